@@ -23,6 +23,7 @@ LOCAL_SRC_FILES := \
         util/QCameraFlash.cpp \
         util/QCameraPerf.cpp \
         util/QCameraQueue.cpp \
+        util/QCameraSuperBufPool.cpp \
         util/QCameraDisplay.cpp \
         util/QCameraCommon.cpp \
         util/QCameraTrace.cpp \
@@ -40,6 +41,7 @@ LOCAL_SRC_FILES += \
         HAL3/QCamera3VendorTags.cpp \
         HAL3/QCamera3PostProc.cpp \
         HAL3/QCamera3CropRegionMapper.cpp \
+        HAL3/QCamera3InflightTracker.cpp \
         HAL3/QCamera3StreamMem.cpp
 
 LOCAL_CFLAGS := -Wall -Wextra -Werror
@@ -56,6 +58,7 @@ ifeq ($(TARGET_SUPPORT_HAL1),false)
 LOCAL_CFLAGS += -DQCAMERA_HAL3_SUPPORT
 LOCAL_SRC_FILES += \
 	HAL/QCameraMem.cpp \
+	HAL/QCameraMemPool.cpp \
 	HAL/QCameraThermalAdapter.cpp \
         util/QCameraFOVControl.cpp \
         util/QCameraHALPP.cpp \
@@ -70,12 +73,15 @@ LOCAL_SRC_FILES += \
         HAL/QCamera2HWI.cpp \
         HAL/QCameraMuxer.cpp \
         HAL/QCameraMem.cpp \
+        HAL/QCameraMemPool.cpp \
         HAL/QCameraStateMachine.cpp \
         HAL/QCameraChannel.cpp \
         HAL/QCameraStream.cpp \
         HAL/QCameraPostProc.cpp \
         HAL/QCamera2HWICallbacks.cpp \
         HAL/QCameraParameters.cpp \
+        HAL/QCameraParametersTables.cpp \
+        HAL/QCameraMapIndex.cpp \
 	HAL/CameraParameters.cpp \
         HAL/QCameraParametersIntf.cpp \
         HAL/QCameraThermalAdapter.cpp \
@@ -174,7 +174,9 @@ const char CameraParameters::LIGHTFX_LOWLIGHT[] = "low-light";
 const char CameraParameters::LIGHTFX_HDR[] = "high-dynamic-range";
 
 CameraParameters::CameraParameters()
-                : mMap()
+                : mMap(),
+                  mFlattenedValid(false),
+                  mOverrideValid(false)
 {
 }
 
@@ -184,21 +186,81 @@ CameraParameters::~CameraParameters()
 
 String8 CameraParameters::flatten() const
 {
-    String8 flattened("");
-    size_t size = mMap.size();
+    if (mFlattenedValid) {
+        return mFlattened;
+    }
 
-    for (size_t i = 0; i < size; i++) {
-        String8 k, v;
-        k = mMap.keyAt(i);
-        v = mMap.valueAt(i);
+    mFlattened = flattenMap(-1, NULL);
+    mFlattenedValid = true;
+    return mFlattened;
+}
+
+String8 CameraParameters::flatten(const char *key, const char *value) const
+{
+    ssize_t idx = mMap.indexOfKey(String8(key));
+    if (idx < 0) {
+        // Not worth caching, the callers only override existing keys
+        CameraParameters params(*this);
+        params.set(key, value);
+        return params.flatten();
+    }
+    if (!strcmp(mMap.valueAt(idx).string(), value)) {
+        return flatten();
+    }
 
-        flattened += k;
-        flattened += "=";
-        flattened += v;
-        if (i != size-1)
-            flattened += ";";
+    if (!mOverrideValid || strcmp(mOverrideKey.string(), key) ||
+            strcmp(mOverrideValue.string(), value)) {
+        mOverrideFlattened = flattenMap(idx, value);
+        mOverrideKey = String8(key);
+        mOverrideValue = String8(value);
+        mOverrideValid = true;
+    }
+    return mOverrideFlattened;
+}
+
+String8 CameraParameters::flattenMap(ssize_t overrideIdx,
+        const char *overrideValue) const
+{
+    size_t overrideLen = (overrideValue != NULL) ? strlen(overrideValue) : 0;
+
+    // Size the result up front and fill it in one pass instead of growing
+    // it with a reallocation per key and value.
+    size_t size = mMap.size();
+    size_t len = 0;
+    for (size_t i = 0; i < size; i++) {
+        len += mMap.keyAt(i).length() + 2;
+        len += ((ssize_t)i == overrideIdx) ?
+                overrideLen : mMap.valueAt(i).length();
+    }
+    if (len > 0) {
+        len--;  // no ';' after the last pair
     }
 
+    String8 flattened("");
+    if (len > 0) {
+        char *p = flattened.lockBuffer(len);
+        if (p == NULL) {
+            return flattened;
+        }
+        for (size_t i = 0; i < size; i++) {
+            const String8 &k = mMap.keyAt(i);
+            const char *v = mMap.valueAt(i).string();
+            size_t vLen = mMap.valueAt(i).length();
+            if ((ssize_t)i == overrideIdx) {
+                v = overrideValue;
+                vLen = overrideLen;
+            }
+
+            memcpy(p, k.string(), k.length());
+            p += k.length();
+            *p++ = '=';
+            memcpy(p, v, vLen);
+            p += vLen;
+            if (i != size-1)
+                *p++ = ';';
+        }
+        flattened.unlockBuffer(len);
+    }
     return flattened;
 }
 
@@ -206,17 +268,32 @@ void CameraParameters::unflatten(const String8 &params)
 {
     const char *a = params.string();
     const char *b;
+    size_t pairs = 0;
+    // Whether flatten() of the result gives params back unchanged, which
+    // holds for strictly sorted keys and no trailing separator
+    bool canonical = true;
 
     mMap.clear();
+    invalidateFlattened();
+
+    for (b = strchr(a, '='); b != 0; b = strchr(b+1, '='))
+        pairs++;
+    mMap.setCapacity(pairs);
 
     for (;;) {
         // Find the bounds of the key name.
         b = strchr(a, '=');
-        if (b == 0)
+        if (b == 0) {
+            if (*a != '\0' || a != params.string())
+                canonical = false;
             break;
+        }
 
         // Create the key string.
         String8 k(a, (size_t)(b-a));
+        if (canonical && mMap.size() > 0 &&
+                strcmp(mMap.keyAt(mMap.size()-1).string(), k.string()) >= 0)
+            canonical = false;
 
         // Find the value.
         a = b+1;
@@ -232,6 +309,11 @@ void CameraParameters::unflatten(const String8 &params)
         mMap.add(k, v);
         a = b+1;
     }
+
+    if (canonical) {
+        mFlattened = params;
+        mFlattenedValid = true;
+    }
 }
 
 
@@ -248,7 +330,17 @@ void CameraParameters::set(const char *key, const char *value)
         return;
     }
 
-    mMap.replaceValueFor(String8(key), String8(value));
+    ssize_t idx = mMap.indexOfKey(String8(key));
+    if (idx >= 0) {
+        if (!strcmp(mMap.valueAt(idx).string(), value)) {
+            return;
+        }
+        mMap.editValueAt(idx) = String8(value);
+    } else {
+        mMap.add(String8(key), String8(value));
+    }
+
+    invalidateFlattened();
 }
 
 void CameraParameters::set(const char *key, int value)
@@ -290,7 +382,11 @@ float CameraParameters::getFloat(const char *key) const
 
 void CameraParameters::remove(const char *key)
 {
-    mMap.removeItem(String8(key));
+    if (mMap.removeItem(String8(key)) < 0) {
+        return;
+    }
+
+    invalidateFlattened();
 }
 
 // Parse string like "640x480" or "10000,20000"
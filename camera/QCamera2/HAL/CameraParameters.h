@@ -42,10 +42,14 @@ class CameraParameters
 {
 public:
     CameraParameters();
-    CameraParameters(const String8 &params) { unflatten(params); }
+    CameraParameters(const String8 &params)
+            : mFlattenedValid(false), mOverrideValid(false) { unflatten(params); }
     ~CameraParameters();
 
     String8 flatten() const;
+    // flatten() as if key were set to value, leaving the parameters and
+    // the flatten() cache untouched
+    String8 flatten(const char *key, const char *value) const;
     void unflatten(const String8 &params);
 
     void set(const char *key, const char *value);
@@ -694,7 +698,18 @@ public:
     static int previewFormatToEnum(const char* format);
 
 private:
+    String8 flattenMap(ssize_t overrideIdx, const char *overrideValue) const;
+    void invalidateFlattened() { mFlattenedValid = false; mOverrideValid = false; }
+
     DefaultKeyedVector<String8,String8>    mMap;
+    // flatten() result, kept until set(), remove() or unflatten() change mMap
+    mutable String8                        mFlattened;
+    mutable bool                           mFlattenedValid;
+    // Last flatten(key, value) result, dropped along with mFlattened
+    mutable String8                        mOverrideFlattened;
+    mutable String8                        mOverrideKey;
+    mutable String8                        mOverrideValue;
+    mutable bool                           mOverrideValid;
 };
 
 }; // namespace android
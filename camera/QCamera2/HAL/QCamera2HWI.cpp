@@ -1714,6 +1714,7 @@ QCamera2HardwareInterface::QCamera2HardwareInterface(uint32_t cameraId)
       mInitPProcJob(0),
       mParamAllocJob(0),
       mParamInitJob(0),
+      mPoolPrewarmJob(0),
       mOutputCount(0),
       mInputCount(0),
       mAdvancedCaptureConfigured(false),
@@ -1765,6 +1766,7 @@ QCamera2HardwareInterface::QCamera2HardwareInterface(uint32_t cameraId)
     pthread_condattr_destroy(&mCondAttr);
 
     memset(m_channels, 0, sizeof(m_channels));
+    mPoolPrewarmCnt = 0;
 
     memset(&mExifParams, 0, sizeof(mm_jpeg_exif_params_t));
 
@@ -2346,6 +2348,8 @@ int QCamera2HardwareInterface::closeCamera()
     // exit notifier
     m_cbNotifier.exit();
 
+    waitDeferredWork(mPoolPrewarmJob);
+
     // stop and deinit postprocessor
     waitDeferredWork(mReprocJob);
     // Close the JPEG session
@@ -4012,6 +4016,9 @@ int QCamera2HardwareInterface::startPreview()
 
     setDisplayFrameSkip();
 
+    // buffers for the configured streams are taken from the pool from here on
+    waitDeferredWork(mPoolPrewarmJob);
+
     // start preview stream
     if (mParameters.isZSLMode() && mParameters.getRecordingHintValue() != true) {
         rc = startChannel(QCAMERA_CH_TYPE_ZSL);
@@ -6627,6 +6634,7 @@ int QCamera2HardwareInterface::dump(int fd)
     dprintf(fd, "StoreMetaDataInFrame: %d \n", mStoreMetaDataInFrame);
     dprintf(fd, "\n Configuration: %s", mParameters.dump().string());
     dprintf(fd, "\n State Information: %s", m_stateMachine.dump().string());
+    dprintf(fd, "\n Memory Pool: %s", m_memoryPool.dump().string());
     dprintf(fd, "\n Camera HAL information End \n");
 
     /* send UPDATE_DEBUG_LEVEL to the backend so that they can read the
@@ -9497,6 +9505,10 @@ int32_t QCamera2HardwareInterface::preparePreview()
         }
     }
 
+    if (rc == NO_ERROR) {
+        prewarmMemoryPool();
+    }
+
     LOGI("X rc = %d", rc);
     return rc;
 }
@@ -9512,6 +9524,7 @@ int32_t QCamera2HardwareInterface::preparePreview()
  *==========================================================================*/
 void QCamera2HardwareInterface::unpreparePreview()
 {
+    waitDeferredWork(mPoolPrewarmJob);
     if (isDualCamera()) {
         mParameters.setDCDeferCamera(CAM_DEFER_FLUSH);
     }
@@ -9523,6 +9536,101 @@ void QCamera2HardwareInterface::unpreparePreview()
     delChannel(QCAMERA_CH_TYPE_RAW);
 }
 
+/*===========================================================================
+ * FUNCTION   : prewarmMemoryPool
+ *
+ * DESCRIPTION: schedule allocation of pool backed stream buffers for the
+ *              configured channels, so that stream start mostly hits the
+ *              memory pool. Streams with deferred allocation are skipped.
+ *
+ * PARAMETERS : none
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void QCamera2HardwareInterface::prewarmMemoryPool()
+{
+    char value[PROPERTY_VALUE_MAX];
+    property_get("persist.vendor.camera.mem.usepool", value, "1");
+    if ((atoi(value) != 1) || isSecureMode()) {
+        return;
+    }
+
+    // Request table is owned by the previous job until it completes
+    waitDeferredWork(mPoolPrewarmJob);
+    mPoolPrewarmCnt = 0;
+
+    for (int i = 0; i < QCAMERA_CH_TYPE_MAX; i++) {
+        QCameraChannel *pChannel = m_channels[i];
+        if (pChannel == NULL) {
+            continue;
+        }
+        for (uint32_t j = 0; j < pChannel->getNumOfStreams(); j++) {
+            QCameraStream *pStream = pChannel->getStreamByIndex(j);
+            cam_frame_len_offset_t offset;
+
+            if ((pStream == NULL) || pStream->isDeffered()) {
+                continue;
+            }
+            // Only stream types that allocateStreamBuf backs by the pool
+            switch (pStream->getMyType()) {
+            case CAM_STREAM_TYPE_SNAPSHOT:
+            case CAM_STREAM_TYPE_ANALYSIS:
+            case CAM_STREAM_TYPE_CALLBACK:
+            case CAM_STREAM_TYPE_RAW:
+                break;
+            default:
+                continue;
+            }
+            memset(&offset, 0, sizeof(offset));
+            if ((pStream->getFrameOffset(offset) != NO_ERROR) ||
+                    (offset.frame_len == 0) ||
+                    (mPoolPrewarmCnt >= QCAMERA_CH_TYPE_MAX)) {
+                continue;
+            }
+            mPoolPrewarmReq[mPoolPrewarmCnt].stream_type = pStream->getMyType();
+            mPoolPrewarmReq[mPoolPrewarmCnt].size = offset.frame_len;
+            mPoolPrewarmReq[mPoolPrewarmCnt].count = pStream->getBufferCount();
+            mPoolPrewarmCnt++;
+        }
+    }
+
+    if (mPoolPrewarmCnt > 0) {
+        mPoolPrewarmTask.bgFunction = backgroundPrewarm;
+        mPoolPrewarmTask.bgArgs = this;
+        mPoolPrewarmJob = scheduleBackgroundTask(&mPoolPrewarmTask);
+        if (mPoolPrewarmJob == 0) {
+            LOGW("Unable to schedule memory pool prewarm");
+        }
+    }
+}
+
+/*===========================================================================
+ * FUNCTION   : backgroundPrewarm
+ *
+ * DESCRIPTION: deferred thread routine filling the memory pool
+ *
+ * PARAMETERS :
+ *   @data    : ptr to QCamera2HardwareInterface
+ *
+ * RETURN     : NO_ERROR, a failed prewarm only costs the allocation later
+ *==========================================================================*/
+int32_t QCamera2HardwareInterface::backgroundPrewarm(void *data)
+{
+    QCamera2HardwareInterface *pme =
+            reinterpret_cast<QCamera2HardwareInterface *>(data);
+
+    for (uint32_t i = 0; i < pme->mPoolPrewarmCnt; i++) {
+        pool_prewarm_req_t &req = pme->mPoolPrewarmReq[i];
+        int32_t rc = pme->m_memoryPool.prewarm(req.stream_type,
+                QCameraMemory::getDefaultHeapMask(), req.size,
+                QCAMERA_ION_USE_CACHE, req.count);
+        if (rc != NO_ERROR) {
+            LOGW("Prewarm of stream type %d failed %d", req.stream_type, rc);
+        }
+    }
+    return NO_ERROR;
+}
+
 /*===========================================================================
  * FUNCTION   : playShutter
  *
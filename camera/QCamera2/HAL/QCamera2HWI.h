@@ -480,6 +480,8 @@ private:
                                void *userData);
     int32_t preparePreview();
     void unpreparePreview();
+    void prewarmMemoryPool();
+    static int32_t backgroundPrewarm(void *data);
     int32_t prepareRawStream(QCameraChannel *pChannel);
     QCameraChannel *getChannelByHandle(uint32_t channelHandle);
     mm_camera_buf_def_t *getSnapshotFrame(mm_camera_super_buf_t *recvd_frame);
@@ -667,6 +669,15 @@ private:
     pthread_cond_t m_cond;
     api_result_list *m_apiResultList;
     QCameraMemoryPool m_memoryPool;
+    // Pool backed stream buffers to allocate while preview is being prepared
+    typedef struct {
+        cam_stream_type_t stream_type;
+        size_t size;
+        uint8_t count;
+    } pool_prewarm_req_t;
+    pool_prewarm_req_t mPoolPrewarmReq[QCAMERA_CH_TYPE_MAX];
+    uint32_t mPoolPrewarmCnt;
+    BackgroundTask mPoolPrewarmTask;
 
     pthread_mutex_t m_evtLock;
     pthread_cond_t m_evtCond;
@@ -810,6 +821,7 @@ private:
     uint32_t mInitPProcJob;
     uint32_t mParamAllocJob;
     uint32_t mParamInitJob;
+    uint32_t mPoolPrewarmJob;
     uint32_t mOutputCount;
     uint32_t mInputCount;
     bool mAdvancedCaptureConfigured;
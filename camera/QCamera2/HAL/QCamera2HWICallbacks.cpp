@@ -40,6 +40,7 @@
 // Camera dependencies
 #include "QCamera2HWI.h"
 #include "QCameraDisplay.h"
+#include "QCameraSuperBufPool.h"
 #include "QCameraTrace.h"
 
 extern "C" {
@@ -153,7 +154,7 @@ void QCamera2HardwareInterface::zsl_channel_cb(mm_camera_super_buf_t *recvd_fram
 
     // save a copy for the superbuf
     mm_camera_super_buf_t* frame =
-               (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+               QCameraSuperBufPool::getInstance()->acquire();
     if (frame == NULL) {
         LOGE("Error allocating memory to save received_frame structure.");
         pChannel->bufDone(recvd_frame);
@@ -281,7 +282,7 @@ void QCamera2HardwareInterface::zsl_channel_cb(mm_camera_super_buf_t *recvd_fram
             (NO_ERROR != pme->m_postprocessor.processData(frame))) {
         LOGE("Failed to trigger process data");
         pChannel->bufDone(recvd_frame);
-        free(frame);
+        QCameraSuperBufPool::getInstance()->release(frame);
         frame = NULL;
         return;
     }
@@ -415,7 +416,7 @@ void QCamera2HardwareInterface::capture_channel_cb_routine(mm_camera_super_buf_t
 
     // save a copy for the superbuf
     mm_camera_super_buf_t* frame =
-               (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+               QCameraSuperBufPool::getInstance()->acquire();
     if (frame == NULL) {
         LOGE("Error allocating memory to save received_frame structure.");
         pChannel->bufDone(recvd_frame);
@@ -468,7 +469,7 @@ void QCamera2HardwareInterface::capture_channel_cb_routine(mm_camera_super_buf_t
             (NO_ERROR != pme->m_postprocessor.processData(frame))) {
         LOGE("Failed to trigger process data");
         pChannel->bufDone(recvd_frame);
-        free(frame);
+        QCameraSuperBufPool::getInstance()->release(frame);
         frame = NULL;
         return;
     }
@@ -670,7 +671,7 @@ void QCamera2HardwareInterface::postproc_channel_cb_routine(mm_camera_super_buf_
 
     // save a copy for the superbuf
     mm_camera_super_buf_t* frame =
-               (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+               QCameraSuperBufPool::getInstance()->acquire();
     if (frame == NULL) {
         LOGE("Error allocating memory to save received_frame structure.");
         return;
@@ -815,6 +816,7 @@ void QCamera2HardwareInterface::preview_stream_cb_routine(mm_camera_super_buf_t
 {
     CAMSCOPE_UPDATE_FLAGS(CAMSCOPE_SECTION_HAL, kpi_camscope_flags);
     KPI_ATRACE_CAMSCOPE_CALL(CAMSCOPE_HAL1_PREVIEW_STRM_CB);
+    QCameraSuperBufHandle frameHolder(super_frame);
     LOGH("[KPI Perf] : BEGIN");
     int err = NO_ERROR;
     QCamera2HardwareInterface *pme = (QCamera2HardwareInterface *)userdata;
@@ -823,19 +825,16 @@ void QCamera2HardwareInterface::preview_stream_cb_routine(mm_camera_super_buf_t
     mm_camera_buf_def_t *dumpBuffer = NULL;
     if (pme == NULL) {
         LOGE("Invalid hardware object");
-        free(super_frame);
         return;
     }
     if (memory == NULL) {
         LOGE("Invalid memory object");
-        free(super_frame);
         return;
     }
 
     mm_camera_buf_def_t *frame = super_frame->bufs[0];
     if (NULL == frame) {
         LOGE("preview frame is NULL");
-        free(super_frame);
         return;
     }
 
@@ -976,7 +975,6 @@ void QCamera2HardwareInterface::preview_stream_cb_routine(mm_camera_super_buf_t
             memory->setBufferStatus(dequeuedIdx, STATUS_IDLE);
         }
     }
-    free(super_frame);
     LOGH("[KPI Perf] : END");
     return;
 }
@@ -1183,6 +1181,7 @@ void QCamera2HardwareInterface::nodisplay_preview_stream_cb_routine(
                                                           void * userdata)
 {
     ATRACE_CAMSCOPE_CALL(CAMSCOPE_HAL1_NODIS_PREVIEW_STRMCB);
+    QCameraSuperBufHandle frameHolder(super_frame);
     LOGH("[KPI Perf] E");
     QCamera2HardwareInterface *pme = (QCamera2HardwareInterface *)userdata;
     if (pme == NULL ||
@@ -1190,21 +1189,17 @@ void QCamera2HardwareInterface::nodisplay_preview_stream_cb_routine(
         !validate_handle(pme->mCameraHandle->camera_handle,
         super_frame->camera_handle)){
         LOGE("camera obj not valid");
-        // simply free super frame
-        free(super_frame);
         return;
     }
     mm_camera_buf_def_t *frame = super_frame->bufs[0];
     if (NULL == frame) {
         LOGE("preview frame is NULL");
-        free(super_frame);
         return;
     }
 
     if (!pme->needProcessPreviewFrame(frame->frame_idx)) {
         LOGH("preview is not running, no need to process");
         stream->bufDone(frame->buf_idx);
-        free(super_frame);
         return;
     }
 
@@ -1242,7 +1237,6 @@ void QCamera2HardwareInterface::nodisplay_preview_stream_cb_routine(
             stream->bufDone(frame->buf_idx);
         }
     }
-    free(super_frame);
     LOGH("[KPI Perf] X");
 }
 
@@ -1415,7 +1409,7 @@ void QCamera2HardwareInterface::secure_stream_cb_routine(
     }
 
 end:
-    free(super_frame);
+    QCameraSuperBufPool::getInstance()->release(super_frame);
     LOGD("Exit");
     return;
 }
@@ -1442,6 +1436,7 @@ void QCamera2HardwareInterface::rdi_mode_stream_cb_routine(
   void * userdata)
 {
     ATRACE_CAMSCOPE_CALL(CAMSCOPE_HAL1_RDI_MODE_STRM_CB);
+    QCameraSuperBufHandle frameHolder(super_frame);
     QCameraMemory *previewMemObj = NULL;
     camera_memory_t *preview_mem = NULL;
 
@@ -1452,7 +1447,6 @@ void QCamera2HardwareInterface::rdi_mode_stream_cb_routine(
         !validate_handle(pme->mCameraHandle->camera_handle,
         super_frame->camera_handle)){
         LOGE("camera obj not valid");
-        free(super_frame);
         return;
     }
     mm_camera_buf_def_t *frame = super_frame->bufs[0];
@@ -1505,7 +1499,6 @@ void QCamera2HardwareInterface::rdi_mode_stream_cb_routine(
         stream->bufDone(frame->buf_idx);
     }
 end:
-    free(super_frame);
     LOGH("RDI_DEBUG Exit");
     return;
 }
@@ -1530,18 +1523,17 @@ void QCamera2HardwareInterface::postview_stream_cb_routine(mm_camera_super_buf_t
                                                            void *userdata)
 {
     ATRACE_CAMSCOPE_CALL(CAMSCOPE_HAL1_POSTVIEW_STRM_CB);
+    QCameraSuperBufHandle frameHolder(super_frame);
     int err = NO_ERROR;
     QCamera2HardwareInterface *pme = (QCamera2HardwareInterface *)userdata;
     QCameraGrallocMemory *memory = (QCameraGrallocMemory *)super_frame->bufs[0]->mem_info;
 
     if (pme == NULL) {
         LOGE("Invalid hardware object");
-        free(super_frame);
         return;
     }
     if (memory == NULL) {
         LOGE("Invalid memory object");
-        free(super_frame);
         return;
     }
 
@@ -1550,7 +1542,6 @@ void QCamera2HardwareInterface::postview_stream_cb_routine(mm_camera_super_buf_t
     mm_camera_buf_def_t *frame = super_frame->bufs[0];
     if (NULL == frame) {
         LOGE("preview frame is NULL");
-        free(super_frame);
         return;
     }
 
@@ -1565,7 +1556,6 @@ void QCamera2HardwareInterface::postview_stream_cb_routine(mm_camera_super_buf_t
         LOGE("stream bufDone failed %d", err);
     }
 
-    free(super_frame);
     LOGH("[KPI Perf] : END");
     return;
 }
@@ -1605,7 +1595,7 @@ void QCamera2HardwareInterface::video_stream_cb_routine(mm_camera_super_buf_t *s
             !validate_handle(pme->mCameraHandle->camera_handle,
             super_frame->camera_handle)) {
         // simply free super frame
-        free(super_frame);
+        QCameraSuperBufPool::getInstance()->release(super_frame);
         return;
     }
 
@@ -1666,7 +1656,7 @@ void QCamera2HardwareInterface::video_stream_cb_routine(mm_camera_super_buf_t *s
                 LOGE("No Free metadata. Drop this frame");
                 stream->mCurBufIndex = -1;
                 stream->bufDone(frame->buf_idx);
-                free(super_frame);
+                QCameraSuperBufPool::getInstance()->release(super_frame);
                 return;
             }
 
@@ -1772,7 +1762,7 @@ void QCamera2HardwareInterface::video_stream_cb_routine(mm_camera_super_buf_t *s
         }
     }
     if (!pme->mParameters.isVideoFaceBeautification()) {
-        free(super_frame);
+        QCameraSuperBufPool::getInstance()->release(super_frame);
     }
     LOGD("[KPI Perf] : END");
 }
@@ -1807,7 +1797,7 @@ void QCamera2HardwareInterface::snapshot_channel_cb_routine(mm_camera_super_buf_
         super_frame->camera_handle)){
         LOGE("camera obj not valid");
         // simply free super frame
-        free(super_frame);
+        QCameraSuperBufPool::getInstance()->release(super_frame);
         return;
     }
 
@@ -1856,7 +1846,7 @@ void QCamera2HardwareInterface::snapshot_channel_cb_routine(mm_camera_super_buf_
     }
 
     // save a copy for the superbuf
-    mm_camera_super_buf_t* frame = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+    mm_camera_super_buf_t* frame = QCameraSuperBufPool::getInstance()->acquire();
     if (frame == NULL) {
         LOGE("Error allocating memory to save received_frame structure.");
         pChannel->bufDone(super_frame);
@@ -1873,7 +1863,7 @@ void QCamera2HardwareInterface::snapshot_channel_cb_routine(mm_camera_super_buf_
             (NO_ERROR != pme->m_postprocessor.processData(frame))) {
         LOGE("Failed to trigger process data");
         pChannel->bufDone(super_frame);
-        free(frame);
+        QCameraSuperBufPool::getInstance()->release(frame);
         frame = NULL;
         return;
     }
@@ -1913,7 +1903,7 @@ void QCamera2HardwareInterface::raw_stream_cb_routine(mm_camera_super_buf_t * su
         super_frame->camera_handle)){
         LOGE("camera obj not valid");
         // simply free super frame
-        free(super_frame);
+        QCameraSuperBufPool::getInstance()->release(super_frame);
         return;
     }
 
@@ -1952,7 +1942,7 @@ void QCamera2HardwareInterface::raw_channel_cb_routine(mm_camera_super_buf_t *su
         super_frame->camera_handle)){
         LOGE("camera obj not valid");
         // simply free super frame
-        free(super_frame);
+        QCameraSuperBufPool::getInstance()->release(super_frame);
         return;
     }
 
@@ -1992,7 +1982,7 @@ void QCamera2HardwareInterface::raw_channel_cb_routine(mm_camera_super_buf_t *su
     }
 
     // save a copy for the superbuf
-    mm_camera_super_buf_t* frame = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+    mm_camera_super_buf_t* frame = QCameraSuperBufPool::getInstance()->acquire();
     if (frame == NULL) {
         LOGE("Error allocating memory to save received_frame structure.");
         pChannel->bufDone(super_frame);
@@ -2011,7 +2001,7 @@ void QCamera2HardwareInterface::raw_channel_cb_routine(mm_camera_super_buf_t *su
             (NO_ERROR != pme->m_postprocessor.processData(frame))) {
         LOGE("Failed to trigger process data");
         pChannel->bufDone(super_frame);
-        free(frame);
+        QCameraSuperBufPool::getInstance()->release(frame);
         frame = NULL;
         return;
     }
@@ -2040,6 +2030,7 @@ void QCamera2HardwareInterface::preview_raw_stream_cb_routine(mm_camera_super_bu
                                                               void * userdata)
 {
     ATRACE_CAMSCOPE_CALL(CAMSCOPE_HAL1_PREVIEW_RAW_STRM_CB);
+    QCameraSuperBufHandle frameHolder(super_frame);
     LOGH("[KPI Perf] : BEGIN");
     char value[PROPERTY_VALUE_MAX];
     bool dump_preview_raw = false, dump_video_raw = false;
@@ -2050,8 +2041,6 @@ void QCamera2HardwareInterface::preview_raw_stream_cb_routine(mm_camera_super_bu
         !validate_handle(pme->mCameraHandle->camera_handle,
         super_frame->camera_handle)){
         LOGE("camera obj not valid");
-        // simply free super frame
-        free(super_frame);
         return;
     }
 
@@ -2068,7 +2057,6 @@ void QCamera2HardwareInterface::preview_raw_stream_cb_routine(mm_camera_super_bu
         }
         stream->bufDone(raw_frame->buf_idx);
     }
-    free(super_frame);
 
     LOGH("[KPI Perf] : END");
 }
@@ -2093,6 +2081,7 @@ void QCamera2HardwareInterface::snapshot_raw_stream_cb_routine(mm_camera_super_b
                                                                void * userdata)
 {
     ATRACE_CAMSCOPE_CALL(CAMSCOPE_HAL1_SNAPSHOT_RAW_STRM_CB);
+    QCameraSuperBufHandle frameHolder(super_frame);
     LOGH("[KPI Perf] : BEGIN");
     char value[PROPERTY_VALUE_MAX];
     bool dump_raw = false;
@@ -2103,8 +2092,6 @@ void QCamera2HardwareInterface::snapshot_raw_stream_cb_routine(mm_camera_super_b
         !validate_handle(pme->mCameraHandle->camera_handle,
         super_frame->camera_handle)){
         LOGE("camera obj not valid");
-        // simply free super frame
-        free(super_frame);
         return;
     }
 
@@ -2124,7 +2111,6 @@ void QCamera2HardwareInterface::snapshot_raw_stream_cb_routine(mm_camera_super_b
         }
     }
 
-    free(super_frame);
 
     LOGH("[KPI Perf] : END");
 }
@@ -2287,7 +2273,7 @@ void QCamera2HardwareInterface::metadata_stream_cb_routine(mm_camera_super_buf_t
             !validate_handle(pme->mCameraHandle->camera_handle,
             super_frame->camera_handle)) {
         // simply free super frame
-        free(super_frame);
+        QCameraSuperBufPool::getInstance()->release(super_frame);
         return;
     }
 
@@ -2360,7 +2346,7 @@ void QCamera2HardwareInterface::metadata_stream_cb_routine(mm_camera_super_buf_t
             pMetaData = resultMetadata;
         } else {
             stream->bufDone(super_frame);
-            free(super_frame);
+            QCameraSuperBufPool::getInstance()->release(super_frame);
             return;
         }
     }
@@ -2795,7 +2781,7 @@ void QCamera2HardwareInterface::metadata_stream_cb_routine(mm_camera_super_buf_t
     }
 
     stream->bufDone(super_frame);
-    free(super_frame);
+    QCameraSuperBufPool::getInstance()->release(super_frame);
 
     LOGD("[KPI Perf] : END");
 }
@@ -2832,7 +2818,7 @@ void QCamera2HardwareInterface::reprocess_stream_cb_routine(mm_camera_super_buf_
         super_frame->camera_handle)){
         LOGE("camera obj not valid");
         // simply free super frame
-        free(super_frame);
+        QCameraSuperBufPool::getInstance()->release(super_frame);
         return;
     }
 
@@ -2858,6 +2844,7 @@ void QCamera2HardwareInterface::callback_stream_cb_routine(mm_camera_super_buf_t
         QCameraStream *stream, void *userdata)
 {
     ATRACE_CAMSCOPE_CALL(CAMSCOPE_HAL1_CB_STRM_CB);
+    QCameraSuperBufHandle frameHolder(super_frame);
     LOGH("[KPI Perf]: E");
     QCamera2HardwareInterface *pme = (QCamera2HardwareInterface *)userdata;
 
@@ -2865,22 +2852,18 @@ void QCamera2HardwareInterface::callback_stream_cb_routine(mm_camera_super_buf_t
             pme->mCameraHandle == 0 ||
             !validate_handle(pme->mCameraHandle->camera_handle,
             super_frame->camera_handle)) {
-        // simply free super frame
-        free(super_frame);
         return;
     }
 
     mm_camera_buf_def_t *frame = super_frame->bufs[0];
     if (NULL == frame) {
         LOGE("preview callback frame is NULL");
-        free(super_frame);
         return;
     }
 
     if (!pme->needProcessPreviewFrame(frame->frame_idx)) {
         LOGH("preview is not running, no need to process");
         stream->bufDone(frame->buf_idx);
-        free(super_frame);
         return;
     }
 
@@ -2897,7 +2880,6 @@ void QCamera2HardwareInterface::callback_stream_cb_routine(mm_camera_super_buf_t
         }
     }
     stream->bufDone(frame->buf_idx);
-    free(super_frame);
     LOGH("[KPI Perf]: X");
 }
 
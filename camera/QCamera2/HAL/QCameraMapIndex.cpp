@@ -0,0 +1,301 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define LOG_TAG "QCameraMapIndex"
+
+// System dependencies
+#include <string.h>
+
+// Camera dependencies
+#include "QCameraMapIndex.h"
+
+extern "C" {
+#include "mm_camera_dbg.h"
+}
+
+namespace qcamera {
+
+#define SLOT_MASK (QCAMERA_MAP_INDEX_SLOTS - 1)
+
+/*===========================================================================
+ * FUNCTION   : QCameraMapIndex
+ *
+ * DESCRIPTION: constructor of QCameraMapIndex
+ *
+ * PARAMETERS :
+ *   @init    : optional function adding the tables to index
+ *
+ * RETURN     : None
+ *==========================================================================*/
+QCameraMapIndex::QCameraMapIndex(void (*init)(QCameraMapIndex &index))
+    : mTableCnt(0),
+      mNameCnt(0),
+      mValueCnt(0)
+{
+    memset(mNames, 0, sizeof(mNames));
+    memset(mValues, 0, sizeof(mValues));
+    memset(mTables, 0, sizeof(mTables));
+    if (init != NULL) {
+        init(*this);
+    }
+}
+
+/*===========================================================================
+ * FUNCTION   : hashName
+ *
+ * DESCRIPTION: cheap hash of a map name from its length and three chars
+ *
+ * PARAMETERS :
+ *   @name    : name to hash, NULL for the table marker
+ *
+ * RETURN     : hash value
+ *==========================================================================*/
+uint32_t QCameraMapIndex::hashName(const char *name)
+{
+    size_t len;
+
+    if (name == NULL) {
+        return 0;
+    }
+    // names in one map rarely share length, first, middle and last char;
+    // when they do the full hash compare and strcmp still tell them apart
+    len = strlen(name);
+    if (len == 0) {
+        return 1;
+    }
+    return ((uint32_t)len & 0xFF) |
+            ((uint32_t)(uint8_t)name[0] << 8) |
+            ((uint32_t)(uint8_t)name[len / 2] << 16) |
+            ((uint32_t)(uint8_t)name[len - 1] << 24);
+}
+
+/*===========================================================================
+ * FUNCTION   : slotOf
+ *
+ * DESCRIPTION: first slot to probe for a key of a table
+ *
+ * PARAMETERS :
+ *   @map     : table address
+ *   @hash    : hash of the key within the table
+ *
+ * RETURN     : slot index
+ *==========================================================================*/
+uint32_t QCameraMapIndex::slotOf(const void *map, uint32_t hash)
+{
+    uint32_t h = hash ^ ((uint32_t)((uintptr_t)map >> 3) * 0x9E3779B1U);
+
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+    return h & SLOT_MASK;
+}
+
+/*===========================================================================
+ * FUNCTION   : addTable
+ *
+ * DESCRIPTION: reserve room for the entries of a table, a refused table is
+ *              logged and left to the linear scan
+ *
+ * PARAMETERS :
+ *   @map     : table address
+ *   @len     : number of entries
+ *   @name    : table name for logs
+ *   @descOf  : accessor to the name of an entry
+ *   @valOf   : accessor to the value of an entry
+ *
+ * RETURN     : true if the entries can be added
+ *==========================================================================*/
+bool QCameraMapIndex::addTable(const void *map, size_t len, const char *name,
+        const char *(*descOf)(const void *, size_t),
+        int (*valOf)(const void *, size_t))
+{
+    if (len < QCAMERA_MAP_INDEX_MIN_LEN) {
+        LOGW("%s has %zu entries, too few to index", name, len);
+        return false;
+    }
+    if ((mTableCnt == QCAMERA_MAP_INDEX_TABLES) ||
+            (mNameCnt + len + 1 > QCAMERA_MAP_INDEX_SLOTS / 2) ||
+            (mValueCnt + len > QCAMERA_MAP_INDEX_SLOTS / 2)) {
+        LOGE("No room to index %s with %zu entries", name, len);
+        return false;
+    }
+    mTables[mTableCnt].map = map;
+    mTables[mTableCnt].len = len;
+    mTables[mTableCnt].name = name;
+    mTables[mTableCnt].descAt = descOf;
+    mTables[mTableCnt].valAt = valOf;
+    mTableCnt++;
+    return true;
+}
+
+/*===========================================================================
+ * FUNCTION   : addName
+ *
+ * DESCRIPTION: add a name of a table, a NULL name marks the table indexed
+ *
+ * PARAMETERS :
+ *   @map     : table address
+ *   @desc    : name
+ *   @val     : value of the name
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraMapIndex::addName(const void *map, const char *desc, int val)
+{
+    uint32_t hash = hashName(desc);
+    uint32_t i = slotOf(map, hash);
+
+    while (mNames[i].map != NULL) {
+        const Slot &slot = mNames[i];
+        if ((slot.map == map) && (slot.hash == hash) &&
+                ((slot.desc == desc) ||
+                 ((slot.desc != NULL) && (desc != NULL) &&
+                  !strcmp(slot.desc, desc)))) {
+            // keep the first entry, as the linear scan would
+            return;
+        }
+        i = (i + 1) & SLOT_MASK;
+    }
+    mNames[i].map = map;
+    mNames[i].desc = desc;
+    mNames[i].val = val;
+    mNames[i].hash = hash;
+    mNameCnt++;
+}
+
+/*===========================================================================
+ * FUNCTION   : addValue
+ *
+ * DESCRIPTION: add a value of a table for the reverse lookup
+ *
+ * PARAMETERS :
+ *   @map     : table address
+ *   @desc    : name of the value
+ *   @val     : value
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraMapIndex::addValue(const void *map, const char *desc, int val)
+{
+    uint32_t i = slotOf(map, (uint32_t)val);
+
+    while (mValues[i].map != NULL) {
+        if ((mValues[i].map == map) && (mValues[i].val == val)) {
+            return;
+        }
+        i = (i + 1) & SLOT_MASK;
+    }
+    mValues[i].map = map;
+    mValues[i].desc = desc;
+    mValues[i].val = val;
+    mValues[i].hash = (uint32_t)val;
+    mValueCnt++;
+}
+
+/*===========================================================================
+ * FUNCTION   : isIndexed
+ *
+ * DESCRIPTION: whether all entries of a table are in the index
+ *
+ * PARAMETERS :
+ *   @map     : table address
+ *
+ * RETURN     : true if the table was added
+ *==========================================================================*/
+bool QCameraMapIndex::isIndexed(const void *map) const
+{
+    uint32_t i = slotOf(map, 0);
+
+    while (mNames[i].map != NULL) {
+        if ((mNames[i].map == map) && (mNames[i].desc == NULL)) {
+            return true;
+        }
+        i = (i + 1) & SLOT_MASK;
+    }
+    return false;
+}
+
+/*===========================================================================
+ * FUNCTION   : findName
+ *
+ * DESCRIPTION: lookup a value by its name
+ *
+ * PARAMETERS :
+ *   @map     : table address
+ *   @name    : name to be looked up
+ *   @val     : [output] value of the name
+ *
+ * RETURN     : true if found
+ *==========================================================================*/
+bool QCameraMapIndex::findName(const void *map, const char *name,
+        int &val) const
+{
+    uint32_t hash = hashName(name);
+    uint32_t i = slotOf(map, hash);
+
+    while (mNames[i].map != NULL) {
+        const Slot &slot = mNames[i];
+        if ((slot.map == map) && (slot.hash == hash) &&
+                (slot.desc != NULL) && !strcmp(slot.desc, name)) {
+            val = slot.val;
+            return true;
+        }
+        i = (i + 1) & SLOT_MASK;
+    }
+    return false;
+}
+
+/*===========================================================================
+ * FUNCTION   : findValue
+ *
+ * DESCRIPTION: lookup a name by its value
+ *
+ * PARAMETERS :
+ *   @map     : table address
+ *   @val     : value to be looked up
+ *   @name    : [output] first name of the value
+ *
+ * RETURN     : true if found
+ *==========================================================================*/
+bool QCameraMapIndex::findValue(const void *map, int val,
+        const char *&name) const
+{
+    uint32_t i = slotOf(map, (uint32_t)val);
+
+    while (mValues[i].map != NULL) {
+        if ((mValues[i].map == map) && (mValues[i].val == val)) {
+            name = mValues[i].desc;
+            return true;
+        }
+        i = (i + 1) & SLOT_MASK;
+    }
+    return false;
+}
+
+}; // namespace qcamera
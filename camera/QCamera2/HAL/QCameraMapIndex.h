@@ -0,0 +1,122 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef __QCAMERA_MAP_INDEX_H__
+#define __QCAMERA_MAP_INDEX_H__
+
+// System dependencies
+#include <stddef.h>
+#include <stdint.h>
+
+namespace qcamera {
+
+// Slots per direction, at most half of them are filled
+#define QCAMERA_MAP_INDEX_SLOTS 512
+// Tables the index can hold
+#define QCAMERA_MAP_INDEX_TABLES 16
+// Below this many entries a linear scan is faster than the index
+#define QCAMERA_MAP_INDEX_MIN_LEN 8
+
+// Hash index over static { desc, val } tables such as the *_MAP tables of
+// QCameraParameters. Entries of all tables share one open addressed table
+// keyed by table address, so a lookup costs one hash and usually a single
+// strcmp instead of one strcmp per entry. When a name or value repeats
+// within a table the first entry wins, like the linear scan it replaces.
+// Small tables are refused, callers scan those linearly. The index is
+// filled once and only read afterwards, lookups take no lock.
+class QCameraMapIndex {
+public:
+    // A table held by the index, with typed accessors to its entries
+    typedef struct {
+        const void *map;
+        size_t len;
+        const char *name;
+        const char *(*descAt)(const void *map, size_t i);
+        int (*valAt)(const void *map, size_t i);
+    } Table;
+
+    QCameraMapIndex(void (*init)(QCameraMapIndex &index) = NULL);
+
+    template <class mapType> bool add(const mapType *arr, size_t len,
+            const char *name)
+    {
+        if (!addTable(arr, len, name, descAt<mapType>, valAt<mapType>)) {
+            // left to the linear scan
+            return false;
+        }
+        for (size_t i = 0; i < len; i++) {
+            addName(arr, arr[i].desc, (int)arr[i].val);
+            addValue(arr, arr[i].desc, (int)arr[i].val);
+        }
+        addName(arr, NULL, 0);
+        return true;
+    }
+    bool isIndexed(const void *map) const;
+    bool findName(const void *map, const char *name, int &val) const;
+    bool findValue(const void *map, int val, const char *&name) const;
+    size_t getTableCount() const { return mTableCnt; }
+    const Table &getTable(size_t i) const { return mTables[i]; }
+
+private:
+    typedef struct {
+        const void *map;
+        const char *desc;
+        int val;
+        uint32_t hash;
+    } Slot;
+
+    template <class mapType> static const char *descAt(const void *map,
+            size_t i)
+    {
+        return ((const mapType *)map)[i].desc;
+    }
+    template <class mapType> static int valAt(const void *map, size_t i)
+    {
+        return (int)((const mapType *)map)[i].val;
+    }
+
+    bool addTable(const void *map, size_t len, const char *name,
+            const char *(*descOf)(const void *, size_t),
+            int (*valOf)(const void *, size_t));
+    void addName(const void *map, const char *desc, int val);
+    void addValue(const void *map, const char *desc, int val);
+    static uint32_t hashName(const char *name);
+    static uint32_t slotOf(const void *map, uint32_t hash);
+
+    Slot mNames[QCAMERA_MAP_INDEX_SLOTS];
+    Slot mValues[QCAMERA_MAP_INDEX_SLOTS];
+    Table mTables[QCAMERA_MAP_INDEX_TABLES];
+    size_t mTableCnt;
+    size_t mNameCnt;
+    size_t mValueCnt;
+};
+
+}; // namespace qcamera
+
+#endif /* __QCAMERA_MAP_INDEX_H__ */
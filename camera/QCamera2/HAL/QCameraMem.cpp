@@ -300,6 +300,24 @@ uint8_t QCameraMemory::checkIfAllBuffersMapped() const
     return 1;
 }
 
+/*===========================================================================
+ * FUNCTION   : getDefaultHeapMask
+ *
+ * DESCRIPTION: query the ion heap mask used for stream buffers
+ *
+ * PARAMETERS : none
+ *
+ * RETURN     : ion heap id mask
+ *==========================================================================*/
+unsigned int QCameraMemory::getDefaultHeapMask()
+{
+#ifndef TARGET_ION_ABI_VERSION
+    return 0x1 << ION_IOMMU_HEAP_ID;
+#else
+    return 0x1 << ION_SYSTEM_HEAP_ID;
+#endif // TARGET_ION_ABI_VERSION
+}
+
 
 /*===========================================================================
  * FUNCTION   : getBufDef
@@ -629,181 +647,6 @@ void QCameraMemory::deallocOneBuffer(QCameraMemInfo &memInfo)
     memInfo.size = 0;
 }
 
-/*===========================================================================
- * FUNCTION   : QCameraMemoryPool
- *
- * DESCRIPTION: default constructor of QCameraMemoryPool
- *
- * PARAMETERS : None
- *
- * RETURN     : None
- *==========================================================================*/
-QCameraMemoryPool::QCameraMemoryPool()
-{
-    pthread_mutex_init(&mLock, NULL);
-}
-
-
-/*===========================================================================
- * FUNCTION   : ~QCameraMemoryPool
- *
- * DESCRIPTION: deconstructor of QCameraMemoryPool
- *
- * PARAMETERS : None
- *
- * RETURN     : None
- *==========================================================================*/
-QCameraMemoryPool::~QCameraMemoryPool()
-{
-    clear();
-    pthread_mutex_destroy(&mLock);
-}
-
-/*===========================================================================
- * FUNCTION   : releaseBuffer
- *
- * DESCRIPTION: release one cached buffers
- *
- * PARAMETERS :
- *   @memInfo : reference to struct that stores additional memory allocation info
- *   @streamType: Type of stream the buffers belongs to
- *
- * RETURN     : none
- *==========================================================================*/
-void QCameraMemoryPool::releaseBuffer(
-        struct QCameraMemory::QCameraMemInfo &memInfo,
-        cam_stream_type_t streamType)
-{
-    pthread_mutex_lock(&mLock);
-
-    mPools[streamType].push_back(memInfo);
-
-    pthread_mutex_unlock(&mLock);
-}
-
-/*===========================================================================
- * FUNCTION   : clear
- *
- * DESCRIPTION: clears all cached buffers
- *
- * PARAMETERS : none
- *
- * RETURN     : none
- *==========================================================================*/
-void QCameraMemoryPool::clear()
-{
-    pthread_mutex_lock(&mLock);
-
-    for (int i = CAM_STREAM_TYPE_DEFAULT; i < CAM_STREAM_TYPE_MAX; i++ ) {
-        List<struct QCameraMemory::QCameraMemInfo>::iterator it;
-        it = mPools[i].begin();
-        for( ; it != mPools[i].end() ; it++) {
-            QCameraMemory::deallocOneBuffer(*it);
-        }
-
-        mPools[i].clear();
-    }
-
-    pthread_mutex_unlock(&mLock);
-}
-
-/*===========================================================================
- * FUNCTION   : findBufferLocked
- *
- * DESCRIPTION: search for a appropriate cached buffer
- *
- * PARAMETERS :
- *   @memInfo : reference to struct that stores additional memory allocation info
- *   @heap_id : type of heap
- *   @size    : size of the buffer
- *   @cached  : whether the buffer should be cached
- *   @streaType: type of stream this buffer belongs to
- *
- * RETURN     : int32_t type of status
- *              NO_ERROR  -- success
- *              none-zero failure code
- *==========================================================================*/
-int QCameraMemoryPool::findBufferLocked(
-        struct QCameraMemory::QCameraMemInfo &memInfo, unsigned int heap_id,
-        size_t size, bool cached, cam_stream_type_t streamType)
-{
-    int rc = NAME_NOT_FOUND;
-    size_t alignsize = (size + 4095U) & (~4095U);
-    if (mPools[streamType].empty()) {
-        return NAME_NOT_FOUND;
-    }
-
-    List<struct QCameraMemory::QCameraMemInfo>::iterator it = mPools[streamType].begin();
-    if (streamType == CAM_STREAM_TYPE_OFFLINE_PROC) {
-        for( ; it != mPools[streamType].end() ; it++) {
-            if( ((*it).size == alignsize) &&
-                    ((*it).heap_id == heap_id) &&
-                    ((*it).cached == cached) ) {
-                memInfo = *it;
-                LOGD("Found buffer %lx size %d",
-                         (unsigned long)memInfo.handle, memInfo.size);
-                mPools[streamType].erase(it);
-                rc = NO_ERROR;
-                break;
-            }
-        }
-    } else {
-        for( ; it != mPools[streamType].end() ; it++) {
-            if(((*it).size >= size) &&
-                    ((*it).heap_id == heap_id) &&
-                    ((*it).cached == cached) ) {
-                memInfo = *it;
-                LOGD("Found buffer %lx size %d",
-                         (unsigned long)memInfo.handle, memInfo.size);
-                mPools[streamType].erase(it);
-                rc = NO_ERROR;
-                break;
-            }
-        }
-    }
-
-    return rc;
-}
-
-/*===========================================================================
- * FUNCTION   : allocateBuffer
- *
- * DESCRIPTION: allocates a buffer from the memory pool,
- *              it will re-use cached buffers if possible
- *
- * PARAMETERS :
- *   @memInfo : reference to struct that stores additional memory allocation info
- *   @heap_id : type of heap
- *   @size    : size of the buffer
- *   @cached  : whether the buffer should be cached
- *   @streaType: type of stream this buffer belongs to
- *   @secure_mode : secure mode
- *
- * RETURN     : int32_t type of status
- *              NO_ERROR  -- success
- *              none-zero failure code
- *==========================================================================*/
-int QCameraMemoryPool::allocateBuffer(
-        struct QCameraMemory::QCameraMemInfo &memInfo, unsigned int heap_id,
-        size_t size, bool cached, cam_stream_type_t streamType,
-        bool secure_mode)
-{
-    int rc = NO_ERROR;
-
-    pthread_mutex_lock(&mLock);
-
-    rc = findBufferLocked(memInfo, heap_id, size, cached, streamType);
-    if (NAME_NOT_FOUND == rc ) {
-        LOGD("Buffer not found!");
-        rc = QCameraMemory::allocOneBuffer(memInfo, heap_id, size, cached,
-                 secure_mode);
-    }
-
-    pthread_mutex_unlock(&mLock);
-
-    return rc;
-}
-
 /*===========================================================================
  * FUNCTION   : QCameraHeapMemory
  *
@@ -1178,11 +1021,7 @@ QCameraStreamMemory::~QCameraStreamMemory()
 int QCameraStreamMemory::allocate(uint8_t count, size_t size)
 {
     ATRACE_BEGIN_SNPRINTF("%s %zu %d", "StreamMemsize", size, count);
-#ifndef TARGET_ION_ABI_VERSION
-    uint32_t heap_id_mask = 0x1 << ION_IOMMU_HEAP_ID;
-#else
-    uint32_t heap_id_mask = 0x1 << ION_SYSTEM_HEAP_ID;
-#endif // TARGET_ION_ABI_VERSION
+    uint32_t heap_id_mask = getDefaultHeapMask();
     int rc = alloc(count, size, heap_id_mask);
     if (rc < 0) {
         ATRACE_END();
@@ -38,6 +38,7 @@
 #endif //TARGET_ION_ABI_VERSION
 #include <utils/Mutex.h>
 #include <utils/List.h>
+#include <utils/String8.h>
 
 //Media depedancies
 #include "OMX_QCOMExtns.h"
@@ -125,6 +126,7 @@ public:
     uint8_t getCnt() const;
     virtual uint8_t getMappable() const;
     virtual uint8_t checkIfAllBuffersMapped() const;
+    static unsigned int getDefaultHeapMask();
 
     virtual int allocate(uint8_t count, size_t size) = 0;
     virtual void deallocate() = 0;
@@ -179,27 +181,78 @@ protected:
     QCameraMemType mBufType;
 };
 
+// Number of power-of-two size classes (in 4K pages) kept per stream type.
+// The last class collects everything of 2^(N-1) pages and above.
+#define QCAMERA_MEM_POOL_SIZE_CLASSES   20
+
+typedef struct {
+    uint32_t hits;            // requests served from the pool
+    uint32_t misses;          // requests that had to allocate
+    uint32_t prewarmed;       // buffers allocated ahead of time by prewarm()
+    uint32_t trimmed;         // buffers freed by budget trimming
+    uint64_t wasted_bytes;    // slack handed out on hits (buffer - request)
+    size_t idle_bytes;        // bytes currently parked in the pool
+    uint32_t idle_bufs;       // buffers currently parked in the pool
+} QCameraMemPoolStats;
+
+// Cache of released ION buffers, binned per stream type and size class.
+// Lookups are best-fit within a bounded slack; idle buffers are trimmed
+// least-recently-released first once a per-stream or global budget is hit.
 class QCameraMemoryPool {
 
 public:
 
+    typedef struct QCameraMemory::QCameraMemInfo MemInfo;
+
     QCameraMemoryPool();
     virtual ~QCameraMemoryPool();
 
-    int allocateBuffer(struct QCameraMemory::QCameraMemInfo &memInfo,
+    int allocateBuffer(MemInfo &memInfo,
             unsigned int heap_id, size_t size, bool cached,
             cam_stream_type_t streamType, bool is_secure);
-    void releaseBuffer(struct QCameraMemory::QCameraMemInfo &memInfo,
+    void releaseBuffer(MemInfo &memInfo,
             cam_stream_type_t streamType);
+    int prewarm(cam_stream_type_t streamType, unsigned int heap_id,
+            size_t size, bool cached, uint8_t count);
+    void setBudget(size_t totalBudget, size_t streamBudget);
+    void setMaxWaste(uint32_t maxWastePct);
+    void getStats(cam_stream_type_t streamType, QCameraMemPoolStats &stats);
     void clear();
+    String8 dump();
 
 protected:
 
-    int findBufferLocked(struct QCameraMemory::QCameraMemInfo &memInfo,
+    struct QCameraPoolEntry {
+        MemInfo memInfo;
+        uint64_t lastUsed;
+    };
+
+    // Backing allocator. Subclasses overriding these must clear() from
+    // their own destructor.
+    virtual int allocOne(MemInfo &memInfo, unsigned int heap_id,
+            size_t size, bool cached, bool is_secure);
+    virtual void freeOne(MemInfo &memInfo);
+
+    static uint32_t getSizeClass(size_t size);
+    size_t getMaxFitSize(size_t alignSize, cam_stream_type_t streamType,
+            bool is_secure) const;
+    int findBufferLocked(MemInfo &memInfo,
             unsigned int heap_id, size_t size, bool cached,
+            cam_stream_type_t streamType, bool is_secure);
+    uint32_t countFitLocked(unsigned int heap_id, size_t size, bool cached,
             cam_stream_type_t streamType);
-
-    android::List<QCameraMemory::QCameraMemInfo> mPools[CAM_STREAM_TYPE_MAX];
+    void insertLocked(const MemInfo &memInfo, cam_stream_type_t streamType);
+    bool evictLRULocked(cam_stream_type_t streamType);
+    void trimLocked(cam_stream_type_t streamType);
+
+    android::List<QCameraPoolEntry>
+            mPools[CAM_STREAM_TYPE_MAX][QCAMERA_MEM_POOL_SIZE_CLASSES];
+    QCameraMemPoolStats mStats[CAM_STREAM_TYPE_MAX];
+    size_t mIdleBytes;
+    size_t mTotalBudget;
+    size_t mStreamBudget;
+    uint32_t mMaxWastePct;
+    uint64_t mReleaseSeq;
     pthread_mutex_t mLock;
 };
 
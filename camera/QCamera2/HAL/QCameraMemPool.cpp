@@ -0,0 +1,655 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_TAG "QCameraHWI_MemPool"
+
+// System dependencies
+#include <stdlib.h>
+#include <cutils/properties.h>
+#include <utils/Errors.h>
+
+// Camera dependencies
+#include "QCameraMem.h"
+
+extern "C" {
+#include "mm_camera_dbg.h"
+}
+
+using namespace android;
+
+namespace qcamera {
+
+// Secure buffers are padded to the 2MiB protection granule by the allocator,
+// so a fresh secure allocation may already carry this much slack.
+#define QCAMERA_MEM_POOL_SECURE_ALIGN (2U * 1024U * 1024U)
+
+/*===========================================================================
+ * FUNCTION   : QCameraMemoryPool
+ *
+ * DESCRIPTION: default constructor of QCameraMemoryPool
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+QCameraMemoryPool::QCameraMemoryPool()
+{
+    char prop[PROPERTY_VALUE_MAX];
+
+    // Budgets are in MB, 0 disables the limit. Max waste is the slack a
+    // reused buffer may carry, in percent of the requested size.
+    pthread_mutex_init(&mLock, NULL);
+    memset(mStats, 0, sizeof(mStats));
+    mIdleBytes = 0;
+    mReleaseSeq = 0;
+
+    property_get("persist.vendor.camera.mempool.budget", prop,
+            "512");
+    mTotalBudget = (size_t)atoi(prop) * 1024U * 1024U;
+    property_get("persist.vendor.camera.mempool.streambudget", prop,
+            "256");
+    mStreamBudget = (size_t)atoi(prop) * 1024U * 1024U;
+    property_get("persist.vendor.camera.mempool.maxwaste", prop,
+            "25");
+    mMaxWastePct = (uint32_t)atoi(prop);
+
+    LOGD("budget %zu stream budget %zu max waste %u%%",
+            mTotalBudget, mStreamBudget, mMaxWastePct);
+}
+
+/*===========================================================================
+ * FUNCTION   : ~QCameraMemoryPool
+ *
+ * DESCRIPTION: deconstructor of QCameraMemoryPool
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+QCameraMemoryPool::~QCameraMemoryPool()
+{
+    clear();
+    pthread_mutex_destroy(&mLock);
+}
+
+/*===========================================================================
+ * FUNCTION   : allocOne
+ *
+ * DESCRIPTION: allocate one buffer from the backing allocator
+ *
+ * PARAMETERS :
+ *   @memInfo : [output] reference to struct to store memory allocation info
+ *   @heap_id : heap id to indicate where the buffer will be allocated from
+ *   @size    : size of the buffer
+ *   @cached  : whether the buffer should be cached
+ *   @is_secure : secure mode
+ *
+ * RETURN     : int32_t type of status
+ *              NO_ERROR  -- success
+ *              none-zero failure code
+ *==========================================================================*/
+int QCameraMemoryPool::allocOne(MemInfo &memInfo, unsigned int heap_id,
+        size_t size, bool cached, bool is_secure)
+{
+    return QCameraMemory::allocOneBuffer(memInfo, heap_id, size, cached,
+            is_secure);
+}
+
+/*===========================================================================
+ * FUNCTION   : freeOne
+ *
+ * DESCRIPTION: return one buffer to the backing allocator
+ *
+ * PARAMETERS :
+ *   @memInfo : reference to struct that stores memory allocation info
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void QCameraMemoryPool::freeOne(MemInfo &memInfo)
+{
+    QCameraMemory::deallocOneBuffer(memInfo);
+}
+
+/*===========================================================================
+ * FUNCTION   : getSizeClass
+ *
+ * DESCRIPTION: map a buffer size to its power-of-two size class in 4K pages
+ *
+ * PARAMETERS :
+ *   @size    : size of the buffer
+ *
+ * RETURN     : size class index
+ *==========================================================================*/
+uint32_t QCameraMemoryPool::getSizeClass(size_t size)
+{
+    size_t pages = (size + 4095U) >> 12;
+    uint32_t cls = 0;
+
+    while ((pages >>= 1) != 0 && cls < QCAMERA_MEM_POOL_SIZE_CLASSES - 1) {
+        cls++;
+    }
+    return cls;
+}
+
+/*===========================================================================
+ * FUNCTION   : getMaxFitSize
+ *
+ * DESCRIPTION: largest cached buffer that may serve a request of given size
+ *
+ * PARAMETERS :
+ *   @alignSize : page aligned size of the request
+ *   @streamType: type of stream the request belongs to
+ *   @is_secure : secure mode
+ *
+ * RETURN     : max acceptable buffer size
+ *==========================================================================*/
+size_t QCameraMemoryPool::getMaxFitSize(size_t alignSize,
+        cam_stream_type_t streamType, bool is_secure) const
+{
+    uint64_t maxSize;
+
+    // Offline reprocess buffers are registered by size with the backend
+    if (streamType == CAM_STREAM_TYPE_OFFLINE_PROC) {
+        return alignSize;
+    }
+
+    maxSize = alignSize + (uint64_t)alignSize * mMaxWastePct / 100U;
+    if (is_secure) {
+        maxSize += QCAMERA_MEM_POOL_SECURE_ALIGN;
+    }
+    return (maxSize > SIZE_MAX) ? SIZE_MAX : (size_t)maxSize;
+}
+
+/*===========================================================================
+ * FUNCTION   : findBufferLocked
+ *
+ * DESCRIPTION: search for the best fitting cached buffer. Only the size
+ *              classes that can hold a buffer within the allowed slack are
+ *              visited; the smallest fit wins, the most recently released
+ *              one on ties.
+ *
+ * PARAMETERS :
+ *   @memInfo : reference to struct that stores additional memory allocation info
+ *   @heap_id : type of heap
+ *   @size    : size of the buffer
+ *   @cached  : whether the buffer should be cached
+ *   @streaType: type of stream this buffer belongs to
+ *   @is_secure : secure mode
+ *
+ * RETURN     : int32_t type of status
+ *              NO_ERROR  -- success
+ *              none-zero failure code
+ *==========================================================================*/
+int QCameraMemoryPool::findBufferLocked(
+        MemInfo &memInfo, unsigned int heap_id, size_t size, bool cached,
+        cam_stream_type_t streamType, bool is_secure)
+{
+    size_t alignsize = (size + 4095U) & (~4095U);
+    size_t maxsize = getMaxFitSize(alignsize, streamType, is_secure);
+    uint32_t lastCls = getSizeClass(maxsize);
+    List<QCameraPoolEntry> *bestList = NULL;
+    List<QCameraPoolEntry>::iterator best;
+
+    for (uint32_t cls = getSizeClass(alignsize); cls <= lastCls; cls++) {
+        List<QCameraPoolEntry> &bin = mPools[streamType][cls];
+        List<QCameraPoolEntry>::iterator it = bin.begin();
+        for ( ; it != bin.end(); it++) {
+            const MemInfo &info = (*it).memInfo;
+            if ((info.size < alignsize) || (info.size > maxsize) ||
+                    (info.heap_id != heap_id) || (info.cached != cached)) {
+                continue;
+            }
+            // Bins are kept in release order, so a later equal fit is
+            // also the more recently used one
+            if ((NULL == bestList) || (info.size <= (*best).memInfo.size)) {
+                bestList = &bin;
+                best = it;
+            }
+        }
+        if (NULL != bestList) {
+            // Any fit in a higher class is strictly larger
+            break;
+        }
+    }
+
+    if (NULL == bestList) {
+        return NAME_NOT_FOUND;
+    }
+
+    memInfo = (*best).memInfo;
+    bestList->erase(best);
+
+    mStats[streamType].hits++;
+    mStats[streamType].wasted_bytes += memInfo.size - alignsize;
+    mStats[streamType].idle_bytes -= memInfo.size;
+    mStats[streamType].idle_bufs--;
+    mIdleBytes -= memInfo.size;
+
+    LOGD("Found buffer %lx size %zu for %zu",
+             (unsigned long)memInfo.handle, memInfo.size, size);
+    return NO_ERROR;
+}
+
+/*===========================================================================
+ * FUNCTION   : countFitLocked
+ *
+ * DESCRIPTION: count cached buffers that could serve a request
+ *
+ * PARAMETERS :
+ *   @heap_id : type of heap
+ *   @size    : size of the buffer
+ *   @cached  : whether the buffer should be cached
+ *   @streaType: type of stream this buffer belongs to
+ *
+ * RETURN     : number of fitting buffers
+ *==========================================================================*/
+uint32_t QCameraMemoryPool::countFitLocked(unsigned int heap_id, size_t size,
+        bool cached, cam_stream_type_t streamType)
+{
+    size_t alignsize = (size + 4095U) & (~4095U);
+    size_t maxsize = getMaxFitSize(alignsize, streamType, false);
+    uint32_t lastCls = getSizeClass(maxsize);
+    uint32_t count = 0;
+
+    for (uint32_t cls = getSizeClass(alignsize); cls <= lastCls; cls++) {
+        List<QCameraPoolEntry> &bin = mPools[streamType][cls];
+        List<QCameraPoolEntry>::iterator it = bin.begin();
+        for ( ; it != bin.end(); it++) {
+            const MemInfo &info = (*it).memInfo;
+            if ((info.size >= alignsize) && (info.size <= maxsize) &&
+                    (info.heap_id == heap_id) && (info.cached == cached)) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/*===========================================================================
+ * FUNCTION   : insertLocked
+ *
+ * DESCRIPTION: park one buffer in its size class bin
+ *
+ * PARAMETERS :
+ *   @memInfo : reference to struct that stores additional memory allocation info
+ *   @streamType: Type of stream the buffers belongs to
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void QCameraMemoryPool::insertLocked(const MemInfo &memInfo,
+        cam_stream_type_t streamType)
+{
+    QCameraPoolEntry entry;
+
+    entry.memInfo = memInfo;
+    entry.lastUsed = ++mReleaseSeq;
+    mPools[streamType][getSizeClass(memInfo.size)].push_back(entry);
+
+    mStats[streamType].idle_bytes += memInfo.size;
+    mStats[streamType].idle_bufs++;
+    mIdleBytes += memInfo.size;
+}
+
+/*===========================================================================
+ * FUNCTION   : evictLRULocked
+ *
+ * DESCRIPTION: free the least recently released buffer
+ *
+ * PARAMETERS :
+ *   @streamType: stream type to evict from, CAM_STREAM_TYPE_MAX for any
+ *
+ * RETURN     : true if a buffer was freed
+ *==========================================================================*/
+bool QCameraMemoryPool::evictLRULocked(cam_stream_type_t streamType)
+{
+    int first = (streamType == CAM_STREAM_TYPE_MAX) ?
+            CAM_STREAM_TYPE_DEFAULT : streamType;
+    int last = (streamType == CAM_STREAM_TYPE_MAX) ?
+            (CAM_STREAM_TYPE_MAX - 1) : streamType;
+    List<QCameraPoolEntry> *victim = NULL;
+    int victimType = CAM_STREAM_TYPE_DEFAULT;
+
+    // Each bin is in release order, so only the bin heads are candidates
+    for (int i = first; i <= last; i++) {
+        for (int cls = 0; cls < QCAMERA_MEM_POOL_SIZE_CLASSES; cls++) {
+            List<QCameraPoolEntry> &bin = mPools[i][cls];
+            if (!bin.empty() && ((NULL == victim) ||
+                    ((*bin.begin()).lastUsed < (*victim->begin()).lastUsed))) {
+                victim = &bin;
+                victimType = i;
+            }
+        }
+    }
+
+    if (NULL == victim) {
+        return false;
+    }
+
+    MemInfo memInfo = (*victim->begin()).memInfo;
+    victim->erase(victim->begin());
+
+    mStats[victimType].idle_bytes -= memInfo.size;
+    mStats[victimType].idle_bufs--;
+    mStats[victimType].trimmed++;
+    mIdleBytes -= memInfo.size;
+
+    LOGD("Trimming buffer %lx size %zu of stream type %d",
+             (unsigned long)memInfo.handle, memInfo.size, victimType);
+    freeOne(memInfo);
+    return true;
+}
+
+/*===========================================================================
+ * FUNCTION   : trimLocked
+ *
+ * DESCRIPTION: free idle buffers until the stream and global budgets hold
+ *
+ * PARAMETERS :
+ *   @streamType: Type of stream whose budget is checked
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void QCameraMemoryPool::trimLocked(cam_stream_type_t streamType)
+{
+    while ((mStreamBudget != 0) &&
+            (mStats[streamType].idle_bytes > mStreamBudget) &&
+            evictLRULocked(streamType)) {
+    }
+
+    while ((mTotalBudget != 0) && (mIdleBytes > mTotalBudget) &&
+            evictLRULocked(CAM_STREAM_TYPE_MAX)) {
+    }
+}
+
+/*===========================================================================
+ * FUNCTION   : releaseBuffer
+ *
+ * DESCRIPTION: release one cached buffers
+ *
+ * PARAMETERS :
+ *   @memInfo : reference to struct that stores additional memory allocation info
+ *   @streamType: Type of stream the buffers belongs to
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void QCameraMemoryPool::releaseBuffer(MemInfo &memInfo,
+        cam_stream_type_t streamType)
+{
+    pthread_mutex_lock(&mLock);
+
+    insertLocked(memInfo, streamType);
+    trimLocked(streamType);
+
+    pthread_mutex_unlock(&mLock);
+}
+
+/*===========================================================================
+ * FUNCTION   : allocateBuffer
+ *
+ * DESCRIPTION: allocates a buffer from the memory pool,
+ *              it will re-use cached buffers if possible
+ *
+ * PARAMETERS :
+ *   @memInfo : reference to struct that stores additional memory allocation info
+ *   @heap_id : type of heap
+ *   @size    : size of the buffer
+ *   @cached  : whether the buffer should be cached
+ *   @streaType: type of stream this buffer belongs to
+ *   @secure_mode : secure mode
+ *
+ * RETURN     : int32_t type of status
+ *              NO_ERROR  -- success
+ *              none-zero failure code
+ *==========================================================================*/
+int QCameraMemoryPool::allocateBuffer(MemInfo &memInfo, unsigned int heap_id,
+        size_t size, bool cached, cam_stream_type_t streamType,
+        bool secure_mode)
+{
+    int rc = NO_ERROR;
+
+    pthread_mutex_lock(&mLock);
+
+    rc = findBufferLocked(memInfo, heap_id, size, cached, streamType,
+            secure_mode);
+    if (NAME_NOT_FOUND == rc ) {
+        LOGD("Buffer not found!");
+        mStats[streamType].misses++;
+        rc = allocOne(memInfo, heap_id, size, cached, secure_mode);
+    }
+
+    pthread_mutex_unlock(&mLock);
+
+    return rc;
+}
+
+/*===========================================================================
+ * FUNCTION   : prewarm
+ *
+ * DESCRIPTION: allocate buffers ahead of stream start so that the following
+ *              allocateBuffer calls are served from the pool. Buffers that
+ *              already fit are counted, and allocation stops short of the
+ *              budgets instead of trimming other streams.
+ *
+ * PARAMETERS :
+ *   @streamType: type of stream the buffers will be used by
+ *   @heap_id : type of heap
+ *   @size    : size of each buffer
+ *   @cached  : whether the buffers should be cached
+ *   @count   : number of buffers the stream needs
+ *
+ * RETURN     : int32_t type of status
+ *              NO_ERROR  -- success
+ *              none-zero failure code
+ *==========================================================================*/
+int QCameraMemoryPool::prewarm(cam_stream_type_t streamType,
+        unsigned int heap_id, size_t size, bool cached, uint8_t count)
+{
+    int rc = NO_ERROR;
+    size_t alignsize = (size + 4095U) & (~4095U);
+    uint32_t added = 0;
+
+    if ((streamType <= CAM_STREAM_TYPE_DEFAULT) ||
+            (streamType >= CAM_STREAM_TYPE_MAX) || (0 == size)) {
+        return BAD_VALUE;
+    }
+
+    while (rc == NO_ERROR) {
+        MemInfo memInfo;
+
+        pthread_mutex_lock(&mLock);
+        if ((countFitLocked(heap_id, size, cached, streamType) >= count) ||
+                ((mStreamBudget != 0) &&
+                 (mStats[streamType].idle_bytes + alignsize > mStreamBudget)) ||
+                ((mTotalBudget != 0) &&
+                 (mIdleBytes + alignsize > mTotalBudget))) {
+            pthread_mutex_unlock(&mLock);
+            break;
+        }
+        pthread_mutex_unlock(&mLock);
+
+        // Allocate without the lock so running streams are not held up
+        rc = allocOne(memInfo, heap_id, size, cached, false);
+        if (rc != NO_ERROR) {
+            LOGE("Prewarm allocation failed for stream type %d", streamType);
+            break;
+        }
+
+        pthread_mutex_lock(&mLock);
+        insertLocked(memInfo, streamType);
+        mStats[streamType].prewarmed++;
+        added++;
+        trimLocked(streamType);
+        pthread_mutex_unlock(&mLock);
+    }
+
+    LOGH("stream type %d size %zu count %d: %u buffers added",
+            streamType, size, count, added);
+    return rc;
+}
+
+/*===========================================================================
+ * FUNCTION   : setBudget
+ *
+ * DESCRIPTION: set the byte budgets for idle pooled buffers and trim to them
+ *
+ * PARAMETERS :
+ *   @totalBudget : budget across all stream types, 0 for no limit
+ *   @streamBudget: budget of each stream type, 0 for no limit
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void QCameraMemoryPool::setBudget(size_t totalBudget, size_t streamBudget)
+{
+    pthread_mutex_lock(&mLock);
+
+    mTotalBudget = totalBudget;
+    mStreamBudget = streamBudget;
+    for (int i = CAM_STREAM_TYPE_DEFAULT; i < CAM_STREAM_TYPE_MAX; i++) {
+        trimLocked((cam_stream_type_t)i);
+    }
+
+    pthread_mutex_unlock(&mLock);
+}
+
+/*===========================================================================
+ * FUNCTION   : setMaxWaste
+ *
+ * DESCRIPTION: set how much larger than requested a reused buffer may be
+ *
+ * PARAMETERS :
+ *   @maxWastePct : allowed slack in percent of the requested size
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void QCameraMemoryPool::setMaxWaste(uint32_t maxWastePct)
+{
+    pthread_mutex_lock(&mLock);
+    mMaxWastePct = maxWastePct;
+    pthread_mutex_unlock(&mLock);
+}
+
+/*===========================================================================
+ * FUNCTION   : getStats
+ *
+ * DESCRIPTION: query pool counters
+ *
+ * PARAMETERS :
+ *   @streamType: stream type to query, CAM_STREAM_TYPE_MAX for the totals
+ *   @stats   : [output] pool counters
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void QCameraMemoryPool::getStats(cam_stream_type_t streamType,
+        QCameraMemPoolStats &stats)
+{
+    pthread_mutex_lock(&mLock);
+
+    if (streamType < CAM_STREAM_TYPE_MAX) {
+        stats = mStats[streamType];
+    } else {
+        memset(&stats, 0, sizeof(stats));
+        for (int i = CAM_STREAM_TYPE_DEFAULT; i < CAM_STREAM_TYPE_MAX; i++) {
+            stats.hits += mStats[i].hits;
+            stats.misses += mStats[i].misses;
+            stats.prewarmed += mStats[i].prewarmed;
+            stats.trimmed += mStats[i].trimmed;
+            stats.wasted_bytes += mStats[i].wasted_bytes;
+            stats.idle_bytes += mStats[i].idle_bytes;
+            stats.idle_bufs += mStats[i].idle_bufs;
+        }
+    }
+
+    pthread_mutex_unlock(&mLock);
+}
+
+/*===========================================================================
+ * FUNCTION   : clear
+ *
+ * DESCRIPTION: clears all cached buffers
+ *
+ * PARAMETERS : none
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void QCameraMemoryPool::clear()
+{
+    pthread_mutex_lock(&mLock);
+
+    for (int i = CAM_STREAM_TYPE_DEFAULT; i < CAM_STREAM_TYPE_MAX; i++ ) {
+        for (int cls = 0; cls < QCAMERA_MEM_POOL_SIZE_CLASSES; cls++) {
+            List<QCameraPoolEntry> &bin = mPools[i][cls];
+            List<QCameraPoolEntry>::iterator it = bin.begin();
+            for( ; it != bin.end() ; it++) {
+                freeOne((*it).memInfo);
+            }
+            bin.clear();
+        }
+        mStats[i].idle_bytes = 0;
+        mStats[i].idle_bufs = 0;
+    }
+    mIdleBytes = 0;
+
+    pthread_mutex_unlock(&mLock);
+}
+
+/*===========================================================================
+ * FUNCTION   : dump
+ *
+ * DESCRIPTION: pool counters for the HAL dump
+ *
+ * PARAMETERS : none
+ *
+ * RETURN     : String8 with the pool state
+ *==========================================================================*/
+String8 QCameraMemoryPool::dump()
+{
+    String8 str;
+
+    pthread_mutex_lock(&mLock);
+
+    str.appendFormat("idle %zu bytes, budget %zu (per stream %zu), "
+            "max waste %u%%\n",
+            mIdleBytes, mTotalBudget, mStreamBudget, mMaxWastePct);
+    for (int i = CAM_STREAM_TYPE_DEFAULT; i < CAM_STREAM_TYPE_MAX; i++) {
+        const QCameraMemPoolStats &s = mStats[i];
+        if ((s.hits | s.misses | s.prewarmed | s.idle_bufs) == 0) {
+            continue;
+        }
+        str.appendFormat("  stream type %d: hits %u misses %u prewarmed %u "
+                "trimmed %u wasted %llu bytes, idle %u bufs %zu bytes\n",
+                i, s.hits, s.misses, s.prewarmed, s.trimmed,
+                (unsigned long long)s.wasted_bytes, s.idle_bufs,
+                s.idle_bytes);
+    }
+
+    pthread_mutex_unlock(&mLock);
+
+    return str;
+}
+
+}; //namespace qcamera
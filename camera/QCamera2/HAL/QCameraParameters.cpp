@@ -64,855 +64,15 @@ extern "C" {
 #define CAMERA_MIN_SECURE_BUFFERS 2
 
 namespace qcamera {
-// Parameter keys to communicate between camera application and driver.
-const char QCameraParameters::KEY_QC_SUPPORTED_HFR_SIZES[] = "hfr-size-values";
-const char QCameraParameters::KEY_QC_PREVIEW_FRAME_RATE_MODE[] = "preview-frame-rate-mode";
-const char QCameraParameters::KEY_QC_SUPPORTED_PREVIEW_FRAME_RATE_MODES[] = "preview-frame-rate-modes";
-const char QCameraParameters::KEY_QC_PREVIEW_FRAME_RATE_AUTO_MODE[] = "frame-rate-auto";
-const char QCameraParameters::KEY_QC_PREVIEW_FRAME_RATE_FIXED_MODE[] = "frame-rate-fixed";
-const char QCameraParameters::KEY_QC_TOUCH_AF_AEC[] = "touch-af-aec";
-const char QCameraParameters::KEY_QC_SUPPORTED_TOUCH_AF_AEC[] = "touch-af-aec-values";
-const char QCameraParameters::KEY_QC_TOUCH_INDEX_AEC[] = "touch-index-aec";
-const char QCameraParameters::KEY_QC_TOUCH_INDEX_AF[] = "touch-index-af";
-const char QCameraParameters::KEY_QC_SCENE_DETECT[] = "scene-detect";
-const char QCameraParameters::KEY_QC_SUPPORTED_SCENE_DETECT[] = "scene-detect-values";
-const char QCameraParameters::KEY_QC_ISO_MODE[] = "iso";
-const char QCameraParameters::KEY_QC_CONTINUOUS_ISO[] = "continuous-iso";
-const char QCameraParameters::KEY_QC_MIN_ISO[] = "min-iso";
-const char QCameraParameters::KEY_QC_MAX_ISO[] = "max-iso";
-const char QCameraParameters::KEY_QC_SUPPORTED_ISO_MODES[] = "iso-values";
-const char QCameraParameters::KEY_QC_EXPOSURE_TIME[] = "exposure-time";
-const char QCameraParameters::KEY_QC_MIN_EXPOSURE_TIME[] = "min-exposure-time";
-const char QCameraParameters::KEY_QC_MAX_EXPOSURE_TIME[] = "max-exposure-time";
-const char QCameraParameters::KEY_QC_CURRENT_EXPOSURE_TIME[] = "cur-exposure-time";
-const char QCameraParameters::KEY_QC_CURRENT_ISO[] = "cur-iso";
-const char QCameraParameters::KEY_QC_LENSSHADE[] = "lensshade";
-const char QCameraParameters::KEY_QC_SUPPORTED_LENSSHADE_MODES[] = "lensshade-values";
-const char QCameraParameters::KEY_QC_AUTO_EXPOSURE[] = "auto-exposure";
-const char QCameraParameters::KEY_QC_SUPPORTED_AUTO_EXPOSURE[] = "auto-exposure-values";
-const char QCameraParameters::KEY_QC_DENOISE[] = "denoise";
-const char QCameraParameters::KEY_QC_SUPPORTED_DENOISE[] = "denoise-values";
-const char QCameraParameters::KEY_QC_FOCUS_ALGO[] = "selectable-zone-af";
-const char QCameraParameters::KEY_QC_SUPPORTED_FOCUS_ALGOS[] = "selectable-zone-af-values";
-const char QCameraParameters::KEY_QC_MANUAL_FOCUS_POSITION[] = "manual-focus-position";
-const char QCameraParameters::KEY_QC_MANUAL_FOCUS_POS_TYPE[] = "manual-focus-pos-type";
-const char QCameraParameters::KEY_QC_MIN_FOCUS_POS_INDEX[] = "min-focus-pos-index";
-const char QCameraParameters::KEY_QC_MAX_FOCUS_POS_INDEX[] = "max-focus-pos-index";
-const char QCameraParameters::KEY_QC_MIN_FOCUS_POS_DAC[] = "min-focus-pos-dac";
-const char QCameraParameters::KEY_QC_MAX_FOCUS_POS_DAC[] = "max-focus-pos-dac";
-const char QCameraParameters::KEY_QC_MIN_FOCUS_POS_RATIO[] = "min-focus-pos-ratio";
-const char QCameraParameters::KEY_QC_MAX_FOCUS_POS_RATIO[] = "max-focus-pos-ratio";
-const char QCameraParameters::KEY_QC_FOCUS_POSITION_SCALE[] = "cur-focus-scale";
-const char QCameraParameters::KEY_QC_MIN_FOCUS_POS_DIOPTER[] = "min-focus-pos-diopter";
-const char QCameraParameters::KEY_QC_MAX_FOCUS_POS_DIOPTER[] = "max-focus-pos-diopter";
-const char QCameraParameters::KEY_QC_FOCUS_POSITION_DIOPTER[] = "cur-focus-diopter";
-const char QCameraParameters::KEY_QC_FACE_DETECTION[] = "face-detection";
-const char QCameraParameters::KEY_QC_SUPPORTED_FACE_DETECTION[] = "face-detection-values";
-const char QCameraParameters::KEY_QC_FACE_RECOGNITION[] = "face-recognition";
-const char QCameraParameters::KEY_QC_SUPPORTED_FACE_RECOGNITION[] = "face-recognition-values";
-const char QCameraParameters::KEY_QC_MEMORY_COLOR_ENHANCEMENT[] = "mce";
-const char QCameraParameters::KEY_QC_SUPPORTED_MEM_COLOR_ENHANCE_MODES[] = "mce-values";
-const char QCameraParameters::KEY_QC_DIS[] = "dis";
-const char QCameraParameters::KEY_QC_OIS[] = "ois";
-const char QCameraParameters::KEY_QC_SUPPORTED_DIS_MODES[] = "dis-values";
-const char QCameraParameters::KEY_QC_SUPPORTED_OIS_MODES[] = "ois-values";
-const char QCameraParameters::KEY_QC_VIDEO_HIGH_FRAME_RATE[] = "video-hfr";
-const char QCameraParameters::KEY_QC_VIDEO_HIGH_SPEED_RECORDING[] = "video-hsr";
-const char QCameraParameters::KEY_QC_SUPPORTED_VIDEO_HIGH_FRAME_RATE_MODES[] = "video-hfr-values";
-const char QCameraParameters::KEY_QC_REDEYE_REDUCTION[] = "redeye-reduction";
-const char QCameraParameters::KEY_QC_SUPPORTED_REDEYE_REDUCTION[] = "redeye-reduction-values";
-const char QCameraParameters::KEY_QC_HIGH_DYNAMIC_RANGE_IMAGING[] = "hdr";
-const char QCameraParameters::KEY_QC_SUPPORTED_HDR_IMAGING_MODES[] = "hdr-values";
-const char QCameraParameters::KEY_QC_ZSL[] = "zsl";
-const char QCameraParameters::KEY_QC_SUPPORTED_ZSL_MODES[] = "zsl-values";
-const char QCameraParameters::KEY_QC_ZSL_BURST_INTERVAL[] = "capture-burst-interval";
-const char QCameraParameters::KEY_QC_ZSL_BURST_LOOKBACK[] = "capture-burst-retroactive";
-const char QCameraParameters::KEY_QC_ZSL_QUEUE_DEPTH[] = "capture-burst-queue-depth";
-const char QCameraParameters::KEY_QC_CAMERA_MODE[] = "camera-mode";
-const char QCameraParameters::KEY_QC_AE_BRACKET_HDR[] = "ae-bracket-hdr";
-const char QCameraParameters::KEY_QC_SUPPORTED_AE_BRACKET_MODES[] = "ae-bracket-hdr-values";
-const char QCameraParameters::KEY_QC_SUPPORTED_RAW_FORMATS[] = "raw-format-values";
-const char QCameraParameters::KEY_QC_RAW_FORMAT[] = "raw-format";
-const char QCameraParameters::KEY_QC_ORIENTATION[] = "orientation";
-const char QCameraParameters::KEY_QC_SELECTABLE_ZONE_AF[] = "selectable-zone-af";
-const char QCameraParameters::KEY_QC_CAPTURE_BURST_EXPOSURE[] = "capture-burst-exposures";
-const char QCameraParameters::KEY_QC_NUM_SNAPSHOT_PER_SHUTTER[] = "num-snaps-per-shutter";
-const char QCameraParameters::KEY_QC_NUM_RETRO_BURST_PER_SHUTTER[] = "num-retro-burst-per-shutter";
-const char QCameraParameters::KEY_QC_SNAPSHOT_BURST_LED_ON_PERIOD[] = "zsl-burst-led-on-period";
-const char QCameraParameters::KEY_QC_NO_DISPLAY_MODE[] = "no-display-mode";
-const char QCameraParameters::KEY_QC_RAW_PICUTRE_SIZE[] = "raw-size";
-const char QCameraParameters::KEY_QC_SUPPORTED_SKIN_TONE_ENHANCEMENT_MODES[] = "skinToneEnhancement-values";
-const char QCameraParameters::KEY_QC_SUPPORTED_LIVESNAPSHOT_SIZES[] = "supported-live-snapshot-sizes";
-const char QCameraParameters::KEY_QC_SUPPORTED_HDR_NEED_1X[] = "hdr-need-1x-values";
-const char QCameraParameters::KEY_QC_HDR_NEED_1X[] = "hdr-need-1x";
-const char QCameraParameters::KEY_QC_PREVIEW_FLIP[] = "preview-flip";
-const char QCameraParameters::KEY_QC_VIDEO_FLIP[] = "video-flip";
-const char QCameraParameters::KEY_QC_SNAPSHOT_PICTURE_FLIP[] = "snapshot-picture-flip";
-const char QCameraParameters::KEY_QC_SUPPORTED_FLIP_MODES[] = "flip-mode-values";
-const char QCameraParameters::KEY_QC_VIDEO_HDR[] = "video-hdr";
-const char QCameraParameters::KEY_QC_SENSOR_HDR[] = "sensor-hdr";
-const char QCameraParameters::KEY_QC_VT_ENABLE[] = "avtimer";
-const char QCameraParameters::KEY_QC_SUPPORTED_VIDEO_HDR_MODES[] = "video-hdr-values";
-const char QCameraParameters::KEY_QC_SUPPORTED_SENSOR_HDR_MODES[] = "sensor-hdr-values";
-const char QCameraParameters::KEY_QC_AUTO_HDR_ENABLE [] = "auto-hdr-enable";
-const char QCameraParameters::KEY_QC_SNAPSHOT_BURST_NUM[] = "snapshot-burst-num";
-const char QCameraParameters::KEY_QC_SNAPSHOT_FD_DATA[] = "snapshot-fd-data-enable";
-const char QCameraParameters::KEY_QC_TINTLESS_ENABLE[] = "tintless";
-const char QCameraParameters::KEY_QC_SCENE_SELECTION[] = "scene-selection";
-const char QCameraParameters::KEY_QC_CDS_MODE[] = "cds-mode";
-const char QCameraParameters::KEY_QC_VIDEO_CDS_MODE[] = "video-cds-mode";
-const char QCameraParameters::KEY_QC_SUPPORTED_CDS_MODES[] = "cds-mode-values";
-const char QCameraParameters::KEY_QC_SUPPORTED_VIDEO_CDS_MODES[] = "video-cds-mode-values";
-const char QCameraParameters::KEY_QC_TNR_MODE[] = "tnr-mode";
-const char QCameraParameters::KEY_QC_VIDEO_TNR_MODE[] = "video-tnr-mode";
-const char QCameraParameters::KEY_QC_SUPPORTED_TNR_MODES[] = "tnr-mode-values";
-const char QCameraParameters::KEY_QC_SUPPORTED_VIDEO_TNR_MODES[] = "video-tnr-mode-values";
-const char QCameraParameters::KEY_QC_VIDEO_ROTATION[] = "video-rotation";
-const char QCameraParameters::KEY_QC_SUPPORTED_VIDEO_ROTATION_VALUES[] = "video-rotation-values";
-const char QCameraParameters::KEY_QC_AF_BRACKET[] = "af-bracket";
-const char QCameraParameters::KEY_QC_SUPPORTED_AF_BRACKET_MODES[] = "af-bracket-values";
-const char QCameraParameters::KEY_QC_RE_FOCUS[] = "re-focus";
-const char QCameraParameters::KEY_QC_SUPPORTED_RE_FOCUS_MODES[] = "re-focus-values";
-const char QCameraParameters::KEY_QC_CHROMA_FLASH[] = "chroma-flash";
-const char QCameraParameters::KEY_QC_SUPPORTED_CHROMA_FLASH_MODES[] = "chroma-flash-values";
-const char QCameraParameters::KEY_QC_OPTI_ZOOM[] = "opti-zoom";
-const char QCameraParameters::KEY_QC_SEE_MORE[] = "see-more";
-const char QCameraParameters::KEY_QC_STILL_MORE[] = "still-more";
-const char QCameraParameters::KEY_QC_SUPPORTED_OPTI_ZOOM_MODES[] = "opti-zoom-values";
-const char QCameraParameters::KEY_QC_HDR_MODE[] = "hdr-mode";
-const char QCameraParameters::KEY_QC_SUPPORTED_KEY_QC_HDR_MODES[] = "hdr-mode-values";
-const char QCameraParameters::KEY_QC_TRUE_PORTRAIT[] = "true-portrait";
-const char QCameraParameters::KEY_QC_SUPPORTED_TRUE_PORTRAIT_MODES[] = "true-portrait-values";
-const char QCameraParameters::KEY_QC_SUPPORTED_SEE_MORE_MODES[] = "see-more-values";
-const char QCameraParameters::KEY_QC_SUPPORTED_STILL_MORE_MODES[] = "still-more-values";
-const char QCameraParameters::KEY_INTERNAL_PERVIEW_RESTART[] = "internal-restart";
-const char QCameraParameters::KEY_QC_RDI_MODE[] = "rdi-mode";
-const char QCameraParameters::KEY_QC_SUPPORTED_RDI_MODES[] = "rdi-mode-values";
-const char QCameraParameters::KEY_QC_SECURE_MODE[] = "secure-mode";
-const char QCameraParameters::KEY_QC_SECURE_MODE_UBWC[] = "secure-mode-ubwc";
-const char QCameraParameters::KEY_QC_SECURE_QUEUE_DEPTH[] = "secure-mode-queue-depth";
-const char QCameraParameters::KEY_QC_SECURE_MODE_AEC_MODE[] = "secure-mode-aec-mode";
-const char QCameraParameters::KEY_QC_SECURE_MODE_EXPOSURE_TIME[] = "secure-mode-exposure-time";
-const char QCameraParameters::KEY_QC_SECURE_MODE_SENSITIVITY[] = "secure-mode-sensitivity";
-const char QCameraParameters::KEY_QC_SUPPORTED_SECURE_MODES[] = "secure-mode-values";
-const char QCameraParameters::ISO_HJR[] = "ISO_HJR";
-const char QCameraParameters::KEY_QC_AUTO_HDR_SUPPORTED[] = "auto-hdr-supported";
-const char QCameraParameters::KEY_QC_LONGSHOT_SUPPORTED[] = "longshot-supported";
-const char QCameraParameters::KEY_QC_ZSL_HDR_SUPPORTED[] = "zsl-hdr-supported";
-const char QCameraParameters::KEY_QC_WB_MANUAL_CCT[] = "wb-manual-cct";
-const char QCameraParameters::KEY_QC_MIN_WB_CCT[] = "min-wb-cct";
-const char QCameraParameters::KEY_QC_MAX_WB_CCT[] = "max-wb-cct";
-
-const char QCameraParameters::KEY_QC_MANUAL_WB_GAINS[] = "manual-wb-gains";
-const char QCameraParameters::KEY_QC_MIN_WB_GAIN[] = "min-wb-gain";
-const char QCameraParameters::KEY_QC_MAX_WB_GAIN[] = "max-wb-gain";
-
-const char QCameraParameters::KEY_QC_MANUAL_WB_TYPE[] = "manual-wb-type";
-const char QCameraParameters::KEY_QC_MANUAL_WB_VALUE[] = "manual-wb-value";
-
-const char QCameraParameters::WHITE_BALANCE_MANUAL[] = "manual";
-const char QCameraParameters::FOCUS_MODE_MANUAL_POSITION[] = "manual";
-const char QCameraParameters::KEY_QC_CACHE_VIDEO_BUFFERS[] = "cache-video-buffers";
-
-const char QCameraParameters::KEY_QC_LONG_SHOT[] = "long-shot";
-const char QCameraParameters::KEY_QC_INITIAL_EXPOSURE_INDEX[] = "initial-exp-index";
-const char QCameraParameters::KEY_QC_INSTANT_AEC[] = "instant-aec";
-const char QCameraParameters::KEY_QC_INSTANT_CAPTURE[] = "instant-capture";
-const char QCameraParameters::KEY_QC_INSTANT_AEC_SUPPORTED_MODES[] = "instant-aec-values";
-const char QCameraParameters::KEY_QC_INSTANT_CAPTURE_SUPPORTED_MODES[] = "instant-capture-values";
-
-const char QCameraParameters::KEY_QC_BOKEH_MODE[] = "bokeh-mode";
-const char QCameraParameters::KEY_QC_SUPPORTED_DEGREES_OF_BLUR[] = "supported-blur-degrees";
-const char QCameraParameters::KEY_QC_IS_BOKEH_MODE_SUPPORTED[] = "is-bokeh-supported";
-const char QCameraParameters::KEY_QC_IS_BOKEH_MPO_SUPPORTED[] = "is-bokeh-mpo-supported";
-const char QCameraParameters::KEY_QC_BOKEH_BLUR_VALUE[] = "bokeh-blur-value";
-const char QCameraParameters::KEY_QC_BOKEH_MPO_MODE[] = "bokeh-mpo-mode";
-const char QCameraParameters::KEY_QC_BOKEH_PICTURE_SIZE[] = "bokeh-picture-size";
-
-const char QCameraParameters::KEY_QC_VFE1_RESERVED_RDI[] = "vfe1-reserved-rdi";
-
-// Values for effect settings.
-const char QCameraParameters::EFFECT_EMBOSS[] = "emboss";
-const char QCameraParameters::EFFECT_SKETCH[] = "sketch";
-const char QCameraParameters::EFFECT_NEON[] = "neon";
-const char QCameraParameters::EFFECT_BEAUTY[] = "beauty";
-
-
-// Values for auto exposure settings.
-const char QCameraParameters::TOUCH_AF_AEC_OFF[] = "touch-off";
-const char QCameraParameters::TOUCH_AF_AEC_ON[] = "touch-on";
-
-// Values for scene mode settings.
-const char QCameraParameters::SCENE_MODE_ASD[] = "asd";   // corresponds to CAMERA_BESTSHOT_AUTO in HAL
-const char QCameraParameters::SCENE_MODE_BACKLIGHT[] = "backlight";
-const char QCameraParameters::SCENE_MODE_FLOWERS[] = "flowers";
-const char QCameraParameters::SCENE_MODE_AR[] = "AR";
-const char QCameraParameters::SCENE_MODE_HDR[] = "hdr";
-
-// Formats for setPreviewFormat and setPictureFormat.
-const char QCameraParameters::PIXEL_FORMAT_YUV420SP_ADRENO[] = "yuv420sp-adreno";
-const char QCameraParameters::PIXEL_FORMAT_YV12[] = "yuv420p";
-const char QCameraParameters::PIXEL_FORMAT_NV12[] = "nv12";
-const char QCameraParameters::QC_PIXEL_FORMAT_NV12_VENUS[] = "nv12-venus";
-
-// Values for raw image formats
-const char QCameraParameters::QC_PIXEL_FORMAT_YUV_RAW_8BIT_YUYV[] = "yuv-raw8-yuyv";
-const char QCameraParameters::QC_PIXEL_FORMAT_YUV_RAW_8BIT_YVYU[] = "yuv-raw8-yvyu";
-const char QCameraParameters::QC_PIXEL_FORMAT_YUV_RAW_8BIT_UYVY[] = "yuv-raw8-uyvy";
-const char QCameraParameters::QC_PIXEL_FORMAT_YUV_RAW_8BIT_VYUY[] = "yuv-raw8-vyuy";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_8GBRG[] = "bayer-qcom-8gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_8GRBG[] = "bayer-qcom-8grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_8RGGB[] = "bayer-qcom-8rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_8BGGR[] = "bayer-qcom-8bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_10GBRG[] = "bayer-qcom-10gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_10GRBG[] = "bayer-qcom-10grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_10RGGB[] = "bayer-qcom-10rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_10BGGR[] = "bayer-qcom-10bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_12GBRG[] = "bayer-qcom-12gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_12GRBG[] = "bayer-qcom-12grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_12RGGB[] = "bayer-qcom-12rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_12BGGR[] = "bayer-qcom-12bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_14GBRG[] = "bayer-qcom-14gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_14GRBG[] = "bayer-qcom-14grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_14RGGB[] = "bayer-qcom-14rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_QCOM_RAW_14BGGR[] = "bayer-qcom-14bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_8GBRG[] = "bayer-mipi-8gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_8GRBG[] = "bayer-mipi-8grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_8RGGB[] = "bayer-mipi-8rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_8BGGR[] = "bayer-mipi-8bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_10GBRG[] = "bayer-mipi-10gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_10GRBG[] = "bayer-mipi-10grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_10RGGB[] = "bayer-mipi-10rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_10BGGR[] = "bayer-mipi-10bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_12GBRG[] = "bayer-mipi-12gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_12GRBG[] = "bayer-mipi-12grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_12RGGB[] = "bayer-mipi-12rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_12BGGR[] = "bayer-mipi-12bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_14GBRG[] = "bayer-mipi-14gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_14GRBG[] = "bayer-mipi-14grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_14RGGB[] = "bayer-mipi-14rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_MIPI_RAW_14BGGR[] = "bayer-mipi-14bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_8GBRG[] = "bayer-ideal-qcom-8gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_8GRBG[] = "bayer-ideal-qcom-8grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_8RGGB[] = "bayer-ideal-qcom-8rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_8BGGR[] = "bayer-ideal-qcom-8bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_10GBRG[] = "bayer-ideal-qcom-10gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_10GRBG[] = "bayer-ideal-qcom-10grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_10RGGB[] = "bayer-ideal-qcom-10rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_10BGGR[] = "bayer-ideal-qcom-10bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_12GBRG[] = "bayer-ideal-qcom-12gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_12GRBG[] = "bayer-ideal-qcom-12grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_12RGGB[] = "bayer-ideal-qcom-12rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_12BGGR[] = "bayer-ideal-qcom-12bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_14GBRG[] = "bayer-ideal-qcom-14gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_14GRBG[] = "bayer-ideal-qcom-14grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_14RGGB[] = "bayer-ideal-qcom-14rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_14BGGR[] = "bayer-ideal-qcom-14bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_8GBRG[] = "bayer-ideal-mipi-8gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_8GRBG[] = "bayer-ideal-mipi-8grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_8RGGB[] = "bayer-ideal-mipi-8rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_8BGGR[] = "bayer-ideal-mipi-8bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_10GBRG[] = "bayer-ideal-mipi-10gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_10GRBG[] = "bayer-ideal-mipi-10grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_10RGGB[] = "bayer-ideal-mipi-10rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_10BGGR[] = "bayer-ideal-mipi-10bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_12GBRG[] = "bayer-ideal-mipi-12gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_12GRBG[] = "bayer-ideal-mipi-12grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_12RGGB[] = "bayer-ideal-mipi-12rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_12BGGR[] = "bayer-ideal-mipi-12bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_14GBRG[] = "bayer-ideal-mipi-14gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_14GRBG[] = "bayer-ideal-mipi-14grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_14RGGB[] = "bayer-ideal-mipi-14rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_14BGGR[] = "bayer-ideal-mipi-14bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN8_8GBRG[] = "bayer-ideal-plain8-8gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN8_8GRBG[] = "bayer-ideal-plain8-8grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN8_8RGGB[] = "bayer-ideal-plain8-8rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN8_8BGGR[] = "bayer-ideal-plain8-8bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_8GBRG[] = "bayer-ideal-plain16-8gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_8GRBG[] = "bayer-ideal-plain16-8grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_8RGGB[] = "bayer-ideal-plain16-8rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_8BGGR[] = "bayer-ideal-plain16-8bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_10GBRG[] = "bayer-ideal-plain16-10gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_10GRBG[] = "bayer-ideal-plain16-10grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_10RGGB[] = "bayer-ideal-plain16-10rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_10BGGR[] = "bayer-ideal-plain16-10bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_12GBRG[] = "bayer-ideal-plain16-12gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_12GRBG[] = "bayer-ideal-plain16-12grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_12RGGB[] = "bayer-ideal-plain16-12rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_12BGGR[] = "bayer-ideal-plain16-12bggr";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_14GBRG[] = "bayer-ideal-plain16-14gbrg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_14GRBG[] = "bayer-ideal-plain16-14grbg";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_14RGGB[] = "bayer-ideal-plain16-14rggb";
-const char QCameraParameters::QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_14BGGR[] = "bayer-ideal-plain16-14bggr";
-
-// Values for ISO Settings
-const char QCameraParameters::ISO_AUTO[] = "auto";
-const char QCameraParameters::ISO_100[] = "ISO100";
-const char QCameraParameters::ISO_200[] = "ISO200";
-const char QCameraParameters::ISO_400[] = "ISO400";
-const char QCameraParameters::ISO_800[] = "ISO800";
-const char QCameraParameters::ISO_1600[] = "ISO1600";
-const char QCameraParameters::ISO_3200[] = "ISO3200";
-const char QCameraParameters::ISO_MANUAL[] = "manual";
-
-
-// Values for auto exposure settings.
-const char QCameraParameters::AUTO_EXPOSURE_FRAME_AVG[] = "frame-average";
-const char QCameraParameters::AUTO_EXPOSURE_CENTER_WEIGHTED[] = "center-weighted";
-const char QCameraParameters::AUTO_EXPOSURE_SPOT_METERING[] = "spot-metering";
-const char QCameraParameters::AUTO_EXPOSURE_SMART_METERING[] = "smart-metering";
-const char QCameraParameters::AUTO_EXPOSURE_USER_METERING[] = "user-metering";
-const char QCameraParameters::AUTO_EXPOSURE_SPOT_METERING_ADV[] = "spot-metering-adv";
-const char QCameraParameters::AUTO_EXPOSURE_CENTER_WEIGHTED_ADV[] = "center-weighted-adv";
-
-// Values for instant AEC modes
-const char QCameraParameters::KEY_QC_INSTANT_AEC_DISABLE[] = "0";
-const char QCameraParameters::KEY_QC_INSTANT_AEC_AGGRESSIVE_AEC[] = "1";
-const char QCameraParameters::KEY_QC_INSTANT_AEC_FAST_AEC[] = "2";
-
-// Values for instant capture modes
-const char QCameraParameters::KEY_QC_INSTANT_CAPTURE_DISABLE[] = "0";
-const char QCameraParameters::KEY_QC_INSTANT_CAPTURE_AGGRESSIVE_AEC[] = "1";
-const char QCameraParameters::KEY_QC_INSTANT_CAPTURE_FAST_AEC[] = "2";
-
-const char QCameraParameters::KEY_QC_GPS_LATITUDE_REF[] = "gps-latitude-ref";
-const char QCameraParameters::KEY_QC_GPS_LONGITUDE_REF[] = "gps-longitude-ref";
-const char QCameraParameters::KEY_QC_GPS_ALTITUDE_REF[] = "gps-altitude-ref";
-const char QCameraParameters::KEY_QC_GPS_STATUS[] = "gps-status";
-
-const char QCameraParameters::KEY_QC_HISTOGRAM[] = "histogram";
-const char QCameraParameters::KEY_QC_SUPPORTED_HISTOGRAM_MODES[] = "histogram-values";
-
-const char QCameraParameters::VALUE_ENABLE[] = "enable";
-const char QCameraParameters::VALUE_DISABLE[] = "disable";
-const char QCameraParameters::VALUE_OFF[] = "off";
-const char QCameraParameters::VALUE_ON[] = "on";
-const char QCameraParameters::VALUE_TRUE[] = "true";
-const char QCameraParameters::VALUE_FALSE[] = "false";
-
-const char QCameraParameters::VALUE_FAST[] = "fast";
-const char QCameraParameters::VALUE_HIGH_QUALITY[] = "high-quality";
-
-const char QCameraParameters::KEY_QC_SHARPNESS[] = "sharpness";
-const char QCameraParameters::KEY_QC_MIN_SHARPNESS[] = "min-sharpness";
-const char QCameraParameters::KEY_QC_MAX_SHARPNESS[] = "max-sharpness";
-const char QCameraParameters::KEY_QC_SHARPNESS_STEP[] = "sharpness-step";
-const char QCameraParameters::KEY_QC_CONTRAST[] = "contrast";
-const char QCameraParameters::KEY_QC_MIN_CONTRAST[] = "min-contrast";
-const char QCameraParameters::KEY_QC_MAX_CONTRAST[] = "max-contrast";
-const char QCameraParameters::KEY_QC_CONTRAST_STEP[] = "contrast-step";
-const char QCameraParameters::KEY_QC_SATURATION[] = "saturation";
-const char QCameraParameters::KEY_QC_MIN_SATURATION[] = "min-saturation";
-const char QCameraParameters::KEY_QC_MAX_SATURATION[] = "max-saturation";
-const char QCameraParameters::KEY_QC_SATURATION_STEP[] = "saturation-step";
-const char QCameraParameters::KEY_QC_BRIGHTNESS[] = "luma-adaptation";
-const char QCameraParameters::KEY_QC_MIN_BRIGHTNESS[] = "min-brightness";
-const char QCameraParameters::KEY_QC_MAX_BRIGHTNESS[] = "max-brightness";
-const char QCameraParameters::KEY_QC_BRIGHTNESS_STEP[] = "brightness-step";
-const char QCameraParameters::KEY_QC_SCE_FACTOR[] = "skinToneEnhancement";
-const char QCameraParameters::KEY_QC_MIN_SCE_FACTOR[] = "min-sce-factor";
-const char QCameraParameters::KEY_QC_MAX_SCE_FACTOR[] = "max-sce-factor";
-const char QCameraParameters::KEY_QC_SCE_FACTOR_STEP[] = "sce-factor-step";
-
-const char QCameraParameters::KEY_QC_MAX_NUM_REQUESTED_FACES[] = "qc-max-num-requested-faces";
-
-//Values for DENOISE
-const char QCameraParameters::DENOISE_OFF[] = "denoise-off";
-const char QCameraParameters::DENOISE_ON[] = "denoise-on";
-
-// Values for selectable zone af Settings
-const char QCameraParameters::FOCUS_ALGO_AUTO[] = "auto";
-const char QCameraParameters::FOCUS_ALGO_SPOT_METERING[] = "spot-metering";
-const char QCameraParameters::FOCUS_ALGO_CENTER_WEIGHTED[] = "center-weighted";
-const char QCameraParameters::FOCUS_ALGO_FRAME_AVERAGE[] = "frame-average";
-
-// Values for HFR settings.
-const char QCameraParameters::VIDEO_HFR_OFF[] = "off";
-const char QCameraParameters::VIDEO_HFR_2X[] = "60";
-const char QCameraParameters::VIDEO_HFR_3X[] = "90";
-const char QCameraParameters::VIDEO_HFR_4X[] = "120";
-const char QCameraParameters::VIDEO_HFR_5X[] = "150";
-const char QCameraParameters::VIDEO_HFR_6X[] = "180";
-const char QCameraParameters::VIDEO_HFR_7X[] = "210";
-const char QCameraParameters::VIDEO_HFR_8X[] = "240";
-const char QCameraParameters::VIDEO_HFR_9X[] = "480";
-
-// Values for HDR Bracketing settings.
-const char QCameraParameters::AE_BRACKET_OFF[] = "Off";
-const char QCameraParameters::AE_BRACKET[] = "AE-Bracket";
-
-// Values for AF Bracketing setting.
-const char QCameraParameters::AF_BRACKET_OFF[] = "af-bracket-off";
-const char QCameraParameters::AF_BRACKET_ON[] = "af-bracket-on";
-
-// Values for Refocus setting.
-const char QCameraParameters::RE_FOCUS_OFF[] = "re-focus-off";
-const char QCameraParameters::RE_FOCUS_ON[] = "re-focus-on";
-
-// Values for Chroma Flash setting.
-const char QCameraParameters::CHROMA_FLASH_OFF[] = "chroma-flash-off";
-const char QCameraParameters::CHROMA_FLASH_ON[] = "chroma-flash-on";
-
-// Values for Opti Zoom setting.
-const char QCameraParameters::OPTI_ZOOM_OFF[] = "opti-zoom-off";
-const char QCameraParameters::OPTI_ZOOM_ON[] = "opti-zoom-on";
-
-// Values for Still More setting.
-const char QCameraParameters::STILL_MORE_OFF[] = "still-more-off";
-const char QCameraParameters::STILL_MORE_ON[] = "still-more-on";
-
-// Values for HDR mode setting.
-const char QCameraParameters::HDR_MODE_SENSOR[] = "hdr-mode-sensor";
-const char QCameraParameters::HDR_MODE_MULTI_FRAME[] = "hdr-mode-multiframe";
-
-// Values for True Portrait setting.
-const char QCameraParameters::TRUE_PORTRAIT_OFF[] = "true-portrait-off";
-const char QCameraParameters::TRUE_PORTRAIT_ON[] = "true-portrait-on";
-
-// Values for FLIP settings.
-const char QCameraParameters::FLIP_MODE_OFF[] = "off";
-const char QCameraParameters::FLIP_MODE_V[] = "flip-v";
-const char QCameraParameters::FLIP_MODE_H[] = "flip-h";
-const char QCameraParameters::FLIP_MODE_VH[] = "flip-vh";
-
-const char QCameraParameters::CDS_MODE_OFF[] = "off";
-const char QCameraParameters::CDS_MODE_ON[] = "on";
-const char QCameraParameters::CDS_MODE_AUTO[] = "auto";
-
-// Values for video rotation settings.
-const char QCameraParameters::VIDEO_ROTATION_0[] = "0";
-const char QCameraParameters::VIDEO_ROTATION_90[] = "90";
-const char QCameraParameters::VIDEO_ROTATION_180[] = "180";
-const char QCameraParameters::VIDEO_ROTATION_270[] = "270";
-
-const char QCameraParameters::KEY_QC_SUPPORTED_MANUAL_FOCUS_MODES[] = "manual-focus-modes";
-const char QCameraParameters::KEY_QC_SUPPORTED_MANUAL_EXPOSURE_MODES[] = "manual-exposure-modes";
-const char QCameraParameters::KEY_QC_SUPPORTED_MANUAL_WB_MODES[] = "manual-wb-modes";
-const char QCameraParameters::KEY_QC_FOCUS_SCALE_MODE[] = "scale-mode";
-const char QCameraParameters::KEY_QC_FOCUS_DIOPTER_MODE[] = "diopter-mode";
-const char QCameraParameters::KEY_QC_ISO_PRIORITY[] = "iso-priority";
-const char QCameraParameters::KEY_QC_EXP_TIME_PRIORITY[] = "exp-time-priority";
-const char QCameraParameters::KEY_QC_USER_SETTING[] = "user-setting";
-const char QCameraParameters::KEY_QC_WB_CCT_MODE[] = "color-temperature";
-const char QCameraParameters::KEY_QC_WB_GAIN_MODE[] = "rbgb-gains";
-const char QCameraParameters::KEY_QC_NOISE_REDUCTION_MODE[] = "noise-reduction-mode";
-const char QCameraParameters::KEY_QC_NOISE_REDUCTION_MODE_VALUES[] = "noise-reduction-mode-values";
-
-#ifdef TARGET_TS_MAKEUP
-const char QCameraParameters::KEY_TS_MAKEUP[] = "tsmakeup";
-const char QCameraParameters::KEY_TS_MAKEUP_WHITEN[] = "tsmakeup_whiten";
-const char QCameraParameters::KEY_TS_MAKEUP_CLEAN[] = "tsmakeup_clean";
-#endif
-
-//KEY to set the RAW ZSL mode
-const char QCameraParameters::KEY_QC_RAW_ZSL[] = "raw-zsl";
-
-//KEY to set the RAW ZSL capture
-const char QCameraParameters::KEY_QC_RAW_ZSL_CAPTURE[] = "raw-zsl-capture";
-
-//KEY to share HFR batch size with video encoder.
-const char QCameraParameters::KEY_QC_VIDEO_BATCH_SIZE[] = "video-batch-size";
-
-//Camera supported metadata.  App can use this to read metadata callback type.
-const char QCameraParameters::KEY_QC_SUPPORTED_METADATA_TYPES[] = "metadata-types";
-const char QCameraParameters::QC_METADATA_ASD[] = "metadata-asd";
-const char QCameraParameters::QC_METADATA_FD[] = "metadata-fd";
-const char QCameraParameters::QC_METADATA_HDR[] = "metadata-hdr";
-const char QCameraParameters::QC_METADATA_LED_CALIB[] = "metadata-led-calib";
-//Real time bokeh metadata
-const char QCameraParameters::QC_METADATA_RTB[] = "metadata-rtb";
-
-const char QCameraParameters::KEY_QC_LED_CALIBRATION[] = "led-calibration";
-// AF fine tune values
-const char QCameraParameters::KEY_QC_AF_FINETUNE[] = "finetune";
-const char QCameraParameters::KEY_QC_SUPPORTED_FINETUNE_MODES[] = "finetune-values";
-
-const char QCameraParameters::KEY_QC_DEPTH_MAP_SIZE[] = "depthmap-size";
 
 static const char* portrait = "portrait";
 static const char* landscape = "landscape";
 
-const cam_dimension_t QCameraParameters::THUMBNAIL_SIZES_MAP[] = {
-    { 256, 154 }, //1.66233
-    { 240, 160 }, //1.5
-    { 320, 320 }, //1.0
-    { 320, 240 }, //1.33333
-    { 256, 144 }, //1.777778
-    { 240, 144 }, //1.666667
-    { 176, 144 }, //1.222222
-    /*Thumbnail sizes to match portrait picture size aspect ratio*/
-    { 240, 320 }, //to match 480X640 & 240X320 picture size
-    { 144, 176 }, //to match 144X176  picture size
-    { 0, 0 }      // required by Android SDK
-};
-
-const QCameraParameters::QCameraMap<cam_auto_exposure_mode_type>
-        QCameraParameters::AUTO_EXPOSURE_MAP[] = {
-    { AUTO_EXPOSURE_FRAME_AVG,           CAM_AEC_MODE_FRAME_AVERAGE },
-    { AUTO_EXPOSURE_CENTER_WEIGHTED,     CAM_AEC_MODE_CENTER_WEIGHTED },
-    { AUTO_EXPOSURE_SPOT_METERING,       CAM_AEC_MODE_SPOT_METERING },
-    { AUTO_EXPOSURE_SMART_METERING,      CAM_AEC_MODE_SMART_METERING },
-    { AUTO_EXPOSURE_USER_METERING,       CAM_AEC_MODE_USER_METERING },
-    { AUTO_EXPOSURE_SPOT_METERING_ADV,   CAM_AEC_MODE_SPOT_METERING_ADV },
-    { AUTO_EXPOSURE_CENTER_WEIGHTED_ADV, CAM_AEC_MODE_CENTER_WEIGHTED_ADV },
-};
-
-const QCameraParameters::QCameraMap<cam_aec_convergence_type>
-        QCameraParameters::INSTANT_AEC_MODES_MAP[] = {
-    { KEY_QC_INSTANT_AEC_DISABLE,        CAM_AEC_NORMAL_CONVERGENCE },
-    { KEY_QC_INSTANT_AEC_AGGRESSIVE_AEC, CAM_AEC_AGGRESSIVE_CONVERGENCE },
-    { KEY_QC_INSTANT_AEC_FAST_AEC,       CAM_AEC_FAST_CONVERGENCE },
-};
-
-const QCameraParameters::QCameraMap<cam_aec_convergence_type>
-        QCameraParameters::INSTANT_CAPTURE_MODES_MAP[] = {
-    { KEY_QC_INSTANT_CAPTURE_DISABLE,        CAM_AEC_NORMAL_CONVERGENCE },
-    { KEY_QC_INSTANT_CAPTURE_AGGRESSIVE_AEC, CAM_AEC_AGGRESSIVE_CONVERGENCE },
-    { KEY_QC_INSTANT_CAPTURE_FAST_AEC,       CAM_AEC_FAST_CONVERGENCE },
-};
-
-const QCameraParameters::QCameraMap<cam_format_t>
-        QCameraParameters::PREVIEW_FORMATS_MAP[] = {
-    {PIXEL_FORMAT_YUV420SP,        CAM_FORMAT_YUV_420_NV21},
-    {PIXEL_FORMAT_YUV420P,         CAM_FORMAT_YUV_420_YV12},
-    {PIXEL_FORMAT_YUV420SP_ADRENO, CAM_FORMAT_YUV_420_NV21_ADRENO},
-    {PIXEL_FORMAT_YV12,            CAM_FORMAT_YUV_420_YV12},
-    {PIXEL_FORMAT_NV12,            CAM_FORMAT_YUV_420_NV12},
-    {QC_PIXEL_FORMAT_NV12_VENUS,   CAM_FORMAT_YUV_420_NV12_VENUS}
-};
-
-const QCameraParameters::QCameraMap<cam_format_t>
-        QCameraParameters::PICTURE_TYPES_MAP[] = {
-    {PIXEL_FORMAT_JPEG,                          CAM_FORMAT_JPEG},
-    {PIXEL_FORMAT_YUV420SP,                      CAM_FORMAT_YUV_420_NV21},
-    {PIXEL_FORMAT_YUV422SP,                      CAM_FORMAT_YUV_422_NV16},
-    {QC_PIXEL_FORMAT_YUV_RAW_8BIT_YUYV,          CAM_FORMAT_YUV_RAW_8BIT_YUYV},
-    {QC_PIXEL_FORMAT_YUV_RAW_8BIT_YVYU,          CAM_FORMAT_YUV_RAW_8BIT_YVYU},
-    {QC_PIXEL_FORMAT_YUV_RAW_8BIT_UYVY,          CAM_FORMAT_YUV_RAW_8BIT_UYVY},
-    {QC_PIXEL_FORMAT_YUV_RAW_8BIT_VYUY,          CAM_FORMAT_YUV_RAW_8BIT_VYUY},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_8GBRG,       CAM_FORMAT_BAYER_QCOM_RAW_8BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_8GRBG,       CAM_FORMAT_BAYER_QCOM_RAW_8BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_8RGGB,       CAM_FORMAT_BAYER_QCOM_RAW_8BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_8BGGR,       CAM_FORMAT_BAYER_QCOM_RAW_8BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_10GBRG,      CAM_FORMAT_BAYER_QCOM_RAW_10BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_10GRBG,      CAM_FORMAT_BAYER_QCOM_RAW_10BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_10RGGB,      CAM_FORMAT_BAYER_QCOM_RAW_10BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_10BGGR,      CAM_FORMAT_BAYER_QCOM_RAW_10BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_12GBRG,      CAM_FORMAT_BAYER_QCOM_RAW_12BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_12GRBG,      CAM_FORMAT_BAYER_QCOM_RAW_12BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_12RGGB,      CAM_FORMAT_BAYER_QCOM_RAW_12BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_12BGGR,      CAM_FORMAT_BAYER_QCOM_RAW_12BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_14GBRG,      CAM_FORMAT_BAYER_QCOM_RAW_14BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_14GRBG,      CAM_FORMAT_BAYER_QCOM_RAW_14BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_14RGGB,      CAM_FORMAT_BAYER_QCOM_RAW_14BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_QCOM_RAW_14BGGR,      CAM_FORMAT_BAYER_QCOM_RAW_14BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_8GBRG,       CAM_FORMAT_BAYER_MIPI_RAW_8BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_8GRBG,       CAM_FORMAT_BAYER_MIPI_RAW_8BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_8RGGB,       CAM_FORMAT_BAYER_MIPI_RAW_8BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_8BGGR,       CAM_FORMAT_BAYER_MIPI_RAW_8BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_10GBRG,      CAM_FORMAT_BAYER_MIPI_RAW_10BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_10GRBG,      CAM_FORMAT_BAYER_MIPI_RAW_10BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_10RGGB,      CAM_FORMAT_BAYER_MIPI_RAW_10BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_10BGGR,      CAM_FORMAT_BAYER_MIPI_RAW_10BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_12GBRG,      CAM_FORMAT_BAYER_MIPI_RAW_12BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_12GRBG,      CAM_FORMAT_BAYER_MIPI_RAW_12BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_12RGGB,      CAM_FORMAT_BAYER_MIPI_RAW_12BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_12BGGR,      CAM_FORMAT_BAYER_MIPI_RAW_12BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_14GBRG,      CAM_FORMAT_BAYER_MIPI_RAW_14BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_14GRBG,      CAM_FORMAT_BAYER_MIPI_RAW_14BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_14RGGB,      CAM_FORMAT_BAYER_MIPI_RAW_14BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_MIPI_RAW_14BGGR,      CAM_FORMAT_BAYER_MIPI_RAW_14BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_8GBRG,     CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_8BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_8GRBG,     CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_8BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_8RGGB,     CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_8BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_8BGGR,     CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_8BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_10GBRG,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_10BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_10GRBG,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_10BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_10RGGB,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_10BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_10BGGR,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_10BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_12GBRG,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_12BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_12GRBG,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_12BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_12RGGB,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_12BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_12BGGR,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_12BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_14GBRG,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_14BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_14GRBG,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_14BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_14RGGB,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_14BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_QCOM_14BGGR,    CAM_FORMAT_BAYER_IDEAL_RAW_QCOM_14BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_8GBRG,     CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_8BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_8GRBG,     CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_8BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_8RGGB,     CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_8BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_8BGGR,     CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_8BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_10GBRG,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_10BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_10GRBG,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_10BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_10RGGB,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_10BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_10BGGR,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_10BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_12GBRG,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_12BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_12GRBG,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_12BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_12RGGB,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_12BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_12BGGR,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_12BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_14GBRG,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_14BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_14GRBG,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_14BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_14RGGB,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_14BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_MIPI_14BGGR,    CAM_FORMAT_BAYER_IDEAL_RAW_MIPI_14BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN8_8GBRG,   CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN8_8BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN8_8GRBG,   CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN8_8BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN8_8RGGB,   CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN8_8BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN8_8BGGR,   CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN8_8BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_8GBRG,  CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_8BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_8GRBG,  CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_8BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_8RGGB,  CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_8BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_8BGGR,  CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_8BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_10GBRG, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_10BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_10GRBG, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_10BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_10RGGB, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_10BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_10BGGR, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_10BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_12GBRG, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_12BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_12GRBG, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_12BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_12RGGB, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_12BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_12BGGR, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_12BPP_BGGR},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_14GBRG, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_14BPP_GBRG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_14GRBG, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_14BPP_GRBG},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_14RGGB, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_14BPP_RGGB},
-    {QC_PIXEL_FORMAT_BAYER_IDEAL_PLAIN16_14BGGR, CAM_FORMAT_BAYER_IDEAL_RAW_PLAIN16_14BPP_BGGR}
-};
-
-const QCameraParameters::QCameraMap<cam_focus_mode_type>
-        QCameraParameters::FOCUS_MODES_MAP[] = {
-    { FOCUS_MODE_AUTO,               CAM_FOCUS_MODE_AUTO },
-    { FOCUS_MODE_INFINITY,           CAM_FOCUS_MODE_INFINITY },
-    { FOCUS_MODE_MACRO,              CAM_FOCUS_MODE_MACRO },
-    { FOCUS_MODE_FIXED,              CAM_FOCUS_MODE_FIXED },
-    { FOCUS_MODE_EDOF,               CAM_FOCUS_MODE_EDOF },
-    { FOCUS_MODE_CONTINUOUS_PICTURE, CAM_FOCUS_MODE_CONTINOUS_PICTURE },
-    { FOCUS_MODE_CONTINUOUS_VIDEO,   CAM_FOCUS_MODE_CONTINOUS_VIDEO },
-    { FOCUS_MODE_MANUAL_POSITION,    CAM_FOCUS_MODE_MANUAL},
-};
-
-const QCameraParameters::QCameraMap<cam_effect_mode_type>
-        QCameraParameters::EFFECT_MODES_MAP[] = {
-    { EFFECT_NONE,       CAM_EFFECT_MODE_OFF },
-    { EFFECT_MONO,       CAM_EFFECT_MODE_MONO },
-    { EFFECT_NEGATIVE,   CAM_EFFECT_MODE_NEGATIVE },
-    { EFFECT_SOLARIZE,   CAM_EFFECT_MODE_SOLARIZE },
-    { EFFECT_SEPIA,      CAM_EFFECT_MODE_SEPIA },
-    { EFFECT_POSTERIZE,  CAM_EFFECT_MODE_POSTERIZE },
-    { EFFECT_WHITEBOARD, CAM_EFFECT_MODE_WHITEBOARD },
-    { EFFECT_BLACKBOARD, CAM_EFFECT_MODE_BLACKBOARD },
-    { EFFECT_AQUA,       CAM_EFFECT_MODE_AQUA },
-    { EFFECT_EMBOSS,     CAM_EFFECT_MODE_EMBOSS },
-    { EFFECT_SKETCH,     CAM_EFFECT_MODE_SKETCH },
-    { EFFECT_NEON,       CAM_EFFECT_MODE_NEON },
-    { EFFECT_BEAUTY,     CAM_EFFECT_MODE_BEAUTY }
-};
-
-const QCameraParameters::QCameraMap<cam_scene_mode_type>
-        QCameraParameters::SCENE_MODES_MAP[] = {
-    { SCENE_MODE_AUTO,           CAM_SCENE_MODE_OFF },
-    { SCENE_MODE_ACTION,         CAM_SCENE_MODE_ACTION },
-    { SCENE_MODE_PORTRAIT,       CAM_SCENE_MODE_PORTRAIT },
-    { SCENE_MODE_LANDSCAPE,      CAM_SCENE_MODE_LANDSCAPE },
-    { SCENE_MODE_NIGHT,          CAM_SCENE_MODE_NIGHT },
-    { SCENE_MODE_NIGHT_PORTRAIT, CAM_SCENE_MODE_NIGHT_PORTRAIT },
-    { SCENE_MODE_THEATRE,        CAM_SCENE_MODE_THEATRE },
-    { SCENE_MODE_BEACH,          CAM_SCENE_MODE_BEACH },
-    { SCENE_MODE_SNOW,           CAM_SCENE_MODE_SNOW },
-    { SCENE_MODE_SUNSET,         CAM_SCENE_MODE_SUNSET },
-    { SCENE_MODE_STEADYPHOTO,    CAM_SCENE_MODE_ANTISHAKE },
-    { SCENE_MODE_FIREWORKS ,     CAM_SCENE_MODE_FIREWORKS },
-    { SCENE_MODE_SPORTS ,        CAM_SCENE_MODE_SPORTS },
-    { SCENE_MODE_PARTY,          CAM_SCENE_MODE_PARTY },
-    { SCENE_MODE_CANDLELIGHT,    CAM_SCENE_MODE_CANDLELIGHT },
-    { SCENE_MODE_ASD,            CAM_SCENE_MODE_AUTO },
-    { SCENE_MODE_BACKLIGHT,      CAM_SCENE_MODE_BACKLIGHT },
-    { SCENE_MODE_FLOWERS,        CAM_SCENE_MODE_FLOWERS },
-    { SCENE_MODE_AR,             CAM_SCENE_MODE_AR },
-    { SCENE_MODE_HDR,            CAM_SCENE_MODE_HDR },
-};
-
-const QCameraParameters::QCameraMap<cam_flash_mode_t>
-        QCameraParameters::FLASH_MODES_MAP[] = {
-    { FLASH_MODE_OFF,   CAM_FLASH_MODE_OFF },
-    { FLASH_MODE_AUTO,  CAM_FLASH_MODE_AUTO },
-    { FLASH_MODE_ON,    CAM_FLASH_MODE_ON },
-    { FLASH_MODE_TORCH, CAM_FLASH_MODE_TORCH }
-};
-
-const QCameraParameters::QCameraMap<cam_focus_algorithm_type>
-         QCameraParameters::FOCUS_ALGO_MAP[] = {
-    { FOCUS_ALGO_AUTO,            CAM_FOCUS_ALGO_AUTO },
-    { FOCUS_ALGO_SPOT_METERING,   CAM_FOCUS_ALGO_SPOT },
-    { FOCUS_ALGO_CENTER_WEIGHTED, CAM_FOCUS_ALGO_CENTER_WEIGHTED },
-    { FOCUS_ALGO_FRAME_AVERAGE,   CAM_FOCUS_ALGO_AVERAGE }
-};
-
-const QCameraParameters::QCameraMap<cam_wb_mode_type>
-        QCameraParameters::WHITE_BALANCE_MODES_MAP[] = {
-    { WHITE_BALANCE_AUTO,            CAM_WB_MODE_AUTO },
-    { WHITE_BALANCE_INCANDESCENT,    CAM_WB_MODE_INCANDESCENT },
-    { WHITE_BALANCE_FLUORESCENT,     CAM_WB_MODE_FLUORESCENT },
-    { WHITE_BALANCE_WARM_FLUORESCENT,CAM_WB_MODE_WARM_FLUORESCENT},
-    { WHITE_BALANCE_DAYLIGHT,        CAM_WB_MODE_DAYLIGHT },
-    { WHITE_BALANCE_CLOUDY_DAYLIGHT, CAM_WB_MODE_CLOUDY_DAYLIGHT },
-    { WHITE_BALANCE_TWILIGHT,        CAM_WB_MODE_TWILIGHT },
-    { WHITE_BALANCE_SHADE,           CAM_WB_MODE_SHADE },
-    { WHITE_BALANCE_MANUAL,          CAM_WB_MODE_MANUAL},
-};
-
-const QCameraParameters::QCameraMap<cam_antibanding_mode_type>
-        QCameraParameters::ANTIBANDING_MODES_MAP[] = {
-    { ANTIBANDING_OFF,  CAM_ANTIBANDING_MODE_OFF },
-    { ANTIBANDING_50HZ, CAM_ANTIBANDING_MODE_50HZ },
-    { ANTIBANDING_60HZ, CAM_ANTIBANDING_MODE_60HZ },
-    { ANTIBANDING_AUTO, CAM_ANTIBANDING_MODE_AUTO }
-};
-
-const QCameraParameters::QCameraMap<cam_iso_mode_type>
-        QCameraParameters::ISO_MODES_MAP[] = {
-    { ISO_AUTO,  CAM_ISO_MODE_AUTO },
-    { ISO_HJR,   CAM_ISO_MODE_DEBLUR },
-    { ISO_100,   CAM_ISO_MODE_100 },
-    { ISO_200,   CAM_ISO_MODE_200 },
-    { ISO_400,   CAM_ISO_MODE_400 },
-    { ISO_800,   CAM_ISO_MODE_800 },
-    { ISO_1600,  CAM_ISO_MODE_1600 },
-    { ISO_3200,  CAM_ISO_MODE_3200 }
-};
-
-const QCameraParameters::QCameraMap<cam_hfr_mode_t>
-        QCameraParameters::HFR_MODES_MAP[] = {
-    { VIDEO_HFR_OFF, CAM_HFR_MODE_OFF },
-    { VIDEO_HFR_2X, CAM_HFR_MODE_60FPS },
-    { VIDEO_HFR_3X, CAM_HFR_MODE_90FPS },
-    { VIDEO_HFR_4X, CAM_HFR_MODE_120FPS },
-    { VIDEO_HFR_5X, CAM_HFR_MODE_150FPS },
-    { VIDEO_HFR_6X, CAM_HFR_MODE_180FPS },
-    { VIDEO_HFR_7X, CAM_HFR_MODE_210FPS },
-    { VIDEO_HFR_8X, CAM_HFR_MODE_240FPS },
-    { VIDEO_HFR_9X, CAM_HFR_MODE_480FPS }
-};
-
-const QCameraParameters::QCameraMap<cam_bracket_mode>
-        QCameraParameters::BRACKETING_MODES_MAP[] = {
-    { AE_BRACKET_OFF, CAM_EXP_BRACKETING_OFF },
-    { AE_BRACKET,     CAM_EXP_BRACKETING_ON }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::ON_OFF_MODES_MAP[] = {
-    { VALUE_OFF, 0 },
-    { VALUE_ON,  1 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::TOUCH_AF_AEC_MODES_MAP[] = {
-    { QCameraParameters::TOUCH_AF_AEC_OFF, 0 },
-    { QCameraParameters::TOUCH_AF_AEC_ON, 1 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::ENABLE_DISABLE_MODES_MAP[] = {
-    { VALUE_ENABLE,  1 },
-    { VALUE_DISABLE, 0 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::DENOISE_ON_OFF_MODES_MAP[] = {
-    { DENOISE_OFF, 0 },
-    { DENOISE_ON,  1 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::TRUE_FALSE_MODES_MAP[] = {
-    { VALUE_FALSE, 0},
-    { VALUE_TRUE,  1}
-};
-
-const QCameraParameters::QCameraMap<cam_flip_t>
-        QCameraParameters::FLIP_MODES_MAP[] = {
-    {FLIP_MODE_OFF, FLIP_NONE},
-    {FLIP_MODE_V, FLIP_V},
-    {FLIP_MODE_H, FLIP_H},
-    {FLIP_MODE_VH, FLIP_V_H}
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::AF_BRACKETING_MODES_MAP[] = {
-    { AF_BRACKET_OFF, 0 },
-    { AF_BRACKET_ON,  1 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::RE_FOCUS_MODES_MAP[] = {
-    { RE_FOCUS_OFF, 0 },
-    { RE_FOCUS_ON,  1 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::CHROMA_FLASH_MODES_MAP[] = {
-    { CHROMA_FLASH_OFF, 0 },
-    { CHROMA_FLASH_ON,  1 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::OPTI_ZOOM_MODES_MAP[] = {
-    { OPTI_ZOOM_OFF, 0 },
-    { OPTI_ZOOM_ON,  1 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::TRUE_PORTRAIT_MODES_MAP[] = {
-    { TRUE_PORTRAIT_OFF, 0 },
-    { TRUE_PORTRAIT_ON,  1 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::STILL_MORE_MODES_MAP[] = {
-    { STILL_MORE_OFF, 0 },
-    { STILL_MORE_ON,  1 }
-};
-
-const QCameraParameters::QCameraMap<cam_cds_mode_type_t>
-        QCameraParameters::CDS_MODES_MAP[] = {
-    { CDS_MODE_OFF, CAM_CDS_MODE_OFF },
-    { CDS_MODE_ON, CAM_CDS_MODE_ON },
-    { CDS_MODE_AUTO, CAM_CDS_MODE_AUTO}
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::HDR_MODES_MAP[] = {
-    { HDR_MODE_SENSOR, 0 },
-    { HDR_MODE_MULTI_FRAME, 1 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::VIDEO_ROTATION_MODES_MAP[] = {
-    { VIDEO_ROTATION_0, 0 },
-    { VIDEO_ROTATION_90, 90 },
-    { VIDEO_ROTATION_180, 180 },
-    { VIDEO_ROTATION_270, 270 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::NOISE_REDUCTION_MODES_MAP[] = {
-    { VALUE_OFF, 0 },
-    { VALUE_FAST,  1 },
-    { VALUE_HIGH_QUALITY,  2 }
-};
-
-const QCameraParameters::QCameraMap<int>
-        QCameraParameters::METADATA_TYPES_MAP[] = {
-    {QC_METADATA_ASD,        QCAMERA_METADATA_ASD},
-    {QC_METADATA_FD,         QCAMERA_METADATA_FD},
-    {QC_METADATA_HDR,        QCAMERA_METADATA_HDR},
-    {QC_METADATA_LED_CALIB,  QCAMERA_METADATA_LED_CALIB},
-    {QC_METADATA_RTB,        QCAMERA_METADATA_RTB}
-};
-
-
 #define DEFAULT_CAMERA_AREA "(0, 0, 0, 0, 0)"
 #define DATA_PTR(MEM_OBJ,INDEX) MEM_OBJ->getPtr( INDEX )
 #define TOTAL_RAM_SIZE_512MB 536870912
-#define PARAM_MAP_SIZE(MAP) (sizeof(MAP)/sizeof(MAP[0]))
+// the maps are defined in QCameraParametersTables.cpp, along with their sizes
+#define PARAM_MAP_SIZE(MAP) (MAP##_SIZE)
 
 // initialise to some default value
 uint32_t QCameraParameters::sessionId[] = {0};
@@ -1557,6 +717,18 @@ template <class mapType> int lookupAttr(const mapType *arr,
         size_t len, const char *name)
 {
     if (name) {
+        // defaults sit first in the maps and are the common case
+        if ((len >= QCAMERA_MAP_INDEX_MIN_LEN) && strcmp(arr[0].desc, name)) {
+            const QCameraMapIndex &index = QCameraParameters::getMapIndex();
+            int val;
+
+            if (index.findName(arr, name, val)) {
+                return val;
+            }
+            if (index.isIndexed(arr)) {
+                return NAME_NOT_FOUND;
+            }
+        }
         for (size_t i = 0; i < len; i++) {
             if (!strcmp(arr[i].desc, name))
                 return arr[i].val;
@@ -1580,6 +752,17 @@ template <class mapType> int lookupAttr(const mapType *arr,
 template <class mapType> const char *lookupNameByValue(const mapType *arr,
         size_t len, int value)
 {
+    if (len >= QCAMERA_MAP_INDEX_MIN_LEN) {
+        const QCameraMapIndex &index = QCameraParameters::getMapIndex();
+        const char *name;
+
+        if (index.findValue(arr, value, name)) {
+            return name;
+        }
+        if (index.isIndexed(arr)) {
+            return NULL;
+        }
+    }
     for (size_t i = 0; i < len; i++) {
         if (arr[i].val == value) {
             return arr[i].desc;
@@ -1604,6 +787,12 @@ int32_t QCameraParameters::setPreviewSize(const QCameraParameters& params)
 {
     int width = 0, height = 0;
     int old_width = 0, old_height = 0;
+
+    // an unchanged size was validated by an earlier update
+    if (!isParamChanged(*this, params, PREVIEW_SIZE_UPDATE_KEYS)) {
+        return NO_ERROR;
+    }
+
     params.getPreviewSize(&width, &height);
     CameraParameters::getPreviewSize(&old_width, &old_height);
 
@@ -1665,6 +854,12 @@ int32_t QCameraParameters::setPreviewSize(const QCameraParameters& params)
 int32_t QCameraParameters::setPictureSize(const QCameraParameters& params)
 {
     int width, height;
+
+    // an unchanged size was validated, and view angles updated, earlier
+    if (!isParamChanged(*this, params, PICTURE_SIZE_UPDATE_KEYS)) {
+        return NO_ERROR;
+    }
+
     params.getPictureSize(&width, &height);
     int old_width, old_height;
 
@@ -2144,7 +1339,7 @@ int32_t QCameraParameters::setJpegThumbnailSize(const QCameraParameters& params)
     int height = params.getInt(KEY_JPEG_THUMBNAIL_HEIGHT);
 
     LOGD("requested jpeg thumbnail size %d x %d", width, height);
-    int sizes_cnt = sizeof(THUMBNAIL_SIZES_MAP) / sizeof(cam_dimension_t);
+    int sizes_cnt = (int)PARAM_MAP_SIZE(THUMBNAIL_SIZES_MAP);
     // Validate thumbnail size
     for (int i = 0; i < sizes_cnt; i++) {
         if (width == THUMBNAIL_SIZES_MAP[i].width &&
@@ -2342,6 +1537,14 @@ int32_t QCameraParameters::setPreviewFpsRange(const QCameraParameters& params)
     int rc = NO_ERROR;
     bool found = false, updateNeeded = false;
 
+    // a new preview frame rate is flagged by setPreviewFrameRate and
+    // applied here, even with an unchanged range
+    if (!m_bFixedFrameRateSet &&
+            !isParamChanged(*this, params, PREVIEW_FPS_RANGE_UPDATE_KEYS)) {
+        LOGD("No change in FpsRange or HFR mode");
+        return NO_ERROR;
+    }
+
     CameraParameters::getPreviewFpsRange(&prevMinFps, &prevMaxFps);
     params.getPreviewFpsRange(&minFps, &maxFps);
 
@@ -6607,7 +5810,7 @@ int32_t QCameraParameters::initDefaultParameters()
     char value[PROPERTY_VALUE_MAX];
 
     property_get("persist.vendor.camera.hdr.outcrop", value, VALUE_DISABLE);
-    if (strncmp(VALUE_ENABLE, value, sizeof(VALUE_ENABLE))) {
+    if (strcmp(VALUE_ENABLE, value)) {
       m_bHDROutputCropEnabled = false;
     } else {
       m_bHDROutputCropEnabled = true;
@@ -11215,38 +10418,25 @@ char* QCameraParameters::getParameters()
     char* strParams = NULL;
     String8 str;
 
-    int cur_width, cur_height;
     //Need take care Scale picture size
     if(m_reprocScaleParam.isScaleEnabled() &&
         m_reprocScaleParam.isUnderScaling()){
         int scale_width, scale_height;
 
         m_reprocScaleParam.getPicSizeFromAPK(scale_width,scale_height);
-        getPictureSize(&cur_width, &cur_height);
 
-        String8 pic_size;
+        // Report the APK picture size without touching the stored one, so
+        // the flatten() cache survives
         char buffer[32];
         snprintf(buffer, sizeof(buffer), "%dx%d", scale_width, scale_height);
-        pic_size.append(buffer);
-        set(CameraParameters::KEY_PICTURE_SIZE, pic_size);
+        str = flatten(CameraParameters::KEY_PICTURE_SIZE, buffer);
+    } else {
+        // flatten() returns the cached string unless a parameter changed
+        str = flatten();
     }
-
-    str = flatten();
     strParams = (char *)malloc(sizeof(char)*(str.length()+1));
     if(strParams != NULL){
-        memset(strParams, 0, sizeof(char)*(str.length()+1));
-        strlcpy(strParams, str.string(), str.length()+1);
-        strParams[str.length()] = 0;
-    }
-
-    if(m_reprocScaleParam.isScaleEnabled() &&
-        m_reprocScaleParam.isUnderScaling()){
-        //need set back picture size
-        String8 pic_size;
-        char buffer[32];
-        snprintf(buffer, sizeof(buffer), "%dx%d", cur_width, cur_height);
-        pic_size.append(buffer);
-        set(CameraParameters::KEY_PICTURE_SIZE, pic_size);
+        memcpy(strParams, str.string(), str.length()+1);
     }
     return strParams;
 }
@@ -35,6 +35,7 @@
 #include "QCameraCommon.h"
 #include "QCameraFOVControl.h"
 #include "CameraParameters.h"
+#include "QCameraMapIndex.h"
 
 
 extern "C" {
@@ -968,6 +969,12 @@ public:
     void setBokehSnaphot(bool enable);
     void getDepthMapSize(int &width, int &height);
     bool isAutoFocusSupported(uint32_t cam_type);
+    static const QCameraMapIndex &getMapIndex();
+    static const char *const PREVIEW_SIZE_UPDATE_KEYS[];
+    static const char *const PICTURE_SIZE_UPDATE_KEYS[];
+    static const char *const PREVIEW_FPS_RANGE_UPDATE_KEYS[];
+    static bool isParamChanged(const CameraParameters& current,
+            const CameraParameters& params, const char *const *keys);
 private:
     int32_t setPreviewSize(const QCameraParameters& );
     int32_t setVideoSize(const QCameraParameters& );
@@ -1230,6 +1237,45 @@ private:
     static const QCameraMap<int> NOISE_REDUCTION_MODES_MAP[];
     static const QCameraMap<int> METADATA_TYPES_MAP[];
 
+    // Entry counts of the maps above, which are defined with the keys in
+    // QCameraParametersTables.cpp
+    static const size_t THUMBNAIL_SIZES_MAP_SIZE;
+    static const size_t AUTO_EXPOSURE_MAP_SIZE;
+    static const size_t INSTANT_CAPTURE_MODES_MAP_SIZE;
+    static const size_t INSTANT_AEC_MODES_MAP_SIZE;
+    static const size_t PREVIEW_FORMATS_MAP_SIZE;
+    static const size_t PICTURE_TYPES_MAP_SIZE;
+    static const size_t FOCUS_MODES_MAP_SIZE;
+    static const size_t EFFECT_MODES_MAP_SIZE;
+    static const size_t SCENE_MODES_MAP_SIZE;
+    static const size_t FLASH_MODES_MAP_SIZE;
+    static const size_t FOCUS_ALGO_MAP_SIZE;
+    static const size_t WHITE_BALANCE_MODES_MAP_SIZE;
+    static const size_t ANTIBANDING_MODES_MAP_SIZE;
+    static const size_t ISO_MODES_MAP_SIZE;
+    static const size_t HFR_MODES_MAP_SIZE;
+    static const size_t BRACKETING_MODES_MAP_SIZE;
+    static const size_t ON_OFF_MODES_MAP_SIZE;
+    static const size_t ENABLE_DISABLE_MODES_MAP_SIZE;
+    static const size_t DENOISE_ON_OFF_MODES_MAP_SIZE;
+    static const size_t TRUE_FALSE_MODES_MAP_SIZE;
+    static const size_t TOUCH_AF_AEC_MODES_MAP_SIZE;
+    static const size_t FLIP_MODES_MAP_SIZE;
+    static const size_t AF_BRACKETING_MODES_MAP_SIZE;
+    static const size_t RE_FOCUS_MODES_MAP_SIZE;
+    static const size_t CHROMA_FLASH_MODES_MAP_SIZE;
+    static const size_t OPTI_ZOOM_MODES_MAP_SIZE;
+    static const size_t TRUE_PORTRAIT_MODES_MAP_SIZE;
+    static const size_t CDS_MODES_MAP_SIZE;
+    static const size_t HDR_MODES_MAP_SIZE;
+    static const size_t VIDEO_ROTATION_MODES_MAP_SIZE;
+    static const size_t STILL_MORE_MODES_MAP_SIZE;
+    static const size_t NOISE_REDUCTION_MODES_MAP_SIZE;
+    static const size_t METADATA_TYPES_MAP_SIZE;
+
+    // Fills the hash index behind lookupAttr with the maps above
+    static void indexMaps(QCameraMapIndex &index);
+
     /*Common for all objects*/
     static uint32_t sessionId[MM_CAMERA_MAX_NUM_SENSORS];
 
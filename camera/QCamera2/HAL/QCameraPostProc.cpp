@@ -38,6 +38,7 @@
 // Camera dependencies
 #include "QCamera2HWI.h"
 #include "QCameraPostProc.h"
+#include "QCameraSuperBufPool.h"
 #include "QCameraTrace.h"
 #include "QCameraPprocManager.h"
 
@@ -83,7 +84,7 @@ QCameraPostProcessor::QCameraPostProcessor(QCamera2HardwareInterface *cam_ctrl)
       m_ongoingPPQ(releaseOngoingPPData, this),
       m_inputJpegQ(releaseJpegData, this),
       m_ongoingJpegQ(releaseJpegData, this),
-      m_inputRawQ(releaseRawData, this),
+      m_inputRawQ(releaseRawData, this, true),
       mSaveFrmCnt(0),
       mUseSaveProc(false),
       mUseJpegBurst(false),
@@ -1137,7 +1138,7 @@ int32_t QCameraPostProcessor::processData(mm_camera_super_buf_t *frame)
         if (false == m_inputPPQ.enqueue((void *)pp_request_job)) {
             LOGW("Input PP Q is not active!!!");
             releaseSuperBuf(frame);
-            free(frame);
+            QCameraSuperBufPool::getInstance()->release(frame);
             free(pp_request_job);
             frame = NULL;
             pp_request_job = NULL;
@@ -1215,7 +1216,7 @@ int32_t QCameraPostProcessor::processRawData(mm_camera_super_buf_t *frame)
     } else {
         LOGW("m_inputRawQ is not active!!!");
         releaseSuperBuf(frame);
-        free(frame);
+        QCameraSuperBufPool::getInstance()->release(frame);
         frame = NULL;
     }
     return NO_ERROR;
@@ -1503,7 +1504,7 @@ int32_t QCameraPostProcessor::processPPData(mm_camera_super_buf_t *frame)
     if ( mCurReprocCount > 1 ) {
         //In case of pp 2nd pass, we can release input of 2nd pass
         releaseSuperBuf(job->src_frame);
-        free(job->src_frame);
+        QCameraSuperBufPool::getInstance()->release(job->src_frame);
         job->src_frame = NULL;
     }
 
@@ -1754,12 +1755,12 @@ void QCameraPostProcessor::releasePPInputData(void *data, void *user_data)
             pme->releaseSuperBuf(pp_job->src_frame);
             if (pp_job->src_frame == pp_job->src_reproc_frame)
                 pp_job->src_reproc_frame = NULL;
-            free(pp_job->src_frame);
+            QCameraSuperBufPool::getInstance()->release(pp_job->src_frame);
             pp_job->src_frame = NULL;
         }
         if (NULL != pp_job->src_reproc_frame) {
             pme->releaseSuperBuf(pp_job->src_reproc_frame);
-            free(pp_job->src_reproc_frame);
+            QCameraSuperBufPool::getInstance()->release(pp_job->src_reproc_frame);
             pp_job->src_reproc_frame = NULL;
         }
         pp_job->reprocCount = 0;
@@ -1810,12 +1811,12 @@ void QCameraPostProcessor::releaseOngoingPPData(void *data, void *user_data)
             if (pp_job->src_frame == pp_job->src_reproc_frame)
                 pp_job->src_reproc_frame = NULL;
 
-            free(pp_job->src_frame);
+            QCameraSuperBufPool::getInstance()->release(pp_job->src_frame);
             pp_job->src_frame = NULL;
         }
         if (NULL != pp_job->src_reproc_frame) {
             pme->releaseSuperBuf(pp_job->src_reproc_frame);
-            free(pp_job->src_reproc_frame);
+            QCameraSuperBufPool::getInstance()->release(pp_job->src_reproc_frame);
             pp_job->src_reproc_frame = NULL;
         }
         if ((pp_job->offline_reproc_buf != NULL)
@@ -1869,7 +1870,7 @@ void QCameraPostProcessor::releaseNotifyData(void *user_data,
         }
         if (app_cb && NULL != app_cb->release_data.frame) {
             postProc->releaseSuperBuf(app_cb->release_data.frame);
-            free(app_cb->release_data.frame);
+            QCameraSuperBufPool::getInstance()->release(app_cb->release_data.frame);
             app_cb->release_data.frame = NULL;
         }
         if (app_cb && NULL != app_cb->release_data.streamBufs) {
@@ -1988,7 +1989,7 @@ void QCameraPostProcessor::releaseJpegJobData(qcamera_jpeg_data_t *job)
             if (!job->reproc_frame_release) {
                 releaseSuperBuf(job->src_reproc_frame);
             }
-            free(job->src_reproc_frame);
+            QCameraSuperBufPool::getInstance()->release(job->src_reproc_frame);
             job->src_reproc_frame = NULL;
         }
 
@@ -2012,7 +2013,7 @@ void QCameraPostProcessor::releaseJpegJobData(qcamera_jpeg_data_t *job)
                     job->metadata_heap = NULL;
                 }
             }
-            free(job->src_frame);
+            QCameraSuperBufPool::getInstance()->release(job->src_frame);
             job->src_frame = NULL;
         }
 
@@ -2090,12 +2091,13 @@ void QCameraPostProcessor::releaseRawData(void *data, void *user_data)
     LOGD("E");
 
     QCameraPostProcessor *pme = (QCameraPostProcessor *) user_data;
+    mm_camera_super_buf_t *super_buf = (mm_camera_super_buf_t *) data;
     if (NULL == pme) {
         LOGE("Invalid postproc handle");
-        return;
+    } else {
+        pme->releaseSuperBuf(super_buf);
     }
-    mm_camera_super_buf_t *super_buf = (mm_camera_super_buf_t *) data;
-    pme->releaseSuperBuf(super_buf);
+    QCameraSuperBufPool::getInstance()->release(super_buf);
 
     LOGD("X");
 }
@@ -2335,6 +2337,37 @@ int32_t QCameraPostProcessor::syncStreamParams(mm_camera_super_buf_t *frame,
     return ret;
 }
 
+/*===========================================================================
+ * FUNCTION   : getJobPriority
+ *
+ * DESCRIPTION: scheduling class of an encode job, by the stream its main
+ *              image comes from. Preview path frames (preview, postview,
+ *              callback or video, e.g. live snapshots) are callback jobs,
+ *              snapshot and reprocessed snapshot frames are snapshot jobs.
+ *
+ * PARAMETERS :
+ *   @main_stream : stream of the main image, possibly a reprocess stream
+ *
+ * RETURN     : priority class of the job
+ *==========================================================================*/
+mm_jpeg_job_prio_t QCameraPostProcessor::getJobPriority(QCameraStream *main_stream)
+{
+    static const cam_stream_type_t callback_types[] = {
+        CAM_STREAM_TYPE_PREVIEW,
+        CAM_STREAM_TYPE_POSTVIEW,
+        CAM_STREAM_TYPE_CALLBACK,
+        CAM_STREAM_TYPE_VIDEO,
+    };
+
+    for (size_t i = 0; i < sizeof(callback_types) / sizeof(callback_types[0]); i++) {
+        if (main_stream->isTypeOf(callback_types[i]) ||
+                main_stream->isOrignalTypeOf(callback_types[i])) {
+            return MM_JPEG_JOB_PRIO_CALLBACK;
+        }
+    }
+    return MM_JPEG_JOB_PRIO_SNAPSHOT;
+}
+
 /*===========================================================================
  * FUNCTION   : encodeData
  *
@@ -2709,6 +2742,8 @@ int32_t QCameraPostProcessor::encodeData(qcamera_jpeg_data_t *jpeg_job_data,
     jpg_job.encode_job.main_dim.dst_dim = dst_dim;
     jpg_job.encode_job.main_dim.crop = crop;
 
+    jpg_job.encode_job.priority = getJobPriority(main_stream);
+
     // get 3a sw version info
     cam_q3a_version_t sw_version =
         m_parent->getCamHalCapabilities()->q3a_version;
@@ -3422,7 +3457,7 @@ void *QCameraPostProcessor::dataProcessRoutine(void *data)
                         ret = pme->processRawImageImpl(super_buf);
                         if (NO_ERROR != ret) {
                             pme->releaseSuperBuf(super_buf);
-                            free(super_buf);
+                            QCameraSuperBufPool::getInstance()->release(super_buf);
                             pme->sendEvtNotify(CAMERA_MSG_ERROR, UNKNOWN_ERROR, 0);
                         }
                     }
@@ -3446,7 +3481,7 @@ void *QCameraPostProcessor::dataProcessRoutine(void *data)
                         (mm_camera_super_buf_t *)pme->m_inputRawQ.dequeue();
                     if (NULL != super_buf) {
                         pme->releaseSuperBuf(super_buf);
-                        free(super_buf);
+                        QCameraSuperBufPool::getInstance()->release(super_buf);
                     }
 
                     // flush input Postproc Queue
@@ -4301,7 +4336,7 @@ void QCameraPostProcessor::getHalPPOutputBuffer(uint32_t frameIndex)
     }
     memset(output_data, 0, sizeof(qcamera_hal_pp_data_t));
     mm_camera_super_buf_t* output_frame =
-            (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+            QCameraSuperBufPool::getInstance()->acquire();
     if (output_frame == NULL) {
         LOGE("No memory for mm_camera_super_buf_t frame");
         free(output_data);
@@ -4313,7 +4348,7 @@ void QCameraPostProcessor::getHalPPOutputBuffer(uint32_t frameIndex)
             (mm_camera_buf_def_t *)malloc(HAL_PP_NUM_BUFS * sizeof(mm_camera_buf_def_t));
     if (output_data->bufs == NULL) {
         LOGE("No memory for output_data->bufs");
-        free(output_frame);
+        QCameraSuperBufPool::getInstance()->release(output_frame);
         free(output_data);
         return;
     }
@@ -4322,7 +4357,7 @@ void QCameraPostProcessor::getHalPPOutputBuffer(uint32_t frameIndex)
     output_data->snapshot_heap = new QCameraHeapMemory(QCAMERA_ION_USE_CACHE);
     if (output_data->snapshot_heap == NULL) {
         LOGE("Unable to new heap memory obj for image buf");
-        free(output_frame);
+        QCameraSuperBufPool::getInstance()->release(output_frame);
         free(output_data->bufs);
         free(output_data);
         return;
@@ -4331,7 +4366,7 @@ void QCameraPostProcessor::getHalPPOutputBuffer(uint32_t frameIndex)
     if (output_data->metadata_heap == NULL) {
         LOGE("Unable to new heap memory obj for metadata buf");
         delete output_data->snapshot_heap;
-        free(output_frame);
+        QCameraSuperBufPool::getInstance()->release(output_frame);
         free(output_data->bufs);
         free(output_data);
         return;
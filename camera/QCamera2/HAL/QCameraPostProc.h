@@ -190,6 +190,7 @@ private:
             mm_camera_super_buf_t *reproc_frame);
     int32_t syncStreamParams(mm_camera_super_buf_t *frame,
             mm_camera_super_buf_t *reproc_frame);
+    static mm_jpeg_job_prio_t getJobPriority(QCameraStream *main_stream);
     void releaseSuperBuf(mm_camera_super_buf_t *super_buf,
             cam_stream_type_t stream_type);
     static void releaseNotifyData(void *user_data,
@@ -36,6 +36,7 @@
 #include "QCameraBufferMaps.h"
 #include "QCamera2HWI.h"
 #include "QCameraStream.h"
+#include "QCameraSuperBufPool.h"
 
 extern "C" {
 #include "mm_camera_dbg.h"
@@ -357,11 +358,12 @@ QCameraStream::QCameraStream(QCameraAllocator &allocator,
         mNumBufs(0),
         mNumPlaneBufs(0),
         mNumBufsNeedAlloc(0),
+        mSuperBufReserved(0),
         mRegFlags(NULL),
         mDataCB(NULL),
         mSYNCDataCB(NULL),
         mUserData(NULL),
-        mDataQ(releaseFrameData, this),
+        mDataQ(releaseFrameData, this, true),
         mStreamInfoBuf(NULL),
         mMiscBuf(NULL),
         mStreamBufs(NULL),
@@ -468,6 +470,8 @@ QCameraStream::~QCameraStream()
         mCamOps->delete_stream(mCamHandle, mChannelHandle, mHandle);
         mHandle = 0;
     }
+    QCameraSuperBufPool::getInstance()->unreserve(mSuperBufReserved);
+    mSuperBufReserved = 0;
     pthread_mutex_destroy(&m_lock);
     pthread_cond_destroy(&m_cond);
     mDualStream = 0;
@@ -822,6 +826,12 @@ int32_t QCameraStream::init(QCameraHeapMemory *streamInfoBuf,
 
     mDataCB = stream_cb;
     mUserData = userdata;
+
+    // One descriptor per stream buffer covers every frame that can be in
+    // flight, so dataNotifyCB never has to hit the allocator
+    QCameraSuperBufPool::getInstance()->unreserve(mSuperBufReserved);
+    mSuperBufReserved = mNumBufs;
+    QCameraSuperBufPool::getInstance()->reserve(mSuperBufReserved);
     return 0;
 
 err1:
@@ -1072,7 +1082,7 @@ int32_t QCameraStream::processDataNotify(mm_camera_super_buf_t *frame)
         } else {
             bufDone(frame);
         }
-        free(frame);
+        QCameraSuperBufPool::getInstance()->release(frame);
         return NO_ERROR;
     }
 }
@@ -1134,7 +1144,7 @@ void QCameraStream::dataNotifyCB(mm_camera_super_buf_t *recvd_frame,
     }
 
     mm_camera_super_buf_t *frame =
-        (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+        QCameraSuperBufPool::getInstance()->acquire();
     if (frame == NULL) {
         LOGE("No mem for mm_camera_buf_def_t");
         stream->bufDone(recvd_frame);
@@ -1188,7 +1198,7 @@ void *QCameraStream::dataProcRoutine(void *data)
                     } else {
                         // no data cb routine, return buf here
                         pme->bufDone(frame);
-                        free(frame);
+                        QCameraSuperBufPool::getInstance()->release(frame);
                     }
                 }
             }
@@ -2814,7 +2824,8 @@ int32_t QCameraStream::getParameter(cam_stream_parm_buffer_t &param)
 /*===========================================================================
  * FUNCTION   : releaseFrameData
  *
- * DESCRIPTION: callback function to release frame data node
+ * DESCRIPTION: callback function to release frame data node. Returns the
+ *              stream buffer and the super buf descriptor.
  *
  * PARAMETERS :
  *   @data      : ptr to post process input data
@@ -2829,6 +2840,7 @@ void QCameraStream::releaseFrameData(void *data, void *user_data)
     if (NULL != pme) {
         pme->bufDone(frame->bufs[0]->buf_idx);
     }
+    QCameraSuperBufPool::getInstance()->release(frame);
 }
 
 /*===========================================================================
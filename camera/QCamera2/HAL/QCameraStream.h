@@ -175,6 +175,7 @@ private:
     uint8_t mNumBufs;
     uint8_t mNumPlaneBufs;
     uint8_t mNumBufsNeedAlloc;
+    uint8_t mSuperBufReserved; // descriptors reserved in QCameraSuperBufPool
     uint8_t *mRegFlags;
     stream_cb_routine mDataCB;
     stream_cb_routine mSYNCDataCB;
@@ -71,3 +71,334 @@ endif
 endif
 
 #include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+    qcamera_mempool_test.cpp \
+    ../QCameraMemPool.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+    liblog \
+    libutils \
+    libcutils \
+    libmmcamera_interface \
+
+ifneq ($(TARGET_KERNEL_VERSION),$(filter $(TARGET_KERNEL_VERSION),3.18 4.4 4.9))
+  ifneq ($(LIBION_HEADER_PATH_WRAPPER), )
+    include $(LIBION_HEADER_PATH_WRAPPER)
+    LOCAL_C_INCLUDES += $(LIBION_HEADER_PATHS)
+  else
+    LOCAL_C_INCLUDES += \
+            system/core/libion/kernel-headers \
+            system/core/libion/include
+  endif
+endif
+
+LOCAL_HEADER_LIBRARIES := media_plugin_headers
+LOCAL_HEADER_LIBRARIES += camera_common_headers
+LOCAL_HEADER_LIBRARIES += display_headers
+LOCAL_HEADER_LIBRARIES += libhardware_headers
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/.. \
+    $(LOCAL_PATH)/../../stack/common \
+    $(LOCAL_PATH)/../../stack/mm-camera-interface/inc \
+    $(call project-path-for,qcom-media)/mm-core/inc \
+    $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr/include
+
+LOCAL_ADDITIONAL_DEPENDENCIES := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr
+
+LOCAL_MODULE:= qcamera_mempool_test
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+LOCAL_MODULE_TAGS:= tests
+
+LOCAL_CFLAGS += -Wall -Wextra -Werror -Wno-unused-parameter
+LOCAL_CFLAGS += -DQCAMERA_REDEFINE_LOG -DUSE_CAMERA_METABUFFER_UTILS
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+    qcamera_mapindex_test.cpp \
+    ../QCameraParametersTables.cpp \
+    ../QCameraMapIndex.cpp \
+    ../CameraParameters.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+    liblog \
+    libutils \
+    libcutils \
+    libmmcamera_interface \
+
+ifneq ($(TARGET_KERNEL_VERSION),$(filter $(TARGET_KERNEL_VERSION),3.18 4.4 4.9))
+  ifneq ($(LIBION_HEADER_PATH_WRAPPER), )
+    include $(LIBION_HEADER_PATH_WRAPPER)
+    LOCAL_C_INCLUDES += $(LIBION_HEADER_PATHS)
+  else
+    LOCAL_C_INCLUDES += \
+            system/core/libion/kernel-headers \
+            system/core/libion/include
+  endif
+endif
+
+LOCAL_HEADER_LIBRARIES := media_plugin_headers
+LOCAL_HEADER_LIBRARIES += camera_common_headers
+LOCAL_HEADER_LIBRARIES += display_headers
+LOCAL_HEADER_LIBRARIES += libhardware_headers
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/.. \
+    $(LOCAL_PATH)/../../util \
+    $(LOCAL_PATH)/../../HAL3 \
+    $(LOCAL_PATH)/../../stack/common \
+    $(LOCAL_PATH)/../../stack/mm-camera-interface/inc \
+    $(LOCAL_PATH)/../../../mm-image-codec/qexif \
+    $(LOCAL_PATH)/../../../mm-image-codec/qomx_core \
+    $(call project-path-for,qcom-media)/mm-core/inc \
+    $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr/include
+
+LOCAL_ADDITIONAL_DEPENDENCIES := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr
+
+LOCAL_MODULE:= qcamera_mapindex_test
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+LOCAL_MODULE_TAGS:= tests
+
+LOCAL_CFLAGS += -Wall -Wextra -Werror -Wno-unused-parameter
+LOCAL_CFLAGS += -DQCAMERA_HAL1_SUPPORT -DQCAMERA_REDEFINE_LOG
+LOCAL_CFLAGS += -DUSE_CAMERA_METABUFFER_UTILS
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+    qcamera_paramdiff_test.cpp \
+    ../QCameraParametersTables.cpp \
+    ../QCameraMapIndex.cpp \
+    ../CameraParameters.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+    liblog \
+    libutils \
+    libcutils \
+    libmmcamera_interface \
+
+ifneq ($(TARGET_KERNEL_VERSION),$(filter $(TARGET_KERNEL_VERSION),3.18 4.4 4.9))
+  ifneq ($(LIBION_HEADER_PATH_WRAPPER), )
+    include $(LIBION_HEADER_PATH_WRAPPER)
+    LOCAL_C_INCLUDES += $(LIBION_HEADER_PATHS)
+  else
+    LOCAL_C_INCLUDES += \
+            system/core/libion/kernel-headers \
+            system/core/libion/include
+  endif
+endif
+
+LOCAL_HEADER_LIBRARIES := media_plugin_headers
+LOCAL_HEADER_LIBRARIES += camera_common_headers
+LOCAL_HEADER_LIBRARIES += display_headers
+LOCAL_HEADER_LIBRARIES += libhardware_headers
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/.. \
+    $(LOCAL_PATH)/../../util \
+    $(LOCAL_PATH)/../../HAL3 \
+    $(LOCAL_PATH)/../../stack/common \
+    $(LOCAL_PATH)/../../stack/mm-camera-interface/inc \
+    $(LOCAL_PATH)/../../../mm-image-codec/qexif \
+    $(LOCAL_PATH)/../../../mm-image-codec/qomx_core \
+    $(call project-path-for,qcom-media)/mm-core/inc \
+    $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr/include
+
+LOCAL_ADDITIONAL_DEPENDENCIES := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr
+
+LOCAL_MODULE:= qcamera_paramdiff_test
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+LOCAL_MODULE_TAGS:= tests
+
+LOCAL_CFLAGS += -Wall -Wextra -Werror -Wno-unused-parameter
+LOCAL_CFLAGS += -DQCAMERA_HAL1_SUPPORT -DQCAMERA_REDEFINE_LOG
+LOCAL_CFLAGS += -DUSE_CAMERA_METABUFFER_UTILS
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+    qcamera_flatten_bench.cpp \
+    ../CameraParameters.cpp \
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/..
+
+LOCAL_SHARED_LIBRARIES:= \
+    libutils \
+    liblog \
+
+LOCAL_MODULE:= qcamera_flatten_bench
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+LOCAL_MODULE_TAGS:= tests
+
+LOCAL_CFLAGS += -Wall -Wextra -Werror -Wno-unused-parameter
+LOCAL_CFLAGS += -DQCAMERA_HAL1_SUPPORT
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+    qcamera_superbuf_pool_test.cpp \
+    ../../util/QCameraSuperBufPool.cpp \
+    ../../util/QCameraQueue.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+    liblog \
+    libutils \
+    libcutils \
+
+LOCAL_HEADER_LIBRARIES := camera_common_headers
+LOCAL_HEADER_LIBRARIES += libhardware_headers
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/../../util \
+    $(LOCAL_PATH)/../../stack/common \
+    $(LOCAL_PATH)/../../stack/mm-camera-interface/inc \
+    $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr/include
+
+LOCAL_ADDITIONAL_DEPENDENCIES := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr
+
+LOCAL_MODULE:= qcamera_superbuf_pool_test
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+LOCAL_MODULE_TAGS:= tests
+
+LOCAL_CFLAGS += -Wall -Wextra -Werror -Wno-unused-parameter
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+    qcamera_queue_bench.cpp \
+    ../../util/QCameraCmdThread.cpp \
+    ../../util/QCameraQueue.cpp \
+    ../../util/QCameraSuperBufPool.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+    liblog \
+    libutils \
+    libcutils \
+
+LOCAL_HEADER_LIBRARIES := camera_common_headers
+LOCAL_HEADER_LIBRARIES += libhardware_headers
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/../../util \
+    $(LOCAL_PATH)/../../stack/common \
+    $(LOCAL_PATH)/../../stack/mm-camera-interface/inc \
+    $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr/include
+
+LOCAL_ADDITIONAL_DEPENDENCIES := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr
+
+LOCAL_MODULE:= qcamera_queue_bench
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+LOCAL_MODULE_TAGS:= tests
+
+LOCAL_CFLAGS += -Wall -Wextra -Werror -Wno-unused-parameter
+LOCAL_CFLAGS += -DSYSTEM_HEADER_PREFIX=sys
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+    qcamera_inflight_replay_test.cpp \
+    ../../HAL3/QCamera3InflightTracker.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+    liblog \
+    libutils \
+    libcutils \
+    libmmcamera_interface \
+
+LOCAL_HEADER_LIBRARIES := libhardware_headers
+LOCAL_HEADER_LIBRARIES += camera_common_headers
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/../../HAL3 \
+    $(LOCAL_PATH)/../../stack/common \
+    $(LOCAL_PATH)/../../stack/mm-camera-interface/inc \
+    $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr/include
+
+LOCAL_ADDITIONAL_DEPENDENCIES := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr
+
+LOCAL_MODULE:= qcamera_inflight_replay_test
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+LOCAL_MODULE_TAGS:= tests
+
+LOCAL_CFLAGS += -Wall -Wextra -Werror -Wno-unused-parameter
+LOCAL_CFLAGS += -DQCAMERA_REDEFINE_LOG -DSYSTEM_HEADER_PREFIX=sys
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+    qcamera_camscope_test.cpp \
+    ../../util/QCameraTrace.cpp \
+    ../../util/camscope_packet_type.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+    liblog \
+    libutils \
+    libcutils \
+    libmmcamera_interface \
+
+LOCAL_HEADER_LIBRARIES := camera_common_headers
+LOCAL_HEADER_LIBRARIES += libhardware_headers
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/../../util \
+    $(LOCAL_PATH)/../../stack/common \
+    $(LOCAL_PATH)/../../stack/mm-camera-interface/inc \
+    $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr/include
+
+LOCAL_ADDITIONAL_DEPENDENCIES := $(TARGET_OUT_INTERMEDIATES)/KERNEL_OBJ/usr
+
+LOCAL_MODULE:= qcamera_camscope_test
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+LOCAL_MODULE_TAGS:= tests
+
+LOCAL_CFLAGS += -Wall -Wextra -Werror -Wno-unused-parameter
+LOCAL_CFLAGS += -DQCAMERA_REDEFINE_LOG
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+    qcamera_memleak_bench.cpp \
+
+LOCAL_SHARED_LIBRARIES:= \
+    libhal_dbg \
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/../../stack/common \
+
+LOCAL_MODULE:= qcamera_memleak_bench
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+LOCAL_MODULE_TAGS:= tests
+
+LOCAL_CFLAGS += -Wall -Wextra -Werror -Wno-unused-parameter
+
+include $(BUILD_EXECUTABLE)
@@ -0,0 +1,274 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Checks that CameraScope logging never waits on file I/O. The HAL section
+// is pointed at a FIFO nobody reads, which stalls the flusher thread in its
+// open, while camera-like threads keep logging: every call has to return
+// promptly, dropping and counting packets once the thread queues are full.
+// A paced run into a regular file must then lose nothing, and toggling the
+// section on and off under load must keep the file well formed.
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "QCameraTrace.h"
+#include "qcamera_test_check.h"
+
+#define NUM_THREADS         4
+#define STALL_PACKETS       50000
+#define PACED_PACKETS       2000
+#define PACED_BURST         100
+#define MAX_CALL_LATENCY_NS 50000000LL // far above any lock-free call
+
+typedef struct {
+    uint32_t id;
+    uint32_t packets;
+    uint32_t burst;         // packets between 1ms pauses, 0 for none
+    volatile bool *stop;    // log until set instead of a packet count
+    int64_t maxLatencyNs;
+    uint32_t logged;
+} LoggerArgs;
+
+static int64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void *logger(void *arg)
+{
+    LoggerArgs *args = (LoggerArgs *)arg;
+    args->maxLatencyNs = 0;
+    args->logged = 0;
+    for (uint32_t i = 0; (args->stop != NULL) ? !*args->stop : (i < args->packets);
+            i++) {
+        int64_t start = nowNs();
+        // frame_id carries thread id and sequence for the readers below
+        camscope_timing_log(CAMSCOPE_SECTION_HAL, CAMSCOPE_KPI_MASK,
+                            CAMSCOPE_SYNC_BEGIN, 0, (args->id << 24) | i);
+        int64_t latency = nowNs() - start;
+        if (latency > args->maxLatencyNs) {
+            args->maxLatencyNs = latency;
+        }
+        args->logged++;
+        if (args->burst != 0 && (i % args->burst) == args->burst - 1) {
+            usleep(1000);
+        }
+    }
+    return NULL;
+}
+
+static void runLoggers(LoggerArgs *args, uint32_t packets, uint32_t burst,
+                       volatile bool *stop, pthread_t *threads)
+{
+    for (uint32_t t = 0; t < NUM_THREADS; t++) {
+        args[t].id = t + 1;
+        args[t].packets = packets;
+        args[t].burst = burst;
+        args[t].stop = stop;
+        pthread_create(&threads[t], NULL, logger, &args[t]);
+    }
+}
+
+typedef struct {
+    const char *path;
+    uint64_t bytes;
+} ReaderArgs;
+
+static void *fifoReader(void *arg)
+{
+    ReaderArgs *args = (ReaderArgs *)arg;
+    char buf[4096];
+    int fd = open(args->path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    ssize_t n;
+    while ((n = read(fd, buf, sizeof(buf))) > 0) {
+        args->bytes += (uint64_t)n;
+    }
+    close(fd);
+    return NULL;
+}
+
+// Validates the packets of a file, each thread's sequence must increase
+static uint32_t checkFile(const char *path, bool contiguous)
+{
+    FILE *fp = fopen(path, "rb");
+    CHECK(fp != NULL);
+    if (fp == NULL) {
+        return 0;
+    }
+    int64_t next[NUM_THREADS + 1];
+    memset(next, 0, sizeof(next));
+    camscope_timing pkt;
+    uint32_t count = 0;
+    size_t n;
+    while ((n = fread(&pkt, 1, sizeof(pkt), fp)) == sizeof(pkt)) {
+        CHECK(pkt.sw_base.base.packet_type == CAMSCOPE_SYNC_BEGIN);
+        CHECK(pkt.sw_base.base.size == sizeof(pkt));
+        uint32_t id = pkt.frame_id >> 24;
+        uint32_t seq = pkt.frame_id & 0xFFFFFF;
+        CHECK(id >= 1 && id <= NUM_THREADS);
+        if (id >= 1 && id <= NUM_THREADS) {
+            if (contiguous) {
+                CHECK(seq == next[id]);
+            } else {
+                CHECK(seq >= next[id]);
+            }
+            next[id] = (int64_t)seq + 1;
+        }
+        count++;
+    }
+    CHECK(n == 0);
+    fclose(fp);
+    return count;
+}
+
+static void testStalledWriter(const char *dir)
+{
+    char fifo[256];
+    snprintf(fifo, sizeof(fifo), "%s/camscope_test_fifo", dir);
+    unlink(fifo);
+    CHECK(mkfifo(fifo, 0600) == 0);
+
+    camscope_set_file(CAMSCOPE_SECTION_HAL, fifo);
+    camscope_init(CAMSCOPE_SECTION_HAL);
+
+    LoggerArgs args[NUM_THREADS];
+    pthread_t threads[NUM_THREADS];
+    int64_t start = nowNs();
+    runLoggers(args, STALL_PACKETS, 0, NULL, threads);
+    int64_t maxLatency = 0;
+    uint32_t logged = 0;
+    for (uint32_t t = 0; t < NUM_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+        if (args[t].maxLatencyNs > maxLatency) {
+            maxLatency = args[t].maxLatencyNs;
+        }
+        logged += args[t].logged;
+    }
+    int64_t elapsed = nowNs() - start;
+    uint32_t dropped = camscope_get_dropped(CAMSCOPE_SECTION_HAL);
+    printf("stalled writer: %u packets in %lld us, worst call %lld us, "
+           "%u dropped\n", logged, (long long)(elapsed / 1000),
+           (long long)(maxLatency / 1000), dropped);
+    CHECK(maxLatency < MAX_CALL_LATENCY_NS);
+    CHECK(dropped > 0);
+    CHECK(dropped < logged);
+
+    // unblock the flusher, everything not dropped must come out
+    ReaderArgs reader = { fifo, 0 };
+    pthread_t readerThread;
+    pthread_create(&readerThread, NULL, fifoReader, &reader);
+    camscope_destroy(CAMSCOPE_SECTION_HAL);
+    pthread_join(readerThread, NULL);
+    CHECK(reader.bytes == (uint64_t)(logged - dropped) * sizeof(camscope_timing));
+    unlink(fifo);
+}
+
+static void testPaced(const char *dir)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/camscope_test_paced.bin", dir);
+    unlink(path);
+
+    camscope_set_file(CAMSCOPE_SECTION_HAL, path);
+    camscope_init(CAMSCOPE_SECTION_HAL);
+    LoggerArgs args[NUM_THREADS];
+    pthread_t threads[NUM_THREADS];
+    runLoggers(args, PACED_PACKETS, PACED_BURST, NULL, threads);
+    for (uint32_t t = 0; t < NUM_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    CHECK(camscope_get_dropped(CAMSCOPE_SECTION_HAL) == 0);
+    camscope_destroy(CAMSCOPE_SECTION_HAL);
+
+    uint32_t count = checkFile(path, true);
+    printf("paced: %u of %u packets written\n", count,
+           NUM_THREADS * PACED_PACKETS);
+    CHECK(count == NUM_THREADS * PACED_PACKETS);
+    unlink(path);
+}
+
+// Like CAMSCOPE_UPDATE_FLAGS flipping the property while frames flow
+static void testToggle(const char *dir)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/camscope_test_toggle.bin", dir);
+    unlink(path);
+    camscope_set_file(CAMSCOPE_SECTION_HAL, path);
+
+    volatile bool stop = false;
+    LoggerArgs args[NUM_THREADS];
+    pthread_t threads[NUM_THREADS];
+    runLoggers(args, 0, PACED_BURST, &stop, threads);
+    for (int i = 0; i < 20; i++) {
+        camscope_init(CAMSCOPE_SECTION_HAL);
+        usleep(2000);
+        camscope_destroy(CAMSCOPE_SECTION_HAL);
+        usleep(500);
+    }
+    stop = true;
+    for (uint32_t t = 0; t < NUM_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    struct stat st;
+    CHECK(stat(path, &st) == 0);
+    CHECK((st.st_size % sizeof(camscope_timing)) == 0);
+    uint32_t count = checkFile(path, false);
+    printf("toggle: %u packets over 20 sessions\n", count);
+    CHECK(count > 0);
+    unlink(path);
+}
+
+int main()
+{
+    const char *dir = getenv("TMPDIR");
+    if (dir == NULL) {
+        dir = "/data/local/tmp";
+    }
+    kpi_camscope_frame_count = 1;
+    kpi_camscope_flags = CAMSCOPE_ON_FLAG;
+
+    testStalledWriter(dir);
+    testPaced(dir);
+    testToggle(dir);
+
+    return testResult("qcamera_camscope_test");
+}
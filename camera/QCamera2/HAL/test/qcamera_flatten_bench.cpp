@@ -0,0 +1,279 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Checks the CameraParameters flatten cache and unflatten against a
+// straightforward rebuild of the map, then times flatten and unflatten on a
+// parameter set the size of what QCameraParameters exposes (~250 keys).
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "CameraParameters.h"
+#include "qcamera_test_check.h"
+
+using namespace android;
+
+#define NUM_KEYS     250
+#define MAP_SIZE(MAP) (sizeof(MAP) / sizeof(MAP[0]))
+
+typedef struct {
+    const char *key;
+    const char *value;
+} KeyValue;
+
+// A sample of what a HAL1 getParameters() returns, the rest is filled up
+// with supported-values lists of the same shape
+static const KeyValue kParams[] = {
+    { "preview-size", "1440x1080" },
+    { "preview-size-values", "1920x1080,1440x1080,1280x960,1280x720,"
+            "1088x1088,960x720,800x480,720x480,640x480,352x288,320x240" },
+    { "picture-size", "4000x3000" },
+    { "picture-size-values", "4000x3000,4000x2250,3264x2448,3264x1836,"
+            "2592x1944,2048x1536,1920x1080,1600x1200,1280x960,640x480" },
+    { "video-size", "1920x1080" },
+    { "video-size-values", "3840x2160,1920x1080,1280x720,864x480,720x480,"
+            "640x480,352x288,320x240,176x144" },
+    { "preview-format", "yuv420sp" },
+    { "preview-format-values", "yuv420sp,yuv420p,yuv420p,nv12-venus" },
+    { "preview-fps-range", "7500,30000" },
+    { "preview-fps-range-values", "(7500,15000),(7500,24000),(7500,30000),"
+            "(15000,30000),(30000,30000)" },
+    { "focus-mode", "continuous-picture" },
+    { "focus-mode-values", "auto,infinity,macro,continuous-video,"
+            "continuous-picture,manual" },
+    { "whitebalance", "auto" },
+    { "whitebalance-values", "auto,incandescent,fluorescent,"
+            "warm-fluorescent,daylight,cloudy-daylight,twilight,shade" },
+    { "scene-mode", "auto" },
+    { "scene-mode-values", "auto,asd,action,portrait,landscape,night,"
+            "night-portrait,theatre,beach,snow,sunset,steadyphoto,fireworks,"
+            "sports,party,candlelight,backlight,flowers,AR,hdr" },
+    { "zoom", "0" },
+    { "zoom-ratios", "100,102,104,107,109,112,114,117,120,123,125,128,131,"
+            "135,138,141,144,148,151,155,158,162,166,170,174,178,182,186,190" },
+    { "jpeg-quality", "85" },
+    { "recording-hint", "false" },
+};
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void fillParams(CameraParameters &params)
+{
+    char key[32];
+    char value[128];
+
+    for (size_t i = 0; i < MAP_SIZE(kParams); i++) {
+        params.set(kParams[i].key, kParams[i].value);
+    }
+    for (size_t i = MAP_SIZE(kParams); i < NUM_KEYS; i++) {
+        if (i % 3 == 0) {
+            snprintf(key, sizeof(key), "qc-vendor-param-%03zu-values", i);
+            snprintf(value, sizeof(value), "off,on,auto,mode-%zu,mode-%zu",
+                    i, i + 1);
+        } else {
+            snprintf(key, sizeof(key), "qc-vendor-param-%03zu", i);
+            snprintf(value, sizeof(value), "%zu", i * 7);
+        }
+        params.set(key, value);
+    }
+}
+
+static void testFlattenCache()
+{
+    CameraParameters params;
+    fillParams(params);
+
+    String8 flat = params.flatten();
+    CameraParameters copy(flat);
+    CHECK(copy.flatten() == flat);
+    CHECK(!strcmp(copy.get("zoom"), "0"));
+
+    // Setting the same value keeps the cached string valid
+    params.set("zoom", "0");
+    CHECK(params.flatten() == flat);
+
+    params.set("zoom", "5");
+    String8 zoomed = params.flatten();
+    CHECK(strstr(zoomed.string(), ";zoom=5") != NULL);
+    CHECK(zoomed.length() == flat.length());
+
+    params.remove("zoom");
+    CHECK(strstr(params.flatten().string(), "zoom=") == NULL);
+    params.remove("zoom");
+    params.set("zoom", "0");
+    CHECK(params.flatten() == flat);
+
+    CameraParameters empty;
+    CHECK(empty.flatten().length() == 0);
+    empty.set("a", "1");
+    CHECK(!strcmp(empty.flatten().string(), "a=1"));
+}
+
+static void testFlattenOverride()
+{
+    CameraParameters params;
+    fillParams(params);
+    String8 flat = params.flatten();
+
+    CameraParameters scaled(flat);
+    scaled.set("picture-size", "1280x960");
+    String8 expected = scaled.flatten();
+
+    // The override neither changes the parameters nor drops their cache
+    String8 over = params.flatten("picture-size", "1280x960");
+    CHECK(over == expected);
+    CHECK(!strcmp(params.get("picture-size"), "4000x3000"));
+    CHECK(params.flatten().string() == flat.string());
+    CHECK(params.flatten("picture-size", "1280x960").string() == over.string());
+    CHECK(params.flatten("picture-size", "4000x3000") == flat);
+
+    params.set("zoom", "5");
+    over = params.flatten("picture-size", "1280x960");
+    CHECK(strstr(over.string(), ";zoom=5") != NULL);
+    CHECK(strstr(over.string(), "picture-size=1280x960;") != NULL);
+
+    // A key that isn't there is added, as set() would
+    over = params.flatten("a-new-key", "1");
+    CHECK(strstr(over.string(), "a-new-key=1;") != NULL);
+    CHECK(params.get("a-new-key") == NULL);
+}
+
+static void testUnflatten()
+{
+    static const struct {
+        const char *in;
+        const char *out;
+    } kCases[] = {
+        { "", "" },
+        { "a=1", "a=1" },
+        { "a=1;b=2;c=", "a=1;b=2;c=" },
+        { "b=2;a=1", "a=1;b=2" },           // unsorted
+        { "a=1;a=2", "a=2" },               // duplicate key
+        { "a=1;b=2;", "a=1;b=2" },          // trailing separator
+        { "a=1;junk", "a=1" },              // pair without '='
+    };
+
+    for (size_t i = 0; i < MAP_SIZE(kCases); i++) {
+        CameraParameters params;
+        params.set("stale", "1");
+        params.flatten();
+        params.unflatten(String8(kCases[i].in));
+        if (strcmp(params.flatten().string(), kCases[i].out)) {
+            printf("unflatten \"%s\": got \"%s\", expected \"%s\"\n",
+                    kCases[i].in, params.flatten().string(), kCases[i].out);
+            TEST_FAIL();
+        }
+    }
+}
+
+typedef void (*BenchFunc)(CameraParameters &params, const String8 &flat,
+        int iter);
+
+static void flattenCached(CameraParameters &params, const String8 &, int)
+{
+    String8 s = params.flatten();
+    CHECK(s.length() > 0);
+}
+
+static void flattenOverride(CameraParameters &params, const String8 &, int)
+{
+    String8 s = params.flatten("picture-size", "1280x960");
+    CHECK(s.length() > 0);
+}
+
+static void flattenChanged(CameraParameters &params, const String8 &, int iter)
+{
+    params.set("zoom", iter & 1);
+    String8 s = params.flatten();
+    CHECK(s.length() > 0);
+}
+
+static void unflattenSorted(CameraParameters &params, const String8 &flat, int)
+{
+    params.unflatten(flat);
+}
+
+static void unflattenRoundTrip(CameraParameters &params, const String8 &flat,
+        int)
+{
+    params.unflatten(flat);
+    String8 s = params.flatten();
+    CHECK(s.length() == flat.length());
+}
+
+static void bench(const char *what, BenchFunc func, int iters)
+{
+    CameraParameters params;
+    fillParams(params);
+    String8 flat = params.flatten();
+    uint64_t best = UINT64_MAX;
+
+    for (int round = 0; round < 5; round++) {
+        uint64_t start = nowNs();
+        for (int i = 0; i < iters; i++) {
+            func(params, flat, i);
+        }
+        uint64_t ns = (nowNs() - start) / iters;
+        best = (ns < best) ? ns : best;
+    }
+    printf("  %-28s %8llu ns\n", what, (unsigned long long)best);
+}
+
+int main(int argc, char **argv)
+{
+    int iters = (argc > 1) ? atoi(argv[1]) : 2000;
+
+    if (iters <= 0) {
+        printf("usage: %s [iterations]\n", argv[0]);
+        return -1;
+    }
+    testFlattenCache();
+    testFlattenOverride();
+    testUnflatten();
+
+    CameraParameters params;
+    fillParams(params);
+    printf("%d keys, %zu bytes flattened, %d iterations\n", NUM_KEYS,
+            params.flatten().length(), iters);
+    bench("flatten, unchanged", flattenCached, iters);
+    bench("flatten with picture-size", flattenOverride, iters);
+    bench("flatten after one set", flattenChanged, iters);
+    bench("unflatten", unflattenSorted, iters);
+    bench("unflatten + flatten", unflattenRoundTrip, iters);
+
+    return testResult("qcamera_flatten_bench");
+}
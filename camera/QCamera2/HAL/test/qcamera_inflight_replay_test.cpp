@@ -0,0 +1,484 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Replays request/result orderings seen from the HAL3 pipeline against the
+// in-flight bookkeeping of QCamera3InflightTracker.h: the frame number index
+// lookup behind QCamera3HardwareInterface::findPendingRequest and the real
+// PendingBuffersMap. Every lookup is checked against the linear scan it
+// replaces.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "QCamera3InflightTracker.h"
+#include "qcamera_test_check.h"
+
+using namespace android;
+using namespace qcamera;
+
+#define NUM_STREAMS     3
+#define STREAM_NUM_BUFS 64
+#define HFR_BATCH       48
+
+typedef enum {
+    EV_REQUEST,     // process_capture_request, stream mask in arg
+    EV_METADATA,    // metadata for the frame
+    EV_BUFFER,      // buffer of stream arg for the frame
+    EV_FLUSH,       // flush, error out everything pending
+    EV_END,
+} event_type_t;
+
+typedef struct {
+    event_type_t type;
+    uint32_t frame;
+    uint32_t arg;
+} event_t;
+
+// The fields of PendingRequestInfo the replay needs
+typedef struct {
+    uint32_t frame_number;
+    uint32_t streams;       // streams still owing a buffer
+    bool meta;
+    buffer_handle_t *bufs[NUM_STREAMS];
+} Request;
+
+typedef List<Request>::iterator reqIt;
+typedef List<PendingBuffersInRequest>::iterator bufReqIt;
+
+static camera3_stream_t gStreams[NUM_STREAMS];
+// Gralloc buffers are recycled: a handle is requested again only after the
+// HAL returned it, like a BufferQueue slot
+static buffer_handle_t gHandles[NUM_STREAMS][STREAM_NUM_BUFS];
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Request of a pending buffer by a linear scan of the map
+static bufReqIt scanBuf(PendingBuffersMap &map, buffer_handle_t *buf)
+{
+    for (auto r = map.mPendingBuffersInRequest.begin();
+            r != map.mPendingBuffersInRequest.end(); r++) {
+        for (auto &k : r->mPendingBufferList) {
+            if (k.buffer == buf) {
+                return r;
+            }
+        }
+    }
+    return map.mPendingBuffersInRequest.end();
+}
+
+class Tracker {
+public:
+    Tracker() : mLookups(0), mScans(0), mReqNs(0), mLinearReqNs(0)
+    {
+        for (uint32_t s = 0; s < NUM_STREAMS; s++) {
+            for (uint32_t b = 0; b < STREAM_NUM_BUFS; b++) {
+                mFree[s].push_back(&gHandles[s][b]);
+            }
+        }
+    }
+
+    // like processCaptureRequest
+    void request(uint32_t frame, uint32_t streams)
+    {
+        Request r;
+        memset(&r, 0, sizeof(r));
+        r.frame_number = frame;
+        r.streams = streams;
+        PendingBuffersInRequest bufs;
+        bufs.frame_number = frame;
+        bufs.timestamp = 0;
+        for (uint32_t s = 0; s < NUM_STREAMS; s++) {
+            if (streams & (1U << s)) {
+                CHECK(!mFree[s].empty());
+                r.bufs[s] = *mFree[s].begin();
+                mFree[s].erase(mFree[s].begin());
+                PendingBufferInfo info;
+                info.stream = &gStreams[s];
+                info.buffer = r.bufs[s];
+                bufs.mPendingBufferList.push_back(info);
+            }
+        }
+        if (!bufs.mPendingBufferList.empty()) {
+            mBufMap.addRequest(bufs);
+        }
+        reqIt i = mReqs.insert(mReqs.end(), r);
+        mIndex.add(frame, i);
+    }
+
+    // like erasePendingRequest
+    reqIt erase(reqIt i)
+    {
+        mIndex.remove(i->frame_number, i);
+        return mReqs.erase(i);
+    }
+
+    // like findPendingRequest, checked against a linear scan
+    reqIt find(uint32_t frame)
+    {
+        uint64_t start = nowNs();
+        reqIt linear;
+        for (linear = mReqs.begin(); linear != mReqs.end(); linear++) {
+            if (linear->frame_number == frame) {
+                break;
+            }
+        }
+        uint64_t mid = nowNs();
+        reqIt i = mIndex.lookup(frame, mReqs);
+        mReqNs += nowNs() - mid;
+        mLinearReqNs += mid - start;
+
+        reqIt hit;
+        mLookups++;
+        if (!mIndex.find(frame, hit) && !mIndex.isComplete()) {
+            mScans++;
+        }
+        CHECK(i == linear);
+        return i;
+    }
+
+    // like handleBufferWithLock, checked against a linear scan
+    void removeBuf(buffer_handle_t *buf)
+    {
+        bool found = (scanBuf(mBufMap, buf) != mBufMap.mPendingBuffersInRequest.end());
+        int32_t status = mBufMap.getBufErrStatus(buf);
+        CHECK(status == CAMERA3_BUFFER_STATUS_OK);
+        uint32_t before = mBufMap.get_num_overall_buffers();
+        mBufMap.removeBuf(buf);
+        CHECK(mBufMap.get_num_overall_buffers() == before - (found ? 1 : 0));
+        CHECK(scanBuf(mBufMap, buf) == mBufMap.mPendingBuffersInRequest.end());
+    }
+
+    void complete(reqIt i)
+    {
+        if (i->meta && (i->streams == 0)) {
+            erase(i);
+        }
+    }
+
+    // like notifyErrorForPendingRequests
+    void flush()
+    {
+        for (reqIt i = mReqs.begin(); i != mReqs.end(); ) {
+            for (uint32_t s = 0; s < NUM_STREAMS; s++) {
+                if (i->streams & (1U << s)) {
+                    mFree[s].push_back(i->bufs[s]);
+                }
+            }
+            i = erase(i);
+        }
+        for (bufReqIt r = mBufMap.mPendingBuffersInRequest.begin();
+                r != mBufMap.mPendingBuffersInRequest.end(); ) {
+            for (auto info = r->mPendingBufferList.begin();
+                    info != r->mPendingBufferList.end(); ) {
+                info = r->mPendingBufferList.erase(info);
+            }
+            r = mBufMap.eraseRequest(r);
+        }
+        mBufMap.clear();
+    }
+
+    void replay(const event_t *ev)
+    {
+        for (; ev->type != EV_END; ev++) {
+            reqIt i;
+            switch (ev->type) {
+            case EV_REQUEST:
+                request(ev->frame, ev->arg);
+                break;
+            case EV_METADATA:
+                i = find(ev->frame);
+                if (i != mReqs.end()) {
+                    i->meta = true;
+                    complete(i);
+                }
+                break;
+            case EV_BUFFER:
+                i = find(ev->frame);
+                if (i != mReqs.end() && (i->streams & (1U << ev->arg))) {
+                    i->streams &= ~(1U << ev->arg);
+                    removeBuf(i->bufs[ev->arg]);
+                    mFree[ev->arg].push_back(i->bufs[ev->arg]);
+                    complete(i);
+                }
+                break;
+            case EV_FLUSH:
+                flush();
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    List<Request> mReqs;
+    QCamera3FrameIndex<reqIt> mIndex;
+    PendingBuffersMap mBufMap;
+    List<buffer_handle_t *> mFree[NUM_STREAMS];
+    uint64_t mLookups;
+    uint64_t mScans;
+    uint64_t mReqNs;
+    uint64_t mLinearReqNs;
+};
+
+// Preview plus a snapshot whose JPEG lands after later preview frames
+static const event_t kSnapshot[] = {
+    { EV_REQUEST, 1, 0x1 }, { EV_REQUEST, 2, 0x3 }, { EV_REQUEST, 3, 0x1 },
+    { EV_METADATA, 1, 0 }, { EV_BUFFER, 1, 0 },
+    { EV_METADATA, 2, 0 }, { EV_BUFFER, 2, 0 },
+    { EV_REQUEST, 4, 0x1 },
+    { EV_METADATA, 3, 0 }, { EV_BUFFER, 3, 0 },
+    { EV_METADATA, 4, 0 }, { EV_BUFFER, 4, 0 },
+    { EV_BUFFER, 2, 1 },
+    { EV_BUFFER, 9, 0 },    // unknown frame, sent straight to the framework
+    { EV_END, 0, 0 },
+};
+
+// Buffers ahead of metadata, then a flush with requests in flight
+static const event_t kFlush[] = {
+    { EV_REQUEST, 10, 0x5 }, { EV_REQUEST, 11, 0x5 }, { EV_REQUEST, 12, 0x5 },
+    { EV_BUFFER, 10, 2 }, { EV_BUFFER, 10, 0 }, { EV_METADATA, 10, 0 },
+    { EV_BUFFER, 11, 0 },
+    { EV_FLUSH, 0, 0 },
+    { EV_METADATA, 11, 0 },  // late result of a flushed request
+    { EV_REQUEST, 13, 0x5 }, { EV_BUFFER, 13, 0 }, { EV_BUFFER, 13, 2 },
+    { EV_METADATA, 13, 0 },
+    { EV_END, 0, 0 },
+};
+
+// Reprocess requests held across a full ring of frame numbers
+static const event_t kCollision[] = {
+    { EV_REQUEST, 100, 0x2 }, { EV_REQUEST, 228, 0x1 }, { EV_REQUEST, 356, 0x1 },
+    { EV_METADATA, 228, 0 }, { EV_BUFFER, 228, 0 },
+    { EV_METADATA, 356, 0 },
+    { EV_METADATA, 100, 0 }, { EV_BUFFER, 100, 1 },
+    { EV_BUFFER, 356, 0 },
+    { EV_REQUEST, 484, 0x1 }, { EV_METADATA, 484, 0 }, { EV_BUFFER, 484, 0 },
+    { EV_END, 0, 0 },
+};
+
+static void testRecorded()
+{
+    const event_t *traces[] = { kSnapshot, kFlush, kCollision };
+    for (size_t t = 0; t < sizeof(traces) / sizeof(traces[0]); t++) {
+        Tracker tr;
+        tr.replay(traces[t]);
+        CHECK(tr.mReqs.empty());
+        CHECK(tr.mBufMap.mPendingBuffersInRequest.empty());
+        CHECK(tr.mIndex.isComplete());
+    }
+}
+
+// A long HFR session: 48 requests in flight, metadata for a frame arriving
+// a few frames after its request while its buffers complete only when the
+// pipeline is full, out of order within a frame. A reprocess request is held
+// every 500 frames and the session is flushed periodically.
+static void testSession()
+{
+    const uint32_t frames = 20000;
+    const uint32_t metaLag = 4;
+    static event_t ev[frames * 6 + 2];
+    size_t n = 0;
+    uint32_t seed = 12345;
+    uint32_t first = 1;
+    uint32_t held = 0;
+    for (uint32_t f = 1; f <= frames; f++) {
+        ev[n++] = { EV_REQUEST, f, ((f % 30) == 0) ? 0x7U : 0x3U };
+        if ((f % 500) == 0) {
+            held = f;
+        }
+        if ((f >= first + metaLag) && (f - metaLag != held)) {
+            ev[n++] = { EV_METADATA, f - metaLag, 0 };
+        }
+        if ((f >= first + HFR_BATCH) && (f - HFR_BATCH != held)) {
+            uint32_t done = f - HFR_BATCH;
+            uint32_t s = ((done % 30) == 0) ? 3 : 2;
+            seed = seed * 1103515245 + 12345;
+            for (uint32_t k = 0; k < s; k++) {
+                ev[n++] = { EV_BUFFER, done, (k + (seed >> 16)) % s };
+            }
+        }
+        if ((held != 0) && (f - held > 200)) {
+            ev[n++] = { EV_METADATA, held, 0 };
+            for (uint32_t k = 0; k < NUM_STREAMS; k++) {
+                ev[n++] = { EV_BUFFER, held, k };
+            }
+            held = 0;
+        }
+        if ((f % 4999) == 0) {
+            ev[n++] = { EV_FLUSH, 0, 0 };
+            first = f + 1;
+            held = 0;
+        }
+    }
+    ev[n++] = { EV_FLUSH, 0, 0 };
+    ev[n] = { EV_END, 0, 0 };
+
+    Tracker tr;
+    tr.replay(ev);
+    printf("session: %zu events, %llu lookups, %llu fallback scans\n",
+            n, (unsigned long long)tr.mLookups, (unsigned long long)tr.mScans);
+    printf("  request lookups %llu us indexed vs %llu us linear\n",
+            (unsigned long long)(tr.mReqNs / 1000),
+            (unsigned long long)(tr.mLinearReqNs / 1000));
+    CHECK(tr.mReqs.empty());
+    CHECK(tr.mBufMap.mPendingBuffersInRequest.empty());
+}
+
+// PendingBuffersMap lookups across requests sharing and losing buffers
+static void testBufferLookup()
+{
+    static buffer_handle_t h, g, k;
+    PendingBuffersMap map;
+    PendingBufferInfo info;
+    info.stream = &gStreams[0];
+
+    // h is requested by frames 1 and 2, and frame 2 gives it up again:
+    // the lookup lands on frame 1
+    PendingBuffersInRequest req1;
+    req1.frame_number = 1;
+    req1.timestamp = 0;
+    info.buffer = &h;
+    info.bufStatus = CAMERA3_BUFFER_STATUS_ERROR;
+    req1.mPendingBufferList.push_back(info);
+    map.addRequest(req1);
+
+    PendingBuffersInRequest req2;
+    req2.frame_number = 2;
+    req2.timestamp = 0;
+    info.bufStatus = CAMERA3_BUFFER_STATUS_OK;
+    req2.mPendingBufferList.push_back(info);
+    info.buffer = &g;
+    req2.mPendingBufferList.push_back(info);
+    map.addRequest(req2);
+
+    bufReqIt r2 = map.mPendingBuffersInRequest.begin();
+    r2++;
+    CHECK(r2->frame_number == 2);
+    r2->mPendingBufferList.erase(r2->mPendingBufferList.begin());
+
+    CHECK(map.getBufErrStatus(&h) == CAMERA3_BUFFER_STATUS_ERROR);
+    map.removeBuf(&h);
+    CHECK(map.mPendingBuffersInRequest.size() == 1);
+    CHECK(map.mPendingBuffersInRequest.begin()->frame_number == 2);
+    CHECK(map.get_num_overall_buffers() == 1);
+
+    // Buffers of an erased request are no longer pending
+    PendingBuffersInRequest req3;
+    req3.frame_number = 3;
+    req3.timestamp = 0;
+    info.buffer = &k;
+    req3.mPendingBufferList.push_back(info);
+    map.addRequest(req3);
+    bufReqIt r3 = map.mPendingBuffersInRequest.begin();
+    r3++;
+    map.eraseRequest(r3);
+    CHECK(map.getBufErrStatus(&k) == CAMERA3_BUFFER_STATUS_OK);
+    map.removeBuf(&k);
+    CHECK(map.get_num_overall_buffers() == 1);
+
+    map.removeBuf(&g);
+    CHECK(map.mPendingBuffersInRequest.empty());
+    map.clear();
+}
+
+// The frame index lookup scans only while an entry is left unindexed
+static void testFrameIndexLookup()
+{
+    List<Request> reqs;
+    QCamera3FrameIndex<reqIt> index;
+    Request r;
+    memset(&r, 0, sizeof(r));
+
+    r.frame_number = 5;
+    reqIt a = reqs.insert(reqs.end(), r);
+    index.add(5, a);
+    CHECK(index.lookup(5, reqs) == a);
+    CHECK(index.lookup(6, reqs) == reqs.end());
+
+    // 5 + QCAMERA3_FRAME_INDEX_SLOTS shares the slot of 5
+    r.frame_number = 5 + QCAMERA3_FRAME_INDEX_SLOTS;
+    reqIt b = reqs.insert(reqs.end(), r);
+    index.add(r.frame_number, b);
+    CHECK(!index.isComplete());
+    CHECK(index.lookup(r.frame_number, reqs) == b);
+    CHECK(index.lookup(6, reqs) == reqs.end());
+
+    index.remove(b->frame_number, b);
+    reqs.erase(b);
+    CHECK(index.isComplete());
+    index.remove(a->frame_number, a);
+    reqs.erase(a);
+    CHECK(index.lookup(5, reqs) == reqs.end());
+}
+
+// More handles than ways per bucket: evicted hints must not break lookups
+static void testBufferIndexEviction()
+{
+    static int handles[1024];
+    QCamera3BufferIndex index;
+    for (uint32_t i = 0; i < 1024; i++) {
+        index.add(&handles[i], i);
+    }
+    uint32_t hits = 0;
+    for (uint32_t i = 0; i < 1024; i++) {
+        uint32_t val;
+        if (index.find(&handles[i], val)) {
+            CHECK(val == i);
+            hits++;
+        }
+    }
+    CHECK(hits == QCAMERA3_BUFFER_INDEX_BUCKETS * QCAMERA3_BUFFER_INDEX_WAYS);
+    // updates in place and removal
+    index.add(&handles[1023], 7);
+    uint32_t val = 0;
+    CHECK(index.find(&handles[1023], val) && (val == 7));
+    index.remove(&handles[1023]);
+    CHECK(!index.find(&handles[1023], val));
+    index.clear();
+    CHECK(!index.find(&handles[0], val));
+    CHECK(!index.find(NULL, val));
+}
+
+int main()
+{
+    testRecorded();
+    testSession();
+    testBufferLookup();
+    testFrameIndexLookup();
+    testBufferIndexEviction();
+
+    return testResult("qcamera_inflight_replay_test");
+}
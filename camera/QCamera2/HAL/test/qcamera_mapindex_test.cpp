@@ -0,0 +1,401 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Checks QCameraMapIndex against the linear scan it replaces in
+// QCameraParameters::lookupAttr and lookupNameByValue, on the real tables
+// QCameraParameters indexes, then replays the lookups updateParameters does
+// for a full HAL1 parameter string and times both.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "QCameraParameters.h"
+#include "qcamera_test_check.h"
+
+using namespace qcamera;
+
+#define NOT_FOUND    (-1)
+#define MAP_SIZE(MAP) (sizeof(MAP) / sizeof(MAP[0]))
+
+typedef struct {
+    const char *desc;
+    int val;
+} TestMap;
+
+// Repeats a name and a value: the first entry wins both ways
+static const TestMap kDuplicates[] = {
+    { "off", 0 }, { "on", 1 }, { "off", 2 }, { "disabled", 0 },
+    { "low", 3 }, { "mid", 4 }, { "high", 5 }, { "max", 6 },
+};
+// Long enough for the index but never added to it
+static const TestMap kNotIndexed[] = {
+    { "off", 0 }, { "on", 1 }, { "auto", 2 }, { "low", 3 },
+    { "mid", 4 }, { "high", 5 }, { "max", 6 }, { "min", 7 },
+};
+static const TestMap kOnOff[] = {
+    { "off", 0 }, { "on", 1 },
+};
+
+// Tables QCameraParameters::indexMaps is expected to add
+static const char *kIndexedMaps[] = {
+    "PICTURE_TYPES_MAP", "FOCUS_MODES_MAP", "EFFECT_MODES_MAP",
+    "SCENE_MODES_MAP", "WHITE_BALANCE_MODES_MAP", "ISO_MODES_MAP",
+    "HFR_MODES_MAP",
+};
+
+// Keys of the parameter string that updateParameters resolves through an
+// indexed map
+typedef struct {
+    const char *key;
+    const char *map;
+} KeyMap;
+
+static const KeyMap kKeyMaps[] = {
+    { "picture-format", "PICTURE_TYPES_MAP" },
+    { "focus-mode", "FOCUS_MODES_MAP" },
+    { "effect", "EFFECT_MODES_MAP" },
+    { "scene-mode", "SCENE_MODES_MAP" },
+    { "whitebalance", "WHITE_BALANCE_MODES_MAP" },
+    { "iso", "ISO_MODES_MAP" },
+    { "video-hfr", "HFR_MODES_MAP" },
+    { "video-hsr", "HFR_MODES_MAP" },
+};
+
+// Flattened parameters of a HAL1 app in ZSL preview, mostly defaults
+static const char kParams[] =
+    "preview-size=1920x1080;preview-format=yuv420sp;preview-frame-rate=30;"
+    "preview-fps-range=7500,30000;picture-size=4000x3000;"
+    "picture-format=jpeg;jpeg-quality=95;jpeg-thumbnail-size=512x384;"
+    "jpeg-thumbnail-quality=85;rotation=0;gps-timestamp=1600000000;"
+    "whitebalance=auto;effect=none;antibanding=auto;scene-mode=auto;"
+    "flash-mode=off;focus-mode=continuous-picture;focal-length=4.73;"
+    "horizontal-view-angle=65.2;vertical-view-angle=51.3;"
+    "exposure-compensation=0;max-exposure-compensation=12;"
+    "min-exposure-compensation=-12;exposure-compensation-step=0.166667;"
+    "auto-exposure-lock=false;auto-whitebalance-lock=false;"
+    "focus-areas=(0,0,0,0,0);metering-areas=(0,0,0,0,0);zoom=0;"
+    "max-zoom=79;smooth-zoom-supported=false;zoom-supported=true;"
+    "video-size=1920x1080;recording-hint=false;video-stabilization=false;"
+    "iso=auto;auto-exposure=center-weighted;sharpness=12;contrast=5;"
+    "saturation=5;brightness=3;skinToneEnhancement=0;lens-shading=enable;"
+    "zsl=on;denoise=denoise-on;redeye-reduction=disable;"
+    "face-detection=off;face-recognition=off;ae-bracket-hdr=off;"
+    "video-hdr=off;sensor-hdr=off;video-hfr=off;video-hsr=off;"
+    "cds-mode=auto;video-cds-mode=on;preview-flip=off;video-flip=off;"
+    "snapshot-picture-flip=off;dis=disable;tintless=enable;"
+    "num-snaps-per-shutter=1;longshot-supported=true;"
+    "manual-focus-position=0;wb-manual-cct=5000;";
+
+// The mapped keys of the same app with a scene picked and HFR recording
+static const char kParamsNonDefault[] =
+    "picture-format=yuv422sp;whitebalance=cloudy-daylight;effect=sketch;"
+    "scene-mode=fireworks;focus-mode=continuous-video;iso=ISO1600;"
+    "video-hfr=120;video-hsr=60;";
+
+// Typed copy of an indexed table, scanned the way lookupAttr does
+typedef struct {
+    const QCameraMapIndex::Table *table;
+    TestMap entries[128];
+} LinearMap;
+
+typedef struct {
+    const LinearMap *map;
+    char value[32];
+} Lookup;
+
+static int linearName(const TestMap *map, size_t len, const char *name)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (!strcmp(map[i].desc, name))
+            return map[i].val;
+    }
+    return NOT_FOUND;
+}
+
+static const char *linearValue(const TestMap *map, size_t len, int val)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (map[i].val == val)
+            return map[i].desc;
+    }
+    return NULL;
+}
+
+// Same dispatch as lookupAttr in QCameraParameters.cpp
+static int indexName(const QCameraMapIndex &index, const void *map,
+        const TestMap *entries, size_t len, const char *name)
+{
+    if ((len >= QCAMERA_MAP_INDEX_MIN_LEN) && strcmp(entries[0].desc, name)) {
+        int val;
+
+        if (index.findName(map, name, val)) {
+            return val;
+        }
+        if (index.isIndexed(map)) {
+            return NOT_FOUND;
+        }
+    }
+    return linearName(entries, len, name);
+}
+
+static const QCameraMapIndex::Table *findTable(const QCameraMapIndex &index,
+        const char *name)
+{
+    for (size_t i = 0; i < index.getTableCount(); i++) {
+        if (!strcmp(index.getTable(i).name, name)) {
+            return &index.getTable(i);
+        }
+    }
+    return NULL;
+}
+
+static bool copyTable(const QCameraMapIndex::Table *table, LinearMap &copy)
+{
+    if ((table == NULL) || (table->len > MAP_SIZE(copy.entries))) {
+        return false;
+    }
+    copy.table = table;
+    for (size_t i = 0; i < table->len; i++) {
+        copy.entries[i].desc = table->descAt(table->map, i);
+        copy.entries[i].val = table->valAt(table->map, i);
+    }
+    return true;
+}
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void testRealMaps(const QCameraMapIndex &index)
+{
+    static const char *kProbes[] = {
+        "", "of", "offf", "OFF", "auto ", "continuous", "ISO", "none",
+    };
+    static LinearMap copy;
+
+    CHECK(index.getTableCount() == MAP_SIZE(kIndexedMaps));
+    for (size_t m = 0; m < MAP_SIZE(kIndexedMaps); m++) {
+        const QCameraMapIndex::Table *table = findTable(index, kIndexedMaps[m]);
+        CHECK(table != NULL);
+        if (!copyTable(table, copy)) {
+            CHECK(!"table missing or too long to copy");
+            continue;
+        }
+        const TestMap *entries = copy.entries;
+        size_t len = table->len;
+        // every registered table is long enough to be indexed
+        CHECK(len >= QCAMERA_MAP_INDEX_MIN_LEN);
+        CHECK(index.isIndexed(table->map));
+        for (size_t i = 0; i < len; i++) {
+            const char *name = NULL;
+            int val = NOT_FOUND;
+            CHECK(index.findName(table->map, entries[i].desc, val));
+            CHECK(val == linearName(entries, len, entries[i].desc));
+            CHECK(index.findValue(table->map, entries[i].val, name));
+            CHECK(name == linearValue(entries, len, entries[i].val));
+            // a copy of the string finds the same entry
+            char str[64];
+            snprintf(str, sizeof(str), "%s", entries[i].desc);
+            CHECK(indexName(index, table->map, entries, len, str) ==
+                    linearName(entries, len, entries[i].desc));
+        }
+        for (size_t i = 0; i < MAP_SIZE(kProbes); i++) {
+            CHECK(indexName(index, table->map, entries, len, kProbes[i]) ==
+                    linearName(entries, len, kProbes[i]));
+        }
+        const char *name = NULL;
+        CHECK(!index.findValue(table->map, 1000, name));
+    }
+}
+
+static void addTestMaps(QCameraMapIndex &index)
+{
+    CHECK(index.add(kDuplicates, MAP_SIZE(kDuplicates), "kDuplicates"));
+    // short tables are refused and left to the linear scan
+    CHECK(!index.add(kOnOff, MAP_SIZE(kOnOff), "kOnOff"));
+}
+
+static void testSynthetic()
+{
+    QCameraMapIndex index(addTestMaps);
+    int val = NOT_FOUND;
+    const char *name = NULL;
+
+    CHECK(index.getTableCount() == 1);
+    // first entry wins for repeated names and values
+    CHECK(index.findName(kDuplicates, "off", val) && (val == 0));
+    CHECK(index.findValue(kDuplicates, 0, name) && !strcmp(name, "off"));
+    CHECK(index.findValue(kDuplicates, 2, name) && !strcmp(name, "off"));
+
+    // a table that was never added falls back to the linear scan
+    CHECK(!index.isIndexed(kNotIndexed));
+    CHECK(!index.findName(kNotIndexed, "on", val));
+    CHECK(indexName(index, kNotIndexed, kNotIndexed,
+            MAP_SIZE(kNotIndexed), "on") == 1);
+    CHECK(!index.isIndexed(kOnOff));
+}
+
+static void testFull()
+{
+    static TestMap big[QCAMERA_MAP_INDEX_SLOTS];
+    static char names[QCAMERA_MAP_INDEX_SLOTS][8];
+    QCameraMapIndex index;
+
+    for (int i = 0; i < QCAMERA_MAP_INDEX_SLOTS; i++) {
+        snprintf(names[i], sizeof(names[i]), "n%d", i);
+        big[i].desc = names[i];
+        big[i].val = i;
+    }
+    // more than half the slots is refused as a whole
+    CHECK(!index.add(big, QCAMERA_MAP_INDEX_SLOTS / 2, "big"));
+    CHECK(!index.isIndexed(big));
+    CHECK(index.add(big, QCAMERA_MAP_INDEX_SLOTS / 2 - 1, "big"));
+    CHECK(index.isIndexed(big));
+    for (int i = 0; i < QCAMERA_MAP_INDEX_SLOTS / 2 - 1; i++) {
+        int val = NOT_FOUND;
+        CHECK(index.findName(big, names[i], val) && (val == i));
+    }
+    CHECK(!index.add(kNotIndexed, MAP_SIZE(kNotIndexed), "kNotIndexed"));
+    CHECK(index.getTableCount() == 1);
+}
+
+static size_t parseParams(const char *params, const LinearMap *maps,
+        Lookup *lookups, size_t max)
+{
+    size_t count = 0;
+    const char *p = params;
+
+    while (*p && (count < max)) {
+        const char *eq = strchr(p, '=');
+        const char *end = strchr(p, ';');
+        if (!eq || !end || (eq > end)) {
+            break;
+        }
+        for (size_t i = 0; i < MAP_SIZE(kKeyMaps); i++) {
+            if ((strlen(kKeyMaps[i].key) == (size_t)(eq - p)) &&
+                    !strncmp(kKeyMaps[i].key, p, eq - p)) {
+                lookups[count].map = &maps[i];
+                snprintf(lookups[count].value, sizeof(lookups[count].value),
+                        "%.*s", (int)(end - eq - 1), eq + 1);
+                count++;
+                break;
+            }
+        }
+        p = end + 1;
+    }
+    return count;
+}
+
+typedef int (*LookupFunc)(const QCameraMapIndex &index, const void *map,
+        const TestMap *entries, size_t len, const char *name);
+
+static int linearLookup(const QCameraMapIndex & /*index*/,
+        const void * /*map*/, const TestMap *entries, size_t len,
+        const char *name)
+{
+    return linearName(entries, len, name);
+}
+
+static uint64_t timeReplay(const QCameraMapIndex &index, LookupFunc lookup,
+        const Lookup *lookups, size_t count, int replays)
+{
+    volatile int sink = 0;
+    uint64_t start = nowNs();
+
+    for (int r = 0; r < replays; r++) {
+        for (size_t i = 0; i < count; i++) {
+            const LinearMap *lm = lookups[i].map;
+            sink += lookup(index, lm->table->map, lm->entries, lm->table->len,
+                    lookups[i].value);
+        }
+    }
+    return (nowNs() - start) / replays;
+}
+
+static void benchReplay(const QCameraMapIndex &index, const char *what,
+        const char *params, int replays)
+{
+    static LinearMap maps[MAP_SIZE(kKeyMaps)];
+    Lookup lookups[MAP_SIZE(kKeyMaps)];
+    uint64_t linearNs = UINT64_MAX;
+    uint64_t indexNs = UINT64_MAX;
+
+    for (size_t i = 0; i < MAP_SIZE(kKeyMaps); i++) {
+        if (!copyTable(findTable(index, kKeyMaps[i].map), maps[i])) {
+            CHECK(!"table missing or too long to copy");
+            return;
+        }
+    }
+    size_t count = parseParams(params, maps, lookups, MAP_SIZE(lookups));
+    CHECK(count == MAP_SIZE(kKeyMaps));
+    for (size_t i = 0; i < count; i++) {
+        const LinearMap *lm = lookups[i].map;
+        int val = linearName(lm->entries, lm->table->len, lookups[i].value);
+        CHECK(val != NOT_FOUND);
+        CHECK(indexName(index, lm->table->map, lm->entries, lm->table->len,
+                lookups[i].value) == val);
+    }
+
+    // alternate the two and keep the best round of each
+    for (int round = 0; round < 5; round++) {
+        uint64_t ns = timeReplay(index, linearLookup, lookups, count, replays);
+        linearNs = (ns < linearNs) ? ns : linearNs;
+        ns = timeReplay(index, indexName, lookups, count, replays);
+        indexNs = (ns < indexNs) ? ns : indexNs;
+    }
+
+    printf("%s: %zu indexed lookups per parameter string, %d replays\n",
+            what, count, replays);
+    printf("  linear %6llu ns per string\n", (unsigned long long)linearNs);
+    printf("  index  %6llu ns per string\n", (unsigned long long)indexNs);
+}
+
+int main(int argc, char **argv)
+{
+    int replays = (argc > 1) ? atoi(argv[1]) : 100000;
+    const QCameraMapIndex &index = QCameraParameters::getMapIndex();
+
+    if (replays <= 0) {
+        printf("usage: %s [replays]\n", argv[0]);
+        return -1;
+    }
+    testRealMaps(index);
+    testSynthetic();
+    testFull();
+    benchReplay(index, "defaults", kParams, replays);
+    benchReplay(index, "non-default", kParamsNonDefault, replays);
+
+    return testResult("qcamera_mapindex_test");
+}
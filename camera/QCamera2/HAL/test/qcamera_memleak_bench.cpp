@@ -0,0 +1,244 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Compares the libhal_dbg allocation tracker modes on a camera-like
+// allocation mix: plain pass-through, full tracing of every allocation
+// under one lock, and the sampled mode with sharded tables. Each mode runs
+// in its own child process because the tracker cannot be switched back
+// off. The sampled mode is also checked for its leak estimate and for
+// forgetting every sample that gets freed or reallocated.
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "leak/memleak.h"
+#include "qcamera_test_check.h"
+
+extern "C" void *__wrap_malloc(size_t size);
+extern "C" void *__wrap_calloc(size_t nmemb, size_t size);
+extern "C" void *__wrap_realloc(void *ptr, size_t size);
+extern "C" void __wrap_free(void *ptr);
+
+#define MAX_THREADS         4
+#define LIVE_SLOTS          512     // allocations each thread keeps alive
+#define LEAK_COUNT          16384
+#define LEAK_SIZE           4096
+
+typedef enum {
+    MODE_OFF,
+    MODE_FULL,
+    MODE_SAMPLED,
+} Mode;
+
+static const char *kModeNames[] = { "off", "full", "sampled" };
+
+typedef struct {
+    uint32_t seed;
+    int iterations;
+} WorkerArgs;
+
+static int64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static uint32_t nextRand(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Mostly small control structures, some metadata sized blocks and the
+// occasional large scratch buffer.
+static size_t pickSize(uint32_t *state)
+{
+    uint32_t r = nextRand(state);
+    uint32_t bucket = r % 100;
+    if (bucket < 80) {
+        return 16 + (r >> 8) % 496;
+    } else if (bucket < 98) {
+        return 512 + (r >> 8) % 15872;
+    }
+    return 65536 + (r >> 8) % 458752;
+}
+
+static void *worker(void *data)
+{
+    WorkerArgs *args = (WorkerArgs *)data;
+    void *live[LIVE_SLOTS];
+    uint32_t state = args->seed;
+
+    memset(live, 0, sizeof(live));
+    for (int i = 0; i < args->iterations; i++) {
+        uint32_t slot = nextRand(&state) % LIVE_SLOTS;
+        __wrap_free(live[slot]);
+        if ((i & 15) == 0) {
+            live[slot] = __wrap_calloc(1, pickSize(&state));
+        } else {
+            live[slot] = __wrap_malloc(pickSize(&state));
+        }
+        if (live[slot] != NULL) {
+            *(volatile char *)live[slot] = (char)i;
+        }
+    }
+    for (int i = 0; i < LIVE_SLOTS; i++) {
+        __wrap_free(live[i]);
+    }
+    return NULL;
+}
+
+static void bench(Mode mode, int threads, int iterations)
+{
+    pthread_t tids[MAX_THREADS];
+    WorkerArgs args[MAX_THREADS];
+
+    int64_t start = nowNs();
+    for (int i = 0; i < threads; i++) {
+        args[i].seed = 0x9E3779B9u * (uint32_t)(i + 1);
+        args[i].iterations = iterations;
+        pthread_create(&tids[i], NULL, worker, &args[i]);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    int64_t elapsed = nowNs() - start;
+    printf("%-8s %d threads: %7.1f ns per malloc+free\n", kModeNames[mode],
+            threads, (double)elapsed / ((double)iterations * threads));
+}
+
+static __attribute__((noinline)) void *leakOne()
+{
+    return __wrap_malloc(LEAK_SIZE);
+}
+
+static void testSampledAccounting()
+{
+    hal_debug_memleak_stats_t stats;
+    void **leaks = (void **)malloc(LEAK_COUNT * sizeof(void *));
+
+    // Single callsite leaking a known amount
+    for (int i = 0; i < LEAK_COUNT; i++) {
+        leaks[i] = leakOne();
+    }
+    hal_debug_get_memleak_stats(&stats);
+    double expected = (double)LEAK_COUNT * LEAK_SIZE;
+    CHECK(stats.live_samples > 0);
+    CHECK(stats.callsites >= 1);
+    CHECK(stats.dropped == 0);
+    CHECK((double)stats.live_bytes > expected * 0.7);
+    CHECK((double)stats.live_bytes < expected * 1.3);
+    printf("leak of %.0f bytes estimated at %zu bytes from %zu samples\n",
+            expected, stats.live_bytes, stats.live_samples);
+
+    // A failed realloc leaves the block and its sample in place
+    volatile size_t hugeSize = SIZE_MAX / 2;
+    size_t liveSamples = stats.live_samples;
+    for (int i = 0; i < LEAK_COUNT; i++) {
+        CHECK(__wrap_realloc(leaks[i], hugeSize) == NULL);
+    }
+    hal_debug_get_memleak_stats(&stats);
+    CHECK(stats.live_samples == liveSamples);
+
+    // Growing through realloc must move samples, not lose or duplicate them
+    for (int i = 0; i < LEAK_COUNT; i += 2) {
+        leaks[i] = __wrap_realloc(leaks[i], LEAK_SIZE * 2);
+    }
+    // realloc to zero bytes frees the block and forgets its sample
+    for (int i = 1; i < LEAK_COUNT; i += 2) {
+        CHECK(__wrap_realloc(leaks[i], 0) == NULL);
+        leaks[i] = NULL;
+    }
+    for (int i = 0; i < LEAK_COUNT; i++) {
+        __wrap_free(leaks[i]);
+    }
+    hal_debug_get_memleak_stats(&stats);
+    CHECK(stats.live_samples == 0);
+    CHECK(stats.live_bytes == 0);
+    free(leaks);
+}
+
+static int runMode(Mode mode, int iterations)
+{
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (mode == MODE_FULL) {
+            hal_debug_enable_memleak_trace();
+        } else if (mode == MODE_SAMPLED) {
+            hal_debug_enable_memleak_sampling(0);
+            testSampledAccounting();
+        }
+        for (int threads = 1; threads <= MAX_THREADS; threads *= 4) {
+            bench(mode, threads, iterations);
+        }
+        if (mode == MODE_SAMPLED) {
+            hal_debug_memleak_stats_t stats;
+            hal_debug_get_memleak_stats(&stats);
+            CHECK(stats.live_samples == 0);
+            printf("sampled  %zu samples at %zu callsites, %zu dropped\n",
+                    stats.sampled_allocs, stats.callsites, stats.dropped);
+        }
+        fflush(stdout);
+        // Skip the tracker's exit dump
+        _exit(gFailures ? 1 : 0);
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) {
+        return 1;
+    }
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = (argc > 1) ? atoi(argv[1]) : 200000;
+
+    if (iterations <= 0) {
+        printf("usage: %s [iterations per thread]\n", argv[0]);
+        return -1;
+    }
+    fflush(stdout);
+    for (int mode = MODE_OFF; mode <= MODE_SAMPLED; mode++) {
+        if (runMode((Mode)mode, iterations)) {
+            printf("%s mode failed\n", kModeNames[mode]);
+            TEST_FAIL();
+        }
+    }
+
+    return testResult("qcamera_memleak_bench");
+}
@@ -0,0 +1,422 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Drives QCameraMemoryPool through allocate/release sequences taken from
+// HAL1 stream configurations, on top of a mock allocator that tracks every
+// buffer handed out by the backing allocator.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utils/Errors.h>
+
+#include "QCameraMem.h"
+#include "qcamera_test_check.h"
+
+using namespace android;
+using namespace qcamera;
+
+#define MAX_TEST_BUFS 64
+#define ALIGN_4K(x)   (((x) + 4095U) & (~4095U))
+#define ALIGN_64(x)   (((x) + 63U) & (~63U))
+#define MB            (1024U * 1024U)
+
+namespace qcamera {
+// The pool's default ION backend is never reached through MockPool
+int QCameraMemory::allocOneBuffer(QCameraMemInfo & /*memInfo*/,
+        unsigned int /*heap_id*/, size_t /*size*/, bool /*cached*/,
+        bool /*secure_mode*/)
+{
+    return NO_MEMORY;
+}
+
+void QCameraMemory::deallocOneBuffer(QCameraMemInfo & /*memInfo*/)
+{
+}
+}; //namespace qcamera
+
+class MockPool : public QCameraMemoryPool {
+public:
+    MockPool() : mNextFd(100), mLive(0), mLiveBytes(0), mAllocs(0),
+            mFrees(0), mFailAllocs(false)
+    {
+        // Start from known limits regardless of device properties
+        setBudget(0, 0);
+        setMaxWaste(25);
+    }
+    virtual ~MockPool()
+    {
+        clear();
+        if (mLive != 0) {
+            printf("%d buffers leaked\n", mLive);
+            TEST_FAIL();
+        }
+    }
+
+    int mNextFd;
+    int mLive;
+    size_t mLiveBytes;
+    int mAllocs;
+    int mFrees;
+    bool mFailAllocs;
+
+protected:
+    virtual int allocOne(MemInfo &memInfo, unsigned int heap_id,
+            size_t size, bool cached, bool /*is_secure*/)
+    {
+        if (mFailAllocs) {
+            return NO_MEMORY;
+        }
+        memset(&memInfo, 0, sizeof(memInfo));
+        memInfo.fd = mNextFd++;
+        memInfo.main_ion_fd = -1;
+        memInfo.size = ALIGN_4K(size);
+        memInfo.cached = cached;
+        memInfo.heap_id = heap_id;
+        mLive++;
+        mLiveBytes += memInfo.size;
+        mAllocs++;
+        return NO_ERROR;
+    }
+    virtual void freeOne(MemInfo &memInfo)
+    {
+        mLive--;
+        mLiveBytes -= memInfo.size;
+        mFrees++;
+    }
+};
+
+typedef struct {
+    cam_stream_type_t type;
+    int width;
+    int height;
+    uint8_t count;
+} stream_cfg_t;
+
+typedef struct {
+    const char *name;
+    stream_cfg_t streams[4];
+    int num_streams;
+} usecase_cfg_t;
+
+// Pool backed streams of the HAL1 use cases, sizes as configured by the
+// app and buffer counts as requested by QCameraParameters
+static const usecase_cfg_t kZsl12MP = {
+    "ZSL 12MP", {
+        { CAM_STREAM_TYPE_SNAPSHOT, 4000, 3000, 7 },
+        { CAM_STREAM_TYPE_ANALYSIS, 640, 480, 4 },
+        { CAM_STREAM_TYPE_CALLBACK, 1920, 1080, 6 },
+    }, 3
+};
+static const usecase_cfg_t kZsl8MP = {
+    "ZSL 8MP", {
+        { CAM_STREAM_TYPE_SNAPSHOT, 3264, 2448, 7 },
+        { CAM_STREAM_TYPE_ANALYSIS, 640, 480, 4 },
+        { CAM_STREAM_TYPE_CALLBACK, 1920, 1080, 6 },
+    }, 3
+};
+static const usecase_cfg_t kRawDump = {
+    "Raw dump 12MP", {
+        { CAM_STREAM_TYPE_RAW, 4000, 3000, 5 },
+        { CAM_STREAM_TYPE_ANALYSIS, 640, 480, 4 },
+    }, 2
+};
+
+// NV21 frame length with 64 pixel stride/scanline padding, the way
+// mm_stream_calc_offset_* lays out YUV420 semi planar frames
+static size_t frameLen(const stream_cfg_t &cfg)
+{
+    size_t y;
+
+    if (cfg.type == CAM_STREAM_TYPE_RAW) {
+        // 10 bit packed MIPI raw
+        return (size_t)ALIGN_64((uint32_t)cfg.width * 5 / 4) * cfg.height;
+    }
+    y = (size_t)ALIGN_64((uint32_t)cfg.width) * ALIGN_64((uint32_t)cfg.height);
+    return y + y / 2;
+}
+
+static unsigned int kHeap = 0x1 << 2;
+
+typedef struct {
+    QCameraMemoryPool::MemInfo bufs[MAX_TEST_BUFS];
+    cam_stream_type_t types[MAX_TEST_BUFS];
+    int count;
+} held_bufs_t;
+
+static int startUsecase(MockPool &pool, const usecase_cfg_t &uc,
+        held_bufs_t &held)
+{
+    held.count = 0;
+    for (int s = 0; s < uc.num_streams; s++) {
+        const stream_cfg_t &cfg = uc.streams[s];
+        for (int i = 0; i < cfg.count; i++) {
+            int rc = pool.allocateBuffer(held.bufs[held.count], kHeap,
+                    frameLen(cfg), true, cfg.type, false);
+            if (rc != NO_ERROR) {
+                return rc;
+            }
+            held.types[held.count++] = cfg.type;
+        }
+    }
+    return NO_ERROR;
+}
+
+static void stopUsecase(MockPool &pool, held_bufs_t &held)
+{
+    for (int i = 0; i < held.count; i++) {
+        pool.releaseBuffer(held.bufs[i], held.types[i]);
+    }
+    held.count = 0;
+}
+
+static void prewarmUsecase(MockPool &pool, const usecase_cfg_t &uc)
+{
+    for (int s = 0; s < uc.num_streams; s++) {
+        const stream_cfg_t &cfg = uc.streams[s];
+        CHECK(pool.prewarm(cfg.type, kHeap, frameLen(cfg), true, cfg.count)
+                == NO_ERROR);
+    }
+}
+
+static int usecaseBufs(const usecase_cfg_t &uc)
+{
+    int n = 0;
+    for (int s = 0; s < uc.num_streams; s++) {
+        n += uc.streams[s].count;
+    }
+    return n;
+}
+
+// Stopping and restarting the same configuration must not allocate
+static void testRestart()
+{
+    MockPool pool;
+    held_bufs_t held;
+    QCameraMemPoolStats stats;
+    int n = usecaseBufs(kZsl12MP);
+
+    CHECK(startUsecase(pool, kZsl12MP, held) == NO_ERROR);
+    CHECK(pool.mAllocs == n);
+    stopUsecase(pool, held);
+    CHECK(pool.mLive == n);
+
+    CHECK(startUsecase(pool, kZsl12MP, held) == NO_ERROR);
+    CHECK(pool.mAllocs == n);
+    pool.getStats(CAM_STREAM_TYPE_MAX, stats);
+    CHECK(stats.hits == (uint32_t)n);
+    CHECK(stats.misses == (uint32_t)n);
+    CHECK(stats.wasted_bytes == 0);
+    CHECK(stats.idle_bufs == 0);
+    stopUsecase(pool, held);
+}
+
+// A smaller snapshot must get the closest buffer, not the first one parked
+static void testBestFit()
+{
+    MockPool pool;
+    QCameraMemoryPool::MemInfo big, mid, small, got;
+    size_t len12 = frameLen(kZsl12MP.streams[0]);
+    size_t len8 = frameLen(kZsl8MP.streams[0]);
+    size_t len1080 = frameLen(kZsl12MP.streams[2]);
+    QCameraMemPoolStats stats;
+
+    CHECK(pool.allocateBuffer(big, kHeap, len12, true,
+            CAM_STREAM_TYPE_SNAPSHOT, false) == NO_ERROR);
+    CHECK(pool.allocateBuffer(mid, kHeap, len8, true,
+            CAM_STREAM_TYPE_SNAPSHOT, false) == NO_ERROR);
+    CHECK(pool.allocateBuffer(small, kHeap, len1080, true,
+            CAM_STREAM_TYPE_SNAPSHOT, false) == NO_ERROR);
+    pool.releaseBuffer(big, CAM_STREAM_TYPE_SNAPSHOT);
+    pool.releaseBuffer(small, CAM_STREAM_TYPE_SNAPSHOT);
+    pool.releaseBuffer(mid, CAM_STREAM_TYPE_SNAPSHOT);
+
+    // 8MP request: the 12MP buffer was parked first but 8MP fits best
+    CHECK(pool.allocateBuffer(got, kHeap, len8, true,
+            CAM_STREAM_TYPE_SNAPSHOT, false) == NO_ERROR);
+    CHECK(got.fd == mid.fd);
+    pool.releaseBuffer(got, CAM_STREAM_TYPE_SNAPSHOT);
+
+    // 1080p sized request in between: only the exact 1080p buffer fits
+    CHECK(pool.allocateBuffer(got, kHeap, len1080 - 8192, true,
+            CAM_STREAM_TYPE_SNAPSHOT, false) == NO_ERROR);
+    CHECK(got.fd == small.fd);
+
+    // Nothing within the slack: a 1080p request must not pin 12MP
+    CHECK(pool.allocateBuffer(small, kHeap, len1080, true,
+            CAM_STREAM_TYPE_SNAPSHOT, false) == NO_ERROR);
+    CHECK(small.fd != big.fd && small.fd != mid.fd);
+    CHECK(small.size == ALIGN_4K(len1080));
+
+    // Heap and cache attributes have to match
+    CHECK(pool.allocateBuffer(mid, kHeap, len8, false,
+            CAM_STREAM_TYPE_SNAPSHOT, false) == NO_ERROR);
+    CHECK(mid.size == ALIGN_4K(len8) && !mid.cached);
+
+    pool.getStats(CAM_STREAM_TYPE_SNAPSHOT, stats);
+    CHECK(stats.hits == 2);
+    CHECK(stats.misses == 5);
+    CHECK(stats.wasted_bytes == ALIGN_4K(len1080) - ALIGN_4K(len1080 - 8192));
+    CHECK(stats.idle_bufs == 2);
+
+    pool.releaseBuffer(got, CAM_STREAM_TYPE_SNAPSHOT);
+    pool.releaseBuffer(small, CAM_STREAM_TYPE_SNAPSHOT);
+    pool.releaseBuffer(mid, CAM_STREAM_TYPE_SNAPSHOT);
+}
+
+// Offline reprocess buffers are only reused at the exact size
+static void testOfflineExact()
+{
+    MockPool pool;
+    QCameraMemoryPool::MemInfo buf, got;
+    size_t len = frameLen(kZsl12MP.streams[0]);
+
+    CHECK(pool.allocateBuffer(buf, kHeap, len, true,
+            CAM_STREAM_TYPE_OFFLINE_PROC, false) == NO_ERROR);
+    pool.releaseBuffer(buf, CAM_STREAM_TYPE_OFFLINE_PROC);
+    CHECK(pool.allocateBuffer(got, kHeap, len - 16384, true,
+            CAM_STREAM_TYPE_OFFLINE_PROC, false) == NO_ERROR);
+    CHECK(got.fd != buf.fd);
+    pool.releaseBuffer(got, CAM_STREAM_TYPE_OFFLINE_PROC);
+    CHECK(pool.allocateBuffer(got, kHeap, len, true,
+            CAM_STREAM_TYPE_OFFLINE_PROC, false) == NO_ERROR);
+    CHECK(got.fd == buf.fd);
+    pool.releaseBuffer(got, CAM_STREAM_TYPE_OFFLINE_PROC);
+}
+
+// Switching picture size leaves the old buffers to the LRU trimming
+static void testBudgetLRU()
+{
+    MockPool pool;
+    held_bufs_t held;
+    QCameraMemPoolStats stats;
+    size_t len12 = ALIGN_4K(frameLen(kZsl12MP.streams[0]));
+    size_t len8 = ALIGN_4K(frameLen(kZsl8MP.streams[0]));
+    size_t streamBudget = 7 * len12;
+
+    pool.setBudget(0, streamBudget);
+
+    CHECK(startUsecase(pool, kZsl12MP, held) == NO_ERROR);
+    stopUsecase(pool, held);
+    pool.getStats(CAM_STREAM_TYPE_SNAPSHOT, stats);
+    CHECK(stats.idle_bufs == 7);
+    CHECK(stats.idle_bytes == 7 * len12);
+
+    // 8MP snapshot is too far from 12MP to reuse it
+    CHECK(startUsecase(pool, kZsl8MP, held) == NO_ERROR);
+    pool.getStats(CAM_STREAM_TYPE_SNAPSHOT, stats);
+    CHECK(stats.hits == 0);
+    CHECK(stats.misses == 14);
+    stopUsecase(pool, held);
+
+    // 8MP buffers released last survive, 12MP ones are trimmed first
+    pool.getStats(CAM_STREAM_TYPE_SNAPSHOT, stats);
+    CHECK(stats.idle_bytes <= streamBudget);
+    CHECK(stats.trimmed == 5);
+    CHECK(stats.idle_bytes == 2 * len12 + 7 * len8);
+    CHECK(startUsecase(pool, kZsl8MP, held) == NO_ERROR);
+    pool.getStats(CAM_STREAM_TYPE_SNAPSHOT, stats);
+    CHECK(stats.hits == 7);
+    stopUsecase(pool, held);
+
+    // Global budget trims across stream types, least recently released
+    // first: snapshot buffers go before the later released streams
+    size_t keep = 0;
+    pool.getStats(CAM_STREAM_TYPE_ANALYSIS, stats);
+    keep += stats.idle_bytes;
+    pool.getStats(CAM_STREAM_TYPE_CALLBACK, stats);
+    keep += stats.idle_bytes;
+    CHECK(stats.idle_bufs == 6);
+    pool.setBudget(keep, streamBudget);
+    pool.getStats(CAM_STREAM_TYPE_MAX, stats);
+    CHECK(stats.idle_bytes == keep);
+    CHECK(stats.idle_bytes == pool.mLiveBytes);
+    pool.getStats(CAM_STREAM_TYPE_SNAPSHOT, stats);
+    CHECK(stats.idle_bufs == 0);
+    pool.getStats(CAM_STREAM_TYPE_CALLBACK, stats);
+    CHECK(stats.idle_bufs == 6);
+}
+
+// Prewarm fills the pool once, so stream start only hits
+static void testPrewarm()
+{
+    MockPool pool;
+    held_bufs_t held;
+    QCameraMemPoolStats stats;
+    int n = usecaseBufs(kRawDump);
+
+    prewarmUsecase(pool, kRawDump);
+    prewarmUsecase(pool, kRawDump);
+    CHECK(pool.mAllocs == n);
+    CHECK(startUsecase(pool, kRawDump, held) == NO_ERROR);
+    CHECK(pool.mAllocs == n);
+    pool.getStats(CAM_STREAM_TYPE_MAX, stats);
+    CHECK(stats.prewarmed == (uint32_t)n);
+    CHECK(stats.hits == (uint32_t)n);
+    CHECK(stats.misses == 0);
+    stopUsecase(pool, held);
+
+    // Prewarm stops at the budget instead of evicting
+    pool.clear();
+    pool.setBudget(0, 3 * ALIGN_4K(frameLen(kRawDump.streams[0])));
+    prewarmUsecase(pool, kRawDump);
+    pool.getStats(CAM_STREAM_TYPE_RAW, stats);
+    CHECK(stats.idle_bufs == 3);
+    CHECK(stats.trimmed == 0);
+
+    // Allocation failures surface to the caller
+    pool.mFailAllocs = true;
+    CHECK(pool.prewarm(CAM_STREAM_TYPE_CALLBACK, kHeap, 4096, true, 2)
+            == NO_MEMORY);
+    CHECK(startUsecase(pool, kZsl12MP, held) == NO_MEMORY);
+    stopUsecase(pool, held);
+    pool.mFailAllocs = false;
+}
+
+int main()
+{
+    MockPool *pool = new MockPool();
+    String8 dump;
+
+    testRestart();
+    testBestFit();
+    testOfflineExact();
+    testBudgetLRU();
+    testPrewarm();
+
+    // Dump keeps working on a populated pool and clear() frees everything
+    prewarmUsecase(*pool, kZsl12MP);
+    dump = pool->dump();
+    printf("%s", dump.string());
+    pool->clear();
+    CHECK(pool->mLive == 0);
+    delete pool;
+
+    return testResult("qcamera_mempool_test");
+}
@@ -0,0 +1,271 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Replays a captured HAL1 app parameter stream against the key lists
+// QCameraParameters::updateParameters uses to skip setPreviewSize,
+// setPictureSize and setPreviewFpsRange while their keys are unchanged, and
+// checks which of them run at every step. The other setters compare their
+// own key against the current map already and always run.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "QCameraParameters.h"
+#include "qcamera_test_check.h"
+
+using namespace android;
+using namespace qcamera;
+
+// Setters gated by a key list, as bits of StreamStep::expectedRun
+#define RUN_PREVIEW_SIZE      (1 << 0)
+#define RUN_PICTURE_SIZE      (1 << 1)
+#define RUN_PREVIEW_FPS_RANGE (1 << 2)
+
+typedef struct {
+    const char *name;
+    const char *const *keys;
+    int bit;
+} GatedSetter;
+
+static const GatedSetter kSetters[] = {
+    { "setPreviewSize", QCameraParameters::PREVIEW_SIZE_UPDATE_KEYS,
+            RUN_PREVIEW_SIZE },
+    { "setPictureSize", QCameraParameters::PICTURE_SIZE_UPDATE_KEYS,
+            RUN_PICTURE_SIZE },
+    { "setPreviewFpsRange", QCameraParameters::PREVIEW_FPS_RANGE_UPDATE_KEYS,
+            RUN_PREVIEW_FPS_RANGE },
+};
+
+// Default parameters the HAL starts from and hands to the app
+static const char kInitialParams[] =
+    "preview-size=640x480;video-size=640x480;jpeg-quality=85;"
+    "jpeg-thumbnail-quality=85;focus-mode=continuous-picture;"
+    "recording-hint=false;zoom=0;picture-size=4000x3000;"
+    "preview-format=yuv420sp;preview-fps-range=7500,30000;"
+    "preview-frame-rate=30;video-hfr=off;video-hsr=off;antibanding=auto;"
+    "whitebalance=auto;effect=none;scene-mode=auto;flash-mode=off";
+
+typedef struct {
+    const char *name;
+    const char *set;        // "key=value;..." the app changed in this step
+    const char *removed;    // key the app removed in this step, or NULL
+    int expectedRun;        // RUN_* bits of the setters that must run
+} StreamStep;
+
+// Captured from an app going through preview start, pinch zoom, tap to
+// focus, recording with a preview size change, HFR, a burst of GPS fixes
+// and a picture size change.
+static const StreamStep kStream[] = {
+    { "preview start", "preview-size=1440x1080;video-size=1920x1080", NULL,
+            RUN_PREVIEW_SIZE },
+    { "resend", "", NULL, 0 },
+    { "zoom 1", "zoom=4", NULL, 0 },
+    { "zoom 2", "zoom=9", NULL, 0 },
+    { "zoom 3", "zoom=15", NULL, 0 },
+    { "touch af", "focus-mode=auto;focus-areas=(-100,-100,100,100,1000)",
+            NULL, 0 },
+    { "touch af move", "focus-areas=(200,-50,400,150,1000)", NULL, 0 },
+    { "touch af done", "focus-mode=continuous-picture;"
+            "focus-areas=(0,0,0,0,0)", NULL, 0 },
+    { "recording hint", "recording-hint=true", NULL, 0 },
+    { "record size", "preview-size=1920x1080;video-size=3840x2160", NULL,
+            RUN_PREVIEW_SIZE },
+    { "record fps", "preview-fps-range=30000,30000", NULL,
+            RUN_PREVIEW_FPS_RANGE },
+    { "hfr on", "video-hfr=120", NULL, RUN_PREVIEW_FPS_RANGE },
+    { "hfr to hsr", "video-hfr=off;video-hsr=120", NULL,
+            RUN_PREVIEW_FPS_RANGE },
+    { "hsr off", "video-hsr=off", NULL, RUN_PREVIEW_FPS_RANGE },
+    { "gps fix 1", "gps-latitude=37.42;gps-longitude=-122.08;"
+            "gps-altitude=30;gps-altitude-ref=0;gps-timestamp=1600000000",
+            NULL, 0 },
+    { "gps fix 2", "gps-latitude=37.43;gps-timestamp=1600000001", NULL, 0 },
+    { "gps resend", "", NULL, 0 },
+    { "quality", "jpeg-quality=95;jpeg-thumbnail-quality=90;zoom=0", NULL,
+            0 },
+    { "gps lost", "", "gps-latitude", 0 },
+    { "snapshot size", "picture-size=1920x1080", NULL, RUN_PICTURE_SIZE },
+    { "recording stop", "recording-hint=false;preview-size=1440x1080;"
+            "preview-fps-range=7500,30000;picture-size=4000x3000", NULL,
+            RUN_PREVIEW_SIZE | RUN_PICTURE_SIZE | RUN_PREVIEW_FPS_RANGE },
+    { "fps dropped", "", "preview-fps-range", RUN_PREVIEW_FPS_RANGE },
+};
+
+// Applies "key=value;..." to params the way an app edits getParameters()
+static void applyStep(CameraParameters &params, const StreamStep &step)
+{
+    char buf[256];
+    char *saveptr = NULL;
+
+    snprintf(buf, sizeof(buf), "%s", step.set);
+    for (char *tok = strtok_r(buf, ";", &saveptr); tok != NULL;
+            tok = strtok_r(NULL, ";", &saveptr)) {
+        char *eq = strchr(tok, '=');
+        if (eq != NULL) {
+            *eq = '\0';
+            params.set(tok, eq + 1);
+        }
+    }
+    if (step.removed != NULL) {
+        params.remove(step.removed);
+    }
+}
+
+static int gatedRun(const CameraParameters &current,
+        const CameraParameters &params)
+{
+    int run = 0;
+
+    for (size_t i = 0; i < sizeof(kSetters) / sizeof(kSetters[0]); i++) {
+        if (QCameraParameters::isParamChanged(current, params,
+                kSetters[i].keys)) {
+            run |= kSetters[i].bit;
+        }
+    }
+    return run;
+}
+
+static bool hasKey(const char *const *keys, const char *key)
+{
+    for (size_t i = 0; keys[i] != NULL; i++) {
+        if (!strcmp(keys[i], key)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void testIsParamChanged()
+{
+    static const char *const keys[] = { "a", "b", NULL };
+    CameraParameters a, b;
+
+    a.set("a", "1");
+    a.set("b", "2");
+    b.set("a", "1");
+    b.set("b", "2");
+    b.set("c", "3");
+    // keys outside the list do not count
+    CHECK(!QCameraParameters::isParamChanged(a, b, keys));
+    b.set("b", "4");
+    CHECK(QCameraParameters::isParamChanged(a, b, keys));
+    b.set("b", "2");
+    b.remove("a");
+    CHECK(QCameraParameters::isParamChanged(a, b, keys));
+    CHECK(QCameraParameters::isParamChanged(b, a, keys));
+}
+
+static void testKeyLists()
+{
+    // every key the gated setters read from the user setting parameters,
+    // directly or through UpdateHFRFrameRate
+    CHECK(hasKey(QCameraParameters::PREVIEW_SIZE_UPDATE_KEYS,
+            CameraParameters::KEY_PREVIEW_SIZE));
+    CHECK(hasKey(QCameraParameters::PICTURE_SIZE_UPDATE_KEYS,
+            CameraParameters::KEY_PICTURE_SIZE));
+    CHECK(hasKey(QCameraParameters::PREVIEW_FPS_RANGE_UPDATE_KEYS,
+            CameraParameters::KEY_PREVIEW_FPS_RANGE));
+    CHECK(hasKey(QCameraParameters::PREVIEW_FPS_RANGE_UPDATE_KEYS,
+            "video-hfr"));
+    CHECK(hasKey(QCameraParameters::PREVIEW_FPS_RANGE_UPDATE_KEYS,
+            "video-hsr"));
+}
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void testReplay()
+{
+    CameraParameters current;
+    CameraParameters app;
+    int runs = 0, calls = 0;
+
+    current.unflatten(String8(kInitialParams));
+    app.unflatten(String8(kInitialParams));
+    for (size_t i = 0; i < sizeof(kStream) / sizeof(kStream[0]); i++) {
+        const StreamStep &step = kStream[i];
+
+        applyStep(app, step);
+        int run = gatedRun(current, app);
+        if (run != step.expectedRun) {
+            printf("%s: setters 0x%x run, expected 0x%x\n", step.name, run,
+                    step.expectedRun);
+            TEST_FAIL();
+        }
+        for (size_t s = 0; s < sizeof(kSetters) / sizeof(kSetters[0]); s++) {
+            runs += (run & kSetters[s].bit) ? 1 : 0;
+            calls++;
+        }
+        // all values of the stream are valid, the HAL stores them as is
+        current.unflatten(app.flatten());
+    }
+    printf("replayed %zu steps: %d of %d gated setter calls run\n",
+            sizeof(kStream) / sizeof(kStream[0]), runs, calls);
+}
+
+static void benchGate(int replays)
+{
+    CameraParameters current;
+    CameraParameters app;
+    volatile int sink = 0;
+
+    current.unflatten(String8(kInitialParams));
+    app.unflatten(String8(kInitialParams));
+    app.set(CameraParameters::KEY_ZOOM, "10");
+
+    uint64_t start = nowNs();
+    for (int r = 0; r < replays; r++) {
+        sink += gatedRun(current, app);
+    }
+    printf("key list checks: %llu ns per update\n",
+            (unsigned long long)((nowNs() - start) / replays));
+}
+
+int main(int argc, char **argv)
+{
+    int replays = (argc > 1) ? atoi(argv[1]) : 100000;
+
+    if (replays <= 0) {
+        printf("usage: %s [replays]\n", argv[0]);
+        return -1;
+    }
+    testIsParamChanged();
+    testKeyLists();
+    testReplay();
+    benchGate(replays);
+
+    return testResult("qcamera_paramdiff_test");
+}
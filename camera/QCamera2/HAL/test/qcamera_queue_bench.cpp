@@ -0,0 +1,431 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Checks the ring backed QCameraQueue, QCameraIntrusiveQueue and the
+// QCameraCmdThread command pool, then compares the ring against the old
+// malloc-per-node list with several producers feeding one consumer, the
+// way stream callbacks feed a data-proc thread. Each producer has a fixed
+// number of items in flight, like a stream's buffers. Reports ops/sec and
+// the enqueue to dequeue latency distribution.
+
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "cam_semaphore.h"
+#include "QCameraCmdThread.h"
+#include "QCameraQueue.h"
+#include "qcamera_test_check.h"
+
+using namespace qcamera;
+
+#define MAX_PRODUCERS 4
+#define PRODUCER_CREDITS 8   // like a stream's buffer count
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// The list based queue QCameraQueue used before, one malloc per element
+class LegacyQueue {
+public:
+    LegacyQueue() : m_size(0)
+    {
+        pthread_mutex_init(&m_lock, NULL);
+        cam_list_init(&m_head.list);
+    }
+    ~LegacyQueue() { pthread_mutex_destroy(&m_lock); }
+    bool enqueue(void *data)
+    {
+        node_t *node = (node_t *)malloc(sizeof(node_t));
+        if (node == NULL) {
+            return false;
+        }
+        memset(node, 0, sizeof(node_t));
+        node->data = data;
+        pthread_mutex_lock(&m_lock);
+        cam_list_add_tail_node(&node->list, &m_head.list);
+        m_size++;
+        pthread_mutex_unlock(&m_lock);
+        return true;
+    }
+    void *dequeue()
+    {
+        node_t *node = NULL;
+        void *data = NULL;
+        pthread_mutex_lock(&m_lock);
+        struct cam_list *pos = m_head.list.next;
+        if (pos != &m_head.list) {
+            node = member_of(pos, node_t, list);
+            cam_list_del_node(&node->list);
+            m_size--;
+        }
+        pthread_mutex_unlock(&m_lock);
+        if (node != NULL) {
+            data = node->data;
+            free(node);
+        }
+        return data;
+    }
+private:
+    typedef struct {
+        struct cam_list list;
+        void *data;
+    } node_t;
+    node_t m_head;
+    int m_size;
+    pthread_mutex_t m_lock;
+};
+
+typedef struct {
+    int id;
+    int releases;
+} Item;
+
+static bool matchId(void *data, void *, void *match_data)
+{
+    return ((Item *)data)->id == *(int *)match_data;
+}
+
+static bool matchOdd(void *data, void *)
+{
+    return (((Item *)data)->id & 1) != 0;
+}
+
+static void countRelease(void *data, void *)
+{
+    ((Item *)data)->releases++;
+}
+
+static void testRingQueue()
+{
+    QCameraQueue queue;
+    const int count = 3 * QCAMERA_QUEUE_DEFAULT_CAPACITY + 5;
+    std::vector<Item *> items;
+
+    for (int i = 0; i < count; i++) {
+        Item *item = (Item *)calloc(1, sizeof(Item));
+        item->id = i;
+        items.push_back(item);
+    }
+
+    // Wrap the ring before it has to grow, growth must keep the order
+    for (int i = 0; i < 10; i++) {
+        CHECK(queue.enqueue(items[i]));
+    }
+    for (int i = 0; i < 10; i++) {
+        CHECK(queue.dequeue() == items[i]);
+    }
+    CHECK(queue.isEmpty());
+    for (int i = 0; i < count; i++) {
+        CHECK(queue.enqueue(items[i]));
+    }
+    CHECK(queue.getCurrentSize() == count);
+    CHECK(queue.getCapacity() >= (uint32_t)count);
+    for (int i = 0; i < count; i++) {
+        CHECK(queue.dequeue() == items[i]);
+    }
+    CHECK(queue.dequeue() == NULL);
+
+    // Priority lane goes to the head, tail dequeue takes the newest
+    queue.enqueue(items[1]);
+    queue.enqueue(items[2]);
+    queue.enqueueWithPriority(items[0]);
+    CHECK(queue.peek() == items[0]);
+    CHECK(queue.dequeue(false) == items[2]);
+    CHECK(queue.dequeue() == items[0]);
+    CHECK(queue.dequeue() == items[1]);
+
+    // Match dequeue removes from the middle and keeps the rest in order
+    for (int i = 0; i < 6; i++) {
+        queue.enqueue(items[i]);
+    }
+    int id = 3;
+    CHECK(queue.dequeue(matchId, &id) == items[3]);
+    id = 42;
+    CHECK(queue.dequeue(matchId, &id) == NULL);
+    CHECK(queue.getCurrentSize() == 5);
+    CHECK(queue.dequeue() == items[0]);
+    CHECK(queue.dequeue() == items[1]);
+    CHECK(queue.dequeue() == items[2]);
+    CHECK(queue.dequeue() == items[4]);
+    CHECK(queue.dequeue() == items[5]);
+
+    for (int i = 0; i < count; i++) {
+        free(items[i]);
+    }
+}
+
+static void testRingFlush()
+{
+    QCameraQueue queue(countRelease, NULL);
+    Item stack[8];
+    memset(stack, 0, sizeof(stack));
+
+    // flushNodes hands matches to the release fn and frees them
+    for (int i = 0; i < 8; i++) {
+        Item *item = (Item *)calloc(1, sizeof(Item));
+        item->id = i;
+        queue.enqueue(item);
+    }
+    queue.flushNodes(matchOdd);
+    CHECK(queue.getCurrentSize() == 4);
+    int id = 4;
+    queue.flushNodes(matchId, &id);
+    CHECK(queue.getCurrentSize() == 3);
+    for (int i = 0; i < 3; i++) {
+        Item *item = (Item *)queue.dequeue();
+        CHECK(item != NULL && item->id == 2 * (i == 2 ? 3 : i));
+        free(item);
+    }
+
+    // flush deactivates the queue until init()
+    queue.enqueue(calloc(1, sizeof(Item)));
+    queue.enqueue(NULL);
+    queue.flush();
+    CHECK(queue.isEmpty());
+    CHECK(!queue.enqueue(&stack[0]));
+    queue.init();
+    CHECK(queue.enqueue(&stack[0]));
+    CHECK(queue.dequeue() == &stack[0]);
+}
+
+typedef struct {
+    struct cam_list list;
+    int id;
+} Node;
+
+static bool matchNode(struct cam_list *node, void *match_data)
+{
+    return member_of(node, Node, list)->id == *(int *)match_data;
+}
+
+static void countNode(struct cam_list *node, void *user_data)
+{
+    (void)node;
+    (*(int *)user_data)++;
+}
+
+static void testIntrusiveQueue()
+{
+    int released = 0;
+    QCameraIntrusiveQueue queue(countNode, &released);
+    Node nodes[5];
+
+    for (int i = 0; i < 5; i++) {
+        nodes[i].id = i;
+    }
+    queue.enqueue(&nodes[1].list);
+    queue.enqueue(&nodes[2].list);
+    queue.enqueue(&nodes[3].list);
+    queue.enqueueWithPriority(&nodes[0].list);
+    queue.enqueue(&nodes[4].list);
+    CHECK(queue.getCurrentSize() == 5);
+    int id = 2;
+    CHECK(queue.dequeue(matchNode, &id) == &nodes[2].list);
+    CHECK(queue.dequeue() == &nodes[0].list);
+    CHECK(queue.dequeue(false) == &nodes[4].list);
+    id = 3;
+    queue.flushNodes(matchNode, &id);
+    CHECK(released == 1);
+    CHECK(queue.getCurrentSize() == 1);
+    queue.flush();
+    CHECK(released == 2);
+    CHECK(!queue.enqueue(&nodes[0].list));
+    queue.init();
+    CHECK(queue.enqueue(&nodes[0].list));
+    CHECK(queue.dequeue() == &nodes[0].list);
+}
+
+static void testCmdThread()
+{
+    QCameraCmdThread thread;
+    const int count = CAMERA_CMD_POOL_SIZE + 8;
+    uint8_t sync = 1;
+
+    // More commands than the pool holds, the rest come from the heap
+    for (int i = 0; i < count; i++) {
+        CHECK(thread.sendCmd(CAMERA_CMD_TYPE_DO_NEXT_JOB, 0, 0) == 0);
+    }
+    CHECK(thread.sendCmd(CAMERA_CMD_TYPE_STOP_DATA_PROC, 0, 1) == 0);
+    CHECK(thread.getCmd(sync) == CAMERA_CMD_TYPE_STOP_DATA_PROC);
+    CHECK(sync == 0);
+    for (int i = 0; i < count; i++) {
+        CHECK(thread.getCmd() == CAMERA_CMD_TYPE_DO_NEXT_JOB);
+    }
+    CHECK(thread.getCmd() == CAMERA_CMD_TYPE_NONE);
+
+    // Pending commands are dropped with the thread object
+    for (int i = 0; i < count; i++) {
+        thread.sendCmd(CAMERA_CMD_TYPE_DO_NEXT_JOB, 0, 0);
+    }
+}
+
+typedef struct {
+    uint64_t enqueueNs;
+    int producer;
+} BenchItem;
+
+template <class Q>
+struct BenchCtx {
+    Q *queue;
+    bool paced;
+    cam_semaphore_t sem;
+    int itemsPerProducer;
+    BenchItem *items[MAX_PRODUCERS];
+    cam_semaphore_t credits[MAX_PRODUCERS];
+    std::vector<uint64_t> latency;
+};
+
+template <class Q>
+struct ProducerArg {
+    BenchCtx<Q> *ctx;
+    int index;
+};
+
+template <class Q>
+static void *benchProducer(void *arg)
+{
+    ProducerArg<Q> *p = (ProducerArg<Q> *)arg;
+    BenchCtx<Q> *ctx = p->ctx;
+
+    for (int i = 0; i < ctx->itemsPerProducer; i++) {
+        BenchItem *item = &ctx->items[p->index][i];
+        if (ctx->paced) {
+            cam_sem_wait(&ctx->credits[p->index]);
+        }
+        item->producer = p->index;
+        item->enqueueNs = nowNs();
+        while (!ctx->queue->enqueue(item)) {
+        }
+        if (ctx->paced) {
+            cam_sem_post(&ctx->sem);
+        }
+    }
+    return NULL;
+}
+
+template <class Q>
+static void bench(const char *name, int producers, int itemsPerProducer,
+        bool paced)
+{
+    Q queue;
+    BenchCtx<Q> ctx;
+    ProducerArg<Q> args[MAX_PRODUCERS];
+    pthread_t threads[MAX_PRODUCERS];
+    int total = producers * itemsPerProducer;
+
+    ctx.queue = &queue;
+    ctx.paced = paced;
+    cam_sem_init(&ctx.sem, 0);
+    ctx.itemsPerProducer = itemsPerProducer;
+    ctx.latency.reserve(total);
+    for (int i = 0; i < producers; i++) {
+        ctx.items[i] = (BenchItem *)calloc(itemsPerProducer, sizeof(BenchItem));
+        cam_sem_init(&ctx.credits[i], PRODUCER_CREDITS);
+        args[i].ctx = &ctx;
+        args[i].index = i;
+    }
+
+    uint64_t start = nowNs();
+    for (int i = 0; i < producers; i++) {
+        pthread_create(&threads[i], NULL, benchProducer<Q>, &args[i]);
+    }
+    for (int i = 0; i < total; i++) {
+        BenchItem *item = NULL;
+        if (paced) {
+            cam_sem_wait(&ctx.sem);
+            item = (BenchItem *)queue.dequeue();
+            CHECK(item != NULL);
+        } else {
+            while ((item = (BenchItem *)queue.dequeue()) == NULL) {
+                sched_yield();
+            }
+        }
+        if (item != NULL) {
+            ctx.latency.push_back(nowNs() - item->enqueueNs);
+            cam_sem_post(&ctx.credits[item->producer]);
+        }
+    }
+    uint64_t elapsed = nowNs() - start;
+    for (int i = 0; i < producers; i++) {
+        pthread_join(threads[i], NULL);
+        cam_sem_destroy(&ctx.credits[i]);
+        free(ctx.items[i]);
+    }
+    cam_sem_destroy(&ctx.sem);
+
+    if (!paced) {
+        // Unpaced latency is only backlog, report raw queue throughput
+        printf("%-8s %d producers: %8.0f kops/s  unpaced\n", name, producers,
+                (double)total * 1e6 / (double)elapsed);
+        return;
+    }
+    std::sort(ctx.latency.begin(), ctx.latency.end());
+    size_t n = ctx.latency.size();
+    printf("%-8s %d producers: %8.0f kops/s  p50 %6.1f us  p99 %7.1f us  "
+            "p99.9 %7.1f us  max %8.1f us\n", name, producers,
+            (double)total * 1e6 / (double)elapsed,
+            ctx.latency[n / 2] / 1e3, ctx.latency[n * 99 / 100] / 1e3,
+            ctx.latency[n * 999 / 1000] / 1e3, ctx.latency[n - 1] / 1e3);
+}
+
+int main(int argc, char **argv)
+{
+    int items = (argc > 1) ? atoi(argv[1]) : 200000;
+
+    if (items <= 0) {
+        printf("usage: %s [items per producer]\n", argv[0]);
+        return -1;
+    }
+    testRingQueue();
+    testRingFlush();
+    testIntrusiveQueue();
+    testCmdThread();
+
+    for (int producers = 1; producers <= MAX_PRODUCERS; producers *= 2) {
+        bench<LegacyQueue>("list", producers, items, false);
+        bench<QCameraQueue>("ring", producers, items, false);
+    }
+    for (int producers = 1; producers <= MAX_PRODUCERS; producers *= 2) {
+        bench<LegacyQueue>("list", producers, items, true);
+        bench<QCameraQueue>("ring", producers, items, true);
+    }
+
+    return testResult("qcamera_queue_bench");
+}
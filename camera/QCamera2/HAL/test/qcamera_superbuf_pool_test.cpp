@@ -0,0 +1,355 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Exercises QCameraSuperBufPool the way the HAL data callbacks use it: a
+// simulated 60 fps preview with preview, video and metadata streams, each
+// copying its super buf into the pool and handing it to a consumer thread
+// through a QCameraQueue. Once the streams have reserved their buffer
+// counts the pool must serve every frame without touching the allocator.
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "QCameraQueue.h"
+#include "QCameraSuperBufPool.h"
+#include "qcamera_test_check.h"
+
+using namespace qcamera;
+
+#define NUM_STREAMS       3
+#define STREAM_NUM_BUFS   8
+#define FRAME_INTERVAL_US 16667
+#define STRESS_THREADS    4
+#define STRESS_ITERS      200000
+
+typedef struct {
+    uint32_t streamId;
+    uint32_t numFrames;
+    uint32_t interval;
+    mm_camera_buf_def_t bufs[STREAM_NUM_BUFS];
+    int inFlight;       // buffers held by the consumer, like a real stream
+    QCameraQueue *queue;
+} StreamSim;
+
+static QCameraSuperBufPool *pool()
+{
+    return QCameraSuperBufPool::getInstance();
+}
+
+// Mirrors QCameraStream::dataNotifyCB: copy the super buf and queue it
+static void *producer(void *arg)
+{
+    StreamSim *stream = (StreamSim *)arg;
+
+    for (uint32_t i = 0; i < stream->numFrames; i++) {
+        while (__atomic_load_n(&stream->inFlight, __ATOMIC_ACQUIRE) >=
+                STREAM_NUM_BUFS) {
+            usleep(100);
+        }
+        mm_camera_super_buf_t frame;
+        memset(&frame, 0, sizeof(frame));
+        frame.ch_id = stream->streamId;
+        frame.num_bufs = 1;
+        frame.bufs[0] = &stream->bufs[i % STREAM_NUM_BUFS];
+        frame.bufs[0]->frame_idx = i;
+
+        QCameraSuperBufHandle copy(pool()->copy(&frame));
+        CHECK(copy.isValid());
+        if (!copy.isValid()) {
+            continue;
+        }
+        __atomic_add_fetch(&stream->inFlight, 1, __ATOMIC_ACQ_REL);
+        if (stream->queue->enqueue(copy.get())) {
+            copy.detach();
+        } else {
+            __atomic_sub_fetch(&stream->inFlight, 1, __ATOMIC_ACQ_REL);
+        }
+        if (stream->interval) {
+            usleep(stream->interval);
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    StreamSim *streams;
+    QCameraQueue *queue;
+    uint32_t expected;
+    uint32_t received;
+} ConsumerArgs;
+
+static void *consumer(void *arg)
+{
+    ConsumerArgs *args = (ConsumerArgs *)arg;
+
+    while (args->received < args->expected) {
+        mm_camera_super_buf_t *frame =
+                (mm_camera_super_buf_t *)args->queue->dequeue();
+        if (frame == NULL) {
+            usleep(200);
+            continue;
+        }
+        CHECK(frame->num_bufs == 1);
+        CHECK(frame->ch_id < NUM_STREAMS);
+        // Hold the frame for a little while, as display/encoder would
+        usleep(1000);
+        StreamSim *stream = &args->streams[frame->ch_id];
+        pool()->release(frame);
+        __atomic_sub_fetch(&stream->inFlight, 1, __ATOMIC_ACQ_REL);
+        args->received++;
+    }
+    return NULL;
+}
+
+static void runPreview(uint32_t numFrames, uint32_t interval)
+{
+    QCameraQueue queue(QCameraSuperBufPool::releaseNode, NULL, true);
+    StreamSim streams[NUM_STREAMS];
+    pthread_t producers[NUM_STREAMS];
+    pthread_t consumerThread;
+    ConsumerArgs args;
+
+    memset(streams, 0, sizeof(streams));
+    for (uint32_t i = 0; i < NUM_STREAMS; i++) {
+        streams[i].streamId = i;
+        streams[i].numFrames = numFrames;
+        streams[i].interval = interval;
+        streams[i].queue = &queue;
+    }
+    args.streams = streams;
+    args.queue = &queue;
+    args.expected = numFrames * NUM_STREAMS;
+    args.received = 0;
+
+    pthread_create(&consumerThread, NULL, consumer, &args);
+    for (uint32_t i = 0; i < NUM_STREAMS; i++) {
+        pthread_create(&producers[i], NULL, producer, &streams[i]);
+    }
+    for (uint32_t i = 0; i < NUM_STREAMS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    pthread_join(consumerThread, NULL);
+    CHECK(args.received == args.expected);
+}
+
+static void testSteadyState()
+{
+    qcamera_super_buf_pool_stats_t stats;
+    const uint32_t numFrames = 120;   // two seconds of preview
+    struct timespec start, end;
+
+    for (uint32_t i = 0; i < NUM_STREAMS; i++) {
+        CHECK(pool()->reserve(STREAM_NUM_BUFS) == 0);
+    }
+    pool()->resetStats();
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    runPreview(numFrames, FRAME_INTERVAL_US);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    pool()->getStats(&stats);
+    printf("60 fps preview: %u frames x %d streams in %.2f s, acquired %llu "
+            "recycled %llu fallback %llu capacity %u\n",
+            numFrames, NUM_STREAMS,
+            (double)(end.tv_sec - start.tv_sec) +
+            (double)(end.tv_nsec - start.tv_nsec) / 1e9,
+            (unsigned long long)stats.acquired,
+            (unsigned long long)stats.recycled,
+            (unsigned long long)stats.fallbackAllocs, stats.capacity);
+    CHECK(stats.acquired == numFrames * NUM_STREAMS);
+    CHECK(stats.recycled == stats.acquired);
+    CHECK(stats.fallbackAllocs == 0);
+    CHECK(stats.released == stats.acquired);
+    CHECK(stats.outstanding == 0);
+    CHECK(stats.capacity >= NUM_STREAMS * STREAM_NUM_BUFS);
+    CHECK(stats.reserved == NUM_STREAMS * STREAM_NUM_BUFS);
+
+    for (uint32_t i = 0; i < NUM_STREAMS; i++) {
+        pool()->unreserve(STREAM_NUM_BUFS);
+    }
+}
+
+static void testReopenReusesSlabs()
+{
+    qcamera_super_buf_pool_stats_t before, after;
+
+    pool()->getStats(&before);
+    for (int cycle = 0; cycle < 10; cycle++) {
+        for (uint32_t i = 0; i < NUM_STREAMS; i++) {
+            CHECK(pool()->reserve(STREAM_NUM_BUFS) == 0);
+        }
+        runPreview(16, 0);
+        for (uint32_t i = 0; i < NUM_STREAMS; i++) {
+            pool()->unreserve(STREAM_NUM_BUFS);
+        }
+    }
+    pool()->getStats(&after);
+    CHECK(after.capacity == before.capacity);
+    CHECK(after.reserved == 0);
+    CHECK(after.outstanding == 0);
+}
+
+static void testHandleAndFallback()
+{
+    qcamera_super_buf_pool_stats_t stats;
+
+    pool()->getStats(&stats);
+    uint32_t capacity = stats.capacity;
+    mm_camera_super_buf_t **bufs = (mm_camera_super_buf_t **)
+            calloc(capacity + 4, sizeof(mm_camera_super_buf_t *));
+    CHECK(bufs != NULL);
+    if (bufs == NULL) {
+        return;
+    }
+
+    pool()->resetStats();
+    {
+        QCameraSuperBufHandle handle(pool()->acquire());
+        CHECK(pool()->owns(handle.get()));
+        CHECK(handle->num_bufs == 0);
+        pool()->getStats(&stats);
+        CHECK(stats.outstanding == 1);
+    }
+    pool()->getStats(&stats);
+    CHECK(stats.outstanding == 0);
+    CHECK(stats.released == 1);
+
+    // Drain the pool, the extra descriptors must come from malloc
+    for (uint32_t i = 0; i < capacity + 4; i++) {
+        bufs[i] = pool()->acquire();
+        CHECK(bufs[i] != NULL);
+    }
+    pool()->getStats(&stats);
+    CHECK(stats.fallbackAllocs == 4);
+    CHECK(stats.outstanding == capacity);
+    for (uint32_t i = 0; i < capacity; i++) {
+        CHECK(pool()->owns(bufs[i]));
+    }
+    for (uint32_t i = capacity; i < capacity + 4; i++) {
+        CHECK(!pool()->owns(bufs[i]));
+    }
+    for (uint32_t i = 0; i < capacity + 4; i++) {
+        pool()->release(bufs[i]);
+    }
+    pool()->getStats(&stats);
+    CHECK(stats.outstanding == 0);
+    free(bufs);
+
+    // Plain malloc'ed super bufs and NULL are accepted by release()
+    mm_camera_super_buf_t *legacy =
+            (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+    CHECK(!pool()->owns(legacy));
+    pool()->release(legacy);
+    pool()->release(NULL);
+}
+
+static void testQueueFlush()
+{
+    qcamera_super_buf_pool_stats_t stats;
+    QCameraQueue queue(QCameraSuperBufPool::releaseNode, NULL, true);
+    QCameraQueue plainQueue(NULL, NULL);
+
+    // A super buf queue hands its nodes back through its release function
+    for (int i = 0; i < 8; i++) {
+        queue.enqueue(pool()->acquire());
+    }
+    queue.enqueue(malloc(sizeof(mm_camera_super_buf_t)));
+    pool()->getStats(&stats);
+    CHECK(stats.outstanding == 8);
+    queue.flush();
+    pool()->getStats(&stats);
+    CHECK(stats.outstanding == 0);
+
+    // Other queues keep freeing their nodes and never touch the pool
+    pool()->resetStats();
+    for (int i = 0; i < 4; i++) {
+        plainQueue.enqueue(malloc(64));
+    }
+    plainQueue.flush();
+    pool()->getStats(&stats);
+    CHECK(stats.released == 0);
+}
+
+static void *stressThread(void *arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)arg;
+    mm_camera_super_buf_t *held[4];
+
+    for (int i = 0; i < STRESS_ITERS; i++) {
+        int n = (i % 4) + 1;
+        for (int j = 0; j < n; j++) {
+            held[j] = pool()->acquire();
+            held[j]->camera_handle = id;
+            held[j]->num_bufs = (uint32_t)i;
+        }
+        for (int j = 0; j < n; j++) {
+            // A descriptor handed to two threads at once would be overwritten
+            CHECK(held[j]->camera_handle == id);
+            CHECK(held[j]->num_bufs == (uint32_t)i);
+            pool()->release(held[j]);
+        }
+    }
+    return NULL;
+}
+
+static void testConcurrentStress()
+{
+    qcamera_super_buf_pool_stats_t stats;
+    pthread_t threads[STRESS_THREADS];
+
+    CHECK(pool()->reserve(STRESS_THREADS * 4) == 0);
+    pool()->resetStats();
+    for (uintptr_t i = 0; i < STRESS_THREADS; i++) {
+        pthread_create(&threads[i], NULL, stressThread, (void *)(i + 1));
+    }
+    for (int i = 0; i < STRESS_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pool()->getStats(&stats);
+    CHECK(stats.outstanding == 0);
+    CHECK(stats.fallbackAllocs == 0);
+    CHECK(stats.acquired == stats.released);
+    pool()->unreserve(STRESS_THREADS * 4);
+}
+
+int main()
+{
+    testSteadyState();
+    testReopenReusesSlabs();
+    testHandleAndFallback();
+    testQueueFlush();
+    testConcurrentStress();
+
+    return testResult("qcamera_superbuf_pool_test");
+}
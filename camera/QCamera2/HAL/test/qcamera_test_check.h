@@ -0,0 +1,71 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef QCAMERA_TEST_CHECK_H
+#define QCAMERA_TEST_CHECK_H
+
+// Minimal check harness shared by the standalone unit tests and benches.
+// Include it from exactly one source file per test executable.
+
+#include <stdio.h>
+
+static int gFailures = 0;
+
+// Counts a failure; safe to call from worker threads
+#define TEST_FAIL() __sync_fetch_and_add(&gFailures, 1)
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("%s:%d: CHECK failed: %s\n", __func__, __LINE__, #cond); \
+            TEST_FAIL(); \
+        } \
+    } while (0)
+
+/*===========================================================================
+ * FUNCTION   : testResult
+ *
+ * DESCRIPTION: print the verdict of a test executable
+ *
+ * PARAMETERS :
+ *   @name : test name printed with the verdict
+ *
+ * RETURN     : exit status for main(), 0 if no check failed, 1 otherwise
+ *==========================================================================*/
+static inline int testResult(const char *name)
+{
+    if (gFailures) {
+        printf("%s: FAILED (%d)\n", name, gFailures);
+        return 1;
+    }
+    printf("%s: PASSED\n", name);
+    return 0;
+}
+
+#endif /* QCAMERA_TEST_CHECK_H */
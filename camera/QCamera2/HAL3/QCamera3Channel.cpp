@@ -43,6 +43,7 @@
 // Camera dependencies
 #include "QCamera3Channel.h"
 #include "QCamera3HWI.h"
+#include "QCameraSuperBufPool.h"
 #include "QCameraTrace.h"
 #include "QCameraFormat.h"
 extern "C" {
@@ -1088,7 +1089,7 @@ void QCamera3ProcessingChannel::streamCbRoutine(mm_camera_super_buf_t *super_fra
        } else {
            LOGE("Bad frame number");
        }
-       free(super_frame);
+       QCameraSuperBufPool::getInstance()->release(super_frame);
        super_frame = NULL;
        if (mOutOfSequenceBuffers.empty()) {
           break;
@@ -1520,7 +1521,7 @@ int32_t QCamera3ProcessingChannel::setFwkInputPPData(qcamera_fwk_input_pp_data_t
     if (NO_ERROR != rc) {
         return rc;
     }
-    memcpy(meta_buf.buffer, metadata, sizeof(metadata_buffer_t));
+    mm_camera_meta_copy((metadata_buffer_t *)meta_buf.buffer, metadata);
     src_frame->metadata_buffer = meta_buf;
     src_frame->reproc_config = *reproc_cfg;
     src_frame->output_buffer = output_buffer;
@@ -3100,6 +3101,7 @@ void QCamera3RawDumpChannel::dumpRawSnapshot(mm_camera_buf_def_t *frame)
 void QCamera3RawDumpChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
                                                 __unused QCamera3Stream *stream)
 {
+    QCameraSuperBufHandle frameHolder(super_frame);
     LOGD("E");
     if (super_frame == NULL || super_frame->num_bufs != 1) {
         LOGE("super_frame is not valid");
@@ -3110,7 +3112,6 @@ void QCamera3RawDumpChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
         dumpRawSnapshot(super_frame->bufs[0]);
 
     bufDone(super_frame);
-    free(super_frame);
 }
 
 /*===========================================================================
@@ -3271,6 +3272,7 @@ QCamera3QCfaCaptureChannel::~QCamera3QCfaCaptureChannel()
 void QCamera3QCfaCaptureChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
                                                 QCamera3Stream *stream)
 {
+    QCameraSuperBufHandle frameHolder(super_frame);
     LOGD("E");
     if (super_frame == NULL || super_frame->num_bufs != 1) {
         LOGE("super_frame is not valid");
@@ -3298,8 +3300,6 @@ void QCamera3QCfaCaptureChannel::streamCbRoutine(mm_camera_super_buf_t *super_fr
     } else {
         bufDone(super_frame);
     }
-
-    free(super_frame);
 }
 
 QCamera3StreamMem* QCamera3QCfaCaptureChannel::getStreamBufs(uint32_t len)
@@ -3378,7 +3378,7 @@ int32_t QCamera3QCfaCaptureChannel::queueReprocMetadata(mm_camera_super_buf_t *m
             LOGE("frame number not match!");
             return -1;
         }
-        memcpy(&urgent_meta, p_metadata, sizeof(metadata_buffer_t));
+        mm_camera_meta_copy(&urgent_meta, p_metadata);
     } else {
         if (p_frame_number == NULL || *p_frame_number != m_frameNumber) {
             return -1;
@@ -3394,7 +3394,7 @@ int32_t QCamera3QCfaCaptureChannel::queueReprocMetadata(mm_camera_super_buf_t *m
         }
         m_metaMem->allocateAll((size_t)metadata->bufs[0]->frame_len);
         m_metaMem->getBufDef(offset, meta_buf, 0);
-        memcpy(meta_buf.buffer, metadata->bufs[0]->buffer, sizeof(metadata_buffer_t));
+        mm_camera_meta_copy((metadata_buffer_t *)meta_buf.buffer, p_metadata);
 
         meta_frame = *metadata;
         meta_frame.bufs[0] = &meta_buf;
@@ -3474,6 +3474,7 @@ QCamera3MultiRawChannel::~QCamera3MultiRawChannel()
 void QCamera3MultiRawChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
                                                  QCamera3Stream *stream)
 {
+    QCameraSuperBufHandle frameHolder(super_frame);
     LOGD("E");
     if (super_frame == NULL || super_frame->num_bufs != 1) {
         LOGE("super_frame is not valid");
@@ -3481,7 +3482,7 @@ void QCamera3MultiRawChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame
     }
 
     mm_camera_super_buf_t* frame = NULL;
-    frame = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+    frame = QCameraSuperBufPool::getInstance()->acquire();
     *frame = *super_frame;
 
     inputRawQ.push_back(frame);
@@ -3489,8 +3490,6 @@ void QCamera3MultiRawChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame
     if (inputRawQ.size() == mNumBuffers) {
         notifyCaptureDone(stream);
     }
-
-    free(super_frame);
 }
 
 QCamera3StreamMem* QCamera3MultiRawChannel::getStreamBufs(uint32_t len)
@@ -3601,7 +3600,7 @@ void QCamera3MultiRawChannel::notifyCaptureDone(QCamera3Stream* stream)
     }
 
     mm_camera_super_buf_t* frame = NULL;
-    frame = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+    frame = QCameraSuperBufPool::getInstance()->acquire();
     if (frame == NULL) {
         LOGE("frame alloc failed");
     }
@@ -3624,7 +3623,7 @@ void QCamera3MultiRawChannel::finishCapture()
 
     for (itr = inputRawQ.begin(); itr != inputRawQ.end(); itr++) {
         bufDone(*itr);
-        free(*itr);
+        QCameraSuperBufPool::getInstance()->release(*itr);
     }
     inputRawQ.clear();
 }
@@ -3925,7 +3924,7 @@ void QCamera3YUVChannel::setQuadraMetaBuffer(metadata_buffer_t *frameMeta,
     if(m_QuadraMeta != NULL)
     {
         LOGH("cache meta buffer");
-        memcpy(m_QuadraMeta, frameMeta, sizeof(metadata_buffer_t));
+        mm_camera_meta_copy(m_QuadraMeta, frameMeta);
     }
 
     if(hal_obj)
@@ -4104,7 +4103,7 @@ int32_t QCamera3YUVChannel::request(buffer_handle_t *buffer,
             startPostProc(reproc_cfg);
 
             mm_camera_super_buf_t *super_buf =
-                    (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+                    QCameraSuperBufPool::getInstance()->acquire();
             if (super_buf == NULL) {
                 LOGE("fail to allocate memory");
                 return -1;
@@ -4114,7 +4113,7 @@ int32_t QCamera3YUVChannel::request(buffer_handle_t *buffer,
                                                                                        metadata);
             m_postprocessor.processPPMetadata(super_buf, frameNumber, false);
 
-            super_buf = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+            super_buf = QCameraSuperBufPool::getInstance()->acquire();
             if (super_buf == NULL) {
                 LOGE("fail to allocate memory");
                 return -1;
@@ -4390,7 +4389,7 @@ void QCamera3YUVChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
         if (ppInfo == mOfflinePpInfoList.end()) {
             LOGE("Error, request for frame number is a reprocess.");
             stream->bufDone(frameIndex);
-            free(super_frame);
+            QCameraSuperBufPool::getInstance()->release(super_frame);
             return;
         }
         if(lastReturnedFrame == 0) {
@@ -4405,7 +4404,7 @@ void QCamera3YUVChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
                 if(bufferIndex != -1) {
                     mMemory.markFrameNumber(bufferIndex, -1);
                     mFreeHeapBufferList.push_back(bufferIndex);
-                    free(super_frame);
+                    QCameraSuperBufPool::getInstance()->release(super_frame);
                     {
                         Mutex::Autolock lock(mDropReprocBuffersLock);
                         if(m_postprocessor.releaseReprocMetaBuffer(resultFrameNumber)) {
@@ -4440,7 +4439,7 @@ void QCamera3YUVChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
         }
         if (ppInfo->offlinePpFlag && !cancelledBuffer) {
             mm_camera_super_buf_t *frame =
-                    (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+                    QCameraSuperBufPool::getInstance()->acquire();
             if (frame == NULL) {
                 LOGE("Error allocating memory to save received_frame structure.");
                 if(stream) {
@@ -4452,7 +4451,7 @@ void QCamera3YUVChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
             *frame = *super_frame;
             LOGD(" Sending Frame for Reprocessing : %d", resultFrameNumber);
             m_postprocessor.processData(frame, ppInfo->output, resultFrameNumber);
-            free(super_frame);
+            QCameraSuperBufPool::getInstance()->release(super_frame);
             return;
         } else {
             if (ppInfo != mOfflinePpInfoList.begin()) {
@@ -4874,21 +4873,21 @@ void QCamera3YUVChannel::releaseSuperBuf(mm_camera_super_buf_t *recvd_frame)
     {
         if (recvd_frame->bufs[i]->stream_type == CAM_STREAM_TYPE_CALLBACK) {
             mm_camera_super_buf_t *snap_buf =
-                     (mm_camera_super_buf_t *) malloc(sizeof(mm_camera_super_buf_t));
+                     QCameraSuperBufPool::getInstance()->acquire();
             *snap_buf = *recvd_frame;
             snap_buf->num_bufs = 1;
             snap_buf->bufs[0] = recvd_frame->bufs[i];
             bufDone(snap_buf);
-            free(snap_buf);
+            QCameraSuperBufPool::getInstance()->release(snap_buf);
         } else if(recvd_frame->bufs[i]->stream_type == CAM_STREAM_TYPE_METADATA) {
             mm_camera_super_buf_t *meta_buf =
-                     (mm_camera_super_buf_t *) malloc(sizeof(mm_camera_super_buf_t));
+                     QCameraSuperBufPool::getInstance()->acquire();
             *meta_buf = *recvd_frame;
             meta_buf->num_bufs = 1;
             meta_buf->ch_id = m_pMetaChannel->getMyHandle();
             meta_buf->bufs[0] = recvd_frame->bufs[i];
             m_pMetaChannel->bufDone(meta_buf);
-            free(meta_buf);
+            QCameraSuperBufPool::getInstance()->release(meta_buf);
         }
     }
 }
@@ -5011,7 +5010,7 @@ void QCamera3YUVChannel::ZSLChannelCb(mm_camera_super_buf_t *recvd_frame)
         if (recvd_frame->bufs[i]->stream_type == CAM_STREAM_TYPE_CALLBACK) {
             frameIndex = (uint8_t)recvd_frame->bufs[i]->buf_idx;
             mm_camera_super_buf_t *cb_buf =
-                    (mm_camera_super_buf_t *) malloc(sizeof(mm_camera_super_buf_t));
+                    QCameraSuperBufPool::getInstance()->acquire();
             *cb_buf = *recvd_frame;
             cb_buf->num_bufs = 1;
             cb_buf->bufs[0] = recvd_frame->bufs[i];
@@ -5028,7 +5027,7 @@ void QCamera3YUVChannel::ZSLChannelCb(mm_camera_super_buf_t *recvd_frame)
 
         if (recvd_frame->bufs[i]->stream_type == CAM_STREAM_TYPE_METADATA) {
             mm_camera_super_buf_t *meta_buf =
-                    (mm_camera_super_buf_t *) malloc(sizeof(mm_camera_super_buf_t));
+                    QCameraSuperBufPool::getInstance()->acquire();
             *meta_buf = *recvd_frame;
             meta_buf->num_bufs = 1;
             meta_buf->ch_id = m_pMetaChannel->getMyHandle();
@@ -5046,7 +5045,7 @@ void QCamera3YUVChannel::ZSLChannelCb(mm_camera_super_buf_t *recvd_frame)
                 }
             } else {
                 m_pMetaChannel->bufDone(meta_buf);
-                free(meta_buf);
+                QCameraSuperBufPool::getInstance()->release(meta_buf);
             }
         }
     }
@@ -6261,7 +6260,7 @@ int32_t QCamera3PicChannel::request(buffer_handle_t *buffer,
             }
 
             mm_camera_super_buf_t *super_buf =
-                    (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+                    QCameraSuperBufPool::getInstance()->acquire();
             if (super_buf == NULL) {
                 LOGE("fail to allocate memory");
                 return -1;
@@ -6269,7 +6268,7 @@ int32_t QCamera3PicChannel::request(buffer_handle_t *buffer,
             memcpy(super_buf, &(pChannel->meta_frame), sizeof(mm_camera_super_buf_t));
             m_postprocessor.processPPMetadata(super_buf, frameNumber, false);
 
-            super_buf = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+            super_buf = QCameraSuperBufPool::getInstance()->acquire();
             if (super_buf == NULL) {
                 LOGE("fail to allocate memory");
                 return -1;
@@ -6461,10 +6460,10 @@ void QCamera3PicChannel::freeBufferForJpeg(int& index)
 void QCamera3PicChannel::queueReprocFrame(mm_camera_super_buf_t *super_frame, uint32_t frame_number)
 {
     mm_camera_super_buf_t* frame = NULL;
-    frame = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+    frame = QCameraSuperBufPool::getInstance()->acquire();
     *frame = *super_frame;
     m_postprocessor.processData(frame, NULL, frame_number);
-    free(super_frame);
+    QCameraSuperBufPool::getInstance()->release(super_frame);
     return;
 }
 
@@ -6485,6 +6484,7 @@ void QCamera3PicChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
                             QCamera3Stream *stream)
 {
     KPI_ATRACE_CAMSCOPE_CALL(CAMSCOPE_HAL3_CAPTURE_CH_CB);
+    QCameraSuperBufHandle frameHolder(super_frame);
     //TODO
     //Used only for getting YUV. Jpeg callback will be sent back from channel
     //directly to HWI. Refer to func jpegEvtHandle
@@ -6525,11 +6525,10 @@ void QCamera3PicChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
         } else {
             mFreeBufferList.push_back(frameIndex);
         }
-        free(super_frame);
         return;
     }
 
-    frame = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+    frame = QCameraSuperBufPool::getInstance()->acquire();
     if (frame == NULL) {
        LOGE("Error allocating memory to save received_frame structure.");
        if(stream) {
@@ -6553,7 +6552,6 @@ void QCamera3PicChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
                              mYuvMemory->getFrameNumber(frameIndex));
     LOGD(" Sending frame :%d ",frameNum);
     m_postprocessor.processData(frame, NULL, frameNum);
-    free(super_frame);
     return;
 }
 
@@ -6635,21 +6633,21 @@ void QCamera3PicChannel::releaseSuperBuf(mm_camera_super_buf_t *recvd_frame)
     {
         if (recvd_frame->bufs[i]->stream_type == CAM_STREAM_TYPE_SNAPSHOT) {
             mm_camera_super_buf_t *snap_buf =
-                     (mm_camera_super_buf_t *) malloc(sizeof(mm_camera_super_buf_t));
+                     QCameraSuperBufPool::getInstance()->acquire();
             *snap_buf = *recvd_frame;
             snap_buf->num_bufs = 1;
             snap_buf->bufs[0] = recvd_frame->bufs[i];
             bufDone(snap_buf);
-            free(snap_buf);
+            QCameraSuperBufPool::getInstance()->release(snap_buf);
         } else if(recvd_frame->bufs[i]->stream_type == CAM_STREAM_TYPE_METADATA) {
             mm_camera_super_buf_t *meta_buf =
-                     (mm_camera_super_buf_t *) malloc(sizeof(mm_camera_super_buf_t));
+                     QCameraSuperBufPool::getInstance()->acquire();
             *meta_buf = *recvd_frame;
             meta_buf->num_bufs = 1;
             meta_buf->ch_id = m_pMetaChannel->getMyHandle();
             meta_buf->bufs[0] = recvd_frame->bufs[i];
             m_pMetaChannel->bufDone(meta_buf);
-            free(meta_buf);
+            QCameraSuperBufPool::getInstance()->release(meta_buf);
         }
     }
 }
@@ -7149,7 +7147,7 @@ void QCamera3PicChannel::ZSLChannelCb(mm_camera_super_buf_t *recvd_frame)
         if (recvd_frame->bufs[i]->stream_type == CAM_STREAM_TYPE_SNAPSHOT) {
             frameIndex = (uint8_t)recvd_frame->bufs[i]->buf_idx;
             mm_camera_super_buf_t *snap_buf =
-                    (mm_camera_super_buf_t *) malloc(sizeof(mm_camera_super_buf_t));
+                    QCameraSuperBufPool::getInstance()->acquire();
             *snap_buf = *recvd_frame;
             snap_buf->num_bufs = 1;
             snap_buf->bufs[0] = recvd_frame->bufs[i];
@@ -7161,7 +7159,7 @@ void QCamera3PicChannel::ZSLChannelCb(mm_camera_super_buf_t *recvd_frame)
 
         if (recvd_frame->bufs[i]->stream_type == CAM_STREAM_TYPE_METADATA) {
             mm_camera_super_buf_t *meta_buf =
-                    (mm_camera_super_buf_t *) malloc(sizeof(mm_camera_super_buf_t));
+                    QCameraSuperBufPool::getInstance()->acquire();
             *meta_buf = *recvd_frame;
             meta_buf->num_bufs = 1;
             meta_buf->ch_id = m_pMetaChannel->getMyHandle();
@@ -7345,6 +7343,7 @@ int QCamera3ReprocessChannel::releaseOutputBuffer(buffer_handle_t * output_buffe
 void QCamera3ReprocessChannel::streamCbRoutine(mm_camera_super_buf_t *super_frame,
                                   QCamera3Stream *stream)
 {
+    QCameraSuperBufHandle frameHolder(super_frame);
     //Got the pproc data callback. Now send to jpeg encoding
     uint8_t frameIndex;
     uint32_t resultFrameNumber;
@@ -7387,7 +7386,7 @@ void QCamera3ReprocessChannel::streamCbRoutine(mm_camera_super_buf_t *super_fram
 
     if (mReprocessType == REPROCESS_TYPE_JPEG) {
         resultFrameNumber =  mMemory->getFrameNumber(frameIndex);
-        frame = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+        frame = QCameraSuperBufPool::getInstance()->acquire();
         if (frame == NULL) {
            LOGE("Error allocating memory to save received_frame structure.");
            if(stream) {
@@ -7416,7 +7415,7 @@ void QCamera3ReprocessChannel::streamCbRoutine(mm_camera_super_buf_t *super_fram
     } else if((mReprocessType == REPROCESS_TYPE_YUV) &&
         (hal_obj->m_bPreSnapQuadraCfaRequest) && (m_ppIndex == 0)) {
         resultFrameNumber = mMemory->getFrameNumber(frameIndex);
-        frame = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+        frame = QCameraSuperBufPool::getInstance()->acquire();
         if(frame == NULL) {
             LOGE("Error allocating memory to save received frame structure");
             if(stream) {
@@ -7462,7 +7461,6 @@ void QCamera3ReprocessChannel::streamCbRoutine(mm_camera_super_buf_t *super_fram
         }
         resetToCamPerfNormal(resultFrameNumber);
     }
-    free(super_frame);
     return;
 }
 
@@ -8857,12 +8855,12 @@ void QCamera3SupportChannel::streamCbRoutine(
                         mm_camera_super_buf_t *super_frame,
                         QCamera3Stream * /*stream*/)
 {
+    QCameraSuperBufHandle frameHolder(super_frame);
     if (super_frame == NULL || super_frame->num_bufs != 1) {
         LOGE("super_frame is not valid");
         return;
     }
     bufDone(super_frame);
-    free(super_frame);
 }
 
 QCamera3StreamMem* QCamera3SupportChannel::getStreamBufs(uint32_t len)
@@ -56,6 +56,7 @@
 #include "QCameraPerfTranslator.h"
 #include "QCamera3HWI.h"
 #include "QCamera3VendorTags.h"
+#include "QCameraSuperBufPool.h"
 #include "QCameraTrace.h"
 
 extern "C" {
@@ -839,10 +840,7 @@ QCamera3HardwareInterface::~QCamera3HardwareInterface()
     if (mState != CLOSED)
         closeCamera();
 
-    for (auto &req : mPendingBuffersMap.mPendingBuffersInRequest) {
-        req.mPendingBufferList.clear();
-    }
-    mPendingBuffersMap.mPendingBuffersInRequest.clear();
+    mPendingBuffersMap.clear();
     mPendingReprocessResultList.clear();
     for (pendingRequestIterator i = mPendingRequestsList.begin();
             i != mPendingRequestsList.end();) {
@@ -900,9 +898,28 @@ QCamera3HardwareInterface::pendingRequestIterator
     }
     if (i->settings != NULL)
         free_camera_metadata((camera_metadata_t*)i->settings);
+    mPendingRequestIndex.remove(i->frame_number, i);
     return mPendingRequestsList.erase(i);
 }
 
+/*===========================================================================
+ * FUNCTION   : findPendingRequest
+ *
+ * DESCRIPTION: find the pending request of a frame number. Looks up the frame
+ *              number index and only scans mPendingRequestsList when the
+ *              index could not hold every pending request.
+ *
+ * PARAMETERS :
+ *   @frame_number : frame number of the request
+ *
+ * RETURN     : iterator pointing to the request, or end of the list
+ *==========================================================================*/
+QCamera3HardwareInterface::pendingRequestIterator
+        QCamera3HardwareInterface::findPendingRequest(uint32_t frame_number)
+{
+    return mPendingRequestIndex.lookup(frame_number, mPendingRequestsList);
+}
+
 /*===========================================================================
  * FUNCTION   : camEvtHandle
  *
@@ -3857,10 +3874,7 @@ int QCamera3HardwareInterface::configureStreamsPerfLocked(
     }
     mPendingFrameDropList.clear();
     // Initialize/Reset the pending buffers list
-    for (auto &req : mPendingBuffersMap.mPendingBuffersInRequest) {
-        req.mPendingBufferList.clear();
-    }
-    mPendingBuffersMap.mPendingBuffersInRequest.clear();
+    mPendingBuffersMap.clear();
 
     mPendingReprocessResultList.clear();
 
@@ -4216,27 +4230,23 @@ int32_t QCamera3HardwareInterface::handlePendingReprocResults(uint32_t frame_num
             LOGD("Delayed reprocess notify %d",
                     frame_number);
 
-            for (pendingRequestIterator k = mPendingRequestsList.begin();
-                    k != mPendingRequestsList.end(); k++) {
-
-                if (k->frame_number == j->frame_number) {
-                    LOGD("Found reprocess frame number %d in pending reprocess List "
-                            "Take it out!!",
-                            k->frame_number);
-
-                    camera3_capture_result result;
-                    memset(&result, 0, sizeof(camera3_capture_result));
-                    result.frame_number = frame_number;
-                    result.num_output_buffers = 1;
-                    result.output_buffers =  &j->buffer;
-                    result.input_buffer = k->input_buffer;
-                    result.result = k->settings;
-                    result.partial_result = PARTIAL_RESULT_COUNT;
-                    orchestrateResult(&result);
-
-                    erasePendingRequest(k);
-                    break;
-                }
+            pendingRequestIterator k = findPendingRequest(j->frame_number);
+            if (k != mPendingRequestsList.end()) {
+                LOGD("Found reprocess frame number %d in pending reprocess List "
+                        "Take it out!!",
+                        k->frame_number);
+
+                camera3_capture_result result;
+                memset(&result, 0, sizeof(camera3_capture_result));
+                result.frame_number = frame_number;
+                result.num_output_buffers = 1;
+                result.output_buffers =  &j->buffer;
+                result.input_buffer = k->input_buffer;
+                result.result = k->settings;
+                result.partial_result = PARTIAL_RESULT_COUNT;
+                orchestrateResult(&result);
+
+                erasePendingRequest(k);
             }
             mPendingReprocessResultList.erase(j);
             break;
@@ -4258,16 +4268,7 @@ int32_t QCamera3HardwareInterface::handlePendingReprocResults(uint32_t frame_num
 bool QCamera3HardwareInterface::checkFrameInPendingList(
         const uint32_t frame_number)
 {
-    bool ret = false;
-    for(auto itr = mPendingRequestsList.begin(); itr != mPendingRequestsList.end(); itr++)
-    {
-        if(frame_number == itr->frame_number)
-        {
-            ret = true;
-            break;
-        }
-    }
-    return ret;
+    return (findPendingRequest(frame_number) != mPendingRequestsList.end());
 }
 
 /*===========================================================================
@@ -4454,7 +4455,7 @@ BUFFER_NOT_BATCHED:
     /* BufDone metadata buffer */
     if (free_and_bufdone_meta_buf && !is_metabuf_queued) {
         mMetadataChannel->bufDone(metadata_buf);
-        free(metadata_buf);
+        QCameraSuperBufPool::getInstance()->release(metadata_buf);
         metadata_buf = NULL;
     }
 }
@@ -4477,38 +4478,32 @@ bool QCamera3HardwareInterface::cacheMetaIfNeeded(
          mm_camera_super_buf_t *metadata_buf, uint32_t frame_number)
 {
     bool cached = false;
-    for (pendingRequestIterator i = mPendingRequestsList.begin();
-            i != mPendingRequestsList.end(); i++) {
-
-            if(!(i->frame_number == frame_number)) continue;
-
-            if(i->received_main_meta && i->received_aux_meta)
-            {
-                LOGE("already received metadata for main and aux...");
-                break;
-            }
-
-            if ((metadata_buf->camera_handle ==
-                    get_main_camera_handle(mCameraHandle->camera_handle))
-                    && (i->main_meta == NULL))
-            {
-                i->main_meta = metadata_buf;
-                i->received_main_meta = true;
-                cached = true;
-                LOGI("cached main meta for frame_numer %d", frame_number);
-                break;
-            }
+    pendingRequestIterator i = findPendingRequest(frame_number);
+    if (i == mPendingRequestsList.end()) {
+        return cached;
+    }
 
-            if((metadata_buf->camera_handle ==
-                     get_aux_camera_handle(mCameraHandle->camera_handle))
-                     && (i->aux_meta == NULL))
-            {
-                i->aux_meta = metadata_buf;
-                i->received_aux_meta = true;
-                cached = true;
-                LOGI("cached aux meta for frame_number %d",frame_number);
-                break;
-            }
+    if(i->received_main_meta && i->received_aux_meta)
+    {
+        LOGE("already received metadata for main and aux...");
+    }
+    else if ((metadata_buf->camera_handle ==
+            get_main_camera_handle(mCameraHandle->camera_handle))
+            && (i->main_meta == NULL))
+    {
+        i->main_meta = metadata_buf;
+        i->received_main_meta = true;
+        cached = true;
+        LOGI("cached main meta for frame_numer %d", frame_number);
+    }
+    else if((metadata_buf->camera_handle ==
+             get_aux_camera_handle(mCameraHandle->camera_handle))
+             && (i->aux_meta == NULL))
+    {
+        i->aux_meta = metadata_buf;
+        i->received_aux_meta = true;
+        cached = true;
+        LOGI("cached aux meta for frame_number %d",frame_number);
     }
     return cached;
 }
@@ -4656,14 +4651,14 @@ void QCamera3HardwareInterface::releaseCachedMeta(
     if(request->main_meta != NULL)
     {
         meta_channel->bufDone(request->main_meta);
-        free(request->main_meta);
+        QCameraSuperBufPool::getInstance()->release(request->main_meta);
         request->main_meta = NULL;
     }
 
     if(request->aux_meta != NULL)
     {
         meta_channel->bufDone(request->aux_meta);
-        free(request->aux_meta);
+        QCameraSuperBufPool::getInstance()->release(request->aux_meta);
         request->aux_meta = NULL;
     }
 }
@@ -4751,7 +4746,7 @@ void QCamera3HardwareInterface::handleMetadataWithLock(
         LOGD("not sending metadata during flush or when mState is error");
         if (free_and_bufdone_meta_buf) {
             mMetadataChannel->bufDone(metadata_buf);
-            free(metadata_buf);
+            QCameraSuperBufPool::getInstance()->release(metadata_buf);
         }
         return;
     }
@@ -4783,7 +4778,7 @@ void QCamera3HardwareInterface::handleMetadataWithLock(
         LOGE("Invalid metadata");
         if (free_and_bufdone_meta_buf) {
             mMetadataChannel->bufDone(metadata_buf);
-            free(metadata_buf);
+            QCameraSuperBufPool::getInstance()->release(metadata_buf);
             meta_freed = true;
         }
         goto done_metadata;
@@ -4813,7 +4808,7 @@ void QCamera3HardwareInterface::handleMetadataWithLock(
              || (!(getHalPPType() == CAM_HAL_PP_TYPE_SAT)
              && mHALZSL && (resultMetadata == NULL))) {
             mMetadataChannel->bufDone(metadata_buf);
-            free(metadata_buf);
+            QCameraSuperBufPool::getInstance()->release(metadata_buf);
             return;
         } else {
             if (pMetaDataAux && frame_number_valid
@@ -4918,7 +4913,7 @@ void QCamera3HardwareInterface::handleMetadataWithLock(
         LOGD("Not a valid normal frame number, used as SOF only");
         if (free_and_bufdone_meta_buf) {
             mMetadataChannel->bufDone(metadata_buf);
-            free(metadata_buf);
+            QCameraSuperBufPool::getInstance()->release(metadata_buf);
             meta_freed = true;
         }
         goto done_metadata;
@@ -5160,7 +5155,7 @@ void QCamera3HardwareInterface::handleMetadataWithLock(
                        releaseCachedMeta(&(*i), mMetadataChannel);
                    } else {
                         mMetadataChannel->bufDone(metadata_buf);
-                        free(metadata_buf);
+                        QCameraSuperBufPool::getInstance()->release(metadata_buf);
                    }
                    meta_freed = true;
                 }
@@ -5276,7 +5271,7 @@ done_metadata:
     if(!meta_freed && free_and_bufdone_meta_buf)
     {
         mMetadataChannel->bufDone(metadata_buf);
-        free(metadata_buf);
+        QCameraSuperBufPool::getInstance()->release(metadata_buf);
     }
 
     LOGD("mPendingLiveRequest = %d", mPendingLiveRequest);
@@ -5362,10 +5357,7 @@ void QCamera3HardwareInterface::hdrPlusPerfLock(
 void QCamera3HardwareInterface::handleInputBufferWithLock(uint32_t frame_number)
 {
     ATRACE_CAMSCOPE_CALL(CAMSCOPE_HAL3_HANDLE_IN_BUF_LKD);
-    pendingRequestIterator i = mPendingRequestsList.begin();
-    while (i != mPendingRequestsList.end() && i->frame_number != frame_number){
-        i++;
-    }
+    pendingRequestIterator i = findPendingRequest(frame_number);
     if (i != mPendingRequestsList.end() && i->input_buffer && (i->buffers.size() == 1)) {
         //found the right request
         if (!i->shutter_notified) {
@@ -5485,10 +5477,7 @@ void QCamera3HardwareInterface::handleBufferWithLock(
         mMultiFrameSnapshotRunning = false;
     }
 
-    pendingRequestIterator i = mPendingRequestsList.begin();
-    while (i != mPendingRequestsList.end() && i->frame_number != frame_number){
-        i++;
-    }
+    pendingRequestIterator i = findPendingRequest(frame_number);
     if (i == mPendingRequestsList.end() || (i->input_buffer != NULL)) {
         // Verify all pending requests frame_numbers are greater
         for (pendingRequestIterator j = mPendingRequestsList.begin();
@@ -7032,8 +7021,7 @@ int QCamera3HardwareInterface::processCaptureRequest(
                 }
 
                 if (isDualCamera() && !IS_PP_TYPE_NONE) {
-                    clear_metadata_buffer(mAuxParameters);
-                    memcpy(mAuxParameters, mParameters, sizeof(metadata_buffer_t));
+                    mm_camera_meta_copy(mAuxParameters, mParameters);
                     if (m_pFovControl != NULL) {
                         m_pFovControl->translateInputParams(mParameters, mAuxParameters);
                     }
@@ -8366,13 +8354,14 @@ no_error:
     // Add this request packet into mPendingBuffersMap
     if(request->num_output_buffers > 0)
     {
-        mPendingBuffersMap.mPendingBuffersInRequest.push_back(bufsForCurRequest);
+        mPendingBuffersMap.addRequest(bufsForCurRequest);
         LOGD("mPendingBuffersMap.num_overall_buffers = %d",
             mPendingBuffersMap.get_num_overall_buffers());
     }
 
     latestRequest = mPendingRequestsList.insert(
             mPendingRequestsList.end(), pendingRequest);
+    mPendingRequestIndex.add(latestRequest->frame_number, latestRequest);
     if(mFlush) {
         LOGI("mFlush is true");
         if(mParameters != NULL) {
@@ -9346,7 +9335,7 @@ void QCamera3HardwareInterface::internalMetaCb(mm_camera_super_buf_t *metadata){
             (NULL == p_urgent_frame_number_valid) || (NULL == p_urgent_frame_number)) {
         LOGE("Invalid metadata");
         mMetadataChannel->bufDone(metadata);
-        free(metadata);
+        QCameraSuperBufPool::getInstance()->release(metadata);
         return;
     }
 
@@ -9368,7 +9357,7 @@ void QCamera3HardwareInterface::internalMetaCb(mm_camera_super_buf_t *metadata){
     }
 
     mMetadataChannel->bufDone(metadata);
-    free(metadata);
+    QCameraSuperBufPool::getInstance()->release(metadata);
 }
 
 /*===========================================================================
@@ -14275,7 +14264,7 @@ int QCamera3HardwareInterface::setFrameParameters(
     if(settings != NULL){
         rc = translateToHalMetadata(settings, mParameters, snapshotStreamId, request);
         if (blob_request)
-            memcpy(mPrevParameters, mParameters, sizeof(metadata_buffer_t));
+            mm_camera_meta_copy(mPrevParameters, mParameters);
     }
 
     if (isDualCamera() && !IS_PP_TYPE_NONE) {
@@ -17152,7 +17141,7 @@ int32_t QCamera3HardwareInterface::notifyErrorForPendingRequests()
             // Remove this request from Map
             LOGD("Removing request %d. Remaining requests in mPendingBuffersMap: %d",
                 req->frame_number, mPendingBuffersMap.mPendingBuffersInRequest.size());
-            req = mPendingBuffersMap.mPendingBuffersInRequest.erase(req);
+            req = mPendingBuffersMap.eraseRequest(req);
 
             orchestrateResult(&result);
 
@@ -17202,7 +17191,7 @@ int32_t QCamera3HardwareInterface::notifyErrorForPendingRequests()
             // Remove this request from Map
             LOGD("Removing request %d. Remaining requests in mPendingBuffersMap: %d",
                 req->frame_number, mPendingBuffersMap.mPendingBuffersInRequest.size());
-            req = mPendingBuffersMap.mPendingBuffersInRequest.erase(req);
+            req = mPendingBuffersMap.eraseRequest(req);
 
             orchestrateResult(&result);
             delete [] pStream_Buf;
@@ -17213,10 +17202,7 @@ int32_t QCamera3HardwareInterface::notifyErrorForPendingRequests()
     /* Reset pending frame Drop list and requests list */
     mPendingFrameDropList.clear();
 
-    for (auto &req : mPendingBuffersMap.mPendingBuffersInRequest) {
-        req.mPendingBufferList.clear();
-    }
-    mPendingBuffersMap.mPendingBuffersInRequest.clear();
+    mPendingBuffersMap.clear();
     mPendingReprocessResultList.clear();
     LOGH("Cleared all the pending buffers ");
 
@@ -17391,87 +17377,6 @@ int32_t QCamera3HardwareInterface::setInstantAEC(const CameraMetadata &meta)
     return rc;
 }
 
-/*===========================================================================
- * FUNCTION   : get_num_overall_buffers
- *
- * DESCRIPTION: Estimate number of pending buffers across all requests.
- *
- * PARAMETERS : None
- *
- * RETURN     : Number of overall pending buffers
- *
- *==========================================================================*/
-uint32_t PendingBuffersMap::get_num_overall_buffers()
-{
-    uint32_t sum_buffers = 0;
-    for (auto &req : mPendingBuffersInRequest) {
-        sum_buffers += req.mPendingBufferList.size();
-    }
-    return sum_buffers;
-}
-
-/*===========================================================================
- * FUNCTION   : removeBuf
- *
- * DESCRIPTION: Remove a matching buffer from tracker.
- *
- * PARAMETERS : @buffer: image buffer for the callback
- *
- * RETURN     : None
- *
- *==========================================================================*/
-void PendingBuffersMap::removeBuf(buffer_handle_t *buffer)
-{
-    bool buffer_found = false;
-    for (auto req = mPendingBuffersInRequest.begin();
-            req != mPendingBuffersInRequest.end(); req++) {
-        for (auto k = req->mPendingBufferList.begin();
-                k != req->mPendingBufferList.end(); k++ ) {
-            if (k->buffer == buffer) {
-                LOGD("Frame %d: Found Frame buffer %p, take it out from mPendingBufferList",
-                        req->frame_number, buffer);
-                k = req->mPendingBufferList.erase(k);
-                if (req->mPendingBufferList.empty()) {
-                    // Remove this request from Map
-                    req = mPendingBuffersInRequest.erase(req);
-                }
-                buffer_found = true;
-                break;
-            }
-        }
-        if (buffer_found) {
-            break;
-        }
-    }
-    LOGD("mPendingBuffersMap.num_overall_buffers = %d",
-            get_num_overall_buffers());
-}
-
-/*===========================================================================
- * FUNCTION   : getBufErrStatus
- *
- * DESCRIPTION: get buffer error status
- *
- * PARAMETERS : @buffer: buffer handle
- *
- * RETURN     : Error status
- *
- *==========================================================================*/
-int32_t PendingBuffersMap::getBufErrStatus(buffer_handle_t *buffer)
-{
-    for (auto& req : mPendingBuffersInRequest) {
-        for (auto& k : req.mPendingBufferList) {
-            if (k.buffer == buffer) {
-                if (k.bufStatus & CAMERA3_BUFFER_STATUS_ERROR) {
-                    LOGH("CAMERA3_BUFFER_STATUS_ERROR, buffer=%p", buffer);
-                }
-                return k.bufStatus;
-            }
-        }
-    }
-    return CAMERA3_BUFFER_STATUS_OK;
-}
-
 /*===========================================================================
  * FUNCTION   : setPAAFSupport
  *
@@ -42,6 +42,7 @@
 #include "QCamera3Channel.h"
 #include "QCamera3CropRegionMapper.h"
 #include "QCamera3HALHeader.h"
+#include "QCamera3InflightTracker.h"
 #include "QCamera3Mem.h"
 #include "QCameraPerf.h"
 #include "QCameraCommon.h"
@@ -159,34 +160,6 @@ typedef struct {
     QCamera3ProcessingChannel *channel;
 } stream_info_t;
 
-typedef struct {
-    // Stream handle
-    camera3_stream_t *stream;
-    // Buffer handle
-    buffer_handle_t *buffer;
-    // Buffer status
-    camera3_buffer_status_t bufStatus = CAMERA3_BUFFER_STATUS_OK;
-} PendingBufferInfo;
-
-typedef struct {
-    // Frame number corresponding to request
-    uint32_t frame_number;
-    // Time when request queued into system
-    nsecs_t timestamp;
-    List<PendingBufferInfo> mPendingBufferList;
-} PendingBuffersInRequest;
-
-class PendingBuffersMap {
-public:
-    // Number of outstanding buffers at flush
-    uint32_t numPendingBufsAtFlush;
-    // List of pending buffers per request
-    List<PendingBuffersInRequest> mPendingBuffersInRequest;
-    uint32_t get_num_overall_buffers();
-    void removeBuf(buffer_handle_t *buffer);
-    int32_t getBufErrStatus(buffer_handle_t *buffer);
-};
-
 class FrameNumberRegistry {
 public:
 
@@ -672,6 +645,8 @@ private:
 
     List<PendingReprocessResult> mPendingReprocessResultList;
     List<PendingRequestInfo> mPendingRequestsList;
+    // mPendingRequestsList entries by frame number
+    QCamera3FrameIndex<pendingRequestIterator> mPendingRequestIndex;
     List<PendingFrameDropInfo> mPendingFrameDropList;
     /* Use last frame number of the batch as key and first frame number of the
      * batch as value for that key */
@@ -818,6 +793,7 @@ private:
     static const QCameraPropMap CDS_MAP[];
 
     pendingRequestIterator erasePendingRequest(pendingRequestIterator i);
+    pendingRequestIterator findPendingRequest(uint32_t frame_number);
     //GPU library to read buffer padding details.
     void *lib_surface_utils;
     int (*LINK_get_surface_pixel_alignment)();
@@ -0,0 +1,326 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define LOG_TAG "QCamera3InflightTracker"
+
+// System dependencies
+#include <string.h>
+
+// Camera dependencies
+#include "QCamera3InflightTracker.h"
+
+extern "C" {
+#include "mm_camera_dbg.h"
+}
+
+using namespace android;
+
+namespace qcamera {
+
+/*===========================================================================
+ * FUNCTION   : QCamera3BufferIndex
+ *
+ * DESCRIPTION: constructor of QCamera3BufferIndex
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+QCamera3BufferIndex::QCamera3BufferIndex()
+{
+    clear();
+}
+
+/*===========================================================================
+ * FUNCTION   : bucketOf
+ *
+ * DESCRIPTION: hash a buffer handle to its bucket
+ *
+ * PARAMETERS :
+ *   @handle  : buffer handle
+ *
+ * RETURN     : bucket index
+ *==========================================================================*/
+uint32_t QCamera3BufferIndex::bucketOf(const void *handle)
+{
+    // handles are at least pointer aligned, drop the low bits first
+    uint64_t key = (uint64_t)(uintptr_t)handle >> 3;
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(key >> 32) & (QCAMERA3_BUFFER_INDEX_BUCKETS - 1);
+}
+
+/*===========================================================================
+ * FUNCTION   : add
+ *
+ * DESCRIPTION: add or update the entry of a buffer handle
+ *
+ * PARAMETERS :
+ *   @handle  : buffer handle
+ *   @val     : value to remember for the handle
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCamera3BufferIndex::add(const void *handle, uint32_t val)
+{
+    if (handle == NULL) {
+        return;
+    }
+    uint32_t b = bucketOf(handle);
+    Way *free_way = NULL;
+    for (uint32_t i = 0; i < QCAMERA3_BUFFER_INDEX_WAYS; i++) {
+        if (mWays[b][i].handle == handle) {
+            mWays[b][i].val = val;
+            return;
+        }
+        if ((free_way == NULL) && (mWays[b][i].handle == NULL)) {
+            free_way = &mWays[b][i];
+        }
+    }
+    if (free_way == NULL) {
+        free_way = &mWays[b][mNextVictim[b]];
+        mNextVictim[b] = (uint8_t)((mNextVictim[b] + 1) % QCAMERA3_BUFFER_INDEX_WAYS);
+    }
+    free_way->handle = handle;
+    free_way->val = val;
+}
+
+/*===========================================================================
+ * FUNCTION   : remove
+ *
+ * DESCRIPTION: drop the entry of a buffer handle if present
+ *
+ * PARAMETERS :
+ *   @handle  : buffer handle
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCamera3BufferIndex::remove(const void *handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+    uint32_t b = bucketOf(handle);
+    for (uint32_t i = 0; i < QCAMERA3_BUFFER_INDEX_WAYS; i++) {
+        if (mWays[b][i].handle == handle) {
+            mWays[b][i].handle = NULL;
+            return;
+        }
+    }
+}
+
+/*===========================================================================
+ * FUNCTION   : find
+ *
+ * DESCRIPTION: look up the value remembered for a buffer handle
+ *
+ * PARAMETERS :
+ *   @handle  : buffer handle
+ *   @val     : value of the handle if found
+ *
+ * RETURN     : true if the handle has an entry, false otherwise
+ *==========================================================================*/
+bool QCamera3BufferIndex::find(const void *handle, uint32_t &val) const
+{
+    if (handle == NULL) {
+        return false;
+    }
+    uint32_t b = bucketOf(handle);
+    for (uint32_t i = 0; i < QCAMERA3_BUFFER_INDEX_WAYS; i++) {
+        if (mWays[b][i].handle == handle) {
+            val = mWays[b][i].val;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*===========================================================================
+ * FUNCTION   : clear
+ *
+ * DESCRIPTION: drop all entries
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCamera3BufferIndex::clear()
+{
+    memset(mWays, 0, sizeof(mWays));
+    memset(mNextVictim, 0, sizeof(mNextVictim));
+}
+
+/*===========================================================================
+ * FUNCTION   : get_num_overall_buffers
+ *
+ * DESCRIPTION: Estimate number of pending buffers across all requests.
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : Number of overall pending buffers
+ *
+ *==========================================================================*/
+uint32_t PendingBuffersMap::get_num_overall_buffers()
+{
+    uint32_t sum_buffers = 0;
+    for (auto &req : mPendingBuffersInRequest) {
+        sum_buffers += req.mPendingBufferList.size();
+    }
+    return sum_buffers;
+}
+
+/*===========================================================================
+ * FUNCTION   : addRequest
+ *
+ * DESCRIPTION: Add the pending buffers of a new request to tracker.
+ *
+ * PARAMETERS : @request: frame number and buffers of the request
+ *
+ * RETURN     : None
+ *
+ *==========================================================================*/
+void PendingBuffersMap::addRequest(const PendingBuffersInRequest &request)
+{
+    mPendingBuffersInRequest.push_back(request);
+}
+
+/*===========================================================================
+ * FUNCTION   : eraseRequest
+ *
+ * DESCRIPTION: Remove a request and its remaining buffers from tracker.
+ *
+ * PARAMETERS : @req: request to remove
+ *
+ * RETURN     : iterator pointing to the next request
+ *
+ *==========================================================================*/
+List<PendingBuffersInRequest>::iterator PendingBuffersMap::eraseRequest(
+        List<PendingBuffersInRequest>::iterator req)
+{
+    return mPendingBuffersInRequest.erase(req);
+}
+
+/*===========================================================================
+ * FUNCTION   : clear
+ *
+ * DESCRIPTION: Remove all requests and buffers from tracker.
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *
+ *==========================================================================*/
+void PendingBuffersMap::clear()
+{
+    for (auto &req : mPendingBuffersInRequest) {
+        req.mPendingBufferList.clear();
+    }
+    mPendingBuffersInRequest.clear();
+}
+
+/*===========================================================================
+ * FUNCTION   : findBuf
+ *
+ * DESCRIPTION: Find the request and entry of a pending buffer. A linear
+ *              scan: with a handful of requests in flight it is cheaper
+ *              than keeping a handle index in sync.
+ *
+ * PARAMETERS :
+ *   @buffer  : buffer handle
+ *   @bufIt   : entry of the buffer in the request if found
+ *
+ * RETURN     : request holding the buffer, or end of mPendingBuffersInRequest
+ *
+ *==========================================================================*/
+List<PendingBuffersInRequest>::iterator PendingBuffersMap::findBuf(
+        buffer_handle_t *buffer, List<PendingBufferInfo>::iterator &bufIt)
+{
+    for (auto req = mPendingBuffersInRequest.begin();
+            req != mPendingBuffersInRequest.end(); req++) {
+        for (auto k = req->mPendingBufferList.begin();
+                k != req->mPendingBufferList.end(); k++) {
+            if (k->buffer == buffer) {
+                bufIt = k;
+                return req;
+            }
+        }
+    }
+    return mPendingBuffersInRequest.end();
+}
+
+/*===========================================================================
+ * FUNCTION   : removeBuf
+ *
+ * DESCRIPTION: Remove a matching buffer from tracker.
+ *
+ * PARAMETERS : @buffer: image buffer for the callback
+ *
+ * RETURN     : None
+ *
+ *==========================================================================*/
+void PendingBuffersMap::removeBuf(buffer_handle_t *buffer)
+{
+    List<PendingBufferInfo>::iterator k;
+    auto req = findBuf(buffer, k);
+    if (req != mPendingBuffersInRequest.end()) {
+        LOGD("Frame %d: Found Frame buffer %p, take it out from mPendingBufferList",
+                req->frame_number, buffer);
+        req->mPendingBufferList.erase(k);
+        if (req->mPendingBufferList.empty()) {
+            // Remove this request from Map
+            eraseRequest(req);
+        }
+    }
+    LOGD("mPendingBuffersMap.num_overall_buffers = %d",
+            get_num_overall_buffers());
+}
+
+/*===========================================================================
+ * FUNCTION   : getBufErrStatus
+ *
+ * DESCRIPTION: get buffer error status
+ *
+ * PARAMETERS : @buffer: buffer handle
+ *
+ * RETURN     : Error status
+ *
+ *==========================================================================*/
+int32_t PendingBuffersMap::getBufErrStatus(buffer_handle_t *buffer)
+{
+    List<PendingBufferInfo>::iterator k;
+    auto req = findBuf(buffer, k);
+    if (req != mPendingBuffersInRequest.end()) {
+        if (k->bufStatus & CAMERA3_BUFFER_STATUS_ERROR) {
+            LOGH("CAMERA3_BUFFER_STATUS_ERROR, buffer=%p", buffer);
+        }
+        return k->bufStatus;
+    }
+    return CAMERA3_BUFFER_STATUS_OK;
+}
+
+}; // namespace qcamera
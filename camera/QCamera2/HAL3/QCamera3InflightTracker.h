@@ -0,0 +1,200 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef __QCAMERA3_INFLIGHT_TRACKER_H__
+#define __QCAMERA3_INFLIGHT_TRACKER_H__
+
+// System dependencies
+#include <stddef.h>
+#include <stdint.h>
+#include <utils/List.h>
+
+// Camera dependencies
+#include "hardware/camera3.h"
+
+namespace qcamera {
+
+typedef int64_t nsecs_t;
+
+// Ring slots of the frame number index, twice MAX_INFLIGHT_HFR_REQUESTS
+#define QCAMERA3_FRAME_INDEX_SLOTS 128
+// Buckets and ways of the buffer handle index
+#define QCAMERA3_BUFFER_INDEX_BUCKETS 64
+#define QCAMERA3_BUFFER_INDEX_WAYS 4
+
+// Index of in-flight requests by frame number. Frame numbers of in-flight
+// requests fall in a narrow window, so the index is a ring keyed by
+// frame_number modulo the ring size. An entry whose slot is taken by another
+// live frame is not indexed; while any such entry is live a miss is not
+// final and callers fall back to scanning their own list. The owner's list
+// stays the source of truth, every add and remove must be mirrored here.
+template <class T> class QCamera3FrameIndex {
+public:
+    QCamera3FrameIndex() { clear(); }
+
+    void add(uint32_t frame, const T &val)
+    {
+        Slot &s = mSlots[frame & (QCAMERA3_FRAME_INDEX_SLOTS - 1)];
+        if (s.valid) {
+            mUnindexed++;
+            return;
+        }
+        s.frame = frame;
+        s.val = val;
+        s.valid = true;
+    }
+
+    // val tells the indexed entry apart from an unindexed one of the same
+    // frame number
+    void remove(uint32_t frame, const T &val)
+    {
+        Slot &s = mSlots[frame & (QCAMERA3_FRAME_INDEX_SLOTS - 1)];
+        if (s.valid && (s.frame == frame) && (s.val == val)) {
+            s.valid = false;
+        } else if (mUnindexed > 0) {
+            mUnindexed--;
+        }
+    }
+
+    bool find(uint32_t frame, T &val) const
+    {
+        const Slot &s = mSlots[frame & (QCAMERA3_FRAME_INDEX_SLOTS - 1)];
+        if (s.valid && (s.frame == frame)) {
+            val = s.val;
+            return true;
+        }
+        return false;
+    }
+
+    // True when every live entry is indexed, so a miss in find() is final
+    bool isComplete() const { return (mUnindexed == 0); }
+
+    // Entry of frame in the owner's list, or list.end(). The list is only
+    // scanned when the index is not complete.
+    template <class L> T lookup(uint32_t frame, L &list) const
+    {
+        T i;
+        if (find(frame, i)) {
+            return i;
+        }
+        if (isComplete()) {
+            return list.end();
+        }
+        for (i = list.begin(); i != list.end(); i++) {
+            if (i->frame_number == frame) {
+                break;
+            }
+        }
+        return i;
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < QCAMERA3_FRAME_INDEX_SLOTS; i++) {
+            mSlots[i].valid = false;
+        }
+        mUnindexed = 0;
+    }
+
+private:
+    typedef struct {
+        uint32_t frame;
+        bool valid;
+        T val;
+    } Slot;
+
+    Slot mSlots[QCAMERA3_FRAME_INDEX_SLOTS];
+    uint32_t mUnindexed;
+};
+
+// Hint cache from buffer handle to a caller defined value, e.g. the slot of
+// a buffer in a buffer array. Each
+// handle hashes to one bucket of a few ways, a full bucket evicts its oldest
+// way. Entries can be stale or evicted, callers check a hit against their
+// own bookkeeping and scan it on a miss.
+class QCamera3BufferIndex {
+public:
+    QCamera3BufferIndex();
+
+    void add(const void *handle, uint32_t val);
+    void remove(const void *handle);
+    bool find(const void *handle, uint32_t &val) const;
+    void clear();
+
+private:
+    typedef struct {
+        const void *handle;
+        uint32_t val;
+    } Way;
+
+    static uint32_t bucketOf(const void *handle);
+
+    Way mWays[QCAMERA3_BUFFER_INDEX_BUCKETS][QCAMERA3_BUFFER_INDEX_WAYS];
+    uint8_t mNextVictim[QCAMERA3_BUFFER_INDEX_BUCKETS];
+};
+
+typedef struct {
+    // Stream handle
+    camera3_stream_t *stream;
+    // Buffer handle
+    buffer_handle_t *buffer;
+    // Buffer status
+    camera3_buffer_status_t bufStatus = CAMERA3_BUFFER_STATUS_OK;
+} PendingBufferInfo;
+
+typedef struct {
+    // Frame number corresponding to request
+    uint32_t frame_number;
+    // Time when request queued into system
+    nsecs_t timestamp;
+    android::List<PendingBufferInfo> mPendingBufferList;
+} PendingBuffersInRequest;
+
+class PendingBuffersMap {
+public:
+    // Number of outstanding buffers at flush
+    uint32_t numPendingBufsAtFlush;
+    // List of pending buffers per request
+    android::List<PendingBuffersInRequest> mPendingBuffersInRequest;
+    uint32_t get_num_overall_buffers();
+    void addRequest(const PendingBuffersInRequest &request);
+    android::List<PendingBuffersInRequest>::iterator eraseRequest(
+            android::List<PendingBuffersInRequest>::iterator req);
+    void clear();
+    void removeBuf(buffer_handle_t *buffer);
+    int32_t getBufErrStatus(buffer_handle_t *buffer);
+private:
+    android::List<PendingBuffersInRequest>::iterator findBuf(
+            buffer_handle_t *buffer,
+            android::List<PendingBufferInfo>::iterator &bufIt);
+};
+
+}; // namespace qcamera
+
+#endif /* __QCAMERA3_INFLIGHT_TRACKER_H__ */
@@ -912,6 +912,7 @@ int QCamera3GrallocMemory::registerBuffer(buffer_handle_t *buffer,
     }
 
     mBufferHandle[idx] = buffer;
+    mBufferIndex.add(buffer, (uint32_t)idx);
     mPrivateHandle[idx] = (struct private_handle_t *)(*mBufferHandle[idx]);
 
     setMetaData(mPrivateHandle[idx], UPDATE_COLOR_SPACE, &colorSpace);
@@ -1012,6 +1013,7 @@ int32_t QCamera3GrallocMemory::unregisterBufferLocked(size_t idx)
 #endif  // TARGET_ION_ABI_VERSION
     memset(&mMemInfo[idx], 0, sizeof(struct QCamera3MemInfo));
     mMemInfo[idx].main_ion_fd = -1;
+    mBufferIndex.remove(mBufferHandle[idx]);
     mBufferHandle[idx] = NULL;
     mPrivateHandle[idx] = NULL;
     mCurrentFrameNumbers[idx] = -1;
@@ -1295,10 +1297,15 @@ int QCamera3GrallocMemory::getMatchBufIndex(void *object)
     Mutex::Autolock lock(mLock);
 
     int index = -1;
+    uint32_t hint;
     buffer_handle_t *key = (buffer_handle_t*) object;
     if (!key) {
         return BAD_VALUE;
     }
+    if (mBufferIndex.find(key, hint) && (hint >= mStartIdx) &&
+            (hint < MM_CAMERA_MAX_NUM_FRAMES) && (mBufferHandle[hint] == key)) {
+        return (int)hint;
+    }
     for (uint32_t i = mStartIdx; i < MM_CAMERA_MAX_NUM_FRAMES; i++) {
         if (mBufferHandle[i] == key) {
             index = (int)i;
@@ -40,6 +40,7 @@
 
 // Camera dependencies
 #include "hardware/camera3.h"
+#include "QCamera3InflightTracker.h"
 
 extern "C" {
 #include "mm_camera_interface.h"
@@ -172,6 +173,8 @@ private:
     int32_t unregisterBufferLocked(size_t idx);
     int32_t getFreeIndexLocked();
     buffer_handle_t *mBufferHandle[MM_CAMERA_MAX_NUM_FRAMES];
+    // Slot of each registered buffer handle, a lookup hint
+    QCamera3BufferIndex mBufferIndex;
     struct private_handle_t *mPrivateHandle[MM_CAMERA_MAX_NUM_FRAMES];
 
     uint32_t mStartIdx;
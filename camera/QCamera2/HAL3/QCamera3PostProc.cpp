@@ -40,6 +40,7 @@
 #include "QCamera3HWI.h"
 #include "QCamera3PostProc.h"
 #include "QCamera3Stream.h"
+#include "QCameraSuperBufPool.h"
 #include "QCameraTrace.h"
 #include "QCameraPprocManager.h"
 #include "QCameraMem.h"
@@ -1398,13 +1399,14 @@ int32_t QCamera3PostProcessor::processPPData(mm_camera_super_buf_t *frame,
         if (job->fwk_src_frame != NULL) {
             LOGD("reprocess for fwk input frame.");
             if (p_metadata != NULL) {
-                memcpy(job->fwk_src_frame->metadata_buffer.buffer, p_metadata,
-                            sizeof(metadata_buffer_t));
+                mm_camera_meta_copy(
+                        (metadata_buffer_t *)job->fwk_src_frame->metadata_buffer.buffer,
+                        p_metadata);
             }
         } else if (job->src_frame != NULL) {
             LOGD("reprocess for non-fwk input frame.");
             if (p_metadata != NULL && job->metadata != NULL) {
-                memcpy(job->metadata, p_metadata, sizeof(metadata_buffer_t));
+                mm_camera_meta_copy(job->metadata, p_metadata);
             }
         }
 
@@ -1436,7 +1438,7 @@ int32_t QCamera3PostProcessor::processPPData(mm_camera_super_buf_t *frame,
     }
     if (p_metadata != NULL) {
         // update metadata content with input buffer
-        memcpy(jpeg_job->metadata, p_metadata, sizeof(metadata_buffer_t));
+        mm_camera_meta_copy(jpeg_job->metadata, p_metadata);
     }
     jpeg_job->src_metadata = job->src_metadata;
     jpeg_job->jpeg_settings = job->jpeg_settings;
@@ -1453,7 +1455,7 @@ int32_t QCamera3PostProcessor::processPPData(mm_camera_super_buf_t *frame,
                 break;
             }
         }
-        free(job->reprocessed_src_frame);
+        QCameraSuperBufPool::getInstance()->release(job->reprocessed_src_frame);
         job->reprocessed_src_frame = NULL;
     }
 
@@ -1562,7 +1564,7 @@ void QCamera3PostProcessor::releasePPInputData(void *data, void *user_data)
         if (NULL != buf) {
             if (buf->input) {
                 pme->releaseSuperBuf(buf->input);
-                free(buf->input);
+                QCameraSuperBufPool::getInstance()->release(buf->input);
                 buf->input = NULL;
             }
         }
@@ -1719,7 +1721,7 @@ void QCamera3PostProcessor::releaseJpegJobData(qcamera_hal3_jpeg_data_t *job)
     LOGD("E");
     if (NULL != job) {
         if (NULL != job->src_reproc_frame) {
-            free(job->src_reproc_frame);
+            QCameraSuperBufPool::getInstance()->release(job->src_reproc_frame);
             job->src_reproc_frame = NULL;
         }
 
@@ -1754,7 +1756,7 @@ void QCamera3PostProcessor::releaseJpegJobData(qcamera_hal3_jpeg_data_t *job)
                 }
             }
 
-            free(job->src_frame);
+            QCameraSuperBufPool::getInstance()->release(job->src_frame);
             job->src_frame = NULL;
         }
 
@@ -1763,7 +1765,7 @@ void QCamera3PostProcessor::releaseJpegJobData(qcamera_hal3_jpeg_data_t *job)
             job->fwk_src_buffer = NULL;
         } else if (NULL != job->src_metadata) {
             m_parent->metadataBufDone(job->src_metadata);
-            free(job->src_metadata);
+            QCameraSuperBufPool::getInstance()->release(job->src_metadata);
             job->src_metadata = NULL;
         }
 
@@ -1807,10 +1809,10 @@ void QCamera3PostProcessor::releasePPJobData(qcamera_hal3_pp_data_t *pp_job)
     LOGD("E");
     if (NULL != pp_job) {
         if (NULL != pp_job->src_frame) {
-            free(pp_job->src_frame);
+            QCameraSuperBufPool::getInstance()->release(pp_job->src_frame);
             if (NULL != pp_job->src_metadata) {
                 m_parent->metadataBufDone(pp_job->src_metadata);
-                free(pp_job->src_metadata);
+                QCameraSuperBufPool::getInstance()->release(pp_job->src_metadata);
             }
             pp_job->src_frame = NULL;
             pp_job->metadata = NULL;
@@ -2291,6 +2293,8 @@ int32_t QCamera3PostProcessor::encodeFWKData(qcamera_hal3_jpeg_data_t *jpeg_job_
     }
 
     jpg_job.encode_job.hal_version = CAM_HAL_V3;
+    // Framework reprocess goes after snapshots of the ongoing capture
+    jpg_job.encode_job.priority = MM_JPEG_JOB_PRIO_REPROCESS;
 
     //Start jpeg encoding
     ret = mJpegHandle.start_job(&jpg_job, &jobId);
@@ -2306,6 +2310,43 @@ int32_t QCamera3PostProcessor::encodeFWKData(qcamera_hal3_jpeg_data_t *jpeg_job_
     return ret;
 }
 
+/*===========================================================================
+ * FUNCTION   : getJobPriority
+ *
+ * DESCRIPTION: scheduling class of an encode job, by the stream its main
+ *              image comes from. Snapshot frames, from the picture channel
+ *              or reprocessed, are snapshot jobs. Frames reprocessed from a
+ *              preview, callback or video stream are callback jobs.
+ *              Framework reprocess jobs are classed in encodeFWKData.
+ *
+ * PARAMETERS :
+ *   @main_stream : stream of the main image
+ *
+ * RETURN     : priority class of the job
+ *==========================================================================*/
+mm_jpeg_job_prio_t QCamera3PostProcessor::getJobPriority(QCamera3Stream *main_stream)
+{
+    cam_stream_info_t *info = main_stream->getStreamInfo();
+    if ((info == NULL) || (info->stream_type != CAM_STREAM_TYPE_OFFLINE_PROC)) {
+        return MM_JPEG_JOB_PRIO_SNAPSHOT;
+    }
+
+    cam_stream_type_t input_type = CAM_STREAM_TYPE_DEFAULT;
+    if (info->reprocess_config.pp_type == CAM_OFFLINE_REPROCESS_TYPE) {
+        input_type = info->reprocess_config.offline.input_type;
+    } else {
+        input_type = info->reprocess_config.online.input_stream_type;
+    }
+    switch (input_type) {
+    case CAM_STREAM_TYPE_PREVIEW:
+    case CAM_STREAM_TYPE_CALLBACK:
+    case CAM_STREAM_TYPE_VIDEO:
+        return MM_JPEG_JOB_PRIO_CALLBACK;
+    default:
+        return MM_JPEG_JOB_PRIO_SNAPSHOT;
+    }
+}
+
 /*===========================================================================
  * FUNCTION   : encodeData
  *
@@ -2614,6 +2655,8 @@ int32_t QCamera3PostProcessor::encodeData(qcamera_hal3_jpeg_data_t *jpeg_job_dat
         jpg_job.encode_job.main_dim.crop = crop;
     }
 
+    jpg_job.encode_job.priority = getJobPriority(main_stream);
+
     // get 3a sw version info
     cam_q3a_version_t sw_version;
     memset(&sw_version, 0, sizeof(sw_version));
@@ -2994,7 +3037,7 @@ void *QCamera3PostProcessor::dataProcessRoutine(void *data)
                     if (NULL != pp_buf) {
                         if (pp_buf->input) {
                             pme->releaseSuperBuf(pp_buf->input);
-                            free(pp_buf->input);
+                            QCameraSuperBufPool::getInstance()->release(pp_buf->input);
                             pp_buf->input = NULL;
                         }
                         if(pme->m_pReprocChannel[0] != NULL)
@@ -3066,7 +3109,7 @@ void *QCamera3PostProcessor::dataProcessRoutine(void *data)
                     if (pp_buffer != NULL) {
                         if (pp_buffer->input) {
                             pme->releaseSuperBuf(pp_buffer->input);
-                            free(pp_buffer->input);
+                            QCameraSuperBufPool::getInstance()->release(pp_buffer->input);
                         }
                         free(pp_buffer);
                     }
@@ -3075,7 +3118,7 @@ void *QCamera3PostProcessor::dataProcessRoutine(void *data)
                         if(NULL != meta_pp_buffer->metabuf)
                         {
                             pme->m_parent->metadataBufDone(meta_pp_buffer->metabuf);
-                            free(meta_pp_buffer->metabuf);
+                            QCameraSuperBufPool::getInstance()->release(meta_pp_buffer->metabuf);
                         }
                         free(meta_pp_buffer);
                     }
@@ -3350,14 +3393,14 @@ void *QCamera3PostProcessor::dataProcessRoutine(void *data)
                             if (pp_buffer != NULL) {
                                 if (pp_buffer->input) {
                                     pme->releaseSuperBuf(pp_buffer->input);
-                                    free(pp_buffer->input);
+                                    QCameraSuperBufPool::getInstance()->release(pp_buffer->input);
                                 }
                                 free(pp_buffer);
                             }
                             //free metadata
                             if (NULL != meta_buffer) {
                                 pme->m_parent->metadataBufDone(meta_buffer);
-                                free(meta_buffer);
+                                QCameraSuperBufPool::getInstance()->release(meta_buffer);
                             }
                         } else {
                             if (pp_buffer != NULL) {
@@ -3384,7 +3427,7 @@ void *QCamera3PostProcessor::dataProcessRoutine(void *data)
                     if (NULL != pp_buf) {
                         if (pp_buf->input) {
                             pme->releaseSuperBuf(pp_buf->input);
-                            free(pp_buf->input);
+                            QCameraSuperBufPool::getInstance()->release(pp_buf->input);
                             pp_buf->input = NULL;
                         }
                         free(pp_buf);
@@ -3393,7 +3436,7 @@ void *QCamera3PostProcessor::dataProcessRoutine(void *data)
                                                             pme->m_inputMetaQ.dequeue();
                     if (metadata != NULL) {
                         pme->m_parent->metadataBufDone(metadata);
-                        free(metadata);
+                        QCameraSuperBufPool::getInstance()->release(metadata);
                     }
                     qcamera_fwk_input_pp_data_t *fwk_frame =
                             (qcamera_fwk_input_pp_data_t *) pme->m_inputFWKPPQ.dequeue();
@@ -200,6 +200,7 @@ private:
                        uint8_t &needNewSess);
     int32_t encodeFWKData(qcamera_hal3_jpeg_data_t *jpeg_job_data,
             uint8_t &needNewSess);
+    static mm_jpeg_job_prio_t getJobPriority(QCamera3Stream *main_stream);
     void releaseSuperBuf(mm_camera_super_buf_t *super_buf);
     static void releaseNotifyData(void *user_data, void *cookie);
     int32_t processRawImageImpl(mm_camera_super_buf_t *recvd_frame);
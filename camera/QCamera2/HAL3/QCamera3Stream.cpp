@@ -32,6 +32,7 @@
 // Camera dependencies
 #include "QCamera3HWI.h"
 #include "QCamera3Stream.h"
+#include "QCameraSuperBufPool.h"
 #include <cutils/properties.h>
 
 extern "C" {
@@ -285,9 +286,10 @@ QCamera3Stream::QCamera3Stream(uint32_t camHandle,
         mStreamInfo(NULL),
         mMemOps(NULL),
         mNumBufs(0),
+        mSuperBufReserved(0),
         mDataCB(NULL),
         mUserData(NULL),
-        mDataQ(releaseFrameData, this),
+        mDataQ(releaseFrameData, this, true),
         mStreamInfoBuf(NULL),
         mStreamBufs(NULL),
         mBufDefs(NULL),
@@ -344,6 +346,8 @@ QCamera3Stream::~QCamera3Stream()
         mCamOps->delete_stream(mCamHandle, mChannelHandle, mHandle);
         mHandle = 0;
     }
+    QCameraSuperBufPool::getInstance()->unreserve(mSuperBufReserved);
+    mSuperBufReserved = 0;
 }
 
 /*===========================================================================
@@ -534,6 +538,10 @@ int32_t QCamera3Stream::init(cam_stream_type_t streamType,
     mDataCB = stream_cb;
     mUserData = userdata;
     mBatchSize = batchSize;
+
+    QCameraSuperBufPool::getInstance()->unreserve(mSuperBufReserved);
+    mSuperBufReserved = mNumBufs;
+    QCameraSuperBufPool::getInstance()->reserve(mSuperBufReserved);
     return 0;
 
 err4:
@@ -653,7 +661,7 @@ int32_t QCamera3Stream::processDataNotify(mm_camera_super_buf_t *frame)
     } else {
         LOGD("Stream thread is not active, no ops here");
         bufDone(frame->bufs[0]->buf_idx);
-        free(frame);
+        QCameraSuperBufPool::getInstance()->release(frame);
         rc = NO_ERROR;
     }
     LOGD("X\n");
@@ -686,7 +694,7 @@ void QCamera3Stream::dataNotifyCB(mm_camera_super_buf_t *recvd_frame,
     }
 
     mm_camera_super_buf_t *frame =
-        (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+        QCameraSuperBufPool::getInstance()->acquire();
     if (frame == NULL) {
         LOGE("No mem for mm_camera_buf_def_t");
         stream->bufDone(recvd_frame->bufs[0]->buf_idx);
@@ -761,7 +769,7 @@ void *QCamera3Stream::dataProcRoutine(void *data)
                     } else {
                         // no data cb routine, return buf here
                         pme->bufDone(frame->bufs[0]->buf_idx);
-                        free(frame);
+                        QCameraSuperBufPool::getInstance()->release(frame);
                     }
                 }
             }
@@ -1421,7 +1429,8 @@ int32_t QCamera3Stream::setParameter(cam_stream_parm_buffer_t &param,  uint32_t
 /*===========================================================================
  * FUNCTION   : releaseFrameData
  *
- * DESCRIPTION: callback function to release frame data node
+ * DESCRIPTION: callback function to release frame data node. Returns the
+ *              stream buffer and the super buf descriptor.
  *
  * PARAMETERS :
  *   @data      : ptr to post process input data
@@ -1444,6 +1453,7 @@ void QCamera3Stream::releaseFrameData(void *data, void *user_data)
             pme->bufDone(frame->bufs[0]->buf_idx);
         }
     }
+    QCameraSuperBufPool::getInstance()->release(frame);
 }
 
 /*===========================================================================
@@ -1783,7 +1793,7 @@ int32_t QCamera3Stream::handleBatchBuffer(mm_camera_super_buf_t *superBuf)
     if (!mFreeBatchBufQ.enqueue((void*) superBuf->bufs[0])) {
         LOGE("batchBuf.buf_idx: %d enqueue failed",
                 batchBuf.buf_idx);
-        free(superBuf);
+        QCameraSuperBufPool::getInstance()->release(superBuf);
         return NO_MEMORY;
     }
     LOGD("Received batch buffer: %d bufs_used: %d",
@@ -1797,7 +1807,7 @@ int32_t QCamera3Stream::handleBatchBuffer(mm_camera_super_buf_t *superBuf)
         buf = mBufDefs[buf_idx];
 
         /* this memory is freed inside dataCB. Should not be freed here */
-        frame = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+        frame = QCameraSuperBufPool::getInstance()->acquire();
         if (!frame) {
             LOGE("malloc failed. Buffers will be dropped");
             break;
@@ -1811,7 +1821,7 @@ int32_t QCamera3Stream::handleBatchBuffer(mm_camera_super_buf_t *superBuf)
     LOGD("batch buffer: %d callbacks done",
             batchBuf.buf_idx);
 
-    free(superBuf);
+    QCameraSuperBufPool::getInstance()->release(superBuf);
     return rc;
 }
 
@@ -1819,7 +1829,7 @@ int32_t QCamera3Stream::handleBatchBuffer(mm_camera_super_buf_t *superBuf)
  * FUNCTION   : flushFreeBatchBufQ
  *
  * DESCRIPTION: dequeue all the entries of mFreeBatchBufQ and call flush.
- *              QCameraQueue::flush calls 'free(node->data)' which should be
+ *              QCameraQueue::flush releases 'node->data' which should be
  *              avoided for mFreeBatchBufQ as the entries are not allocated
  *              during each enqueue
  *
@@ -116,6 +116,7 @@ private:
     mm_camera_stream_mem_vtbl_t mMemVtbl;
     mm_camera_map_unmap_ops_tbl_t *mMemOps;
     uint8_t mNumBufs;
+    uint8_t mSuperBufReserved; // descriptors reserved in QCameraSuperBufPool
     hal3_stream_cb_routine mDataCB;
     void *mUserData;
 
@@ -930,279 +930,289 @@ typedef struct {
 } custom_parm_buffer_t;
 
 
-typedef struct {
-/**************************************************************************************
+/* List of all metadata entries, expanded with ENTRY(ID, DATATYPE, COUNT).
+ * NO_ID marks members whose name has no cam_intf_parm_type_t value; they
+ * only take up room in the layout. metadata_data_t lays out one member per
+ * entry in this order, and the sparse copy helpers use it to find each
+ * entry's offset and size.
+ **************************************************************************************
  *  ID from (cam_intf_metadata_type_t)                DATATYPE                     COUNT
  **************************************************************************************/
-    /* common between HAL1 and HAL3 */
-    INCLUDE(CAM_INTF_META_HISTOGRAM,                    cam_hist_stats_t,               1);
-    INCLUDE(CAM_INTF_META_FACE_DETECTION,               cam_face_detection_data_t,      1);
-    INCLUDE(CAM_INTF_META_FACE_RECOG,                   cam_face_recog_data_t,          1);
-    INCLUDE(CAM_INTF_META_FACE_BLINK,                   cam_face_blink_data_t,          1);
-    INCLUDE(CAM_INTF_META_FACE_GAZE,                    cam_face_gaze_data_t,           1);
-    INCLUDE(CAM_INTF_META_FACE_SMILE,                   cam_face_smile_data_t,          1);
-    INCLUDE(CAM_INTF_META_FACE_LANDMARK,                cam_face_landmarks_data_t,      1);
-    INCLUDE(CAM_INTF_META_FACE_CONTOUR,                 cam_face_contour_data_t,        1);
-    INCLUDE(CAM_INTF_META_AUTOFOCUS_DATA,               cam_auto_focus_data_t,          1);
-    INCLUDE(CAM_INTF_META_CDS_DATA,                     cam_cds_data_t,                 1);
-    INCLUDE(CAM_INTF_PARM_UPDATE_DEBUG_LEVEL,           uint32_t,                       1);
-
-    /* Specific to HAl1 */
-    INCLUDE(CAM_INTF_META_CROP_DATA,                    cam_crop_data_t,                1);
-    INCLUDE(CAM_INTF_META_PREP_SNAPSHOT_DONE,           int32_t,                        1);
-    INCLUDE(CAM_INTF_META_GOOD_FRAME_IDX_RANGE,         cam_frame_idx_range_t,          1);
-    INCLUDE(CAM_INTF_META_ASD_HDR_SCENE_DATA,           cam_asd_hdr_scene_data_t,       1);
-    INCLUDE(CAM_INTF_META_ASD_SCENE_INFO,               cam_asd_decision_t,             1);
-    INCLUDE(CAM_INTF_META_CURRENT_SCENE,                cam_scene_mode_type,            1);
-    INCLUDE(CAM_INTF_META_AWB_INFO,                     cam_awb_params_t,               1);
-    INCLUDE(CAM_INTF_META_FOCUS_POSITION,               cam_focus_pos_info_t,           1);
-    INCLUDE(CAM_INTF_META_CHROMATIX_LITE_ISP,           cam_chromatix_lite_isp_t,       1);
-    INCLUDE(CAM_INTF_META_CHROMATIX_LITE_PP,            cam_chromatix_lite_pp_t,        1);
-    INCLUDE(CAM_INTF_META_CHROMATIX_LITE_AE,            cam_chromatix_lite_ae_stats_t,  1);
-    INCLUDE(CAM_INTF_META_CHROMATIX_LITE_AWB,           cam_chromatix_lite_awb_stats_t, 1);
-    INCLUDE(CAM_INTF_META_CHROMATIX_LITE_AF,            cam_chromatix_lite_af_stats_t,  1);
-    INCLUDE(CAM_INTF_META_CHROMATIX_LITE_ASD,           cam_chromatix_lite_asd_stats_t, 1);
-    INCLUDE(CAM_INTF_BUF_DIVERT_INFO,                   cam_buf_divert_info_t,          1);
-
-    /* Specific to HAL3 */
-    INCLUDE(CAM_INTF_META_FRAME_NUMBER_VALID,           int32_t,                     1);
-    INCLUDE(CAM_INTF_META_URGENT_FRAME_NUMBER_VALID,    int32_t,                     1);
-    INCLUDE(CAM_INTF_META_FRAME_DROPPED,                cam_stream_ID_t,             1);
-    INCLUDE(CAM_INTF_META_FRAME_NUMBER,                 uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_URGENT_FRAME_NUMBER,          uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_COLOR_CORRECT_MODE,           uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_COLOR_CORRECT_TRANSFORM,      cam_color_correct_matrix_t,  1);
-    INCLUDE(CAM_INTF_META_COLOR_CORRECT_GAINS,          cam_color_correct_gains_t,   1);
-    INCLUDE(CAM_INTF_META_PRED_COLOR_CORRECT_TRANSFORM, cam_color_correct_matrix_t,  1);
-    INCLUDE(CAM_INTF_META_PRED_COLOR_CORRECT_GAINS,     cam_color_correct_gains_t,   1);
-    INCLUDE(CAM_INTF_META_AEC_ROI,                      cam_area_t,                  1);
-    INCLUDE(CAM_INTF_META_AEC_STATE,                    uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_FOCUS_MODE,                   uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_MANUAL_FOCUS_POS,             cam_manual_focus_parm_t,     1);
-    INCLUDE(CAM_INTF_META_AF_ROI,                       cam_area_t,                  1);
-    INCLUDE(CAM_INTF_META_AF_DEFAULT_ROI,               cam_rect_t,                  1);
-    INCLUDE(CAM_INTF_META_AF_STATE,                     uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_WHITE_BALANCE,                int32_t,                     1);
-    INCLUDE(CAM_INTF_META_AWB_REGIONS,                  cam_area_t,                  1);
-    INCLUDE(CAM_INTF_META_AWB_STATE,                    uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_AWB_CONVERGENCE_SPEED,        float,                       1);
-    INCLUDE(CAM_INTF_META_BLACK_LEVEL_LOCK,             uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_MODE,                         uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_EDGE_MODE,                    cam_edge_application_t,      1);
-    INCLUDE(CAM_INTF_META_FLASH_POWER,                  uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_FLASH_FIRING_TIME,            int64_t,                     1);
-    INCLUDE(CAM_INTF_META_FLASH_MODE,                   uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_FLASH_STATE,                  int32_t,                     1);
-    INCLUDE(CAM_INTF_META_HOTPIXEL_MODE,                uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_LENS_APERTURE,                float,                       1);
-    INCLUDE(CAM_INTF_META_LENS_FILTERDENSITY,           float,                       1);
-    INCLUDE(CAM_INTF_META_LENS_FOCAL_LENGTH,            float,                       1);
-    INCLUDE(CAM_INTF_META_LENS_FOCUS_DISTANCE,          float,                       1);
-    INCLUDE(CAM_INTF_META_FOCUS_VALUE,                  float,                       1);
-    INCLUDE(CAM_INTF_META_SPOT_LIGHT_DETECT,            uint8_t,                     1);
-    INCLUDE(CAM_INTF_META_LENS_FOCUS_RANGE,             float,                       2);
-    INCLUDE(CAM_INTF_META_LENS_STATE,                   cam_af_lens_state_t,         1);
-    INCLUDE(CAM_INTF_META_LENS_OPT_STAB_MODE,           cam_ois_mode_t,              1);
-    INCLUDE(CAM_INTF_META_VIDEO_STAB_MODE,              uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_LENS_FOCUS_STATE,             uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_NOISE_REDUCTION_MODE,         uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_NOISE_REDUCTION_STRENGTH,     uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_SCALER_CROP_REGION,           cam_crop_region_t,           1);
-    INCLUDE(CAM_INTF_META_SCENE_FLICKER,                uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_SENSOR_EXPOSURE_TIME,         int64_t,                     1);
-    INCLUDE(CAM_INTF_META_SENSOR_FRAME_DURATION,        int64_t,                     1);
-    INCLUDE(CAM_INTF_META_SENSOR_SENSITIVITY,           int32_t,                     1);
-    INCLUDE(CAM_INTF_META_ISP_SENSITIVITY ,             int32_t,                     1);
-    INCLUDE(CAM_INTF_META_SENSOR_TIMESTAMP,             int64_t,                     1);
-    INCLUDE(CAM_INTF_META_SENSOR_ROLLING_SHUTTER_SKEW,  int64_t,                     1);
-    INCLUDE(CAM_INTF_META_SHADING_MODE,                 uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_STATS_FACEDETECT_MODE,        uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_STATS_HISTOGRAM_MODE,         uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_STATS_SHARPNESS_MAP_MODE,     uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_STATS_SHARPNESS_MAP,          cam_sharpness_map_t,         3);
-    INCLUDE(CAM_INTF_META_TONEMAP_CURVES,               cam_rgb_tonemap_curves,      1);
-    INCLUDE(CAM_INTF_META_LENS_SHADING_MAP,             cam_lens_shading_map_t,      1);
-    INCLUDE(CAM_INTF_META_AEC_INFO,                     cam_3a_params_t,             1);
-    INCLUDE(CAM_INTF_META_SENSOR_INFO,                  cam_sensor_params_t,         1);
-    INCLUDE(CAM_INTF_META_EXIF_DEBUG_AE,                cam_ae_exif_debug_t,         1);
-    INCLUDE(CAM_INTF_META_EXIF_DEBUG_AWB,               cam_awb_exif_debug_t,        1);
-    INCLUDE(CAM_INTF_META_EXIF_DEBUG_AF,                cam_af_exif_debug_t,         1);
-    INCLUDE(CAM_INTF_META_EXIF_DEBUG_ASD,               cam_asd_exif_debug_t,        1);
-    INCLUDE(CAM_INTF_META_EXIF_DEBUG_STATS,             cam_stats_buffer_exif_debug_t,   1);
-    INCLUDE(CAM_INTF_META_EXIF_DEBUG_BESTATS,           cam_bestats_buffer_exif_debug_t, 1);
-    INCLUDE(CAM_INTF_META_EXIF_DEBUG_BHIST,             cam_bhist_buffer_exif_debug_t,   1);
-    INCLUDE(CAM_INTF_META_EXIF_DEBUG_3A_TUNING,         cam_q3a_tuning_info_t,       1);
-    INCLUDE(CAM_INTF_META_ASD_SCENE_CAPTURE_TYPE,       cam_auto_scene_t,            1);
-    INCLUDE(CAM_INTF_PARM_EFFECT,                       uint32_t,                    1);
-    /* Defining as int32_t so that this array is 4 byte aligned */
-    INCLUDE(CAM_INTF_META_PRIVATE_DATA,                 int32_t,
-            MAX_METADATA_PRIVATE_PAYLOAD_SIZE_IN_BYTES / 4);
-
-    /* Following are Params only and not metadata currently */
-    INCLUDE(CAM_INTF_PARM_HAL_VERSION,                  int32_t,                     1);
-    /* Shared between HAL1 and HAL3 */
-    INCLUDE(CAM_INTF_PARM_ANTIBANDING,                  uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_EXPOSURE_COMPENSATION,        int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_EV_STEP,                      cam_rational_type_t,         1);
-    INCLUDE(CAM_INTF_PARM_AEC_LOCK,                     uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_FPS_RANGE,                    cam_fps_range_t,             1);
-    INCLUDE(CAM_INTF_PARM_AWB_LOCK,                     uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_BESTSHOT_MODE,                uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_DIS_ENABLE,                   int32_t,                     1);
-
-    INCLUDE(XIAOMI_01,                                  uint8_t,                     1);
-    
-    INCLUDE(CAM_INTF_PARM_LED_MODE,                     int32_t,                     1);
-    INCLUDE(CAM_INTF_META_LED_MODE_OVERRIDE,            uint32_t,                    1);
-
-    /* dual camera specific params */
-    INCLUDE(CAM_INTF_PARM_RELATED_SENSORS_CALIBRATION,  cam_related_system_calibration_data_t, 1);
-    INCLUDE(CAM_INTF_META_AF_FOCAL_LENGTH_RATIO,        cam_focal_length_ratio_t, 1);
-    INCLUDE(CAM_INTF_META_SNAP_CROP_INFO_SENSOR,        cam_stream_crop_info_t,   1);
-    INCLUDE(CAM_INTF_META_SNAP_CROP_INFO_CAMIF,         cam_stream_crop_info_t,   1);
-    INCLUDE(CAM_INTF_META_SNAP_CROP_INFO_ISP,           cam_stream_crop_info_t,   1);
-    INCLUDE(CAM_INTF_META_SNAP_CROP_INFO_CPP,           cam_stream_crop_info_t,   1);
-    INCLUDE(CAM_INTF_META_DCRF,                         cam_dcrf_result_t,        1);
-    INCLUDE(CAM_INTF_PARM_SYNC_DC_PARAMETERS,           uint32_t,                  1);
-    INCLUDE(CAM_INTF_META_AF_FOCUS_POS,                 cam_af_focus_pos_t, 1);
-
-    /* HAL1 specific */
-    /* read only */
-    INCLUDE(CAM_INTF_PARM_QUERY_FLASH4SNAP,             int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_EXPOSURE,                     int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_SHARPNESS,                    int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_CONTRAST,                     int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_SATURATION,                   int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_BRIGHTNESS,                   int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_ISO,                          cam_intf_parm_manual_3a_t,   1);
-    INCLUDE(CAM_INTF_PARM_EXPOSURE_TIME,                cam_intf_parm_manual_3a_t,   1);
-    INCLUDE(CAM_INTF_PARM_USERZOOM,                     cam_zoom_info_t,             1);
-    INCLUDE(CAM_INTF_PARM_ROLLOFF,                      int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_MODE,                         int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_AEC_ALGO_TYPE,                int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_FOCUS_ALGO_TYPE,              int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_AEC_ROI,                      cam_set_aec_roi_t,           1);
-    INCLUDE(CAM_INTF_PARM_AF_ROI,                       cam_roi_info_t,              1);
-    INCLUDE(CAM_INTF_PARM_SCE_FACTOR,                   int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_FD,                           cam_fd_set_parm_t,           1);
-    INCLUDE(CAM_INTF_PARM_MCE,                          int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_HFR,                          int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_REDEYE_REDUCTION,             int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_WAVELET_DENOISE,              cam_denoise_param_t,         1);
-    INCLUDE(CAM_INTF_PARM_TEMPORAL_DENOISE,             cam_denoise_param_t,         1);
-    INCLUDE(CAM_INTF_PARM_HISTOGRAM,                    int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_ASD_ENABLE,                   int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_RECORDING_HINT,               int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_HDR,                          cam_exp_bracketing_t,        1);
-    INCLUDE(CAM_INTF_PARM_FRAMESKIP,                    int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_ZSL_MODE,                     int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_HDR_NEED_1X,                  int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_LOCK_CAF,                     int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_VIDEO_HDR,                    int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_SENSOR_HDR,                   cam_sensor_hdr_type_t,       1);
-    INCLUDE(CAM_INTF_PARM_VT,                           int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_SET_AUTOFOCUSTUNING,          tune_actuator_t,             1);
-    INCLUDE(CAM_INTF_PARM_SET_VFE_COMMAND,              tune_cmd_t,                  1);
-    INCLUDE(CAM_INTF_PARM_SET_PP_COMMAND,               tune_cmd_t,                  1);
-    INCLUDE(CAM_INTF_PARM_MAX_DIMENSION,                cam_dimension_t,             1);
-    INCLUDE(CAM_INTF_PARM_RAW_DIMENSION,                cam_sensor_config_t,         1);
-    INCLUDE(CAM_INTF_PARM_TINTLESS,                     int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_WB_MANUAL,                    cam_manual_wb_parm_t,        1);
-    INCLUDE(CAM_INTF_PARM_CDS_MODE,                     int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_EZTUNE_CMD,                   cam_eztune_cmd_data_t,       1);
-    INCLUDE(CAM_INTF_PARM_INT_EVT,                      cam_int_evt_params_t,        1);
-    INCLUDE(CAM_INTF_PARM_RDI_MODE,                     int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_BURST_NUM,                    uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_RETRO_BURST_NUM,              uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_BURST_LED_ON_PERIOD,          uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_LONGSHOT_ENABLE,              int8_t,                      1);
-    INCLUDE(CAM_INTF_PARM_TONE_MAP_MODE,                uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_TOUCH_AE_RESULT,              int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_DUAL_LED_CALIBRATION,         int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_ADV_CAPTURE_MODE,             uint8_t,                     1);
-    INCLUDE(CAM_INTF_PARM_QUADRA_CFA,                   int32_t,                     1);
-    INCLUDE(CAM_INTF_META_RAW,                          cam_dimension_t,             1);
-    INCLUDE(CAM_INTF_META_STREAM_INFO_FOR_PIC_RES,      cam_stream_size_info_t,      1);
-    INCLUDE(CAM_INTF_PARM_VFE1_RESERVED_RDI,            int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_SKIP_FINE_SCAN,               int32_t,                     1);
-
-    /* HAL3 specific */
-    INCLUDE(CAM_INTF_META_STREAM_INFO,                  cam_stream_size_info_t,      1);
-    INCLUDE(CAM_INTF_META_AEC_MODE,                     uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_AEC_CONVERGENCE_SPEED,        float,                       1);
-    INCLUDE(CAM_INTF_META_AEC_PRECAPTURE_TRIGGER,       cam_trigger_t,               1);
-    INCLUDE(CAM_INTF_META_AF_TRIGGER,                   cam_trigger_t,               1);
-    INCLUDE(CAM_INTF_META_CAPTURE_INTENT,               uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_DEMOSAIC,                     int32_t,                     1);
-    INCLUDE(CAM_INTF_META_SHARPNESS_STRENGTH,           int32_t,                     1);
-    INCLUDE(CAM_INTF_META_GEOMETRIC_MODE,               uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_GEOMETRIC_STRENGTH,           uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_LENS_SHADING_MAP_MODE,        uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_SHADING_STRENGTH,             uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_TONEMAP_MODE,                 uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_IR_MODE,                      cam_ir_mode_type_t,          1);
-    INCLUDE(CAM_INTF_META_STREAM_ID,                    cam_stream_ID_t,             1);
-    INCLUDE(CAM_INTF_PARM_STATS_DEBUG_MASK,             uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_STATS_AF_PAAF,                uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_FOCUS_BRACKETING,             cam_af_bracketing_t,         1);
-    INCLUDE(CAM_INTF_PARM_FLASH_BRACKETING,             cam_flash_bracketing_t,      1);
-    INCLUDE(CAM_INTF_META_JPEG_GPS_COORDINATES,         double,                      3);
-    INCLUDE(CAM_INTF_META_JPEG_GPS_PROC_METHODS,        uint8_t,                     GPS_PROCESSING_METHOD_SIZE);
-    INCLUDE(CAM_INTF_META_JPEG_GPS_TIMESTAMP,           int64_t,                     1);
-    INCLUDE(CAM_INTF_META_JPEG_ORIENTATION,             int32_t,                     1);
-    INCLUDE(CAM_INTF_META_JPEG_QUALITY,                 uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_JPEG_THUMB_QUALITY,           uint32_t,                    1);
-    INCLUDE(CAM_INTF_META_JPEG_THUMB_SIZE,              cam_dimension_t,             1);
-    INCLUDE(CAM_INTF_META_TEST_PATTERN_DATA,            cam_test_pattern_data_t,     1);
-    INCLUDE(CAM_INTF_META_PROFILE_TONE_CURVE,           cam_profile_tone_curve,      1);
-    INCLUDE(CAM_INTF_META_OTP_WB_GRGB,                  float,                       1);
-    INCLUDE(CAM_INTF_META_IMG_HYST_INFO,                cam_img_hysterisis_info_t,   1);
-    INCLUDE(CAM_INTF_META_CAC_INFO,                     cam_cac_info_t,              1);
-    INCLUDE(CAM_INTF_PARM_CAC,                          cam_aberration_mode_t,       1);
-    INCLUDE(CAM_INTF_META_NEUTRAL_COL_POINT,            cam_neutral_col_point_t,     1);
-    INCLUDE(CAM_INTF_PARM_ROTATION,                     cam_rotation_info_t,         1);
-    INCLUDE(CAM_INTF_PARM_HW_DATA_OVERWRITE,            cam_hw_data_overwrite_t,     1);
-    INCLUDE(CAM_INTF_META_IMGLIB,                       cam_intf_meta_imglib_t,      1);
-    INCLUDE(CAM_INTF_PARM_CAPTURE_FRAME_CONFIG,         cam_capture_frame_config_t,  1);
-    INCLUDE(CAM_INTF_PARM_CUSTOM,                       custom_parm_buffer_t,        1);
-    INCLUDE(CAM_INTF_PARM_FLIP,                         int32_t,                     1);
-    INCLUDE(CAM_INTF_META_USE_AV_TIMER,                 uint8_t,                     1);
-    INCLUDE(CAM_INTF_META_EFFECTIVE_EXPOSURE_FACTOR,    float,                       1);
-    INCLUDE(CAM_INTF_META_LDAF_EXIF,                    uint32_t,                    2);
-    INCLUDE(CAM_INTF_META_BLACK_LEVEL_SOURCE_PATTERN,   cam_black_level_metadata_t,  1);
-    INCLUDE(CAM_INTF_META_BLACK_LEVEL_APPLIED_PATTERN,  cam_black_level_metadata_t,  1);
-    INCLUDE(CAM_INTF_META_LOW_LIGHT,                    cam_low_light_mode_t,        1);
-    INCLUDE(CAM_INTF_META_IMG_DYN_FEAT,                 cam_dyn_img_data_t,          1);
-    INCLUDE(CAM_INTF_PARM_MANUAL_CAPTURE_TYPE,          cam_manual_capture_type,     1);
-    INCLUDE(CAM_INTF_AF_STATE_TRANSITION,               uint8_t,                     1);
-    INCLUDE(CAM_INTF_PARM_INITIAL_EXPOSURE_INDEX,       uint32_t,                    1);
-    INCLUDE(CAM_INTF_PARM_INSTANT_AEC,                  uint8_t,                     1);
-    INCLUDE(CAM_INTF_META_REPROCESS_FLAGS,              uint8_t,                     1);
-    INCLUDE(CAM_INTF_PARM_JPEG_ENCODE_CROP,             cam_stream_crop_info_t,      1);
-    INCLUDE(CAM_INTF_PARM_JPEG_SCALE_DIMENSION,         cam_dimension_t,             1);
-    INCLUDE(CAM_INTF_META_FOCUS_DEPTH_INFO,             uint8_t,                     1);
-    INCLUDE(CAM_INTF_PARM_HAL_BRACKETING_HDR,           cam_hdr_param_t,             1);
-    INCLUDE(CAM_INTF_META_DC_LOW_POWER_ENABLE,          uint8_t,                     1);
-    INCLUDE(CAM_INTF_META_DC_SAC_OUTPUT_INFO,           cam_sac_output_info_t,       1);
-    INCLUDE(CAM_INTF_META_DC_IN_SNAPSHOT_PP_ZOOM_RANGE, uint8_t,                     1);
-    INCLUDE(CAM_INTF_META_DC_BOKEH_MODE,                uint8_t,                     1);
-    INCLUDE(CAM_INTF_PARM_FOV_COMP_ENABLE,              int32_t,                     1);
-    INCLUDE(CAM_INTF_META_LED_CALIB_RESULT,             int32_t,                     1);
-    INCLUDE(CAM_INTF_PARM_DC_USERZOOM,                  int32_t,                     1);
-    INCLUDE(CAM_INTF_META_AEC_LUX_INDEX,                float,                       1);
-    INCLUDE(CAM_INTF_META_AF_OBJ_DIST_CM,               int32_t,                     1);
-    INCLUDE(CAM_INTF_META_BINNING_CORRECTION_MODE,      cam_binning_correction_mode_t,  1);
-
-    /* HAL1 and HAL3 Dual Camera */
-    INCLUDE(CAM_INTF_META_OIS_READ_DATA,                cam_ois_data_t,              1);
-    INCLUDE(CAM_INTF_PARAM_BOKEH_BLUR_LEVEL,            cam_rtb_blur_info_t,         1);
-    INCLUDE(CAM_INTF_META_RTB_DATA,                     cam_rtb_msg_type_t,          1);
-    INCLUDE(CAM_INTF_META_DC_CAPTURE,                   uint8_t,                     1);
-    INCLUDE(CAM_INTF_PARM_BOKEH_MODE,                   uint8_t,                     1);
-    INCLUDE(CAM_INTF_META_USERZOOM,                     cam_zoom_info_t,             1);
-    INCLUDE(CAM_INTF_META_TUNING_PARAMS,                tuning_params_t,             1);
-    INCLUDE(CAM_INTF_PARM_CLOSE_HINT,                   uint8_t,                     1);
-    INCLUDE(CAM_INTF_META_SEND_IMMEDIATELY,             uint8_t,                     1);
+#define CAM_INTF_METADATA_ENTRIES(ENTRY, NO_ID) \
+    /* common between HAL1 and HAL3 */                                                                         \
+    ENTRY(CAM_INTF_META_HISTOGRAM,                    cam_hist_stats_t,               1)                       \
+    ENTRY(CAM_INTF_META_FACE_DETECTION,               cam_face_detection_data_t,      1)                       \
+    ENTRY(CAM_INTF_META_FACE_RECOG,                   cam_face_recog_data_t,          1)                       \
+    ENTRY(CAM_INTF_META_FACE_BLINK,                   cam_face_blink_data_t,          1)                       \
+    ENTRY(CAM_INTF_META_FACE_GAZE,                    cam_face_gaze_data_t,           1)                       \
+    ENTRY(CAM_INTF_META_FACE_SMILE,                   cam_face_smile_data_t,          1)                       \
+    ENTRY(CAM_INTF_META_FACE_LANDMARK,                cam_face_landmarks_data_t,      1)                       \
+    ENTRY(CAM_INTF_META_FACE_CONTOUR,                 cam_face_contour_data_t,        1)                       \
+    ENTRY(CAM_INTF_META_AUTOFOCUS_DATA,               cam_auto_focus_data_t,          1)                       \
+    ENTRY(CAM_INTF_META_CDS_DATA,                     cam_cds_data_t,                 1)                       \
+    ENTRY(CAM_INTF_PARM_UPDATE_DEBUG_LEVEL,           uint32_t,                       1)                       \
+                                                                                                               \
+    /* Specific to HAl1 */                                                                                     \
+    ENTRY(CAM_INTF_META_CROP_DATA,                    cam_crop_data_t,                1)                       \
+    ENTRY(CAM_INTF_META_PREP_SNAPSHOT_DONE,           int32_t,                        1)                       \
+    ENTRY(CAM_INTF_META_GOOD_FRAME_IDX_RANGE,         cam_frame_idx_range_t,          1)                       \
+    ENTRY(CAM_INTF_META_ASD_HDR_SCENE_DATA,           cam_asd_hdr_scene_data_t,       1)                       \
+    ENTRY(CAM_INTF_META_ASD_SCENE_INFO,               cam_asd_decision_t,             1)                       \
+    ENTRY(CAM_INTF_META_CURRENT_SCENE,                cam_scene_mode_type,            1)                       \
+    ENTRY(CAM_INTF_META_AWB_INFO,                     cam_awb_params_t,               1)                       \
+    ENTRY(CAM_INTF_META_FOCUS_POSITION,               cam_focus_pos_info_t,           1)                       \
+    ENTRY(CAM_INTF_META_CHROMATIX_LITE_ISP,           cam_chromatix_lite_isp_t,       1)                       \
+    ENTRY(CAM_INTF_META_CHROMATIX_LITE_PP,            cam_chromatix_lite_pp_t,        1)                       \
+    ENTRY(CAM_INTF_META_CHROMATIX_LITE_AE,            cam_chromatix_lite_ae_stats_t,  1)                       \
+    ENTRY(CAM_INTF_META_CHROMATIX_LITE_AWB,           cam_chromatix_lite_awb_stats_t, 1)                       \
+    ENTRY(CAM_INTF_META_CHROMATIX_LITE_AF,            cam_chromatix_lite_af_stats_t,  1)                       \
+    ENTRY(CAM_INTF_META_CHROMATIX_LITE_ASD,           cam_chromatix_lite_asd_stats_t, 1)                       \
+    ENTRY(CAM_INTF_BUF_DIVERT_INFO,                   cam_buf_divert_info_t,          1)                       \
+                                                                                                               \
+    /* Specific to HAL3 */                                                                                     \
+    ENTRY(CAM_INTF_META_FRAME_NUMBER_VALID,           int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_URGENT_FRAME_NUMBER_VALID,    int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_FRAME_DROPPED,                cam_stream_ID_t,             1)                          \
+    ENTRY(CAM_INTF_META_FRAME_NUMBER,                 uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_URGENT_FRAME_NUMBER,          uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_COLOR_CORRECT_MODE,           uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_COLOR_CORRECT_TRANSFORM,      cam_color_correct_matrix_t,  1)                          \
+    ENTRY(CAM_INTF_META_COLOR_CORRECT_GAINS,          cam_color_correct_gains_t,   1)                          \
+    ENTRY(CAM_INTF_META_PRED_COLOR_CORRECT_TRANSFORM, cam_color_correct_matrix_t,  1)                          \
+    ENTRY(CAM_INTF_META_PRED_COLOR_CORRECT_GAINS,     cam_color_correct_gains_t,   1)                          \
+    ENTRY(CAM_INTF_META_AEC_ROI,                      cam_area_t,                  1)                          \
+    ENTRY(CAM_INTF_META_AEC_STATE,                    uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_FOCUS_MODE,                   uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_MANUAL_FOCUS_POS,             cam_manual_focus_parm_t,     1)                          \
+    ENTRY(CAM_INTF_META_AF_ROI,                       cam_area_t,                  1)                          \
+    ENTRY(CAM_INTF_META_AF_DEFAULT_ROI,               cam_rect_t,                  1)                          \
+    ENTRY(CAM_INTF_META_AF_STATE,                     uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_WHITE_BALANCE,                int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_AWB_REGIONS,                  cam_area_t,                  1)                          \
+    ENTRY(CAM_INTF_META_AWB_STATE,                    uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_AWB_CONVERGENCE_SPEED,        float,                       1)                          \
+    ENTRY(CAM_INTF_META_BLACK_LEVEL_LOCK,             uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_MODE,                         uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_EDGE_MODE,                    cam_edge_application_t,      1)                          \
+    ENTRY(CAM_INTF_META_FLASH_POWER,                  uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_FLASH_FIRING_TIME,            int64_t,                     1)                          \
+    ENTRY(CAM_INTF_META_FLASH_MODE,                   uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_FLASH_STATE,                  int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_HOTPIXEL_MODE,                uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_LENS_APERTURE,                float,                       1)                          \
+    ENTRY(CAM_INTF_META_LENS_FILTERDENSITY,           float,                       1)                          \
+    ENTRY(CAM_INTF_META_LENS_FOCAL_LENGTH,            float,                       1)                          \
+    ENTRY(CAM_INTF_META_LENS_FOCUS_DISTANCE,          float,                       1)                          \
+    ENTRY(CAM_INTF_META_FOCUS_VALUE,                  float,                       1)                          \
+    ENTRY(CAM_INTF_META_SPOT_LIGHT_DETECT,            uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_META_LENS_FOCUS_RANGE,             float,                       2)                          \
+    ENTRY(CAM_INTF_META_LENS_STATE,                   cam_af_lens_state_t,         1)                          \
+    ENTRY(CAM_INTF_META_LENS_OPT_STAB_MODE,           cam_ois_mode_t,              1)                          \
+    ENTRY(CAM_INTF_META_VIDEO_STAB_MODE,              uint32_t,                    1)                          \
+    NO_ID(CAM_INTF_META_LENS_FOCUS_STATE,             uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_NOISE_REDUCTION_MODE,         uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_NOISE_REDUCTION_STRENGTH,     uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_SCALER_CROP_REGION,           cam_crop_region_t,           1)                          \
+    ENTRY(CAM_INTF_META_SCENE_FLICKER,                uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_SENSOR_EXPOSURE_TIME,         int64_t,                     1)                          \
+    ENTRY(CAM_INTF_META_SENSOR_FRAME_DURATION,        int64_t,                     1)                          \
+    ENTRY(CAM_INTF_META_SENSOR_SENSITIVITY,           int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_ISP_SENSITIVITY ,             int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_SENSOR_TIMESTAMP,             int64_t,                     1)                          \
+    ENTRY(CAM_INTF_META_SENSOR_ROLLING_SHUTTER_SKEW,  int64_t,                     1)                          \
+    ENTRY(CAM_INTF_META_SHADING_MODE,                 uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_STATS_FACEDETECT_MODE,        uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_STATS_HISTOGRAM_MODE,         uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_STATS_SHARPNESS_MAP_MODE,     uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_STATS_SHARPNESS_MAP,          cam_sharpness_map_t,         3)                          \
+    ENTRY(CAM_INTF_META_TONEMAP_CURVES,               cam_rgb_tonemap_curves,      1)                          \
+    ENTRY(CAM_INTF_META_LENS_SHADING_MAP,             cam_lens_shading_map_t,      1)                          \
+    ENTRY(CAM_INTF_META_AEC_INFO,                     cam_3a_params_t,             1)                          \
+    ENTRY(CAM_INTF_META_SENSOR_INFO,                  cam_sensor_params_t,         1)                          \
+    ENTRY(CAM_INTF_META_EXIF_DEBUG_AE,                cam_ae_exif_debug_t,         1)                          \
+    ENTRY(CAM_INTF_META_EXIF_DEBUG_AWB,               cam_awb_exif_debug_t,        1)                          \
+    ENTRY(CAM_INTF_META_EXIF_DEBUG_AF,                cam_af_exif_debug_t,         1)                          \
+    ENTRY(CAM_INTF_META_EXIF_DEBUG_ASD,               cam_asd_exif_debug_t,        1)                          \
+    ENTRY(CAM_INTF_META_EXIF_DEBUG_STATS,             cam_stats_buffer_exif_debug_t,   1)                      \
+    ENTRY(CAM_INTF_META_EXIF_DEBUG_BESTATS,           cam_bestats_buffer_exif_debug_t, 1)                      \
+    ENTRY(CAM_INTF_META_EXIF_DEBUG_BHIST,             cam_bhist_buffer_exif_debug_t,   1)                      \
+    ENTRY(CAM_INTF_META_EXIF_DEBUG_3A_TUNING,         cam_q3a_tuning_info_t,       1)                          \
+    NO_ID(CAM_INTF_META_ASD_SCENE_CAPTURE_TYPE,       cam_auto_scene_t,            1)                          \
+    ENTRY(CAM_INTF_PARM_EFFECT,                       uint32_t,                    1)                          \
+    /* Defining as int32_t so that this array is 4 byte aligned */                                             \
+    ENTRY(CAM_INTF_META_PRIVATE_DATA,                 int32_t, MAX_METADATA_PRIVATE_PAYLOAD_SIZE_IN_BYTES / 4) \
+                                                                                                               \
+    /* Following are Params only and not metadata currently */                                                 \
+    ENTRY(CAM_INTF_PARM_HAL_VERSION,                  int32_t,                     1)                          \
+    /* Shared between HAL1 and HAL3 */                                                                         \
+    ENTRY(CAM_INTF_PARM_ANTIBANDING,                  uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_EXPOSURE_COMPENSATION,        int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_EV_STEP,                      cam_rational_type_t,         1)                          \
+    ENTRY(CAM_INTF_PARM_AEC_LOCK,                     uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_FPS_RANGE,                    cam_fps_range_t,             1)                          \
+    ENTRY(CAM_INTF_PARM_AWB_LOCK,                     uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_BESTSHOT_MODE,                uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_DIS_ENABLE,                   int32_t,                     1)                          \
+                                                                                                               \
+    ENTRY(XIAOMI_01,                                  uint8_t,                     1)                          \
+                                                                                                               \
+    ENTRY(CAM_INTF_PARM_LED_MODE,                     int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_LED_MODE_OVERRIDE,            uint32_t,                    1)                          \
+                                                                                                               \
+    /* dual camera specific params */                                                                          \
+    ENTRY(CAM_INTF_PARM_RELATED_SENSORS_CALIBRATION,  cam_related_system_calibration_data_t, 1)                \
+    ENTRY(CAM_INTF_META_AF_FOCAL_LENGTH_RATIO,        cam_focal_length_ratio_t, 1)                             \
+    ENTRY(CAM_INTF_META_SNAP_CROP_INFO_SENSOR,        cam_stream_crop_info_t,   1)                             \
+    ENTRY(CAM_INTF_META_SNAP_CROP_INFO_CAMIF,         cam_stream_crop_info_t,   1)                             \
+    ENTRY(CAM_INTF_META_SNAP_CROP_INFO_ISP,           cam_stream_crop_info_t,   1)                             \
+    ENTRY(CAM_INTF_META_SNAP_CROP_INFO_CPP,           cam_stream_crop_info_t,   1)                             \
+    ENTRY(CAM_INTF_META_DCRF,                         cam_dcrf_result_t,        1)                             \
+    ENTRY(CAM_INTF_PARM_SYNC_DC_PARAMETERS,           uint32_t,                  1)                            \
+    ENTRY(CAM_INTF_META_AF_FOCUS_POS,                 cam_af_focus_pos_t, 1)                                   \
+                                                                                                               \
+    /* HAL1 specific */                                                                                        \
+    /* read only */                                                                                            \
+    ENTRY(CAM_INTF_PARM_QUERY_FLASH4SNAP,             int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_EXPOSURE,                     int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_SHARPNESS,                    int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_CONTRAST,                     int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_SATURATION,                   int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_BRIGHTNESS,                   int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_ISO,                          cam_intf_parm_manual_3a_t,   1)                          \
+    ENTRY(CAM_INTF_PARM_EXPOSURE_TIME,                cam_intf_parm_manual_3a_t,   1)                          \
+    ENTRY(CAM_INTF_PARM_USERZOOM,                     cam_zoom_info_t,             1)                          \
+    ENTRY(CAM_INTF_PARM_ROLLOFF,                      int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_MODE,                         int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_AEC_ALGO_TYPE,                int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_FOCUS_ALGO_TYPE,              int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_AEC_ROI,                      cam_set_aec_roi_t,           1)                          \
+    ENTRY(CAM_INTF_PARM_AF_ROI,                       cam_roi_info_t,              1)                          \
+    ENTRY(CAM_INTF_PARM_SCE_FACTOR,                   int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_FD,                           cam_fd_set_parm_t,           1)                          \
+    ENTRY(CAM_INTF_PARM_MCE,                          int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_HFR,                          int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_REDEYE_REDUCTION,             int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_WAVELET_DENOISE,              cam_denoise_param_t,         1)                          \
+    ENTRY(CAM_INTF_PARM_TEMPORAL_DENOISE,             cam_denoise_param_t,         1)                          \
+    ENTRY(CAM_INTF_PARM_HISTOGRAM,                    int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_ASD_ENABLE,                   int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_RECORDING_HINT,               int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_HDR,                          cam_exp_bracketing_t,        1)                          \
+    ENTRY(CAM_INTF_PARM_FRAMESKIP,                    int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_ZSL_MODE,                     int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_HDR_NEED_1X,                  int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_LOCK_CAF,                     int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_VIDEO_HDR,                    int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_SENSOR_HDR,                   cam_sensor_hdr_type_t,       1)                          \
+    ENTRY(CAM_INTF_PARM_VT,                           int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_SET_AUTOFOCUSTUNING,          tune_actuator_t,             1)                          \
+    ENTRY(CAM_INTF_PARM_SET_VFE_COMMAND,              tune_cmd_t,                  1)                          \
+    ENTRY(CAM_INTF_PARM_SET_PP_COMMAND,               tune_cmd_t,                  1)                          \
+    ENTRY(CAM_INTF_PARM_MAX_DIMENSION,                cam_dimension_t,             1)                          \
+    ENTRY(CAM_INTF_PARM_RAW_DIMENSION,                cam_sensor_config_t,         1)                          \
+    ENTRY(CAM_INTF_PARM_TINTLESS,                     int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_WB_MANUAL,                    cam_manual_wb_parm_t,        1)                          \
+    ENTRY(CAM_INTF_PARM_CDS_MODE,                     int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_EZTUNE_CMD,                   cam_eztune_cmd_data_t,       1)                          \
+    ENTRY(CAM_INTF_PARM_INT_EVT,                      cam_int_evt_params_t,        1)                          \
+    ENTRY(CAM_INTF_PARM_RDI_MODE,                     int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_BURST_NUM,                    uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_RETRO_BURST_NUM,              uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_BURST_LED_ON_PERIOD,          uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_LONGSHOT_ENABLE,              int8_t,                      1)                          \
+    ENTRY(CAM_INTF_PARM_TONE_MAP_MODE,                uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_TOUCH_AE_RESULT,              int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_DUAL_LED_CALIBRATION,         int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_ADV_CAPTURE_MODE,             uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_QUADRA_CFA,                   int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_RAW,                          cam_dimension_t,             1)                          \
+    ENTRY(CAM_INTF_META_STREAM_INFO_FOR_PIC_RES,      cam_stream_size_info_t,      1)                          \
+    ENTRY(CAM_INTF_PARM_VFE1_RESERVED_RDI,            int32_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_SKIP_FINE_SCAN,               int32_t,                     1)                          \
+                                                                                                               \
+    /* HAL3 specific */                                                                                        \
+    ENTRY(CAM_INTF_META_STREAM_INFO,                  cam_stream_size_info_t,      1)                          \
+    ENTRY(CAM_INTF_META_AEC_MODE,                     uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_AEC_CONVERGENCE_SPEED,        float,                       1)                          \
+    ENTRY(CAM_INTF_META_AEC_PRECAPTURE_TRIGGER,       cam_trigger_t,               1)                          \
+    ENTRY(CAM_INTF_META_AF_TRIGGER,                   cam_trigger_t,               1)                          \
+    ENTRY(CAM_INTF_META_CAPTURE_INTENT,               uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_DEMOSAIC,                     int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_SHARPNESS_STRENGTH,           int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_GEOMETRIC_MODE,               uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_GEOMETRIC_STRENGTH,           uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_LENS_SHADING_MAP_MODE,        uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_SHADING_STRENGTH,             uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_TONEMAP_MODE,                 uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_IR_MODE,                      cam_ir_mode_type_t,          1)                          \
+    ENTRY(CAM_INTF_META_STREAM_ID,                    cam_stream_ID_t,             1)                          \
+    ENTRY(CAM_INTF_PARM_STATS_DEBUG_MASK,             uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_STATS_AF_PAAF,                uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_FOCUS_BRACKETING,             cam_af_bracketing_t,         1)                          \
+    ENTRY(CAM_INTF_PARM_FLASH_BRACKETING,             cam_flash_bracketing_t,      1)                          \
+    ENTRY(CAM_INTF_META_JPEG_GPS_COORDINATES,         double,                      3)                          \
+    ENTRY(CAM_INTF_META_JPEG_GPS_PROC_METHODS,        uint8_t,                     GPS_PROCESSING_METHOD_SIZE) \
+    ENTRY(CAM_INTF_META_JPEG_GPS_TIMESTAMP,           int64_t,                     1)                          \
+    ENTRY(CAM_INTF_META_JPEG_ORIENTATION,             int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_JPEG_QUALITY,                 uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_JPEG_THUMB_QUALITY,           uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_META_JPEG_THUMB_SIZE,              cam_dimension_t,             1)                          \
+    ENTRY(CAM_INTF_META_TEST_PATTERN_DATA,            cam_test_pattern_data_t,     1)                          \
+    ENTRY(CAM_INTF_META_PROFILE_TONE_CURVE,           cam_profile_tone_curve,      1)                          \
+    ENTRY(CAM_INTF_META_OTP_WB_GRGB,                  float,                       1)                          \
+    ENTRY(CAM_INTF_META_IMG_HYST_INFO,                cam_img_hysterisis_info_t,   1)                          \
+    ENTRY(CAM_INTF_META_CAC_INFO,                     cam_cac_info_t,              1)                          \
+    ENTRY(CAM_INTF_PARM_CAC,                          cam_aberration_mode_t,       1)                          \
+    ENTRY(CAM_INTF_META_NEUTRAL_COL_POINT,            cam_neutral_col_point_t,     1)                          \
+    ENTRY(CAM_INTF_PARM_ROTATION,                     cam_rotation_info_t,         1)                          \
+    ENTRY(CAM_INTF_PARM_HW_DATA_OVERWRITE,            cam_hw_data_overwrite_t,     1)                          \
+    ENTRY(CAM_INTF_META_IMGLIB,                       cam_intf_meta_imglib_t,      1)                          \
+    ENTRY(CAM_INTF_PARM_CAPTURE_FRAME_CONFIG,         cam_capture_frame_config_t,  1)                          \
+    ENTRY(CAM_INTF_PARM_CUSTOM,                       custom_parm_buffer_t,        1)                          \
+    ENTRY(CAM_INTF_PARM_FLIP,                         int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_USE_AV_TIMER,                 uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_META_EFFECTIVE_EXPOSURE_FACTOR,    float,                       1)                          \
+    ENTRY(CAM_INTF_META_LDAF_EXIF,                    uint32_t,                    2)                          \
+    ENTRY(CAM_INTF_META_BLACK_LEVEL_SOURCE_PATTERN,   cam_black_level_metadata_t,  1)                          \
+    ENTRY(CAM_INTF_META_BLACK_LEVEL_APPLIED_PATTERN,  cam_black_level_metadata_t,  1)                          \
+    ENTRY(CAM_INTF_META_LOW_LIGHT,                    cam_low_light_mode_t,        1)                          \
+    ENTRY(CAM_INTF_META_IMG_DYN_FEAT,                 cam_dyn_img_data_t,          1)                          \
+    ENTRY(CAM_INTF_PARM_MANUAL_CAPTURE_TYPE,          cam_manual_capture_type,     1)                          \
+    ENTRY(CAM_INTF_AF_STATE_TRANSITION,               uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_INITIAL_EXPOSURE_INDEX,       uint32_t,                    1)                          \
+    ENTRY(CAM_INTF_PARM_INSTANT_AEC,                  uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_META_REPROCESS_FLAGS,              uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_JPEG_ENCODE_CROP,             cam_stream_crop_info_t,      1)                          \
+    ENTRY(CAM_INTF_PARM_JPEG_SCALE_DIMENSION,         cam_dimension_t,             1)                          \
+    ENTRY(CAM_INTF_META_FOCUS_DEPTH_INFO,             uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_HAL_BRACKETING_HDR,           cam_hdr_param_t,             1)                          \
+    ENTRY(CAM_INTF_META_DC_LOW_POWER_ENABLE,          uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_META_DC_SAC_OUTPUT_INFO,           cam_sac_output_info_t,       1)                          \
+    ENTRY(CAM_INTF_META_DC_IN_SNAPSHOT_PP_ZOOM_RANGE, uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_META_DC_BOKEH_MODE,                uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_FOV_COMP_ENABLE,              int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_LED_CALIB_RESULT,             int32_t,                     1)                          \
+    NO_ID(CAM_INTF_PARM_DC_USERZOOM,                  int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_AEC_LUX_INDEX,                float,                       1)                          \
+    ENTRY(CAM_INTF_META_AF_OBJ_DIST_CM,               int32_t,                     1)                          \
+    ENTRY(CAM_INTF_META_BINNING_CORRECTION_MODE,      cam_binning_correction_mode_t,  1)                       \
+                                                                                                               \
+    /* HAL1 and HAL3 Dual Camera */                                                                            \
+    ENTRY(CAM_INTF_META_OIS_READ_DATA,                cam_ois_data_t,              1)                          \
+    ENTRY(CAM_INTF_PARAM_BOKEH_BLUR_LEVEL,            cam_rtb_blur_info_t,         1)                          \
+    ENTRY(CAM_INTF_META_RTB_DATA,                     cam_rtb_msg_type_t,          1)                          \
+    ENTRY(CAM_INTF_META_DC_CAPTURE,                   uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_PARM_BOKEH_MODE,                   uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_META_USERZOOM,                     cam_zoom_info_t,             1)                          \
+    ENTRY(CAM_INTF_META_TUNING_PARAMS,                tuning_params_t,             1)                          \
+    ENTRY(CAM_INTF_PARM_CLOSE_HINT,                   uint8_t,                     1)                          \
+    ENTRY(CAM_INTF_META_SEND_IMMEDIATELY,             uint8_t,                     1)
+
+#define CAM_INTF_METADATA_MEMBER(PARAM_ID, DATATYPE, COUNT) \
+        INCLUDE(PARAM_ID, DATATYPE, COUNT);
+
+typedef struct {
+    CAM_INTF_METADATA_ENTRIES(CAM_INTF_METADATA_MEMBER, CAM_INTF_METADATA_MEMBER)
 } metadata_data_t;
 
 /* Update clear_metadata_buffer() function when a new is_xxx_valid is added to
@@ -34,6 +34,7 @@
 #include <unwind.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include <inttypes.h>
 #include <cutils/properties.h>
 
@@ -367,6 +368,370 @@ void __free(void *ptr)
   }
 }
 
+/* Sampled mode: keeps no header in front of allocations and takes no global
+ * lock. Each thread counts down an exponentially distributed number of
+ * bytes and only the allocation crossing zero is recorded, so on average
+ * one allocation per SAMPLE_BYTES allocated bytes pays for a backtrace.
+ * Sampled pointers live in tables sharded by pointer hash, each with its
+ * own lock, and are aggregated per callsite into estimated counts and
+ * bytes. */
+
+#define DEFAULT_SAMPLE_BYTES (512 * 1024)
+#define SAMPLE_SHARDS 64
+#define SAMPLE_SHARD_SLOTS 1024
+#define SAMPLE_SITES 4096
+#define SAMPLE_DUMP_MAX_SITES 64
+
+typedef enum {
+  MEMLEAK_MODE_OFF,
+  MEMLEAK_MODE_FULL,
+  MEMLEAK_MODE_SAMPLED,
+} memleak_mode_t;
+
+struct sample_t {
+  void *ptr;
+  unsigned int size;
+  unsigned int site;
+  size_t weight;
+};
+
+struct sample_shard_t {
+  pthread_mutex_t lock;
+  unsigned int live;
+  struct sample_t slots[SAMPLE_SHARD_SLOTS];
+} __attribute__((aligned(64)));
+
+struct sample_site_t {
+  uint64_t hash;
+  uintptr_t bt[MAX_BACKTRACE_DEPTH];
+  int bt_depth;
+  size_t allocs;
+  size_t alloc_bytes;
+  size_t live;
+  size_t live_bytes;
+};
+
+static memleak_mode_t memleak_mode = MEMLEAK_MODE_OFF;
+static size_t sample_bytes = DEFAULT_SAMPLE_BYTES;
+static struct sample_shard_t *sample_shards = NULL;
+static pthread_mutex_t sample_site_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct sample_site_t *sample_sites = NULL;
+static size_t sample_num_sites = 0;
+static size_t sample_dropped = 0;
+
+static __thread int64_t sample_bytes_left = 0;
+static __thread uint64_t sample_rng = 0;
+
+static inline struct sample_shard_t *sample_shard(void *ptr)
+{
+  uint64_t key = ((uint64_t)(uintptr_t)ptr >> 4) * 0x9E3779B97F4A7C15ULL;
+  return &sample_shards[key >> 58];
+}
+
+static inline unsigned int sample_slot(void *ptr)
+{
+  uint64_t key = ((uint64_t)(uintptr_t)ptr >> 4) * 0xC2B2AE3D27D4EB4FULL;
+  return (unsigned int)(key >> 32) & (SAMPLE_SHARD_SLOTS - 1);
+}
+
+/* Next exponentially distributed distance to a sample, in bytes */
+static int64_t sample_next_interval()
+{
+  if (sample_rng == 0) {
+    sample_rng = ((uint64_t)(uintptr_t)&sample_rng) ^ ((uint64_t)gettid() << 32) ^
+        0x2545F4914F6CDD1DULL;
+  }
+  sample_rng ^= sample_rng << 13;
+  sample_rng ^= sample_rng >> 7;
+  sample_rng ^= sample_rng << 17;
+  /* 53 random bits, uniform in (0, 1] */
+  double u = ((double)(sample_rng >> 11) + 1.0) / 9007199254740992.0;
+  double interval = -log(u) * (double)sample_bytes;
+  return (int64_t)interval + 1;
+}
+
+static unsigned int sample_find_site(uintptr_t *bt, int bt_depth)
+{
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (int i = 0; i < bt_depth; i++) {
+    hash = (hash ^ bt[i]) * 0x100000001B3ULL;
+  }
+  unsigned int idx = (unsigned int)(hash >> 32) & (SAMPLE_SITES - 1);
+  for (unsigned int n = 0; n < SAMPLE_SITES; n++) {
+    struct sample_site_t *site = &sample_sites[idx];
+    if (site->bt_depth == 0) {
+      site->hash = hash;
+      site->bt_depth = bt_depth > 0 ? bt_depth : 1;
+      memcpy(site->bt, bt, bt_depth * sizeof(uintptr_t));
+      sample_num_sites++;
+      return idx;
+    }
+    if (site->hash == hash && site->bt_depth == bt_depth &&
+        !memcmp(site->bt, bt, bt_depth * sizeof(uintptr_t))) {
+      return idx;
+    }
+    idx = (idx + 1) & (SAMPLE_SITES - 1);
+  }
+  return SAMPLE_SITES;
+}
+
+static void sample_record(void *ptr, size_t size)
+{
+  uintptr_t bt[MAX_BACKTRACE_DEPTH];
+  int bt_depth = mmcamera_stacktrace(bt, MAX_BACKTRACE_DEPTH);
+  /* unbiased estimate of the bytes this sample stands for */
+  double p = 1.0 - exp(-(double)size / (double)sample_bytes);
+  size_t weight = (p > 0.0) ? (size_t)((double)size / p) : size;
+
+  pthread_mutex_lock(&sample_site_mutex);
+  unsigned int site = sample_find_site(bt, bt_depth);
+  if (site < SAMPLE_SITES) {
+    sample_sites[site].allocs++;
+    sample_sites[site].alloc_bytes += weight;
+    sample_sites[site].live++;
+    sample_sites[site].live_bytes += weight;
+  } else {
+    sample_dropped++;
+  }
+  pthread_mutex_unlock(&sample_site_mutex);
+  if (site >= SAMPLE_SITES) {
+    return;
+  }
+
+  struct sample_shard_t *shard = sample_shard(ptr);
+  unsigned int idx = sample_slot(ptr);
+  bool stored = false;
+  pthread_mutex_lock(&shard->lock);
+  if (shard->live < SAMPLE_SHARD_SLOTS / 2) {
+    while (shard->slots[idx].ptr != NULL) {
+      idx = (idx + 1) & (SAMPLE_SHARD_SLOTS - 1);
+    }
+    shard->slots[idx].ptr = ptr;
+    shard->slots[idx].size = size;
+    shard->slots[idx].site = site;
+    shard->slots[idx].weight = weight;
+    __atomic_store_n(&shard->live, shard->live + 1, __ATOMIC_RELAXED);
+    stored = true;
+  }
+  pthread_mutex_unlock(&shard->lock);
+  if (!stored) {
+    pthread_mutex_lock(&sample_site_mutex);
+    sample_sites[site].live--;
+    sample_sites[site].live_bytes -= weight;
+    sample_dropped++;
+    pthread_mutex_unlock(&sample_site_mutex);
+  }
+}
+
+static void sample_forget(void *ptr)
+{
+  struct sample_shard_t *shard = sample_shard(ptr);
+  /* the allocating thread published the sample before handing out ptr */
+  if (__atomic_load_n(&shard->live, __ATOMIC_RELAXED) == 0) {
+    return;
+  }
+  unsigned int idx = sample_slot(ptr);
+  struct sample_t found;
+  found.ptr = NULL;
+  pthread_mutex_lock(&shard->lock);
+  while (shard->slots[idx].ptr != NULL) {
+    if (shard->slots[idx].ptr == ptr) {
+      found = shard->slots[idx];
+      /* backward shift deletion keeps probe chains without tombstones */
+      unsigned int hole = idx;
+      unsigned int next = (idx + 1) & (SAMPLE_SHARD_SLOTS - 1);
+      while (shard->slots[next].ptr != NULL) {
+        unsigned int home = sample_slot(shard->slots[next].ptr);
+        if (((next - home) & (SAMPLE_SHARD_SLOTS - 1)) >=
+            ((next - hole) & (SAMPLE_SHARD_SLOTS - 1))) {
+          shard->slots[hole] = shard->slots[next];
+          hole = next;
+        }
+        next = (next + 1) & (SAMPLE_SHARD_SLOTS - 1);
+      }
+      shard->slots[hole].ptr = NULL;
+      __atomic_store_n(&shard->live, shard->live - 1, __ATOMIC_RELAXED);
+      break;
+    }
+    idx = (idx + 1) & (SAMPLE_SHARD_SLOTS - 1);
+  }
+  pthread_mutex_unlock(&shard->lock);
+
+  if (found.ptr != NULL) {
+    pthread_mutex_lock(&sample_site_mutex);
+    sample_sites[found.site].live--;
+    sample_sites[found.site].live_bytes -= found.weight;
+    pthread_mutex_unlock(&sample_site_mutex);
+  }
+}
+
+static inline void sample_account(void *ptr, size_t size)
+{
+  int64_t left = sample_bytes_left - (int64_t)size;
+  if (__builtin_expect(left > 0, 1)) {
+    sample_bytes_left = left;
+    return;
+  }
+  if (sample_bytes_left == 0) {
+    /* first allocation of this thread */
+    sample_bytes_left = sample_next_interval();
+    sample_account(ptr, size);
+    return;
+  }
+  sample_bytes_left = sample_next_interval();
+  if (ptr != NULL) {
+    sample_record(ptr, size);
+  }
+}
+
+void * __sampled_malloc(size_t size)
+{
+  void *ptr = malloc(size);
+  sample_account(ptr, size);
+  return ptr;
+}
+
+void * __sampled_calloc(size_t nmemb, size_t size)
+{
+  void *ptr = calloc(nmemb, size);
+  sample_account(ptr, nmemb * size);
+  return ptr;
+}
+
+void __sampled_free(void *ptr)
+{
+  if (ptr) {
+    sample_forget(ptr);
+    free(ptr);
+  }
+}
+
+void * __sampled_realloc(void *ptr, size_t size)
+{
+  if (ptr == NULL) {
+    return __sampled_malloc(size);
+  }
+  if (size == 0) {
+    /* realloc(ptr, 0) frees ptr */
+    __sampled_free(ptr);
+    return NULL;
+  }
+  void *new_ptr = realloc(ptr, size);
+  if (new_ptr == NULL) {
+    /* ptr is untouched and keeps its sample */
+    return NULL;
+  }
+  /* if another thread got ptr back from malloc meanwhile, its sample sits
+   * later in the probe chain, so the older one is forgotten first */
+  sample_forget(ptr);
+  sample_account(new_ptr, size);
+  return new_ptr;
+}
+
+static int sample_site_cmp(const void *a, const void *b)
+{
+  const struct sample_site_t *sa = *(const struct sample_site_t * const *)a;
+  const struct sample_site_t *sb = *(const struct sample_site_t * const *)b;
+  if (sa->live_bytes != sb->live_bytes) {
+    return (sa->live_bytes < sb->live_bytes) ? 1 : -1;
+  }
+  return 0;
+}
+
+static void print_sampled_memory()
+{
+  struct sample_site_t **sites;
+  struct sample_site_t *copy;
+  size_t num = 0, live = 0, live_bytes = 0, dropped;
+
+  copy = (struct sample_site_t *)malloc(SAMPLE_SITES * sizeof(*copy));
+  sites = (struct sample_site_t **)malloc(SAMPLE_SITES * sizeof(*sites));
+  if (copy == NULL || sites == NULL) {
+    free(copy);
+    free(sites);
+    return;
+  }
+  pthread_mutex_lock(&sample_site_mutex);
+  for (size_t i = 0; i < SAMPLE_SITES; i++) {
+    if (sample_sites[i].live != 0) {
+      copy[num] = sample_sites[i];
+      sites[num] = &copy[num];
+      live += copy[num].live;
+      live_bytes += copy[num].live_bytes;
+      num++;
+    }
+  }
+  dropped = sample_dropped;
+  pthread_mutex_unlock(&sample_site_mutex);
+
+  qsort(sites, num, sizeof(*sites), sample_site_cmp);
+  ALOGI("~%zu bytes non freed memory in %zu sampled allocations at %zu "
+      "callsites, 1 sample per %zu bytes, %zu samples dropped\n",
+      live_bytes, live, num, sample_bytes, dropped);
+
+  struct map_info_holder *p_map_info = lib_map_create(getpid());
+  for (size_t i = 0; i < num && i < SAMPLE_DUMP_MAX_SITES; i++) {
+    ALOGI("%zu CALLSITE ~%zu bytes REMAINING in %zu samples "
+        "(~%zu bytes allocated in %zu samples)\n", i + 1,
+        sites[i]->live_bytes, sites[i]->live, sites[i]->alloc_bytes,
+        sites[i]->allocs);
+    print_backtrace(p_map_info, sites[i]->bt, sites[i]->bt_depth);
+  }
+  lib_map_destroy(p_map_info);
+  free(copy);
+  free(sites);
+}
+
+void hal_debug_enable_memleak_sampling(size_t bytes)
+{
+  pthread_mutex_lock(&memory_mutex);
+  if (memleak_mode != MEMLEAK_MODE_OFF) {
+    /* allocations already made depend on the active mode */
+    pthread_mutex_unlock(&memory_mutex);
+    return;
+  }
+  sample_shards = (struct sample_shard_t *)calloc(SAMPLE_SHARDS,
+      sizeof(struct sample_shard_t));
+  sample_sites = (struct sample_site_t *)calloc(SAMPLE_SITES,
+      sizeof(struct sample_site_t));
+  if (sample_shards == NULL || sample_sites == NULL) {
+    free(sample_shards);
+    free(sample_sites);
+    sample_shards = NULL;
+    sample_sites = NULL;
+    pthread_mutex_unlock(&memory_mutex);
+    LOGE("not enough memory for sampling tables.\n");
+    return;
+  }
+  for (int i = 0; i < SAMPLE_SHARDS; i++) {
+    pthread_mutex_init(&sample_shards[i].lock, NULL);
+  }
+  sample_bytes = bytes ? bytes : DEFAULT_SAMPLE_BYTES;
+  memleak_mode = MEMLEAK_MODE_SAMPLED;
+  __real_malloc = __sampled_malloc;
+  __real_calloc = __sampled_calloc;
+  __real_realloc = __sampled_realloc;
+  __real_free = __sampled_free;
+  pthread_mutex_unlock(&memory_mutex);
+}
+
+void hal_debug_get_memleak_stats(hal_debug_memleak_stats_t *stats)
+{
+  memset(stats, 0, sizeof(*stats));
+  if (memleak_mode != MEMLEAK_MODE_SAMPLED) {
+    return;
+  }
+  pthread_mutex_lock(&sample_site_mutex);
+  for (size_t i = 0; i < SAMPLE_SITES; i++) {
+    stats->sampled_allocs += sample_sites[i].allocs;
+    stats->live_samples += sample_sites[i].live;
+    stats->live_bytes += sample_sites[i].live_bytes;
+  }
+  stats->callsites = sample_num_sites;
+  stats->dropped = sample_dropped;
+  pthread_mutex_unlock(&sample_site_mutex);
+}
+
 extern "C" void * __wrap_malloc(size_t size)
 {
   return __real_malloc(size);
@@ -398,17 +763,37 @@ static __attribute__((constructor)) void init(void)
 
 void hal_debug_enable_memleak_trace()
 {
-  __real_malloc = __malloc;
-  __real_calloc = __calloc;
-  __real_realloc = __realloc;
-  __real_free = __free;
+  char prop[PROPERTY_VALUE_MAX];
+
+  /* persist.vendor.camera.memleak.enable: 1 traces every allocation,
+   * 2 samples one allocation per memleak.sample_bytes allocated bytes */
+  property_get("persist.vendor.camera.memleak.enable", prop, "1");
+  if (atoi(prop) == 2) {
+    property_get("persist.vendor.camera.memleak.sample_bytes", prop, "0");
+    hal_debug_enable_memleak_sampling((size_t)atol(prop));
+    return;
+  }
+
+  pthread_mutex_lock(&memory_mutex);
+  if (memleak_mode == MEMLEAK_MODE_OFF) {
+    memleak_mode = MEMLEAK_MODE_FULL;
+    __real_malloc = __malloc;
+    __real_calloc = __calloc;
+    __real_realloc = __realloc;
+    __real_free = __free;
+  }
+  pthread_mutex_unlock(&memory_mutex);
 }
 void hal_debug_dump_memleak_trace()
 {
-  print_allocated_memory();
+  if (memleak_mode == MEMLEAK_MODE_SAMPLED) {
+    print_sampled_memory();
+  } else {
+    print_allocated_memory();
+  }
 }
 static __attribute__((destructor)) void finish(void)
 {
   LOGI( "memleak lib deinit.\n");
-  print_allocated_memory();
+  hal_debug_dump_memleak_trace();
 }
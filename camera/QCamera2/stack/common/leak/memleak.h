@@ -32,6 +32,7 @@
 #define MEMLEAK_H
 #include <pthread.h>
 #include <unistd.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,8 +42,18 @@ struct map_info_holder *lib_map_create(pid_t pid);
 void print_backtrace(struct map_info_holder *p_map_info, uintptr_t* frames, int frame_count);
 void lib_map_destroy(struct map_info_holder *map_hold);
 void hal_debug_enable_memleak_trace();
+void hal_debug_enable_memleak_sampling(size_t sample_bytes);
 void hal_debug_dump_memleak_trace();
 
+typedef struct {
+  size_t sampled_allocs;  /* allocations picked by the sampler */
+  size_t live_samples;    /* sampled allocations not freed yet */
+  size_t live_bytes;      /* estimated bytes not freed yet */
+  size_t callsites;       /* distinct sampled backtraces */
+  size_t dropped;         /* samples lost to full tables */
+} hal_debug_memleak_stats_t;
+void hal_debug_get_memleak_stats(hal_debug_memleak_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
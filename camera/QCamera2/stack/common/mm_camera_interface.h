@@ -1049,4 +1049,20 @@ uint8_t validate_handle(uint32_t src_handle, uint32_t handle);
 int mm_camera_util_match_subdev_type(struct media_entity_desc entity,
      uint32_t gid, uint32_t type);
 
+/*Sparse metadata helpers: only entries flagged in is_valid are touched*/
+uint32_t mm_camera_meta_get_valid_ids(const metadata_buffer_t *meta,
+        uint32_t *ids, uint32_t max_ids);
+
+/*Replacement for memcpy of a whole metadata_buffer_t, returns bytes copied*/
+size_t mm_camera_meta_copy(metadata_buffer_t *dst,
+        const metadata_buffer_t *src);
+
+/*Overlay the valid entries of src onto dst, returns bytes copied*/
+size_t mm_camera_meta_merge(metadata_buffer_t *dst,
+        const metadata_buffer_t *src);
+
+/*Entries of cur that are new or changed since prev, returns bytes copied*/
+size_t mm_camera_meta_delta(metadata_buffer_t *delta,
+        const metadata_buffer_t *cur, const metadata_buffer_t *prev);
+
 #endif /*__MM_CAMERA_INTERFACE_H__*/
@@ -131,6 +131,14 @@ typedef enum {
   MM_JPEG_COLOR_FORMAT_MAX
 } mm_jpeg_color_format;
 
+/* order in which queued jobs are started, snapshot jobs are the default */
+typedef enum {
+  MM_JPEG_JOB_PRIO_SNAPSHOT = 0,
+  MM_JPEG_JOB_PRIO_CALLBACK,     /* thumbnail and preview callback jobs */
+  MM_JPEG_JOB_PRIO_REPROCESS,    /* offline reprocess jobs */
+  MM_JPEG_JOB_PRIO_MAX
+} mm_jpeg_job_prio_t;
+
 typedef enum {
   JPEG_JOB_STATUS_DONE = 0,
   JPEG_JOB_STATUS_ERROR
@@ -319,6 +327,9 @@ typedef struct {
   this info will be used to perform cache ops*/
   mm_jpeg_buf_usage_t buf_usage;
 
+  /* scheduling priority of the job */
+  mm_jpeg_job_prio_t priority;
+
 } mm_jpeg_encode_job_t;
 
 typedef struct {
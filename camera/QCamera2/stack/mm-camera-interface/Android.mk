@@ -16,7 +16,8 @@ src/mm_camera_muxer.c \
 src/mm_camera_channel.c \
 src/mm_camera_stream.c \
 src/mm_camera_thread.c \
-src/mm_camera_sock.c
+src/mm_camera_sock.c \
+src/mm_camera_meta.c
 
 # System header file path prefix
 LOCAL_CFLAGS += -DSYSTEM_HEADER_PREFIX=sys
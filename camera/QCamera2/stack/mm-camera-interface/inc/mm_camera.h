@@ -62,6 +62,16 @@
 /*For frame sync */
 #define MAX_OBJS_FOR_FRAME_SYNC   4
 
+/* frame idx window of unmatched super bufs indexed in a superbuf queue,
+* power of 2 */
+#define MM_CHANNEL_SUPERBUF_INDEX_SIZE 64
+
+/* num of groups of channels synced by frame idx */
+#define MM_CAMERA_FRAME_SYNC_GROUPS 2
+/* slots of the frame idx index of a frame sync group,
+* power of 2 and larger than MM_CAMERA_FRAME_SYNC_NODES */
+#define MM_CAMERA_FRAME_SYNC_INDEX_SIZE 8
+
 /* num of supporting camera*/
 #define MM_CAMERA_MAX_AUX_CAMERA 1
 
@@ -156,6 +166,12 @@ typedef enum {
     MM_CAMERA_POLL_TYPE_MAX
 } mm_camera_poll_thread_type_t;
 
+typedef enum {
+    MM_CAMERA_POLL_ENGINE_POLL,  /* poll(), level triggered */
+    MM_CAMERA_POLL_ENGINE_EPOLL, /* epoll, edge triggered, ready fds drained per wakeup */
+    MM_CAMERA_POLL_ENGINE_MAX
+} mm_camera_poll_engine_type_t;
+
 /* function ptr defined for poll notify CB,
  * registered at poll thread with poll fd */
 typedef void (*mm_camera_poll_notify_t)(void *user_data);
@@ -180,6 +196,18 @@ typedef struct {
     uint32_t cmd;
     struct pollfd poll_fds[MAX_STREAM_NUM_IN_BUNDLE + 1];
     uint8_t num_fds;
+    /* chosen before launch, poll is used if epoll can not be set up */
+    mm_camera_poll_engine_type_t poll_engine;
+    int32_t epoll_fd;
+    /* fd registered in epoll_fd for each poll entry, -1 if none */
+    int32_t epoll_entry_fds[MAX_STREAM_NUM_IN_BUNDLE];
+    /* entries left with data after their drain limit, bit per entry */
+    uint32_t epoll_pending;
+    /* entries registered or unregistered by pipe commands of the current
+     * wakeup, bit per entry; their earlier readiness is stale */
+    uint32_t epoll_changed;
+    /* current sleep after a poll error, doubled on each error in a row */
+    uint32_t backoff_us;
     pthread_mutex_t mutex;
     pthread_cond_t cond_v;
     int32_t status;
@@ -445,6 +473,18 @@ typedef struct {
     uint32_t once;
     uint32_t frame_skip_count;
     uint32_t good_frame_id;
+    /* unmatched super bufs by frame_idx modulo MM_CHANNEL_SUPERBUF_INDEX_SIZE */
+    cam_node_t *frame_index[MM_CHANNEL_SUPERBUF_INDEX_SIZE];
+    uint32_t frame_index_cnt;
+    /* no indexed frame_idx below low or above high */
+    uint32_t frame_index_low;
+    uint32_t frame_index_high;
+    /* all unmatched super bufs are in frame_index */
+    uint8_t frame_index_valid;
+    /* buffers matched by queue walk before rebuilding an invalid frame_index */
+    uint32_t frame_index_retry;
+    /* matching may use frame_index, linear queue walk otherwise */
+    uint8_t frame_index_enabled;
 } mm_channel_queue_t;
 
 typedef struct {
@@ -464,16 +504,27 @@ typedef struct {
     uint32_t frame_valid[MAX_NUM_CAMERA_PER_BUNDLE];
     /* Frame present in all channels*/
     uint32_t matched;
+    /* position in the matched heap, if matched */
+    uint8_t heap_pos;
 } mm_channel_sync_node_t;
 
-/* Frame sync information */
+/* Frame sync information of a group of channels */
 typedef struct {
+    /* protects the group, taken after the superbuf queue locks of its channels */
+    pthread_mutex_t lock;
+    /* master channel of the linked channels synced here, NULL if unused */
+    struct mm_channel *master;
     /* Number of camera channels that need to be synced*/
     uint8_t num_cam;
     /* position of the next node to be updated */
     uint8_t pos;
     /* circular node array used to store frame information */
     mm_channel_sync_node_t node[MM_CAMERA_FRAME_SYNC_NODES];
+    /* node of each frame idx in use, -1 for a free slot. open addressing */
+    int8_t node_index[MM_CAMERA_FRAME_SYNC_INDEX_SIZE];
+    /* matched nodes, min heap by frame idx */
+    uint8_t matched_heap[MM_CAMERA_FRAME_SYNC_NODES];
+    uint8_t num_matched;
     /* Channel corresponding to each camera */
     struct mm_channel *ch_obj[MAX_NUM_CAMERA_PER_BUNDLE];
     /* Cb corresponding to each camera */
@@ -569,6 +620,8 @@ typedef struct mm_channel {
     struct mm_channel *aux_ch_obj[MM_CAMERA_MAX_AUX_CAMERA];  /*Slave channel of this channel*/
     uint8_t match_meta;
     uint32_t zsl_stream_id;
+    /* frame sync group the channel is registered to */
+    mm_channel_frame_sync_info_t *fs_group;
 } mm_channel_t;
 
 typedef struct {
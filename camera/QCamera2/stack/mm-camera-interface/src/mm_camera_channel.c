@@ -28,8 +28,10 @@
  */
 
 // System dependencies
+#include <cutils/properties.h>
 #include <pthread.h>
 #include <fcntl.h>
+#include <stdlib.h>
 
 // Camera dependencies
 #include "cam_semaphore.h"
@@ -42,9 +44,10 @@
 extern mm_camera_obj_t* mm_camera_util_get_camera_by_handler(uint32_t cam_handler);
 extern mm_channel_t * mm_camera_util_get_channel_by_handler(mm_camera_obj_t * cam_obj,
                                                             uint32_t handler);
-/* Static frame sync info used between different camera channels*/
-static mm_channel_frame_sync_info_t fs = { .num_cam =0, .pos = 0};
-/* Frame sync info access lock */
+/* Static frame sync groups used between different camera channels*/
+static mm_channel_frame_sync_info_t fs[MM_CAMERA_FRAME_SYNC_GROUPS];
+static pthread_once_t fs_once = PTHREAD_ONCE_INIT;
+/* Frame sync group registration lock */
 static pthread_mutex_t fs_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /* internal function declare goes here */
@@ -138,15 +141,18 @@ int32_t mm_channel_superbuf_flush_matched(mm_channel_t* my_obj,
                                           mm_channel_queue_t * queue);
 
 /* Start of Frame Sync util methods */
-void mm_frame_sync_reset();
+void mm_frame_sync_reset(mm_channel_frame_sync_info_t *group);
 int32_t mm_frame_sync_register_channel(mm_channel_t *ch_obj);
 int32_t mm_frame_sync_unregister_channel(mm_channel_t *ch_obj);
 int32_t mm_frame_sync_add(uint32_t frame_id, mm_channel_t *ch_obj);
-int32_t mm_frame_sync_remove(uint32_t frame_id);
-uint32_t mm_frame_sync_find_matched(uint8_t oldest);
-int8_t mm_frame_sync_find_frame_index(uint32_t frame_id);
-void mm_frame_sync_lock_queues();
-void mm_frame_sync_unlock_queues();
+int32_t mm_frame_sync_remove(uint32_t frame_id, mm_channel_t *ch_obj);
+static void mm_frame_sync_group_remove(mm_channel_frame_sync_info_t *group,
+        uint32_t frame_id);
+uint32_t mm_frame_sync_find_matched(mm_channel_frame_sync_info_t *group);
+int8_t mm_frame_sync_find_frame_index(mm_channel_frame_sync_info_t *group,
+        uint32_t frame_id);
+mm_channel_frame_sync_info_t *mm_frame_sync_lock_queues(mm_channel_t *ch_obj);
+void mm_frame_sync_unlock_queues(mm_channel_frame_sync_info_t *group);
 void mm_channel_node_qbuf(mm_channel_t *ch_obj, mm_channel_queue_node_t *node);
 /* End of Frame Sync Util methods */
 void mm_channel_send_super_buf(mm_channel_node_info_t *info);
@@ -158,6 +164,16 @@ void mm_channel_fill_meta_frame_id(mm_channel_t* ch_obj,
                         mm_channel_queue_node_t * node);
 mm_channel_queue_node_t* mm_channel_superbuf_dequeue_frame(
         mm_channel_queue_t *queue, mm_channel_t *ch_obj);
+int8_t mm_channel_util_seq_comp_w_rollover(uint32_t v1, uint32_t v2);
+/* superbuf queue frame index */
+void mm_channel_superbuf_index_reset(mm_channel_queue_t *queue);
+void mm_channel_superbuf_index_rebuild(mm_channel_queue_t *queue);
+void mm_channel_superbuf_index_add(mm_channel_queue_t *queue, cam_node_t *node);
+void mm_channel_superbuf_index_del(mm_channel_queue_t *queue, cam_node_t *node);
+cam_node_t* mm_channel_superbuf_index_find(mm_channel_queue_t *queue,
+        uint32_t frame_idx);
+cam_node_t* mm_channel_superbuf_index_first(mm_channel_queue_t *queue,
+        uint32_t from, uint32_t to);
 
 /*===========================================================================
  * FUNCTION   : mm_channel_util_get_stream_by_handler
@@ -578,14 +594,15 @@ static void mm_channel_process_stream_buf(mm_camera_cmdcb_t * cmd_cb,
         if (ch_obj->req_type == MM_CAMERA_REQ_FRAME_SYNC_BUF
                 && !m_obj->frame_sync.is_active) {
             // Lock the Queues
-            mm_frame_sync_lock_queues();
-            uint32_t match_frame = mm_frame_sync_find_matched(FALSE);
+            mm_channel_frame_sync_info_t *fs_group = mm_frame_sync_lock_queues(ch_obj);
+            uint32_t match_frame =
+                    (NULL != fs_group) ? mm_frame_sync_find_matched(fs_group) : 0;
             if (match_frame) {
                 uint8_t j = 0;
                 for (j = 0; j < MAX_NUM_CAMERA_PER_BUNDLE; j++) {
-                    if (fs.ch_obj[j]) {
+                    if (fs_group->ch_obj[j]) {
                         mm_channel_queue_t *ch_queue =
-                                &fs.ch_obj[j]->bundle.superbuf_queue;
+                                &fs_group->ch_obj[j]->bundle.superbuf_queue;
                         if (ch_queue == NULL) {
                             LOGW("Channel queue is NULL");
                             break;
@@ -593,19 +610,19 @@ static void mm_channel_process_stream_buf(mm_camera_cmdcb_t * cmd_cb,
                         node = mm_channel_superbuf_dequeue_frame_internal(
                                 ch_queue, match_frame);
                         if (node != NULL) {
-                            info.ch_obj[info.num_nodes] = fs.ch_obj[j];
+                            info.ch_obj[info.num_nodes] = fs_group->ch_obj[j];
                             info.node[info.num_nodes] = node;
                             info.num_nodes++;
                             LOGH("Added ch(%p) to node ,num nodes %d",
-                                     fs.ch_obj[j], info.num_nodes);
+                                     fs_group->ch_obj[j], info.num_nodes);
                         }
                     }
                 }
-                mm_frame_sync_remove(match_frame);
+                mm_frame_sync_group_remove(fs_group, match_frame);
                 LOGI("match frame %d", match_frame);
-                if (info.num_nodes != fs.num_cam) {
+                if (info.num_nodes != fs_group->num_cam) {
                     LOGI("num node %d != num cam (%d) Debug this",
-                             info.num_nodes, fs.num_cam);
+                             info.num_nodes, fs_group->num_cam);
                     uint8_t j = 0;
                     // free super buffers from various nodes
                     for (j = 0; j < info.num_nodes; j++) {
@@ -618,7 +635,9 @@ static void mm_channel_process_stream_buf(mm_camera_cmdcb_t * cmd_cb,
                     info.num_nodes = 0;
                 }
             }
-            mm_frame_sync_unlock_queues();
+            if (NULL != fs_group) {
+                mm_frame_sync_unlock_queues(fs_group);
+            }
         } else {
            if (ch_obj->frame_req_cnt == 0) {
                if (ch_obj->match_meta) {
@@ -1364,6 +1383,7 @@ int32_t mm_channel_init(mm_channel_t *my_obj,
                         void *userdata)
 {
     int32_t rc = 0;
+    char prop[PROPERTY_VALUE_MAX];
 
     my_obj->bundle.super_buf_notify_cb = channel_cb;
     my_obj->bundle.user_data = userdata;
@@ -1380,6 +1400,9 @@ int32_t mm_channel_init(mm_channel_t *my_obj,
 
     LOGD("Launch data poll thread in channel open");
     snprintf(my_obj->poll_thread[0].threadName, THREAD_NAME_SIZE, "CAM_dataPoll");
+    property_get("persist.vendor.camera.mci.epoll", prop, "0");
+    my_obj->poll_thread[0].poll_engine = (atoi(prop) > 0) ?
+            MM_CAMERA_POLL_ENGINE_EPOLL : MM_CAMERA_POLL_ENGINE_POLL;
     mm_camera_poll_thread_launch(&my_obj->poll_thread[0],
                                  MM_CAMERA_POLL_TYPE_DATA);
 
@@ -2695,6 +2718,8 @@ int32_t mm_channel_unmap_stream_buf(mm_channel_t *my_obj,
  *==========================================================================*/
 int32_t mm_channel_superbuf_queue_init(mm_channel_queue_t * queue)
 {
+    mm_channel_superbuf_index_reset(queue);
+    queue->frame_index_enabled = TRUE;
     return cam_queue_init(&queue->que);
 }
 
@@ -2712,13 +2737,16 @@ int32_t mm_channel_superbuf_queue_init(mm_channel_queue_t * queue)
  *==========================================================================*/
 int32_t mm_channel_superbuf_queue_deinit(mm_channel_queue_t * queue)
 {
+    mm_channel_superbuf_index_reset(queue);
     return cam_queue_deinit(&queue->que);
 }
 
 /*===========================================================================
  * FUNCTION   : mm_channel_util_seq_comp_w_rollover
  *
- * DESCRIPTION: utility function to handle sequence number comparison with rollover
+ * DESCRIPTION: utility function to handle sequence number comparison with rollover.
+ *              v1 is larger if it is less than half the sequence range ahead
+ *              of v2, so a sequence that rolled over to 0 is still larger.
  *
  * PARAMETERS :
  *   @v1      : first value to be compared
@@ -2733,17 +2761,223 @@ int8_t mm_channel_util_seq_comp_w_rollover(uint32_t v1,
                                            uint32_t v2)
 {
     int8_t ret = 0;
+    int32_t diff = (int32_t)(v1 - v2);
 
-    /* TODO: need to handle the case if v2 roll over to 0 */
-    if (v1 > v2) {
+    if (diff > 0) {
         ret = 1;
-    } else if (v1 < v2) {
+    } else if (diff < 0) {
         ret = -1;
     }
 
     return ret;
 }
 
+/*===========================================================================
+ * FUNCTION   : mm_channel_superbuf_index_reset
+ *
+ * DESCRIPTION: empty the frame index of a superbuf queue
+ *
+ * PARAMETERS :
+ *   @queue   : superbuf queue
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void mm_channel_superbuf_index_reset(mm_channel_queue_t *queue)
+{
+    memset(queue->frame_index, 0, sizeof(queue->frame_index));
+    queue->frame_index_cnt = 0;
+    queue->frame_index_low = 0;
+    queue->frame_index_high = 0;
+    queue->frame_index_valid = TRUE;
+    queue->frame_index_retry = 0;
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_channel_superbuf_index_rebuild
+ *
+ * DESCRIPTION: index all unmatched super bufs of the queue again. The index
+ *              stays invalid if they are still further apart than its window,
+ *              and is tried again after frame_index_retry more buffers.
+ *              Queue lock must be held.
+ *
+ * PARAMETERS :
+ *   @queue   : superbuf queue
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void mm_channel_superbuf_index_rebuild(mm_channel_queue_t *queue)
+{
+    struct cam_list *head = &queue->que.head.list;
+    struct cam_list *pos = NULL;
+    cam_node_t* node = NULL;
+    mm_channel_queue_node_t* super_buf = NULL;
+
+    mm_channel_superbuf_index_reset(queue);
+    for (pos = head->next; (pos != head) && queue->frame_index_valid; pos = pos->next) {
+        node = member_of(pos, cam_node_t, list);
+        super_buf = (mm_channel_queue_node_t*)node->data;
+        if ((NULL != super_buf) && !super_buf->matched) {
+            mm_channel_superbuf_index_add(queue, node);
+        }
+    }
+    if (!queue->frame_index_valid) {
+        queue->frame_index_retry = MM_CHANNEL_SUPERBUF_INDEX_SIZE;
+    }
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_channel_superbuf_index_add
+ *
+ * DESCRIPTION: add an unmatched super buf to the frame index. Invalidates the
+ *              index if its slot is taken by another frame idx.
+ *
+ * PARAMETERS :
+ *   @queue   : superbuf queue
+ *   @node    : queue node of the super buf
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void mm_channel_superbuf_index_add(mm_channel_queue_t *queue, cam_node_t *node)
+{
+    uint32_t frame_idx = ((mm_channel_queue_node_t*)node->data)->frame_idx;
+    uint32_t slot = frame_idx & (MM_CHANNEL_SUPERBUF_INDEX_SIZE - 1);
+
+    if (!queue->frame_index_valid) {
+        return;
+    }
+    if (NULL != queue->frame_index[slot]) {
+        LOGD("frame %d out of index window, queue walk until it drains", frame_idx);
+        queue->frame_index_valid = FALSE;
+        return;
+    }
+
+    queue->frame_index[slot] = node;
+    if (0 == queue->frame_index_cnt++) {
+        queue->frame_index_low = frame_idx;
+        queue->frame_index_high = frame_idx;
+    } else if (mm_channel_util_seq_comp_w_rollover(frame_idx, queue->frame_index_low) < 0) {
+        queue->frame_index_low = frame_idx;
+    } else if (mm_channel_util_seq_comp_w_rollover(frame_idx, queue->frame_index_high) > 0) {
+        queue->frame_index_high = frame_idx;
+    }
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_channel_superbuf_index_del
+ *
+ * DESCRIPTION: remove a super buf from the frame index, if it is indexed
+ *
+ * PARAMETERS :
+ *   @queue   : superbuf queue
+ *   @node    : queue node of the super buf
+ *
+ * RETURN     : none
+ *==========================================================================*/
+void mm_channel_superbuf_index_del(mm_channel_queue_t *queue, cam_node_t *node)
+{
+    uint32_t frame_idx = ((mm_channel_queue_node_t*)node->data)->frame_idx;
+    uint32_t slot = frame_idx & (MM_CHANNEL_SUPERBUF_INDEX_SIZE - 1);
+
+    if (queue->frame_index[slot] == node) {
+        queue->frame_index[slot] = NULL;
+        queue->frame_index_cnt--;
+    }
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_channel_superbuf_index_find
+ *
+ * DESCRIPTION: look up the unmatched super buf of a frame idx
+ *
+ * PARAMETERS :
+ *   @queue     : superbuf queue
+ *   @frame_idx : frame idx
+ *
+ * RETURN     : queue node of the super buf, NULL if there is none
+ *==========================================================================*/
+cam_node_t* mm_channel_superbuf_index_find(mm_channel_queue_t *queue,
+        uint32_t frame_idx)
+{
+    cam_node_t* node =
+            queue->frame_index[frame_idx & (MM_CHANNEL_SUPERBUF_INDEX_SIZE - 1)];
+
+    if ((NULL != node) &&
+            (((mm_channel_queue_node_t*)node->data)->frame_idx == frame_idx)) {
+        return node;
+    }
+    return NULL;
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_channel_superbuf_index_first
+ *
+ * DESCRIPTION: find the unmatched super buf with the lowest frame idx in a
+ *              range. Searching from the low bound moves it up to the result.
+ *
+ * PARAMETERS :
+ *   @queue   : superbuf queue
+ *   @from    : lowest frame idx of the range
+ *   @to      : highest frame idx of the range
+ *
+ * RETURN     : queue node of the super buf, NULL if there is none
+ *==========================================================================*/
+cam_node_t* mm_channel_superbuf_index_first(mm_channel_queue_t *queue,
+        uint32_t from, uint32_t to)
+{
+    cam_node_t* node = NULL;
+    cam_node_t* first = NULL;
+    uint32_t first_idx = 0;
+    uint32_t frame_idx, i;
+    uint8_t from_low;
+
+    if (0 == queue->frame_index_cnt) {
+        return NULL;
+    }
+    if (mm_channel_util_seq_comp_w_rollover(from, queue->frame_index_low) <= 0) {
+        from = queue->frame_index_low;
+    }
+    if (mm_channel_util_seq_comp_w_rollover(to, queue->frame_index_high) > 0) {
+        to = queue->frame_index_high;
+    }
+    if (mm_channel_util_seq_comp_w_rollover(from, to) > 0) {
+        return NULL;
+    }
+    from_low = (from == queue->frame_index_low);
+
+    if ((to - from) < MM_CHANNEL_SUPERBUF_INDEX_SIZE) {
+        for (frame_idx = from; ; frame_idx++) {
+            first = mm_channel_superbuf_index_find(queue, frame_idx);
+            if ((NULL != first) || (frame_idx == to)) {
+                break;
+            }
+        }
+        if (from_low) {
+            queue->frame_index_low = (NULL != first) ? frame_idx : to + 1;
+        }
+        return first;
+    }
+
+    /* range is wider than the index window, check every slot */
+    for (i = 0; i < MM_CHANNEL_SUPERBUF_INDEX_SIZE; i++) {
+        node = queue->frame_index[i];
+        if (NULL == node) {
+            continue;
+        }
+        frame_idx = ((mm_channel_queue_node_t*)node->data)->frame_idx;
+        if ((mm_channel_util_seq_comp_w_rollover(frame_idx, from) >= 0) &&
+                (mm_channel_util_seq_comp_w_rollover(frame_idx, to) <= 0) &&
+                ((NULL == first) ||
+                (mm_channel_util_seq_comp_w_rollover(frame_idx, first_idx) < 0))) {
+            first = node;
+            first_idx = frame_idx;
+        }
+    }
+    if (from_low && (NULL != first)) {
+        queue->frame_index_low = first_idx;
+    }
+    return first;
+}
+
 /*===========================================================================
  * FUNCTION   : mm_channel_validate_super_buf.
  *
@@ -2772,6 +3006,16 @@ int8_t mm_channel_validate_super_buf(mm_channel_t* ch_obj,
 
     /* comp */
     pthread_mutex_lock(&queue->que.lock);
+    if (queue->frame_index_enabled && queue->frame_index_valid) {
+        /* only unmatched super bufs can be expected frames */
+        node = mm_channel_superbuf_index_find(queue, buf_info->frame_idx);
+        if ((NULL != node) &&
+                ((mm_channel_queue_node_t*)node->data)->expected_frame) {
+            ret = 1;
+        }
+        pthread_mutex_unlock(&queue->que.lock);
+        return ret;
+    }
     head = &queue->que.head.list;
     /* get the last one in the queue which is possibly having no matching */
     pos = head->next;
@@ -3126,7 +3370,7 @@ int32_t mm_channel_superbuf_comp_and_enqueue(
     struct cam_list *head = NULL;
     struct cam_list *pos = NULL;
     mm_channel_queue_node_t* super_buf = NULL;
-    uint8_t buf_s_idx, i, found_super_buf, unmatched_bundles;
+    uint8_t buf_s_idx, i, found_super_buf, unmatched_bundles, use_index;
     struct cam_list *last_buf, *insert_before_buf, *last_buf_ptr;
 
     LOGD("E");
@@ -3176,7 +3420,44 @@ int32_t mm_channel_superbuf_comp_and_enqueue(
     insert_before_buf = NULL;
     last_buf_ptr = NULL;
 
-    while (pos != head) {
+    /* low priority bundling matches on more than the frame idx */
+    use_index = queue->frame_index_enabled &&
+            (queue->attr.priority != MM_CAMERA_SUPER_BUF_PRIORITY_LOW);
+    if (!use_index) {
+        queue->frame_index_valid = FALSE;
+    } else if (!queue->frame_index_valid) {
+        if (0 == queue->frame_index_retry) {
+            mm_channel_superbuf_index_rebuild(queue);
+        } else {
+            queue->frame_index_retry--;
+        }
+    }
+
+    if (use_index && queue->frame_index_valid) {
+        /* unmatched super bufs are kept in frame idx order, so the first
+         * older and first newer ones in the queue are the closest in the index */
+        pos = head;
+        node = mm_channel_superbuf_index_find(queue, buf_info->frame_idx);
+        if (NULL != node) {
+            found_super_buf = 1;
+            pos = &node->list;
+            super_buf = (mm_channel_queue_node_t*)node->data;
+        } else {
+            unmatched_bundles = (uint8_t)queue->frame_index_cnt;
+            node = mm_channel_superbuf_index_first(queue, buf_info->frame_idx + 1,
+                    queue->frame_index_high);
+            if (NULL != node) {
+                insert_before_buf = &node->list;
+            }
+        }
+        node = mm_channel_superbuf_index_first(queue, queue->frame_index_low,
+                buf_info->frame_idx - 1);
+        if (NULL != node) {
+            last_buf = &node->list;
+        }
+    }
+
+    while ((!use_index || !queue->frame_index_valid) && (pos != head)) {
         node = member_of(pos, cam_node_t, list);
         super_buf = (mm_channel_queue_node_t*)node->data;
 
@@ -3213,12 +3494,14 @@ int32_t mm_channel_superbuf_comp_and_enqueue(
             } else {
                 unmatched_bundles++;
                 if ( NULL == last_buf ) {
-                    if ( super_buf->frame_idx < buf_info->frame_idx ) {
+                    if (mm_channel_util_seq_comp_w_rollover(super_buf->frame_idx,
+                            buf_info->frame_idx) < 0) {
                         last_buf = pos;
                     }
                 }
                 if ( NULL == insert_before_buf ) {
-                    if ( super_buf->frame_idx > buf_info->frame_idx ) {
+                    if (mm_channel_util_seq_comp_w_rollover(super_buf->frame_idx,
+                            buf_info->frame_idx) > 0) {
                         insert_before_buf = pos;
                     }
                 }
@@ -3249,6 +3532,7 @@ int32_t mm_channel_superbuf_comp_and_enqueue(
         }
 
         if (super_buf->matched) {
+            mm_channel_superbuf_index_del(queue, member_of(pos, cam_node_t, list));
             if (ch_obj->match_meta) {
                 mm_channel_fill_meta_frame_id(ch_obj, super_buf);
             }
@@ -3272,9 +3556,7 @@ int32_t mm_channel_superbuf_comp_and_enqueue(
 
             queue->match_cnt++;
             if (ch_obj->bundle.superbuf_queue.attr.enable_frame_sync) {
-                pthread_mutex_lock(&fs_lock);
                 mm_frame_sync_add(buf_info->frame_idx, ch_obj);
-                pthread_mutex_unlock(&fs_lock);
             }
             /* Any older unmatched buffer need to be released */
             if ( last_buf ) {
@@ -3289,6 +3571,7 @@ int32_t mm_channel_superbuf_comp_and_enqueue(
                         }
                         queue->que.size--;
                         last_buf = last_buf->next;
+                        mm_channel_superbuf_index_del(queue, node);
                         cam_list_del_node(&node->list);
                         free(node);
                         free(super_buf);
@@ -3326,6 +3609,7 @@ int32_t mm_channel_superbuf_comp_and_enqueue(
                     }
                     queue->que.size--;
                     last_buf_ptr = last_buf_ptr->next;
+                    mm_channel_superbuf_index_del(queue, node);
                     cam_list_del_node(&node->list);
                     free(node);
                     free(super_buf);
@@ -3344,6 +3628,7 @@ int32_t mm_channel_superbuf_comp_and_enqueue(
                     }
                 }
                 queue->que.size--;
+                mm_channel_superbuf_index_del(queue, node);
                 cam_list_del_node(&node->list);
                 free(node);
                 free(super_buf);
@@ -3384,10 +3669,10 @@ int32_t mm_channel_superbuf_comp_and_enqueue(
                     queue->expected_frame_id = buf_info->frame_idx + queue->attr.post_frame_skip;
                     queue->match_cnt++;
                     if (ch_obj->bundle.superbuf_queue.attr.enable_frame_sync) {
-                        pthread_mutex_lock(&fs_lock);
                         mm_frame_sync_add(buf_info->frame_idx, ch_obj);
-                        pthread_mutex_unlock(&fs_lock);
                     }
+                } else {
+                    mm_channel_superbuf_index_add(queue, new_node);
                 }
                 /* In low priority queue, this will become a 'meta only' superbuf. Set the
                 unmatched_frame_idx so that the upcoming stream buffers (other than meta)
@@ -3451,14 +3736,13 @@ mm_channel_queue_node_t* mm_channel_superbuf_dequeue_internal(
         }
         if (NULL != super_buf) {
             /* remove from the queue */
+            mm_channel_superbuf_index_del(queue, node);
             cam_list_del_node(&node->list);
             queue->que.size--;
             if (super_buf->matched == TRUE) {
                 queue->match_cnt--;
                 if (ch_obj->bundle.superbuf_queue.attr.enable_frame_sync) {
-                    pthread_mutex_lock(&fs_lock);
-                    mm_frame_sync_remove(super_buf->frame_idx);
-                    pthread_mutex_unlock(&fs_lock);
+                    mm_frame_sync_remove(super_buf->frame_idx, ch_obj);
                 }
             }
             free(node);
@@ -3871,22 +4155,50 @@ int32_t mm_channel_superbuf_flush_matched(mm_channel_t* my_obj,
 }
 
 
+/*===========================================================================
+ * FUNCTION   : mm_frame_sync_init
+ *
+ * DESCRIPTION: Initialize the frame sync groups, once per process
+ *
+ * RETURN     : None
+ *==========================================================================*/
+static void mm_frame_sync_init(void) {
+    uint8_t i;
+    for (i = 0; i < MM_CAMERA_FRAME_SYNC_GROUPS; i++) {
+        pthread_mutex_init(&fs[i].lock, NULL);
+        mm_frame_sync_reset(&fs[i]);
+    }
+}
+
 /*===========================================================================
  * FUNCTION   : mm_frame_sync_reset
  *
- * DESCRIPTION: Reset Frame sync info
+ * DESCRIPTION: Reset Frame sync info of a group
+ *
+ * PARAMETERS :
+ *   @group   : frame sync group
  *
  * RETURN     : None
  *==========================================================================*/
-void mm_frame_sync_reset() {
-    memset(&fs, 0x0, sizeof(fs));
+void mm_frame_sync_reset(mm_channel_frame_sync_info_t *group) {
+    group->master = NULL;
+    group->num_cam = 0;
+    group->pos = 0;
+    memset(group->node, 0x0, sizeof(group->node));
+    memset(group->node_index, -1, sizeof(group->node_index));
+    group->num_matched = 0;
+    memset(group->ch_obj, 0x0, sizeof(group->ch_obj));
+    memset(group->cb, 0x0, sizeof(group->cb));
     LOGD("Reset Done");
 }
 
 /*===========================================================================
  * FUNCTION   : mm_frame_sync_register_channel
  *
- * DESCRIPTION: Register Channel for frame sync
+ * DESCRIPTION: Register Channel for frame sync. Channels linked to the same
+ *              master channel (see mm_channel_reg_frame_sync) are synced in
+ *              one group, whatever order they start in. A channel linked to
+ *              no other channel has nothing to sync with and is rejected.
  *
  * PARAMETERS :
  *   @ch_obj  : channel object
@@ -3896,34 +4208,56 @@ void mm_frame_sync_reset() {
  *              -1 -- failure
  *==========================================================================*/
 int32_t mm_frame_sync_register_channel(mm_channel_t *ch_obj) {
-    // Lock frame sync info
+    mm_channel_frame_sync_info_t *group = NULL;
+    mm_channel_t *master = NULL;
+    uint8_t i = 0;
+
+    pthread_once(&fs_once, mm_frame_sync_init);
+    if (!ch_obj) {
+        LOGE("Error!! invalid channel");
+        return -1;
+    }
+    master = (NULL != ch_obj->master_ch_obj) ? ch_obj->master_ch_obj : ch_obj;
+    if ((master == ch_obj) && (0 == ch_obj->num_s_cnt)) {
+        LOGE("Error!! channel %p is not linked to another channel", ch_obj);
+        return -1;
+    }
+    // Lock frame sync groups
     pthread_mutex_lock(&fs_lock);
-    if ((fs.num_cam >= MAX_NUM_CAMERA_PER_BUNDLE) || (!ch_obj)) {
-        LOGE("Error!! num cam(%d) is out of range ",
-                 fs.num_cam);
+    for (i = 0; (i < MM_CAMERA_FRAME_SYNC_GROUPS) && (NULL == group); i++) {
+        if ((fs[i].num_cam > 0) && (fs[i].master == master)) {
+            group = &fs[i];
+        }
+    }
+    for (i = 0; (i < MM_CAMERA_FRAME_SYNC_GROUPS) && (NULL == group); i++) {
+        if (fs[i].num_cam == 0) {
+            group = &fs[i];
+        }
+    }
+    if ((NULL == group) || (group->num_cam >= MAX_NUM_CAMERA_PER_BUNDLE)) {
+        LOGE("Error!! no frame sync group left for master channel %p", master);
         pthread_mutex_unlock(&fs_lock);
         return -1;
     }
-    if (fs.num_cam == 0) {
+
+    pthread_mutex_lock(&group->lock);
+    if (group->num_cam == 0) {
         LOGH("First channel registering!!");
-        mm_frame_sync_reset();
+        mm_frame_sync_reset(group);
+        group->master = master;
     }
-    uint8_t i = 0;
     for (i = 0; i < MAX_NUM_CAMERA_PER_BUNDLE; i++) {
-        if (fs.ch_obj[i] == NULL) {
-            fs.ch_obj[i] = ch_obj;
-            fs.cb[i] = ch_obj->bundle.super_buf_notify_cb;
-            fs.num_cam++;
-            LOGD("DBG_FS index %d", i);
+        if (group->ch_obj[i] == NULL) {
+            group->ch_obj[i] = ch_obj;
+            group->cb[i] = ch_obj->bundle.super_buf_notify_cb;
+            group->num_cam++;
+            LOGD("DBG_FS group %d index %d", (int)(group - fs), i);
             break;
         }
     }
-    if (i >= MAX_NUM_CAMERA_PER_BUNDLE) {
-        LOGH("X, DBG_FS Cannot register channel!!");
-        pthread_mutex_unlock(&fs_lock);
-        return -1;
-    }
-    LOGH("num_cam %d ", fs.num_cam);
+    ch_obj->fs_group = group;
+    LOGH("num_cam %d ", group->num_cam);
+    pthread_mutex_unlock(&group->lock);
     pthread_mutex_unlock(&fs_lock);
     return 0;
 }
@@ -3941,42 +4275,171 @@ int32_t mm_frame_sync_register_channel(mm_channel_t *ch_obj) {
  *              -1 -- failure
  *==========================================================================*/
 int32_t mm_frame_sync_unregister_channel(mm_channel_t *ch_obj) {
+    mm_channel_frame_sync_info_t *group = NULL;
     uint8_t i = 0;
-    // Lock frame sync info
-    pthread_mutex_lock(&fs_lock);
-    if (!fs.num_cam || !ch_obj) {
+
+    if (!ch_obj || (NULL == ch_obj->fs_group)) {
         LOGH("X, DBG_FS: channel not found  !!");
-        // Lock frame sync info
-        pthread_mutex_unlock(&fs_lock);
         return -1;
     }
+    // Lock frame sync groups
+    pthread_mutex_lock(&fs_lock);
+    group = ch_obj->fs_group;
+    pthread_mutex_lock(&group->lock);
     for (i = 0; i < MAX_NUM_CAMERA_PER_BUNDLE; i++) {
-        if (fs.ch_obj[i] == ch_obj) {
+        if (group->ch_obj[i] == ch_obj) {
             LOGD("found ch_obj at i (%d) ", i);
             break;
         }
     }
     if (i < MAX_NUM_CAMERA_PER_BUNDLE) {
         LOGD("remove channel info ");
-        fs.ch_obj[i] = NULL;
-        fs.cb[i] = NULL;
-        fs.num_cam--;
+        group->ch_obj[i] = NULL;
+        group->cb[i] = NULL;
+        group->num_cam--;
     } else {
         LOGD("DBG_FS Channel not found ");
     }
-    if (fs.num_cam == 0) {
-        mm_frame_sync_reset();
+    ch_obj->fs_group = NULL;
+    if (group->num_cam == 0) {
+        mm_frame_sync_reset(group);
     }
-    LOGH("X, fs.num_cam %d", fs.num_cam);
+    LOGH("X, num_cam %d", group->num_cam);
+    pthread_mutex_unlock(&group->lock);
     pthread_mutex_unlock(&fs_lock);
     return 0;
 }
 
+/*===========================================================================
+ * FUNCTION   : mm_frame_sync_heap_fix
+ *
+ * DESCRIPTION: move a matched heap entry up or down to its place
+ *
+ * PARAMETERS :
+ *   @group   : frame sync group
+ *   @pos     : heap position of the entry
+ *
+ * RETURN     : None
+ *==========================================================================*/
+static void mm_frame_sync_heap_fix(mm_channel_frame_sync_info_t *group, uint8_t pos) {
+    uint8_t *heap = group->matched_heap;
+    uint8_t index = heap[pos];
+    uint32_t frame_idx = group->node[index].frame_idx;
+    uint8_t parent, child;
+
+    while (pos > 0) {
+        parent = (uint8_t)((pos - 1) / 2);
+        if (mm_channel_util_seq_comp_w_rollover(frame_idx,
+                group->node[heap[parent]].frame_idx) >= 0) {
+            break;
+        }
+        heap[pos] = heap[parent];
+        group->node[heap[pos]].heap_pos = pos;
+        pos = parent;
+    }
+    while ((child = (uint8_t)(2 * pos + 1)) < group->num_matched) {
+        if ((child + 1 < group->num_matched) &&
+                (mm_channel_util_seq_comp_w_rollover(group->node[heap[child + 1]].frame_idx,
+                group->node[heap[child]].frame_idx) < 0)) {
+            child++;
+        }
+        if (mm_channel_util_seq_comp_w_rollover(group->node[heap[child]].frame_idx,
+                frame_idx) >= 0) {
+            break;
+        }
+        heap[pos] = heap[child];
+        group->node[heap[pos]].heap_pos = pos;
+        pos = child;
+    }
+    heap[pos] = index;
+    group->node[index].heap_pos = pos;
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_frame_sync_index_del
+ *
+ * DESCRIPTION: remove a node from the frame idx index, moving back the
+ *              entries probed past it
+ *
+ * PARAMETERS :
+ *   @group   : frame sync group
+ *   @index   : node array index
+ *
+ * RETURN     : None
+ *==========================================================================*/
+static void mm_frame_sync_index_del(mm_channel_frame_sync_info_t *group, int8_t index) {
+    const uint8_t mask = MM_CAMERA_FRAME_SYNC_INDEX_SIZE - 1;
+    uint8_t hole = group->node[index].frame_idx & mask;
+    uint8_t next, home;
+
+    while (group->node_index[hole] != index) {
+        if (group->node_index[hole] < 0) {
+            return;
+        }
+        hole = (hole + 1) & mask;
+    }
+    for (next = (hole + 1) & mask; group->node_index[next] >= 0; next = (next + 1) & mask) {
+        home = group->node[group->node_index[next]].frame_idx & mask;
+        /* entries whose home slot lies between the hole and them stay */
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            group->node_index[hole] = group->node_index[next];
+            hole = next;
+        }
+    }
+    group->node_index[hole] = -1;
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_frame_sync_del_node
+ *
+ * DESCRIPTION: free a frame sync node. Group lock must be held.
+ *
+ * PARAMETERS :
+ *   @group   : frame sync group
+ *   @index   : node array index
+ *
+ * RETURN     : None
+ *==========================================================================*/
+static void mm_frame_sync_del_node(mm_channel_frame_sync_info_t *group, int8_t index) {
+    mm_channel_sync_node_t *node = &group->node[index];
+    uint8_t pos;
+
+    if (!node->frame_idx) {
+        return;
+    }
+    mm_frame_sync_index_del(group, index);
+    if (node->matched) {
+        pos = node->heap_pos;
+        group->num_matched--;
+        if (pos < group->num_matched) {
+            group->matched_heap[pos] = group->matched_heap[group->num_matched];
+            mm_frame_sync_heap_fix(group, pos);
+        }
+    }
+    memset(node, 0x00, sizeof(mm_channel_sync_node_t));
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_frame_sync_set_matched
+ *
+ * DESCRIPTION: mark a frame sync node as present in all channels
+ *
+ * PARAMETERS :
+ *   @group   : frame sync group
+ *   @index   : node array index
+ *
+ * RETURN     : None
+ *==========================================================================*/
+static void mm_frame_sync_set_matched(mm_channel_frame_sync_info_t *group, int8_t index) {
+    group->node[index].matched = 1;
+    group->matched_heap[group->num_matched] = (uint8_t)index;
+    mm_frame_sync_heap_fix(group, group->num_matched++);
+}
 
 /*===========================================================================
  * FUNCTION   : mm_frame_sync_add
  *
- * DESCRIPTION: Add frame info into frame sync nodes
+ * DESCRIPTION: Add frame info into frame sync nodes of the channel's group
  *
  * PARAMETERS :
  *   @frame_id  : frame id to be added
@@ -3987,17 +4450,19 @@ int32_t mm_frame_sync_unregister_channel(mm_channel_t *ch_obj) {
  *              -1 -- failure
  *==========================================================================*/
 int32_t mm_frame_sync_add(uint32_t frame_id, mm_channel_t *ch_obj) {
+    mm_channel_frame_sync_info_t *group = NULL;
 
     LOGD("E, frame id %d ch_obj %p", frame_id, ch_obj);
-    if (!frame_id || !ch_obj) {
+    if (!frame_id || !ch_obj || (NULL == (group = ch_obj->fs_group))) {
         LOGH("X : Error, cannot add sync frame !!");
         return -1;
     }
 
+    pthread_mutex_lock(&group->lock);
     int8_t ch_idx = -1;
     uint8_t i = 0;
     for (i = 0; i < MAX_NUM_CAMERA_PER_BUNDLE; i++) {
-        if (fs.ch_obj[i] == ch_obj) {
+        if (group->ch_obj[i] == ch_obj) {
             ch_idx = i;
             LOGD("ch id %d ", ch_idx);
             break;
@@ -4005,67 +4470,99 @@ int32_t mm_frame_sync_add(uint32_t frame_id, mm_channel_t *ch_obj) {
     }
     if (ch_idx < 0) {
         LOGH("X : DBG_FS ch not found!!");
+        pthread_mutex_unlock(&group->lock);
         return -1;
     }
-    int8_t index = mm_frame_sync_find_frame_index(frame_id);
-    if ((index >= 0) && (index < MM_CAMERA_FRAME_SYNC_NODES)) {
-        fs.node[index].frame_valid[ch_idx] = 1;
-    } else if (index < 0) {
-        if (fs.pos >= MM_CAMERA_FRAME_SYNC_NODES) {
-            fs.pos = 0;
-        }
-        index = fs.pos;
-        memset(&fs.node[index], 0x00, sizeof(mm_channel_sync_node_t));
-        fs.pos++;
-        fs.node[index].frame_idx = frame_id;
-        fs.node[index].frame_valid[ch_idx] = 1;
-        if (fs.num_cam == 1) {
+    int8_t index = mm_frame_sync_find_frame_index(group, frame_id);
+    if (index < 0) {
+        const uint8_t mask = MM_CAMERA_FRAME_SYNC_INDEX_SIZE - 1;
+        uint8_t slot = frame_id & mask;
+
+        if (group->pos >= MM_CAMERA_FRAME_SYNC_NODES) {
+            group->pos = 0;
+        }
+        index = group->pos;
+        mm_frame_sync_del_node(group, index);
+        group->pos++;
+        group->node[index].frame_idx = frame_id;
+        /* index has more slots than there are nodes, one is free */
+        while (group->node_index[slot] >= 0) {
+            slot = (slot + 1) & mask;
+        }
+        group->node_index[slot] = index;
+        if (group->num_cam == 1) {
             LOGD("Single camera frame %d , matched ", frame_id);
-            fs.node[index].matched = 1;
+            mm_frame_sync_set_matched(group, index);
         }
     }
+    group->node[index].frame_valid[ch_idx] = 1;
     uint8_t frames_valid = 0;
-    if (!fs.node[index].matched) {
+    if (!group->node[index].matched) {
         for (i = 0; i < MAX_NUM_CAMERA_PER_BUNDLE; i++) {
-            if (fs.node[index].frame_valid[i]) {
+            if (group->node[index].frame_valid[i]) {
                 frames_valid++;
             }
         }
-        if (frames_valid == fs.num_cam) {
-            fs.node[index].matched = 1;
+        if (frames_valid == group->num_cam) {
+            mm_frame_sync_set_matched(group, index);
             LOGD("dual camera frame %d , matched ",
                      frame_id);
         }
     }
+    pthread_mutex_unlock(&group->lock);
     return 0;
 }
 
+/*===========================================================================
+ * FUNCTION   : mm_frame_sync_group_remove
+ *
+ * DESCRIPTION: Remove frame info from frame sync nodes. Group lock must be held.
+ *
+ * PARAMETERS :
+ *   @group     : frame sync group
+ *   @frame_id  : frame id to be removed
+ *
+ * RETURN     : None
+ *==========================================================================*/
+static void mm_frame_sync_group_remove(mm_channel_frame_sync_info_t *group,
+        uint32_t frame_id) {
+    int8_t index = mm_frame_sync_find_frame_index(group, frame_id);
+    if (index >= 0) {
+        LOGD("Removing sync frame %d", frame_id);
+        mm_frame_sync_del_node(group, index);
+    }
+}
+
 /*===========================================================================
  * FUNCTION   : mm_frame_sync_remove
  *
- * DESCRIPTION: Remove frame info from frame sync nodes
+ * DESCRIPTION: Remove frame info from frame sync nodes of the channel's group
  *
  * PARAMETERS :
  *   @frame_id  : frame id to be removed
+ *   @ch_obj    : channel object
  *
  * RETURN     : int32_t type of status
  *              0  -- success
  *              -1 -- failure
  *==========================================================================*/
-int32_t mm_frame_sync_remove(uint32_t frame_id) {
-    int8_t index = -1;
+int32_t mm_frame_sync_remove(uint32_t frame_id, mm_channel_t *ch_obj) {
+    mm_channel_frame_sync_info_t *group = NULL;
 
     LOGD("E, frame_id %d", frame_id);
-    if (!frame_id) {
+    if (!frame_id || !ch_obj) {
         LOGE("X, DBG_FS frame id invalid");
         return -1;
     }
-
-    index = mm_frame_sync_find_frame_index(frame_id);
-    if ((index >= 0) && (index < MM_CAMERA_FRAME_SYNC_NODES)) {
-        LOGD("Removing sync frame %d", frame_id);
-        memset(&fs.node[index], 0x00, sizeof(mm_channel_sync_node_t));
+    group = ch_obj->fs_group;
+    if (NULL == group) {
+        LOGH("X, DBG_FS channel not registered");
+        return -1;
     }
+
+    pthread_mutex_lock(&group->lock);
+    mm_frame_sync_group_remove(group, frame_id);
+    pthread_mutex_unlock(&group->lock);
     LOGD("X ");
     return 0;
 }
@@ -4073,59 +4570,55 @@ int32_t mm_frame_sync_remove(uint32_t frame_id) {
 /*===========================================================================
  * FUNCTION   : mm_frame_sync_find_matched
  *
- * DESCRIPTION: Find  a matched sync frame from the node array
+ * DESCRIPTION: Find the oldest matched sync frame of a group.
+ *              Group lock must be held.
  *
  * PARAMETERS :
- *   @oldest  : If enabled, find oldest matched frame.,
- *                  If not enabled, get the first matched frame found
+ *   @group   : frame sync group
  *
  * RETURN     : unt32_t type of status
  *              0  -- If no matched frames found
  *              frame index: inf matched frame found
  *==========================================================================*/
-uint32_t mm_frame_sync_find_matched(uint8_t oldest) {
-    LOGH("E, oldest %d ", oldest);
-    uint8_t i = 0;
+uint32_t mm_frame_sync_find_matched(mm_channel_frame_sync_info_t *group) {
     uint32_t frame_idx = 0;
-    uint32_t curr_frame_idx = 0;
-    for (i = 0; i < MM_CAMERA_FRAME_SYNC_NODES; i++) {
-        if (fs.node[i].matched) {
-            curr_frame_idx = fs.node[i].frame_idx;
-            if (!frame_idx) {
-                frame_idx = curr_frame_idx;
-            }
-            if (!oldest) {
-                break;
-            } else if (frame_idx > curr_frame_idx) {
-                frame_idx = curr_frame_idx;
-            }
-        }
+    if (group->num_matched > 0) {
+        frame_idx = group->node[group->matched_heap[0]].frame_idx;
     }
-    LOGH("X, oldest %d frame idx %d", oldest, frame_idx);
+    LOGH("X, frame idx %d", frame_idx);
     return frame_idx;
 }
 
 /*===========================================================================
  * FUNCTION   : mm_frame_sync_find_frame_index
  *
- * DESCRIPTION: Find sync frame index if present
+ * DESCRIPTION: Find sync frame index if present. Group lock must be held.
  *
  * PARAMETERS :
+ *   @group     : frame sync group
  *   @frame_id  : frame id to be searched
  *
  * RETURN     : int8_t type of status
  *              -1  -- If desired frame not found
  *              index: node array index if frame is found
  *==========================================================================*/
-int8_t mm_frame_sync_find_frame_index(uint32_t frame_id) {
+int8_t mm_frame_sync_find_frame_index(mm_channel_frame_sync_info_t *group,
+        uint32_t frame_id) {
+    const uint8_t mask = MM_CAMERA_FRAME_SYNC_INDEX_SIZE - 1;
+    uint8_t slot = frame_id & mask;
+    int8_t index = -1;
+    uint8_t i = 0;
 
     LOGD("E, frame_id %d", frame_id);
-    int8_t index = -1, i = 0;
-    for (i = 0; i < MM_CAMERA_FRAME_SYNC_NODES; i++) {
-        if (fs.node[i].frame_idx == frame_id) {
-            index = i;
+    for (i = 0; i < MM_CAMERA_FRAME_SYNC_INDEX_SIZE; i++) {
+        if (group->node_index[slot] < 0) {
             break;
         }
+        if (group->node[group->node_index[slot]].frame_idx == frame_id) {
+            index = group->node_index[slot];
+            break;
+        }
+        slot = (slot + 1) & mask;
     }
     LOGD("X index :%d", index);
     return index;
@@ -4134,48 +4627,69 @@ int8_t mm_frame_sync_find_frame_index(uint32_t frame_id) {
 /*===========================================================================
  * FUNCTION   : mm_frame_sync_lock_queues
  *
- * DESCRIPTION: Lock all channel queues present in node info
+ * DESCRIPTION: Lock the queues of all channels in the frame sync group of a
+ *              channel, then the group itself
  *
- * RETURN     : None
+ * PARAMETERS :
+ *   @ch_obj  : channel object
+ *
+ * RETURN     : locked frame sync group, NULL if the channel has none
  *==========================================================================*/
-void mm_frame_sync_lock_queues() {
+mm_channel_frame_sync_info_t *mm_frame_sync_lock_queues(mm_channel_t *ch_obj) {
+    mm_channel_frame_sync_info_t *group = ch_obj->fs_group;
+    mm_channel_t *locked[MAX_NUM_CAMERA_PER_BUNDLE];
     uint8_t j = 0;
+
     LOGD("E ");
-    for (j = 0; j < MAX_NUM_CAMERA_PER_BUNDLE; j++) {
-        if (fs.ch_obj[j]) {
-            mm_channel_queue_t *ch_queue =
-                    &fs.ch_obj[j]->bundle.superbuf_queue;
-            if (ch_queue) {
-                pthread_mutex_lock(&ch_queue->que.lock);
-                LOGL("Done locking fs.ch_obj[%d] ", j);
+    if (NULL == group) {
+        return NULL;
+    }
+    for (;;) {
+        memcpy(locked, group->ch_obj, sizeof(locked));
+        for (j = 0; j < MAX_NUM_CAMERA_PER_BUNDLE; j++) {
+            if (locked[j]) {
+                pthread_mutex_lock(&locked[j]->bundle.superbuf_queue.que.lock);
+                LOGL("Done locking ch_obj[%d] ", j);
+            }
+        }
+        pthread_mutex_lock(&group->lock);
+        if (!memcmp(locked, group->ch_obj, sizeof(locked))) {
+            break;
+        }
+        /* a channel registered or left before the group was locked */
+        pthread_mutex_unlock(&group->lock);
+        for (j = 0; j < MAX_NUM_CAMERA_PER_BUNDLE; j++) {
+            if (locked[j]) {
+                pthread_mutex_unlock(&locked[j]->bundle.superbuf_queue.que.lock);
             }
         }
     }
-    pthread_mutex_lock(&fs_lock);
     LOGD("X ");
+    return group;
 }
 
 /*===========================================================================
  * FUNCTION   : mm_frame_sync_unlock_queues
  *
- * DESCRIPTION: Unlock all channel queues
+ * DESCRIPTION: Unlock a frame sync group and the queues of its channels
+ *
+ * PARAMETERS :
+ *   @group   : frame sync group locked by mm_frame_sync_lock_queues
  *
  * RETURN     : None
  *==========================================================================*/
-void mm_frame_sync_unlock_queues() {
+void mm_frame_sync_unlock_queues(mm_channel_frame_sync_info_t *group) {
     // Unlock all queues
+    mm_channel_t *locked[MAX_NUM_CAMERA_PER_BUNDLE];
     uint8_t j = 0;
     LOGD("E ");
-    pthread_mutex_unlock(&fs_lock);
+    memcpy(locked, group->ch_obj, sizeof(locked));
+    pthread_mutex_unlock(&group->lock);
     LOGL("Done unlocking fs ");
     for (j = 0; j < MAX_NUM_CAMERA_PER_BUNDLE; j++) {
-        if (fs.ch_obj[j]) {
-            mm_channel_queue_t *ch_queue =
-                    &fs.ch_obj[j]->bundle.superbuf_queue;
-            if (ch_queue) {
-                pthread_mutex_unlock(&ch_queue->que.lock);
-                LOGL("Done unlocking fs.ch_obj[%d] ", j);
-            }
+        if (locked[j]) {
+            pthread_mutex_unlock(&locked[j]->bundle.superbuf_queue.que.lock);
+            LOGL("Done unlocking ch_obj[%d] ", j);
         }
     }
     LOGD("X ");
@@ -0,0 +1,224 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// System dependencies
+#include <stddef.h>
+#include <string.h>
+
+// Camera dependencies
+#include "mm_camera_interface.h"
+
+/* Location of one entry inside metadata_data_t. Ids without an entry keep a
+ * zero size and are never copied. */
+typedef struct {
+    uint32_t offset;
+    uint32_t size;
+} mm_camera_meta_entry_t;
+
+#define MM_CAMERA_META_ENTRY(PARAM_ID, DATATYPE, COUNT) \
+    [PARAM_ID] = { \
+        (uint32_t)offsetof(metadata_data_t, member_variable_##PARAM_ID), \
+        (uint32_t)sizeof(((metadata_data_t *)0)->member_variable_##PARAM_ID) },
+#define MM_CAMERA_META_NO_ID(PARAM_ID, DATATYPE, COUNT)
+
+static const mm_camera_meta_entry_t mm_camera_meta_table[CAM_INTF_PARM_MAX] = {
+    CAM_INTF_METADATA_ENTRIES(MM_CAMERA_META_ENTRY, MM_CAMERA_META_NO_ID)
+};
+
+/*===========================================================================
+ * FUNCTION   : mm_camera_meta_next_valid
+ *
+ * DESCRIPTION: find the next id flagged in is_valid, skipping runs of unset
+ *              flags a word at a time
+ *
+ * PARAMETERS :
+ *   @meta    : metadata buffer
+ *   @id      : first id to look at
+ *
+ * RETURN     : next valid id, CAM_INTF_PARM_MAX if there is none
+ *==========================================================================*/
+static inline uint32_t mm_camera_meta_next_valid(const metadata_buffer_t *meta,
+        uint32_t id)
+{
+    uint64_t word;
+
+    while (id + sizeof(word) <= CAM_INTF_PARM_MAX) {
+        memcpy(&word, &meta->is_valid[id], sizeof(word));
+        if (word != 0) {
+            break;
+        }
+        id += (uint32_t)sizeof(word);
+    }
+    while ((id < CAM_INTF_PARM_MAX) && !meta->is_valid[id]) {
+        id++;
+    }
+    return id;
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_camera_meta_get_valid_ids
+ *
+ * DESCRIPTION: list the ids flagged valid in a metadata buffer
+ *
+ * PARAMETERS :
+ *   @meta    : metadata buffer
+ *   @ids     : [output] compact list of valid ids, may be NULL to only count
+ *   @max_ids : capacity of ids
+ *
+ * RETURN     : number of valid ids, may exceed max_ids
+ *==========================================================================*/
+uint32_t mm_camera_meta_get_valid_ids(const metadata_buffer_t *meta,
+        uint32_t *ids, uint32_t max_ids)
+{
+    uint32_t count = 0;
+    uint32_t id;
+
+    if (NULL == meta) {
+        return 0;
+    }
+    for (id = mm_camera_meta_next_valid(meta, 0); id < CAM_INTF_PARM_MAX;
+            id = mm_camera_meta_next_valid(meta, id + 1)) {
+        if ((NULL != ids) && (count < max_ids)) {
+            ids[count] = id;
+        }
+        count++;
+    }
+    return count;
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_camera_meta_copy
+ *
+ * DESCRIPTION: sparse replacement for memcpy of a whole metadata_buffer_t.
+ *              The valid table is copied as is and only the entries flagged
+ *              in it are copied; data of entries not flagged valid in dst is
+ *              left as it was.
+ *
+ * PARAMETERS :
+ *   @dst     : destination metadata buffer
+ *   @src     : source metadata buffer
+ *
+ * RETURN     : number of bytes copied
+ *==========================================================================*/
+size_t mm_camera_meta_copy(metadata_buffer_t *dst,
+        const metadata_buffer_t *src)
+{
+    size_t bytes = CAM_INTF_PARM_MAX;
+    uint32_t id;
+
+    if ((NULL == dst) || (NULL == src) || (dst == src)) {
+        return 0;
+    }
+
+    memcpy(dst->is_valid, src->is_valid, CAM_INTF_PARM_MAX);
+    for (id = mm_camera_meta_next_valid(src, 0); id < CAM_INTF_PARM_MAX;
+            id = mm_camera_meta_next_valid(src, id + 1)) {
+        const mm_camera_meta_entry_t *entry = &mm_camera_meta_table[id];
+        memcpy((uint8_t *)&dst->data + entry->offset,
+                (const uint8_t *)&src->data + entry->offset, entry->size);
+        bytes += entry->size;
+    }
+    return bytes;
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_camera_meta_merge
+ *
+ * DESCRIPTION: overlay the valid entries of src onto dst. Entries valid only
+ *              in dst are kept.
+ *
+ * PARAMETERS :
+ *   @dst     : destination metadata buffer
+ *   @src     : source metadata buffer, e.g. a delta
+ *
+ * RETURN     : number of bytes copied
+ *==========================================================================*/
+size_t mm_camera_meta_merge(metadata_buffer_t *dst,
+        const metadata_buffer_t *src)
+{
+    size_t bytes = 0;
+    uint32_t id;
+
+    if ((NULL == dst) || (NULL == src) || (dst == src)) {
+        return 0;
+    }
+
+    for (id = mm_camera_meta_next_valid(src, 0); id < CAM_INTF_PARM_MAX;
+            id = mm_camera_meta_next_valid(src, id + 1)) {
+        const mm_camera_meta_entry_t *entry = &mm_camera_meta_table[id];
+        memcpy((uint8_t *)&dst->data + entry->offset,
+                (const uint8_t *)&src->data + entry->offset, entry->size);
+        dst->is_valid[id] = 1;
+        bytes += entry->size;
+    }
+    return bytes;
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_camera_meta_delta
+ *
+ * DESCRIPTION: collect what changed from prev to cur: entries valid in cur
+ *              that are not valid in prev or hold different bytes. Entries
+ *              only valid in prev are not reported. Merging the delta into
+ *              a copy of prev gives back every valid entry of cur.
+ *
+ * PARAMETERS :
+ *   @delta   : [output] metadata buffer receiving the changed entries
+ *   @cur     : current metadata buffer
+ *   @prev    : previous metadata buffer, NULL to take every valid entry
+ *
+ * RETURN     : number of bytes copied into delta, 0 if nothing changed
+ *==========================================================================*/
+size_t mm_camera_meta_delta(metadata_buffer_t *delta,
+        const metadata_buffer_t *cur, const metadata_buffer_t *prev)
+{
+    size_t bytes = 0;
+    uint32_t id;
+
+    if ((NULL == delta) || (NULL == cur) || (delta == cur) || (delta == prev)) {
+        return 0;
+    }
+
+    clear_metadata_buffer(delta);
+    for (id = mm_camera_meta_next_valid(cur, 0); id < CAM_INTF_PARM_MAX;
+            id = mm_camera_meta_next_valid(cur, id + 1)) {
+        const mm_camera_meta_entry_t *entry = &mm_camera_meta_table[id];
+        const uint8_t *cur_data = (const uint8_t *)&cur->data + entry->offset;
+
+        if ((NULL != prev) && prev->is_valid[id] &&
+                !memcmp(cur_data, (const uint8_t *)&prev->data + entry->offset,
+                entry->size)) {
+            continue;
+        }
+        memcpy((uint8_t *)&delta->data + entry->offset, cur_data, entry->size);
+        delta->is_valid[id] = 1;
+        bytes += entry->size;
+    }
+    return bytes;
+}
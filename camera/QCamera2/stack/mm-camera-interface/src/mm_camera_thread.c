@@ -37,6 +37,7 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <poll.h>
+#include <sys/epoll.h>
 #include <cam_semaphore.h>
 
 #include "mm_camera_dbg.h"
@@ -67,6 +68,14 @@ typedef struct {
     mm_camera_event_t event;
 } mm_camera_sig_evt_t;
 
+/* epoll data of the pipe, poll entries use their index */
+#define MM_CAMERA_EPOLL_PIPE_IDX MAX_STREAM_NUM_IN_BUNDLE
+/* notifications per ready entry and wakeup, before the other entries get a turn */
+#define MM_CAMERA_EPOLL_MAX_DRAIN 8
+/* sleep after a poll error, from MIN doubling up to MAX while errors go on */
+#define MM_CAMERA_POLL_BACKOFF_MIN_US 10
+#define MM_CAMERA_POLL_BACKOFF_MAX_US 10000
+
 
 /*===========================================================================
  * FUNCTION   : mm_camera_poll_sig_async
@@ -199,6 +208,121 @@ static void mm_camera_poll_set_state(mm_camera_poll_thread_t *poll_cb,
     poll_cb->state = state;
 }
 
+/*===========================================================================
+ * FUNCTION   : mm_camera_poll_backoff
+ *
+ * DESCRIPTION: sleep after a failed poll, longer each time it fails in a row
+ *
+ * PARAMETERS :
+ *   @poll_cb : ptr to poll thread object
+ *   @err     : errno of the failed poll
+ *
+ * RETURN     : none
+ *==========================================================================*/
+static void mm_camera_poll_backoff(mm_camera_poll_thread_t *poll_cb, int err)
+{
+    if (EINTR == err) {
+        return;
+    }
+    if (poll_cb->backoff_us < MM_CAMERA_POLL_BACKOFF_MIN_US) {
+        poll_cb->backoff_us = MM_CAMERA_POLL_BACKOFF_MIN_US;
+    } else if (poll_cb->backoff_us < MM_CAMERA_POLL_BACKOFF_MAX_US) {
+        poll_cb->backoff_us *= 2;
+        if (poll_cb->backoff_us > MM_CAMERA_POLL_BACKOFF_MAX_US) {
+            poll_cb->backoff_us = MM_CAMERA_POLL_BACKOFF_MAX_US;
+        }
+    }
+    LOGW("poll failed (%s), retry in %u us", strerror(err), poll_cb->backoff_us);
+    usleep(poll_cb->backoff_us);
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_camera_epoll_update_entries
+ *
+ * DESCRIPTION: register the valid poll entries with the epoll fd. All entries
+ *              are registered again, an fd closed and reopened under the same
+ *              number between two updates is then not missed.
+ *
+ * PARAMETERS :
+ *   @poll_cb : ptr to poll thread object
+ *
+ * RETURN     : none
+ *==========================================================================*/
+static void mm_camera_epoll_update_entries(mm_camera_poll_thread_t *poll_cb)
+{
+    struct epoll_event ev;
+    uint32_t i;
+    uint32_t num_entries = (MM_CAMERA_POLL_TYPE_EVT == poll_cb->poll_type) ?
+            1 : MAX_STREAM_NUM_IN_BUNDLE;
+
+    for (i = 0; i < MAX_STREAM_NUM_IN_BUNDLE; i++) {
+        if (poll_cb->epoll_entry_fds[i] >= 0) {
+            /* fails harmlessly if the fd was already closed */
+            epoll_ctl(poll_cb->epoll_fd, EPOLL_CTL_DEL, poll_cb->epoll_entry_fds[i], NULL);
+            poll_cb->epoll_entry_fds[i] = -1;
+            poll_cb->epoll_changed |= (1U << i);
+        }
+    }
+    poll_cb->epoll_pending = 0;
+
+    for (i = 0; i < num_entries; i++) {
+        if (poll_cb->poll_entries[i].fd < 0) {
+            continue;
+        }
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLET | ((MM_CAMERA_POLL_TYPE_EVT == poll_cb->poll_type) ?
+                EPOLLPRI : (EPOLLIN | EPOLLRDNORM));
+        ev.data.u32 = i;
+        if (epoll_ctl(poll_cb->epoll_fd, EPOLL_CTL_ADD, poll_cb->poll_entries[i].fd, &ev) < 0) {
+            LOGE("epoll add fd %d failed (%s)", poll_cb->poll_entries[i].fd, strerror(errno));
+            continue;
+        }
+        poll_cb->epoll_entry_fds[i] = poll_cb->poll_entries[i].fd;
+        poll_cb->epoll_changed |= (1U << i);
+    }
+}
+
+/*===========================================================================
+ * FUNCTION   : mm_camera_epoll_dispatch
+ *
+ * DESCRIPTION: notify a ready entry until its fd has no more data. Edge
+ *              triggered epoll reports an fd once however many buffers are
+ *              queued on it, and each notify takes one of them.
+ *
+ * PARAMETERS :
+ *   @poll_cb : ptr to poll thread object
+ *   @idx     : poll entry index
+ *
+ * RETURN     : none
+ *==========================================================================*/
+static void mm_camera_epoll_dispatch(mm_camera_poll_thread_t *poll_cb, uint32_t idx)
+{
+    struct pollfd pfd;
+    short events = (MM_CAMERA_POLL_TYPE_EVT == poll_cb->poll_type) ?
+            POLLPRI : (POLLIN | POLLRDNORM);
+    int n;
+
+    poll_cb->epoll_pending &= ~(1U << idx);
+    for (n = 0; n < MM_CAMERA_EPOLL_MAX_DRAIN; n++) {
+        mm_camera_poll_entry_t *entry = &poll_cb->poll_entries[idx];
+        if ((entry->fd < 0) || (entry->fd != poll_cb->epoll_entry_fds[idx]) ||
+                (NULL == entry->notify_cb)) {
+            /* entry went away in a pipe command of this wakeup */
+            return;
+        }
+        entry->notify_cb(entry->user_data);
+
+        pfd.fd = entry->fd;
+        pfd.events = events;
+        pfd.revents = 0;
+        if ((poll(&pfd, 1, 0) <= 0) || ((pfd.revents & events) != events)) {
+            return;
+        }
+    }
+    /* still has data, picked up again after the other entries had a turn */
+    poll_cb->epoll_pending |= (1U << idx);
+}
+
 /*===========================================================================
  * FUNCTION   : mm_camera_poll_proc_pipe
  *
@@ -209,17 +333,27 @@ static void mm_camera_poll_set_state(mm_camera_poll_thread_t *poll_cb,
  *
  * RETURN     : none
  *==========================================================================*/
-static void mm_camera_poll_proc_pipe(mm_camera_poll_thread_t *poll_cb)
+static ssize_t mm_camera_poll_proc_pipe(mm_camera_poll_thread_t *poll_cb)
 {
     ssize_t read_len;
     int i;
     mm_camera_sig_evt_t cmd_evt;
     read_len = read(poll_cb->pfds[0], &cmd_evt, sizeof(cmd_evt));
+    if (read_len != (ssize_t)sizeof(cmd_evt)) {
+        /* nothing left to read on the non blocking epoll pipe */
+        return read_len;
+    }
     LOGD("read_fd = %d, read_len = %d, expect_len = %d cmd = %d",
           poll_cb->pfds[0], (int)read_len, (int)sizeof(cmd_evt), cmd_evt.cmd);
     switch (cmd_evt.cmd) {
     case MM_CAMERA_PIPE_CMD_POLL_ENTRIES_UPDATED:
     case MM_CAMERA_PIPE_CMD_POLL_ENTRIES_UPDATED_ASYNC:
+        if (MM_CAMERA_POLL_ENGINE_EPOLL == poll_cb->poll_engine) {
+            mm_camera_epoll_update_entries(poll_cb);
+            if (cmd_evt.cmd != MM_CAMERA_PIPE_CMD_POLL_ENTRIES_UPDATED_ASYNC)
+                mm_camera_poll_sig_done(poll_cb);
+            break;
+        }
         /* we always have index 0 for pipe read */
         poll_cb->num_fds = 0;
         poll_cb->poll_fds[poll_cb->num_fds].fd = poll_cb->pfds[0];
@@ -269,6 +403,7 @@ static void mm_camera_poll_proc_pipe(mm_camera_poll_thread_t *poll_cb)
         mm_camera_poll_sig_done(poll_cb);
         break;
     }
+    return read_len;
 }
 
 /*===========================================================================
@@ -292,12 +427,9 @@ static void *mm_camera_poll_fn(mm_camera_poll_thread_t *poll_cb)
     LOGD("poll type = %d, num_fd = %d poll_cb = %p\n",
           poll_cb->poll_type, poll_cb->num_fds,poll_cb);
     do {
-         for(i = 0; i < poll_cb->num_fds; i++) {
-            poll_cb->poll_fds[i].events = POLLIN|POLLRDNORM|POLLPRI;
-         }
-
          rc = poll(poll_cb->poll_fds, poll_cb->num_fds, poll_cb->timeoutms);
          if(rc > 0) {
+            poll_cb->backoff_us = 0;
             if ((poll_cb->poll_fds[0].revents & POLLIN) &&
                 (poll_cb->poll_fds[0].revents & POLLRDNORM)) {
                 /* if we have data on pipe, we only process pipe in this iteration */
@@ -324,15 +456,67 @@ static void *mm_camera_poll_fn(mm_camera_poll_thread_t *poll_cb)
                     }
                 }
             }
-        } else {
-            /* in error case sleep 10 us and then continue. hard coded here */
-            usleep(10);
+        } else if (rc < 0) {
+            mm_camera_poll_backoff(poll_cb, errno);
             continue;
         }
     } while ((poll_cb != NULL) && (poll_cb->state == MM_CAMERA_POLL_TASK_STATE_POLL));
     return NULL;
 }
 
+/*===========================================================================
+ * FUNCTION   : mm_camera_epoll_fn
+ *
+ * DESCRIPTION: polling thread routine of the epoll engine. Pipe commands are
+ *              handled first, then every ready entry is drained. Readiness
+ *              of entries the pipe commands registered again is dropped,
+ *              epoll reports those fds afresh if they have data.
+ *
+ * PARAMETERS :
+ *   @poll_cb : ptr to poll thread object
+ *
+ * RETURN     : none
+ *==========================================================================*/
+static void *mm_camera_epoll_fn(mm_camera_poll_thread_t *poll_cb)
+{
+    struct epoll_event events[MAX_STREAM_NUM_IN_BUNDLE + 1];
+    uint32_t ready;
+    uint32_t i;
+    int rc = 0;
+
+    LOGD("poll type = %d, poll_cb = %p\n", poll_cb->poll_type, poll_cb);
+    do {
+        rc = epoll_wait(poll_cb->epoll_fd, events, MAX_STREAM_NUM_IN_BUNDLE + 1,
+                (0 != poll_cb->epoll_pending) ? 0 : poll_cb->timeoutms);
+        if (rc < 0) {
+            mm_camera_poll_backoff(poll_cb, errno);
+            continue;
+        }
+        poll_cb->backoff_us = 0;
+
+        ready = poll_cb->epoll_pending;
+        poll_cb->epoll_changed = 0;
+        for (i = 0; i < (uint32_t)rc; i++) {
+            if (MM_CAMERA_EPOLL_PIPE_IDX == events[i].data.u32) {
+                LOGD("cmd received on pipe\n");
+                while ((mm_camera_poll_proc_pipe(poll_cb) > 0) &&
+                        (MM_CAMERA_POLL_TASK_STATE_POLL == poll_cb->state)) {
+                }
+            } else {
+                ready |= (1U << events[i].data.u32);
+            }
+        }
+        ready &= ~poll_cb->epoll_changed;
+        for (i = 0; (i < MAX_STREAM_NUM_IN_BUNDLE) &&
+                (MM_CAMERA_POLL_TASK_STATE_POLL == poll_cb->state); i++) {
+            if (ready & (1U << i)) {
+                mm_camera_epoll_dispatch(poll_cb, i);
+            }
+        }
+    } while (poll_cb->state == MM_CAMERA_POLL_TASK_STATE_POLL);
+    return NULL;
+}
+
 /*===========================================================================
  * FUNCTION   : mm_camera_poll_thread
  *
@@ -349,10 +533,15 @@ static void *mm_camera_poll_thread(void *data)
 
     mm_camera_cmd_thread_name(poll_cb->threadName);
     /* add pipe read fd into poll first */
-    poll_cb->poll_fds[poll_cb->num_fds++].fd = poll_cb->pfds[0];
+    poll_cb->poll_fds[poll_cb->num_fds].fd = poll_cb->pfds[0];
+    poll_cb->poll_fds[poll_cb->num_fds].events = POLLIN|POLLRDNORM|POLLPRI;
+    poll_cb->num_fds++;
 
-    mm_camera_poll_sig_done(poll_cb);
     mm_camera_poll_set_state(poll_cb, MM_CAMERA_POLL_TASK_STATE_POLL);
+    mm_camera_poll_sig_done(poll_cb);
+    if (MM_CAMERA_POLL_ENGINE_EPOLL == poll_cb->poll_engine) {
+        return mm_camera_epoll_fn(poll_cb);
+    }
     return mm_camera_poll_fn(poll_cb);
 }
 
@@ -507,8 +696,38 @@ int32_t mm_camera_poll_thread_launch(mm_camera_poll_thread_t * poll_cb,
 
     poll_cb->timeoutms = -1;  /* Infinite seconds */
 
-    LOGD("poll_type = %d, read fd = %d, write fd = %d timeout = %d",
-         poll_cb->poll_type,
+    poll_cb->epoll_fd = -1;
+    for (i = 0; i < MAX_STREAM_NUM_IN_BUNDLE; i++) {
+        poll_cb->epoll_entry_fds[i] = -1;
+    }
+    poll_cb->epoll_pending = 0;
+    poll_cb->epoll_changed = 0;
+    poll_cb->backoff_us = 0;
+    if (MM_CAMERA_POLL_ENGINE_EPOLL == poll_cb->poll_engine) {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.u32 = MM_CAMERA_EPOLL_PIPE_IDX;
+        poll_cb->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        /* the pipe is read until empty on each edge */
+        if ((poll_cb->epoll_fd < 0) ||
+                (fcntl(poll_cb->pfds[0], F_SETFL,
+                        fcntl(poll_cb->pfds[0], F_GETFL) | O_NONBLOCK) < 0) ||
+                (epoll_ctl(poll_cb->epoll_fd, EPOLL_CTL_ADD, poll_cb->pfds[0], &ev) < 0)) {
+            LOGW("epoll setup failed (%s), using poll", strerror(errno));
+            if (poll_cb->epoll_fd >= 0) {
+                close(poll_cb->epoll_fd);
+                poll_cb->epoll_fd = -1;
+            }
+            fcntl(poll_cb->pfds[0], F_SETFL, fcntl(poll_cb->pfds[0], F_GETFL) & ~O_NONBLOCK);
+            poll_cb->poll_engine = MM_CAMERA_POLL_ENGINE_POLL;
+        }
+    } else {
+        poll_cb->poll_engine = MM_CAMERA_POLL_ENGINE_POLL;
+    }
+
+    LOGD("poll_type = %d, engine = %d, read fd = %d, write fd = %d timeout = %d",
+         poll_cb->poll_type, poll_cb->poll_engine,
         poll_cb->pfds[0], poll_cb->pfds[1],poll_cb->timeoutms);
 
     pthread_condattr_init(&cond_attr);
@@ -553,12 +772,16 @@ int32_t mm_camera_poll_thread_release(mm_camera_poll_thread_t *poll_cb)
     if(poll_cb->pfds[1] >= 0) {
         close(poll_cb->pfds[1]);
     }
+    if(poll_cb->epoll_fd >= 0) {
+        close(poll_cb->epoll_fd);
+    }
 
     pthread_mutex_destroy(&poll_cb->mutex);
     pthread_cond_destroy(&poll_cb->cond_v);
     memset(poll_cb, 0, sizeof(mm_camera_poll_thread_t));
     poll_cb->pfds[0] = -1;
     poll_cb->pfds[1] = -1;
+    poll_cb->epoll_fd = -1;
     return rc;
 }
 
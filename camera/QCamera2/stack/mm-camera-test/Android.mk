@@ -237,4 +237,136 @@ include $(SDCLANG_COMMON_DEFS)
 
 include $(BUILD_SHARED_LIBRARY)
 
+# Build poll thread load test: mm-qcamera-poll-test
+include $(CLEAR_VARS)
+
+LOCAL_HEADER_LIBRARIES := libutils_headers
+LOCAL_HEADER_LIBRARIES += media_plugin_headers
+
+LOCAL_CFLAGS:= \
+        $(mmcamera_debug_defines) \
+        $(mmcamera_debug_cflags)
+LOCAL_CFLAGS += -Wall -Wextra -Werror
+
+LOCAL_SRC_FILES:= \
+        src/mm_qcamera_poll_test.c
+
+LOCAL_C_INCLUDES:= \
+        $(LOCAL_PATH)/../common \
+        $(LOCAL_PATH)/../mm-camera-interface/inc
+
+LOCAL_C_INCLUDES+= $(kernel_includes)
+LOCAL_ADDITIONAL_DEPENDENCIES := $(common_deps)
+
+LOCAL_SHARED_LIBRARIES:= \
+         libcutils liblog libmmcamera_interface
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_32_BIT_ONLY := $(BOARD_QTI_CAMERA_32BIT_ONLY)
+
+LOCAL_MODULE:= mm-qcamera-poll-test
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+
+include $(BUILD_EXECUTABLE)
+
+# Build superbuf matching test: mm-qcamera-superbuf-test
+include $(CLEAR_VARS)
+
+LOCAL_HEADER_LIBRARIES := libutils_headers
+LOCAL_HEADER_LIBRARIES += media_plugin_headers
+
+LOCAL_CFLAGS:= \
+        $(mmcamera_debug_defines) \
+        $(mmcamera_debug_cflags)
+LOCAL_CFLAGS += -Wall -Wextra -Werror
+
+LOCAL_SRC_FILES:= \
+        src/mm_qcamera_superbuf_test.c
+
+LOCAL_C_INCLUDES:= \
+        $(LOCAL_PATH)/../common \
+        $(LOCAL_PATH)/../mm-camera-interface/inc
+
+LOCAL_C_INCLUDES+= $(kernel_includes)
+LOCAL_ADDITIONAL_DEPENDENCIES := $(common_deps)
+
+LOCAL_SHARED_LIBRARIES:= \
+         libcutils liblog libmmcamera_interface
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_32_BIT_ONLY := $(BOARD_QTI_CAMERA_32BIT_ONLY)
+
+LOCAL_MODULE:= mm-qcamera-superbuf-test
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+
+include $(BUILD_EXECUTABLE)
+
+# Build frame sync stress test: mm-qcamera-frame-sync-test
+include $(CLEAR_VARS)
+
+LOCAL_HEADER_LIBRARIES := libutils_headers
+LOCAL_HEADER_LIBRARIES += media_plugin_headers
+
+LOCAL_CFLAGS:= \
+        $(mmcamera_debug_defines) \
+        $(mmcamera_debug_cflags)
+LOCAL_CFLAGS += -Wall -Wextra -Werror
+
+LOCAL_SRC_FILES:= \
+        src/mm_qcamera_frame_sync_test.c
+
+LOCAL_C_INCLUDES:= \
+        $(LOCAL_PATH)/../common \
+        $(LOCAL_PATH)/../mm-camera-interface/inc
+
+LOCAL_C_INCLUDES+= $(kernel_includes)
+LOCAL_ADDITIONAL_DEPENDENCIES := $(common_deps)
+
+LOCAL_SHARED_LIBRARIES:= \
+         libcutils liblog libmmcamera_interface
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_32_BIT_ONLY := $(BOARD_QTI_CAMERA_32BIT_ONLY)
+
+LOCAL_MODULE:= mm-qcamera-frame-sync-test
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+
+include $(BUILD_EXECUTABLE)
+
+# Build sparse metadata copy benchmark: mm-qcamera-meta-bench
+include $(CLEAR_VARS)
+
+LOCAL_HEADER_LIBRARIES := libutils_headers
+LOCAL_HEADER_LIBRARIES += media_plugin_headers
+
+LOCAL_CFLAGS:= \
+        $(mmcamera_debug_defines) \
+        $(mmcamera_debug_cflags)
+LOCAL_CFLAGS += -Wall -Wextra -Werror
+
+LOCAL_SRC_FILES:= \
+        src/mm_qcamera_meta_bench.c
+
+LOCAL_C_INCLUDES:= \
+        $(LOCAL_PATH)/../common \
+        $(LOCAL_PATH)/../mm-camera-interface/inc
+
+LOCAL_C_INCLUDES+= $(kernel_includes)
+LOCAL_ADDITIONAL_DEPENDENCIES := $(common_deps)
+
+LOCAL_SHARED_LIBRARIES:= \
+         libcutils liblog libmmcamera_interface
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_32_BIT_ONLY := $(BOARD_QTI_CAMERA_32BIT_ONLY)
+
+LOCAL_MODULE:= mm-qcamera-meta-bench
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+
+include $(BUILD_EXECUTABLE)
+
 LOCAL_PATH := $(OLD_LOCAL_PATH)
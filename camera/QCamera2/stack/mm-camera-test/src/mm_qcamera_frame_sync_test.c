@@ -0,0 +1,423 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/* Exercises the frame sync groups of mm_camera_channel.c.
+ * First a seeded sequence of adds and removes in one group is checked against
+ * a linear model of the sync nodes: same eviction, same frames present and
+ * the same oldest matched frame after every step. Then one or two linked pairs
+ * of simulated channels run on their own threads, each adding its frames under
+ * its superbuf queue lock like mm_channel_superbuf_comp_and_enqueue, while one
+ * consumer per group takes the oldest matched frame like the frame sync
+ * dispatch. Every frame has to come out once, in order, after all channels of
+ * its group added it. Channels are grouped by their links, and a channel
+ * linked to no other one is refused.
+ *
+ *     mm-qcamera-frame-sync-test [frames per channel]
+ */
+
+// System dependencies
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Camera dependencies
+#include "mm_camera.h"
+
+/* frame sync functions of mm_camera_channel.c */
+int32_t mm_channel_superbuf_queue_init(mm_channel_queue_t * queue);
+int32_t mm_channel_superbuf_queue_deinit(mm_channel_queue_t * queue);
+int32_t mm_frame_sync_register_channel(mm_channel_t *ch_obj);
+int32_t mm_frame_sync_unregister_channel(mm_channel_t *ch_obj);
+int32_t mm_frame_sync_add(uint32_t frame_id, mm_channel_t *ch_obj);
+int32_t mm_frame_sync_remove(uint32_t frame_id, mm_channel_t *ch_obj);
+uint32_t mm_frame_sync_find_matched(mm_channel_frame_sync_info_t *group);
+int8_t mm_frame_sync_find_frame_index(mm_channel_frame_sync_info_t *group,
+        uint32_t frame_id);
+mm_channel_frame_sync_info_t *mm_frame_sync_lock_queues(mm_channel_t *ch_obj);
+void mm_frame_sync_unlock_queues(mm_channel_frame_sync_info_t *group);
+
+#define FS_TEST_MAX_CH (MM_CAMERA_FRAME_SYNC_GROUPS * MAX_NUM_CAMERA_PER_BUNDLE)
+/* frames a producer may run ahead of its group's consumer, below the node count
+ * so that no unmatched frame is evicted */
+#define FS_TEST_WINDOW (MM_CAMERA_FRAME_SYNC_NODES - 1)
+
+typedef struct {
+    uint32_t frame_idx;
+    uint8_t valid[MAX_NUM_CAMERA_PER_BUNDLE];
+} fs_test_model_node_t;
+
+typedef struct {
+    fs_test_model_node_t node[MM_CAMERA_FRAME_SYNC_NODES];
+    uint8_t pos;
+    uint8_t num_cam;
+} fs_test_model_t;
+
+typedef struct fs_test_group {
+    mm_channel_t *ch[MAX_NUM_CAMERA_PER_BUNDLE];
+    uint8_t num_ch;
+    uint32_t first_frame;
+    uint32_t num_frames;
+    /* all frames before it came out of the group */
+    uint32_t next_out;
+    /* channels that added a frame, by frame idx */
+    uint32_t added[FS_TEST_WINDOW + 1];
+    uint32_t errors;
+    pthread_t consumer;
+} fs_test_group_t;
+
+typedef struct {
+    fs_test_group_t *group;
+    uint8_t ch_idx;
+    pthread_t producer;
+} fs_test_channel_t;
+
+static mm_channel_t fs_test_ch[FS_TEST_MAX_CH];
+
+static uint32_t fs_test_rand(uint32_t *seed)
+{
+    *seed = *seed * 1103515245U + 12345U;
+    return (*seed >> 8) & 0xFFFF;
+}
+
+static uint64_t fs_test_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* next frame idx, 0 is not a valid frame */
+static uint32_t fs_test_next(uint32_t frame_idx)
+{
+    return (0 == frame_idx + 1) ? 1 : frame_idx + 1;
+}
+
+/* Every MAX_NUM_CAMERA_PER_BUNDLE channels are linked to the first of them, like
+ * mm_channel_reg_frame_sync does. The masters register first so that groups have
+ * to follow the links rather than the registration order. */
+static int fs_test_init_channels(uint8_t num_ch)
+{
+    uint8_t i, pass;
+    for (i = 0; i < num_ch; i++) {
+        mm_channel_t *master = &fs_test_ch[i - i % MAX_NUM_CAMERA_PER_BUNDLE];
+        memset(&fs_test_ch[i], 0, sizeof(fs_test_ch[i]));
+        mm_channel_superbuf_queue_init(&fs_test_ch[i].bundle.superbuf_queue);
+        fs_test_ch[i].bundle.superbuf_queue.attr.enable_frame_sync = 1;
+        if (master != &fs_test_ch[i]) {
+            fs_test_ch[i].master_ch_obj = master;
+            master->aux_ch_obj[master->num_s_cnt++] = &fs_test_ch[i];
+        }
+    }
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < num_ch; i++) {
+            if ((0 == pass) != (NULL == fs_test_ch[i].master_ch_obj)) {
+                continue;
+            }
+            if (0 != mm_frame_sync_register_channel(&fs_test_ch[i])) {
+                printf("register of channel %u failed\n", i);
+                return -1;
+            }
+        }
+    }
+    for (i = 0; i < num_ch; i++) {
+        if ((NULL != fs_test_ch[i].master_ch_obj) &&
+                (fs_test_ch[i].fs_group != fs_test_ch[i].master_ch_obj->fs_group)) {
+            printf("channel %u is not in the group of its master\n", i);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* a channel linked to no other one has nothing to be synced with */
+static int fs_test_unlinked(void)
+{
+    mm_channel_t ch;
+    int rc;
+
+    memset(&ch, 0, sizeof(ch));
+    mm_channel_superbuf_queue_init(&ch.bundle.superbuf_queue);
+    ch.bundle.superbuf_queue.attr.enable_frame_sync = 1;
+    rc = (0 != mm_frame_sync_register_channel(&ch)) && (NULL == ch.fs_group) ? 0 : -1;
+    mm_frame_sync_unregister_channel(&ch);
+    mm_channel_superbuf_queue_deinit(&ch.bundle.superbuf_queue);
+    printf("unlinked channel: %s\n", rc ? "registered" : "rejected");
+    return rc;
+}
+
+static void fs_test_deinit_channels(uint8_t num_ch)
+{
+    uint8_t i;
+    for (i = 0; i < num_ch; i++) {
+        mm_frame_sync_unregister_channel(&fs_test_ch[i]);
+        mm_channel_superbuf_queue_deinit(&fs_test_ch[i].bundle.superbuf_queue);
+    }
+}
+
+/* the linear frame sync node array the group replaces */
+static void fs_test_model_add(fs_test_model_t *model, uint32_t frame_idx, uint8_t ch_idx)
+{
+    uint8_t i;
+    for (i = 0; i < MM_CAMERA_FRAME_SYNC_NODES; i++) {
+        if (model->node[i].frame_idx == frame_idx) {
+            model->node[i].valid[ch_idx] = 1;
+            return;
+        }
+    }
+    if (model->pos >= MM_CAMERA_FRAME_SYNC_NODES) {
+        model->pos = 0;
+    }
+    memset(&model->node[model->pos], 0, sizeof(model->node[0]));
+    model->node[model->pos].frame_idx = frame_idx;
+    model->node[model->pos].valid[ch_idx] = 1;
+    model->pos++;
+}
+
+static void fs_test_model_remove(fs_test_model_t *model, uint32_t frame_idx)
+{
+    uint8_t i;
+    for (i = 0; i < MM_CAMERA_FRAME_SYNC_NODES; i++) {
+        if (model->node[i].frame_idx == frame_idx) {
+            memset(&model->node[i], 0, sizeof(model->node[0]));
+        }
+    }
+}
+
+static uint32_t fs_test_model_oldest(const fs_test_model_t *model)
+{
+    uint32_t oldest = 0;
+    uint8_t i, j, valid;
+    for (i = 0; i < MM_CAMERA_FRAME_SYNC_NODES; i++) {
+        if (0 == model->node[i].frame_idx) {
+            continue;
+        }
+        for (j = 0, valid = 0; j < MAX_NUM_CAMERA_PER_BUNDLE; j++) {
+            valid += model->node[i].valid[j];
+        }
+        if ((valid == model->num_cam) && ((0 == oldest) ||
+                ((int32_t)(model->node[i].frame_idx - oldest) < 0))) {
+            oldest = model->node[i].frame_idx;
+        }
+    }
+    return oldest;
+}
+
+static int fs_test_model_check(uint8_t num_cam, uint32_t base, uint32_t steps, uint32_t seed)
+{
+    fs_test_model_t model;
+    mm_channel_frame_sync_info_t *group;
+    uint32_t first_frame = base;
+    uint32_t step, frame_idx, expected, found;
+    uint8_t i, present;
+    int rc = 0;
+
+    memset(&model, 0, sizeof(model));
+    model.num_cam = num_cam;
+    if (0 != fs_test_init_channels(num_cam)) {
+        return -1;
+    }
+    for (step = 0; (step < steps) && (0 == rc); step++) {
+        uint32_t op = fs_test_rand(&seed);
+        frame_idx = base + fs_test_rand(&seed) % (2 * MM_CAMERA_FRAME_SYNC_NODES);
+        if (0 == frame_idx) {
+            continue;
+        }
+        if (op % 8 == 0) {
+            mm_frame_sync_remove(frame_idx, &fs_test_ch[0]);
+            fs_test_model_remove(&model, frame_idx);
+        } else {
+            uint8_t ch_idx = (uint8_t)(op % num_cam);
+            mm_frame_sync_add(frame_idx, &fs_test_ch[ch_idx]);
+            fs_test_model_add(&model, frame_idx, ch_idx);
+        }
+        if (op % 16 == 1) {
+            base++;
+        }
+
+        group = mm_frame_sync_lock_queues(&fs_test_ch[0]);
+        found = mm_frame_sync_find_matched(group);
+        expected = fs_test_model_oldest(&model);
+        if (found != expected) {
+            printf("step %u: oldest matched %u, expected %u\n", step, found, expected);
+            rc = -1;
+        }
+        for (i = 0; i < MM_CAMERA_FRAME_SYNC_NODES; i++) {
+            if (0 == model.node[i].frame_idx) {
+                continue;
+            }
+            present = mm_frame_sync_find_frame_index(group, model.node[i].frame_idx) >= 0;
+            if (!present) {
+                printf("step %u: frame %u missing\n", step, model.node[i].frame_idx);
+                rc = -1;
+            }
+        }
+        mm_frame_sync_unlock_queues(group);
+    }
+    fs_test_deinit_channels(num_cam);
+    printf("model check, %u channel(s), first frame %10u: %s\n", num_cam, first_frame,
+            rc ? "MISMATCH" : "ok");
+    return rc;
+}
+
+static void *fs_test_producer(void *data)
+{
+    fs_test_channel_t *ctx = (fs_test_channel_t *)data;
+    fs_test_group_t *group = ctx->group;
+    mm_channel_t *ch = group->ch[ctx->ch_idx];
+    mm_channel_queue_t *queue = &ch->bundle.superbuf_queue;
+    uint32_t frame_idx = group->first_frame;
+    uint32_t n;
+
+    for (n = 0; n < group->num_frames; n++, frame_idx = fs_test_next(frame_idx)) {
+        while ((uint32_t)(frame_idx - __atomic_load_n(&group->next_out, __ATOMIC_ACQUIRE))
+                >= FS_TEST_WINDOW) {
+            sched_yield();
+        }
+        __sync_fetch_and_or(&group->added[frame_idx % (FS_TEST_WINDOW + 1)],
+                1U << ctx->ch_idx);
+        pthread_mutex_lock(&queue->que.lock);
+        mm_frame_sync_add(frame_idx, ch);
+        pthread_mutex_unlock(&queue->que.lock);
+    }
+    return NULL;
+}
+
+static void *fs_test_consumer(void *data)
+{
+    fs_test_group_t *group = (fs_test_group_t *)data;
+    mm_channel_frame_sync_info_t *fs_group;
+    uint32_t all = (1U << group->num_ch) - 1;
+    uint32_t n = 0, matched, added;
+
+    while (n < group->num_frames) {
+        fs_group = mm_frame_sync_lock_queues(group->ch[0]);
+        matched = mm_frame_sync_find_matched(fs_group);
+        mm_frame_sync_unlock_queues(fs_group);
+        if (0 == matched) {
+            sched_yield();
+            continue;
+        }
+        added = __atomic_load_n(&group->added[matched % (FS_TEST_WINDOW + 1)],
+                __ATOMIC_ACQUIRE);
+        if ((matched != group->next_out) || (added != all)) {
+            if (group->errors++ < 10) {
+                printf("group of %u: frame %u out, expected %u, added by 0x%x\n",
+                        group->num_ch, matched, group->next_out, added);
+            }
+        }
+        mm_frame_sync_remove(matched, group->ch[0]);
+        __atomic_store_n(&group->added[matched % (FS_TEST_WINDOW + 1)], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&group->next_out, fs_test_next(matched), __ATOMIC_RELEASE);
+        n++;
+    }
+    return NULL;
+}
+
+static int fs_test_stress(uint8_t num_ch, uint32_t first_frame, uint32_t num_frames)
+{
+    fs_test_group_t groups[MM_CAMERA_FRAME_SYNC_GROUPS];
+    fs_test_channel_t channels[FS_TEST_MAX_CH];
+    uint8_t num_groups = 0, i, g;
+    uint64_t start_ns, ns;
+    uint32_t errors = 0;
+
+    if (0 != fs_test_init_channels(num_ch)) {
+        return -1;
+    }
+    memset(groups, 0, sizeof(groups));
+    for (i = 0; i < num_ch; i++) {
+        for (g = 0; g < num_groups; g++) {
+            if (groups[g].ch[0]->fs_group == fs_test_ch[i].fs_group) {
+                break;
+            }
+        }
+        if (g == num_groups) {
+            num_groups++;
+        }
+        channels[i].group = &groups[g];
+        channels[i].ch_idx = groups[g].num_ch;
+        groups[g].ch[groups[g].num_ch++] = &fs_test_ch[i];
+    }
+
+    start_ns = fs_test_now_ns();
+    for (g = 0; g < num_groups; g++) {
+        groups[g].first_frame = first_frame;
+        groups[g].num_frames = num_frames;
+        groups[g].next_out = first_frame;
+        pthread_create(&groups[g].consumer, NULL, fs_test_consumer, &groups[g]);
+    }
+    for (i = 0; i < num_ch; i++) {
+        pthread_create(&channels[i].producer, NULL, fs_test_producer, &channels[i]);
+    }
+    for (i = 0; i < num_ch; i++) {
+        pthread_join(channels[i].producer, NULL);
+    }
+    for (g = 0; g < num_groups; g++) {
+        pthread_join(groups[g].consumer, NULL);
+        errors += groups[g].errors;
+    }
+    ns = fs_test_now_ns() - start_ns;
+    fs_test_deinit_channels(num_ch);
+
+    printf("stress, %u channels in %u group(s), first frame %10u: %u frames per group "
+            "in %.1f ms, %.0f ns per frame %s\n", num_ch, num_groups, first_frame,
+            num_frames, ns / 1e6, (double)ns / num_frames, errors ? "FAILED" : "ok");
+    return errors ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t num_frames = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200000;
+    const uint32_t first[] = { 1, 0xFFFFFFFFU - 1000 };
+    uint8_t num_ch;
+    uint32_t f;
+    int rc = 0;
+
+    if (0 == num_frames) {
+        printf("usage: %s [frames per channel]\n", argv[0]);
+        return -1;
+    }
+    rc |= fs_test_unlinked();
+    for (f = 0; f < sizeof(first) / sizeof(first[0]); f++) {
+        for (num_ch = 2; num_ch <= MAX_NUM_CAMERA_PER_BUNDLE; num_ch++) {
+            rc |= fs_test_model_check(num_ch, first[f], 100000, 17 * num_ch + f);
+        }
+    }
+    for (f = 0; f < sizeof(first) / sizeof(first[0]); f++) {
+        for (num_ch = MAX_NUM_CAMERA_PER_BUNDLE; num_ch <= FS_TEST_MAX_CH;
+                num_ch += MAX_NUM_CAMERA_PER_BUNDLE) {
+            rc |= fs_test_stress(num_ch, first[f], num_frames);
+        }
+    }
+    printf("%s\n", rc ? "FAILED" : "PASSED");
+    return rc;
+}
@@ -0,0 +1,351 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/* Checks and times the sparse metadata helpers of mm_camera_meta.c against
+ * the whole buffer memcpy they replace. A result buffer with a typical set of
+ * valid entries is copied, diffed against the previous frame and merged back,
+ * and every valid entry has to come out byte for byte. Then the same per
+ * frame update is timed with memcpy of metadata_buffer_t, mm_camera_meta_copy
+ * and mm_camera_meta_delta, and the bytes touched per frame are printed.
+ *
+ *     mm-qcamera-meta-bench [frames]
+ */
+
+// System dependencies
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Camera dependencies
+#include "mm_camera_interface.h"
+
+typedef struct {
+    uint32_t offset;
+    uint32_t size;
+} meta_bench_entry_t;
+
+#define META_BENCH_ENTRY(PARAM_ID, DATATYPE, COUNT) \
+    [PARAM_ID] = { \
+        (uint32_t)offsetof(metadata_data_t, member_variable_##PARAM_ID), \
+        (uint32_t)sizeof(((metadata_data_t *)0)->member_variable_##PARAM_ID) },
+#define META_BENCH_NO_ID(PARAM_ID, DATATYPE, COUNT)
+
+static const meta_bench_entry_t meta_bench_table[CAM_INTF_PARM_MAX] = {
+    CAM_INTF_METADATA_ENTRIES(META_BENCH_ENTRY, META_BENCH_NO_ID)
+};
+
+/* entries the backend reports with every result */
+static const uint32_t meta_bench_result_ids[] = {
+    CAM_INTF_META_FRAME_NUMBER_VALID,
+    CAM_INTF_META_FRAME_NUMBER,
+    CAM_INTF_META_URGENT_FRAME_NUMBER_VALID,
+    CAM_INTF_META_URGENT_FRAME_NUMBER,
+    CAM_INTF_META_FRAME_DROPPED,
+    CAM_INTF_META_SENSOR_TIMESTAMP,
+    CAM_INTF_META_SENSOR_EXPOSURE_TIME,
+    CAM_INTF_META_SENSOR_FRAME_DURATION,
+    CAM_INTF_META_SENSOR_SENSITIVITY,
+    CAM_INTF_META_ISP_SENSITIVITY,
+    CAM_INTF_META_SENSOR_ROLLING_SHUTTER_SKEW,
+    CAM_INTF_META_AEC_INFO,
+    CAM_INTF_META_AEC_STATE,
+    CAM_INTF_META_AEC_ROI,
+    CAM_INTF_META_AWB_INFO,
+    CAM_INTF_META_AWB_STATE,
+    CAM_INTF_META_AWB_REGIONS,
+    CAM_INTF_META_AF_STATE,
+    CAM_INTF_META_AF_ROI,
+    CAM_INTF_META_FOCUS_POSITION,
+    CAM_INTF_META_LENS_APERTURE,
+    CAM_INTF_META_LENS_FOCAL_LENGTH,
+    CAM_INTF_META_LENS_FOCUS_DISTANCE,
+    CAM_INTF_META_LENS_FOCUS_RANGE,
+    CAM_INTF_META_LENS_STATE,
+    CAM_INTF_META_LENS_OPT_STAB_MODE,
+    CAM_INTF_META_VIDEO_STAB_MODE,
+    CAM_INTF_META_COLOR_CORRECT_MODE,
+    CAM_INTF_META_COLOR_CORRECT_TRANSFORM,
+    CAM_INTF_META_COLOR_CORRECT_GAINS,
+    CAM_INTF_META_PRED_COLOR_CORRECT_TRANSFORM,
+    CAM_INTF_META_PRED_COLOR_CORRECT_GAINS,
+    CAM_INTF_META_BLACK_LEVEL_LOCK,
+    CAM_INTF_META_MODE,
+    CAM_INTF_META_EDGE_MODE,
+    CAM_INTF_META_NOISE_REDUCTION_MODE,
+    CAM_INTF_META_HOTPIXEL_MODE,
+    CAM_INTF_META_SHADING_MODE,
+    CAM_INTF_META_FLASH_MODE,
+    CAM_INTF_META_FLASH_STATE,
+    CAM_INTF_META_SCALER_CROP_REGION,
+    CAM_INTF_META_SCENE_FLICKER,
+    CAM_INTF_META_STATS_FACEDETECT_MODE,
+    CAM_INTF_META_STATS_HISTOGRAM_MODE,
+    CAM_INTF_META_STATS_SHARPNESS_MAP_MODE,
+    CAM_INTF_META_FACE_DETECTION,
+    CAM_INTF_META_CROP_DATA,
+    CAM_INTF_META_SENSOR_INFO,
+};
+
+/* entries that change from one frame to the next */
+static const uint32_t meta_bench_changing_ids[] = {
+    CAM_INTF_META_FRAME_NUMBER,
+    CAM_INTF_META_URGENT_FRAME_NUMBER,
+    CAM_INTF_META_SENSOR_TIMESTAMP,
+    CAM_INTF_META_SENSOR_EXPOSURE_TIME,
+    CAM_INTF_META_SENSOR_SENSITIVITY,
+    CAM_INTF_META_AEC_INFO,
+    CAM_INTF_META_AWB_INFO,
+    CAM_INTF_META_FOCUS_POSITION,
+    CAM_INTF_META_FACE_DETECTION,
+};
+
+#define META_BENCH_NUM(ARRAY) (sizeof(ARRAY) / sizeof((ARRAY)[0]))
+
+static uint32_t meta_bench_rand(uint32_t *seed)
+{
+    *seed = *seed * 1103515245U + 12345U;
+    return (*seed >> 8) & 0xFFFF;
+}
+
+static uint64_t meta_bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint8_t *meta_bench_data(metadata_buffer_t *meta, uint32_t id)
+{
+    return (uint8_t *)&meta->data + meta_bench_table[id].offset;
+}
+
+/* rewrite a few bytes of an entry so that it differs from the last frame */
+static void meta_bench_touch(metadata_buffer_t *meta, uint32_t id,
+        uint32_t *seed)
+{
+    uint8_t *data = meta_bench_data(meta, id);
+    uint32_t size = meta_bench_table[id].size;
+    uint32_t i;
+
+    for (i = 0; i < 4; i++) {
+        data[meta_bench_rand(seed) % size]++;
+    }
+    data[0]++;
+}
+
+static void meta_bench_fill(metadata_buffer_t *meta, uint32_t *seed)
+{
+    uint32_t i;
+
+    memset(meta, 0, sizeof(*meta));
+    for (i = 0; i < META_BENCH_NUM(meta_bench_result_ids); i++) {
+        uint32_t id = meta_bench_result_ids[i];
+        uint8_t *data = meta_bench_data(meta, id);
+        uint32_t j;
+
+        for (j = 0; j < meta_bench_table[id].size; j++) {
+            data[j] = (uint8_t)meta_bench_rand(seed);
+        }
+        meta->is_valid[id] = 1;
+    }
+}
+
+/* every id valid in expected is valid in actual with the same bytes */
+static int meta_bench_same_valid(metadata_buffer_t *actual,
+        metadata_buffer_t *expected, const char *what)
+{
+    uint32_t id;
+
+    for (id = 0; id < CAM_INTF_PARM_MAX; id++) {
+        if (!expected->is_valid[id]) {
+            continue;
+        }
+        if (!actual->is_valid[id] || memcmp(meta_bench_data(actual, id),
+                meta_bench_data(expected, id), meta_bench_table[id].size)) {
+            printf("%s: entry %u differs\n", what, id);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int meta_bench_check(metadata_buffer_t *cur, metadata_buffer_t *prev,
+        metadata_buffer_t *tmp, metadata_buffer_t *delta)
+{
+    uint32_t ids[CAM_INTF_PARM_MAX];
+    uint32_t seed = 7;
+    uint32_t count;
+    uint32_t i;
+    size_t expected = CAM_INTF_PARM_MAX;
+    int rc = 0;
+
+    meta_bench_fill(cur, &seed);
+    for (i = 0; i < META_BENCH_NUM(meta_bench_result_ids); i++) {
+        expected += meta_bench_table[meta_bench_result_ids[i]].size;
+    }
+    /* the last id and one right after a word boundary exercise the scan */
+    cur->is_valid[CAM_INTF_PARM_MAX - 1] = 1;
+    cur->is_valid[8] = 1;
+    expected += meta_bench_table[CAM_INTF_PARM_MAX - 1].size +
+            meta_bench_table[8].size;
+
+    count = mm_camera_meta_get_valid_ids(cur, ids, CAM_INTF_PARM_MAX);
+    if (count != META_BENCH_NUM(meta_bench_result_ids) + 2) {
+        printf("valid ids: %u\n", count);
+        rc = -1;
+    }
+    for (i = 1; i < count; i++) {
+        if (ids[i] <= ids[i - 1] || !cur->is_valid[ids[i]]) {
+            printf("valid ids: bad id %u\n", ids[i]);
+            rc = -1;
+        }
+    }
+    if (mm_camera_meta_get_valid_ids(cur, ids, 1) != count) {
+        printf("valid ids: short list miscounted\n");
+        rc = -1;
+    }
+
+    memset(tmp, 0xA5, sizeof(*tmp));
+    if (mm_camera_meta_copy(tmp, cur) != expected) {
+        printf("copy: byte count\n");
+        rc = -1;
+    }
+    if (memcmp(tmp->is_valid, cur->is_valid, CAM_INTF_PARM_MAX)) {
+        printf("copy: valid table differs\n");
+        rc = -1;
+    }
+    rc |= meta_bench_same_valid(tmp, cur, "copy");
+
+    /* identical buffers have no delta, no previous buffer takes everything */
+    if (0 != mm_camera_meta_delta(delta, cur, tmp) ||
+            0 != mm_camera_meta_get_valid_ids(delta, NULL, 0)) {
+        printf("delta: identical buffers\n");
+        rc = -1;
+    }
+    if (mm_camera_meta_delta(delta, cur, NULL) + CAM_INTF_PARM_MAX != expected) {
+        printf("delta: no previous buffer\n");
+        rc = -1;
+    }
+    rc |= meta_bench_same_valid(delta, cur, "delta all");
+
+    /* next frame: some entries change, one goes away, one is new */
+    mm_camera_meta_copy(prev, cur);
+    for (i = 0; i < META_BENCH_NUM(meta_bench_changing_ids); i++) {
+        meta_bench_touch(cur, meta_bench_changing_ids[i], &seed);
+    }
+    cur->is_valid[CAM_INTF_META_SENSOR_INFO] = 0;
+    cur->is_valid[CAM_INTF_META_FLASH_POWER] = 1;
+    mm_camera_meta_delta(delta, cur, prev);
+    count = mm_camera_meta_get_valid_ids(delta, NULL, 0);
+    if (count != META_BENCH_NUM(meta_bench_changing_ids) + 1) {
+        printf("delta: %u entries changed\n", count);
+        rc = -1;
+    }
+    mm_camera_meta_copy(tmp, prev);
+    mm_camera_meta_merge(tmp, delta);
+    rc |= meta_bench_same_valid(tmp, cur, "merge");
+    if (!tmp->is_valid[CAM_INTF_META_SENSOR_INFO]) {
+        printf("merge: dropped an entry only valid in dst\n");
+        rc = -1;
+    }
+    return rc;
+}
+
+static void meta_bench_run(metadata_buffer_t *cur, metadata_buffer_t *prev,
+        metadata_buffer_t *dst, uint32_t num_frames)
+{
+    uint32_t seed = 11;
+    uint64_t copy_bytes = 0;
+    uint64_t delta_bytes = 0;
+    uint64_t full_ns = 0;
+    uint64_t copy_ns = 0;
+    uint64_t delta_ns = 0;
+    uint64_t start;
+    uint32_t f;
+    uint32_t i;
+
+    meta_bench_fill(cur, &seed);
+    mm_camera_meta_copy(prev, cur);
+    for (f = 0; f < num_frames; f++) {
+        for (i = 0; i < META_BENCH_NUM(meta_bench_changing_ids); i++) {
+            meta_bench_touch(cur, meta_bench_changing_ids[i], &seed);
+        }
+
+        start = meta_bench_now_ns();
+        memcpy(dst, cur, sizeof(*dst));
+        full_ns += meta_bench_now_ns() - start;
+
+        start = meta_bench_now_ns();
+        copy_bytes += mm_camera_meta_copy(dst, cur);
+        copy_ns += meta_bench_now_ns() - start;
+
+        start = meta_bench_now_ns();
+        delta_bytes += mm_camera_meta_delta(dst, cur, prev);
+        delta_ns += meta_bench_now_ns() - start;
+
+        mm_camera_meta_copy(prev, cur);
+    }
+
+    printf("%u frames, %zu valid entries, %zu changing per frame\n",
+            num_frames, META_BENCH_NUM(meta_bench_result_ids),
+            META_BENCH_NUM(meta_bench_changing_ids));
+    printf("  memcpy  %8zu bytes/frame %8llu ns/frame\n", sizeof(*dst),
+            (unsigned long long)(full_ns / num_frames));
+    printf("  copy    %8llu bytes/frame %8llu ns/frame\n",
+            (unsigned long long)(copy_bytes / num_frames),
+            (unsigned long long)(copy_ns / num_frames));
+    printf("  delta   %8llu bytes/frame %8llu ns/frame\n",
+            (unsigned long long)(delta_bytes / num_frames),
+            (unsigned long long)(delta_ns / num_frames));
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t num_frames = (argc > 1) ? (uint32_t)atoi(argv[1]) : 2000;
+    metadata_buffer_t *buf;
+    int rc;
+
+    if (0 == num_frames) {
+        printf("usage: %s [frames]\n", argv[0]);
+        return -1;
+    }
+    buf = (metadata_buffer_t *)malloc(4 * sizeof(metadata_buffer_t));
+    if (NULL == buf) {
+        printf("no memory for metadata buffers\n");
+        return -1;
+    }
+    rc = meta_bench_check(&buf[0], &buf[1], &buf[2], &buf[3]);
+    if (0 == rc) {
+        meta_bench_run(&buf[0], &buf[1], &buf[2], num_frames);
+    }
+    free(buf);
+    printf("%s\n", rc ? "FAILED" : "PASSED");
+    return rc;
+}
@@ -0,0 +1,227 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/* Synthetic load for the mm-camera-interface data poll thread.
+ * Every stream is a pipe standing in for a video node, it is readable with
+ * POLLIN | POLLRDNORM as long as frames are queued: a producer thread writes
+ * one byte per frame at the stream rate, and the poll notify reads one byte,
+ * the way a DQBUF takes one buffer. All streams post at the same instants,
+ * so wakeups find several fds ready. For each poll engine and frame rate it
+ * reports the notify latency after the frame was posted and the CPU time of
+ * the poll thread.
+ *
+ *     mm-qcamera-poll-test [streams] [seconds per rate]
+ */
+
+// System dependencies
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+// Camera dependencies
+#include "mm_camera.h"
+
+#define POLL_TEST_MAX_STREAMS MAX_STREAM_NUM_IN_BUNDLE
+/* frames in flight per stream, the producer never gets that far ahead */
+#define POLL_TEST_RING 64
+#define POLL_TEST_MAX_SAMPLES (240 * 60)
+
+typedef struct {
+    int fd;
+    int write_fd;
+    uint32_t fps;
+    volatile int running;
+    pthread_t producer;
+    uint64_t posted_ns[POLL_TEST_RING];
+    volatile uint32_t posted;
+    uint32_t consumed;
+    uint32_t num_samples;
+    uint32_t samples_us[POLL_TEST_MAX_SAMPLES];
+} poll_test_stream_t;
+
+static uint64_t poll_test_now_ns(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void poll_test_notify(void *user_data)
+{
+    poll_test_stream_t *stream = (poll_test_stream_t *)user_data;
+    uint8_t frame;
+
+    if (read(stream->fd, &frame, sizeof(frame)) != (ssize_t)sizeof(frame)) {
+        return;
+    }
+    uint64_t latency_ns = poll_test_now_ns(CLOCK_MONOTONIC) -
+            stream->posted_ns[stream->consumed % POLL_TEST_RING];
+    stream->consumed++;
+    if (stream->num_samples < POLL_TEST_MAX_SAMPLES) {
+        stream->samples_us[stream->num_samples++] = (uint32_t)(latency_ns / 1000);
+    }
+}
+
+static void *poll_test_producer(void *data)
+{
+    poll_test_stream_t *stream = (poll_test_stream_t *)data;
+    uint64_t period_ns = 1000000000ULL / stream->fps;
+    uint64_t next_ns = poll_test_now_ns(CLOCK_MONOTONIC);
+    uint8_t frame = 0;
+    struct timespec ts;
+
+    while (stream->running) {
+        next_ns += period_ns;
+        ts.tv_sec = (time_t)(next_ns / 1000000000ULL);
+        ts.tv_nsec = (long)(next_ns % 1000000000ULL);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+        if (stream->posted - stream->consumed >= POLL_TEST_RING) {
+            /* consumer is stalled, drop the frame like a starved stream */
+            continue;
+        }
+        stream->posted_ns[stream->posted % POLL_TEST_RING] =
+                poll_test_now_ns(CLOCK_MONOTONIC);
+        __sync_synchronize();
+        stream->posted++;
+        if (write(stream->write_fd, &frame, sizeof(frame)) != (ssize_t)sizeof(frame)) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static int poll_test_cmp(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int poll_test_run(mm_camera_poll_engine_type_t engine, uint32_t fps,
+        uint32_t num_streams, uint32_t seconds)
+{
+    static poll_test_stream_t streams[POLL_TEST_MAX_STREAMS];
+    static uint32_t all_us[POLL_TEST_MAX_STREAMS * POLL_TEST_MAX_SAMPLES];
+    mm_camera_poll_thread_t poll_cb;
+    clockid_t cpu_clock;
+    uint64_t cpu_start_ns, cpu_end_ns, frames = 0;
+    uint32_t i, num_all = 0;
+    int fds[2];
+    int rc = 0;
+
+    memset(&poll_cb, 0, sizeof(poll_cb));
+    poll_cb.poll_engine = engine;
+    snprintf(poll_cb.threadName, THREAD_NAME_SIZE, "CAM_pollTest");
+    if (0 != mm_camera_poll_thread_launch(&poll_cb, MM_CAMERA_POLL_TYPE_DATA)) {
+        printf("poll thread launch failed\n");
+        return -1;
+    }
+    for (i = 0; i < num_streams; i++) {
+        memset(&streams[i], 0, sizeof(streams[i]));
+        if ((pipe(fds) < 0) || (fcntl(fds[0], F_SETFL, O_NONBLOCK) < 0)) {
+            printf("pipe failed\n");
+            return -1;
+        }
+        streams[i].fd = fds[0];
+        streams[i].write_fd = fds[1];
+        streams[i].fps = fps;
+        mm_camera_poll_thread_add_poll_fd(&poll_cb, (uint8_t)i, i + 1, streams[i].fd,
+                poll_test_notify, &streams[i], mm_camera_sync_call);
+    }
+
+    pthread_getcpuclockid(poll_cb.pid, &cpu_clock);
+    cpu_start_ns = poll_test_now_ns(cpu_clock);
+    for (i = 0; i < num_streams; i++) {
+        streams[i].running = 1;
+        pthread_create(&streams[i].producer, NULL, poll_test_producer, &streams[i]);
+    }
+    sleep(seconds);
+    for (i = 0; i < num_streams; i++) {
+        streams[i].running = 0;
+        pthread_join(streams[i].producer, NULL);
+    }
+    /* let the poll thread take the last frames */
+    usleep(100000);
+    cpu_end_ns = poll_test_now_ns(cpu_clock);
+
+    for (i = 0; i < num_streams; i++) {
+        mm_camera_poll_thread_del_poll_fd(&poll_cb, (uint8_t)i, i + 1, mm_camera_sync_call);
+        if (streams[i].consumed != streams[i].posted) {
+            printf("stream %u: %u frames posted, %u notified\n", i,
+                    streams[i].posted, streams[i].consumed);
+            rc = -1;
+        }
+        frames += streams[i].consumed;
+        memcpy(&all_us[num_all], streams[i].samples_us,
+                streams[i].num_samples * sizeof(uint32_t));
+        num_all += streams[i].num_samples;
+        close(streams[i].fd);
+        close(streams[i].write_fd);
+    }
+    engine = poll_cb.poll_engine;
+    mm_camera_poll_thread_release(&poll_cb);
+
+    qsort(all_us, num_all, sizeof(uint32_t), poll_test_cmp);
+    printf("%-5s %3u fps x %u: %7llu frames, latency us p50 %5u p99 %5u max %6u, "
+            "poll thread CPU %5.2f%%\n",
+            (MM_CAMERA_POLL_ENGINE_EPOLL == engine) ? "epoll" : "poll", fps, num_streams,
+            (unsigned long long)frames,
+            num_all ? all_us[num_all / 2] : 0, num_all ? all_us[num_all * 99 / 100] : 0,
+            num_all ? all_us[num_all - 1] : 0,
+            100.0 * (double)(cpu_end_ns - cpu_start_ns) / (seconds * 1e9 + 1e8));
+    return rc;
+}
+
+int main(int argc, char **argv)
+{
+    const uint32_t rates[] = { 30, 60, 120, 240 };
+    uint32_t num_streams = (argc > 1) ? (uint32_t)atoi(argv[1]) : 4;
+    uint32_t seconds = (argc > 2) ? (uint32_t)atoi(argv[2]) : 3;
+    uint32_t r;
+    int engine, rc = 0;
+
+    if (num_streams < 1 || num_streams > POLL_TEST_MAX_STREAMS || seconds < 1 ||
+            seconds > POLL_TEST_MAX_SAMPLES / 240) {
+        printf("usage: %s [streams 1..%d] [seconds 1..%d]\n", argv[0],
+                POLL_TEST_MAX_STREAMS, POLL_TEST_MAX_SAMPLES / 240);
+        return -1;
+    }
+    for (engine = MM_CAMERA_POLL_ENGINE_POLL; engine < MM_CAMERA_POLL_ENGINE_MAX; engine++) {
+        for (r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+            rc |= poll_test_run((mm_camera_poll_engine_type_t)engine, rates[r],
+                    num_streams, seconds);
+        }
+    }
+    printf("%s\n", rc ? "FAILED" : "PASSED");
+    return rc;
+}
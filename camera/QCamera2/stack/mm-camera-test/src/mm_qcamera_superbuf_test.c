@@ -0,0 +1,316 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are
+* met:
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above
+*       copyright notice, this list of conditions and the following
+*       disclaimer in the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of The Linux Foundation nor the names of its
+*       contributors may be used to endorse or promote products derived
+*       from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+* ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+* BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+* WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+* OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+* IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*
+*/
+
+/* Replays stream buffer arrivals into a channel superbuf queue and checks
+ * that matching through the frame index gives the same bundles as the queue
+ * walk. The arrivals come from a seeded generator that delays buffers of
+ * each stream by a few frames and drops some of them, the way metadata and
+ * ZSL streams come back out of order. Each trace is run with the frame index
+ * off and on, and the queue state after every buffer plus every dequeued
+ * bundle are compared.
+ *
+ *     mm-qcamera-superbuf-test [frames] [zsl depth]
+ */
+
+// System dependencies
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Camera dependencies
+#include "mm_camera.h"
+
+/* superbuf queue functions of mm_camera_channel.c */
+int32_t mm_channel_superbuf_queue_init(mm_channel_queue_t * queue);
+int32_t mm_channel_superbuf_queue_deinit(mm_channel_queue_t * queue);
+int32_t mm_channel_superbuf_comp_and_enqueue(mm_channel_t *ch_obj,
+        mm_channel_queue_t * queue, mm_camera_buf_info_t *buf);
+mm_channel_queue_node_t* mm_channel_superbuf_dequeue(
+        mm_channel_queue_t * queue, mm_channel_t *ch_obj);
+mm_channel_queue_node_t* mm_channel_superbuf_dequeue_internal(
+        mm_channel_queue_t * queue, uint8_t matched_only, mm_channel_t *ch_obj);
+
+#define SUPERBUF_TEST_MAX_DELAY 6
+
+typedef struct {
+    uint32_t arrival;
+    uint32_t frame_idx;
+    uint8_t stream;
+} superbuf_test_event_t;
+
+typedef struct {
+    uint8_t num_streams;
+    uint32_t num_frames;
+    uint32_t first_frame_idx;
+    uint32_t max_unmatched;
+    uint32_t zsl_depth;
+    uint32_t drop_permille;
+    /* extra delay of the last stream */
+    uint32_t lag_frames;
+    uint32_t seed;
+} superbuf_test_trace_t;
+
+typedef struct {
+    uint64_t digest;
+    uint32_t bundles;
+    uint64_t ns;
+} superbuf_test_result_t;
+
+static const cam_stream_type_t superbuf_test_types[] = {
+    CAM_STREAM_TYPE_METADATA, CAM_STREAM_TYPE_PREVIEW, CAM_STREAM_TYPE_SNAPSHOT,
+    CAM_STREAM_TYPE_VIDEO, CAM_STREAM_TYPE_RAW,
+};
+#define SUPERBUF_TEST_MAX_STREAMS \
+        (sizeof(superbuf_test_types) / sizeof(superbuf_test_types[0]))
+
+static mm_channel_t superbuf_test_ch;
+static cam_stream_info_t superbuf_test_info[SUPERBUF_TEST_MAX_STREAMS];
+
+static uint32_t superbuf_test_rand(uint32_t *seed)
+{
+    *seed = *seed * 1103515245U + 12345U;
+    return (*seed >> 8) & 0xFFFF;
+}
+
+static int superbuf_test_cmp(const void *a, const void *b)
+{
+    const superbuf_test_event_t *x = (const superbuf_test_event_t *)a;
+    const superbuf_test_event_t *y = (const superbuf_test_event_t *)b;
+    if (x->arrival != y->arrival) {
+        return (x->arrival > y->arrival) - (x->arrival < y->arrival);
+    }
+    if (x->frame_idx != y->frame_idx) {
+        return (x->frame_idx > y->frame_idx) - (x->frame_idx < y->frame_idx);
+    }
+    return x->stream - y->stream;
+}
+
+static uint64_t superbuf_test_mix(uint64_t digest, uint64_t v)
+{
+    digest ^= v + 0x9E3779B97F4A7C15ULL + (digest << 6) + (digest >> 2);
+    return digest;
+}
+
+static uint64_t superbuf_test_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* arrivals of every stream buffer, in arrival order */
+static uint32_t superbuf_test_gen(const superbuf_test_trace_t *trace,
+        superbuf_test_event_t *events)
+{
+    uint32_t seed = trace->seed;
+    uint32_t f, n = 0;
+    uint8_t s;
+
+    for (f = 0; f < trace->num_frames; f++) {
+        for (s = 0; s < trace->num_streams; s++) {
+            if (superbuf_test_rand(&seed) % 1000 < trace->drop_permille) {
+                continue;
+            }
+            events[n].arrival = f + superbuf_test_rand(&seed) % SUPERBUF_TEST_MAX_DELAY;
+            if (s == trace->num_streams - 1) {
+                events[n].arrival += trace->lag_frames;
+            }
+            events[n].frame_idx = trace->first_frame_idx + f;
+            events[n].stream = s;
+            n++;
+        }
+    }
+    qsort(events, n, sizeof(events[0]), superbuf_test_cmp);
+    return n;
+}
+
+static uint64_t superbuf_test_bundle(uint64_t digest, mm_channel_queue_node_t *super_buf,
+        mm_camera_buf_def_t *bufs)
+{
+    uint8_t i;
+
+    digest = superbuf_test_mix(digest, super_buf->frame_idx);
+    for (i = 0; i < super_buf->num_of_bufs; i++) {
+        digest = superbuf_test_mix(digest, (NULL != super_buf->super_buf[i].buf) ?
+                (uint64_t)(super_buf->super_buf[i].buf - bufs) : UINT64_MAX);
+    }
+    free(super_buf);
+    return digest;
+}
+
+static int superbuf_test_run(const superbuf_test_trace_t *trace,
+        const superbuf_test_event_t *events, uint32_t num_events,
+        mm_camera_buf_def_t *bufs, uint8_t use_index, superbuf_test_result_t *result)
+{
+    mm_channel_t *ch = &superbuf_test_ch;
+    mm_channel_queue_t *queue = &ch->bundle.superbuf_queue;
+    mm_channel_queue_node_t *super_buf = NULL;
+    mm_camera_buf_info_t buf_info;
+    uint64_t start_ns;
+    uint32_t i;
+    uint8_t s;
+
+    memset(ch, 0, sizeof(*ch));
+    memset(result, 0, sizeof(*result));
+    /* no channel of their own: metadata is not parsed and drops are not queued back */
+    for (s = 0; s < trace->num_streams; s++) {
+        superbuf_test_info[s].stream_type = superbuf_test_types[s];
+        ch->streams[s].my_hdl = s + 1;
+        ch->streams[s].state = MM_STREAM_STATE_ACTIVE;
+        ch->streams[s].stream_info = &superbuf_test_info[s];
+    }
+    if (0 != mm_channel_superbuf_queue_init(queue)) {
+        return -1;
+    }
+    queue->frame_index_enabled = use_index;
+    queue->num_streams = trace->num_streams;
+    for (s = 0; s < trace->num_streams; s++) {
+        queue->bundled_streams[s] = s + 1;
+    }
+    queue->attr.notify_mode = MM_CAMERA_SUPER_BUF_NOTIFY_BURST;
+    queue->attr.priority = MM_CAMERA_SUPER_BUF_PRIORITY_NORMAL;
+    queue->attr.max_unmatched_frames = trace->max_unmatched;
+    /* as if the stream ran up to the first frame */
+    queue->expected_frame_id = trace->first_frame_idx;
+
+    start_ns = superbuf_test_now_ns();
+    for (i = 0; i < num_events; i++) {
+        mm_camera_buf_def_t *buf = &bufs[i];
+
+        memset(buf, 0, sizeof(*buf));
+        buf->stream_type = superbuf_test_types[events[i].stream];
+        buf->frame_idx = events[i].frame_idx;
+        memset(&buf_info, 0, sizeof(buf_info));
+        buf_info.stream_id = events[i].stream + 1;
+        buf_info.frame_idx = events[i].frame_idx;
+        buf_info.buf = buf;
+        mm_channel_superbuf_comp_and_enqueue(ch, queue, &buf_info);
+
+        /* ZSL keeps the newest matched super bufs */
+        while (queue->match_cnt > trace->zsl_depth) {
+            super_buf = mm_channel_superbuf_dequeue(queue, ch);
+            if (NULL == super_buf) {
+                break;
+            }
+            result->digest = superbuf_test_bundle(result->digest, super_buf, bufs);
+            result->bundles++;
+        }
+        result->digest = superbuf_test_mix(result->digest, queue->que.size);
+        result->digest = superbuf_test_mix(result->digest, queue->match_cnt);
+        result->digest = superbuf_test_mix(result->digest, queue->expected_frame_id);
+    }
+    result->ns = superbuf_test_now_ns() - start_ns;
+
+    while (NULL != (super_buf = mm_channel_superbuf_dequeue_internal(queue, FALSE, ch))) {
+        result->digest = superbuf_test_bundle(result->digest, super_buf, bufs);
+    }
+    mm_channel_superbuf_queue_deinit(queue);
+    return 0;
+}
+
+static int superbuf_test_trace(const superbuf_test_trace_t *trace)
+{
+    superbuf_test_event_t *events;
+    mm_camera_buf_def_t *bufs;
+    superbuf_test_result_t walk, index;
+    uint32_t num_events;
+    int rc = -1;
+
+    events = (superbuf_test_event_t *)malloc(
+            trace->num_frames * trace->num_streams * sizeof(*events));
+    bufs = (mm_camera_buf_def_t *)malloc(
+            trace->num_frames * trace->num_streams * sizeof(*bufs));
+    if ((NULL == events) || (NULL == bufs)) {
+        goto end;
+    }
+    num_events = superbuf_test_gen(trace, events);
+    if ((0 != superbuf_test_run(trace, events, num_events, bufs, FALSE, &walk)) ||
+            (0 != superbuf_test_run(trace, events, num_events, bufs, TRUE, &index))) {
+        goto end;
+    }
+    rc = (walk.digest == index.digest) && (walk.bundles == index.bundles) ? 0 : -1;
+    printf("%u streams, first frame %10u, max unmatched %3u, zsl depth %2u, drops %3u/1000, "
+            "lag %2u: %6u bundles, walk %5.0f ns/buf, index %5.0f ns/buf %s\n",
+            trace->num_streams, trace->first_frame_idx, trace->max_unmatched,
+            trace->zsl_depth, trace->drop_permille, trace->lag_frames, index.bundles,
+            (double)walk.ns / num_events, (double)index.ns / num_events,
+            rc ? "MISMATCH" : "ok");
+end:
+    free(events);
+    free(bufs);
+    return rc;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t num_frames = (argc > 1) ? (uint32_t)atoi(argv[1]) : 20000;
+    uint32_t zsl_depth = (argc > 2) ? (uint32_t)atoi(argv[2]) : 24;
+    const uint32_t first[] = { 1, 0xFFFFFFFFU - 1000 };
+    const uint32_t drops[] = { 0, 20, 200 };
+    superbuf_test_trace_t trace;
+    uint32_t f, d, streams;
+    int rc = 0;
+
+    if (0 == num_frames) {
+        printf("usage: %s [frames] [zsl depth]\n", argv[0]);
+        return -1;
+    }
+    memset(&trace, 0, sizeof(trace));
+    trace.num_frames = num_frames;
+    trace.max_unmatched = SUPERBUF_TEST_MAX_DELAY;
+    for (streams = 2; streams <= SUPERBUF_TEST_MAX_STREAMS; streams++) {
+        for (f = 0; f < sizeof(first) / sizeof(first[0]); f++) {
+            for (d = 0; d < sizeof(drops) / sizeof(drops[0]); d++) {
+                trace.num_streams = (uint8_t)streams;
+                trace.first_frame_idx = first[f];
+                trace.drop_permille = drops[d];
+                trace.zsl_depth = zsl_depth;
+                trace.seed = streams * 7919 + f * 31 + d;
+                rc |= superbuf_test_trace(&trace);
+            }
+        }
+    }
+    /* a tight unmatched limit and a shallow queue drop most late frames */
+    trace.num_streams = SUPERBUF_TEST_MAX_STREAMS;
+    trace.first_frame_idx = 1;
+    trace.max_unmatched = 1;
+    trace.zsl_depth = 2;
+    trace.drop_permille = 20;
+    rc |= superbuf_test_trace(&trace);
+    /* a lagging stream spreads unmatched super bufs wider than the frame index */
+    trace.max_unmatched = 2 * MM_CHANNEL_SUPERBUF_INDEX_SIZE;
+    trace.zsl_depth = zsl_depth;
+    trace.lag_frames = MM_CHANNEL_SUPERBUF_INDEX_SIZE + MM_CHANNEL_SUPERBUF_INDEX_SIZE / 2;
+    rc |= superbuf_test_trace(&trace);
+
+    printf("%s\n", rc ? "FAILED" : "PASSED");
+    return rc;
+}
@@ -75,6 +75,7 @@ LOCAL_CFLAGS += -DSYSTEM_HEADER_PREFIX=sys
 
 LOCAL_SRC_FILES := \
     src/mm_jpeg_queue.c \
+    src/mm_jpeg_sched.c \
     src/mm_jpeg_exif.c \
     src/mm_jpeg.c \
     src/mm_jpeg_interface.c \
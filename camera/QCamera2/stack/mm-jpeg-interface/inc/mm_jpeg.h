@@ -40,6 +40,7 @@
 // JPEG dependencies
 #include "mm_jpeg_interface.h"
 #include "mm_jpeg_ionbuf.h"
+#include "mm_jpeg_sched.h"
 
 // Camera dependencies
 #include "cam_list.h"
@@ -379,6 +380,7 @@ typedef struct {
     mm_jpeg_encode_job_info_t enc_info;
     mm_jpeg_decode_job_info_t dec_info;
   };
+  mm_jpeg_sched_entry_t sched;    /* job scheduler info */
 } mm_jpeg_job_q_node_t;
 
 typedef struct {
@@ -388,12 +390,6 @@ typedef struct {
   pthread_mutex_t lock;           /* job lock */
 } mm_jpeg_client_t;
 
-typedef struct {
-  pthread_t pid;                  /* job cmd thread ID */
-  cam_semaphore_t job_sem;        /* semaphore for job cmd thread */
-  mm_jpeg_queue_t job_queue;      /* queue for job to do */
-} mm_jpeg_job_cmd_thread_t;
-
 #define MAX_JPEG_CLIENT_NUM 8
 typedef struct mm_jpeg_obj_t {
   /* ClientMgr */
@@ -402,7 +398,7 @@ typedef struct mm_jpeg_obj_t {
 
   /* JobMkr */
   pthread_mutex_t job_lock;                       /* job lock */
-  mm_jpeg_job_cmd_thread_t job_mgr;               /* job mgr thread including todo_q*/
+  mm_jpeg_sched_t job_mgr;                        /* job mgr workers including todo queues */
   mm_jpeg_queue_t ongoing_job_q;                  /* queue for ongoing jobs */
   buffer_t ionBuffer[MM_JPEG_CONCURRENT_SESSIONS_COUNT];
 
@@ -460,6 +456,9 @@ extern int32_t mm_jpegdec_init(mm_jpeg_obj *my_obj);
 extern int32_t mm_jpegdec_deinit(mm_jpeg_obj *my_obj);
 extern int32_t mm_jpeg_jobmgr_thread_release(mm_jpeg_obj * my_obj);
 extern int32_t mm_jpeg_jobmgr_thread_launch(mm_jpeg_obj *my_obj);
+extern int32_t mm_jpeg_jobmgr_enq(mm_jpeg_obj *my_obj,
+  mm_jpeg_job_q_node_t *node,
+  mm_jpeg_job_prio_t priority);
 extern int32_t mm_jpegdec_start_decode_job(mm_jpeg_obj *my_obj,
   mm_jpeg_job_t* job,
   uint32_t* jobId);
@@ -520,6 +519,10 @@ mm_jpeg_job_q_node_t* mm_jpeg_queue_remove_job_by_session_id(
   mm_jpeg_queue_t* queue, uint32_t session_id);
 mm_jpeg_job_q_node_t* mm_jpeg_queue_remove_job_unlk(
   mm_jpeg_queue_t* queue, uint32_t job_id);
+mm_jpeg_job_q_node_t* mm_jpeg_jobmgr_remove_job_by_job_id(
+  mm_jpeg_obj *my_obj, uint32_t job_id);
+mm_jpeg_job_q_node_t* mm_jpeg_jobmgr_remove_job_by_session_id(
+  mm_jpeg_obj *my_obj, uint32_t session_id);
 
 
 /** mm_jpeg_queue_func_t:
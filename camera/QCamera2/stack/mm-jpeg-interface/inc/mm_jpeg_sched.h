@@ -0,0 +1,144 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef __MM_JPEG_SCHED_H__
+#define __MM_JPEG_SCHED_H__
+
+// System dependencies
+#include <pthread.h>
+#include <stdint.h>
+
+// Camera dependencies
+#include "cam_list.h"
+
+#define MM_JPEG_SCHED_MAX_WORKERS 4
+/* scheduling classes, class 0 is served first */
+#define MM_JPEG_SCHED_MAX_CLASS 3
+/* times a waiting class may be passed over before it goes first */
+#define MM_JPEG_SCHED_MAX_SKIP 4
+/* latency histogram buckets, bucket 0 counts below 2 us, bucket i
+ * [2^i, 2^(i+1)) us and the last one everything above */
+#define MM_JPEG_SCHED_HIST_BUCKETS 20
+
+/* dispatch result: no resources for the job now, requeue it at the head
+ * of its class and try again after the next job is done */
+#define MM_JPEG_SCHED_RETRY 1
+
+/** mm_jpeg_sched_entry_t:
+ *  @list: link in the queue of the class
+ *  @cls: scheduling class
+ *  @enq_ns: time the job was queued
+ *  @start_ns: time the job was dispatched
+ *
+ *  scheduler part of a job, embedded in the job node
+ **/
+typedef struct {
+  struct cam_list list;
+  uint32_t cls;
+  uint64_t enq_ns;
+  uint64_t start_ns;
+} mm_jpeg_sched_entry_t;
+
+/** mm_jpeg_sched_dispatch_t:
+ *
+ *  starts a job, called from a worker with the dispatch lock held.
+ *  Returns 0 if the job was taken, mm_jpeg_sched_job_done is then due for
+ *  it. MM_JPEG_SCHED_RETRY leaves the job with the scheduler, any other
+ *  value drops it.
+ **/
+typedef int32_t (*mm_jpeg_sched_dispatch_t)(mm_jpeg_sched_entry_t *entry,
+  void *user_data);
+
+/** mm_jpeg_sched_match_t:
+ *
+ *  returns nonzero for a queued job to be removed
+ **/
+typedef int (*mm_jpeg_sched_match_t)(mm_jpeg_sched_entry_t *entry,
+  void *match_data);
+
+/** mm_jpeg_sched_release_t:
+ *
+ *  frees a job still queued when the scheduler is released
+ **/
+typedef void (*mm_jpeg_sched_release_t)(mm_jpeg_sched_entry_t *entry);
+
+typedef struct {
+  uint32_t queued[MM_JPEG_SCHED_MAX_CLASS];
+  uint32_t started[MM_JPEG_SCHED_MAX_CLASS];
+  uint32_t done[MM_JPEG_SCHED_MAX_CLASS];
+  uint32_t retried;
+  uint32_t peak_queued;
+  /* time from queued to dispatched */
+  uint32_t queue_hist[MM_JPEG_SCHED_MAX_CLASS][MM_JPEG_SCHED_HIST_BUCKETS];
+  /* time from dispatched to done */
+  uint32_t run_hist[MM_JPEG_SCHED_MAX_CLASS][MM_JPEG_SCHED_HIST_BUCKETS];
+} mm_jpeg_sched_stats_t;
+
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  struct cam_list queue[MM_JPEG_SCHED_MAX_CLASS];
+  uint32_t num_queued;
+  uint32_t skip[MM_JPEG_SCHED_MAX_CLASS];
+  /* jobs dispatched and not done, at most max_active */
+  uint32_t active;
+  uint32_t max_active;
+  /* jobs done and kicks so far */
+  uint32_t events;
+  /* a job was retried, nothing is dispatched before the next event */
+  uint8_t blocked;
+  uint8_t running;
+  uint32_t num_workers;
+  pthread_t worker[MM_JPEG_SCHED_MAX_WORKERS];
+  /* taken around picking and dispatching a job, may be NULL */
+  pthread_mutex_t *dispatch_lock;
+  mm_jpeg_sched_dispatch_t dispatch;
+  void *user_data;
+  mm_jpeg_sched_stats_t stats;
+} mm_jpeg_sched_t;
+
+int32_t mm_jpeg_sched_init(mm_jpeg_sched_t *sched, const char *name,
+  uint32_t num_workers, uint32_t max_active,
+  mm_jpeg_sched_dispatch_t dispatch, pthread_mutex_t *dispatch_lock,
+  void *user_data);
+void mm_jpeg_sched_deinit(mm_jpeg_sched_t *sched,
+  mm_jpeg_sched_release_t release);
+int32_t mm_jpeg_sched_enq(mm_jpeg_sched_t *sched, mm_jpeg_sched_entry_t *entry,
+  uint32_t cls);
+mm_jpeg_sched_entry_t *mm_jpeg_sched_remove(mm_jpeg_sched_t *sched,
+  mm_jpeg_sched_match_t match, void *match_data);
+void mm_jpeg_sched_job_done(mm_jpeg_sched_t *sched,
+  mm_jpeg_sched_entry_t *entry);
+void mm_jpeg_sched_kick(mm_jpeg_sched_t *sched);
+void mm_jpeg_sched_get_stats(mm_jpeg_sched_t *sched,
+  mm_jpeg_sched_stats_t *stats);
+uint32_t mm_jpeg_sched_hist_percentile(const uint32_t *hist, uint32_t pct);
+void mm_jpeg_sched_dump_stats(mm_jpeg_sched_t *sched);
+
+#endif /* __MM_JPEG_SCHED_H__ */
@@ -2014,7 +2014,8 @@ error:
  *    @job_node: job node
  *
  *  Return:
- *       0 for success -1 otherwise
+ *       0 for success, MM_JPEG_SCHED_RETRY if no session is free,
+ *       -1 otherwise
  *
  *  Description:
  *       Start the encoding job
@@ -2044,13 +2045,8 @@ int32_t mm_jpeg_process_encoding_job(mm_jpeg_obj *my_obj, mm_jpeg_job_q_node_t*
 
   if (NULL == p_session) {
     LOGH("No available sessions %d", ret);
-    /* No available handles */
-    qdata.p = job_node;
-    mm_jpeg_queue_enq_head(&my_obj->job_mgr.job_queue, qdata);
-
-    LOGH("end enqueue %d", ret);
-    return rc;
-
+    /* No available handles, job mgr keeps the job until one is freed */
+    return MM_JPEG_SCHED_RETRY;
   }
 
   p_session->auto_out_buf = OMX_FALSE;
@@ -2112,73 +2108,40 @@ error:
 
 
 
-/** mm_jpeg_jobmgr_thread:
+/** mm_jpeg_jobmgr_dispatch:
  *
  *  Arguments:
- *    @my_obj: jpeg object
+ *    @entry: scheduler part of the job
+ *    @data: jpeg object
  *
  *  Return:
- *       0 for success else failure
+ *       0 if the job was started, MM_JPEG_SCHED_RETRY to try again after
+ *       the next job is done, -1 otherwise
  *
  *  Description:
- *       job manager thread main function
+ *       job manager dispatch function, called by a job mgr worker
+ *       with job_lock held
  *
  **/
-static void *mm_jpeg_jobmgr_thread(void *data)
+static int32_t mm_jpeg_jobmgr_dispatch(mm_jpeg_sched_entry_t *entry, void *data)
 {
-  mm_jpeg_q_data_t qdata;
-  int rc = 0;
-  int running = 1;
-  uint32_t num_ongoing_jobs = 0;
+  int32_t rc = -1;
   mm_jpeg_obj *my_obj = (mm_jpeg_obj*)data;
-  mm_jpeg_job_cmd_thread_t *cmd_thread = &my_obj->job_mgr;
-  mm_jpeg_job_q_node_t* node = NULL;
-  prctl(PR_SET_NAME, (unsigned long)"mm_jpeg_thread", 0, 0, 0);
-
-  do {
-    do {
-      rc = cam_sem_wait(&cmd_thread->job_sem);
-      if (rc != 0 && errno != EINVAL) {
-        LOGE("cam_sem_wait error (%s)",
-           strerror(errno));
-        return NULL;
-      }
-    } while (rc != 0);
+  mm_jpeg_job_q_node_t* node = member_of(entry, mm_jpeg_job_q_node_t, sched);
 
-    /* check ongoing q size */
-    num_ongoing_jobs = mm_jpeg_queue_get_size(&my_obj->ongoing_job_q);
-
-    LOGD("ongoing job  %d %d", num_ongoing_jobs, MM_JPEG_CONCURRENT_SESSIONS_COUNT);
-    if (num_ongoing_jobs >= MM_JPEG_CONCURRENT_SESSIONS_COUNT) {
-      LOGE("ongoing job already reach max %d", num_ongoing_jobs);
-      continue;
-    }
-
-    pthread_mutex_lock(&my_obj->job_lock);
-    /* can go ahead with new work */
-    qdata = mm_jpeg_queue_deq(&cmd_thread->job_queue);
-    node = (mm_jpeg_job_q_node_t*)qdata.p;
-    if (node != NULL) {
-      switch (node->type) {
-      case MM_JPEG_CMD_TYPE_JOB:
-        rc = mm_jpeg_process_encoding_job(my_obj, node);
-        break;
-      case MM_JPEG_CMD_TYPE_DECODE_JOB:
-        rc = mm_jpegdec_process_decoding_job(my_obj, node);
-        break;
-      case MM_JPEG_CMD_TYPE_EXIT:
-      default:
-        /* free node */
-        free(node);
-        /* set running flag to false */
-        running = 0;
-        break;
-      }
-    }
-    pthread_mutex_unlock(&my_obj->job_lock);
-
-  } while (running);
-  return NULL;
+  switch (node->type) {
+  case MM_JPEG_CMD_TYPE_JOB:
+    rc = mm_jpeg_process_encoding_job(my_obj, node);
+    break;
+  case MM_JPEG_CMD_TYPE_DECODE_JOB:
+    rc = mm_jpegdec_process_decoding_job(my_obj, node);
+    break;
+  default:
+    LOGE("invalid job type %d", node->type);
+    free(node);
+    break;
+  }
+  return rc;
 }
 
 /** mm_jpeg_jobmgr_thread_launch:
@@ -2190,24 +2153,34 @@ static void *mm_jpeg_jobmgr_thread(void *data)
  *       0 for success else failure
  *
  *  Description:
- *       launches the job manager thread
+ *       launches the job manager workers, one per concurrent
+ *       session. Dispatching takes job_lock so that abort and
+ *       destroy see each job either queued or ongoing
  *
  **/
 int32_t mm_jpeg_jobmgr_thread_launch(mm_jpeg_obj *my_obj)
 {
-  int32_t rc = 0;
-  mm_jpeg_job_cmd_thread_t *job_mgr = &my_obj->job_mgr;
-
-  cam_sem_init(&job_mgr->job_sem, 0);
-  mm_jpeg_queue_init(&job_mgr->job_queue);
-
-  /* launch the thread */
-  pthread_create(&job_mgr->pid,
-    NULL,
-    mm_jpeg_jobmgr_thread,
+  return mm_jpeg_sched_init(&my_obj->job_mgr,
+    "CAM_jpeg_jobmgr",
+    MM_JPEG_CONCURRENT_SESSIONS_COUNT,
+    MM_JPEG_CONCURRENT_SESSIONS_COUNT,
+    mm_jpeg_jobmgr_dispatch,
+    &my_obj->job_lock,
     (void *)my_obj);
-  pthread_setname_np(job_mgr->pid, "CAM_jpeg_jobmgr");
-  return rc;
+}
+
+/** mm_jpeg_jobmgr_release_job:
+ *
+ *  Arguments:
+ *    @entry: scheduler part of the job
+ *
+ *  Description:
+ *       frees a job left in the job manager
+ *
+ **/
+static void mm_jpeg_jobmgr_release_job(mm_jpeg_sched_entry_t *entry)
+{
+  free(member_of(entry, mm_jpeg_job_q_node_t, sched));
 }
 
 /** mm_jpeg_jobmgr_thread_release:
@@ -2219,37 +2192,48 @@ int32_t mm_jpeg_jobmgr_thread_launch(mm_jpeg_obj *my_obj)
  *       0 for success else failure
  *
  *  Description:
- *       Releases the job manager thread
+ *       Releases the job manager workers and the jobs still queued
  *
  **/
 int32_t mm_jpeg_jobmgr_thread_release(mm_jpeg_obj * my_obj)
 {
-  mm_jpeg_q_data_t qdata;
-  int32_t rc = 0;
-  mm_jpeg_job_cmd_thread_t * cmd_thread = &my_obj->job_mgr;
-  mm_jpeg_job_q_node_t* node =
-    (mm_jpeg_job_q_node_t *)malloc(sizeof(mm_jpeg_job_q_node_t));
-  if (NULL == node) {
-    LOGE("No memory for mm_jpeg_job_q_node_t");
-    return -1;
-  }
-
-  memset(node, 0, sizeof(mm_jpeg_job_q_node_t));
-  node->type = MM_JPEG_CMD_TYPE_EXIT;
-
-  qdata.p = node;
-  mm_jpeg_queue_enq(&cmd_thread->job_queue, qdata);
-  cam_sem_post(&cmd_thread->job_sem);
-
-  /* wait until cmd thread exits */
-  if (pthread_join(cmd_thread->pid, NULL) != 0) {
-    LOGD("pthread dead already");
-  }
-  mm_jpeg_queue_deinit(&cmd_thread->job_queue);
+  mm_jpeg_sched_dump_stats(&my_obj->job_mgr);
+  mm_jpeg_sched_deinit(&my_obj->job_mgr, mm_jpeg_jobmgr_release_job);
+  memset(&my_obj->job_mgr, 0, sizeof(mm_jpeg_sched_t));
+  return 0;
+}
 
-  cam_sem_destroy(&cmd_thread->job_sem);
-  memset(cmd_thread, 0, sizeof(mm_jpeg_job_cmd_thread_t));
-  return rc;
+/** mm_jpeg_jobmgr_enq:
+ *
+ *  Arguments:
+ *    @my_obj: jpeg object
+ *    @node: job node
+ *    @priority: job priority
+ *
+ *  Return:
+ *       0 for success else failure
+ *
+ *  Description:
+ *       Queues a job to the job manager. Callback jobs go
+ *       before snapshots, reprocess jobs after them
+ *
+ **/
+int32_t mm_jpeg_jobmgr_enq(mm_jpeg_obj *my_obj,
+  mm_jpeg_job_q_node_t *node,
+  mm_jpeg_job_prio_t priority)
+{
+  static const uint32_t prio_class[MM_JPEG_JOB_PRIO_MAX] = {
+    1, /* MM_JPEG_JOB_PRIO_SNAPSHOT */
+    0, /* MM_JPEG_JOB_PRIO_CALLBACK */
+    2, /* MM_JPEG_JOB_PRIO_REPROCESS */
+  };
+
+  if ((uint32_t)priority >= MM_JPEG_JOB_PRIO_MAX) {
+    LOGW("invalid priority %d, use snapshot", priority);
+    priority = MM_JPEG_JOB_PRIO_SNAPSHOT;
+  }
+  return mm_jpeg_sched_enq(&my_obj->job_mgr, &node->sched,
+    prio_class[priority]);
 }
 
 /** mm_jpeg_alloc_workbuffer:
@@ -2773,7 +2757,6 @@ int32_t mm_jpeg_start_job(mm_jpeg_obj *my_obj,
   mm_jpeg_job_t *job,
   uint32_t *job_id)
 {
-  mm_jpeg_q_data_t qdata;
   int32_t rc = -1;
   uint8_t session_idx = 0;
   uint8_t client_idx = 0;
@@ -2899,11 +2882,7 @@ int32_t mm_jpeg_start_job(mm_jpeg_obj *my_obj,
   node->enc_info.client_handle = p_session->client_hdl;
   node->type = MM_JPEG_CMD_TYPE_JOB;
 
-  qdata.p = node;
-  rc = mm_jpeg_queue_enq(&my_obj->job_mgr.job_queue, qdata);
-  if (0 == rc) {
-      cam_sem_post(&my_obj->job_mgr.job_sem);
-  }
+  rc = mm_jpeg_jobmgr_enq(my_obj, node, job->encode_job.priority);
 
   LOGH("session_idx %u client_idx %u job_id %d X",
     session_idx, client_idx, *job_id);
@@ -2937,7 +2916,7 @@ int32_t mm_jpeg_abort_job(mm_jpeg_obj *my_obj,
   pthread_mutex_lock(&my_obj->job_lock);
 
   /* abort job if in todo queue */
-  node = mm_jpeg_queue_remove_job_by_job_id(&my_obj->job_mgr.job_queue, jobId);
+  node = mm_jpeg_jobmgr_remove_job_by_job_id(my_obj, jobId);
   if (NULL != node) {
     free(node);
     goto abort_done;
@@ -2946,6 +2925,7 @@ int32_t mm_jpeg_abort_job(mm_jpeg_obj *my_obj,
   /* abort job if in ongoing queue */
   node = mm_jpeg_queue_remove_job_by_job_id(&my_obj->ongoing_job_q, jobId);
   if (NULL != node) {
+    mm_jpeg_sched_job_done(&my_obj->job_mgr, &node->sched);
     /* find job that is OMX ongoing, ask OMX to abort the job */
     p_session = mm_jpeg_get_session(my_obj, node->enc_info.job_id);
     if (p_session) {
@@ -3320,9 +3300,6 @@ static void mm_jpegenc_job_done(mm_jpeg_job_session_t *p_session)
   /*remove the job*/
   node = mm_jpeg_queue_remove_job_by_job_id(&my_obj->ongoing_job_q,
     p_session->jobId);
-  if (node) {
-    free(node);
-  }
   p_session->encoding = OMX_FALSE;
 
   // Queue to available sessions
@@ -3335,8 +3312,13 @@ static void mm_jpegenc_job_done(mm_jpeg_job_session_t *p_session)
     mm_jpeg_queue_enq(p_session->out_buf_q, qdata);
   }
 
-  /* wake up jobMgr thread to work on new job if there is any */
-  cam_sem_post(&my_obj->job_mgr.job_sem);
+  /* wake up jobMgr to work on new job if there is any */
+  if (node) {
+    mm_jpeg_sched_job_done(&my_obj->job_mgr, &node->sched);
+    free(node);
+  } else {
+    mm_jpeg_sched_kick(&my_obj->job_mgr);
+  }
 }
 
 /** mm_jpeg_destroy_session:
@@ -3373,16 +3355,17 @@ int32_t mm_jpeg_destroy_session(mm_jpeg_obj *my_obj,
 
   /* abort job if in todo queue */
   LOGD("abort todo jobs");
-  node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->job_mgr.job_queue, session_id);
+  node = mm_jpeg_jobmgr_remove_job_by_session_id(my_obj, session_id);
   while (NULL != node) {
     free(node);
-    node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->job_mgr.job_queue, session_id);
+    node = mm_jpeg_jobmgr_remove_job_by_session_id(my_obj, session_id);
   }
 
   /* abort job if in ongoing queue */
   LOGD("abort ongoing jobs");
   node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->ongoing_job_q, session_id);
   while (NULL != node) {
+    mm_jpeg_sched_job_done(&my_obj->job_mgr, &node->sched);
     free(node);
     node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->ongoing_job_q, session_id);
   }
@@ -3420,8 +3403,8 @@ int32_t mm_jpeg_destroy_session(mm_jpeg_obj *my_obj,
   p_session->out_buf_q = NULL;
 
 
-  /* wake up jobMgr thread to work on new job if there is any */
-  cam_sem_post(&my_obj->job_mgr.job_sem);
+  /* wake up jobMgr to work on new job if there is any */
+  mm_jpeg_sched_kick(&my_obj->job_mgr);
 
   snprintf(trace_tag, sizeof(trace_tag), "Camera:JPEGsession%d", GET_SESSION_IDX(session_id));
   ATRACE_INT(trace_tag, 0);
@@ -3462,16 +3445,17 @@ int32_t mm_jpeg_destroy_session_unlocked(mm_jpeg_obj *my_obj,
 
   /* abort job if in todo queue */
   LOGD("abort todo jobs");
-  node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->job_mgr.job_queue, session_id);
+  node = mm_jpeg_jobmgr_remove_job_by_session_id(my_obj, session_id);
   while (NULL != node) {
     free(node);
-    node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->job_mgr.job_queue, session_id);
+    node = mm_jpeg_jobmgr_remove_job_by_session_id(my_obj, session_id);
   }
 
   /* abort job if in ongoing queue */
   LOGD("abort ongoing jobs");
   node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->ongoing_job_q, session_id);
   while (NULL != node) {
+    mm_jpeg_sched_job_done(&my_obj->job_mgr, &node->sched);
     free(node);
     node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->ongoing_job_q, session_id);
   }
@@ -3751,6 +3735,46 @@ mm_jpeg_job_q_node_t* mm_jpeg_queue_remove_job_by_session_id(
   return job_node;
 }
 
+/* match a job mgr job by job id */
+static int mm_jpeg_jobmgr_match_job_id(mm_jpeg_sched_entry_t *entry, void *data)
+{
+  mm_jpeg_job_q_node_t *node = member_of(entry, mm_jpeg_job_q_node_t, sched);
+  uint32_t job_id = *(uint32_t *)data;
+
+  if (node->type == MM_JPEG_CMD_TYPE_DECODE_JOB) {
+    return node->dec_info.job_id == job_id;
+  }
+  return node->enc_info.job_id == job_id;
+}
+
+/* match a job mgr job by session id */
+static int mm_jpeg_jobmgr_match_session_id(mm_jpeg_sched_entry_t *entry, void *data)
+{
+  mm_jpeg_job_q_node_t *node = member_of(entry, mm_jpeg_job_q_node_t, sched);
+
+  return node->enc_info.encode_job.session_id == *(uint32_t *)data;
+}
+
+/* remove job from the job mgr with matching job id */
+mm_jpeg_job_q_node_t* mm_jpeg_jobmgr_remove_job_by_job_id(
+  mm_jpeg_obj *my_obj, uint32_t job_id)
+{
+  mm_jpeg_sched_entry_t *entry = mm_jpeg_sched_remove(&my_obj->job_mgr,
+    mm_jpeg_jobmgr_match_job_id, &job_id);
+
+  return entry ? member_of(entry, mm_jpeg_job_q_node_t, sched) : NULL;
+}
+
+/* remove the first job from the job mgr with matching session id */
+mm_jpeg_job_q_node_t* mm_jpeg_jobmgr_remove_job_by_session_id(
+  mm_jpeg_obj *my_obj, uint32_t session_id)
+{
+  mm_jpeg_sched_entry_t *entry = mm_jpeg_sched_remove(&my_obj->job_mgr,
+    mm_jpeg_jobmgr_match_session_id, &session_id);
+
+  return entry ? member_of(entry, mm_jpeg_job_q_node_t, sched) : NULL;
+}
+
 /* remove job from the queue with matching job id */
 mm_jpeg_job_q_node_t* mm_jpeg_queue_remove_job_by_job_id(
   mm_jpeg_queue_t* queue, uint32_t job_id)
@@ -0,0 +1,477 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// System dependencies
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+// JPEG dependencies
+#include "mm_jpeg_dbg.h"
+#include "mm_jpeg_sched.h"
+
+/** mm_jpeg_sched_now_ns:
+ *
+ *  Return:
+ *       monotonic time in ns
+ **/
+static uint64_t mm_jpeg_sched_now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/** mm_jpeg_sched_hist_add:
+ *
+ *  Arguments:
+ *    @hist: latency histogram
+ *    @ns: latency in ns
+ *
+ *  Description:
+ *       counts a latency in its log2 us bucket
+ **/
+static void mm_jpeg_sched_hist_add(uint32_t *hist, uint64_t ns)
+{
+  uint64_t us = ns / 1000;
+  uint32_t bucket = 0;
+
+  while ((us > 1) && (bucket < MM_JPEG_SCHED_HIST_BUCKETS - 1)) {
+    us >>= 1;
+    bucket++;
+  }
+  hist[bucket]++;
+}
+
+/** mm_jpeg_sched_hist_percentile:
+ *
+ *  Arguments:
+ *    @hist: latency histogram
+ *    @pct: percentile, 1 to 100
+ *
+ *  Return:
+ *       upper bound in us of the bucket holding the percentile,
+ *       0 if the histogram is empty
+ **/
+uint32_t mm_jpeg_sched_hist_percentile(const uint32_t *hist, uint32_t pct)
+{
+  uint32_t total = 0, count = 0, i;
+  uint64_t rank;
+
+  for (i = 0; i < MM_JPEG_SCHED_HIST_BUCKETS; i++) {
+    total += hist[i];
+  }
+  if (0 == total) {
+    return 0;
+  }
+  rank = ((uint64_t)total * pct + 99) / 100;
+  for (i = 0; i < MM_JPEG_SCHED_HIST_BUCKETS - 1; i++) {
+    count += hist[i];
+    if (count >= rank) {
+      break;
+    }
+  }
+  return 1U << (i + 1);
+}
+
+/** mm_jpeg_sched_pick:
+ *
+ *  Arguments:
+ *    @sched: scheduler, lock held
+ *
+ *  Return:
+ *       next job to dispatch, NULL if none is queued
+ *
+ *  Description:
+ *       takes the head of the first nonempty class, unless a lower
+ *       class was passed over MM_JPEG_SCHED_MAX_SKIP times already
+ **/
+static mm_jpeg_sched_entry_t *mm_jpeg_sched_pick(mm_jpeg_sched_t *sched)
+{
+  mm_jpeg_sched_entry_t *entry = NULL;
+  struct cam_list *head;
+  int32_t cls = -1;
+  uint32_t i;
+
+  for (i = 0; i < MM_JPEG_SCHED_MAX_CLASS; i++) {
+    head = &sched->queue[i];
+    if (head->next == head) {
+      continue;
+    }
+    if (cls < 0) {
+      cls = (int32_t)i;
+    } else if (sched->skip[i] >= MM_JPEG_SCHED_MAX_SKIP) {
+      cls = (int32_t)i;
+      break;
+    }
+  }
+  if (cls < 0) {
+    return NULL;
+  }
+  for (i = 0; i < MM_JPEG_SCHED_MAX_CLASS; i++) {
+    head = &sched->queue[i];
+    if ((i != (uint32_t)cls) && (head->next != head)) {
+      sched->skip[i]++;
+    }
+  }
+  sched->skip[cls] = 0;
+
+  entry = member_of(sched->queue[cls].next, mm_jpeg_sched_entry_t, list);
+  cam_list_del_node(&entry->list);
+  sched->num_queued--;
+  return entry;
+}
+
+/** mm_jpeg_sched_worker:
+ *
+ *  Arguments:
+ *    @data: scheduler
+ *
+ *  Description:
+ *       worker main function, waits until a job is queued, a slot is free
+ *       and no retried job waits for a completion, then dispatches the job
+ **/
+static void *mm_jpeg_sched_worker(void *data)
+{
+  mm_jpeg_sched_t *sched = (mm_jpeg_sched_t *)data;
+  mm_jpeg_sched_entry_t *entry = NULL;
+  uint32_t events;
+  uint64_t now;
+  int32_t rc;
+
+  pthread_mutex_lock(&sched->lock);
+  while (sched->running) {
+    if ((0 == sched->num_queued) || sched->blocked ||
+      (sched->active >= sched->max_active)) {
+      pthread_cond_wait(&sched->cond, &sched->lock);
+      continue;
+    }
+    /* hold the slot while the dispatch lock is taken */
+    sched->active++;
+    pthread_mutex_unlock(&sched->lock);
+
+    if (sched->dispatch_lock) {
+      pthread_mutex_lock(sched->dispatch_lock);
+    }
+    pthread_mutex_lock(&sched->lock);
+    entry = sched->blocked ? NULL : mm_jpeg_sched_pick(sched);
+    events = sched->events;
+    if (entry) {
+      now = mm_jpeg_sched_now_ns();
+      entry->start_ns = now;
+      sched->stats.started[entry->cls]++;
+      mm_jpeg_sched_hist_add(sched->stats.queue_hist[entry->cls],
+        now - entry->enq_ns);
+    }
+    pthread_mutex_unlock(&sched->lock);
+
+    rc = entry ? sched->dispatch(entry, sched->user_data) : -1;
+
+    pthread_mutex_lock(&sched->lock);
+    if (0 != rc) {
+      sched->active--;
+      if (entry && (MM_JPEG_SCHED_RETRY == rc)) {
+        LOGD("retry job of class %d", entry->cls);
+        cam_list_insert_before_node(&entry->list, sched->queue[entry->cls].next);
+        sched->num_queued++;
+        sched->stats.retried++;
+        /* nothing was done meanwhile, wait for it */
+        if (events == sched->events) {
+          sched->blocked = 1;
+        }
+      }
+      pthread_cond_broadcast(&sched->cond);
+    }
+    if (sched->dispatch_lock) {
+      pthread_mutex_unlock(sched->dispatch_lock);
+    }
+  }
+  pthread_mutex_unlock(&sched->lock);
+  return NULL;
+}
+
+/** mm_jpeg_sched_init:
+ *
+ *  Arguments:
+ *    @sched: scheduler
+ *    @name: name of the worker threads
+ *    @num_workers: number of worker threads
+ *    @max_active: number of jobs dispatched and not done at once
+ *    @dispatch: starts a job
+ *    @dispatch_lock: lock held around picking and dispatching a job,
+ *                    optional
+ *    @user_data: passed to dispatch
+ *
+ *  Return:
+ *       0 for success else failure
+ *
+ *  Description:
+ *       initializes the scheduler and launches its workers
+ **/
+int32_t mm_jpeg_sched_init(mm_jpeg_sched_t *sched, const char *name,
+  uint32_t num_workers, uint32_t max_active,
+  mm_jpeg_sched_dispatch_t dispatch, pthread_mutex_t *dispatch_lock,
+  void *user_data)
+{
+  uint32_t i;
+
+  if ((NULL == sched) || (NULL == dispatch) || (0 == num_workers) ||
+    (num_workers > MM_JPEG_SCHED_MAX_WORKERS) || (0 == max_active)) {
+    LOGE("invalid args workers %d max active %d", num_workers, max_active);
+    return -1;
+  }
+
+  memset(sched, 0, sizeof(mm_jpeg_sched_t));
+  pthread_mutex_init(&sched->lock, NULL);
+  pthread_cond_init(&sched->cond, NULL);
+  for (i = 0; i < MM_JPEG_SCHED_MAX_CLASS; i++) {
+    cam_list_init(&sched->queue[i]);
+  }
+  sched->max_active = max_active;
+  sched->dispatch = dispatch;
+  sched->dispatch_lock = dispatch_lock;
+  sched->user_data = user_data;
+  sched->running = 1;
+
+  for (i = 0; i < num_workers; i++) {
+    if (pthread_create(&sched->worker[i], NULL, mm_jpeg_sched_worker,
+      (void *)sched) != 0) {
+      LOGE("worker %d launch failed", i);
+      break;
+    }
+    pthread_setname_np(sched->worker[i], name);
+    sched->num_workers++;
+  }
+  if (0 == sched->num_workers) {
+    pthread_cond_destroy(&sched->cond);
+    pthread_mutex_destroy(&sched->lock);
+    return -1;
+  }
+  LOGH("%s: %d workers, %d active jobs", name, sched->num_workers, max_active);
+  return 0;
+}
+
+/** mm_jpeg_sched_deinit:
+ *
+ *  Arguments:
+ *    @sched: scheduler
+ *    @release: frees the jobs still queued, optional
+ *
+ *  Description:
+ *       stops the workers after their current dispatch and releases
+ *       the jobs that were not dispatched
+ **/
+void mm_jpeg_sched_deinit(mm_jpeg_sched_t *sched,
+  mm_jpeg_sched_release_t release)
+{
+  mm_jpeg_sched_entry_t *entry = NULL;
+  uint32_t i;
+
+  pthread_mutex_lock(&sched->lock);
+  sched->running = 0;
+  pthread_cond_broadcast(&sched->cond);
+  pthread_mutex_unlock(&sched->lock);
+
+  for (i = 0; i < sched->num_workers; i++) {
+    if (pthread_join(sched->worker[i], NULL) != 0) {
+      LOGD("pthread dead already");
+    }
+  }
+  sched->num_workers = 0;
+
+  while (NULL != (entry = mm_jpeg_sched_remove(sched, NULL, NULL))) {
+    if (release) {
+      release(entry);
+    }
+  }
+  pthread_cond_destroy(&sched->cond);
+  pthread_mutex_destroy(&sched->lock);
+}
+
+/** mm_jpeg_sched_enq:
+ *
+ *  Arguments:
+ *    @sched: scheduler
+ *    @entry: scheduler part of the job
+ *    @cls: scheduling class of the job
+ *
+ *  Return:
+ *       0 for success else failure
+ *
+ *  Description:
+ *       queues a job at the tail of its class
+ **/
+int32_t mm_jpeg_sched_enq(mm_jpeg_sched_t *sched, mm_jpeg_sched_entry_t *entry,
+  uint32_t cls)
+{
+  if ((NULL == entry) || (cls >= MM_JPEG_SCHED_MAX_CLASS)) {
+    LOGE("invalid job class %d", cls);
+    return -1;
+  }
+
+  entry->cls = cls;
+  entry->enq_ns = mm_jpeg_sched_now_ns();
+  entry->start_ns = 0;
+
+  pthread_mutex_lock(&sched->lock);
+  cam_list_add_tail_node(&entry->list, &sched->queue[cls]);
+  sched->num_queued++;
+  sched->stats.queued[cls]++;
+  if (sched->num_queued > sched->stats.peak_queued) {
+    sched->stats.peak_queued = sched->num_queued;
+  }
+  pthread_cond_signal(&sched->cond);
+  pthread_mutex_unlock(&sched->lock);
+  return 0;
+}
+
+/** mm_jpeg_sched_remove:
+ *
+ *  Arguments:
+ *    @sched: scheduler
+ *    @match: selects the job, NULL for any job
+ *    @match_data: passed to match
+ *
+ *  Return:
+ *       the first matching queued job, NULL if there is none
+ **/
+mm_jpeg_sched_entry_t *mm_jpeg_sched_remove(mm_jpeg_sched_t *sched,
+  mm_jpeg_sched_match_t match, void *match_data)
+{
+  mm_jpeg_sched_entry_t *entry = NULL;
+  struct cam_list *head = NULL;
+  struct cam_list *pos = NULL;
+  uint32_t i;
+
+  pthread_mutex_lock(&sched->lock);
+  for (i = 0; (i < MM_JPEG_SCHED_MAX_CLASS) && (NULL == entry); i++) {
+    head = &sched->queue[i];
+    for (pos = head->next; pos != head; pos = pos->next) {
+      mm_jpeg_sched_entry_t *cur = member_of(pos, mm_jpeg_sched_entry_t, list);
+      if ((NULL == match) || match(cur, match_data)) {
+        cam_list_del_node(&cur->list);
+        sched->num_queued--;
+        entry = cur;
+        break;
+      }
+    }
+  }
+  pthread_mutex_unlock(&sched->lock);
+  return entry;
+}
+
+/** mm_jpeg_sched_job_done:
+ *
+ *  Arguments:
+ *    @sched: scheduler
+ *    @entry: scheduler part of the job
+ *
+ *  Description:
+ *       frees the slot of a dispatched job and wakes up the workers
+ **/
+void mm_jpeg_sched_job_done(mm_jpeg_sched_t *sched,
+  mm_jpeg_sched_entry_t *entry)
+{
+  uint64_t now = mm_jpeg_sched_now_ns();
+
+  pthread_mutex_lock(&sched->lock);
+  if (sched->active > 0) {
+    sched->active--;
+  }
+  if (entry && (entry->cls < MM_JPEG_SCHED_MAX_CLASS) && entry->start_ns) {
+    sched->stats.done[entry->cls]++;
+    mm_jpeg_sched_hist_add(sched->stats.run_hist[entry->cls],
+      now - entry->start_ns);
+  }
+  sched->events++;
+  sched->blocked = 0;
+  pthread_cond_broadcast(&sched->cond);
+  pthread_mutex_unlock(&sched->lock);
+}
+
+/** mm_jpeg_sched_kick:
+ *
+ *  Arguments:
+ *    @sched: scheduler
+ *
+ *  Description:
+ *       wakes up the workers after resources were freed outside of a job,
+ *       so that a retried job is tried again
+ **/
+void mm_jpeg_sched_kick(mm_jpeg_sched_t *sched)
+{
+  pthread_mutex_lock(&sched->lock);
+  sched->events++;
+  sched->blocked = 0;
+  pthread_cond_broadcast(&sched->cond);
+  pthread_mutex_unlock(&sched->lock);
+}
+
+/** mm_jpeg_sched_get_stats:
+ *
+ *  Arguments:
+ *    @sched: scheduler
+ *    @stats: filled with a copy of the counters
+ **/
+void mm_jpeg_sched_get_stats(mm_jpeg_sched_t *sched,
+  mm_jpeg_sched_stats_t *stats)
+{
+  pthread_mutex_lock(&sched->lock);
+  *stats = sched->stats;
+  pthread_mutex_unlock(&sched->lock);
+}
+
+/** mm_jpeg_sched_dump_stats:
+ *
+ *  Arguments:
+ *    @sched: scheduler
+ *
+ *  Description:
+ *       logs job counts and latency percentiles of each class
+ **/
+void mm_jpeg_sched_dump_stats(mm_jpeg_sched_t *sched)
+{
+  mm_jpeg_sched_stats_t stats;
+  uint32_t i;
+
+  mm_jpeg_sched_get_stats(sched, &stats);
+  LOGH("peak queued %d retried %d", stats.peak_queued, stats.retried);
+  for (i = 0; i < MM_JPEG_SCHED_MAX_CLASS; i++) {
+    if (0 == stats.queued[i]) {
+      continue;
+    }
+    LOGH("class %d: queued %d started %d done %d, queue p50 %d p99 %d us, "
+      "run p50 %d p99 %d us", i, stats.queued[i], stats.started[i],
+      stats.done[i],
+      mm_jpeg_sched_hist_percentile(stats.queue_hist[i], 50),
+      mm_jpeg_sched_hist_percentile(stats.queue_hist[i], 99),
+      mm_jpeg_sched_hist_percentile(stats.run_hist[i], 50),
+      mm_jpeg_sched_hist_percentile(stats.run_hist[i], 99));
+  }
+}
@@ -92,13 +92,15 @@ static void mm_jpegdec_job_done(mm_jpeg_job_session_t *p_session)
   /*remove the job*/
   node = mm_jpeg_queue_remove_job_by_job_id(&my_obj->ongoing_job_q,
     p_session->jobId);
+  p_session->encoding = OMX_FALSE;
+
+  /* wake up jobMgr to work on new job if there is any */
   if (node) {
+    mm_jpeg_sched_job_done(&my_obj->job_mgr, &node->sched);
     free(node);
+  } else {
+    mm_jpeg_sched_kick(&my_obj->job_mgr);
   }
-  p_session->encoding = OMX_FALSE;
-
-  /* wake up jobMgr thread to work on new job if there is any */
-  cam_sem_post(&my_obj->job_mgr.job_sem);
 }
 
 
@@ -733,7 +735,6 @@ int32_t mm_jpegdec_start_decode_job(mm_jpeg_obj *my_obj,
   mm_jpeg_job_t *job,
   uint32_t *job_id)
 {
-  mm_jpeg_q_data_t qdata;
   int32_t rc = -1;
   uint8_t session_idx = 0;
   uint8_t client_idx = 0;
@@ -785,11 +786,7 @@ int32_t mm_jpegdec_start_decode_job(mm_jpeg_obj *my_obj,
   node->dec_info.client_handle = p_session->client_hdl;
   node->type = MM_JPEG_CMD_TYPE_DECODE_JOB;
 
-  qdata.p = node;
-  rc = mm_jpeg_queue_enq(&my_obj->job_mgr.job_queue, qdata);
-  if (0 == rc) {
-    cam_sem_post(&my_obj->job_mgr.job_sem);
-  }
+  rc = mm_jpeg_jobmgr_enq(my_obj, node, MM_JPEG_JOB_PRIO_SNAPSHOT);
 
   return rc;
 }
@@ -889,16 +886,17 @@ int32_t mm_jpegdec_destroy_session(mm_jpeg_obj *my_obj,
 
   /* abort job if in todo queue */
   LOGD("abort todo jobs");
-  node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->job_mgr.job_queue, session_id);
+  node = mm_jpeg_jobmgr_remove_job_by_session_id(my_obj, session_id);
   while (NULL != node) {
     free(node);
-    node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->job_mgr.job_queue, session_id);
+    node = mm_jpeg_jobmgr_remove_job_by_session_id(my_obj, session_id);
   }
 
   /* abort job if in ongoing queue */
   LOGD("abort ongoing jobs");
   node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->ongoing_job_q, session_id);
   while (NULL != node) {
+    mm_jpeg_sched_job_done(&my_obj->job_mgr, &node->sched);
     free(node);
     node = mm_jpeg_queue_remove_job_by_session_id(&my_obj->ongoing_job_q, session_id);
   }
@@ -909,8 +907,8 @@ int32_t mm_jpegdec_destroy_session(mm_jpeg_obj *my_obj,
   mm_jpeg_remove_session_idx(my_obj, session_id);
   pthread_mutex_unlock(&my_obj->job_lock);
 
-  /* wake up jobMgr thread to work on new job if there is any */
-  cam_sem_post(&my_obj->job_mgr.job_sem);
+  /* wake up jobMgr to work on new job if there is any */
+  mm_jpeg_sched_kick(&my_obj->job_mgr);
   LOGD("X");
 
   return rc;
@@ -1079,7 +1077,7 @@ int32_t mm_jpegdec_abort_job(mm_jpeg_obj *my_obj,
   pthread_mutex_lock(&my_obj->job_lock);
 
   /* abort job if in todo queue */
-  node = mm_jpeg_queue_remove_job_by_job_id(&my_obj->job_mgr.job_queue, jobId);
+  node = mm_jpeg_jobmgr_remove_job_by_job_id(my_obj, jobId);
   if (NULL != node) {
     free(node);
     goto abort_done;
@@ -1088,6 +1086,7 @@ int32_t mm_jpegdec_abort_job(mm_jpeg_obj *my_obj,
   /* abort job if in ongoing queue */
   node = mm_jpeg_queue_remove_job_by_job_id(&my_obj->ongoing_job_q, jobId);
   if (NULL != node) {
+    mm_jpeg_sched_job_done(&my_obj->job_mgr, &node->sched);
     /* find job that is OMX ongoing, ask OMX to abort the job */
     p_session = mm_jpeg_get_session(my_obj, node->dec_info.job_id);
     if (p_session) {
@@ -121,4 +121,27 @@ endif
 
 include $(BUILD_EXECUTABLE)
 
+#job scheduler test
+
+include $(CLEAR_VARS)
+LOCAL_PATH := $(MM_JPEG_TEST_PATH)
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS := -Wall -Wextra -Werror -Wno-unused-parameter
+LOCAL_CFLAGS += -D_ANDROID_
+
+LOCAL_C_INCLUDES := $(MM_JPEG_TEST_PATH)/../inc
+LOCAL_C_INCLUDES += $(MM_JPEG_TEST_PATH)/../../common
+
+LOCAL_SRC_FILES := mm_jpeg_sched_test.c
+
+LOCAL_32_BIT_ONLY := $(BOARD_QTI_CAMERA_32BIT_ONLY)
+LOCAL_MODULE           := mm-jpeg-sched-test
+LOCAL_VENDOR_MODULE := true
+include $(SDCLANG_COMMON_DEFS)
+LOCAL_PRELINK_MODULE   := false
+LOCAL_SHARED_LIBRARIES := libcutils liblog libmmjpeg_interface
+
+include $(BUILD_EXECUTABLE)
+
 LOCAL_PATH := $(OLD_LOCAL_PATH)
@@ -0,0 +1,387 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Runs the jpeg job scheduler against a fake encoder backend.
+ * The backend has a number of encode sessions, returns MM_JPEG_SCHED_RETRY
+ * when none is free and completes each job on its own engine thread after
+ * the job's encode time, like the OMX callbacks do.
+ *
+ *     mm-jpeg-sched-test [bursts]
+ */
+
+// System dependencies
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// JPEG dependencies
+#include "mm_jpeg_sched.h"
+
+#define SCHED_TEST_MAX_JOBS 4096
+#define SCHED_TEST_TIMEOUT_S 30
+
+typedef struct sched_test_job {
+  mm_jpeg_sched_entry_t sched;
+  uint32_t id;
+  uint32_t cls;
+  uint32_t run_us;
+  uint32_t done;
+  uint32_t removed;
+  struct sched_test_job *next;
+} sched_test_job_t;
+
+typedef struct {
+  mm_jpeg_sched_t sched;
+  pthread_mutex_t job_lock;
+  /* fake encoder */
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  sched_test_job_t *head;
+  sched_test_job_t *tail;
+  uint32_t free_sessions;
+  uint32_t running;
+  uint32_t peak_running;
+  uint32_t num_engines;
+  pthread_t engine[MM_JPEG_SCHED_MAX_WORKERS];
+  int stop;
+  /* checks */
+  /* last job dispatched of each class, ids grow in queuing order */
+  int32_t last_id[MM_JPEG_SCHED_MAX_CLASS];
+  uint32_t waiting[MM_JPEG_SCHED_MAX_CLASS];
+  uint32_t skipped[MM_JPEG_SCHED_MAX_CLASS];
+  uint32_t max_skipped;
+  uint32_t track_skips;
+  uint32_t completed;
+  uint32_t errors;
+  sched_test_job_t job[SCHED_TEST_MAX_JOBS];
+  uint32_t num_jobs;
+} sched_test_t;
+
+static uint64_t sched_test_now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static void sched_test_error(sched_test_t *t, const char *msg, uint32_t id)
+{
+  if (t->errors++ < 10) {
+    printf("  error: %s, job %u\n", msg, id);
+  }
+}
+
+/* dispatch of the fake backend, called with job_lock held */
+static int32_t sched_test_dispatch(mm_jpeg_sched_entry_t *entry, void *data)
+{
+  sched_test_t *t = (sched_test_t *)data;
+  sched_test_job_t *job = member_of(entry, sched_test_job_t, sched);
+  uint32_t i;
+
+  pthread_mutex_lock(&t->lock);
+  if (0 == t->free_sessions) {
+    pthread_mutex_unlock(&t->lock);
+    return MM_JPEG_SCHED_RETRY;
+  }
+  t->free_sessions--;
+  if (++t->running > t->peak_running) {
+    t->peak_running = t->running;
+  }
+  if ((int32_t)job->id <= t->last_id[job->cls]) {
+    sched_test_error(t, "out of order in its class", job->id);
+  }
+  t->last_id[job->cls] = (int32_t)job->id;
+  if (t->track_skips) {
+    t->waiting[job->cls]--;
+    t->skipped[job->cls] = 0;
+    for (i = 0; i < MM_JPEG_SCHED_MAX_CLASS; i++) {
+      if ((i != job->cls) && t->waiting[i] &&
+        (++t->skipped[i] > t->max_skipped)) {
+        t->max_skipped = t->skipped[i];
+      }
+    }
+  }
+  job->next = NULL;
+  if (t->tail) {
+    t->tail->next = job;
+  } else {
+    t->head = job;
+  }
+  t->tail = job;
+  pthread_cond_signal(&t->cond);
+  pthread_mutex_unlock(&t->lock);
+  return 0;
+}
+
+/* encode engine of the fake backend */
+static void *sched_test_engine(void *data)
+{
+  sched_test_t *t = (sched_test_t *)data;
+  sched_test_job_t *job;
+
+  pthread_mutex_lock(&t->lock);
+  while (!t->stop) {
+    if (NULL == t->head) {
+      pthread_cond_wait(&t->cond, &t->lock);
+      continue;
+    }
+    job = t->head;
+    t->head = job->next;
+    if (NULL == t->head) {
+      t->tail = NULL;
+    }
+    pthread_mutex_unlock(&t->lock);
+
+    usleep(job->run_us);
+
+    pthread_mutex_lock(&t->lock);
+    t->running--;
+    t->free_sessions++;
+    if (job->done++ || job->removed) {
+      sched_test_error(t, "done twice or after removal", job->id);
+    }
+    t->completed++;
+    pthread_mutex_unlock(&t->lock);
+    /* session is back before the scheduler is told, as in mm_jpeg */
+    mm_jpeg_sched_job_done(&t->sched, &job->sched);
+    pthread_mutex_lock(&t->lock);
+  }
+  pthread_mutex_unlock(&t->lock);
+  return NULL;
+}
+
+static int sched_test_start(sched_test_t *t, uint32_t workers, uint32_t sessions)
+{
+  uint32_t i;
+
+  memset(t, 0, sizeof(*t));
+  pthread_mutex_init(&t->job_lock, NULL);
+  pthread_mutex_init(&t->lock, NULL);
+  pthread_cond_init(&t->cond, NULL);
+  t->free_sessions = sessions;
+  for (i = 0; i < MM_JPEG_SCHED_MAX_CLASS; i++) {
+    t->last_id[i] = -1;
+  }
+  for (i = 0; i < sessions; i++) {
+    pthread_create(&t->engine[i], NULL, sched_test_engine, t);
+    t->num_engines++;
+  }
+  return mm_jpeg_sched_init(&t->sched, "sched_test", workers, workers,
+    sched_test_dispatch, &t->job_lock, t);
+}
+
+static void sched_test_stop(sched_test_t *t)
+{
+  uint32_t i;
+
+  mm_jpeg_sched_deinit(&t->sched, NULL);
+  pthread_mutex_lock(&t->lock);
+  t->stop = 1;
+  pthread_cond_broadcast(&t->cond);
+  pthread_mutex_unlock(&t->lock);
+  for (i = 0; i < t->num_engines; i++) {
+    pthread_join(t->engine[i], NULL);
+  }
+  pthread_cond_destroy(&t->cond);
+  pthread_mutex_destroy(&t->lock);
+  pthread_mutex_destroy(&t->job_lock);
+}
+
+static sched_test_job_t *sched_test_enq(sched_test_t *t, uint32_t cls, uint32_t run_us)
+{
+  sched_test_job_t *job = &t->job[t->num_jobs];
+
+  memset(job, 0, sizeof(*job));
+  job->id = t->num_jobs++;
+  job->cls = cls;
+  job->run_us = run_us;
+  mm_jpeg_sched_enq(&t->sched, &job->sched, cls);
+  return job;
+}
+
+static int sched_test_wait(sched_test_t *t, uint32_t expected)
+{
+  uint64_t deadline = sched_test_now_us() + SCHED_TEST_TIMEOUT_S * 1000000ULL;
+  uint32_t completed;
+
+  do {
+    pthread_mutex_lock(&t->lock);
+    completed = t->completed;
+    pthread_mutex_unlock(&t->lock);
+    if (completed >= expected) {
+      return 0;
+    }
+    usleep(1000);
+  } while (sched_test_now_us() < deadline);
+  printf("  error: stalled at %u of %u jobs\n", completed, expected);
+  t->errors++;
+  return -1;
+}
+
+static void sched_test_print_stats(sched_test_t *t)
+{
+  static const char *names[MM_JPEG_SCHED_MAX_CLASS] =
+    { "callback", "snapshot", "reprocess" };
+  mm_jpeg_sched_stats_t stats;
+  uint32_t i;
+
+  mm_jpeg_sched_get_stats(&t->sched, &stats);
+  for (i = 0; i < MM_JPEG_SCHED_MAX_CLASS; i++) {
+    if (0 == stats.queued[i]) {
+      continue;
+    }
+    printf("  %-9s %4u done, queue p50 %6u p99 %6u us, run p50 %6u p99 %6u us\n",
+      names[i], stats.done[i],
+      mm_jpeg_sched_hist_percentile(stats.queue_hist[i], 50),
+      mm_jpeg_sched_hist_percentile(stats.queue_hist[i], 99),
+      mm_jpeg_sched_hist_percentile(stats.run_hist[i], 50),
+      mm_jpeg_sched_hist_percentile(stats.run_hist[i], 99));
+  }
+  printf("  peak queued %u, retried %u, peak running %u\n",
+    stats.peak_queued, stats.retried, t->peak_running);
+}
+
+/* one worker and all jobs queued before the first dispatch: classes go in
+ * order, none waits more than MM_JPEG_SCHED_MAX_SKIP dispatches plus one
+ * per other class */
+static int sched_test_order(void)
+{
+  static sched_test_t t;
+  const uint32_t count[MM_JPEG_SCHED_MAX_CLASS] = { 40, 30, 20 };
+  uint32_t cls, i, total = 0;
+
+  if (sched_test_start(&t, 1, 1)) {
+    return -1;
+  }
+  t.track_skips = 1;
+  pthread_mutex_lock(&t.job_lock);
+  for (i = 0; i < 40; i++) {
+    for (cls = 0; cls < MM_JPEG_SCHED_MAX_CLASS; cls++) {
+      if (i < count[cls]) {
+        sched_test_enq(&t, cls, 50);
+        t.waiting[cls]++;
+        total++;
+      }
+    }
+  }
+  pthread_mutex_unlock(&t.job_lock);
+  sched_test_wait(&t, total);
+  if (t.max_skipped > MM_JPEG_SCHED_MAX_SKIP + MM_JPEG_SCHED_MAX_CLASS - 1) {
+    printf("  error: a class waited %u dispatches\n", t.max_skipped);
+    t.errors++;
+  }
+  printf("order: %u jobs, longest wait %u dispatches: %s\n", total,
+    t.max_skipped, t.errors ? "FAILED" : "ok");
+  sched_test_stop(&t);
+  return t.errors ? -1 : 0;
+}
+
+/* burst capture: a callback job every frame, a snapshot burst every
+ * eighth frame and some reprocess jobs, with a part of the queued jobs
+ * aborted under job_lock like mm_jpeg_abort_job does */
+static int sched_test_match_abort(mm_jpeg_sched_entry_t *entry, void *data)
+{
+  sched_test_job_t *job = member_of(entry, sched_test_job_t, sched);
+  (void)data;
+  return (job->id % 11) == 0;
+}
+
+static int sched_test_burst(uint32_t workers, uint32_t sessions, uint32_t bursts)
+{
+  static sched_test_t t;
+  sched_test_job_t *job;
+  mm_jpeg_sched_entry_t *entry;
+  uint32_t frame, i, queued = 0, removed = 0;
+  uint64_t start_us, us;
+
+  if (sched_test_start(&t, workers, sessions)) {
+    return -1;
+  }
+  start_us = sched_test_now_us();
+  for (frame = 0; frame < bursts * 8; frame++) {
+    sched_test_enq(&t, 0, 200);
+    queued++;
+    if (0 == frame % 8) {
+      for (i = 0; i < 8; i++) {
+        sched_test_enq(&t, 1, 1500);
+        queued++;
+      }
+    }
+    if (3 == frame % 16) {
+      sched_test_enq(&t, 2, 3000);
+      queued++;
+    }
+    if (5 == frame % 8) {
+      pthread_mutex_lock(&t.job_lock);
+      while (NULL != (entry = mm_jpeg_sched_remove(&t.sched,
+        sched_test_match_abort, NULL))) {
+        job = member_of(entry, sched_test_job_t, sched);
+        pthread_mutex_lock(&t.lock);
+        job->removed = 1;
+        pthread_mutex_unlock(&t.lock);
+        removed++;
+      }
+      pthread_mutex_unlock(&t.job_lock);
+    }
+    usleep(1000);
+  }
+  sched_test_wait(&t, queued - removed);
+  us = sched_test_now_us() - start_us;
+
+  if (t.peak_running > workers) {
+    printf("  error: %u jobs ran at once\n", t.peak_running);
+    t.errors++;
+  }
+  printf("burst: %u workers, %u sessions: %u jobs, %u aborted, %.1f ms: %s\n",
+    workers, sessions, queued, removed, us / 1000.0, t.errors ? "FAILED" : "ok");
+  sched_test_print_stats(&t);
+  sched_test_stop(&t);
+  return t.errors ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+  uint32_t bursts = (argc > 1) ? (uint32_t)atoi(argv[1]) : 40;
+  int rc = 0;
+
+  if ((0 == bursts) || (bursts * 8 * 3 > SCHED_TEST_MAX_JOBS)) {
+    printf("usage: %s [bursts, 1 to %d]\n", argv[0], SCHED_TEST_MAX_JOBS / 24);
+    return -1;
+  }
+  rc |= sched_test_order();
+  rc |= sched_test_burst(1, 1, bursts);
+  rc |= sched_test_burst(2, 1, bursts);
+  rc |= sched_test_burst(2, 2, bursts);
+  rc |= sched_test_burst(4, 4, bursts);
+  printf("%s\n", rc ? "FAILED" : "PASSED");
+  return rc;
+}
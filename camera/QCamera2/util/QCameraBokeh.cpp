@@ -35,6 +35,7 @@
 #include <stdlib.h>
 // Camera dependencies
 #include "QCameraBokeh.h"
+#include "QCameraSuperBufPool.h"
 #include "QCameraTrace.h"
 extern "C" {
 #include "mm_camera_dbg.h"
@@ -1016,7 +1017,7 @@ int32_t QCameraBokeh::allocateDepthBuf(cam_frame_size_t depthSize)
     }
     memset(output_data, 0, sizeof(qcamera_hal_pp_data_t));
     mm_camera_super_buf_t* output_frame =
-            (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+            QCameraSuperBufPool::getInstance()->acquire();
     if (output_frame == NULL) {
         LOGE("No memory for mm_camera_super_buf_t frame");
         free(output_data);
@@ -1034,7 +1035,7 @@ int32_t QCameraBokeh::allocateDepthBuf(cam_frame_size_t depthSize)
             (mm_camera_buf_def_t *)malloc(sizeof(mm_camera_buf_def_t));
     if (output_data->bufs == NULL) {
         LOGE("No memory for output_data->bufs");
-        free(output_frame);
+        QCameraSuperBufPool::getInstance()->release(output_frame);
         free(output_data);
         return NO_MEMORY;
     }
@@ -1043,7 +1044,7 @@ int32_t QCameraBokeh::allocateDepthBuf(cam_frame_size_t depthSize)
     output_data->snapshot_heap = new QCameraHeapMemory(QCAMERA_ION_USE_CACHE);
     if (output_data->snapshot_heap == NULL) {
         LOGE("Unable to new heap memory obj for image buf");
-        free(output_frame);
+        QCameraSuperBufPool::getInstance()->release(output_frame);
         free(output_data->bufs);
         free(output_data);
         return NO_MEMORY;
@@ -1075,15 +1076,13 @@ int32_t QCameraBokeh::allocateDepthBuf(cam_frame_size_t depthSize)
 
     if(mBokehData.aux_input->src_reproc_frame != NULL && output_data->jpeg_settings != NULL)
     {
-        output_data->src_reproc_frame = (mm_camera_super_buf_t *)
-                                        calloc(1, sizeof(mm_camera_super_buf_t));
+        output_data->src_reproc_frame = QCameraSuperBufPool::getInstance()->copy(
+                mBokehData.aux_input->src_reproc_frame);
         if (output_data->src_reproc_frame == NULL) {
             LOGE("No memory for src frame");
             free(output_data);
             return NO_MEMORY;
         }
-        memcpy(output_data->src_reproc_frame, mBokehData.aux_input->src_reproc_frame,
-                                                       sizeof(mm_camera_super_buf_t));
     }
     mBokehData.depth_output = output_data;
 
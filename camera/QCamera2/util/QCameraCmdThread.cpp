@@ -28,6 +28,7 @@
 */
 
 // System dependencies
+#include <stdlib.h>
 #include <string.h>
 #include <utils/Errors.h>
 #define PRCTL_H <SYSTEM_HEADER_PREFIX/prctl.h>
@@ -54,11 +55,16 @@ namespace qcamera {
  * RETURN     : None
  *==========================================================================*/
 QCameraCmdThread::QCameraCmdThread() :
-    cmd_queue()
+    cmd_queue(releaseCmd, this),
+    cmd_free_queue()
 {
     cmd_pid = 0;
     cam_sem_init(&sync_sem, 0);
     cam_sem_init(&cmd_sem, 0);
+    memset(cmd_pool, 0, sizeof(cmd_pool));
+    for (int i = 0; i < CAMERA_CMD_POOL_SIZE; i++) {
+        cmd_free_queue.enqueue(&cmd_pool[i].list);
+    }
 }
 
 /*===========================================================================
@@ -120,6 +126,67 @@ int32_t QCameraCmdThread::setName(const char* name)
     return NO_ERROR;
 }
 
+/*===========================================================================
+ * FUNCTION   : allocCmd
+ *
+ * DESCRIPTION: take a command node from the preallocated pool, or from the
+ *              heap when every pool entry is pending
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : command node, NULL if out of memory
+ *==========================================================================*/
+camera_cmd_t *QCameraCmdThread::allocCmd()
+{
+    struct cam_list *pos = cmd_free_queue.dequeue();
+    if (NULL != pos) {
+        return member_of(pos, camera_cmd_t, list);
+    }
+    LOGD("Command pool exhausted, allocating");
+    return (camera_cmd_t *)malloc(sizeof(camera_cmd_t));
+}
+
+/*===========================================================================
+ * FUNCTION   : recycleCmd
+ *
+ * DESCRIPTION: return a command node taken with allocCmd
+ *
+ * PARAMETERS :
+ *   @node    : command node
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraCmdThread::recycleCmd(camera_cmd_t *node)
+{
+    if ((node >= &cmd_pool[0]) && (node < &cmd_pool[CAMERA_CMD_POOL_SIZE])) {
+        cmd_free_queue.enqueue(&node->list);
+    } else {
+        free(node);
+    }
+}
+
+/*===========================================================================
+ * FUNCTION   : releaseCmd
+ *
+ * DESCRIPTION: release function for commands still pending when cmd_queue
+ *              is flushed. Pool entries need no cleanup.
+ *
+ * PARAMETERS :
+ *   @node      : list link of the command
+ *   @user_data : QCameraCmdThread owning the command
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraCmdThread::releaseCmd(struct cam_list *node, void *user_data)
+{
+    QCameraCmdThread *pme = (QCameraCmdThread *)user_data;
+    camera_cmd_t *cmd = member_of(node, camera_cmd_t, list);
+
+    if ((cmd < &pme->cmd_pool[0]) || (cmd >= &pme->cmd_pool[CAMERA_CMD_POOL_SIZE])) {
+        free(cmd);
+    }
+}
+
 /*===========================================================================
  * FUNCTION   : sendCmd
  *
@@ -138,7 +205,7 @@ int32_t QCameraCmdThread::setName(const char* name)
  *==========================================================================*/
 int32_t QCameraCmdThread::sendCmd(camera_cmd_type_t cmd, uint8_t sync_cmd, uint8_t priority)
 {
-    camera_cmd_t *node = (camera_cmd_t *)malloc(sizeof(camera_cmd_t));
+    camera_cmd_t *node = allocCmd();
     if (NULL == node) {
         LOGE("No memory for camera_cmd_t");
         return NO_MEMORY;
@@ -148,13 +215,13 @@ int32_t QCameraCmdThread::sendCmd(camera_cmd_type_t cmd, uint8_t sync_cmd, uint8
     node->is_sync = sync_cmd;
 
     if (priority) {
-        if (!cmd_queue.enqueueWithPriority((void *)node)) {
-            free(node);
+        if (!cmd_queue.enqueueWithPriority(&node->list)) {
+            recycleCmd(node);
             node = NULL;
         }
     } else {
-        if (!cmd_queue.enqueue((void *)node)) {
-            free(node);
+        if (!cmd_queue.enqueue(&node->list)) {
+            recycleCmd(node);
             node = NULL;
         }
     }
@@ -179,13 +246,14 @@ int32_t QCameraCmdThread::sendCmd(camera_cmd_type_t cmd, uint8_t sync_cmd, uint8
 camera_cmd_type_t QCameraCmdThread::getCmd()
 {
     camera_cmd_type_t cmd = CAMERA_CMD_TYPE_NONE;
-    camera_cmd_t *node = (camera_cmd_t *)cmd_queue.dequeue();
-    if (NULL == node) {
+    struct cam_list *pos = cmd_queue.dequeue();
+    if (NULL == pos) {
         LOGD("No notify avail");
         return CAMERA_CMD_TYPE_NONE;
     } else {
+        camera_cmd_t *node = member_of(pos, camera_cmd_t, list);
         cmd = node->cmd;
-        free(node);
+        recycleCmd(node);
     }
     return cmd;
 }
@@ -203,14 +271,15 @@ camera_cmd_type_t QCameraCmdThread::getCmd()
 camera_cmd_type_t QCameraCmdThread::getCmd(uint8_t &sync_cmd)
 {
     camera_cmd_type_t cmd = CAMERA_CMD_TYPE_NONE;
-    camera_cmd_t *node = (camera_cmd_t *)cmd_queue.dequeue();
-    if (NULL == node) {
+    struct cam_list *pos = cmd_queue.dequeue();
+    if (NULL == pos) {
         LOGD("No notify avail");
         return CAMERA_CMD_TYPE_NONE;
     } else {
+        camera_cmd_t *node = member_of(pos, camera_cmd_t, list);
         cmd = node->cmd;
         sync_cmd = node->is_sync;
-        free(node);
+        recycleCmd(node);
     }
     return cmd;
 }
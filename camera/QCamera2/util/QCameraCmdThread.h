@@ -54,10 +54,15 @@ typedef enum
 } camera_cmd_type_t;
 
 typedef struct {
+    struct cam_list list;   // link in cmd_queue or the free list
     camera_cmd_type_t cmd;
     uint8_t is_sync;
 } camera_cmd_t;
 
+/* Commands preallocated per thread. A thread rarely has more than a couple
+ * pending, sendCmd falls back to malloc beyond this. */
+#define CAMERA_CMD_POOL_SIZE 16
+
 class QCameraCmdThread {
 public:
     QCameraCmdThread();
@@ -70,10 +75,18 @@ public:
     camera_cmd_type_t getCmd();
     camera_cmd_type_t getCmd(uint8_t &sync_cmd);
 
-    QCameraQueue cmd_queue;      /* cmd queue */
+    QCameraIntrusiveQueue cmd_queue;      /* cmd queue */
     pthread_t cmd_pid;           /* cmd thread ID */
     cam_semaphore_t cmd_sem;               /* semaphore for cmd thread */
     cam_semaphore_t sync_sem;              /* semaphore for synchronized call signal */
+
+private:
+    camera_cmd_t *allocCmd();
+    void recycleCmd(camera_cmd_t *node);
+    static void releaseCmd(struct cam_list *node, void *user_data);
+
+    camera_cmd_t cmd_pool[CAMERA_CMD_POOL_SIZE];
+    QCameraIntrusiveQueue cmd_free_queue; /* unused cmd_pool entries */
 };
 
 }; // namespace qcamera
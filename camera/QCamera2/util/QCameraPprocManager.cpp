@@ -33,6 +33,7 @@
 #include "QCameraDualFOVPP.h"
 #include "QCameraBokeh.h"
 #include "QCameraClearSight.h"
+#include "QCameraSuperBufPool.h"
 
 using namespace android;
 
@@ -336,7 +337,7 @@ void QCameraHALPPManager::releaseData(qcamera_hal_pp_data_t *pData)
             if (!pData->reproc_frame_release) {
                 m_halPPReleaseBufCB(pData->src_reproc_frame, pData->pUserData);
             }
-            free(pData->src_reproc_frame);
+            QCameraSuperBufPool::getInstance()->release(pData->src_reproc_frame);
             pData->src_reproc_frame = NULL;
         }
         mm_camera_super_buf_t *frame = pData->frame;
@@ -346,7 +347,7 @@ void QCameraHALPPManager::releaseData(qcamera_hal_pp_data_t *pData)
             } else {
                 m_halPPReleaseBufCB(frame, pData->pUserData);
             }
-            free(frame);
+            QCameraSuperBufPool::getInstance()->release(frame);
             frame = NULL;
         }
         if (pData->snapshot_heap) {
@@ -506,7 +507,7 @@ void QCameraHALPPManager::getHalPPOutputBuffer(uint32_t frameIndex)
     }
     memset(output_data, 0, sizeof(qcamera_hal_pp_data_t));
     mm_camera_super_buf_t* output_frame =
-            (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+            QCameraSuperBufPool::getInstance()->acquire();
     if (output_frame == NULL) {
         LOGE("No memory for mm_camera_super_buf_t frame");
         free(output_data);
@@ -518,7 +519,7 @@ void QCameraHALPPManager::getHalPPOutputBuffer(uint32_t frameIndex)
             (mm_camera_buf_def_t *)malloc(HAL_PP_NUM_BUFS * sizeof(mm_camera_buf_def_t));
     if (output_data->bufs == NULL) {
         LOGE("No memory for output_data->bufs");
-        free(output_frame);
+        QCameraSuperBufPool::getInstance()->release(output_frame);
         free(output_data);
         return;
     }
@@ -527,7 +528,7 @@ void QCameraHALPPManager::getHalPPOutputBuffer(uint32_t frameIndex)
     output_data->snapshot_heap = new QCameraHeapMemory(QCAMERA_ION_USE_CACHE);
     if (output_data->snapshot_heap == NULL) {
         LOGE("Unable to new heap memory obj for image buf");
-        free(output_frame);
+        QCameraSuperBufPool::getInstance()->release(output_frame);
         free(output_data->bufs);
         free(output_data);
         return;
@@ -536,7 +537,7 @@ void QCameraHALPPManager::getHalPPOutputBuffer(uint32_t frameIndex)
     if (output_data->metadata_heap == NULL) {
         LOGE("Unable to new heap memory obj for metadata buf");
         delete output_data->snapshot_heap;
-        free(output_frame);
+        QCameraSuperBufPool::getInstance()->release(output_frame);
         free(output_data->bufs);
         free(output_data);
         return;
@@ -28,6 +28,7 @@
 */
 
 // System dependencies
+#include <stdlib.h>
 #include <string.h>
 #include <utils/Errors.h>
 
@@ -52,10 +53,17 @@ namespace qcamera {
 QCameraQueue::QCameraQueue()
 {
     pthread_mutex_init(&m_lock, NULL);
-    cam_list_init(&m_head.list);
+    m_capacity = QCAMERA_QUEUE_DEFAULT_CAPACITY;
+    m_ring = (void **)malloc(m_capacity * sizeof(void *));
+    if (NULL == m_ring) {
+        LOGE("No memory for queue ring");
+        m_capacity = 0;
+    }
+    m_head = 0;
     m_size = 0;
     m_dataFn = NULL;
     m_userData = NULL;
+    m_bDataFnFrees = false;
     m_active = true;
 }
 
@@ -67,16 +75,25 @@ QCameraQueue::QCameraQueue()
  * PARAMETERS :
  *   @data_rel_fn : function ptr to release node data internal resource
  *   @user_data   : user data ptr
+ *   @data_fn_frees : data_rel_fn frees the node data itself
  *
  * RETURN     : None
  *==========================================================================*/
-QCameraQueue::QCameraQueue(release_data_fn data_rel_fn, void *user_data)
+QCameraQueue::QCameraQueue(release_data_fn data_rel_fn, void *user_data,
+        bool data_fn_frees)
 {
     pthread_mutex_init(&m_lock, NULL);
-    cam_list_init(&m_head.list);
+    m_capacity = QCAMERA_QUEUE_DEFAULT_CAPACITY;
+    m_ring = (void **)malloc(m_capacity * sizeof(void *));
+    if (NULL == m_ring) {
+        LOGE("No memory for queue ring");
+        m_capacity = 0;
+    }
+    m_head = 0;
     m_size = 0;
     m_dataFn = data_rel_fn;
     m_userData = user_data;
+    m_bDataFnFrees = data_fn_frees;
     m_active = true;
 }
 
@@ -92,6 +109,8 @@ QCameraQueue::QCameraQueue(release_data_fn data_rel_fn, void *user_data)
 QCameraQueue::~QCameraQueue()
 {
     flush();
+    free(m_ring);
+    m_ring = NULL;
     pthread_mutex_destroy(&m_lock);
 }
 
@@ -131,6 +150,58 @@ bool QCameraQueue::isEmpty()
     return flag;
 }
 
+/*===========================================================================
+ * FUNCTION   : grow
+ *
+ * DESCRIPTION: double the ring capacity, unrolling the elements to the start
+ *              of the new ring. Must be called with m_lock held.
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : true -- success; false -- no memory
+ *==========================================================================*/
+bool QCameraQueue::grow()
+{
+    uint32_t capacity = m_capacity ? (m_capacity << 1) : QCAMERA_QUEUE_DEFAULT_CAPACITY;
+    void **ring = (void **)malloc(capacity * sizeof(void *));
+    if (NULL == ring) {
+        LOGE("No memory to grow queue to %u", capacity);
+        return false;
+    }
+
+    for (int i = 0; i < m_size; i++) {
+        ring[i] = m_ring[slot(i)];
+    }
+    free(m_ring);
+    m_ring = ring;
+    m_capacity = capacity;
+    m_head = 0;
+    return true;
+}
+
+/*===========================================================================
+ * FUNCTION   : releaseData
+ *
+ * DESCRIPTION: release one element that is dropped from the queue. The
+ *              element is freed here unless the release function owns it.
+ *
+ * PARAMETERS :
+ *   @data    : element to release
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraQueue::releaseData(void *data)
+{
+    if (NULL != data) {
+        if (m_dataFn) {
+            m_dataFn(data, m_userData);
+        }
+        if (!m_bDataFnFrees) {
+            free(data);
+        }
+    }
+}
+
 /*===========================================================================
  * FUNCTION   : enqueue
  *
@@ -143,25 +214,15 @@ bool QCameraQueue::isEmpty()
  *==========================================================================*/
 bool QCameraQueue::enqueue(void *data)
 {
-    bool rc;
-    camera_q_node *node =
-        (camera_q_node *)malloc(sizeof(camera_q_node));
-    if (NULL == node) {
-        LOGE("No memory for camera_q_node");
-        return false;
-    }
-
-    memset(node, 0, sizeof(camera_q_node));
-    node->data = data;
+    bool rc = false;
 
     pthread_mutex_lock(&m_lock);
     if (m_active) {
-        cam_list_add_tail_node(&node->list, &m_head.list);
-        m_size++;
-        rc = true;
-    } else {
-        free(node);
-        rc = false;
+        if (((uint32_t)m_size < m_capacity) || grow()) {
+            m_ring[slot(m_size)] = data;
+            m_size++;
+            rc = true;
+        }
     }
     pthread_mutex_unlock(&m_lock);
     return rc;
@@ -180,31 +241,16 @@ bool QCameraQueue::enqueue(void *data)
  *==========================================================================*/
 bool QCameraQueue::enqueueWithPriority(void *data)
 {
-    bool rc;
-    camera_q_node *node =
-        (camera_q_node *)malloc(sizeof(camera_q_node));
-    if (NULL == node) {
-        LOGE("No memory for camera_q_node");
-        return false;
-    }
-
-    memset(node, 0, sizeof(camera_q_node));
-    node->data = data;
+    bool rc = false;
 
     pthread_mutex_lock(&m_lock);
     if (m_active) {
-        struct cam_list *p_next = m_head.list.next;
-
-        m_head.list.next = &node->list;
-        p_next->prev = &node->list;
-        node->list.next = p_next;
-        node->list.prev = &m_head.list;
-
-        m_size++;
-        rc = true;
-    } else {
-        free(node);
-        rc = false;
+        if (((uint32_t)m_size < m_capacity) || grow()) {
+            m_head = (m_head + m_capacity - 1) & (m_capacity - 1);
+            m_ring[m_head] = data;
+            m_size++;
+            rc = true;
+        }
     }
     pthread_mutex_unlock(&m_lock);
     return rc;
@@ -221,25 +267,14 @@ bool QCameraQueue::enqueueWithPriority(void *data)
  *==========================================================================*/
 void* QCameraQueue::peek()
 {
-    camera_q_node* node = NULL;
     void* data = NULL;
-    struct cam_list *head = NULL;
-    struct cam_list *pos = NULL;
 
     pthread_mutex_lock(&m_lock);
-    if (m_active) {
-        head = &m_head.list;
-        pos = head->next;
-        if (pos != head) {
-            node = member_of(pos, camera_q_node, list);
-        }
+    if (m_active && (m_size > 0)) {
+        data = m_ring[m_head];
     }
     pthread_mutex_unlock(&m_lock);
 
-    if (NULL != node) {
-        data = node->data;
-    }
-
     return data;
 }
 
@@ -256,32 +291,20 @@ void* QCameraQueue::peek()
  *==========================================================================*/
 void* QCameraQueue::dequeue(bool bFromHead)
 {
-    camera_q_node* node = NULL;
     void* data = NULL;
-    struct cam_list *head = NULL;
-    struct cam_list *pos = NULL;
 
     pthread_mutex_lock(&m_lock);
-    if (m_active) {
-        head = &m_head.list;
+    if (m_active && (m_size > 0)) {
         if (bFromHead) {
-            pos = head->next;
+            data = m_ring[m_head];
+            m_head = (m_head + 1) & (m_capacity - 1);
         } else {
-            pos = head->prev;
-        }
-        if (pos != head) {
-            node = member_of(pos, camera_q_node, list);
-            cam_list_del_node(&node->list);
-            m_size--;
+            data = m_ring[slot(m_size - 1)];
         }
+        m_size--;
     }
     pthread_mutex_unlock(&m_lock);
 
-    if (NULL != node) {
-        data = node->data;
-        free(node);
-    }
-
     return data;
 }
 
@@ -297,9 +320,6 @@ void* QCameraQueue::dequeue(bool bFromHead)
  * RETURN     : data ptr. NULL if not any data in the queue.
  *==========================================================================*/
 void* QCameraQueue::dequeue(match_fn_data match, void *match_data){
-    camera_q_node* node = NULL;
-    struct cam_list *head = NULL;
-    struct cam_list *pos = NULL;
     void* data = NULL;
 
     if ( NULL == match || NULL == match_data ) {
@@ -308,26 +328,20 @@ void* QCameraQueue::dequeue(match_fn_data match, void *match_data){
 
     pthread_mutex_lock(&m_lock);
     if (m_active) {
-        head = &m_head.list;
-        pos = head->next;
-
-        while(pos != head) {
-            node = member_of(pos, camera_q_node, list);
-            pos = pos->next;
-            if (NULL != node) {
-                if ( match(node->data, m_userData, match_data) ) {
-                    cam_list_del_node(&node->list);
-                    m_size--;
-                    data = node->data;
-                    free(node);
-                    pthread_mutex_unlock(&m_lock);
-                    return data;
+        for (int i = 0; i < m_size; i++) {
+            if ( match(m_ring[slot(i)], m_userData, match_data) ) {
+                data = m_ring[slot(i)];
+                // close the gap, keeping the order of the remaining elements
+                for (int j = i; j < m_size - 1; j++) {
+                    m_ring[slot(j)] = m_ring[slot(j + 1)];
                 }
+                m_size--;
+                break;
             }
         }
     }
     pthread_mutex_unlock(&m_lock);
-    return NULL;
+    return data;
 }
 
 /*===========================================================================
@@ -341,31 +355,15 @@ void* QCameraQueue::dequeue(match_fn_data match, void *match_data){
  * RETURN     : None
  *==========================================================================*/
 void QCameraQueue::flush(){
-    camera_q_node* node = NULL;
-    struct cam_list *head = NULL;
-    struct cam_list *pos = NULL;
-
     pthread_mutex_lock(&m_lock);
     if (m_active) {
-        head = &m_head.list;
-        pos = head->next;
-
-        while(pos != head) {
-            node = member_of(pos, camera_q_node, list);
-            pos = pos->next;
-            cam_list_del_node(&node->list);
+        while (m_size > 0) {
+            void *data = m_ring[m_head];
+            m_head = (m_head + 1) & (m_capacity - 1);
             m_size--;
-
-            if (NULL != node->data) {
-                if (m_dataFn) {
-                    m_dataFn(node->data, m_userData);
-                }
-                free(node->data);
-            }
-            free(node);
-
+            releaseData(data);
         }
-        m_size = 0;
+        m_head = 0;
         m_active = false;
     }
     pthread_mutex_unlock(&m_lock);
@@ -383,35 +381,22 @@ void QCameraQueue::flush(){
  * RETURN     : None
  *==========================================================================*/
 void QCameraQueue::flushNodes(match_fn match){
-    camera_q_node* node = NULL;
-    struct cam_list *head = NULL;
-    struct cam_list *pos = NULL;
-
     if ( NULL == match ) {
         return;
     }
 
     pthread_mutex_lock(&m_lock);
     if (m_active) {
-        head = &m_head.list;
-        pos = head->next;
-
-        while(pos != head) {
-            node = member_of(pos, camera_q_node, list);
-            pos = pos->next;
-            if ( match(node->data, m_userData) ) {
-                cam_list_del_node(&node->list);
-                m_size--;
-
-                if (NULL != node->data) {
-                    if (m_dataFn) {
-                        m_dataFn(node->data, m_userData);
-                    }
-                    free(node->data);
-                }
-                free(node);
+        int kept = 0;
+        for (int i = 0; i < m_size; i++) {
+            void *data = m_ring[slot(i)];
+            if ( match(data, m_userData) ) {
+                releaseData(data);
+            } else {
+                m_ring[slot(kept++)] = data;
             }
         }
+        m_size = kept;
     }
     pthread_mutex_unlock(&m_lock);
 }
@@ -428,33 +413,302 @@ void QCameraQueue::flushNodes(match_fn match){
  * RETURN     : None
  *==========================================================================*/
 void QCameraQueue::flushNodes(match_fn_data match, void *match_data){
-    camera_q_node* node = NULL;
-    struct cam_list *head = NULL;
-    struct cam_list *pos = NULL;
-
     if ( NULL == match ) {
         return;
     }
 
     pthread_mutex_lock(&m_lock);
     if (m_active) {
-        head = &m_head.list;
-        pos = head->next;
+        int kept = 0;
+        for (int i = 0; i < m_size; i++) {
+            void *data = m_ring[slot(i)];
+            if ( match(data, m_userData, match_data) ) {
+                releaseData(data);
+            } else {
+                m_ring[slot(kept++)] = data;
+            }
+        }
+        m_size = kept;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
 
-        while(pos != head) {
-            node = member_of(pos, camera_q_node, list);
-            pos = pos->next;
-            if ( match(node->data, m_userData, match_data) ) {
-                cam_list_del_node(&node->list);
+/*===========================================================================
+ * FUNCTION   : QCameraIntrusiveQueue
+ *
+ * DESCRIPTION: default constructor of QCameraIntrusiveQueue
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+QCameraIntrusiveQueue::QCameraIntrusiveQueue()
+{
+    pthread_mutex_init(&m_lock, NULL);
+    cam_list_init(&m_head);
+    m_size = 0;
+    m_nodeFn = NULL;
+    m_userData = NULL;
+    m_active = true;
+}
+
+/*===========================================================================
+ * FUNCTION   : QCameraIntrusiveQueue
+ *
+ * DESCRIPTION: constructor of QCameraIntrusiveQueue
+ *
+ * PARAMETERS :
+ *   @node_rel_fn : function ptr called for every node dropped by a flush
+ *   @user_data   : user data ptr
+ *
+ * RETURN     : None
+ *==========================================================================*/
+QCameraIntrusiveQueue::QCameraIntrusiveQueue(release_node_fn node_rel_fn,
+        void *user_data)
+{
+    pthread_mutex_init(&m_lock, NULL);
+    cam_list_init(&m_head);
+    m_size = 0;
+    m_nodeFn = node_rel_fn;
+    m_userData = user_data;
+    m_active = true;
+}
+
+/*===========================================================================
+ * FUNCTION   : ~QCameraIntrusiveQueue
+ *
+ * DESCRIPTION: deconstructor of QCameraIntrusiveQueue
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+QCameraIntrusiveQueue::~QCameraIntrusiveQueue()
+{
+    flush();
+    pthread_mutex_destroy(&m_lock);
+}
+
+/*===========================================================================
+ * FUNCTION   : init
+ *
+ * DESCRIPTION: Put the queue to active state (ready to enqueue and dequeue)
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraIntrusiveQueue::init()
+{
+    pthread_mutex_lock(&m_lock);
+    m_active = true;
+    pthread_mutex_unlock(&m_lock);
+}
+
+/*===========================================================================
+ * FUNCTION   : isEmpty
+ *
+ * DESCRIPTION: return if the queue is empty or not
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : true -- queue is empty; false -- not empty
+ *==========================================================================*/
+bool QCameraIntrusiveQueue::isEmpty()
+{
+    bool flag = true;
+    pthread_mutex_lock(&m_lock);
+    if (m_size > 0) {
+        flag = false;
+    }
+    pthread_mutex_unlock(&m_lock);
+    return flag;
+}
+
+/*===========================================================================
+ * FUNCTION   : enqueue
+ *
+ * DESCRIPTION: link a node at the tail of the queue
+ *
+ * PARAMETERS :
+ *   @node    : node to be enqueued
+ *
+ * RETURN     : true -- success; false -- failed
+ *==========================================================================*/
+bool QCameraIntrusiveQueue::enqueue(struct cam_list *node)
+{
+    bool rc = false;
+
+    if (NULL == node) {
+        return false;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    if (m_active) {
+        cam_list_add_tail_node(node, &m_head);
+        m_size++;
+        rc = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+    return rc;
+}
+
+/*===========================================================================
+ * FUNCTION   : enqueueWithPriority
+ *
+ * DESCRIPTION: link a node at the head of the queue
+ *
+ * PARAMETERS :
+ *   @node    : node to be enqueued
+ *
+ * RETURN     : true -- success; false -- failed
+ *==========================================================================*/
+bool QCameraIntrusiveQueue::enqueueWithPriority(struct cam_list *node)
+{
+    bool rc = false;
+
+    if (NULL == node) {
+        return false;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    if (m_active) {
+        struct cam_list *p_next = m_head.next;
+
+        m_head.next = node;
+        p_next->prev = node;
+        node->next = p_next;
+        node->prev = &m_head;
+
+        m_size++;
+        rc = true;
+    }
+    pthread_mutex_unlock(&m_lock);
+    return rc;
+}
+
+/*===========================================================================
+ * FUNCTION   : dequeue
+ *
+ * DESCRIPTION: unlink a node from the queue
+ *
+ * PARAMETERS :
+ *   @bFromHead : if true, dequeue from the head
+ *                if false, dequeue from the tail
+ *
+ * RETURN     : node ptr. NULL if the queue is empty.
+ *==========================================================================*/
+struct cam_list *QCameraIntrusiveQueue::dequeue(bool bFromHead)
+{
+    struct cam_list *node = NULL;
+
+    pthread_mutex_lock(&m_lock);
+    if (m_active) {
+        struct cam_list *pos = bFromHead ? m_head.next : m_head.prev;
+        if (pos != &m_head) {
+            cam_list_del_node(pos);
+            m_size--;
+            node = pos;
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+    return node;
+}
+
+/*===========================================================================
+ * FUNCTION   : dequeue
+ *
+ * DESCRIPTION: unlink the first node accepted by the matching function
+ *
+ * PARAMETERS :
+ *   @match      : matching function callback
+ *   @match_data : the actual data to be matched
+ *
+ * RETURN     : node ptr. NULL if no node matched.
+ *==========================================================================*/
+struct cam_list *QCameraIntrusiveQueue::dequeue(match_node_fn match,
+        void *match_data)
+{
+    struct cam_list *node = NULL;
+
+    if (NULL == match) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    if (m_active) {
+        for (struct cam_list *pos = m_head.next; pos != &m_head; pos = pos->next) {
+            if (match(pos, match_data)) {
+                cam_list_del_node(pos);
                 m_size--;
+                node = pos;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&m_lock);
+    return node;
+}
 
-                if (NULL != node->data) {
-                    if (m_dataFn) {
-                        m_dataFn(node->data, m_userData);
-                    }
-                    free(node->data);
+/*===========================================================================
+ * FUNCTION   : flush
+ *
+ * DESCRIPTION: unlink all nodes, handing each to the release function.
+ *              The queue needs init() before it can be used again.
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraIntrusiveQueue::flush()
+{
+    pthread_mutex_lock(&m_lock);
+    if (m_active) {
+        struct cam_list *pos = m_head.next;
+        while (pos != &m_head) {
+            struct cam_list *node = pos;
+            pos = pos->next;
+            cam_list_del_node(node);
+            if (m_nodeFn) {
+                m_nodeFn(node, m_userData);
+            }
+        }
+        m_size = 0;
+        m_active = false;
+    }
+    pthread_mutex_unlock(&m_lock);
+}
+
+/*===========================================================================
+ * FUNCTION   : flushNodes
+ *
+ * DESCRIPTION: unlink the nodes accepted by the matching function, handing
+ *              each to the release function
+ *
+ * PARAMETERS :
+ *   @match      : matching function
+ *   @match_data : the actual data to be matched
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraIntrusiveQueue::flushNodes(match_node_fn match, void *match_data)
+{
+    if (NULL == match) {
+        return;
+    }
+
+    pthread_mutex_lock(&m_lock);
+    if (m_active) {
+        struct cam_list *pos = m_head.next;
+        while (pos != &m_head) {
+            struct cam_list *node = pos;
+            pos = pos->next;
+            if (match(node, match_data)) {
+                cam_list_del_node(node);
+                m_size--;
+                if (m_nodeFn) {
+                    m_nodeFn(node, m_userData);
                 }
-                free(node);
             }
         }
     }
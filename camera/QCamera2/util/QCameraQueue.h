@@ -32,12 +32,17 @@
 
 // System dependencies
 #include <pthread.h>
+#include <stdint.h>
 
 // Camera dependencies
 #include "cam_list.h"
 
 namespace qcamera {
 
+/* Initial number of slots of a QCameraQueue ring. Queues that need more
+ * grow by doubling under the queue lock and keep the larger ring. */
+#define QCAMERA_QUEUE_DEFAULT_CAPACITY 16
+
 typedef bool (*match_fn_data)(void *data, void *user_data, void *match_data);
 typedef void (*release_data_fn)(void* data, void *user_data);
 typedef bool (*match_fn)(void *data, void *user_data);
@@ -45,7 +50,10 @@ typedef bool (*match_fn)(void *data, void *user_data);
 class QCameraQueue {
 public:
     QCameraQueue();
-    QCameraQueue(release_data_fn data_rel_fn, void *user_data);
+    /* When data_fn_frees is set, data_rel_fn also frees the element it is
+     * handed; otherwise the queue frees it after data_rel_fn returns. */
+    QCameraQueue(release_data_fn data_rel_fn, void *user_data,
+            bool data_fn_frees = false);
     virtual ~QCameraQueue();
     void init();
     bool enqueue(void *data);
@@ -60,18 +68,50 @@ public:
     void* peek();
     bool isEmpty();
     int getCurrentSize() {return m_size;}
+    uint32_t getCapacity() {return m_capacity;}
 private:
-    typedef struct {
-        struct cam_list list;
-        void* data;
-    } camera_q_node;
+    bool grow();
+    void releaseData(void *data);
+    uint32_t slot(int pos) {return (m_head + (uint32_t)pos) & (m_capacity - 1);}
 
-    camera_q_node m_head; // dummy head
+    void **m_ring;        // circular array of data ptrs, power of 2 sized
+    uint32_t m_capacity;
+    uint32_t m_head;      // slot of the first element
     int m_size;
     bool m_active;
     pthread_mutex_t m_lock;
     release_data_fn m_dataFn;
     void * m_userData;
+    bool m_bDataFnFrees;
+};
+
+typedef bool (*match_node_fn)(struct cam_list *node, void *match_data);
+typedef void (*release_node_fn)(struct cam_list *node, void *user_data);
+
+/* Queue of caller owned nodes linked through an embedded cam_list. It never
+ * allocates; the node must stay valid until it is dequeued or flushed. */
+class QCameraIntrusiveQueue {
+public:
+    QCameraIntrusiveQueue();
+    QCameraIntrusiveQueue(release_node_fn node_rel_fn, void *user_data);
+    virtual ~QCameraIntrusiveQueue();
+    void init();
+    bool enqueue(struct cam_list *node);
+    bool enqueueWithPriority(struct cam_list *node);
+    /* Same as QCameraQueue::flush, queue needs init() afterwards */
+    void flush();
+    void flushNodes(match_node_fn match, void *match_data);
+    struct cam_list *dequeue(bool bFromHead = true);
+    struct cam_list *dequeue(match_node_fn match, void *match_data);
+    bool isEmpty();
+    int getCurrentSize() {return m_size;}
+private:
+    struct cam_list m_head; // dummy head
+    int m_size;
+    bool m_active;
+    pthread_mutex_t m_lock;
+    release_node_fn m_nodeFn;
+    void *m_userData;
 };
 
 }; // namespace qcamera
@@ -0,0 +1,452 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#define LOG_TAG "QCameraSuperBufPool"
+
+// System dependencies
+#include <stdlib.h>
+#include <string.h>
+#include <utils/Errors.h>
+
+// Camera dependencies
+#include "QCameraSuperBufPool.h"
+
+extern "C" {
+#include "mm_camera_dbg.h"
+}
+
+using namespace android;
+
+namespace qcamera {
+
+#define POOL_INDEX_MASK 0xFFFFFFFFULL
+#define POOL_HEAD(tag, link) ((((uint64_t)(tag)) << 32) | (uint64_t)(link))
+
+/*===========================================================================
+ * FUNCTION   : getInstance
+ *
+ * DESCRIPTION: return the process wide pool. The pool is never destroyed so
+ *              descriptors released from late teardown paths stay valid.
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : pool instance
+ *==========================================================================*/
+QCameraSuperBufPool *QCameraSuperBufPool::getInstance()
+{
+    static QCameraSuperBufPool *sInstance = new QCameraSuperBufPool();
+    return sInstance;
+}
+
+/*===========================================================================
+ * FUNCTION   : QCameraSuperBufPool
+ *
+ * DESCRIPTION: constructor of QCameraSuperBufPool
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+QCameraSuperBufPool::QCameraSuperBufPool() :
+        m_numSlabs(0),
+        m_capacity(0),
+        m_reserved(0),
+        m_freeHead(0),
+        m_acquired(0),
+        m_recycled(0),
+        m_fallbackAllocs(0),
+        m_released(0),
+        m_outstanding(0)
+{
+    pthread_mutex_init(&m_growLock, NULL);
+    memset(m_slabs, 0, sizeof(m_slabs));
+    memset(m_nodeTable, 0, sizeof(m_nodeTable));
+}
+
+/*===========================================================================
+ * FUNCTION   : ~QCameraSuperBufPool
+ *
+ * DESCRIPTION: destructor of QCameraSuperBufPool
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+QCameraSuperBufPool::~QCameraSuperBufPool()
+{
+    uint32_t numSlabs = m_numSlabs.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < numSlabs; i++) {
+        delete [] m_slabs[i].nodes;
+    }
+    pthread_mutex_destroy(&m_growLock);
+}
+
+/*===========================================================================
+ * FUNCTION   : reserve
+ *
+ * DESCRIPTION: add to the number of descriptors streams expect to hold and
+ *              grow the pool to cover it. Capacity is never given back, so a
+ *              stream that is torn down and recreated reuses the same slabs.
+ *
+ * PARAMETERS :
+ *   @count   : number of descriptors to reserve, usually the stream's
+ *              buffer count
+ *
+ * RETURN     : int32_t type of status
+ *              NO_ERROR  -- success
+ *              NO_MEMORY -- pool could not grow, fallback allocations will
+ *                           cover the difference
+ *==========================================================================*/
+int32_t QCameraSuperBufPool::reserve(uint32_t count)
+{
+    int32_t rc = NO_ERROR;
+
+    pthread_mutex_lock(&m_growLock);
+    m_reserved += count;
+    uint32_t capacity = m_capacity.load(std::memory_order_relaxed);
+    if (m_reserved > capacity) {
+        rc = addSlab(m_reserved - capacity);
+    }
+    pthread_mutex_unlock(&m_growLock);
+
+    return rc;
+}
+
+/*===========================================================================
+ * FUNCTION   : unreserve
+ *
+ * DESCRIPTION: drop a reservation made with reserve()
+ *
+ * PARAMETERS :
+ *   @count   : number of descriptors previously reserved
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraSuperBufPool::unreserve(uint32_t count)
+{
+    pthread_mutex_lock(&m_growLock);
+    if (count > m_reserved) {
+        LOGW("Unbalanced unreserve %u, reserved %u", count, m_reserved);
+        count = m_reserved;
+    }
+    m_reserved -= count;
+    pthread_mutex_unlock(&m_growLock);
+}
+
+/*===========================================================================
+ * FUNCTION   : addSlab
+ *
+ * DESCRIPTION: allocate a new slab and push its nodes onto the freelist.
+ *              Must be called with m_growLock held.
+ *
+ * PARAMETERS :
+ *   @count   : minimum number of nodes needed
+ *
+ * RETURN     : int32_t type of status
+ *              NO_ERROR  -- success
+ *              NO_MEMORY -- out of slabs or memory
+ *==========================================================================*/
+int32_t QCameraSuperBufPool::addSlab(uint32_t count)
+{
+    uint32_t numSlabs = m_numSlabs.load(std::memory_order_relaxed);
+    uint32_t capacity = m_capacity.load(std::memory_order_relaxed);
+
+    if (count < QCAMERA_SUPER_BUF_POOL_MIN_SLAB) {
+        count = QCAMERA_SUPER_BUF_POOL_MIN_SLAB;
+    }
+    if (count > QCAMERA_SUPER_BUF_POOL_MAX_NODES - capacity) {
+        count = QCAMERA_SUPER_BUF_POOL_MAX_NODES - capacity;
+    }
+    if ((numSlabs >= QCAMERA_SUPER_BUF_POOL_MAX_SLABS) || (count == 0)) {
+        LOGW("Super buf pool is full, slabs %u capacity %u", numSlabs, capacity);
+        return NO_MEMORY;
+    }
+
+    pool_node_t *nodes = new pool_node_t[count];
+    if (nodes == NULL) {
+        LOGE("Failed to allocate %u super buf descriptors", count);
+        return NO_MEMORY;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        nodes[i].next.store(0, std::memory_order_relaxed);
+        m_nodeTable[capacity + i] = &nodes[i];
+    }
+
+    m_slabs[numSlabs].nodes = nodes;
+    m_slabs[numSlabs].base = capacity;
+    m_slabs[numSlabs].count = count;
+    m_numSlabs.store(numSlabs + 1, std::memory_order_release);
+    m_capacity.store(capacity + count, std::memory_order_release);
+
+    for (uint32_t i = 0; i < count; i++) {
+        pushFree(&nodes[i], capacity + i);
+    }
+
+    LOGD("Super buf pool grew by %u to %u", count, capacity + count);
+    return NO_ERROR;
+}
+
+/*===========================================================================
+ * FUNCTION   : popFree
+ *
+ * DESCRIPTION: take a node off the freelist. Nodes are never unmapped, so a
+ *              stale read of the next link is harmless and the tag in the
+ *              head rejects it.
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : free node or NULL if the freelist is empty
+ *==========================================================================*/
+QCameraSuperBufPool::pool_node_t *QCameraSuperBufPool::popFree()
+{
+    uint64_t head = m_freeHead.load(std::memory_order_acquire);
+    while ((head & POOL_INDEX_MASK) != 0) {
+        pool_node_t *node = m_nodeTable[(head & POOL_INDEX_MASK) - 1];
+        uint32_t next = node->next.load(std::memory_order_relaxed);
+        uint64_t newHead = POOL_HEAD((head >> 32) + 1, next);
+        if (m_freeHead.compare_exchange_weak(head, newHead,
+                std::memory_order_acquire, std::memory_order_acquire)) {
+            return node;
+        }
+    }
+    return NULL;
+}
+
+/*===========================================================================
+ * FUNCTION   : pushFree
+ *
+ * DESCRIPTION: return a node to the freelist
+ *
+ * PARAMETERS :
+ *   @node    : node to return
+ *   @index   : global index of the node
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraSuperBufPool::pushFree(pool_node_t *node, uint32_t index)
+{
+    uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+    uint64_t newHead;
+    do {
+        node->next.store((uint32_t)(head & POOL_INDEX_MASK),
+                std::memory_order_relaxed);
+        newHead = POOL_HEAD((head >> 32) + 1, index + 1);
+    } while (!m_freeHead.compare_exchange_weak(head, newHead,
+            std::memory_order_release, std::memory_order_relaxed));
+}
+
+/*===========================================================================
+ * FUNCTION   : lookup
+ *
+ * DESCRIPTION: map a descriptor address to its pool index
+ *
+ * PARAMETERS :
+ *   @buf     : descriptor address
+ *   @index   : [out] global node index, may be NULL
+ *
+ * RETURN     : true if the address is a pool descriptor
+ *==========================================================================*/
+bool QCameraSuperBufPool::lookup(const void *buf, uint32_t *index) const
+{
+    uintptr_t addr = (uintptr_t)buf;
+    uint32_t numSlabs = m_numSlabs.load(std::memory_order_acquire);
+
+    for (uint32_t i = 0; i < numSlabs; i++) {
+        uintptr_t start = (uintptr_t)m_slabs[i].nodes;
+        uintptr_t end = start + m_slabs[i].count * sizeof(pool_node_t);
+        if ((addr < start) || (addr >= end)) {
+            continue;
+        }
+        if (((addr - start) % sizeof(pool_node_t)) != 0) {
+            LOGE("Misaligned super buf %p in pool slab %u", buf, i);
+            return false;
+        }
+        if (index != NULL) {
+            *index = m_slabs[i].base +
+                    (uint32_t)((addr - start) / sizeof(pool_node_t));
+        }
+        return true;
+    }
+    return false;
+}
+
+/*===========================================================================
+ * FUNCTION   : owns
+ *
+ * DESCRIPTION: check whether a descriptor came from the pool slabs
+ *
+ * PARAMETERS :
+ *   @buf     : descriptor address
+ *
+ * RETURN     : true if the descriptor is owned by the pool
+ *==========================================================================*/
+bool QCameraSuperBufPool::owns(const void *buf) const
+{
+    return lookup(buf, NULL);
+}
+
+/*===========================================================================
+ * FUNCTION   : acquire
+ *
+ * DESCRIPTION: get a zeroed super buf descriptor. Falls back to malloc when
+ *              the freelist is empty.
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : descriptor, NULL on allocation failure
+ *==========================================================================*/
+mm_camera_super_buf_t *QCameraSuperBufPool::acquire()
+{
+    mm_camera_super_buf_t *buf = NULL;
+    pool_node_t *node = popFree();
+
+    if (node != NULL) {
+        buf = &node->buf;
+        m_recycled.fetch_add(1, std::memory_order_relaxed);
+        m_outstanding.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        buf = (mm_camera_super_buf_t *)malloc(sizeof(mm_camera_super_buf_t));
+        if (buf == NULL) {
+            LOGE("Failed to allocate super buf");
+            return NULL;
+        }
+        m_fallbackAllocs.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_acquired.fetch_add(1, std::memory_order_relaxed);
+    memset(buf, 0, sizeof(mm_camera_super_buf_t));
+    return buf;
+}
+
+/*===========================================================================
+ * FUNCTION   : copy
+ *
+ * DESCRIPTION: get a descriptor initialized from an existing super buf
+ *
+ * PARAMETERS :
+ *   @src     : super buf to copy
+ *
+ * RETURN     : descriptor, NULL on allocation failure
+ *==========================================================================*/
+mm_camera_super_buf_t *QCameraSuperBufPool::copy(const mm_camera_super_buf_t *src)
+{
+    mm_camera_super_buf_t *buf = acquire();
+    if ((buf != NULL) && (src != NULL)) {
+        *buf = *src;
+    }
+    return buf;
+}
+
+/*===========================================================================
+ * FUNCTION   : release
+ *
+ * DESCRIPTION: return a descriptor. Descriptors that did not come from the
+ *              pool are freed, so this is a drop-in for free().
+ *
+ * PARAMETERS :
+ *   @buf     : descriptor to release, may be NULL
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraSuperBufPool::release(void *buf)
+{
+    uint32_t index = 0;
+
+    if (buf == NULL) {
+        return;
+    }
+    if (!lookup(buf, &index)) {
+        free(buf);
+        return;
+    }
+    m_outstanding.fetch_sub(1, std::memory_order_relaxed);
+    m_released.fetch_add(1, std::memory_order_relaxed);
+    pushFree(m_nodeTable[index], index);
+}
+
+/*===========================================================================
+ * FUNCTION   : releaseNode
+ *
+ * DESCRIPTION: free function for queue nodes that may carry pool descriptors
+ *
+ * PARAMETERS :
+ *   @data      : node data
+ *   @user_data : unused
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraSuperBufPool::releaseNode(void *data, void * /*user_data*/)
+{
+    getInstance()->release(data);
+}
+
+/*===========================================================================
+ * FUNCTION   : getStats
+ *
+ * DESCRIPTION: snapshot of the pool counters
+ *
+ * PARAMETERS :
+ *   @stats   : [out] counters
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraSuperBufPool::getStats(qcamera_super_buf_pool_stats_t *stats) const
+{
+    if (stats == NULL) {
+        return;
+    }
+    stats->acquired = m_acquired.load(std::memory_order_relaxed);
+    stats->recycled = m_recycled.load(std::memory_order_relaxed);
+    stats->fallbackAllocs = m_fallbackAllocs.load(std::memory_order_relaxed);
+    stats->released = m_released.load(std::memory_order_relaxed);
+    stats->outstanding = m_outstanding.load(std::memory_order_relaxed);
+    stats->capacity = m_capacity.load(std::memory_order_acquire);
+    pthread_mutex_lock(const_cast<pthread_mutex_t *>(&m_growLock));
+    stats->reserved = m_reserved;
+    pthread_mutex_unlock(const_cast<pthread_mutex_t *>(&m_growLock));
+}
+
+/*===========================================================================
+ * FUNCTION   : resetStats
+ *
+ * DESCRIPTION: clear the event counters. Capacity, reservation and the
+ *              outstanding count are state and are left untouched.
+ *
+ * PARAMETERS : None
+ *
+ * RETURN     : None
+ *==========================================================================*/
+void QCameraSuperBufPool::resetStats()
+{
+    m_acquired.store(0, std::memory_order_relaxed);
+    m_recycled.store(0, std::memory_order_relaxed);
+    m_fallbackAllocs.store(0, std::memory_order_relaxed);
+    m_released.store(0, std::memory_order_relaxed);
+}
+
+}; // namespace qcamera
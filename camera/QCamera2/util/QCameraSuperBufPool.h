@@ -0,0 +1,155 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef __QCAMERA_SUPER_BUF_POOL_H__
+#define __QCAMERA_SUPER_BUF_POOL_H__
+
+// System dependencies
+#include <atomic>
+#include <pthread.h>
+#include <stdint.h>
+
+extern "C" {
+#include "mm_camera_interface.h"
+}
+
+namespace qcamera {
+
+#define QCAMERA_SUPER_BUF_POOL_MAX_SLABS 16
+#define QCAMERA_SUPER_BUF_POOL_MAX_NODES 2048
+#define QCAMERA_SUPER_BUF_POOL_MIN_SLAB  32
+
+typedef struct {
+    uint64_t acquired;      // descriptors handed out (pool + fallback)
+    uint64_t recycled;      // descriptors served from the freelist
+    uint64_t fallbackAllocs;// descriptors that had to be malloc'ed
+    uint64_t released;      // descriptors returned to the freelist
+    uint32_t outstanding;   // pool descriptors currently handed out
+    uint32_t capacity;      // pool descriptors allocated in slabs
+    uint32_t reserved;      // capacity currently requested by streams
+} qcamera_super_buf_pool_stats_t;
+
+/* Process wide pool of mm_camera_super_buf_t descriptors.
+ *
+ * Descriptors live in slabs that are never returned to the system, so
+ * the freelist is a lock-free index stack with an ABA tag. Streams call
+ * reserve()/unreserve() with their buffer counts; the pool grows to cover
+ * the reservation and falls back to malloc when it runs dry. release()
+ * accepts both pool and malloc'ed descriptors, which lets it replace
+ * free() at any site that frees a super buf. */
+class QCameraSuperBufPool {
+public:
+    static QCameraSuperBufPool *getInstance();
+
+    int32_t reserve(uint32_t count);
+    void unreserve(uint32_t count);
+
+    mm_camera_super_buf_t *acquire();
+    mm_camera_super_buf_t *copy(const mm_camera_super_buf_t *src);
+    void release(void *buf);
+    bool owns(const void *buf) const;
+
+    void getStats(qcamera_super_buf_pool_stats_t *stats) const;
+    void resetStats();
+
+    // release_data_fn compatible helper to free super buf queue nodes
+    static void releaseNode(void *data, void *user_data);
+
+private:
+    QCameraSuperBufPool();
+    ~QCameraSuperBufPool();
+    QCameraSuperBufPool(const QCameraSuperBufPool &);
+    QCameraSuperBufPool &operator=(const QCameraSuperBufPool &);
+
+    typedef struct {
+        mm_camera_super_buf_t buf;      // must stay first
+        std::atomic<uint32_t> next;     // freelist link, index + 1
+    } pool_node_t;
+
+    typedef struct {
+        pool_node_t *nodes;
+        uint32_t base;
+        uint32_t count;
+    } pool_slab_t;
+
+    int32_t addSlab(uint32_t count);
+    pool_node_t *popFree();
+    void pushFree(pool_node_t *node, uint32_t index);
+    bool lookup(const void *buf, uint32_t *index) const;
+
+    pthread_mutex_t m_growLock;
+    pool_slab_t m_slabs[QCAMERA_SUPER_BUF_POOL_MAX_SLABS];
+    pool_node_t *m_nodeTable[QCAMERA_SUPER_BUF_POOL_MAX_NODES];
+    std::atomic<uint32_t> m_numSlabs;
+    std::atomic<uint32_t> m_capacity;
+    uint32_t m_reserved;
+    std::atomic<uint64_t> m_freeHead;   // (tag << 32) | (index + 1)
+
+    std::atomic<uint64_t> m_acquired;
+    std::atomic<uint64_t> m_recycled;
+    std::atomic<uint64_t> m_fallbackAllocs;
+    std::atomic<uint64_t> m_released;
+    std::atomic<uint32_t> m_outstanding;
+};
+
+/* Scoped owner of a super buf descriptor. The descriptor goes back to the
+ * pool when the handle is destroyed unless detach() hands it off first. */
+class QCameraSuperBufHandle {
+public:
+    QCameraSuperBufHandle() : m_buf(NULL) {}
+    explicit QCameraSuperBufHandle(mm_camera_super_buf_t *buf) : m_buf(buf) {}
+    ~QCameraSuperBufHandle() { reset(NULL); }
+
+    mm_camera_super_buf_t *get() const { return m_buf; }
+    mm_camera_super_buf_t *operator->() const { return m_buf; }
+    bool isValid() const { return (m_buf != NULL); }
+    mm_camera_super_buf_t *detach()
+    {
+        mm_camera_super_buf_t *buf = m_buf;
+        m_buf = NULL;
+        return buf;
+    }
+    void reset(mm_camera_super_buf_t *buf)
+    {
+        if ((m_buf != NULL) && (m_buf != buf)) {
+            QCameraSuperBufPool::getInstance()->release(m_buf);
+        }
+        m_buf = buf;
+    }
+
+private:
+    QCameraSuperBufHandle(const QCameraSuperBufHandle &);
+    QCameraSuperBufHandle &operator=(const QCameraSuperBufHandle &);
+
+    mm_camera_super_buf_t *m_buf;
+};
+
+}; // namespace qcamera
+
+#endif /* __QCAMERA_SUPER_BUF_POOL_H__ */
@@ -27,155 +27,478 @@
 *
 */
 
+// System dependencies
+#include <errno.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <atomic>
+
 // Camera dependencies
 #include "QCameraTrace.h"
-#include <string.h>
-#define CAMSCOPE_MEMSTORE_SIZE 0x00100000 // 1MB
+
+// Per thread ring of packets not yet picked up by the flusher, must be a
+// power of 2
+#define CAMSCOPE_RING_SIZE 0x00008000 // 32KB
+// Per section chunk the flusher collects packets in before writing them
+#define CAMSCOPE_CHUNK_SIZE 0x00040000 // 256KB
+// Flusher wakeup period while any section is open
+#define CAMSCOPE_FLUSH_INTERVAL_MS 20
+#define CAMSCOPE_MAX_PACKET_SIZE 0xFFFF
+#define CAMSCOPE_PATH_MAX 256
 
 volatile uint32_t kpi_camscope_flags = 0;
 volatile uint32_t kpi_camscope_frame_count = 0;
 
-static const char * camscope_filenames[CAMSCOPE_SECTION_SIZE] = {
+static char camscope_filenames[CAMSCOPE_SECTION_SIZE][CAMSCOPE_PATH_MAX] = {
     QCAMERA_DUMP_FRM_LOCATION"camscope_mmcamera.bin",
     QCAMERA_DUMP_FRM_LOCATION"camscope_hal.bin",
     QCAMERA_DUMP_FRM_LOCATION"camscope_jpeg.bin"
 };
 
+typedef enum {
+    CAMSCOPE_RING_LIVE,     // owned by a logging thread
+    CAMSCOPE_RING_EXITED,   // owner exited, flusher still has to drain it
+    CAMSCOPE_RING_FREE,     // drained, can be taken over by a new thread
+} camscope_ring_state;
+
+/* Single producer single consumer ring of one logging thread. Each packet
+ * is stored behind a 32 bit header of (section << 16) | size. */
+typedef struct camscope_ring {
+    std::atomic<uint32_t> head;     // advanced by the owning thread
+    std::atomic<uint32_t> tail;     // advanced by the flusher
+    std::atomic<uint32_t> state;
+    struct camscope_ring *next;     // registry link, never changes
+    char data[CAMSCOPE_RING_SIZE];
+} camscope_ring;
+
+/* Rings of all threads that ever logged; rings are recycled, never freed */
+static std::atomic<camscope_ring *> camscope_rings(NULL);
+static pthread_key_t camscope_ring_key;
+static pthread_once_t camscope_ring_key_once = PTHREAD_ONCE_INIT;
+
+/* Read without a lock by the logging threads */
+static std::atomic<uint32_t> camscope_enabled[CAMSCOPE_SECTION_SIZE];
+static std::atomic<uint32_t> camscope_dropped[CAMSCOPE_SECTION_SIZE];
+
+/* Requests to the flusher, protected by camscope_ctl_lock */
+static pthread_mutex_t camscope_ctl_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t camscope_ctl_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t camscope_open_req;
+static uint32_t camscope_close_req;
+static uint32_t camscope_close_pending;
+static bool camscope_flusher_started;
+static sem_t camscope_flusher_sem;
+
+/* Owned by the flusher thread */
 static FILE * camscope_fd[CAMSCOPE_SECTION_SIZE];
-static uint32_t camscope_num_bytes_stored[CAMSCOPE_SECTION_SIZE];
-static char * camscope_memstore[CAMSCOPE_SECTION_SIZE];
-static pthread_mutex_t camscope_mutex[CAMSCOPE_SECTION_SIZE];
+static char * camscope_chunk[CAMSCOPE_SECTION_SIZE];
+static uint32_t camscope_chunk_len[CAMSCOPE_SECTION_SIZE];
 
-/* camscope_init:
+/* camscope_ring_exit:
  *
- *  @camscope_section: camscope section where this function is occurring
+ *  @data: ring of the exiting thread
  *
- *  Initializes the CameraScope tool functionality
+ *  Thread exit hook handing the ring of the thread back to the flusher
  *
  *  Return: N/A
  */
-void camscope_init(camscope_section_type camscope_section) {
-    pthread_mutex_init(&(camscope_mutex[camscope_section]), NULL);
-    if (camscope_fd[camscope_section] == NULL) {
-        if(camscope_memstore[camscope_section] == NULL) {
-            camscope_memstore[camscope_section] =
-                (char *)malloc(CAMSCOPE_MEMSTORE_SIZE);
-            if (camscope_memstore[camscope_section] == NULL) {
-              CLOGE(CAM_NO_MODULE, "Failed to allocate camscope memstore"
-                    "with size %d\n", CAMSCOPE_MEMSTORE_SIZE);
-            }
+static void camscope_ring_exit(void *data) {
+    camscope_ring *ring = (camscope_ring *)data;
+    ring->state.store(CAMSCOPE_RING_EXITED, std::memory_order_release);
+}
+
+/* camscope_ring_key_init:
+ *
+ *  Creates the thread specific key holding the ring of each thread
+ *
+ *  Return: N/A
+ */
+static void camscope_ring_key_init() {
+    pthread_key_create(&camscope_ring_key, camscope_ring_exit);
+}
+
+/* camscope_get_ring:
+ *
+ *  Returns the ring of the calling thread, taking over a drained ring of an
+ *  exited thread or allocating a new one on the first packet of a thread
+ *
+ *  Return: ring of the calling thread, NULL if out of memory
+ */
+static camscope_ring *camscope_get_ring() {
+    pthread_once(&camscope_ring_key_once, camscope_ring_key_init);
+    camscope_ring *ring = (camscope_ring *)pthread_getspecific(camscope_ring_key);
+    if (ring != NULL) {
+        return ring;
+    }
+
+    for (ring = camscope_rings.load(std::memory_order_acquire); ring != NULL;
+            ring = ring->next) {
+        uint32_t state = CAMSCOPE_RING_FREE;
+        if (ring->state.compare_exchange_strong(state, CAMSCOPE_RING_LIVE,
+                std::memory_order_acquire)) {
+            break;
         }
-        camscope_fd[camscope_section] =
-            fopen(camscope_filenames[camscope_section], "ab");
+    }
+    if (ring == NULL) {
+        ring = (camscope_ring *)malloc(sizeof(camscope_ring));
+        if (ring == NULL) {
+            return NULL;
+        }
+        ring->head.store(0, std::memory_order_relaxed);
+        ring->tail.store(0, std::memory_order_relaxed);
+        ring->state.store(CAMSCOPE_RING_LIVE, std::memory_order_relaxed);
+        ring->next = camscope_rings.load(std::memory_order_relaxed);
+        while (!camscope_rings.compare_exchange_weak(ring->next, ring,
+                std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+    pthread_setspecific(camscope_ring_key, ring);
+    return ring;
+}
+
+/* camscope_ring_copy_out:
+ *
+ *  @ring: ring to read from
+ *  @pos:  ring position to start at
+ *  @dst:  destination buffer
+ *  @size: number of bytes to copy
+ *
+ *  Copies bytes out of a ring, wrapping around its end
+ *
+ *  Return: N/A
+ */
+static void camscope_ring_copy_out(const camscope_ring *ring, uint32_t pos,
+                                   void *dst, uint32_t size) {
+    uint32_t off = pos & (CAMSCOPE_RING_SIZE - 1);
+    uint32_t first = CAMSCOPE_RING_SIZE - off;
+    if (first >= size) {
+        memcpy(dst, ring->data + off, size);
+    } else {
+        memcpy(dst, ring->data + off, first);
+        memcpy((char *)dst + first, ring->data, size - first);
+    }
+}
+
+/* camscope_ring_copy_in:
+ *
+ *  @ring: ring to write to
+ *  @pos:  ring position to start at
+ *  @src:  source buffer
+ *  @size: number of bytes to copy
+ *
+ *  Copies bytes into a ring, wrapping around its end
+ *
+ *  Return: N/A
+ */
+static void camscope_ring_copy_in(camscope_ring *ring, uint32_t pos,
+                                  const void *src, uint32_t size) {
+    uint32_t off = pos & (CAMSCOPE_RING_SIZE - 1);
+    uint32_t first = CAMSCOPE_RING_SIZE - off;
+    if (first >= size) {
+        memcpy(ring->data + off, src, size);
+    } else {
+        memcpy(ring->data + off, src, first);
+        memcpy(ring->data, (const char *)src + first, size - first);
     }
 }
 
-/* camscope_flush:
+/* camscope_write_chunk:
  *
  *  @camscope_section: camscope section where this function is occurring
  *
- *  Flushes the camscope memstore to the file system
+ *  Writes the collected chunk of a section to its file. Flusher only.
  *
  *  Return: N/A
  */
-static void camscope_flush(camscope_section_type camscope_section) {
+static void camscope_write_chunk(uint32_t camscope_section) {
     if (camscope_fd[camscope_section] != NULL &&
-        camscope_memstore[camscope_section] != NULL) {
-        fwrite(camscope_memstore[camscope_section], sizeof(char),
-               camscope_num_bytes_stored[camscope_section],
+        camscope_chunk_len[camscope_section] != 0) {
+        fwrite(camscope_chunk[camscope_section], sizeof(char),
+               camscope_chunk_len[camscope_section],
                camscope_fd[camscope_section]);
-        camscope_num_bytes_stored[camscope_section] = 0;
     }
+    camscope_chunk_len[camscope_section] = 0;
 }
 
-/* camscope_destroy:
+/* camscope_drain:
+ *
+ *  Moves the packets of all thread rings into the chunks of their sections,
+ *  writing out chunks as they fill up. Flusher only.
+ *
+ *  Return: N/A
+ */
+static void camscope_drain() {
+    for (camscope_ring *ring = camscope_rings.load(std::memory_order_acquire);
+            ring != NULL; ring = ring->next) {
+        uint32_t state = ring->state.load(std::memory_order_acquire);
+        if (state == CAMSCOPE_RING_FREE) {
+            continue;
+        }
+        uint32_t head = ring->head.load(std::memory_order_acquire);
+        uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+        while (tail != head) {
+            uint32_t hdr;
+            camscope_ring_copy_out(ring, tail, &hdr, sizeof(hdr));
+            uint32_t section = hdr >> 16;
+            uint32_t size = hdr & CAMSCOPE_MAX_PACKET_SIZE;
+            tail += sizeof(hdr);
+            if (section < CAMSCOPE_SECTION_SIZE &&
+                camscope_chunk[section] != NULL) {
+                if (camscope_chunk_len[section] + size > CAMSCOPE_CHUNK_SIZE) {
+                    camscope_write_chunk(section);
+                }
+                camscope_ring_copy_out(ring, tail,
+                    camscope_chunk[section] + camscope_chunk_len[section], size);
+                camscope_chunk_len[section] += size;
+            } else if (section < CAMSCOPE_SECTION_SIZE) {
+                camscope_dropped[section].fetch_add(1, std::memory_order_relaxed);
+            }
+            tail += size;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+        if (state == CAMSCOPE_RING_EXITED) {
+            ring->state.store(CAMSCOPE_RING_FREE, std::memory_order_release);
+        }
+    }
+}
+
+/* camscope_open_section:
  *
  *  @camscope_section: camscope section where this function is occurring
  *
- *  Flushes any remaining data to the file system and cleans up CameraScope
+ *  Opens the file and chunk of a section. Flusher only.
  *
  *  Return: N/A
  */
-void camscope_destroy(camscope_section_type camscope_section) {
-    if (camscope_fd[camscope_section] != NULL) {
-        pthread_mutex_lock(&(camscope_mutex[camscope_section]));
-        if(camscope_memstore[camscope_section] != NULL) {
-            camscope_flush(camscope_section);
-            free(camscope_memstore[camscope_section]);
-            camscope_memstore[camscope_section] = NULL;
+static void camscope_open_section(uint32_t camscope_section) {
+    if (camscope_chunk[camscope_section] == NULL) {
+        camscope_chunk[camscope_section] = (char *)malloc(CAMSCOPE_CHUNK_SIZE);
+        if (camscope_chunk[camscope_section] == NULL) {
+            CLOGE(CAM_NO_MODULE, "Failed to allocate camscope chunk"
+                  "with size %d\n", CAMSCOPE_CHUNK_SIZE);
+            return;
         }
+    }
+    camscope_chunk_len[camscope_section] = 0;
+    if (camscope_fd[camscope_section] == NULL) {
+        camscope_fd[camscope_section] =
+            fopen(camscope_filenames[camscope_section], "ab");
+    }
+}
+
+/* camscope_close_section:
+ *
+ *  @camscope_section: camscope section where this function is occurring
+ *
+ *  Writes the remaining chunk of a section and closes its file. Flusher only.
+ *
+ *  Return: N/A
+ */
+static void camscope_close_section(uint32_t camscope_section) {
+    camscope_write_chunk(camscope_section);
+    free(camscope_chunk[camscope_section]);
+    camscope_chunk[camscope_section] = NULL;
+    if (camscope_fd[camscope_section] != NULL) {
         fclose(camscope_fd[camscope_section]);
         camscope_fd[camscope_section] = NULL;
-        pthread_mutex_unlock(&(camscope_mutex[camscope_section]));
     }
-    pthread_mutex_destroy(&(camscope_mutex[camscope_section]));
+    uint32_t dropped = camscope_dropped[camscope_section].load(
+        std::memory_order_relaxed);
+    if (dropped != 0) {
+        CLOGW(CAM_NO_MODULE, "camscope section %d dropped %u packets",
+              camscope_section, dropped);
+    }
 }
 
-/* camscope_reserve:
+/* camscope_flusher:
  *
- *  @camscope_section:     camscope section where this function is occurring
- *  @num_bytes_to_reserve: number in bytes to reserve on the memstore
+ *  @data: unused
  *
- *  Reserves a number of bytes on the memstore flushing to the
- *  file system if remaining space is insufficient
+ *  Background thread collecting the packets of all logging threads and
+ *  doing all file I/O, so logging never waits on the file system
  *
- *  Return: number of bytes successfully reserved on the memstore
+ *  Return: N/A
  */
-uint32_t camscope_reserve(camscope_section_type camscope_section,
-                                 uint32_t num_bytes_to_reserve) {
-    uint32_t bytes_reserved = 0;
-    if (camscope_fd[camscope_section] != NULL &&
-        num_bytes_to_reserve <= CAMSCOPE_MEMSTORE_SIZE) {
-        int32_t size = CAMSCOPE_MEMSTORE_SIZE -
-               camscope_num_bytes_stored[camscope_section] -
-               num_bytes_to_reserve;
-        if (size < 0) {
-            camscope_flush(camscope_section);
+static void *camscope_flusher(void *data __attribute__((unused))) {
+    uint32_t opened = 0;
+    for (;;) {
+        if (opened != 0) {
+            struct timespec ts;
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += CAMSCOPE_FLUSH_INTERVAL_MS * 1000000L;
+            if (ts.tv_nsec >= 1000000000L) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000L;
+            }
+            while (sem_timedwait(&camscope_flusher_sem, &ts) != 0 &&
+                   errno == EINTR) {
+            }
+        } else {
+            while (sem_wait(&camscope_flusher_sem) != 0 && errno == EINTR) {
+            }
+        }
+
+        pthread_mutex_lock(&camscope_ctl_lock);
+        uint32_t opens = camscope_open_req;
+        uint32_t closes = camscope_close_req;
+        camscope_open_req = 0;
+        camscope_close_req = 0;
+        pthread_mutex_unlock(&camscope_ctl_lock);
+
+        // A section closed and reopened in one go is reopened after the
+        // packets of its old session went to the old file
+        for (uint32_t i = 0; i < CAMSCOPE_SECTION_SIZE; i++) {
+            if ((opens & ~closes) & (1U << i)) {
+                camscope_open_section(i);
+            }
+        }
+        camscope_drain();
+        for (uint32_t i = 0; i < CAMSCOPE_SECTION_SIZE; i++) {
+            if (closes & (1U << i)) {
+                camscope_close_section(i);
+                if (opens & (1U << i)) {
+                    camscope_open_section(i);
+                }
+            }
+        }
+        opened = (opened | opens) & ~(closes & ~opens);
+
+        if (closes != 0) {
+            pthread_mutex_lock(&camscope_ctl_lock);
+            camscope_close_pending &= ~closes;
+            pthread_cond_broadcast(&camscope_ctl_cond);
+            pthread_mutex_unlock(&camscope_ctl_lock);
         }
-        bytes_reserved = num_bytes_to_reserve;
     }
-    return bytes_reserved;
+    return NULL;
 }
 
-/* camscope_store_data:
+/* camscope_set_file:
  *
  *  @camscope_section: camscope section where this function is occurring
- *  @data:             data to be stored
- *  @size:             size of data to be stored
+ *  @path:             file to append the packets of the section to
  *
- *  Store the data to the memstore and calculate remaining space
+ *  Overrides the default file of a section, takes effect on the next
+ *  camscope_init of the section
  *
  *  Return: N/A
  */
-void camscope_store_data(camscope_section_type camscope_section,
-                       void* data, uint32_t size) {
-    if(camscope_memstore[camscope_section] != NULL) {
-        memcpy(camscope_memstore[camscope_section] +
-               camscope_num_bytes_stored[camscope_section], (char*)data, size);
-        camscope_num_bytes_stored[camscope_section] += size;
-    }
+void camscope_set_file(camscope_section_type camscope_section,
+                       const char *path) {
+    pthread_mutex_lock(&camscope_ctl_lock);
+    snprintf(camscope_filenames[camscope_section], CAMSCOPE_PATH_MAX, "%s", path);
+    pthread_mutex_unlock(&camscope_ctl_lock);
 }
 
-/* camscope_mutex_lock:
+/* camscope_init:
  *
  *  @camscope_section: camscope section where this function is occurring
  *
- *  Lock the camscope mutex lock for the given camscope section
+ *  Initializes the CameraScope tool functionality
  *
  *  Return: N/A
  */
-void camscope_mutex_lock(camscope_section_type camscope_section) {
-    pthread_mutex_lock(&(camscope_mutex[camscope_section]));
+void camscope_init(camscope_section_type camscope_section) {
+    pthread_mutex_lock(&camscope_ctl_lock);
+    if (!camscope_flusher_started) {
+        pthread_t tid;
+        pthread_attr_t attr;
+        sem_init(&camscope_flusher_sem, 0, 0);
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        if (pthread_create(&tid, &attr, camscope_flusher, NULL) != 0) {
+            CLOGE(CAM_NO_MODULE, "Failed to start camscope flusher");
+            pthread_attr_destroy(&attr);
+            pthread_mutex_unlock(&camscope_ctl_lock);
+            return;
+        }
+        pthread_setname_np(tid, "CAM_camscope");
+        pthread_attr_destroy(&attr);
+        camscope_flusher_started = true;
+    }
+    if (!camscope_enabled[camscope_section].load(std::memory_order_relaxed)) {
+        camscope_dropped[camscope_section].store(0, std::memory_order_relaxed);
+        camscope_open_req |= 1U << camscope_section;
+        camscope_enabled[camscope_section].store(1, std::memory_order_release);
+        sem_post(&camscope_flusher_sem);
+    }
+    pthread_mutex_unlock(&camscope_ctl_lock);
 }
 
-/* camscope_mutex_unlock:
+/* camscope_destroy:
  *
  *  @camscope_section: camscope section where this function is occurring
  *
- *  Unlock the camscope mutex lock for the given camscope section
+ *  Flushes any remaining data to the file system and cleans up CameraScope.
+ *  Waits for the flusher to close the file of the section.
  *
  *  Return: N/A
  */
-void camscope_mutex_unlock(camscope_section_type camscope_section) {
-    pthread_mutex_unlock(&(camscope_mutex[camscope_section]));
+void camscope_destroy(camscope_section_type camscope_section) {
+    pthread_mutex_lock(&camscope_ctl_lock);
+    if (camscope_enabled[camscope_section].load(std::memory_order_relaxed)) {
+        camscope_enabled[camscope_section].store(0, std::memory_order_relaxed);
+        camscope_close_req |= 1U << camscope_section;
+        camscope_close_pending |= 1U << camscope_section;
+        sem_post(&camscope_flusher_sem);
+        while (camscope_close_pending & (1U << camscope_section)) {
+            pthread_cond_wait(&camscope_ctl_cond, &camscope_ctl_lock);
+        }
+    }
+    pthread_mutex_unlock(&camscope_ctl_lock);
+}
+
+/* camscope_store_packet:
+ *
+ *  @camscope_section: camscope section where this function is occurring
+ *  @data:             packet to be stored
+ *  @size:             size of the packet
+ *
+ *  Queues a packet on the ring of the calling thread for the flusher. Never
+ *  blocks: when the ring is full the packet is dropped and counted.
+ *
+ *  Return: number of bytes stored, 0 if the packet was not stored
+ */
+uint32_t camscope_store_packet(camscope_section_type camscope_section,
+                               const void *data, uint32_t size) {
+    if ((uint32_t)camscope_section >= CAMSCOPE_SECTION_SIZE ||
+        !camscope_enabled[camscope_section].load(std::memory_order_acquire) ||
+        size > CAMSCOPE_MAX_PACKET_SIZE) {
+        return 0;
+    }
+    camscope_ring *ring = camscope_get_ring();
+    uint32_t hdr = ((uint32_t)camscope_section << 16) | size;
+    uint32_t need = sizeof(hdr) + size;
+    if (ring == NULL) {
+        camscope_dropped[camscope_section].fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    uint32_t used = head - ring->tail.load(std::memory_order_acquire);
+    if (CAMSCOPE_RING_SIZE - used < need) {
+        camscope_dropped[camscope_section].fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+    camscope_ring_copy_in(ring, head, &hdr, sizeof(hdr));
+    camscope_ring_copy_in(ring, head + sizeof(hdr), data, size);
+    ring->head.store(head + need, std::memory_order_release);
+    if (used < CAMSCOPE_RING_SIZE / 2 && used + need >= CAMSCOPE_RING_SIZE / 2) {
+        // wake the flusher early rather than dropping
+        sem_post(&camscope_flusher_sem);
+    }
+    return size;
+}
+
+/* camscope_get_dropped:
+ *
+ *  @camscope_section: camscope section where this function is occurring
+ *
+ *  Number of packets of the section dropped since its camscope_init
+ *
+ *  Return: dropped packet count
+ */
+uint32_t camscope_get_dropped(camscope_section_type camscope_section) {
+    return camscope_dropped[camscope_section].load(std::memory_order_relaxed);
 }
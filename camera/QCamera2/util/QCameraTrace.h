@@ -109,20 +109,17 @@ void camscope_init(camscope_section_type camscope_section);
 /* Cleans up CameraScope tool */
 void camscope_destroy(camscope_section_type camscope_section);
 
-/* Reserves a number of bytes on the memstore flushing to the
- * file system if remaining space is insufficient */
-uint32_t camscope_reserve(camscope_section_type camscope_section,
-                                 uint32_t num_bytes_to_reserve);
+/* Overrides the file a section is written to, before camscope_init */
+void camscope_set_file(camscope_section_type camscope_section,
+                       const char *path);
 
-/* Store the data to the memstore and calculate remaining space */
-void camscope_store_data(camscope_section_type camscope_section,
-                       void* data, uint32_t size);
+/* Queues a packet for the flusher thread, dropping it instead of
+ * blocking when the queue of the calling thread is full */
+uint32_t camscope_store_packet(camscope_section_type camscope_section,
+                               const void *data, uint32_t size);
 
-/* Lock the camscope mutex lock for the given camscope section */
-void camscope_mutex_lock(camscope_section_type camscope_section);
-
-/* Unlock the camscope mutex lock for the given camscope section */
-void camscope_mutex_unlock(camscope_section_type camscope_section);
+/* Number of packets dropped since the section was initialized */
+uint32_t camscope_get_dropped(camscope_section_type camscope_section);
 
 #define CAMSCOPE_SYSTRACE_TIME_MARKER() { \
     if (kpi_camscope_frame_count != 0) { \
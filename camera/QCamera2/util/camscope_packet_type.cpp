@@ -338,17 +338,11 @@ void camscope_base_log(uint32_t camscope_section,
         if (kpi_camscope_flags & camscope_enable_mask) {
             struct timeval timestamp;
             gettimeofday(&timestamp, NULL);
-            camscope_mutex_lock((camscope_section_type)camscope_section);
             camscope_base scope_struct;
             uint32_t size = sizeof(scope_struct);
-            uint32_t total_size =
-              camscope_reserve((camscope_section_type)camscope_section, size);
-            if (size == total_size) {
-                fill_camscope_base(&scope_struct, packet_type, size);
-                camscope_store_data((camscope_section_type)camscope_section,
-                                    &scope_struct, size);
-            }
-            camscope_mutex_unlock((camscope_section_type)camscope_section);
+            fill_camscope_base(&scope_struct, packet_type, size);
+            camscope_store_packet((camscope_section_type)camscope_section,
+                                  &scope_struct, size);
         }
     }
 }
@@ -374,19 +368,13 @@ void camscope_sw_base_log(uint32_t camscope_section,
         if (kpi_camscope_flags & camscope_enable_mask) {
             struct timeval timestamp;
             gettimeofday(&timestamp, NULL);
-            camscope_mutex_lock((camscope_section_type)camscope_section);
             camscope_sw_base scope_struct;
             uint32_t size = sizeof(scope_struct);
             int32_t thread_id = (int32_t)get_thread_id();
-            uint32_t total_size =
-              camscope_reserve((camscope_section_type)camscope_section, size);
-            if (size == total_size) {
-                fill_camscope_sw_base(&scope_struct, packet_type, size,
-                                      timestamp, thread_id, event_name);
-                camscope_store_data((camscope_section_type)camscope_section,
-                                    &scope_struct, size);
-            }
-            camscope_mutex_unlock((camscope_section_type)camscope_section);
+            fill_camscope_sw_base(&scope_struct, packet_type, size,
+                                  timestamp, thread_id, event_name);
+            camscope_store_packet((camscope_section_type)camscope_section,
+                                  &scope_struct, size);
         }
     }
 }
@@ -414,20 +402,14 @@ void camscope_timing_log(uint32_t camscope_section,
         if (kpi_camscope_flags & camscope_enable_mask) {
             struct timeval timestamp;
             gettimeofday(&timestamp, NULL);
-            camscope_mutex_lock((camscope_section_type)camscope_section);
             camscope_timing scope_struct;
             uint32_t size = sizeof(scope_struct);
             int32_t thread_id = (int32_t)get_thread_id();
-            uint32_t total_size =
-              camscope_reserve((camscope_section_type)camscope_section, size);
-            if (size == total_size) {
-                fill_camscope_timing(&scope_struct, packet_type, size,
-                                     timestamp, thread_id, event_name,
-                                     frame_id);
-                camscope_store_data((camscope_section_type)camscope_section,
-                                    &scope_struct, size);
-            }
-            camscope_mutex_unlock((camscope_section_type)camscope_section);
+            fill_camscope_timing(&scope_struct, packet_type, size,
+                                 timestamp, thread_id, event_name,
+                                 frame_id);
+            camscope_store_packet((camscope_section_type)camscope_section,
+                                  &scope_struct, size);
         }
     }
 }
@@ -457,21 +439,15 @@ void camscope_in_out_timing_log(uint32_t camscope_section,
         if (kpi_camscope_flags & camscope_enable_mask) {
             struct timeval timestamp;
             gettimeofday(&timestamp, NULL);
-            camscope_mutex_lock((camscope_section_type)camscope_section);
             camscope_in_out_timing scope_struct;
             uint32_t size = sizeof(scope_struct);
             int32_t thread_id = (int32_t)get_thread_id();
-            uint32_t total_size =
-              camscope_reserve((camscope_section_type)camscope_section, size);
-            if (size == total_size) {
-                fill_camscope_in_out_timing(&scope_struct, packet_type, size,
-                                            timestamp, thread_id, event_name,
-                                            in_timestamp, out_timestamp,
-                                            frame_id);
-                camscope_store_data((camscope_section_type)camscope_section,
-                                    &scope_struct, size);
-            }
-            camscope_mutex_unlock((camscope_section_type)camscope_section);
+            fill_camscope_in_out_timing(&scope_struct, packet_type, size,
+                                        timestamp, thread_id, event_name,
+                                        in_timestamp, out_timestamp,
+                                        frame_id);
+            camscope_store_packet((camscope_section_type)camscope_section,
+                                  &scope_struct, size);
         }
     }
 }
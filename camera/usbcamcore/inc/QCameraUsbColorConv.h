@@ -0,0 +1,71 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __QCAMERA_USB_COLOR_CONV_H
+#define __QCAMERA_USB_COLOR_CONV_H
+
+/* Maximum number of row stripes a conversion is split into */
+#define USB_CAM_CONV_MAX_THREADS    4
+
+/* Smallest frame, in pixels, worth handing stripes to the worker threads */
+#define USB_CAM_CONV_STRIPE_MIN_PIXELS  (1920 * 1080)
+
+/******************************************************************************
+ * Starts numThreads - 1 worker threads that convert row stripes of frames
+ * along with the calling thread. They wait for frames until
+ * usbCamConvDestroy. *conv is set to NULL when numThreads is 1 or less, or
+ * no worker could be started: conversions then run on the calling thread.
+ *
+ * Frames smaller than minPixels are converted on the calling thread only.
+ *
+ * Returns 0 on success, -1 on invalid arguments or no memory.
+ *****************************************************************************/
+int usbCamConvInit(void **conv, int numThreads, int minPixels);
+
+/******************************************************************************
+ * Stops and joins the worker threads started by usbCamConvInit. conv may be
+ * NULL.
+ *
+ * Returns 0.
+ *****************************************************************************/
+int usbCamConvDestroy(void *conv);
+
+/******************************************************************************
+ * Converts a packed YUYV frame to 4:2:0 semi planar with VU order
+ * (HAL_PIXEL_FORMAT_YCrCb_420_SP). Chroma is taken from the even rows.
+ * Output and input must not overlap. wd must be even.
+ *
+ * conv is the worker pool from usbCamConvInit, NULL to convert on the
+ * calling thread. Calls sharing a pool are serialized.
+ *
+ * Returns 0 on success, -1 on invalid arguments.
+ *****************************************************************************/
+int usbCamConvertYUYVto420SP(void *conv, const char *inBuf, char *outBuf,
+                             int wd, int ht);
+
+#endif /* __QCAMERA_USB_COLOR_CONV_H */
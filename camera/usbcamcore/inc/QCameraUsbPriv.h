@@ -166,6 +166,9 @@ typedef struct {
     int                                 dispWidth;
     int                                 dispHeight;
 
+    /* Worker threads of the YUYV to 420 SP conversion, NULL if none */
+    void*                               conv;
+
     /* MJPEG decoder related members */
     /* MJPEG decoder object */
     void*                               mjpegd;
@@ -0,0 +1,395 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//#define ALOG_NDEBUG 0
+#define ALOG_NIDEBUG 0
+#define LOG_TAG "QCameraUsbColorConv"
+#include <utils/Log.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define USB_CAM_CONV_NEON
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define USB_CAM_CONV_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define USB_CAM_CONV_SSE2
+#endif
+
+#include "QCameraUsbColorConv.h"
+
+/* Work for one row stripe */
+typedef struct {
+    const uint8_t   *in;
+    uint8_t         *out;
+    int             wd;
+    int             ht;
+    int             rowStart;
+    int             rowEnd;
+} convStripe_t;
+
+struct convPool;
+
+/* Start argument of a worker thread */
+typedef struct {
+    struct convPool *pool;
+    int             index;          /* stripe converted by the thread */
+} convWorker_t;
+
+/* Worker threads converting stripes 1..numWorkers, the caller takes 0 */
+typedef struct convPool {
+    pthread_mutex_t frameLock;      /* serializes frames */
+    pthread_mutex_t lock;           /* protects the members below */
+    pthread_cond_t  workCond;       /* a frame was posted, or exit */
+    pthread_cond_t  doneCond;       /* pending reached 0 */
+    unsigned int    frameSeq;       /* bumped for each posted frame */
+    int             pending;        /* workers still on the posted frame */
+    int             exit;
+    int             numWorkers;
+    int             minPixels;
+    pthread_t       threads[USB_CAM_CONV_MAX_THREADS - 1];
+    convWorker_t    workers[USB_CAM_CONV_MAX_THREADS - 1];
+    convStripe_t    stripes[USB_CAM_CONV_MAX_THREADS];
+} convPool_t;
+
+/******************************************************************************
+ * Function: yuyvRowToY
+ * Description: Extracts the luma of one YUYV row (every even byte)
+ *
+ * Input parameters:
+ *   in                  - YUYV row, 2 * wd bytes
+ *   y                   - luma output, wd bytes
+ *   wd                  - row width in pixels
+ *
+ * Return values: none
+ *****************************************************************************/
+static void yuyvRowToY(const uint8_t *in, uint8_t *y, int wd)
+{
+    int x = 0;
+
+#if defined(USB_CAM_CONV_NEON)
+    for (; x + 16 <= wd; x += 16) {
+        uint8x16x2_t p = vld2q_u8(in + 2 * x);
+        vst1q_u8(y + x, p.val[0]);
+    }
+#elif defined(USB_CAM_CONV_AVX2)
+    const __m256i mask = _mm256_set1_epi16(0x00ff);
+    for (; x + 32 <= wd; x += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(in + 2 * x));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(in + 2 * x + 32));
+        __m256i ys = _mm256_packus_epi16(_mm256_and_si256(a, mask),
+                                         _mm256_and_si256(b, mask));
+        /* packus works per 128 bit lane, restore the row order */
+        ys = _mm256_permute4x64_epi64(ys, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i *)(y + x), ys);
+    }
+#elif defined(USB_CAM_CONV_SSE2)
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    for (; x + 16 <= wd; x += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(in + 2 * x));
+        __m128i b = _mm_loadu_si128((const __m128i *)(in + 2 * x + 16));
+        _mm_storeu_si128((__m128i *)(y + x),
+            _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+    }
+#endif
+    for (; x < wd; x++) {
+        y[x] = in[2 * x];
+    }
+}
+
+/******************************************************************************
+ * Function: yuyvRowToYVU
+ * Description: Extracts the luma of one YUYV row and its chroma in VU order
+ *
+ * Input parameters:
+ *   in                  - YUYV row, 2 * wd bytes
+ *   y                   - luma output, wd bytes
+ *   vu                  - chroma output, wd bytes
+ *   wd                  - row width in pixels, even
+ *
+ * Return values: none
+ *****************************************************************************/
+static void yuyvRowToYVU(const uint8_t *in, uint8_t *y, uint8_t *vu, int wd)
+{
+    int x = 0;
+
+#if defined(USB_CAM_CONV_NEON)
+    for (; x + 32 <= wd; x += 32) {
+        /* val[0..3] = Y0, U, Y1, V of 16 pixel pairs */
+        uint8x16x4_t p = vld4q_u8(in + 2 * x);
+        uint8x16x2_t ys = { { p.val[0], p.val[2] } };
+        uint8x16x2_t vus = { { p.val[3], p.val[1] } };
+        vst2q_u8(y + x, ys);
+        vst2q_u8(vu + x, vus);
+    }
+#elif defined(USB_CAM_CONV_AVX2)
+    const __m256i mask = _mm256_set1_epi16(0x00ff);
+    for (; x + 32 <= wd; x += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(in + 2 * x));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(in + 2 * x + 32));
+        __m256i ys = _mm256_packus_epi16(_mm256_and_si256(a, mask),
+                                         _mm256_and_si256(b, mask));
+        /* odd bytes are U, V, U, V; swap each pair of words to V, U */
+        __m256i ca = _mm256_srli_epi16(a, 8);
+        __m256i cb = _mm256_srli_epi16(b, 8);
+        ca = _mm256_shufflehi_epi16(
+                _mm256_shufflelo_epi16(ca, _MM_SHUFFLE(2, 3, 0, 1)),
+                _MM_SHUFFLE(2, 3, 0, 1));
+        cb = _mm256_shufflehi_epi16(
+                _mm256_shufflelo_epi16(cb, _MM_SHUFFLE(2, 3, 0, 1)),
+                _MM_SHUFFLE(2, 3, 0, 1));
+        __m256i vus = _mm256_packus_epi16(ca, cb);
+        ys = _mm256_permute4x64_epi64(ys, _MM_SHUFFLE(3, 1, 2, 0));
+        vus = _mm256_permute4x64_epi64(vus, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i *)(y + x), ys);
+        _mm256_storeu_si256((__m256i *)(vu + x), vus);
+    }
+#elif defined(USB_CAM_CONV_SSE2)
+    const __m128i mask = _mm_set1_epi16(0x00ff);
+    for (; x + 16 <= wd; x += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(in + 2 * x));
+        __m128i b = _mm_loadu_si128((const __m128i *)(in + 2 * x + 16));
+        __m128i ca = _mm_srli_epi16(a, 8);
+        __m128i cb = _mm_srli_epi16(b, 8);
+        ca = _mm_shufflehi_epi16(
+                _mm_shufflelo_epi16(ca, _MM_SHUFFLE(2, 3, 0, 1)),
+                _MM_SHUFFLE(2, 3, 0, 1));
+        cb = _mm_shufflehi_epi16(
+                _mm_shufflelo_epi16(cb, _MM_SHUFFLE(2, 3, 0, 1)),
+                _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_si128((__m128i *)(y + x),
+            _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask)));
+        _mm_storeu_si128((__m128i *)(vu + x), _mm_packus_epi16(ca, cb));
+    }
+#endif
+    for (; x < wd; x += 2) {
+        y[x] = in[2 * x];
+        y[x + 1] = in[2 * x + 2];
+        vu[x] = in[2 * x + 3];
+        vu[x + 1] = in[2 * x + 1];
+    }
+}
+
+/******************************************************************************
+ * Function: convertStripe
+ * Description: Converts rows [rowStart, rowEnd) of a frame. rowStart is even.
+ *
+ * Input parameters:
+ *   arg                 - convStripe_t describing the stripe
+ *
+ * Return values: NULL
+ *****************************************************************************/
+static void *convertStripe(void *arg)
+{
+    const convStripe_t *s = (const convStripe_t *)arg;
+    const int inStride = s->wd * 2;
+    uint8_t *vuPlane = s->out + (size_t)s->wd * s->ht;
+
+    for (int row = s->rowStart; row < s->rowEnd; row++) {
+        const uint8_t *in = s->in + (size_t)row * inStride;
+        uint8_t *y = s->out + (size_t)row * s->wd;
+
+        if (row & 1) {
+            yuyvRowToY(in, y, s->wd);
+        } else {
+            yuyvRowToYVU(in, y, vuPlane + (size_t)(row / 2) * s->wd, s->wd);
+        }
+    }
+    return NULL;
+}
+
+/******************************************************************************
+ * Function: convWorker
+ * Description: Worker thread loop, converts its stripe of each posted frame
+ *
+ * Input parameters:
+ *   arg                 - convWorker_t of the thread
+ *
+ * Return values: NULL
+ *****************************************************************************/
+static void *convWorker(void *arg)
+{
+    convPool_t *pool = ((convWorker_t *)arg)->pool;
+    int index = ((convWorker_t *)arg)->index;
+    /* started before any frame, one posted before this runs is still due */
+    unsigned int seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->exit && (pool->frameSeq == seen))
+            pthread_cond_wait(&pool->workCond, &pool->lock);
+        if (pool->exit)
+            break;
+        seen = pool->frameSeq;
+        pthread_mutex_unlock(&pool->lock);
+
+        convertStripe(&pool->stripes[index]);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0)
+            pthread_cond_signal(&pool->doneCond);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+int usbCamConvInit(void **conv, int numThreads, int minPixels)
+{
+    convPool_t *pool;
+    int i;
+
+    if (NULL == conv) {
+        ALOGE("%s: Invalid args", __func__);
+        return -1;
+    }
+    *conv = NULL;
+
+    if (numThreads > USB_CAM_CONV_MAX_THREADS)
+        numThreads = USB_CAM_CONV_MAX_THREADS;
+    if (numThreads <= 1)
+        return 0;
+
+    pool = new convPool_t();
+    if (NULL == pool) {
+        ALOGE("%s: No memory", __func__);
+        return -1;
+    }
+    pthread_mutex_init(&pool->frameLock, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->workCond, NULL);
+    pthread_cond_init(&pool->doneCond, NULL);
+    pool->minPixels = minPixels;
+
+    for (i = 1; i < numThreads; i++) {
+        pool->workers[i - 1].pool = pool;
+        pool->workers[i - 1].index = i;
+        if (pthread_create(&pool->threads[i - 1], NULL, convWorker,
+                           &pool->workers[i - 1]))
+            break;
+        pool->numWorkers++;
+    }
+
+    if (0 == pool->numWorkers) {
+        ALOGE("%s: No worker started, converting on the caller", __func__);
+        usbCamConvDestroy(pool);
+        return 0;
+    }
+    ALOGI("%s: %d worker threads", __func__, pool->numWorkers);
+    *conv = pool;
+    return 0;
+}
+
+int usbCamConvDestroy(void *conv)
+{
+    convPool_t *pool = (convPool_t *)conv;
+    int i;
+
+    if (NULL == pool)
+        return 0;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->exit = 1;
+    pthread_cond_broadcast(&pool->workCond);
+    pthread_mutex_unlock(&pool->lock);
+    for (i = 0; i < pool->numWorkers; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_cond_destroy(&pool->doneCond);
+    pthread_cond_destroy(&pool->workCond);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_mutex_destroy(&pool->frameLock);
+    delete pool;
+    return 0;
+}
+
+int usbCamConvertYUYVto420SP(void *conv, const char *inBuf, char *outBuf,
+                             int wd, int ht)
+{
+    convPool_t *pool = (convPool_t *)conv;
+    convStripe_t frame;
+    int numStripes;
+    int rowsPerStripe;
+    int i;
+
+    if ((NULL == inBuf) || (NULL == outBuf) || (wd <= 0) || (ht <= 0) ||
+        (wd & 1)) {
+        ALOGE("%s: Invalid args in %p out %p %dx%d", __func__,
+              inBuf, outBuf, wd, ht);
+        return -1;
+    }
+
+    frame.in       = (const uint8_t *)inBuf;
+    frame.out      = (uint8_t *)outBuf;
+    frame.wd       = wd;
+    frame.ht       = ht;
+    frame.rowStart = 0;
+    frame.rowEnd   = ht;
+
+    /* Waking the workers costs more than it saves on small frames */
+    if ((NULL == pool) || ((long)wd * ht < pool->minPixels)) {
+        convertStripe(&frame);
+        return 0;
+    }
+
+    pthread_mutex_lock(&pool->frameLock);
+
+    /* Stripes start on an even row so each owns whole chroma rows */
+    numStripes = pool->numWorkers + 1;
+    rowsPerStripe = ((ht + 1) / 2 + numStripes - 1) / numStripes * 2;
+    for (i = 0; i < numStripes; i++) {
+        pool->stripes[i]          = frame;
+        pool->stripes[i].rowStart = i * rowsPerStripe;
+        pool->stripes[i].rowEnd   = (i + 1) * rowsPerStripe;
+        if (pool->stripes[i].rowStart > ht)
+            pool->stripes[i].rowStart = ht;
+        if (pool->stripes[i].rowEnd > ht)
+            pool->stripes[i].rowEnd = ht;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->pending = pool->numWorkers;
+    pool->frameSeq++;
+    pthread_cond_broadcast(&pool->workCond);
+    pthread_mutex_unlock(&pool->lock);
+
+    /* The calling thread converts the first stripe */
+    convertStripe(&pool->stripes[0]);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->doneCond, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+
+    pthread_mutex_unlock(&pool->frameLock);
+    return 0;
+}
@@ -32,6 +32,7 @@
 
 #include <utils/Log.h>
 #include <utils/threads.h>
+#include <cutils/properties.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -45,6 +46,7 @@
 #include "QualcommUsbCamera.h"
 #include "QCameraUsbPriv.h"
 #include "QCameraMjpegDecode.h"
+#include "QCameraUsbColorConv.h"
 #include "QCameraUsbParm.h"
 #include <gralloc_priv.h>
 #include <genlock.h>
@@ -116,7 +118,8 @@ static int put_buf_to_display(   camera_hardware_t *camHal, int buffer_id);
 static int convert_data_frm_cam_to_disp(camera_hardware_t *camHal, int buffer_id);
 static void * previewloop(void *);
 static void * takePictureThread(void *);
-static int convert_YUYV_to_420_NV12(char *in_buf, char *out_buf, int wd, int ht);
+static int convert_YUYV_to_420_NV12(void *conv, char *in_buf, char *out_buf,
+                                    int wd, int ht);
 static int get_uvc_device(char *devname);
 static int getPreviewCaptureFmt(camera_hardware_t *camHal);
 static int allocate_ion_memory(QCameraHalMemInfo_t *mem_info, int ion_type);
@@ -222,6 +225,16 @@ extern "C" int  usbcam_camera_device_open(
     rc = 0;
 #endif /* CAPTURE */
 
+    /* Number of row stripes large YUYV frames are converted in, 1 to    */
+    /* convert on the preview thread only                                 */
+    if (0 == rc) {
+        char value[PROPERTY_VALUE_MAX];
+        property_get("persist.vendor.camera.usbcam.convthreads", value, "1");
+        if (usbCamConvInit(&camHal->conv, atoi(value),
+                           USB_CAM_CONV_STRIPE_MIN_PIXELS) < 0)
+            ALOGE("%s: usbCamConvInit error", __func__);
+    }
+
     device                  = &camHal->hw_dev;
     device->common.close    = usbcam_close_camera_device;
     device->ops             = &usbcam_camera_ops;
@@ -248,6 +261,8 @@ extern "C"  int usbcam_close_camera_device( hw_device_t *hw_dev)
                 ALOGE("%s: close failed ", __func__);
             }
             camHal->fd = 0;
+            usbCamConvDestroy(camHal->conv);
+            camHal->conv = NULL;
             delete camHal;
         }else{
                 ALOGE("%s: camHal is NULL pointer ", __func__);
@@ -715,27 +730,14 @@ int usbcam_dump(struct camera_device * device, int fd)
 /************************** VUVU            19 17 23 21            ************/
 /******************************************************************************/
 
-static int convert_YUYV_to_420_NV12(char *in_buf, char *out_buf, int wd, int ht)
+/* See usbCamConvertYUYVto420SP for the vectorized, row striped kernels      */
+static int convert_YUYV_to_420_NV12(void *conv, char *in_buf, char *out_buf,
+                                    int wd, int ht)
 {
     int rc =0;
-    int row, col, uv_row;
 
     ALOGD("%s: E", __func__);
-    /* Arrange Y */
-    for(row = 0; row < ht; row++)
-        for(col = 0; col < wd * 2; col += 2)
-        {
-            out_buf[row * wd + col / 2] = in_buf[row * wd * 2 + col];
-        }
-
-    /* Arrange UV */
-    for(row = 0, uv_row = ht; row < ht; row += 2, uv_row++)
-        for(col = 1; col < wd * 2; col += 4)
-        {
-            out_buf[uv_row * wd + col / 2]= in_buf[row * wd * 2 + col + 2];
-            out_buf[uv_row * wd + col / 2 + 1]  = in_buf[row * wd * 2 + col];
-        }
-
+    rc = usbCamConvertYUYVto420SP(conv, in_buf, out_buf, wd, ht);
     ALOGD("%s: X", __func__);
     return rc;
 }
@@ -1931,6 +1933,7 @@ static int convert_data_frm_cam_to_disp(camera_hardware_t *camHal, int buffer_id
         (HAL_PIXEL_FORMAT_YCrCb_420_SP == camHal->dispFormat))
     {
         convert_YUYV_to_420_NV12(
+            camHal->conv,
             (char *)camHal->buffers[camHal->curCaptureBuf.index].data,
             (char *)camHal->previewMem.camera_memory[buffer_id]->data,
             camHal->prevWidth,
@@ -2827,7 +2830,7 @@ int encodeJpeg(camera_hardware_t *camHal)
         return -1;
     }
 
-    rc = convert_YUYV_to_420_NV12(
+    rc = convert_YUYV_to_420_NV12(camHal->conv,
         (char *)camHal->buffers[camHal->curCaptureBuf.index].data,
         (char *)jpegInMem->data, camHal->pictWidth, camHal->pictHeight);
     ERROR_CHECK_EXIT(rc, "convert_YUYV_to_420_NV12");
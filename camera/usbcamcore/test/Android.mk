@@ -0,0 +1,22 @@
+LOCAL_PATH:= $(call my-dir)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES:= \
+    usbcam_colorconv_test.cpp \
+    ../src/QCameraUsbColorConv.cpp \
+
+LOCAL_C_INCLUDES += \
+    $(LOCAL_PATH)/../inc \
+    $(LOCAL_PATH)/../../QCamera2/HAL/test
+
+LOCAL_SHARED_LIBRARIES:= \
+    liblog \
+
+LOCAL_MODULE:= usbcam_colorconv_test
+LOCAL_VENDOR_MODULE := true
+LOCAL_MODULE_TAGS:= tests
+
+LOCAL_CFLAGS += -Wall -Wextra -Werror
+
+include $(BUILD_EXECUTABLE)
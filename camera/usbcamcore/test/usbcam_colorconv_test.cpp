@@ -0,0 +1,251 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Checks usbCamConvertYUYVto420SP bit for bit against the scalar converter
+// QualcommUsbCamera.cpp used before, for odd sizes, SIMD tails and every
+// worker pool size, then times both from 480p to 4K.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "QCameraUsbColorConv.h"
+#include "qcamera_test_check.h"
+
+#define MAP_SIZE(MAP) (sizeof(MAP) / sizeof(MAP[0]))
+
+/* Worker pools striping every frame, indexed by thread count */
+static void *gPools[USB_CAM_CONV_MAX_THREADS + 2];
+
+/* The former convert_YUYV_to_420_NV12, kept as the reference */
+static int referenceConvert(char *in_buf, char *out_buf, int wd, int ht)
+{
+    int row, col, uv_row;
+
+    /* Arrange Y */
+    for(row = 0; row < ht; row++)
+        for(col = 0; col < wd * 2; col += 2)
+        {
+            out_buf[row * wd + col / 2] = in_buf[row * wd * 2 + col];
+        }
+
+    /* Arrange UV */
+    for(row = 0, uv_row = ht; row < ht; row += 2, uv_row++)
+        for(col = 1; col < wd * 2; col += 4)
+        {
+            out_buf[uv_row * wd + col / 2]= in_buf[row * wd * 2 + col + 2];
+            out_buf[uv_row * wd + col / 2 + 1]  = in_buf[row * wd * 2 + col];
+        }
+    return 0;
+}
+
+static uint64_t nowNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static size_t outSize(int wd, int ht)
+{
+    return (size_t)wd * ht + (size_t)wd * ((ht + 1) / 2);
+}
+
+static void fillRandom(char *buf, size_t len, unsigned int seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        buf[i] = (char)(seed >> 16);
+    }
+}
+
+static void testBitExact()
+{
+    static const int kWidths[] = { 2, 4, 14, 16, 18, 30, 32, 34, 62, 64, 66,
+            96, 176, 322, 640, 1282 };
+    static const int kHeights[] = { 1, 2, 3, 4, 7, 8, 17, 480 };
+
+    for (size_t w = 0; w < MAP_SIZE(kWidths); w++) {
+        for (size_t h = 0; h < MAP_SIZE(kHeights); h++) {
+            int wd = kWidths[w], ht = kHeights[h];
+            size_t inLen = (size_t)wd * ht * 2;
+            size_t outLen = outSize(wd, ht);
+            char *in = (char *)malloc(inLen);
+            char *ref = (char *)malloc(outLen);
+            char *out = (char *)malloc(outLen + 1);
+
+            fillRandom(in, inLen, (unsigned int)(wd * 1000 + ht));
+            memset(ref, 0, outLen);
+            referenceConvert(in, ref, wd, ht);
+            for (int t = 1; t <= USB_CAM_CONV_MAX_THREADS + 1; t++) {
+                /* guard byte catches writes past the frame */
+                memset(out, 0x5a, outLen + 1);
+                CHECK(usbCamConvertYUYVto420SP(gPools[t], in, out, wd, ht)
+                        == 0);
+                if (memcmp(out, ref, outLen) || out[outLen] != 0x5a) {
+                    printf("mismatch at %dx%d with %d stripes\n", wd, ht, t);
+                    TEST_FAIL();
+                }
+            }
+            free(in);
+            free(ref);
+            free(out);
+        }
+    }
+
+    char buf[8];
+    CHECK(usbCamConvertYUYVto420SP(NULL, NULL, buf, 2, 2) < 0);
+    CHECK(usbCamConvertYUYVto420SP(NULL, buf, NULL, 2, 2) < 0);
+    CHECK(usbCamConvertYUYVto420SP(NULL, buf, buf, 3, 1) < 0);
+    CHECK(usbCamConvertYUYVto420SP(NULL, buf, buf, 2, 0) < 0);
+}
+
+static void testPool()
+{
+    void *conv = (void *)&conv;
+    size_t outLen = outSize(64, 64);
+    char *in = (char *)malloc(64 * 64 * 2);
+    char *ref = (char *)malloc(outLen);
+    char *out = (char *)malloc(outLen);
+
+    /* one thread needs no pool */
+    CHECK(usbCamConvInit(&conv, 1, 0) == 0);
+    CHECK(conv == NULL);
+    CHECK(usbCamConvInit(NULL, 2, 0) < 0);
+    CHECK(usbCamConvDestroy(NULL) == 0);
+
+    /* frames below the threshold are converted on the calling thread */
+    CHECK(usbCamConvInit(&conv, 2, 64 * 64 + 1) == 0);
+    CHECK(conv != NULL);
+    fillRandom(in, 64 * 64 * 2, 7);
+    referenceConvert(in, ref, 64, 64);
+    CHECK(usbCamConvertYUYVto420SP(conv, in, out, 64, 64) == 0);
+    CHECK(!memcmp(out, ref, outLen));
+    CHECK(usbCamConvDestroy(conv) == 0);
+
+    /* the workers survive many frames and a pool restart */
+    for (int round = 0; round < 2; round++) {
+        CHECK(usbCamConvInit(&conv, USB_CAM_CONV_MAX_THREADS, 0) == 0);
+        for (int f = 0; f < 1000; f++) {
+            memset(out, 0, outLen);
+            CHECK(usbCamConvertYUYVto420SP(conv, in, out, 64, 64) == 0);
+            if (memcmp(out, ref, outLen)) {
+                printf("mismatch at frame %d of round %d\n", f, round);
+                TEST_FAIL();
+                break;
+            }
+        }
+        CHECK(usbCamConvDestroy(conv) == 0);
+    }
+    free(in);
+    free(ref);
+    free(out);
+}
+
+static void bench(int frames)
+{
+    static const struct {
+        const char *name;
+        int wd;
+        int ht;
+    } kSizes[] = {
+        { "480p", 640, 480 },
+        { "720p", 1280, 720 },
+        { "1080p", 1920, 1080 },
+        { "4K", 3840, 2160 },
+    };
+
+    printf("%-6s %10s", "size", "reference");
+    for (int t = 1; t <= USB_CAM_CONV_MAX_THREADS; t++) {
+        printf("   %d stripe%s", t, (t > 1) ? "s" : " ");
+    }
+    printf("   (us per frame, best of 3, every frame striped)\n");
+
+    for (size_t s = 0; s < MAP_SIZE(kSizes); s++) {
+        int wd = kSizes[s].wd, ht = kSizes[s].ht;
+        size_t inLen = (size_t)wd * ht * 2;
+        char *in = (char *)malloc(inLen);
+        char *out = (char *)malloc(outSize(wd, ht));
+        uint64_t best;
+
+        fillRandom(in, inLen, 1);
+        best = UINT64_MAX;
+        for (int round = 0; round < 3; round++) {
+            uint64_t start = nowNs();
+            for (int f = 0; f < frames; f++) {
+                referenceConvert(in, out, wd, ht);
+            }
+            uint64_t ns = (nowNs() - start) / frames;
+            best = (ns < best) ? ns : best;
+        }
+        printf("%-6s %10llu", kSizes[s].name,
+                (unsigned long long)(best / 1000));
+
+        for (int t = 1; t <= USB_CAM_CONV_MAX_THREADS; t++) {
+            best = UINT64_MAX;
+            for (int round = 0; round < 3; round++) {
+                uint64_t start = nowNs();
+                for (int f = 0; f < frames; f++) {
+                    usbCamConvertYUYVto420SP(gPools[t], in, out, wd, ht);
+                }
+                uint64_t ns = (nowNs() - start) / frames;
+                best = (ns < best) ? ns : best;
+            }
+            printf(" %11llu", (unsigned long long)(best / 1000));
+        }
+        printf("\n");
+        free(in);
+        free(out);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : 30;
+
+    if (frames < 0) {
+        printf("usage: %s [frames, 0 to skip the benchmark]\n", argv[0]);
+        return -1;
+    }
+    for (int t = 1; t <= USB_CAM_CONV_MAX_THREADS + 1; t++) {
+        CHECK(usbCamConvInit(&gPools[t], t, 0) == 0);
+        CHECK((gPools[t] != NULL) == (t > 1));
+    }
+    testBitExact();
+    testPool();
+    if (frames > 0) {
+        bench(frames);
+    }
+    for (int t = 1; t <= USB_CAM_CONV_MAX_THREADS + 1; t++) {
+        usbCamConvDestroy(gPools[t]);
+    }
+
+    return testResult("usbcam_colorconv_test");
+}
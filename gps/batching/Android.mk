@@ -22,7 +22,8 @@ LOCAL_SHARED_LIBRARIES := \
 
 LOCAL_SRC_FILES += \
     location_batching.cpp \
-    BatchingAdapter.cpp
+    BatchingAdapter.cpp \
+    BatchingLocationStore.cpp
 
 LOCAL_HEADER_LIBRARIES := \
     libgps.utils_headers \
@@ -29,13 +29,26 @@
 #define LOG_NDEBUG 0
 #define LOG_TAG "LocSvc_BatchingAdapter"
 
+#include <string.h>
 #include <loc_pla.h>
 #include <log_util.h>
 #include <LocContext.h>
 #include <BatchingAdapter.h>
+#include <LocMsgPool.h>
+
+// reports of up to this many locations are copied into pooled arrays, which
+// covers the default BATCH_SIZE, larger reports still go to the heap
+#define BATCHING_POOLED_LOCATIONS (64)
+#define BATCHING_POOLED_ARRAYS (4)
 
 using namespace loc_core;
 
+static LocMsgPool& locationArrayPool() {
+    static LocMsgPool* sPool = new LocMsgPool("BatchingLocations",
+            BATCHING_POOLED_LOCATIONS * sizeof(Location), BATCHING_POOLED_ARRAYS);
+    return *sPool;
+}
+
 BatchingAdapter::BatchingAdapter() :
     LocAdapterBase(0,
                     LocContext::getLocContext(
@@ -72,12 +85,14 @@ BatchingAdapter::readConfigCommand()
             uint32_t batchingAccuracy = 0;
             uint32_t batchSize = 0;
             uint32_t tripBatchSize = 0;
+            uint32_t batchStoreSize = 0;
             static const loc_param_s_type flp_conf_param_table[] =
             {
                 {"BATCH_SIZE", &batchSize, NULL, 'n'},
                 {"OUTDOOR_TRIP_BATCH_SIZE", &tripBatchSize, NULL, 'n'},
                 {"BATCH_SESSION_TIMEOUT", &batchingTimeout, NULL, 'n'},
                 {"ACCURACY", &batchingAccuracy, NULL, 'n'},
+                {"BATCH_STORE_SIZE", &batchStoreSize, NULL, 'n'},
             };
             UTIL_READ_CONF(LOC_PATH_FLP_CONF, flp_conf_param_table);
 
@@ -88,6 +103,9 @@ BatchingAdapter::readConfigCommand()
              mAdapter.setTripBatchSize(tripBatchSize);
              mAdapter.setBatchingTimeout(batchingTimeout);
              mAdapter.setBatchingAccuracy(batchingAccuracy);
+             if (batchStoreSize > 0 && !mAdapter.mLocationStore.isOpen()) {
+                 mAdapter.mLocationStore.open(BATCHING_STORE_PATH, batchStoreSize);
+             }
         }
     };
 
@@ -596,7 +614,7 @@ BatchingAdapter::reportLocationsEvent(const Location* locations, size_t count,
 {
     LOC_LOGD("%s]: count %zu batchMode %d", __func__, count, batchingMode);
 
-    struct MsgReportLocations : public LocMsg {
+    struct MsgReportLocations : public LocMsg, public LocPooledMsg<MsgReportLocations> {
         BatchingAdapter& mAdapter;
         Location* mLocations;
         size_t mCount;
@@ -607,27 +625,48 @@ BatchingAdapter::reportLocationsEvent(const Location* locations, size_t count,
                                   BatchingMode batchingMode) :
             LocMsg(),
             mAdapter(adapter),
-            mLocations(new Location[count]),
+            mLocations((Location*)locationArrayPool().alloc(count * sizeof(Location))),
             mCount(count),
             mBatchingMode(batchingMode)
         {
-            if (nullptr == mLocations) {
-                LOC_LOGE("%s]: new failed to allocate mLocations", __func__);
-                return;
-            }
-            for (size_t i=0; i < mCount; ++i) {
-                mLocations[i] = locations[i];
-            }
+            memcpy(mLocations, locations, count * sizeof(Location));
         }
         inline virtual ~MsgReportLocations() {
-            if (nullptr != mLocations)
-                delete[] mLocations;
+            locationArrayPool().release(mLocations, mCount * sizeof(Location));
         }
         inline virtual void proc() const {
             mAdapter.reportLocations(mLocations, mCount, mBatchingMode);
         }
     };
 
+    struct MsgReportStoredLocations : public LocMsg,
+                                      public LocPooledMsg<MsgReportStoredLocations> {
+        BatchingAdapter& mAdapter;
+        uint64_t mFirst;
+        size_t mCount;
+        BatchingMode mBatchingMode;
+        inline MsgReportStoredLocations(BatchingAdapter& adapter,
+                                        uint64_t first,
+                                        size_t count,
+                                        BatchingMode batchingMode) :
+            LocMsg(),
+            mAdapter(adapter),
+            mFirst(first),
+            mCount(count),
+            mBatchingMode(batchingMode) {}
+        inline virtual void proc() const {
+            mAdapter.reportStoredLocations(mFirst, mCount, mBatchingMode);
+        }
+    };
+
+    // with the store, the locations wait in the mapping instead of in a
+    // copy allocated for the message, unless the ring is full of locations
+    // not delivered yet
+    uint64_t first = 0;
+    if (mLocationStore.isOpen() && mLocationStore.append(locations, count, first)) {
+        sendMsg(new MsgReportStoredLocations(*this, first, count, batchingMode));
+        return;
+    }
     sendMsg(new MsgReportLocations(*this, locations, count, batchingMode));
 }
 
@@ -643,6 +682,24 @@ BatchingAdapter::reportLocations(Location* locations, size_t count, BatchingMode
     }
 }
 
+// clients get a copy of the stored locations in one contiguous buffer, the
+// mapping being shared; the records are released to the writer once copied
+void
+BatchingAdapter::reportStoredLocations(uint64_t first, size_t count, BatchingMode batchingMode)
+{
+    if (mReportBuffer.size() < count) {
+        mReportBuffer.resize(count);
+    }
+    size_t copied = mLocationStore.read(first, count, mReportBuffer.data());
+    mLocationStore.release(first + count);
+    if (copied < count) {
+        LOC_LOGE("%s]: %zu of %zu stored locations missing", __func__, count - copied, count);
+    }
+    if (copied > 0) {
+        reportLocations(mReportBuffer.data(), copied, batchingMode);
+    }
+}
+
 void
 BatchingAdapter::reportCompletedTripsEvent(uint32_t accumulated_distance)
 {
@@ -32,7 +32,9 @@
 #include <LocAdapterBase.h>
 #include <LocContext.h>
 #include <LocationAPI.h>
+#include <BatchingLocationStore.h>
 #include <map>
+#include <vector>
 
 using namespace loc_core;
 
@@ -80,6 +82,12 @@ class BatchingAdapter : public LocAdapterBase {
     size_t mBatchSize;
     size_t mTripBatchSize;
 
+    /* ==== LOCATION STORE ================================================================= */
+    // reported locations, when BATCH_STORE_SIZE is set
+    BatchingLocationStore mLocationStore;
+    // stored locations are copied here for the clients, on the MsgTask thread
+    std::vector<Location> mReportBuffer;
+
 protected:
 
     /* ==== CLIENT ========================================================================= */
@@ -130,6 +138,7 @@ public:
     void reportBatchStatusChangeEvent(BatchingStatus batchStatus);
     /* ======== UTILITIES ================================================================== */
     void reportLocations(Location* locations, size_t count, BatchingMode batchingMode);
+    void reportStoredLocations(uint64_t first, size_t count, BatchingMode batchingMode);
     void reportBatchStatusChange(BatchingStatus batchStatus,
             std::list<uint32_t> & completedTripsList);
 
@@ -0,0 +1,472 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_NDEBUG 0
+#define LOG_TAG "LocSvc_BatchingLocationStore"
+
+#include <fcntl.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <loc_pla.h>
+#include <log_util.h>
+#include <BatchingLocationStore.h>
+
+#define BATCHING_STORE_MAGIC (0x5453424cu) // "LBST"
+#define BATCHING_STORE_VERSION (1)
+// records start at this offset, keeping them cache line aligned
+#define BATCHING_STORE_HEADER_SIZE (64)
+
+BatchingLocationStore::BatchingLocationStore() :
+    mFd(-1),
+    mMapping(MAP_FAILED),
+    mMappingSize(0),
+    mHeader(nullptr),
+    mRecords(nullptr),
+    mCapacity(0),
+    mOpen(false),
+    mReleased(0)
+{
+    static_assert(sizeof(Header) <= BATCHING_STORE_HEADER_SIZE, "header too large");
+}
+
+bool
+BatchingLocationStore::open(const char* path, uint32_t capacity)
+{
+    close();
+    if (nullptr == path || 0 == capacity) {
+        return false;
+    }
+
+    int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0660);
+    if (fd < 0) {
+        LOC_LOGE("%s]: open %s failed, %s", __func__, path, strerror(errno));
+        return false;
+    }
+    size_t size = BATCHING_STORE_HEADER_SIZE + (size_t)capacity * sizeof(Location);
+    struct stat st;
+    bool reset = (0 != fstat(fd, &st) || (size_t)st.st_size != size);
+    if (reset && 0 != ftruncate(fd, size)) {
+        LOC_LOGE("%s]: ftruncate %s to %zu failed, %s", __func__, path, size, strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == mapping) {
+        LOC_LOGE("%s]: mmap %s failed, %s", __func__, path, strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    Header* header = (Header*)mapping;
+    if (!reset && (BATCHING_STORE_MAGIC != header->magic ||
+                   BATCHING_STORE_VERSION != header->version ||
+                   sizeof(Location) != header->recordSize ||
+                   capacity != header->capacity)) {
+        reset = true;
+    }
+    if (reset) {
+        // magic goes last, a header cut short by a crash is reset again
+        header->magic = 0;
+        header->version = BATCHING_STORE_VERSION;
+        header->recordSize = sizeof(Location);
+        header->capacity = capacity;
+        header->written.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = BATCHING_STORE_MAGIC;
+    }
+    LOC_LOGD("%s]: %s capacity %u, %s with %" PRIu64 " records written", __func__, path,
+             capacity, reset ? "reset" : "kept", header->written.load());
+
+    mFd = fd;
+    mMapping = mapping;
+    mMappingSize = size;
+    mHeader = header;
+    mRecords = (Location*)((char*)mapping + BATCHING_STORE_HEADER_SIZE);
+    mCapacity = capacity;
+    // records of an earlier run have no reader left
+    mReleased.store(header->written.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    mOpen.store(true, std::memory_order_release);
+    return true;
+}
+
+void
+BatchingLocationStore::close()
+{
+    mOpen.store(false, std::memory_order_release);
+    if (MAP_FAILED != mMapping) {
+        munmap(mMapping, mMappingSize);
+        mMapping = MAP_FAILED;
+    }
+    if (mFd >= 0) {
+        ::close(mFd);
+        mFd = -1;
+    }
+    mHeader = nullptr;
+    mRecords = nullptr;
+    mCapacity = 0;
+}
+
+bool
+BatchingLocationStore::append(const Location* locations, size_t count, uint64_t& first)
+{
+    first = mHeader->written.load(std::memory_order_relaxed);
+    // acquire pairs with release(), the reader is done copying those slots
+    uint64_t released = mReleased.load(std::memory_order_acquire);
+    if (first + count - released > mCapacity) {
+        return false;
+    }
+    size_t slot = first % mCapacity;
+    size_t left = count;
+    const Location* from = locations;
+    while (left > 0) {
+        size_t n = (left < mCapacity - slot) ? left : mCapacity - slot;
+        memcpy(&mRecords[slot], from, n * sizeof(Location));
+        from += n;
+        left -= n;
+        slot = 0;
+    }
+    mHeader->written.store(first + count, std::memory_order_release);
+    return true;
+}
+
+size_t
+BatchingLocationStore::read(uint64_t first, size_t count, Location* locations) const
+{
+    uint64_t written = mHeader->written.load(std::memory_order_acquire);
+    uint64_t oldest = (written > mCapacity) ? written - mCapacity : 0;
+    uint64_t begin = (first > oldest) ? first : oldest;
+    uint64_t end = (first + count < written) ? first + count : written;
+    if (begin >= end) {
+        return 0;
+    }
+    size_t slot = begin % mCapacity;
+    size_t n = end - begin;
+    size_t head = (n < mCapacity - slot) ? n : mCapacity - slot;
+    memcpy(locations, &mRecords[slot], head * sizeof(Location));
+    memcpy(&locations[head], mRecords, (n - head) * sizeof(Location));
+    return n;
+}
+
+void
+BatchingLocationStore::release(uint64_t end)
+{
+    if (end > mReleased.load(std::memory_order_relaxed)) {
+        mReleased.store(end, std::memory_order_release);
+    }
+}
+
+#ifdef __LOC_DEBUG__
+
+// For Linux command line checking and benchmarking of the batching store:
+//     g++ -D__LOC_DEBUG__ -DUSE_GLIB -DFEATURE_EXTERNAL_AP -DOFF_TARGET -O2 -std=c++11
+//         -I. -I../location -I../utils -I../pla/oe -o batching_store_test
+//         BatchingLocationStore.cpp ../utils/loc_log.cpp -lpthread
+//     ./batching_store_test [file]
+// Replays 1M synthetic fixes in batches, once through the Location array copy
+// MsgReportLocations makes and once through the store, checks every delivered
+// record, then reopens the file the way a restarted HAL would and keeps
+// appending to it. A reader racing the writer on a small ring, falling back
+// to copies as BatchingAdapter does when the ring is full, must get every
+// fix exactly once and in order.
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <deque>
+
+#define TEST_FIXES (1000000)
+#define TEST_BATCH (40)
+#define TEST_CAPACITY (65536)
+#define TEST_RACE_CAPACITY (256)
+#define TEST_RACE_BATCHES (200000)
+#define TEST_RACE_BURST (8)
+
+static inline uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static long rssKb() {
+    long kb = -1;
+    FILE* file = fopen("/proc/self/status", "r");
+    if (NULL != file) {
+        char line[128];
+        while (NULL != fgets(line, sizeof(line), file)) {
+            if (1 == sscanf(line, "VmRSS: %ld", &kb)) {
+                break;
+            }
+        }
+        fclose(file);
+    }
+    return kb;
+}
+
+static void makeFix(Location& location, uint64_t n) {
+    memset(&location, 0, sizeof(location));
+    location.size = sizeof(Location);
+    location.flags = LOCATION_HAS_LAT_LONG_BIT | LOCATION_HAS_ACCURACY_BIT;
+    location.timestamp = 1600000000000ULL + n * 1000;
+    location.latitude = 37.0 + (n % 1000) * 1e-5;
+    location.longitude = -122.0 - (n % 1000) * 1e-5;
+    location.accuracy = 5.0f;
+}
+
+// what a client batching callback sees, checked to be the fixes in order
+static uint64_t sNextTimestamp;
+static bool sInOrder = true;
+static void deliver(const Location* locations, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        sInOrder = sInOrder && locations[i].timestamp == sNextTimestamp;
+        sNextTimestamp += 1000;
+    }
+}
+
+static bool appendFixes(BatchingLocationStore& store, uint64_t first, size_t count) {
+    Location* batch = new Location[count];
+    for (size_t i = 0; i < count; i++) {
+        makeFix(batch[i], first + i);
+    }
+    uint64_t at = 0;
+    bool appended = store.append(batch, count, at);
+    delete[] batch;
+    return appended && at == first;
+}
+
+// the newest count records of the store should be the fixes up to end
+static bool checkLast(BatchingLocationStore& store, size_t count, uint64_t end) {
+    Location* copy = new Location[count];
+    size_t copied = store.read(store.written() - count, count, copy);
+    sNextTimestamp = 1600000000000ULL + (end - copied) * 1000ULL;
+    sInOrder = true;
+    deliver(copy, copied);
+    delete[] copy;
+    return sInOrder && copied == count;
+}
+
+// a report queued for the reader, as MsgReportStoredLocations or as the
+// MsgReportLocations copy when the ring has no room
+struct RaceReport {
+    uint64_t first;
+    Location* copy;
+};
+
+struct RaceState {
+    BatchingLocationStore* store;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    std::deque<RaceReport> reports;
+    bool done;
+    uint64_t copies;
+};
+
+static void* raceWriter(void* arg) {
+    RaceState* state = (RaceState*)arg;
+    Location batch[TEST_BATCH];
+    for (uint64_t n = 0; n < (uint64_t)TEST_RACE_BATCHES * TEST_BATCH; n += TEST_BATCH) {
+        for (size_t i = 0; i < TEST_BATCH; i++) {
+            makeFix(batch[i], n + i);
+        }
+        RaceReport report = { 0, NULL };
+        if (!state->store->append(batch, TEST_BATCH, report.first)) {
+            report.copy = new Location[TEST_BATCH];
+            memcpy(report.copy, batch, sizeof(batch));
+            state->copies++;
+        }
+        pthread_mutex_lock(&state->lock);
+        state->reports.push_back(report);
+        pthread_cond_broadcast(&state->cond);
+        // bursts of a bit more than the ring holds, then the reader catches
+        // up, so both the store and the copies get used
+        if (0 == (n / TEST_BATCH + 1) % TEST_RACE_BURST) {
+            while (!state->reports.empty()) {
+                pthread_cond_wait(&state->cond, &state->lock);
+            }
+        }
+        pthread_mutex_unlock(&state->lock);
+    }
+    pthread_mutex_lock(&state->lock);
+    state->done = true;
+    pthread_cond_broadcast(&state->cond);
+    pthread_mutex_unlock(&state->lock);
+    return NULL;
+}
+
+// delivers the reports while the writer keeps appending to a small ring,
+// every fix has to come through once and in order
+static bool testRace(const char* path, uint64_t& copies) {
+    BatchingLocationStore store;
+    unlink(path);
+    if (!store.open(path, TEST_RACE_CAPACITY)) {
+        return false;
+    }
+    RaceState state;
+    state.store = &store;
+    pthread_mutex_init(&state.lock, NULL);
+    pthread_cond_init(&state.cond, NULL);
+    state.done = false;
+    state.copies = 0;
+    pthread_t writer;
+    pthread_create(&writer, NULL, raceWriter, &state);
+    Location copy[TEST_BATCH];
+    sNextTimestamp = 1600000000000ULL;
+    sInOrder = true;
+    for (;;) {
+        pthread_mutex_lock(&state.lock);
+        while (state.reports.empty() && !state.done) {
+            pthread_cond_wait(&state.cond, &state.lock);
+        }
+        if (state.reports.empty()) {
+            pthread_mutex_unlock(&state.lock);
+            break;
+        }
+        RaceReport report = state.reports.front();
+        state.reports.pop_front();
+        pthread_cond_broadcast(&state.cond);
+        pthread_mutex_unlock(&state.lock);
+
+        if (NULL != report.copy) {
+            deliver(report.copy, TEST_BATCH);
+            delete[] report.copy;
+        } else {
+            size_t copied = store.read(report.first, TEST_BATCH, copy);
+            store.release(report.first + TEST_BATCH);
+            sInOrder = sInOrder && copied == TEST_BATCH;
+            deliver(copy, copied);
+        }
+    }
+    pthread_join(writer, NULL);
+    pthread_cond_destroy(&state.cond);
+    pthread_mutex_destroy(&state.lock);
+    store.close();
+    unlink(path);
+    copies = state.copies;
+    return sInOrder &&
+            sNextTimestamp == 1600000000000ULL + (uint64_t)TEST_RACE_BATCHES * TEST_BATCH * 1000;
+}
+
+int main(int argc, char** argv) {
+    const char* path = (argc > 1) ? argv[1] : "/tmp/batching_store_test";
+    unlink(path);
+    Location batch[TEST_BATCH];
+    long rssStart = rssKb();
+
+    sNextTimestamp = 1600000000000ULL;
+    uint64_t start = nowNs();
+    for (uint64_t n = 0; n < TEST_FIXES; n += TEST_BATCH) {
+        for (size_t i = 0; i < TEST_BATCH; i++) {
+            makeFix(batch[i], n + i);
+        }
+        Location* copy = new Location[TEST_BATCH];
+        for (size_t i = 0; i < TEST_BATCH; i++) {
+            copy[i] = batch[i];
+        }
+        deliver(copy, TEST_BATCH);
+        delete[] copy;
+    }
+    double copyRate = TEST_FIXES * 1e9 / (nowNs() - start);
+    long rssCopy = rssKb();
+
+    BatchingLocationStore store;
+    if (!store.open(path, TEST_CAPACITY)) {
+        printf("open %s failed\n", path);
+        return 1;
+    }
+    sNextTimestamp = 1600000000000ULL;
+    bool appended = true;
+    start = nowNs();
+    for (uint64_t n = 0; n < TEST_FIXES; n += TEST_BATCH) {
+        for (size_t i = 0; i < TEST_BATCH; i++) {
+            makeFix(batch[i], n + i);
+        }
+        Location copy[TEST_BATCH];
+        uint64_t first = 0;
+        appended = store.append(batch, TEST_BATCH, first) && appended;
+        size_t copied = store.read(first, TEST_BATCH, copy);
+        store.release(first + TEST_BATCH);
+        deliver(copy, copied);
+    }
+    double storeRate = TEST_FIXES * 1e9 / (nowNs() - start);
+    long rssStore = rssKb();
+    bool ok = appended && sInOrder &&
+            sNextTimestamp == 1600000000000ULL + TEST_FIXES * 1000ULL &&
+            store.written() == TEST_FIXES;
+    store.close();
+
+    // a restarted HAL finds the newest records of the last run, wrapped in the ring
+    BatchingLocationStore reopened;
+    bool reopenOk = reopened.open(path, TEST_CAPACITY) && reopened.written() == TEST_FIXES &&
+            checkLast(reopened, TEST_CAPACITY, TEST_FIXES);
+    // records older than the ring are gone
+    reopenOk = reopenOk && 0 == reopened.read(0, TEST_BATCH, batch);
+    // and appending carries on after them, as nothing is left to deliver
+    reopenOk = reopenOk && appendFixes(reopened, TEST_FIXES, 1000) &&
+            reopened.written() == TEST_FIXES + 1000 &&
+            checkLast(reopened, TEST_CAPACITY, TEST_FIXES + 1000);
+    reopened.close();
+    ok = ok && reopenOk;
+
+    // undelivered records are never overwritten: appends that do not fit
+    // are refused, and accepted again once the reader released enough
+    uint64_t end = TEST_FIXES + 1000;
+    bool fullOk = reopened.open(path, TEST_CAPACITY) &&
+            !appendFixes(reopened, end, TEST_CAPACITY + 1) &&
+            appendFixes(reopened, end, TEST_CAPACITY) &&
+            !appendFixes(reopened, end + TEST_CAPACITY, 1) &&
+            reopened.written() == end + TEST_CAPACITY &&
+            checkLast(reopened, TEST_CAPACITY, end + TEST_CAPACITY);
+    reopened.release(end + 1);
+    fullOk = fullOk && appendFixes(reopened, end + TEST_CAPACITY, 1) &&
+            !appendFixes(reopened, end + TEST_CAPACITY + 1, 1);
+    reopened.close();
+    ok = ok && fullOk;
+
+    // a different layout starts over
+    ok = ok && reopened.open(path, TEST_CAPACITY / 2) && 0 == reopened.written();
+    reopened.close();
+    unlink(path);
+
+    uint64_t copies = 0;
+    bool raceOk = testRace(path, copies);
+    ok = ok && raceOk;
+
+    printf("%d fixes in batches of %d: copy %.2fM fixes/s, store %.2fM fixes/s, %s\n",
+           TEST_FIXES, TEST_BATCH, copyRate / 1e6, storeRate / 1e6, ok ? "ok" : "FAILED");
+    printf("reopen %s, full ring %s, racing reader %s (%d batches, %" PRIu64
+           " copied for want of room)\n", reopenOk ? "ok" : "FAILED",
+           fullOk ? "ok" : "FAILED", raceOk ? "ok" : "FAILED", TEST_RACE_BATCHES, copies);
+    printf("RSS kB: start %ld, after copy %ld, after store %ld (%zu kB mapped)\n",
+           rssStart, rssCopy, rssStore,
+           (BATCHING_STORE_HEADER_SIZE + TEST_CAPACITY * sizeof(Location)) / 1024);
+    return ok ? 0 : 1;
+}
+
+#endif /* __LOC_DEBUG__ */
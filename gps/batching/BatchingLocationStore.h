@@ -0,0 +1,98 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef BATCHING_LOCATION_STORE_H
+#define BATCHING_LOCATION_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <atomic>
+#include <LocationDataTypes.h>
+
+#define BATCHING_STORE_PATH "/data/vendor/location/batching_locations"
+
+/* Batched locations kept in a memory mapped file, as a ring of fixed size
+   records behind a small header. The records reach the page cache as they are
+   appended, so they outlive a HAL restart.
+   There is one writer, appending records before it publishes the new write
+   count, and one reader on another thread, which copies the records out and
+   then releases them. The writer never overwrites records that are not
+   released yet: an append that does not fit next to them is refused, and the
+   caller keeps those locations elsewhere. */
+class BatchingLocationStore {
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t recordSize;
+        uint32_t capacity;
+        // records appended since the file was created, slot is written % capacity
+        std::atomic<uint64_t> written;
+    };
+
+    int mFd;
+    void* mMapping;
+    size_t mMappingSize;
+    Header* mHeader;
+    Location* mRecords;
+    uint32_t mCapacity;
+    std::atomic<bool> mOpen;
+    // end of the records the reader is done with, the writer may reuse their slots
+    std::atomic<uint64_t> mReleased;
+
+public:
+    BatchingLocationStore();
+    inline ~BatchingLocationStore() { close(); }
+
+    // maps the file, keeping its records if it was written with the same
+    // record layout and capacity, or else starting it over
+    bool open(const char* path, uint32_t capacity);
+    void close();
+    inline bool isOpen() const { return mOpen.load(std::memory_order_acquire); }
+    inline uint32_t capacity() const { return mCapacity; }
+    inline uint64_t written() const {
+        return mHeader->written.load(std::memory_order_acquire);
+    }
+
+    /* ======== WRITER ===================================================================== */
+    // appends the locations and sets first to the sequence number of the
+    // first of them, returns false without appending anything if they do not
+    // fit in the ring next to the records not released yet
+    bool append(const Location* locations, size_t count, uint64_t& first);
+
+    /* ======== READER ===================================================================== */
+    // copies the records [first, first + count) that are in the ring into
+    // locations, which must hold count records, returns how many were copied;
+    // those are the newest of the range. Only records not released yet are
+    // safe from the writer during the copy
+    size_t read(uint64_t first, size_t count, Location* locations) const;
+    // hands the records before end back to the writer
+    void release(uint64_t end);
+};
+
+#endif /* BATCHING_LOCATION_STORE_H */
@@ -68,6 +68,14 @@ ifneq (,$(filter $(GNSS_HIDL_LEGACY_MEASURMENTS_TARGET_LIST),$(TARGET_BOARD_PLAT
 GNSS_HIDL_LEGACY_MEASURMENTS = true
 endif
 
+# Activate the following line to back MsgTask with the lock-free
+# LocMpscQueue instead of msg_q
+#GNSS_MSGTASK_MPSC_Q := true
+
+# Activate the following line to keep LocTimer timers in the array
+# backed LocArrayHeap instead of the linked LocHeap
+#GNSS_LOC_TIMER_ARRAY_HEAP := true
+
 # Activate the following two lines for regression testing
 #GNSS_SANITIZE := address cfi alignment bounds null unreachable integer
 #GNSS_SANITIZE_DIAG := address cfi alignment bounds null unreachable integer
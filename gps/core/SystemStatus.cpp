@@ -34,6 +34,7 @@
 #include <string.h>
 #include <sys/time.h>
 #include <pthread.h>
+#include <atomic>
 #include <loc_pla.h>
 #include <log_util.h>
 #include <loc_nmea.h>
@@ -51,35 +52,38 @@ namespace loc_core
 class SystemStatusNmeaBase
 {
 protected:
-    std::vector<std::string> mField;
-
-    SystemStatusNmeaBase(const char *str_in, uint32_t len_in)
+    // Fields are not copied out of the sentence: mField[i] points at the start
+    // of field i in the caller's buffer. A field ends at the next ',' or '*',
+    // where atoi/atof/strtol stop anyway, so they can parse it in place.
+    const char* mField[2 + SV_ALL_NUM*3]; // PQWP7 is the longest sentence
+    uint32_t mFieldCount;
+
+    SystemStatusNmeaBase(const char *str_in, uint32_t len_in) :
+        mFieldCount(0)
     {
         // check size and talker
         if (!loc_nmea_is_debug(str_in, len_in)) {
             return;
         }
 
-        std::string parser(str_in);
-        std::string::size_type index = 0;
+        const char* pEnd = str_in + strnlen(str_in, len_in);
 
         // verify checksum field
-        index = parser.find("*");
-        if (index == std::string::npos) {
+        const char* pStar = (const char*)memchr(str_in, '*', pEnd - str_in);
+        if (NULL == pStar) {
             return;
         }
-        parser[index] = ',';
 
-        // tokenize parser
-        while (1) {
-            std::string str;
-            index = parser.find(",");
-            if (index == std::string::npos) {
-                break;
+        // tokenize in a single pass, '*' terminates the last field
+        const char* pField = str_in;
+        for (const char* p = str_in; p < pEnd; p++) {
+            if (',' == *p || p == pStar) {
+                if (mFieldCount >= sizeof(mField) / sizeof(mField[0])) {
+                    break;
+                }
+                mField[mFieldCount++] = pField;
+                pField = p + 1;
             }
-            str = parser.substr(0, index);
-            parser = parser.substr(index + 1);
-            mField.push_back(str);
         }
     }
 
@@ -209,47 +213,47 @@ public:
         : SystemStatusNmeaBase(str_in, len_in)
     {
         memset(&mM1, 0, sizeof(mM1));
-        if (mField.size() <= eMax0) {
-            LOC_LOGE("PQWM1parser - invalid size=%zu", mField.size());
+        if (mFieldCount <= eMax0) {
+            LOC_LOGE("PQWM1parser - invalid size=%u", mFieldCount);
             mM1.mTimeValid = 0;
             return;
         }
-        mM1.mGpsWeek = atoi(mField[eGpsWeek].c_str());
-        mM1.mGpsTowMs = atoi(mField[eGpsTowMs].c_str());
-        mM1.mTimeValid = atoi(mField[eTimeValid].c_str());
-        mM1.mTimeSource = atoi(mField[eTimeSource].c_str());
-        mM1.mTimeUnc = atoi(mField[eTimeUnc].c_str());
-        mM1.mClockFreqBias = atoi(mField[eClockFreqBias].c_str());
-        mM1.mClockFreqBiasUnc = atoi(mField[eClockFreqBiasUnc].c_str());
-        mM1.mXoState = atoi(mField[eXoState].c_str());
-        mM1.mPgaGain = atoi(mField[ePgaGain].c_str());
-        mM1.mGpsBpAmpI = atoi(mField[eGpsBpAmpI].c_str());
-        mM1.mGpsBpAmpQ = atoi(mField[eGpsBpAmpQ].c_str());
-        mM1.mAdcI = atoi(mField[eAdcI].c_str());
-        mM1.mAdcQ = atoi(mField[eAdcQ].c_str());
-        mM1.mJammerGps = atoi(mField[eJammerGps].c_str());
-        mM1.mJammerGlo = atoi(mField[eJammerGlo].c_str());
-        mM1.mJammerBds = atoi(mField[eJammerBds].c_str());
-        mM1.mJammerGal = atoi(mField[eJammerGal].c_str());
-        mM1.mRecErrorRecovery = atoi(mField[eRecErrorRecovery].c_str());
-        mM1.mAgcGps = atof(mField[eAgcGps].c_str());
-        mM1.mAgcGlo = atof(mField[eAgcGlo].c_str());
-        mM1.mAgcBds = atof(mField[eAgcBds].c_str());
-        mM1.mAgcGal = atof(mField[eAgcGal].c_str());
-        if (mField.size() > eLeapSecUnc) {
-            mM1.mLeapSeconds = atoi(mField[eLeapSeconds].c_str());
-            mM1.mLeapSecUnc = atoi(mField[eLeapSecUnc].c_str());
+        mM1.mGpsWeek = atoi(mField[eGpsWeek]);
+        mM1.mGpsTowMs = atoi(mField[eGpsTowMs]);
+        mM1.mTimeValid = atoi(mField[eTimeValid]);
+        mM1.mTimeSource = atoi(mField[eTimeSource]);
+        mM1.mTimeUnc = atoi(mField[eTimeUnc]);
+        mM1.mClockFreqBias = atoi(mField[eClockFreqBias]);
+        mM1.mClockFreqBiasUnc = atoi(mField[eClockFreqBiasUnc]);
+        mM1.mXoState = atoi(mField[eXoState]);
+        mM1.mPgaGain = atoi(mField[ePgaGain]);
+        mM1.mGpsBpAmpI = atoi(mField[eGpsBpAmpI]);
+        mM1.mGpsBpAmpQ = atoi(mField[eGpsBpAmpQ]);
+        mM1.mAdcI = atoi(mField[eAdcI]);
+        mM1.mAdcQ = atoi(mField[eAdcQ]);
+        mM1.mJammerGps = atoi(mField[eJammerGps]);
+        mM1.mJammerGlo = atoi(mField[eJammerGlo]);
+        mM1.mJammerBds = atoi(mField[eJammerBds]);
+        mM1.mJammerGal = atoi(mField[eJammerGal]);
+        mM1.mRecErrorRecovery = atoi(mField[eRecErrorRecovery]);
+        mM1.mAgcGps = atof(mField[eAgcGps]);
+        mM1.mAgcGlo = atof(mField[eAgcGlo]);
+        mM1.mAgcBds = atof(mField[eAgcBds]);
+        mM1.mAgcGal = atof(mField[eAgcGal]);
+        if (mFieldCount > eLeapSecUnc) {
+            mM1.mLeapSeconds = atoi(mField[eLeapSeconds]);
+            mM1.mLeapSecUnc = atoi(mField[eLeapSecUnc]);
         }
-        if (mField.size() > eGalBpAmpQ) {
-            mM1.mGloBpAmpI = atoi(mField[eGloBpAmpI].c_str());
-            mM1.mGloBpAmpQ = atoi(mField[eGloBpAmpQ].c_str());
-            mM1.mBdsBpAmpI = atoi(mField[eBdsBpAmpI].c_str());
-            mM1.mBdsBpAmpQ = atoi(mField[eBdsBpAmpQ].c_str());
-            mM1.mGalBpAmpI = atoi(mField[eGalBpAmpI].c_str());
-            mM1.mGalBpAmpQ = atoi(mField[eGalBpAmpQ].c_str());
+        if (mFieldCount > eGalBpAmpQ) {
+            mM1.mGloBpAmpI = atoi(mField[eGloBpAmpI]);
+            mM1.mGloBpAmpQ = atoi(mField[eGloBpAmpQ]);
+            mM1.mBdsBpAmpI = atoi(mField[eBdsBpAmpI]);
+            mM1.mBdsBpAmpQ = atoi(mField[eBdsBpAmpQ]);
+            mM1.mGalBpAmpI = atoi(mField[eGalBpAmpI]);
+            mM1.mGalBpAmpQ = atoi(mField[eGalBpAmpQ]);
         }
-        if (mField.size() > eTimeUncNs) {
-            mM1.mTimeUncNs = strtoull(mField[eTimeUncNs].c_str(), nullptr, 10);
+        if (mFieldCount > eTimeUncNs) {
+            mM1.mTimeUncNs = strtoull(mField[eTimeUncNs], nullptr, 10);
         }
     }
 
@@ -301,17 +305,17 @@ public:
     SystemStatusPQWP1parser(const char *str_in, uint32_t len_in)
         : SystemStatusNmeaBase(str_in, len_in)
     {
-        if (mField.size() < eMax) {
+        if (mFieldCount < eMax) {
             return;
         }
         memset(&mP1, 0, sizeof(mP1));
-        mP1.mEpiValidity = strtol(mField[eEpiValidity].c_str(), NULL, 16);
-        mP1.mEpiLat = atof(mField[eEpiLat].c_str());
-        mP1.mEpiLon = atof(mField[eEpiLon].c_str());
-        mP1.mEpiAlt = atof(mField[eEpiAlt].c_str());
-        mP1.mEpiHepe = atoi(mField[eEpiHepe].c_str());
-        mP1.mEpiAltUnc = atof(mField[eEpiAltUnc].c_str());
-        mP1.mEpiSrc = atoi(mField[eEpiSrc].c_str());
+        mP1.mEpiValidity = strtol(mField[eEpiValidity], NULL, 16);
+        mP1.mEpiLat = atof(mField[eEpiLat]);
+        mP1.mEpiLon = atof(mField[eEpiLon]);
+        mP1.mEpiAlt = atof(mField[eEpiAlt]);
+        mP1.mEpiHepe = atoi(mField[eEpiHepe]);
+        mP1.mEpiAltUnc = atof(mField[eEpiAltUnc]);
+        mP1.mEpiSrc = atoi(mField[eEpiSrc]);
     }
 
     inline SystemStatusPQWP1& get() { return mP1;}
@@ -356,15 +360,15 @@ public:
     SystemStatusPQWP2parser(const char *str_in, uint32_t len_in)
         : SystemStatusNmeaBase(str_in, len_in)
     {
-        if (mField.size() < eMax) {
+        if (mFieldCount < eMax) {
             return;
         }
         memset(&mP2, 0, sizeof(mP2));
-        mP2.mBestLat = atof(mField[eBestLat].c_str());
-        mP2.mBestLon = atof(mField[eBestLon].c_str());
-        mP2.mBestAlt = atof(mField[eBestAlt].c_str());
-        mP2.mBestHepe = atof(mField[eBestHepe].c_str());
-        mP2.mBestAltUnc = atof(mField[eBestAltUnc].c_str());
+        mP2.mBestLat = atof(mField[eBestLat]);
+        mP2.mBestLon = atof(mField[eBestLon]);
+        mP2.mBestAlt = atof(mField[eBestAlt]);
+        mP2.mBestHepe = atof(mField[eBestHepe]);
+        mP2.mBestAltUnc = atof(mField[eBestAltUnc]);
     }
 
     inline SystemStatusPQWP2& get() { return mP2;}
@@ -432,22 +436,22 @@ public:
     SystemStatusPQWP3parser(const char *str_in, uint32_t len_in)
         : SystemStatusNmeaBase(str_in, len_in)
     {
-        if (mField.size() < eMax) {
+        if (mFieldCount < eMax) {
             return;
         }
         memset(&mP3, 0, sizeof(mP3));
         // todo: update for navic once available
-        mP3.mXtraValidMask = strtol(mField[eXtraValidMask].c_str(), NULL, 16);
-        mP3.mGpsXtraAge = atoi(mField[eGpsXtraAge].c_str());
-        mP3.mGloXtraAge = atoi(mField[eGloXtraAge].c_str());
-        mP3.mBdsXtraAge = atoi(mField[eBdsXtraAge].c_str());
-        mP3.mGalXtraAge = atoi(mField[eGalXtraAge].c_str());
-        mP3.mQzssXtraAge = atoi(mField[eQzssXtraAge].c_str());
-        mP3.mGpsXtraValid = strtol(mField[eGpsXtraValid].c_str(), NULL, 16);
-        mP3.mGloXtraValid = strtol(mField[eGloXtraValid].c_str(), NULL, 16);
-        mP3.mBdsXtraValid = strtol(mField[eBdsXtraValid].c_str(), NULL, 16);
-        mP3.mGalXtraValid = strtol(mField[eGalXtraValid].c_str(), NULL, 16);
-        mP3.mQzssXtraValid = strtol(mField[eQzssXtraValid].c_str(), NULL, 16);
+        mP3.mXtraValidMask = strtol(mField[eXtraValidMask], NULL, 16);
+        mP3.mGpsXtraAge = atoi(mField[eGpsXtraAge]);
+        mP3.mGloXtraAge = atoi(mField[eGloXtraAge]);
+        mP3.mBdsXtraAge = atoi(mField[eBdsXtraAge]);
+        mP3.mGalXtraAge = atoi(mField[eGalXtraAge]);
+        mP3.mQzssXtraAge = atoi(mField[eQzssXtraAge]);
+        mP3.mGpsXtraValid = strtol(mField[eGpsXtraValid], NULL, 16);
+        mP3.mGloXtraValid = strtol(mField[eGloXtraValid], NULL, 16);
+        mP3.mBdsXtraValid = strtol(mField[eBdsXtraValid], NULL, 16);
+        mP3.mGalXtraValid = strtol(mField[eGalXtraValid], NULL, 16);
+        mP3.mQzssXtraValid = strtol(mField[eQzssXtraValid], NULL, 16);
     }
 
     inline SystemStatusPQWP3& get() { return mP3;}
@@ -492,15 +496,15 @@ public:
     SystemStatusPQWP4parser(const char *str_in, uint32_t len_in)
         : SystemStatusNmeaBase(str_in, len_in)
     {
-        if (mField.size() < eMax) {
+        if (mFieldCount < eMax) {
             return;
         }
         memset(&mP4, 0, sizeof(mP4));
-        mP4.mGpsEpheValid = strtol(mField[eGpsEpheValid].c_str(), NULL, 16);
-        mP4.mGloEpheValid = strtol(mField[eGloEpheValid].c_str(), NULL, 16);
-        mP4.mBdsEpheValid = strtol(mField[eBdsEpheValid].c_str(), NULL, 16);
-        mP4.mGalEpheValid = strtol(mField[eGalEpheValid].c_str(), NULL, 16);
-        mP4.mQzssEpheValid = strtol(mField[eQzssEpheValid].c_str(), NULL, 16);
+        mP4.mGpsEpheValid = strtol(mField[eGpsEpheValid], NULL, 16);
+        mP4.mGloEpheValid = strtol(mField[eGloEpheValid], NULL, 16);
+        mP4.mBdsEpheValid = strtol(mField[eBdsEpheValid], NULL, 16);
+        mP4.mGalEpheValid = strtol(mField[eGalEpheValid], NULL, 16);
+        mP4.mQzssEpheValid = strtol(mField[eQzssEpheValid], NULL, 16);
     }
 
     inline SystemStatusPQWP4& get() { return mP4;}
@@ -582,26 +586,26 @@ public:
     SystemStatusPQWP5parser(const char *str_in, uint32_t len_in)
         : SystemStatusNmeaBase(str_in, len_in)
     {
-        if (mField.size() < eMax) {
+        if (mFieldCount < eMax) {
             return;
         }
         memset(&mP5, 0, sizeof(mP5));
         // todo: update for navic once available
-        mP5.mGpsUnknownMask = strtol(mField[eGpsUnknownMask].c_str(), NULL, 16);
-        mP5.mGloUnknownMask = strtol(mField[eGloUnknownMask].c_str(), NULL, 16);
-        mP5.mBdsUnknownMask = strtol(mField[eBdsUnknownMask].c_str(), NULL, 16);
-        mP5.mGalUnknownMask = strtol(mField[eGalUnknownMask].c_str(), NULL, 16);
-        mP5.mQzssUnknownMask = strtol(mField[eQzssUnknownMask].c_str(), NULL, 16);
-        mP5.mGpsGoodMask = strtol(mField[eGpsGoodMask].c_str(), NULL, 16);
-        mP5.mGloGoodMask = strtol(mField[eGloGoodMask].c_str(), NULL, 16);
-        mP5.mBdsGoodMask = strtol(mField[eBdsGoodMask].c_str(), NULL, 16);
-        mP5.mGalGoodMask = strtol(mField[eGalGoodMask].c_str(), NULL, 16);
-        mP5.mQzssGoodMask = strtol(mField[eQzssGoodMask].c_str(), NULL, 16);
-        mP5.mGpsBadMask = strtol(mField[eGpsBadMask].c_str(), NULL, 16);
-        mP5.mGloBadMask = strtol(mField[eGloBadMask].c_str(), NULL, 16);
-        mP5.mBdsBadMask = strtol(mField[eBdsBadMask].c_str(), NULL, 16);
-        mP5.mGalBadMask = strtol(mField[eGalBadMask].c_str(), NULL, 16);
-        mP5.mQzssBadMask = strtol(mField[eQzssBadMask].c_str(), NULL, 16);
+        mP5.mGpsUnknownMask = strtol(mField[eGpsUnknownMask], NULL, 16);
+        mP5.mGloUnknownMask = strtol(mField[eGloUnknownMask], NULL, 16);
+        mP5.mBdsUnknownMask = strtol(mField[eBdsUnknownMask], NULL, 16);
+        mP5.mGalUnknownMask = strtol(mField[eGalUnknownMask], NULL, 16);
+        mP5.mQzssUnknownMask = strtol(mField[eQzssUnknownMask], NULL, 16);
+        mP5.mGpsGoodMask = strtol(mField[eGpsGoodMask], NULL, 16);
+        mP5.mGloGoodMask = strtol(mField[eGloGoodMask], NULL, 16);
+        mP5.mBdsGoodMask = strtol(mField[eBdsGoodMask], NULL, 16);
+        mP5.mGalGoodMask = strtol(mField[eGalGoodMask], NULL, 16);
+        mP5.mQzssGoodMask = strtol(mField[eQzssGoodMask], NULL, 16);
+        mP5.mGpsBadMask = strtol(mField[eGpsBadMask], NULL, 16);
+        mP5.mGloBadMask = strtol(mField[eGloBadMask], NULL, 16);
+        mP5.mBdsBadMask = strtol(mField[eBdsBadMask], NULL, 16);
+        mP5.mGalBadMask = strtol(mField[eGalBadMask], NULL, 16);
+        mP5.mQzssBadMask = strtol(mField[eQzssBadMask], NULL, 16);
     }
 
     inline SystemStatusPQWP5& get() { return mP5;}
@@ -634,11 +638,11 @@ public:
     SystemStatusPQWP6parser(const char *str_in, uint32_t len_in)
         : SystemStatusNmeaBase(str_in, len_in)
     {
-        if (mField.size() < eMax) {
+        if (mFieldCount < eMax) {
             return;
         }
         memset(&mP6, 0, sizeof(mP6));
-        mP6.mFixInfoMask = strtol(mField[eFixInfoMask].c_str(), NULL, 16);
+        mP6.mFixInfoMask = strtol(mField[eFixInfoMask], NULL, 16);
     }
 
     inline SystemStatusPQWP6& get() { return mP6;}
@@ -670,20 +674,20 @@ public:
         : SystemStatusNmeaBase(str_in, len_in)
     {
         uint32_t svLimit = SV_ALL_NUM;
-        if (mField.size() < eMin) {
-            LOC_LOGE("PQWP7parser - invalid size=%zu", mField.size());
+        if (mFieldCount < eMin) {
+            LOC_LOGE("PQWP7parser - invalid size=%u", mFieldCount);
             return;
         }
-        if (mField.size() < eMax) {
+        if (mFieldCount < eMax) {
             // Try reducing limit, accounting for possibly missing NAVIC support
             svLimit = SV_ALL_NUM_MIN;
         }
 
         memset(mP7.mNav, 0, sizeof(mP7.mNav));
         for (uint32_t i=0; i<svLimit; i++) {
-            mP7.mNav[i].mType   = GnssEphemerisType(atoi(mField[i*3+2].c_str()));
-            mP7.mNav[i].mSource = GnssEphemerisSource(atoi(mField[i*3+3].c_str()));
-            mP7.mNav[i].mAgeSec = atoi(mField[i*3+4].c_str());
+            mP7.mNav[i].mType   = GnssEphemerisType(atoi(mField[i*3+2]));
+            mP7.mNav[i].mSource = GnssEphemerisSource(atoi(mField[i*3+3]));
+            mP7.mNav[i].mAgeSec = atoi(mField[i*3+4]);
         }
     }
 
@@ -720,12 +724,12 @@ public:
     SystemStatusPQWS1parser(const char *str_in, uint32_t len_in)
         : SystemStatusNmeaBase(str_in, len_in)
     {
-        if (mField.size() < eMax) {
+        if (mFieldCount < eMax) {
             return;
         }
         memset(&mS1, 0, sizeof(mS1));
-        mS1.mFixInfoMask = atoi(mField[eFixInfoMask].c_str());
-        mS1.mHepeLimit = atoi(mField[eHepeLimit].c_str());
+        mS1.mFixInfoMask = atoi(mField[eFixInfoMask]);
+        mS1.mHepeLimit = atoi(mField[eHepeLimit]);
     }
 
     inline SystemStatusPQWS1& get() { return mS1;}
@@ -1337,6 +1341,8 @@ SystemStatus::SystemStatus(const MsgTask* msgTask) :
     mCache.mBtDeviceScanDetail.clear();
     mCache.mBtLeDeviceScanDetail.clear();
 
+    mSnapshot = std::make_shared<SystemStatusReports>(mCache);
+
     EXIT_LOG_WITH_ERROR ("%d",result);
 }
 
@@ -1346,17 +1352,17 @@ SystemStatus::SystemStatus(const MsgTask* msgTask) :
 template <typename TYPE_REPORT, typename TYPE_ITEM>
 bool SystemStatus::setIteminReport(TYPE_REPORT& report, TYPE_ITEM&& s)
 {
-    if (!report.empty() && report.back().equals(static_cast<TYPE_ITEM&>(s.collate(report.back())))) {
-        // there is no change - just update reported timestamp
-        report.back().mUtcReported = s.mUtcReported;
+    const TYPE_REPORT& cur = report;
+    if (!cur.empty() &&
+            static_cast<TYPE_ITEM&>(s.collate(report.backUnstamped())).equals(cur.back())) {
+        // there is no change - just update reported timestamp, the ring keeps
+        // its stamp so readers are not republished for it
+        report.backUnstamped().mUtcReported = s.mUtcReported;
         return false;
     }
 
-    // first event or updated
+    // first event or updated, the ring drops the oldest item once full
     report.push_back(s);
-    if (report.size() > s.maxItem) {
-        report.erase(report.begin());
-    }
     return true;
 }
 
@@ -1364,9 +1370,6 @@ template <typename TYPE_REPORT, typename TYPE_ITEM>
 void SystemStatus::setDefaultIteminReport(TYPE_REPORT& report, const TYPE_ITEM& s)
 {
     report.push_back(s);
-    if (report.size() > s.maxItem) {
-        report.erase(report.begin());
-    }
 }
 
 template <typename TYPE_REPORT, typename TYPE_ITEM>
@@ -1379,6 +1382,29 @@ void SystemStatus::getIteminReport(TYPE_REPORT& reportout, const TYPE_ITEM& c) c
     }
 }
 
+/******************************************************************************
+@brief      Publish mCache to getReport() readers, called with
+            mMutexSystemStatus held after each update.
+
+            Readers take their own reference to the published copy, so the
+            copy replaced here is refilled in place the next time round only
+            if the last reader has since dropped it, otherwise a new one is
+            allocated and the old one goes away with its last reader.
+******************************************************************************/
+void SystemStatus::publishReport()
+{
+    std::shared_ptr<SystemStatusReports> next;
+    if (mSpare.use_count() == 1) {
+        // pairs with the release of the last reader's reference
+        std::atomic_thread_fence(std::memory_order_acquire);
+        next = std::move(mSpare);
+        *next = mCache;
+    } else {
+        next = std::make_shared<SystemStatusReports>(mCache);
+    }
+    mSpare = std::atomic_exchange(&mSnapshot, next);
+}
+
 /******************************************************************************
 @brief      API to set report data into internal buffer
 
@@ -1393,53 +1419,67 @@ bool SystemStatus::setNmeaString(const char *data, uint32_t len)
         return false;
     }
 
-    char buf[SystemStatusNmeaBase::NMEA_MAXSIZE + 1] = { 0 };
-    strlcpy(buf, data, sizeof(buf));
+    // one entry per sentence tag; the parsers tokenize data in place
+    typedef bool (*NmeaHandler)(SystemStatus& status, const char* data, uint32_t len);
+    static const struct {
+        char tag[SystemStatusNmeaBase::NMEA_MINSIZE + 1];
+        NmeaHandler handler;
+    } sNmeaHandlers[] = {
+        { "$PQWM1", [](SystemStatus& status, const char* data, uint32_t len) -> bool {
+            SystemStatusPQWM1 s = SystemStatusPQWM1parser(data, len).get();
+            bool changed = status.setIteminReport(status.mCache.mTimeAndClock,
+                    SystemStatusTimeAndClock(s));
+            changed |= status.setIteminReport(status.mCache.mXoState, SystemStatusXoState(s));
+            changed |= status.setIteminReport(status.mCache.mRfAndParams,
+                    SystemStatusRfAndParams(s));
+            changed |= status.setIteminReport(status.mCache.mErrRecovery,
+                    SystemStatusErrRecovery(s));
+            return changed;
+        } },
+        { "$PQWP1", [](SystemStatus& status, const char* data, uint32_t len) -> bool {
+            return status.setIteminReport(status.mCache.mInjectedPosition,
+                    SystemStatusInjectedPosition(SystemStatusPQWP1parser(data, len).get()));
+        } },
+        { "$PQWP2", [](SystemStatus& status, const char* data, uint32_t len) -> bool {
+            return status.setIteminReport(status.mCache.mBestPosition,
+                    SystemStatusBestPosition(SystemStatusPQWP2parser(data, len).get()));
+        } },
+        { "$PQWP3", [](SystemStatus& status, const char* data, uint32_t len) -> bool {
+            return status.setIteminReport(status.mCache.mXtra,
+                    SystemStatusXtra(SystemStatusPQWP3parser(data, len).get()));
+        } },
+        { "$PQWP4", [](SystemStatus& status, const char* data, uint32_t len) -> bool {
+            return status.setIteminReport(status.mCache.mEphemeris,
+                    SystemStatusEphemeris(SystemStatusPQWP4parser(data, len).get()));
+        } },
+        { "$PQWP5", [](SystemStatus& status, const char* data, uint32_t len) -> bool {
+            return status.setIteminReport(status.mCache.mSvHealth,
+                    SystemStatusSvHealth(SystemStatusPQWP5parser(data, len).get()));
+        } },
+        { "$PQWP6", [](SystemStatus& status, const char* data, uint32_t len) -> bool {
+            return status.setIteminReport(status.mCache.mPdr,
+                    SystemStatusPdr(SystemStatusPQWP6parser(data, len).get()));
+        } },
+        { "$PQWP7", [](SystemStatus& status, const char* data, uint32_t len) -> bool {
+            return status.setIteminReport(status.mCache.mNavData,
+                    SystemStatusNavData(SystemStatusPQWP7parser(data, len).get()));
+        } },
+        { "$PQWS1", [](SystemStatus& status, const char* data, uint32_t len) -> bool {
+            return status.setIteminReport(status.mCache.mPositionFailure,
+                    SystemStatusPositionFailure(SystemStatusPQWS1parser(data, len).get()));
+        } },
+    };
 
     pthread_mutex_lock(&mMutexSystemStatus);
 
-    // parse the received nmea strings here
-    if (0 == strncmp(data, "$PQWM1", SystemStatusNmeaBase::NMEA_MINSIZE)) {
-        SystemStatusPQWM1 s = SystemStatusPQWM1parser(buf, len).get();
-        setIteminReport(mCache.mTimeAndClock, SystemStatusTimeAndClock(s));
-        setIteminReport(mCache.mXoState, SystemStatusXoState(s));
-        setIteminReport(mCache.mRfAndParams, SystemStatusRfAndParams(s));
-        setIteminReport(mCache.mErrRecovery, SystemStatusErrRecovery(s));
-    }
-    else if (0 == strncmp(data, "$PQWP1", SystemStatusNmeaBase::NMEA_MINSIZE)) {
-        setIteminReport(mCache.mInjectedPosition,
-                SystemStatusInjectedPosition(SystemStatusPQWP1parser(buf, len).get()));
-    }
-    else if (0 == strncmp(data, "$PQWP2", SystemStatusNmeaBase::NMEA_MINSIZE)) {
-        setIteminReport(mCache.mBestPosition,
-                SystemStatusBestPosition(SystemStatusPQWP2parser(buf, len).get()));
-    }
-    else if (0 == strncmp(data, "$PQWP3", SystemStatusNmeaBase::NMEA_MINSIZE)) {
-        setIteminReport(mCache.mXtra,
-                SystemStatusXtra(SystemStatusPQWP3parser(buf, len).get()));
-    }
-    else if (0 == strncmp(data, "$PQWP4", SystemStatusNmeaBase::NMEA_MINSIZE)) {
-        setIteminReport(mCache.mEphemeris,
-                SystemStatusEphemeris(SystemStatusPQWP4parser(buf, len).get()));
-    }
-    else if (0 == strncmp(data, "$PQWP5", SystemStatusNmeaBase::NMEA_MINSIZE)) {
-        setIteminReport(mCache.mSvHealth,
-                SystemStatusSvHealth(SystemStatusPQWP5parser(buf, len).get()));
-    }
-    else if (0 == strncmp(data, "$PQWP6", SystemStatusNmeaBase::NMEA_MINSIZE)) {
-        setIteminReport(mCache.mPdr,
-                SystemStatusPdr(SystemStatusPQWP6parser(buf, len).get()));
-    }
-    else if (0 == strncmp(data, "$PQWP7", SystemStatusNmeaBase::NMEA_MINSIZE)) {
-        setIteminReport(mCache.mNavData,
-                SystemStatusNavData(SystemStatusPQWP7parser(buf, len).get()));
-    }
-    else if (0 == strncmp(data, "$PQWS1", SystemStatusNmeaBase::NMEA_MINSIZE)) {
-        setIteminReport(mCache.mPositionFailure,
-                SystemStatusPositionFailure(SystemStatusPQWS1parser(buf, len).get()));
-    }
-    else {
-        // do nothing
+    // parse the received nmea strings here, unknown tags are ignored
+    for (uint32_t i = 0; i < sizeof(sNmeaHandlers) / sizeof(sNmeaHandlers[0]); i++) {
+        if (0 == memcmp(data, sNmeaHandlers[i].tag, SystemStatusNmeaBase::NMEA_MINSIZE)) {
+            if (sNmeaHandlers[i].handler(*this, data, len)) {
+                publishReport();
+            }
+            break;
+        }
     }
 
     pthread_mutex_unlock(&mMutexSystemStatus);
@@ -1466,6 +1506,9 @@ bool SystemStatus::eventPosition(const UlpLocation& location,
              location.gpsLocation.altitude,
              location.gpsLocation.speed);
 
+    if (ret) {
+        publishReport();
+    }
     pthread_mutex_unlock(&mMutexSystemStatus);
     return ret;
 }
@@ -1574,6 +1617,9 @@ bool SystemStatus::eventDataItemNotify(IDataItemCore* dataitem)
         default:
             break;
     }
+    if (ret) {
+        publishReport();
+    }
     pthread_mutex_unlock(&mMutexSystemStatus);
     return ret;
 }
@@ -1588,96 +1634,56 @@ bool SystemStatus::eventDataItemNotify(IDataItemCore* dataitem)
 ******************************************************************************/
 bool SystemStatus::getReport(SystemStatusReports& report, bool isLatestOnly) const
 {
-    pthread_mutex_lock(&mMutexSystemStatus);
+    // readers only hold the published copy, writers are never blocked
+    std::shared_ptr<const SystemStatusReports> cache = std::atomic_load(&mSnapshot);
 
     if (isLatestOnly) {
         // push back only the latest report and return it
-        getIteminReport(report.mLocation, mCache.mLocation);
-
-        getIteminReport(report.mTimeAndClock, mCache.mTimeAndClock);
-        getIteminReport(report.mXoState, mCache.mXoState);
-        getIteminReport(report.mRfAndParams, mCache.mRfAndParams);
-        getIteminReport(report.mErrRecovery, mCache.mErrRecovery);
-
-        getIteminReport(report.mInjectedPosition, mCache.mInjectedPosition);
-        getIteminReport(report.mBestPosition, mCache.mBestPosition);
-        getIteminReport(report.mXtra, mCache.mXtra);
-        getIteminReport(report.mEphemeris, mCache.mEphemeris);
-        getIteminReport(report.mSvHealth, mCache.mSvHealth);
-        getIteminReport(report.mPdr, mCache.mPdr);
-        getIteminReport(report.mNavData, mCache.mNavData);
-
-        getIteminReport(report.mPositionFailure, mCache.mPositionFailure);
-
-        getIteminReport(report.mAirplaneMode, mCache.mAirplaneMode);
-        getIteminReport(report.mENH, mCache.mENH);
-        getIteminReport(report.mGPSState, mCache.mGPSState);
-        getIteminReport(report.mNLPStatus, mCache.mNLPStatus);
-        getIteminReport(report.mWifiHardwareState, mCache.mWifiHardwareState);
-        getIteminReport(report.mNetworkInfo, mCache.mNetworkInfo);
-        getIteminReport(report.mRilServiceInfo, mCache.mRilServiceInfo);
-        getIteminReport(report.mRilCellInfo, mCache.mRilCellInfo);
-        getIteminReport(report.mServiceStatus, mCache.mServiceStatus);
-        getIteminReport(report.mModel, mCache.mModel);
-        getIteminReport(report.mManufacturer, mCache.mManufacturer);
-        getIteminReport(report.mAssistedGps, mCache.mAssistedGps);
-        getIteminReport(report.mScreenState, mCache.mScreenState);
-        getIteminReport(report.mPowerConnectState, mCache.mPowerConnectState);
-        getIteminReport(report.mTimeZoneChange, mCache.mTimeZoneChange);
-        getIteminReport(report.mTimeChange, mCache.mTimeChange);
-        getIteminReport(report.mWifiSupplicantStatus, mCache.mWifiSupplicantStatus);
-        getIteminReport(report.mShutdownState, mCache.mShutdownState);
-        getIteminReport(report.mTac, mCache.mTac);
-        getIteminReport(report.mMccMnc, mCache.mMccMnc);
-        getIteminReport(report.mBtDeviceScanDetail, mCache.mBtDeviceScanDetail);
-        getIteminReport(report.mBtLeDeviceScanDetail, mCache.mBtLeDeviceScanDetail);
+        getIteminReport(report.mLocation, cache->mLocation);
+
+        getIteminReport(report.mTimeAndClock, cache->mTimeAndClock);
+        getIteminReport(report.mXoState, cache->mXoState);
+        getIteminReport(report.mRfAndParams, cache->mRfAndParams);
+        getIteminReport(report.mErrRecovery, cache->mErrRecovery);
+
+        getIteminReport(report.mInjectedPosition, cache->mInjectedPosition);
+        getIteminReport(report.mBestPosition, cache->mBestPosition);
+        getIteminReport(report.mXtra, cache->mXtra);
+        getIteminReport(report.mEphemeris, cache->mEphemeris);
+        getIteminReport(report.mSvHealth, cache->mSvHealth);
+        getIteminReport(report.mPdr, cache->mPdr);
+        getIteminReport(report.mNavData, cache->mNavData);
+
+        getIteminReport(report.mPositionFailure, cache->mPositionFailure);
+
+        getIteminReport(report.mAirplaneMode, cache->mAirplaneMode);
+        getIteminReport(report.mENH, cache->mENH);
+        getIteminReport(report.mGPSState, cache->mGPSState);
+        getIteminReport(report.mNLPStatus, cache->mNLPStatus);
+        getIteminReport(report.mWifiHardwareState, cache->mWifiHardwareState);
+        getIteminReport(report.mNetworkInfo, cache->mNetworkInfo);
+        getIteminReport(report.mRilServiceInfo, cache->mRilServiceInfo);
+        getIteminReport(report.mRilCellInfo, cache->mRilCellInfo);
+        getIteminReport(report.mServiceStatus, cache->mServiceStatus);
+        getIteminReport(report.mModel, cache->mModel);
+        getIteminReport(report.mManufacturer, cache->mManufacturer);
+        getIteminReport(report.mAssistedGps, cache->mAssistedGps);
+        getIteminReport(report.mScreenState, cache->mScreenState);
+        getIteminReport(report.mPowerConnectState, cache->mPowerConnectState);
+        getIteminReport(report.mTimeZoneChange, cache->mTimeZoneChange);
+        getIteminReport(report.mTimeChange, cache->mTimeChange);
+        getIteminReport(report.mWifiSupplicantStatus, cache->mWifiSupplicantStatus);
+        getIteminReport(report.mShutdownState, cache->mShutdownState);
+        getIteminReport(report.mTac, cache->mTac);
+        getIteminReport(report.mMccMnc, cache->mMccMnc);
+        getIteminReport(report.mBtDeviceScanDetail, cache->mBtDeviceScanDetail);
+        getIteminReport(report.mBtLeDeviceScanDetail, cache->mBtLeDeviceScanDetail);
     }
     else {
         // copy entire reports and return them
-        report.mLocation.clear();
-
-        report.mTimeAndClock.clear();
-        report.mXoState.clear();
-        report.mRfAndParams.clear();
-        report.mErrRecovery.clear();
-
-        report.mInjectedPosition.clear();
-        report.mBestPosition.clear();
-        report.mXtra.clear();
-        report.mEphemeris.clear();
-        report.mSvHealth.clear();
-        report.mPdr.clear();
-        report.mNavData.clear();
-
-        report.mPositionFailure.clear();
-
-        report.mAirplaneMode.clear();
-        report.mENH.clear();
-        report.mGPSState.clear();
-        report.mNLPStatus.clear();
-        report.mWifiHardwareState.clear();
-        report.mNetworkInfo.clear();
-        report.mRilServiceInfo.clear();
-        report.mRilCellInfo.clear();
-        report.mServiceStatus.clear();
-        report.mModel.clear();
-        report.mManufacturer.clear();
-        report.mAssistedGps.clear();
-        report.mScreenState.clear();
-        report.mPowerConnectState.clear();
-        report.mTimeZoneChange.clear();
-        report.mTimeChange.clear();
-        report.mWifiSupplicantStatus.clear();
-        report.mShutdownState.clear();
-        report.mTac.clear();
-        report.mMccMnc.clear();
-        report.mBtDeviceScanDetail.clear();
-        report.mBtLeDeviceScanDetail.clear();
-
-        report = mCache;
+        report = *cache;
     }
 
-    pthread_mutex_unlock(&mMutexSystemStatus);
     return true;
 }
 
@@ -1709,6 +1715,7 @@ bool SystemStatus::setDefaultGnssEngineStates(void)
 
     setDefaultIteminReport(mCache.mPositionFailure, SystemStatusPositionFailure());
 
+    publishReport();
     pthread_mutex_unlock(&mMutexSystemStatus);
     return true;
 }
@@ -1746,3 +1753,254 @@ bool SystemStatus::updatePowerConnectState(bool charging)
 }
 } // namespace loc_core
 
+
+#ifdef __LOC_DEBUG__
+
+// For Linux command line benchmarking of the debug NMEA parsers, with
+// __LOC_DEBUG__ set for SystemStatus.cpp only, as other sources have debug
+// mains of their own:
+//     FLAGS="-DUSE_GLIB -DFEATURE_EXTERNAL_AP -DOFF_TARGET -O2 -I. -Idata-items
+//         -Iobserver -I../utils -I../pla/oe -I../location"
+//     g++ $FLAGS -std=c++11 -c SystemStatusOsObserver.cpp
+//         data-items/DataItemsFactoryProxy.cpp ../utils/loc_log.cpp ../utils/MsgTask.cpp
+//         ../utils/LocThread.cpp ../utils/LocMpscQueue.cpp ../utils/LocTimer.cpp
+//         ../utils/LocHeap.cpp ../utils/loc_misc_utils.cpp
+//     gcc $FLAGS -c ../utils/msg_q.c ../utils/linked_list.c
+//     g++ -D__LOC_DEBUG__ $FLAGS -std=c++11 -o pqw_bench SystemStatus.cpp *.o
+//         -lpthread -ldl
+// (loc_cfg.cpp is left out, add a loc_get_datum_type() stub to the last step)
+//     ./pqw_bench <rounds>
+// "legacy" is the substr() based tokenizer the parsers used to run on, kept
+// here as the reference the in place tokenizer is checked against. The run
+// ends with a stress test of the report writers against a getReport() poller.
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+
+using namespace loc_core;
+
+static inline uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static std::string benchSentence(const std::string& body) {
+    uint8_t checksum = 0;
+    char tail[8];
+    for (size_t i = 1; i < body.length(); i++) {
+        checksum ^= (uint8_t)body[i];
+    }
+    snprintf(tail, sizeof(tail), "*%02X\r\n", checksum);
+    return body + tail;
+}
+
+static std::vector<std::string> legacyTokenize(const char *str_in) {
+    std::vector<std::string> field;
+    std::string parser(str_in);
+    std::string::size_type index = parser.find("*");
+    if (index == std::string::npos) {
+        return field;
+    }
+    parser[index] = ',';
+    while (1) {
+        index = parser.find(",");
+        if (index == std::string::npos) {
+            break;
+        }
+        field.push_back(parser.substr(0, index));
+        parser = parser.substr(index + 1);
+    }
+    return field;
+}
+
+class BenchTokenizer : public SystemStatusNmeaBase {
+public:
+    BenchTokenizer(const char *str_in, uint32_t len_in) :
+        SystemStatusNmeaBase(str_in, len_in) {}
+    inline uint32_t getCount() const { return mFieldCount; }
+    inline std::string getField(uint32_t i) const {
+        return std::string(mField[i], strcspn(mField[i], ",*"));
+    }
+};
+
+// getReport() poller for the report stress test below
+struct BenchReader {
+    SystemStatus* status;
+    bool latestOnly;
+    std::atomic<bool> stop;
+    uint64_t polls;
+};
+
+static void* benchReaderLoop(void* arg) {
+    BenchReader* reader = (BenchReader*)arg;
+    SystemStatusReports* reports = new SystemStatusReports();
+    while (!reader->stop.load(std::memory_order_relaxed)) {
+        reader->status->getReport(*reports, reader->latestOnly);
+        reader->polls++;
+    }
+    delete reports;
+    return NULL;
+}
+
+// writer latency over one epoch of debug NMEA plus a position report per
+// round, with a reader polling getReport() as fast as it can when given
+static void benchWriters(SystemStatus* status, const std::vector<std::string>& sentences,
+                         uint32_t rounds, BenchReader* reader, const char* name) {
+    pthread_t thread;
+    if (NULL != reader) {
+        reader->stop = false;
+        reader->polls = 0;
+        pthread_create(&thread, NULL, benchReaderLoop, reader);
+    }
+
+    UlpLocation location = {};
+    GpsLocationExtended locationEx = {};
+    std::vector<uint64_t> latency;
+    latency.reserve(rounds * (sentences.size() + 1));
+    uint64_t start = nowNs();
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (auto& s : sentences) {
+            uint64_t t0 = nowNs();
+            status->setNmeaString(s.c_str(), s.length());
+            latency.push_back(nowNs() - t0);
+        }
+        location.gpsLocation.latitude = 37.0 + r * 1e-6;
+        uint64_t t0 = nowNs();
+        status->eventPosition(location, locationEx);
+        latency.push_back(nowNs() - t0);
+    }
+    uint64_t elapsed = nowNs() - start;
+
+    if (NULL != reader) {
+        reader->stop = true;
+        pthread_join(thread, NULL);
+    }
+    std::sort(latency.begin(), latency.end());
+    printf("%-22s writer p50 %6.2f us, p99 %8.2f us, max %9.2f us; %8.0f reader polls/s\n",
+           name, latency[latency.size() / 2] / 1e3, latency[latency.size() * 99 / 100] / 1e3,
+           latency.back() / 1e3, (NULL != reader) ? reader->polls * 1e9 / elapsed : 0.0);
+}
+
+int main(int argc, char** argv) {
+    uint32_t rounds = (argc > 1) ? atoi(argv[1]) : 20000;
+
+    // as logged by the modem, one of each debug sentence per second
+    std::vector<std::string> sentences;
+    sentences.push_back(benchSentence("$PQWM1,2112,345678000,1,3,12,-512,25,2,-3,120,118,"
+            "55,-60,3,2,1,4,0,2.31,2.45,2.10,2.52,18,0,110,108,95,97,101,99,1500"));
+    sentences.push_back(benchSentence("$PQWP1,123519.00,1,37.386052,-122.083851,12.5,"
+            "25,4.0,7"));
+    sentences.push_back(benchSentence("$PQWP2,123519.00,37.386091,-122.083812,11.9,8.5,3.2"));
+    sentences.push_back(benchSentence("$PQWP3,123519.00,1F,12,12,36,36,12,FFFFFFFF,FFFFFF,"
+            "1FFFFFFFFF,FFFFFFFFF,1F"));
+    sentences.push_back(benchSentence("$PQWP4,123519.00,FFFFFFFF,FFFFFF,3FFFFFFFFF,"
+            "FFFFFFFFF,1F"));
+    sentences.push_back(benchSentence("$PQWP5,123519.00,0,0,0,0,0,FFFFFFFB,FFFFFF,"
+            "3FFFFFFFFF,FFFFFFFFF,1F,4,0,0,0,0"));
+    sentences.push_back(benchSentence("$PQWP6,123519.00,5"));
+    std::string p7("$PQWP7,123519.00");
+    for (uint32_t i = 0; i < SV_ALL_NUM; i++) {
+        char sv[32];
+        snprintf(sv, sizeof(sv), ",%u,%u,%u", i % 3, i % 4, (i * 37) % 7200);
+        p7 += sv;
+    }
+    sentences.push_back(benchSentence(p7));
+    sentences.push_back(benchSentence("$PQWS1,123519.00,3,50"));
+
+    uint64_t bytes = 0;
+    for (auto& s : sentences) {
+        std::vector<std::string> expected = legacyTokenize(s.c_str());
+        BenchTokenizer tokenizer(s.c_str(), s.length());
+        if (expected.size() != tokenizer.getCount()) {
+            printf("%.6s: %zu fields, expected %zu\n", s.c_str(),
+                   (size_t)tokenizer.getCount(), expected.size());
+            return 1;
+        }
+        for (uint32_t i = 0; i < tokenizer.getCount(); i++) {
+            if (expected[i] != tokenizer.getField(i)) {
+                printf("%.6s: field %u is '%s', expected '%s'\n", s.c_str(), i,
+                       tokenizer.getField(i).c_str(), expected[i].c_str());
+                return 1;
+            }
+        }
+        bytes += s.length();
+    }
+
+    uint64_t legacyNs = 0, tokenizeNs = 0, parseNs = 0;
+    uint32_t sink = 0;
+    for (uint32_t r = 0; r < rounds; r++) {
+        uint64_t t0 = nowNs();
+        for (auto& s : sentences) {
+            sink += legacyTokenize(s.c_str()).size();
+        }
+        uint64_t t1 = nowNs();
+        for (auto& s : sentences) {
+            sink += BenchTokenizer(s.c_str(), s.length()).getCount();
+        }
+        uint64_t t2 = nowNs();
+        for (auto& s : sentences) {
+            const char* data = s.c_str();
+            uint32_t len = s.length();
+            switch (data[4]) {
+            case 'M':
+                sink += SystemStatusPQWM1parser(data, len).get().mGpsWeek;
+                break;
+            case 'S':
+                sink += SystemStatusPQWS1parser(data, len).get().mHepeLimit;
+                break;
+            default:
+                switch (data[5]) {
+                case '1': sink += SystemStatusPQWP1parser(data, len).get().mEpiSrc; break;
+                case '2': sink += SystemStatusPQWP2parser(data, len).get().mBestHepe; break;
+                case '3': sink += SystemStatusPQWP3parser(data, len).get().mGpsXtraAge; break;
+                case '4': sink += SystemStatusPQWP4parser(data, len).get().mQzssEpheValid; break;
+                case '5': sink += SystemStatusPQWP5parser(data, len).get().mQzssBadMask; break;
+                case '6': sink += SystemStatusPQWP6parser(data, len).get().mFixInfoMask; break;
+                case '7': sink += SystemStatusPQWP7parser(data, len).get().mNav[1].mAgeSec; break;
+                }
+            }
+        }
+        uint64_t t3 = nowNs();
+        legacyNs += t1 - t0;
+        tokenizeNs += t2 - t1;
+        parseNs += t3 - t2;
+    }
+
+    uint64_t total = (uint64_t)rounds * sentences.size();
+    printf("%zu sentences, %llu bytes per round, %u rounds (%u)\n", sentences.size(),
+           (unsigned long long)bytes, rounds, sink & 1);
+    printf("legacy tokenize:   %8.0f sentences/s, %6.1f MB/s\n",
+           total * 1e9 / legacyNs, bytes * rounds * 1e3 / legacyNs);
+    printf("in place tokenize: %8.0f sentences/s, %6.1f MB/s\n",
+           total * 1e9 / tokenizeNs, bytes * rounds * 1e3 / tokenizeNs);
+    printf("tokenize + parse:  %8.0f sentences/s, %6.1f MB/s\n",
+           total * 1e9 / parseNs, bytes * rounds * 1e3 / parseNs);
+    // the readers never take mMutexSystemStatus, so writer latency should
+    // hold up whichever way the published reports are read
+    MsgTask* msgTask = new MsgTask("pqw_bench", false);
+    SystemStatus* status = SystemStatus::getInstance(msgTask);
+    BenchReader reader;
+    reader.status = status;
+    uint32_t writeRounds = rounds / 10 + 1;
+    benchWriters(status, sentences, writeRounds, NULL, "no reader:");
+    reader.latestOnly = true;
+    benchWriters(status, sentences, writeRounds, &reader, "latest only reader:");
+    reader.latestOnly = false;
+    benchWriters(status, sentences, writeRounds, &reader, "full copy reader:");
+
+    SystemStatusReports* reports = new SystemStatusReports();
+    status->getReport(*reports, false);
+    if (reports->mLocation.size() != SystemStatusItemBase::maxItem ||
+        fabs(reports->mLocation.back().mLocation.gpsLocation.latitude -
+             (37.0 + (writeRounds - 1) * 1e-6)) > 1e-9) {
+        printf("location history is not the latest %u reports\n", SystemStatusItemBase::maxItem);
+        return 1;
+    }
+    delete reports;
+    return 0;
+}
+
+#endif
@@ -34,6 +34,10 @@
 #include <vector>
 #include <algorithm>
 #include <iterator>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
 #include <loc_pla.h>
 #include <log_util.h>
 #include <MsgTask.h>
@@ -814,6 +818,106 @@ public:
     }
 };
 
+/******************************************************************************
+ SystemStatusItemRing
+
+ Fixed capacity history of one report item type. Once full, the oldest item
+ is overwritten in place, so a steady stream of updates neither allocates nor
+ shifts the remaining items. Indexing is oldest first, as with the vectors
+ it replaces, and back() is the latest item.
+
+ Each ring carries a stamp that is renewed whenever it may have changed, ie
+ on any non-const access, and travels with its content on copy. Copying a
+ ring over one holding the same stamp is then a no-op, which keeps refreshing
+ a full copy of the reports down to the few rings updated in between.
+******************************************************************************/
+template <typename TYPE_ITEM, uint32_t CAPACITY = TYPE_ITEM::maxItem>
+class SystemStatusItemRing
+{
+    typename std::aligned_storage<sizeof(TYPE_ITEM), alignof(TYPE_ITEM)>::type
+            mItems[CAPACITY];
+    uint32_t mHead; // slot of the oldest item
+    uint32_t mSize;
+    uint64_t mStamp;
+    static std::atomic<uint64_t> sStamps;
+
+    inline void touch() {
+        mStamp = sStamps.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    inline TYPE_ITEM* slot(uint32_t i) {
+        return reinterpret_cast<TYPE_ITEM*>(&mItems[(mHead + i) % CAPACITY]);
+    }
+    inline const TYPE_ITEM* slot(uint32_t i) const {
+        return reinterpret_cast<const TYPE_ITEM*>(&mItems[(mHead + i) % CAPACITY]);
+    }
+public:
+    inline SystemStatusItemRing() : mHead(0), mSize(0), mStamp(0) {}
+    inline SystemStatusItemRing(const SystemStatusItemRing& peer) :
+            mHead(0), mSize(0), mStamp(0) {
+        *this = peer;
+    }
+    inline ~SystemStatusItemRing() { clear(); }
+
+    // items already held are assigned rather than rebuilt, so copying into a
+    // ring of the same shape reuses whatever storage the items own
+    SystemStatusItemRing& operator=(const SystemStatusItemRing& peer) {
+        if (mStamp != peer.mStamp) {
+            uint32_t i = 0;
+            for (; i < mSize && i < peer.mSize; i++) {
+                *slot(i) = peer[i];
+            }
+            for (; i < peer.mSize; i++) {
+                new (slot(i)) TYPE_ITEM(peer[i]);
+            }
+            for (; i < mSize; i++) {
+                slot(i)->~TYPE_ITEM();
+            }
+            mSize = peer.mSize;
+            mStamp = peer.mStamp;
+        } else if (mSize > 0) {
+            // the only change backUnstamped() may have made
+            slot(mSize - 1)->mUtcReported = peer.back().mUtcReported;
+        }
+        return *this;
+    }
+
+    inline bool empty() const { return 0 == mSize; }
+    inline uint32_t size() const { return mSize; }
+    inline TYPE_ITEM& operator[](uint32_t i) { touch(); return *slot(i); }
+    inline const TYPE_ITEM& operator[](uint32_t i) const { return *slot(i); }
+    inline TYPE_ITEM& front() { touch(); return *slot(0); }
+    inline const TYPE_ITEM& front() const { return *slot(0); }
+    inline TYPE_ITEM& back() { touch(); return *slot(mSize - 1); }
+    inline const TYPE_ITEM& back() const { return *slot(mSize - 1); }
+    // back() without renewing the stamp, only to refresh mUtcReported of an
+    // unchanged item; copies pick it up even when the stamps match
+    inline TYPE_ITEM& backUnstamped() { return *slot(mSize - 1); }
+
+    inline void push_back(const TYPE_ITEM& item) {
+        touch();
+        if (mSize < CAPACITY) {
+            new (slot(mSize)) TYPE_ITEM(item);
+            mSize++;
+        } else {
+            // the oldest slot becomes the newest
+            *slot(0) = item;
+            mHead = (mHead + 1) % CAPACITY;
+        }
+    }
+    inline void clear() {
+        touch();
+        for (uint32_t i = 0; i < mSize; i++) {
+            slot(i)->~TYPE_ITEM();
+        }
+        mHead = 0;
+        mSize = 0;
+    }
+};
+
+template <typename TYPE_ITEM, uint32_t CAPACITY>
+std::atomic<uint64_t> SystemStatusItemRing<TYPE_ITEM, CAPACITY>::sStamps(0);
+
 /******************************************************************************
  SystemStatusReports
 ******************************************************************************/
@@ -821,49 +925,49 @@ class SystemStatusReports
 {
 public:
     // from QMI_LOC indication
-    std::vector<SystemStatusLocation>         mLocation;
+    SystemStatusItemRing<SystemStatusLocation>         mLocation;
 
     // from ME debug NMEA
-    std::vector<SystemStatusTimeAndClock>     mTimeAndClock;
-    std::vector<SystemStatusXoState>          mXoState;
-    std::vector<SystemStatusRfAndParams>      mRfAndParams;
-    std::vector<SystemStatusErrRecovery>      mErrRecovery;
+    SystemStatusItemRing<SystemStatusTimeAndClock>     mTimeAndClock;
+    SystemStatusItemRing<SystemStatusXoState>          mXoState;
+    SystemStatusItemRing<SystemStatusRfAndParams>      mRfAndParams;
+    SystemStatusItemRing<SystemStatusErrRecovery>      mErrRecovery;
 
     // from PE debug NMEA
-    std::vector<SystemStatusInjectedPosition> mInjectedPosition;
-    std::vector<SystemStatusBestPosition>     mBestPosition;
-    std::vector<SystemStatusXtra>             mXtra;
-    std::vector<SystemStatusEphemeris>        mEphemeris;
-    std::vector<SystemStatusSvHealth>         mSvHealth;
-    std::vector<SystemStatusPdr>              mPdr;
-    std::vector<SystemStatusNavData>          mNavData;
+    SystemStatusItemRing<SystemStatusInjectedPosition> mInjectedPosition;
+    SystemStatusItemRing<SystemStatusBestPosition>     mBestPosition;
+    SystemStatusItemRing<SystemStatusXtra>             mXtra;
+    SystemStatusItemRing<SystemStatusEphemeris>        mEphemeris;
+    SystemStatusItemRing<SystemStatusSvHealth>         mSvHealth;
+    SystemStatusItemRing<SystemStatusPdr>              mPdr;
+    SystemStatusItemRing<SystemStatusNavData>          mNavData;
 
     // from SM debug NMEA
-    std::vector<SystemStatusPositionFailure>  mPositionFailure;
+    SystemStatusItemRing<SystemStatusPositionFailure>  mPositionFailure;
 
     // from dataitems observer
-    std::vector<SystemStatusAirplaneMode>     mAirplaneMode;
-    std::vector<SystemStatusENH>              mENH;
-    std::vector<SystemStatusGpsState>         mGPSState;
-    std::vector<SystemStatusNLPStatus>        mNLPStatus;
-    std::vector<SystemStatusWifiHardwareState> mWifiHardwareState;
-    std::vector<SystemStatusNetworkInfo>      mNetworkInfo;
-    std::vector<SystemStatusServiceInfo>      mRilServiceInfo;
-    std::vector<SystemStatusRilCellInfo>      mRilCellInfo;
-    std::vector<SystemStatusServiceStatus>    mServiceStatus;
-    std::vector<SystemStatusModel>            mModel;
-    std::vector<SystemStatusManufacturer>     mManufacturer;
-    std::vector<SystemStatusAssistedGps>      mAssistedGps;
-    std::vector<SystemStatusScreenState>      mScreenState;
-    std::vector<SystemStatusPowerConnectState> mPowerConnectState;
-    std::vector<SystemStatusTimeZoneChange>   mTimeZoneChange;
-    std::vector<SystemStatusTimeChange>       mTimeChange;
-    std::vector<SystemStatusWifiSupplicantStatus> mWifiSupplicantStatus;
-    std::vector<SystemStatusShutdownState>    mShutdownState;
-    std::vector<SystemStatusTac>              mTac;
-    std::vector<SystemStatusMccMnc>           mMccMnc;
-    std::vector<SystemStatusBtDeviceScanDetail> mBtDeviceScanDetail;
-    std::vector<SystemStatusBtleDeviceScanDetail> mBtLeDeviceScanDetail;
+    SystemStatusItemRing<SystemStatusAirplaneMode>     mAirplaneMode;
+    SystemStatusItemRing<SystemStatusENH>              mENH;
+    SystemStatusItemRing<SystemStatusGpsState>         mGPSState;
+    SystemStatusItemRing<SystemStatusNLPStatus>        mNLPStatus;
+    SystemStatusItemRing<SystemStatusWifiHardwareState> mWifiHardwareState;
+    SystemStatusItemRing<SystemStatusNetworkInfo>      mNetworkInfo;
+    SystemStatusItemRing<SystemStatusServiceInfo>      mRilServiceInfo;
+    SystemStatusItemRing<SystemStatusRilCellInfo>      mRilCellInfo;
+    SystemStatusItemRing<SystemStatusServiceStatus>    mServiceStatus;
+    SystemStatusItemRing<SystemStatusModel>            mModel;
+    SystemStatusItemRing<SystemStatusManufacturer>     mManufacturer;
+    SystemStatusItemRing<SystemStatusAssistedGps>      mAssistedGps;
+    SystemStatusItemRing<SystemStatusScreenState>      mScreenState;
+    SystemStatusItemRing<SystemStatusPowerConnectState> mPowerConnectState;
+    SystemStatusItemRing<SystemStatusTimeZoneChange>   mTimeZoneChange;
+    SystemStatusItemRing<SystemStatusTimeChange>       mTimeChange;
+    SystemStatusItemRing<SystemStatusWifiSupplicantStatus> mWifiSupplicantStatus;
+    SystemStatusItemRing<SystemStatusShutdownState>    mShutdownState;
+    SystemStatusItemRing<SystemStatusTac>              mTac;
+    SystemStatusItemRing<SystemStatusMccMnc>           mMccMnc;
+    SystemStatusItemRing<SystemStatusBtDeviceScanDetail> mBtDeviceScanDetail;
+    SystemStatusItemRing<SystemStatusBtleDeviceScanDetail> mBtLeDeviceScanDetail;
 };
 
 /******************************************************************************
@@ -883,6 +987,14 @@ private:
     static pthread_mutex_t                    mMutexSystemStatus;
     SystemStatusReports mCache;
 
+    // copy of mCache as of the last update, republished by the writers under
+    // mMutexSystemStatus. getReport() only takes a reference to it, so readers
+    // never contend with the NMEA and dataitem writers for the mutex.
+    std::shared_ptr<SystemStatusReports>      mSnapshot;
+    // previously published copy, refilled in place once no reader holds it
+    std::shared_ptr<SystemStatusReports>      mSpare;
+    void publishReport();
+
     template <typename TYPE_REPORT, typename TYPE_ITEM>
     bool setIteminReport(TYPE_REPORT& report, TYPE_ITEM&& s);
 
@@ -31,8 +31,12 @@
 #include <GeofenceAdapter.h>
 #include "loc_log.h"
 #include <log_util.h>
+#include <LocMsgPool.h>
 #include <string>
 
+// breaches of up to this many fences are carried without heap allocations
+#define GEOFENCE_BREACH_INLINE_IDS (16)
+
 using namespace loc_core;
 
 GeofenceAdapter::GeofenceAdapter() :
@@ -53,26 +57,20 @@ GeofenceAdapter::stopClientSessions(LocationAPI* client)
     LOC_LOGD("%s]: client %p", __func__, client);
 
 
-    for (auto it = mGeofenceIds.begin(); it != mGeofenceIds.end();) {
-        uint32_t hwId = it->second;
-        GeofenceKey key(it->first);
+    for (size_t i = 0; i < mGeofences.size(); ++i) {
+        const GeofenceKey& key = mGeofences.objectAt(i).key;
         if (client == key.client) {
-            it = mGeofenceIds.erase(it);
+            uint32_t hwId = mGeofences.hwIdAt(i);
             mLocApi->removeGeofence(hwId, key.id,
                     new LocApiResponse(*getContext(),
                     [this, hwId] (LocationError err) {
                 if (LOCATION_ERROR_SUCCESS == err) {
-                    auto it2 = mGeofences.find(hwId);
-                    if (it2 != mGeofences.end()) {
-                        mGeofences.erase(it2);
-                    } else {
+                    if (!mGeofences.remove(hwId)) {
                         LOC_LOGE("%s]:geofence item to erase not found. hwId %u", __func__, hwId);
                     }
                 }
             }));
-            continue;
         }
-        ++it; // increment only when not erasing an iterator
     }
 
 }
@@ -96,10 +94,7 @@ GeofenceAdapter::updateClientsEventMask()
 LocationError
 GeofenceAdapter::getHwIdFromClient(LocationAPI* client, uint32_t clientId, uint32_t& hwId)
 {
-    GeofenceKey key(client, clientId);
-    auto it = mGeofenceIds.find(key);
-    if (it != mGeofenceIds.end()) {
-        hwId = it->second;
+    if (mGeofences.findHwId(GeofenceKey(client, clientId), hwId)) {
         return LOCATION_ERROR_SUCCESS;
     }
     return LOCATION_ERROR_ID_UNKNOWN;
@@ -108,14 +103,24 @@ GeofenceAdapter::getHwIdFromClient(LocationAPI* client, uint32_t clientId, uint3
 LocationError
 GeofenceAdapter::getGeofenceKeyFromHwId(uint32_t hwId, GeofenceKey& key)
 {
-    auto it = mGeofences.find(hwId);
-    if (it != mGeofences.end()) {
-        key = it->second.key;
+    GeofenceObject* object = mGeofences.find(hwId);
+    if (nullptr != object) {
+        key = object->key;
         return LOCATION_ERROR_SUCCESS;
     }
     return LOCATION_ERROR_ID_UNKNOWN;
 }
 
+void
+GeofenceAdapter::getGeofencesAt(double latitude, double longitude, std::vector<GeofenceKey>& keys)
+{
+    std::vector<uint32_t> hwIds;
+    mGeofences.findContaining(latitude, longitude, hwIds);
+    for (size_t i = 0; i < hwIds.size(); ++i) {
+        keys.push_back(mGeofences.find(hwIds[i])->key);
+    }
+}
+
 void
 GeofenceAdapter::handleEngineUpEvent()
 {
@@ -145,12 +150,26 @@ GeofenceAdapter::restartGeofences()
         return;
     }
 
-    GeofencesMap oldGeofences(mGeofences);
-    mGeofences.clear();
-    mGeofenceIds.clear();
+    // the fences move out of the store for the time they are re-added, the
+    // engine hands out new hwIds for them
+    struct GeofenceRestart {
+        GeofenceAdapter& mAdapter;
+        std::vector<uint32_t> mHwIds;
+        std::vector<GeofenceObject> mObjects;
+        size_t mPending;
+        inline GeofenceRestart(GeofenceAdapter& adapter) :
+            mAdapter(adapter), mPending(0) {}
+    };
+    GeofenceRestart* restart = new GeofenceRestart(*this);
+    if (nullptr == restart) {
+        LOC_LOGE("%s]: new failed to allocate restart", __func__);
+        return;
+    }
+    mGeofences.take(restart->mHwIds, restart->mObjects);
+    restart->mPending = restart->mObjects.size();
 
-    for (auto it = oldGeofences.begin(); it != oldGeofences.end(); it++) {
-        GeofenceObject object = it->second;
+    for (size_t i = 0; i < restart->mObjects.size(); i++) {
+        const GeofenceObject& object = restart->mObjects[i];
         GeofenceOption options = {sizeof(GeofenceOption),
                                    object.breachMask,
                                    object.responsiveness,
@@ -163,13 +182,29 @@ GeofenceAdapter::restartGeofences()
                               options,
                               info,
                               new LocApiResponseData<LocApiGeofenceData>(*getContext(),
-                [this, object, options, info] (LocationError err, LocApiGeofenceData data) {
+                [restart, i] (LocationError err, LocApiGeofenceData data) {
+            GeofenceAdapter& adapter = restart->mAdapter;
+            const GeofenceObject& object = restart->mObjects[i];
             if (LOCATION_ERROR_SUCCESS == err) {
+                GeofenceOption options = {sizeof(GeofenceOption),
+                                           object.breachMask,
+                                           object.responsiveness,
+                                           object.dwellTime};
+                GeofenceInfo info = {sizeof(GeofenceInfo),
+                                     object.latitude,
+                                     object.longitude,
+                                     object.radius};
+                adapter.saveGeofenceItem(object.key.client, object.key.id, data.hwId,
+                                         options, info);
                 if (true == object.paused) {
-                    mLocApi->pauseGeofence(data.hwId, object.key.id,
-                            new LocApiResponse(*getContext(), [] (LocationError /*err*/) {}));
+                    adapter.mLocApi->pauseGeofence(data.hwId, object.key.id,
+                            new LocApiResponse(*adapter.getContext(),
+                            [] (LocationError /*err*/) {}));
+                    adapter.pauseGeofenceItem(data.hwId);
                 }
-                saveGeofenceItem(object.key.client, object.key.id, data.hwId, options, info);
+            }
+            if (0 == --restart->mPending) {
+                delete restart;
             }
         }));
     }
@@ -203,6 +238,47 @@ GeofenceAdapter::reportResponse(LocationAPI* client, size_t count, LocationError
     }
 }
 
+/* Fences of one add or remove command. The engine gets them all from one call
+   queue entry, and each per fence response holds only the batch and an index.
+   The aggregated response goes to the client once every fence is answered. */
+struct GeofenceBatch {
+    GeofenceAdapter& mAdapter;
+    LocationAPI* mClient;
+    size_t mCount;
+    uint32_t* mIds;
+    GeofenceOption* mOptions;
+    GeofenceInfo* mInfos;
+    LocationError* mErrs;
+    uint32_t* mHwIds;
+    // fences not answered yet, plus one held by the loop issuing them
+    size_t mPending;
+    inline GeofenceBatch(GeofenceAdapter& adapter, LocationAPI* client, size_t count,
+                         uint32_t* ids, GeofenceOption* options, GeofenceInfo* infos) :
+        mAdapter(adapter),
+        mClient(client),
+        mCount(count),
+        mIds(ids),
+        mOptions(options),
+        mInfos(infos),
+        mErrs(new LocationError[count]),
+        mHwIds(new uint32_t[count]),
+        mPending(count + 1) {}
+    inline ~GeofenceBatch() {
+        delete[] mErrs;
+        delete[] mHwIds;
+        delete[] mIds;
+        delete[] mOptions;
+        delete[] mInfos;
+    }
+    inline bool valid() const { return nullptr != mErrs && nullptr != mHwIds; }
+    inline void done() {
+        if (0 == --mPending) {
+            mAdapter.reportResponse(mClient, mCount, mErrs, mIds);
+            delete this;
+        }
+    }
+};
+
 uint32_t*
 GeofenceAdapter::addGeofencesCommand(LocationAPI* client, size_t count, GeofenceOption* options,
         GeofenceInfo* infos)
@@ -212,66 +288,45 @@ GeofenceAdapter::addGeofencesCommand(LocationAPI* client, size_t count, Geofence
     struct MsgAddGeofences : public LocMsg {
         GeofenceAdapter& mAdapter;
         LocApiBase& mApi;
-        LocationAPI* mClient;
-        size_t mCount;
-        uint32_t* mIds;
-        GeofenceOption* mOptions;
-        GeofenceInfo* mInfos;
+        GeofenceBatch* mBatch;
         inline MsgAddGeofences(GeofenceAdapter& adapter,
                                LocApiBase& api,
-                               LocationAPI* client,
-                               size_t count,
-                               uint32_t* ids,
-                               GeofenceOption* options,
-                               GeofenceInfo* infos) :
+                               GeofenceBatch* batch) :
             LocMsg(),
             mAdapter(adapter),
             mApi(api),
-            mClient(client),
-            mCount(count),
-            mIds(ids),
-            mOptions(options),
-            mInfos(infos) {}
+            mBatch(batch) {}
         inline virtual void proc() const {
-            LocationError* errs = new LocationError[mCount];
-            if (nullptr == errs) {
-                LOC_LOGE("%s]: new failed to allocate errs", __func__);
+            GeofenceBatch* batch = mBatch;
+            if (NULL == batch->mIds || NULL == batch->mOptions || NULL == batch->mInfos) {
+                for (size_t i=0; i < batch->mCount; ++i) {
+                    batch->mErrs[i] = LOCATION_ERROR_INVALID_PARAMETER;
+                }
+                batch->mPending = 1;
+                batch->done();
                 return;
             }
-            for (size_t i=0; i < mCount; ++i) {
-                if (NULL == mIds || NULL == mOptions || NULL == mInfos) {
-                    errs[i] = LOCATION_ERROR_INVALID_PARAMETER;
-                } else {
-                    mApi.addToCallQueue(new LocApiResponse(*mAdapter.getContext(),
-                            [&mAdapter = mAdapter, mCount = mCount, mClient = mClient,
-                            mOptions = mOptions, mInfos = mInfos, mIds = mIds, &mApi = mApi,
-                            errs, i] (LocationError /*err*/) {
-                        mApi.addGeofence(mIds[i], mOptions[i], mInfos[i],
-                        new LocApiResponseData<LocApiGeofenceData>(*mAdapter.getContext(),
-                        [&mAdapter = mAdapter, mOptions = mOptions, mClient = mClient,
-                        mCount = mCount, mIds = mIds, mInfos = mInfos, errs, i]
-                        (LocationError err, LocApiGeofenceData data) {
-                            if (LOCATION_ERROR_SUCCESS == err) {
-                                mAdapter.saveGeofenceItem(mClient,
-                                mIds[i],
-                                data.hwId,
-                                mOptions[i],
-                                mInfos[i]);
-                            }
-                            errs[i] = err;
-
-                            // Send aggregated response on last item and cleanup
-                            if (i == mCount-1) {
-                                mAdapter.reportResponse(mClient, mCount, errs, mIds);
-                                delete[] errs;
-                                delete[] mIds;
-                                delete[] mOptions;
-                                delete[] mInfos;
-                            }
-                        }));
+            // one call queue entry for the whole batch, then a response per fence
+            mApi.addToCallQueue(new LocApiResponse(*mAdapter.getContext(),
+                    [&mApi = mApi, batch] (LocationError /*err*/) {
+                for (size_t i=0; i < batch->mCount; ++i) {
+                    mApi.addGeofence(batch->mIds[i], batch->mOptions[i], batch->mInfos[i],
+                    new LocApiResponseData<LocApiGeofenceData>(
+                    *batch->mAdapter.getContext(),
+                    [batch, i] (LocationError err, LocApiGeofenceData data) {
+                        if (LOCATION_ERROR_SUCCESS == err) {
+                            batch->mAdapter.saveGeofenceItem(batch->mClient,
+                            batch->mIds[i],
+                            data.hwId,
+                            batch->mOptions[i],
+                            batch->mInfos[i]);
+                        }
+                        batch->mErrs[i] = err;
+                        batch->done();
                     }));
                 }
-            }
+                batch->done();
+            }));
         }
     };
 
@@ -311,7 +366,13 @@ GeofenceAdapter::addGeofencesCommand(LocationAPI* client, size_t count, Geofence
         COPY_IF_NOT_NULL(infosCopy, infos, count);
     }
 
-    sendMsg(new MsgAddGeofences(*this, *mLocApi, client, count, ids, optionsCopy, infosCopy));
+    GeofenceBatch* batch = new GeofenceBatch(*this, client, count, ids, optionsCopy, infosCopy);
+    if (nullptr == batch || !batch->valid()) {
+        LOC_LOGE("%s]: new failed to allocate batch", __func__);
+        delete batch;
+        return NULL;
+    }
+    sendMsg(new MsgAddGeofences(*this, *mLocApi, batch));
     return ids;
 }
 
@@ -323,59 +384,39 @@ GeofenceAdapter::removeGeofencesCommand(LocationAPI* client, size_t count, uint3
     struct MsgRemoveGeofences : public LocMsg {
         GeofenceAdapter& mAdapter;
         LocApiBase& mApi;
-        LocationAPI* mClient;
-        size_t mCount;
-        uint32_t* mIds;
+        GeofenceBatch* mBatch;
         inline MsgRemoveGeofences(GeofenceAdapter& adapter,
                                   LocApiBase& api,
-                                  LocationAPI* client,
-                                  size_t count,
-                                  uint32_t* ids) :
+                                  GeofenceBatch* batch) :
             LocMsg(),
             mAdapter(adapter),
             mApi(api),
-            mClient(client),
-            mCount(count),
-            mIds(ids) {}
+            mBatch(batch) {}
         inline virtual void proc() const  {
-            LocationError* errs = new LocationError[mCount];
-            if (nullptr == errs) {
-                LOC_LOGE("%s]: new failed to allocate errs", __func__);
-                return;
-            }
-            for (size_t i=0; i < mCount; ++i) {
-                mApi.addToCallQueue(new LocApiResponse(*mAdapter.getContext(),
-                        [&mAdapter = mAdapter, mCount = mCount, mClient = mClient, mIds = mIds,
-                        &mApi = mApi, errs, i] (LocationError /*err*/) {
-                    uint32_t hwId = 0;
-                    errs[i] = mAdapter.getHwIdFromClient(mClient, mIds[i], hwId);
-                    if (LOCATION_ERROR_SUCCESS == errs[i]) {
-                        mApi.removeGeofence(hwId, mIds[i],
-                        new LocApiResponse(*mAdapter.getContext(),
-                        [&mAdapter = mAdapter, mCount = mCount, mClient = mClient, mIds = mIds,
-                        hwId, errs, i] (LocationError err ) {
-                            if (LOCATION_ERROR_SUCCESS == err) {
-                                mAdapter.removeGeofenceItem(hwId);
-                            }
-                            errs[i] = err;
-
-                            // Send aggregated response on last item and cleanup
-                            if (i == mCount-1) {
-                                mAdapter.reportResponse(mClient, mCount, errs, mIds);
-                                delete[] errs;
-                                delete[] mIds;
-                            }
-                        }));
-                    } else {
-                        // Send aggregated response on last item and cleanup
-                        if (i == mCount-1) {
-                            mAdapter.reportResponse(mClient, mCount, errs, mIds);
-                            delete[] errs;
-                            delete[] mIds;
-                        }
+            GeofenceBatch* batch = mBatch;
+            // one call queue entry for the whole batch, then a response per fence
+            mApi.addToCallQueue(new LocApiResponse(*mAdapter.getContext(),
+                    [&mApi = mApi, batch] (LocationError /*err*/) {
+                for (size_t i=0; i < batch->mCount; ++i) {
+                    uint32_t& hwId = batch->mHwIds[i];
+                    batch->mErrs[i] = batch->mAdapter.getHwIdFromClient(batch->mClient,
+                            batch->mIds[i], hwId);
+                    if (LOCATION_ERROR_SUCCESS != batch->mErrs[i]) {
+                        batch->done();
+                        continue;
                     }
-                }));
-            }
+                    mApi.removeGeofence(hwId, batch->mIds[i],
+                    new LocApiResponse(*batch->mAdapter.getContext(),
+                    [batch, i] (LocationError err) {
+                        if (LOCATION_ERROR_SUCCESS == err) {
+                            batch->mAdapter.removeGeofenceItem(batch->mHwIds[i]);
+                        }
+                        batch->mErrs[i] = err;
+                        batch->done();
+                    }));
+                }
+                batch->done();
+            }));
         }
     };
 
@@ -388,7 +429,13 @@ GeofenceAdapter::removeGeofencesCommand(LocationAPI* client, size_t count, uint3
         return;
     }
     COPY_IF_NOT_NULL(idsCopy, ids, count);
-    sendMsg(new MsgRemoveGeofences(*this, *mLocApi, client, count, idsCopy));
+    GeofenceBatch* batch = new GeofenceBatch(*this, client, count, idsCopy, NULL, NULL);
+    if (nullptr == batch || !batch->valid()) {
+        LOC_LOGE("%s]: new failed to allocate batch", __func__);
+        delete batch;
+        return;
+    }
+    sendMsg(new MsgRemoveGeofences(*this, *mLocApi, batch));
 }
 
 void
@@ -655,42 +702,26 @@ GeofenceAdapter::saveGeofenceItem(LocationAPI* client, uint32_t clientId, uint32
                              info.longitude,
                              info.radius,
                              false};
-    mGeofences[hwId] = object;
-    mGeofenceIds[key] = hwId;
+    mGeofences.save(hwId, object);
     dump();
 }
 
 void
 GeofenceAdapter::removeGeofenceItem(uint32_t hwId)
 {
-    GeofenceKey key;
-    LocationError err = getGeofenceKeyFromHwId(hwId, key);
-    if (LOCATION_ERROR_SUCCESS != err) {
-        LOC_LOGE("%s]: can not find the key for hwId %u", __func__, hwId);
+    if (mGeofences.remove(hwId)) {
+        dump();
     } else {
-        auto it1 = mGeofenceIds.find(key);
-        if (it1 != mGeofenceIds.end()) {
-            mGeofenceIds.erase(it1);
-
-            auto it2 = mGeofences.find(hwId);
-            if (it2 != mGeofences.end()) {
-                mGeofences.erase(it2);
-                dump();
-            } else {
-                LOC_LOGE("%s]:geofence item to erase not found. hwId %u", __func__, hwId);
-            }
-        } else {
-            LOC_LOGE("%s]: geofence item to erase not found. hwId %u", __func__, hwId);
-        }
+        LOC_LOGE("%s]: geofence item to erase not found. hwId %u", __func__, hwId);
     }
 }
 
 void
 GeofenceAdapter::pauseGeofenceItem(uint32_t hwId)
 {
-    auto it = mGeofences.find(hwId);
-    if (it != mGeofences.end()) {
-        it->second.paused = true;
+    GeofenceObject* object = mGeofences.find(hwId);
+    if (nullptr != object) {
+        object->paused = true;
         dump();
     } else {
         LOC_LOGE("%s]: geofence item to pause not found. hwId %u", __func__, hwId);
@@ -700,9 +731,9 @@ GeofenceAdapter::pauseGeofenceItem(uint32_t hwId)
 void
 GeofenceAdapter::resumeGeofenceItem(uint32_t hwId)
 {
-    auto it = mGeofences.find(hwId);
-    if (it != mGeofences.end()) {
-        it->second.paused = false;
+    GeofenceObject* object = mGeofences.find(hwId);
+    if (nullptr != object) {
+        object->paused = false;
         dump();
     } else {
         LOC_LOGE("%s]: geofence item to resume not found. hwId %u", __func__, hwId);
@@ -712,11 +743,11 @@ GeofenceAdapter::resumeGeofenceItem(uint32_t hwId)
 void
 GeofenceAdapter::modifyGeofenceItem(uint32_t hwId, const GeofenceOption& options)
 {
-    auto it = mGeofences.find(hwId);
-    if (it != mGeofences.end()) {
-        it->second.breachMask = options.breachTypeMask;
-        it->second.responsiveness = options.responsiveness;
-        it->second.dwellTime = options.dwellTime;
+    GeofenceObject* object = mGeofences.find(hwId);
+    if (nullptr != object) {
+        object->breachMask = options.breachTypeMask;
+        object->responsiveness = options.responsiveness;
+        object->dwellTime = options.dwellTime;
         dump();
     } else {
         LOC_LOGE("%s]: geofence item to modify not found. hwId %u", __func__, hwId);
@@ -744,9 +775,10 @@ GeofenceAdapter::geofenceBreachEvent(size_t count, uint32_t* hwIds, Location& lo
     if (0 == count || NULL == hwIds)
         return;
 
-    struct MsgGeofenceBreach : public LocMsg {
+    struct MsgGeofenceBreach : public LocMsg, public LocPooledMsg<MsgGeofenceBreach> {
         GeofenceAdapter& mAdapter;
         size_t mCount;
+        uint32_t mHwIdsBuf[GEOFENCE_BREACH_INLINE_IDS];
         uint32_t* mHwIds;
         Location mLocation;
         GeofenceBreachType mBreachType;
@@ -760,7 +792,7 @@ GeofenceAdapter::geofenceBreachEvent(size_t count, uint32_t* hwIds, Location& lo
             LocMsg(),
             mAdapter(adapter),
             mCount(count),
-            mHwIds(new uint32_t[count]),
+            mHwIds((count <= GEOFENCE_BREACH_INLINE_IDS) ? mHwIdsBuf : new uint32_t[count]),
             mLocation(location),
             mBreachType(breachType),
             mTimestamp(timestamp)
@@ -772,7 +804,9 @@ GeofenceAdapter::geofenceBreachEvent(size_t count, uint32_t* hwIds, Location& lo
             COPY_IF_NOT_NULL(mHwIds, hwIds, mCount);
         }
         inline virtual ~MsgGeofenceBreach() {
-            delete[] mHwIds;
+            if (mHwIds != mHwIdsBuf) {
+                delete[] mHwIds;
+            }
         }
         inline virtual void proc() const {
             mAdapter.geofenceBreach(mCount, mHwIds, mLocation, mBreachType, mTimestamp);
@@ -788,32 +822,40 @@ GeofenceAdapter::geofenceBreach(size_t count, uint32_t* hwIds, const Location& l
         GeofenceBreachType breachType, uint64_t timestamp)
 {
 
+    // resolve each hwId once, fences not known keep a NULL client matching no one
+    mBreachKeys.resize(count);
+    for (size_t i=0; i < count; ++i) {
+        GeofenceObject* object = mGeofences.find(hwIds[i]);
+        mBreachKeys[i] = (nullptr != object) ? object->key : GeofenceKey();
+    }
+
+    IF_LOC_LOGV {
+        std::vector<GeofenceKey> keys;
+        getGeofencesAt(location.latitude, location.longitude, keys);
+        LOC_LOGV("%s]: %zu of %zu fences contain the breach location",
+                 __func__, keys.size(), mGeofences.size());
+    }
+
     for (auto it = mClientData.begin(); it != mClientData.end(); ++it) {
-        uint32_t* clientIds = new uint32_t[count];
-        if (nullptr == clientIds) {
-            return;
+        if (it->second.geofenceBreachCb == nullptr) {
+            continue;
         }
-        uint32_t index = 0;
+        mBreachIds.clear();
         for (size_t i=0; i < count; ++i) {
-            GeofenceKey key;
-            LocationError err = getGeofenceKeyFromHwId(hwIds[i], key);
-            if (LOCATION_ERROR_SUCCESS == err) {
-                if (key.client == it->first) {
-                    clientIds[index++] = key.id;
-                }
+            if (mBreachKeys[i].client == it->first) {
+                mBreachIds.push_back(mBreachKeys[i].id);
             }
         }
-        if (index > 0 && it->second.geofenceBreachCb != nullptr) {
+        if (!mBreachIds.empty()) {
             GeofenceBreachNotification notify = {sizeof(GeofenceBreachNotification),
-                                                 index,
-                                                 clientIds,
+                                                 (uint32_t)mBreachIds.size(),
+                                                 mBreachIds.data(),
                                                  location,
                                                  breachType,
                                                  timestamp};
 
             it->second.geofenceBreachCb(notify);
         }
-        delete[] clientIds;
     }
 }
 
@@ -857,9 +899,9 @@ GeofenceAdapter::dump()
     IF_LOC_LOGV {
         LOC_LOGV(
             "HAL | hwId  | mask | respon | latitude | longitude | radius | paused |  Id  | client");
-        for (auto it = mGeofences.begin(); it != mGeofences.end(); ++it) {
-            uint32_t hwId = it->first;
-            GeofenceObject object = it->second;
+        for (size_t i = 0; i < mGeofences.size(); ++i) {
+            uint32_t hwId = mGeofences.hwIdAt(i);
+            const GeofenceObject& object = mGeofences.objectAt(i);
             LOC_LOGV("    | %5u | %4u | %6u | %8.2f | %9.2f | %6.2f | %6u | %04x | %p ",
                     hwId, object.breachMask, object.responsiveness,
                     object.latitude, object.longitude, object.radius,
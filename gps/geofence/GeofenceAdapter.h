@@ -32,7 +32,8 @@
 #include <LocAdapterBase.h>
 #include <LocContext.h>
 #include <LocationAPI.h>
-#include <map>
+#include <GeofenceStore.h>
+#include <vector>
 
 using namespace loc_core;
 
@@ -44,41 +45,13 @@ using namespace loc_core;
     } \
 } while (0)
 
-typedef struct GeofenceKey {
-    LocationAPI* client;
-    uint32_t id;
-    inline GeofenceKey() :
-        client(NULL), id(0) {}
-    inline GeofenceKey(LocationAPI* _client, uint32_t _id) :
-        client(_client), id(_id) {}
-} GeofenceKey;
-inline bool operator <(GeofenceKey const& left, GeofenceKey const& right) {
-    return left.id < right.id || (left.id == right.id && left.client < right.client);
-}
-inline bool operator ==(GeofenceKey const& left, GeofenceKey const& right) {
-    return left.id == right.id && left.client == right.client;
-}
-inline bool operator !=(GeofenceKey const& left, GeofenceKey const& right) {
-    return left.id != right.id || left.client != right.client;
-}
-typedef struct {
-    GeofenceKey key;
-    GeofenceBreachTypeMask breachMask;
-    uint32_t responsiveness;
-    uint32_t dwellTime;
-    double latitude;
-    double longitude;
-    double radius;
-    bool paused;
-} GeofenceObject;
-typedef std::map<uint32_t, GeofenceObject> GeofencesMap; //map of hwId to GeofenceObject
-typedef std::map<GeofenceKey, uint32_t> GeofenceIdMap; //map of GeofenceKey to hwId
-
 class GeofenceAdapter : public LocAdapterBase {
 
     /* ==== GEOFENCES ====================================================================== */
-    GeofencesMap mGeofences; //map hwId to GeofenceObject
-    GeofenceIdMap mGeofenceIds; //map of GeofenceKey to hwId
+    GeofenceStore mGeofences; //hwId to GeofenceObject, with key and spatial indexes
+    // per breach event scratch, resolved hwId keys and the ids of one client
+    std::vector<GeofenceKey> mBreachKeys;
+    std::vector<uint32_t> mBreachIds;
 
 protected:
 
@@ -120,6 +93,8 @@ public:
     void modifyGeofenceItem(uint32_t hwId, const GeofenceOption& options);
     LocationError getHwIdFromClient(LocationAPI* client, uint32_t clientId, uint32_t& hwId);
     LocationError getGeofenceKeyFromHwId(uint32_t hwId, GeofenceKey& key);
+    // appends the keys of the fences containing the point, for diagnostics
+    void getGeofencesAt(double latitude, double longitude, std::vector<GeofenceKey>& keys);
     void dump();
 
     /* ==== REPORTS ======================================================================== */
@@ -0,0 +1,428 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_NDEBUG 0
+#define LOG_TAG "LocSvc_GeofenceStore"
+
+#include <math.h>
+#include <GeofenceStore.h>
+
+#define GEOFENCE_EARTH_RADIUS_METERS (6371000.0)
+
+static inline double toRadians(double degrees) {
+    return degrees * M_PI / 180.0;
+}
+
+static inline double cellDegrees(uint32_t level) {
+    return GEOFENCE_GRID_CELL_DEGREES * (1 << (4 * level));
+}
+
+static inline int32_t latCell(double latitude, uint32_t level) {
+    int32_t cells = (int32_t)ceil(180.0 / cellDegrees(level));
+    int32_t cell = (int32_t)floor((latitude + 90.0) / cellDegrees(level));
+    return (cell < 0) ? 0 : (cell >= cells) ? cells - 1 : cell;
+}
+
+static inline int32_t lonCell(double longitude, uint32_t level) {
+    return (int32_t)floor((longitude + 180.0) / cellDegrees(level));
+}
+
+static inline uint64_t packCell(uint32_t level, int32_t lat, int32_t lon) {
+    int32_t cells = (int32_t)ceil(360.0 / cellDegrees(level));
+    lon %= cells;
+    if (lon < 0) {
+        lon += cells;
+    }
+    return ((uint64_t)level << 56) | ((uint64_t)(uint32_t)lat << 24) | (uint32_t)lon;
+}
+
+double GeofenceStore::distance(double lat1, double lon1, double lat2, double lon2) {
+    double sinLat = sin(toRadians(lat2 - lat1) / 2);
+    double sinLon = sin(toRadians(lon2 - lon1) / 2);
+    double a = sinLat * sinLat + cos(toRadians(lat1)) * cos(toRadians(lat2)) * sinLon * sinLon;
+    return 2 * GEOFENCE_EARTH_RADIUS_METERS * asin(sqrt((a < 1.0) ? a : 1.0));
+}
+
+// cells of a level covered by the bounding box of the fence circle, false when
+// there are too many of them for the fence to go in that level
+bool GeofenceStore::getCells(const GeofenceObject& object, uint32_t level, int32_t& latMin, int32_t& latMax,
+                             int32_t& lonMin, int32_t& lonMax) const {
+    double angle = object.radius / GEOFENCE_EARTH_RADIUS_METERS;
+    double latSpan = angle * 180.0 / M_PI;
+    if (!(object.latitude - latSpan > -90.0 && object.latitude + latSpan < 90.0)) {
+        // reaches over a pole, or is not a number
+        return false;
+    }
+    double sinRatio = sin(angle) / cos(toRadians(object.latitude));
+    if (!(sinRatio < 1.0)) {
+        return false;
+    }
+    double lonSpan = asin(sinRatio) * 180.0 / M_PI;
+    latMin = latCell(object.latitude - latSpan, level);
+    latMax = latCell(object.latitude + latSpan, level);
+    lonMin = lonCell(object.longitude - lonSpan, level);
+    lonMax = lonCell(object.longitude + lonSpan, level);
+    return (int64_t)(latMax - latMin + 1) * (lonMax - lonMin + 1) <= GEOFENCE_GRID_MAX_CELLS;
+}
+
+void GeofenceStore::indexFence(uint32_t hwId, const GeofenceObject& object) {
+    int32_t latMin, latMax, lonMin, lonMax;
+    uint32_t level = 0;
+    while (level < GEOFENCE_GRID_LEVELS &&
+           !getCells(object, level, latMin, latMax, lonMin, lonMax)) {
+        level++;
+    }
+    if (GEOFENCE_GRID_LEVELS == level) {
+        mLargeFences.push_back(hwId);
+        return;
+    }
+    for (int32_t lat = latMin; lat <= latMax; lat++) {
+        for (int32_t lon = lonMin; lon <= lonMax; lon++) {
+            uint64_t cell = packCell(level, lat, lon);
+            const uint32_t* bucket = mCellIndex.find(cell);
+            if (nullptr != bucket) {
+                mCells[*bucket].push_back(hwId);
+            } else if (!mFreeCells.empty()) {
+                uint32_t index = mFreeCells.back();
+                mFreeCells.pop_back();
+                mCells[index].push_back(hwId);
+                mCellIndex.set(cell, index);
+            } else {
+                mCells.push_back(std::vector<uint32_t>(1, hwId));
+                mCellIndex.set(cell, mCells.size() - 1);
+            }
+        }
+    }
+}
+
+static inline void eraseHwId(std::vector<uint32_t>& hwIds, uint32_t hwId) {
+    for (size_t i = 0; i < hwIds.size(); i++) {
+        if (hwIds[i] == hwId) {
+            hwIds[i] = hwIds.back();
+            hwIds.pop_back();
+            return;
+        }
+    }
+}
+
+void GeofenceStore::unindexFence(uint32_t hwId, const GeofenceObject& object) {
+    int32_t latMin, latMax, lonMin, lonMax;
+    uint32_t level = 0;
+    while (level < GEOFENCE_GRID_LEVELS &&
+           !getCells(object, level, latMin, latMax, lonMin, lonMax)) {
+        level++;
+    }
+    if (GEOFENCE_GRID_LEVELS == level) {
+        eraseHwId(mLargeFences, hwId);
+        return;
+    }
+    for (int32_t lat = latMin; lat <= latMax; lat++) {
+        for (int32_t lon = lonMin; lon <= lonMax; lon++) {
+            uint64_t cell = packCell(level, lat, lon);
+            const uint32_t* bucket = mCellIndex.find(cell);
+            if (nullptr != bucket) {
+                uint32_t index = *bucket;
+                eraseHwId(mCells[index], hwId);
+                if (mCells[index].empty()) {
+                    mCellIndex.erase(cell);
+                    mFreeCells.push_back(index);
+                }
+            }
+        }
+    }
+}
+
+void GeofenceStore::save(uint32_t hwId, const GeofenceObject& object) {
+    const uint32_t* index = mIndexOfHwId.find(hwId);
+    if (nullptr != index) {
+        GeofenceObject& saved = mObjects[*index];
+        unindexFence(hwId, saved);
+        const uint32_t* keyHwId = mHwIdOfKey.find(saved.key);
+        if (nullptr != keyHwId && *keyHwId == hwId) {
+            mHwIdOfKey.erase(saved.key);
+        }
+        saved = object;
+    } else {
+        mIndexOfHwId.set(hwId, mObjects.size());
+        mHwIds.push_back(hwId);
+        mObjects.push_back(object);
+    }
+    mHwIdOfKey.set(object.key, hwId);
+    indexFence(hwId, object);
+}
+
+bool GeofenceStore::remove(uint32_t hwId) {
+    const uint32_t* found = mIndexOfHwId.find(hwId);
+    if (nullptr == found) {
+        return false;
+    }
+    uint32_t index = *found;
+    const GeofenceObject& object = mObjects[index];
+    unindexFence(hwId, object);
+    const uint32_t* keyHwId = mHwIdOfKey.find(object.key);
+    if (nullptr != keyHwId && *keyHwId == hwId) {
+        mHwIdOfKey.erase(object.key);
+    }
+    mIndexOfHwId.erase(hwId);
+
+    // fill the hole with the last fence
+    uint32_t last = mObjects.size() - 1;
+    if (index != last) {
+        mObjects[index] = mObjects[last];
+        mHwIds[index] = mHwIds[last];
+        mIndexOfHwId.set(mHwIds[index], index);
+    }
+    mObjects.pop_back();
+    mHwIds.pop_back();
+    return true;
+}
+
+void GeofenceStore::clear() {
+    mHwIds.clear();
+    mObjects.clear();
+    mIndexOfHwId.clear();
+    mHwIdOfKey.clear();
+    mCellIndex.clear();
+    mCells.clear();
+    mFreeCells.clear();
+    mLargeFences.clear();
+}
+
+void GeofenceStore::take(std::vector<uint32_t>& hwIds, std::vector<GeofenceObject>& objects) {
+    hwIds.clear();
+    objects.clear();
+    hwIds.swap(mHwIds);
+    objects.swap(mObjects);
+    clear();
+}
+
+void GeofenceStore::findContaining(double latitude, double longitude,
+                                   std::vector<uint32_t>& hwIds) const {
+    for (uint32_t level = 0; level < GEOFENCE_GRID_LEVELS; level++) {
+        const uint32_t* bucket = mCellIndex.find(
+                packCell(level, latCell(latitude, level), lonCell(longitude, level)));
+        if (nullptr == bucket) {
+            continue;
+        }
+        const std::vector<uint32_t>& cell = mCells[*bucket];
+        for (size_t i = 0; i < cell.size(); i++) {
+            const GeofenceObject& object = mObjects[*mIndexOfHwId.find(cell[i])];
+            if (distance(latitude, longitude, object.latitude, object.longitude) <=
+                    object.radius) {
+                hwIds.push_back(cell[i]);
+            }
+        }
+    }
+    for (size_t i = 0; i < mLargeFences.size(); i++) {
+        const GeofenceObject& object = mObjects[*mIndexOfHwId.find(mLargeFences[i])];
+        if (distance(latitude, longitude, object.latitude, object.longitude) <= object.radius) {
+            hwIds.push_back(mLargeFences[i]);
+        }
+    }
+}
+
+#ifdef __LOC_DEBUG__
+
+// For Linux command line checking and benchmarking of the geofence store:
+//     g++ -D__LOC_DEBUG__ -DFEATURE_EXTERNAL_AP -O2 -std=c++11 -I. -I../location
+//         -I../utils -I../pla/oe -o geofence_store_bench GeofenceStore.cpp
+//     ./geofence_store_bench
+// "map" is the std::map pair GeofenceAdapter used to keep, with a walk over
+// all fences standing in for the containment query it had no index for.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <map>
+#include <algorithm>
+
+static inline uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline double randomIn(double low, double high) {
+    return low + (high - low) * ((double)rand() / RAND_MAX);
+}
+
+struct BenchTimes {
+    double add, keyLookup, hwIdLookup, query, remove;
+};
+
+static bool benchFences(size_t count, size_t queries, BenchTimes& mapTimes,
+                        BenchTimes& storeTimes) {
+    std::vector<uint32_t> hwIds(count);
+    std::vector<GeofenceObject> objects(count);
+    for (size_t i = 0; i < count; i++) {
+        GeofenceObject& object = objects[i];
+        object.key = GeofenceKey((LocationAPI*)(uintptr_t)(0x1000 * (1 + i % 4)), 1 + i / 4);
+        object.breachMask = GEOFENCE_BREACH_ENTER_BIT | GEOFENCE_BREACH_EXIT_BIT;
+        object.responsiveness = 0;
+        object.dwellTime = 0;
+        // a country sized area, with a few fences of a city size and more
+        object.latitude = randomIn(30.0, 50.0);
+        object.longitude = randomIn(-125.0, -70.0);
+        object.radius = (0 == i % 500) ? randomIn(20000.0, 200000.0) : randomIn(100.0, 5000.0);
+        object.paused = false;
+        hwIds[i] = 1 + i;
+    }
+    std::vector<double> points(queries * 2);
+    for (size_t q = 0; q < queries; q++) {
+        // half of the points close to a fence center, half anywhere in the area
+        const GeofenceObject& near = objects[rand() % count];
+        points[q * 2] = (q & 1) ? randomIn(30.0, 50.0) : near.latitude + randomIn(-0.01, 0.01);
+        points[q * 2 + 1] = (q & 1) ? randomIn(-125.0, -70.0) :
+                near.longitude + randomIn(-0.01, 0.01);
+    }
+    std::vector<uint32_t> removeOrder(hwIds);
+    std::random_shuffle(removeOrder.begin(), removeOrder.end());
+    volatile uint64_t sink = 0;
+    uint64_t start;
+
+    std::map<uint32_t, GeofenceObject> fences;
+    std::map<GeofenceKey, uint32_t> ids;
+    start = nowNs();
+    for (size_t i = 0; i < count; i++) {
+        fences[hwIds[i]] = objects[i];
+        ids[objects[i].key] = hwIds[i];
+    }
+    mapTimes.add = (double)(nowNs() - start) / count;
+    start = nowNs();
+    for (size_t i = 0; i < count; i++) {
+        auto it = ids.find(objects[i].key);
+        sink += (it != ids.end()) ? it->second : 0;
+    }
+    mapTimes.keyLookup = (double)(nowNs() - start) / count;
+    start = nowNs();
+    for (size_t i = 0; i < count; i++) {
+        auto it = fences.find(removeOrder[i]);
+        sink += (it != fences.end()) ? it->second.key.id : 0;
+    }
+    mapTimes.hwIdLookup = (double)(nowNs() - start) / count;
+    std::vector<std::vector<uint32_t> > mapFound(queries);
+    start = nowNs();
+    for (size_t q = 0; q < queries; q++) {
+        for (auto it = fences.begin(); it != fences.end(); ++it) {
+            if (GeofenceStore::distance(points[q * 2], points[q * 2 + 1],
+                    it->second.latitude, it->second.longitude) <= it->second.radius) {
+                mapFound[q].push_back(it->first);
+            }
+        }
+    }
+    mapTimes.query = (double)(nowNs() - start) / queries;
+
+    GeofenceStore store;
+    start = nowNs();
+    for (size_t i = 0; i < count; i++) {
+        store.save(hwIds[i], objects[i]);
+    }
+    storeTimes.add = (double)(nowNs() - start) / count;
+    start = nowNs();
+    for (size_t i = 0; i < count; i++) {
+        uint32_t hwId = 0;
+        store.findHwId(objects[i].key, hwId);
+        sink += hwId;
+    }
+    storeTimes.keyLookup = (double)(nowNs() - start) / count;
+    start = nowNs();
+    for (size_t i = 0; i < count; i++) {
+        GeofenceObject* object = store.find(removeOrder[i]);
+        sink += (nullptr != object) ? object->key.id : 0;
+    }
+    storeTimes.hwIdLookup = (double)(nowNs() - start) / count;
+    std::vector<std::vector<uint32_t> > storeFound(queries);
+    start = nowNs();
+    for (size_t q = 0; q < queries; q++) {
+        store.findContaining(points[q * 2], points[q * 2 + 1], storeFound[q]);
+    }
+    storeTimes.query = (double)(nowNs() - start) / queries;
+
+    bool ok = store.size() == fences.size();
+    size_t matches = 0;
+    for (size_t q = 0; q < queries && ok; q++) {
+        std::sort(storeFound[q].begin(), storeFound[q].end());
+        ok = mapFound[q] == storeFound[q];
+        matches += mapFound[q].size();
+    }
+    for (size_t i = 0; i < count && ok; i++) {
+        uint32_t hwId = 0;
+        GeofenceObject* object = store.find(hwIds[i]);
+        ok = store.findHwId(objects[i].key, hwId) && hwId == hwIds[i] &&
+                nullptr != object && object->key == objects[i].key;
+    }
+
+    start = nowNs();
+    for (size_t i = 0; i < count; i++) {
+        auto it = fences.find(removeOrder[i]);
+        ids.erase(it->second.key);
+        fences.erase(it);
+    }
+    mapTimes.remove = (double)(nowNs() - start) / count;
+    start = nowNs();
+    for (size_t i = 0; i < count / 2; i++) {
+        store.remove(removeOrder[i]);
+    }
+    // the remaining half have moved in the dense array, check they are still found
+    for (size_t i = count / 2; i < count && ok; i++) {
+        uint32_t hwId = 0;
+        GeofenceObject* object = store.find(removeOrder[i]);
+        ok = nullptr != object && store.findHwId(object->key, hwId) && hwId == removeOrder[i];
+    }
+    for (size_t i = count / 2; i < count; i++) {
+        store.remove(removeOrder[i]);
+    }
+    storeTimes.remove = (double)(nowNs() - start) / count;
+    std::vector<uint32_t> left;
+    for (size_t q = 0; q < queries; q++) {
+        store.findContaining(points[q * 2], points[q * 2 + 1], left);
+    }
+    ok = ok && store.empty() && left.empty() && !store.remove(hwIds[0]);
+    printf("%6zu fences: %zu queries matched %zu fences, %s\n", count,
+           queries, matches, ok ? "same as map" : "MISMATCH");
+    return ok;
+}
+
+int main() {
+    const size_t counts[] = { 100, 10000, 100000 };
+    bool ok = true;
+    srand(1);
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        BenchTimes mapTimes, storeTimes;
+        ok = benchFences(counts[c], (counts[c] > 10000) ? 200 : 1000,
+                         mapTimes, storeTimes) && ok;
+        printf("        ns/op       add  key->hwId  hwId->fence      query   remove\n");
+        printf("        map    %7.1f    %7.1f      %7.1f %10.1f  %7.1f\n", mapTimes.add,
+               mapTimes.keyLookup, mapTimes.hwIdLookup, mapTimes.query, mapTimes.remove);
+        printf("        store  %7.1f    %7.1f      %7.1f %10.1f  %7.1f\n", storeTimes.add,
+               storeTimes.keyLookup, storeTimes.hwIdLookup, storeTimes.query,
+               storeTimes.remove);
+    }
+    return ok ? 0 : 1;
+}
+
+#endif /* __LOC_DEBUG__ */
@@ -0,0 +1,252 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef GEOFENCE_STORE_H
+#define GEOFENCE_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include <LocationAPI.h>
+
+typedef struct GeofenceKey {
+    LocationAPI* client;
+    uint32_t id;
+    inline GeofenceKey() :
+        client(NULL), id(0) {}
+    inline GeofenceKey(LocationAPI* _client, uint32_t _id) :
+        client(_client), id(_id) {}
+} GeofenceKey;
+inline bool operator <(GeofenceKey const& left, GeofenceKey const& right) {
+    return left.id < right.id || (left.id == right.id && left.client < right.client);
+}
+inline bool operator ==(GeofenceKey const& left, GeofenceKey const& right) {
+    return left.id == right.id && left.client == right.client;
+}
+inline bool operator !=(GeofenceKey const& left, GeofenceKey const& right) {
+    return left.id != right.id || left.client != right.client;
+}
+typedef struct {
+    GeofenceKey key;
+    GeofenceBreachTypeMask breachMask;
+    uint32_t responsiveness;
+    uint32_t dwellTime;
+    double latitude;
+    double longitude;
+    double radius;
+    bool paused;
+} GeofenceObject;
+
+// edge of a spatial index cell, about 11 km of latitude
+#define GEOFENCE_GRID_CELL_DEGREES (0.1)
+// the grid has this many levels, each with cells 16 times larger than the
+// level below; a fence goes in the finest level where it spans no more
+// than GEOFENCE_GRID_MAX_CELLS cells, or else is checked on every query
+#define GEOFENCE_GRID_LEVELS (2)
+#define GEOFENCE_GRID_MAX_CELLS (64)
+
+/* Open addressing hash index from a key to a uint32_t, with linear probing
+   and backward shift deletion, so it stays tombstone free however many
+   fences come and go. */
+template <typename KEY, typename HASH>
+class GeofenceFlatIndex {
+    struct Slot {
+        KEY key;
+        uint32_t value;
+        bool used;
+    };
+    std::vector<Slot> mSlots; // power of 2 sized
+    size_t mSize;
+
+    inline size_t home(const KEY& key) const {
+        return HASH()(key) & (mSlots.size() - 1);
+    }
+    void grow();
+public:
+    inline GeofenceFlatIndex() : mSize(0) {}
+    inline size_t size() const { return mSize; }
+    inline void clear() { mSlots.clear(); mSize = 0; }
+    const uint32_t* find(const KEY& key) const;
+    void set(const KEY& key, uint32_t value);
+    bool erase(const KEY& key);
+};
+
+template <typename KEY, typename HASH>
+void GeofenceFlatIndex<KEY, HASH>::grow() {
+    std::vector<Slot> slots(mSlots.empty() ? 16 : mSlots.size() * 2);
+    slots.swap(mSlots);
+    size_t mask = mSlots.size() - 1;
+    for (size_t i = 0; i < mSlots.size(); i++) {
+        mSlots[i].used = false;
+    }
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i].used) {
+            size_t j = home(slots[i].key);
+            while (mSlots[j].used) {
+                j = (j + 1) & mask;
+            }
+            mSlots[j] = slots[i];
+        }
+    }
+}
+
+template <typename KEY, typename HASH>
+const uint32_t* GeofenceFlatIndex<KEY, HASH>::find(const KEY& key) const {
+    if (0 == mSize) {
+        return nullptr;
+    }
+    size_t mask = mSlots.size() - 1;
+    for (size_t i = home(key); mSlots[i].used; i = (i + 1) & mask) {
+        if (mSlots[i].key == key) {
+            return &mSlots[i].value;
+        }
+    }
+    return nullptr;
+}
+
+template <typename KEY, typename HASH>
+void GeofenceFlatIndex<KEY, HASH>::set(const KEY& key, uint32_t value) {
+    // keep the load under 3/4
+    if ((mSize + 1) * 4 > mSlots.size() * 3) {
+        grow();
+    }
+    size_t mask = mSlots.size() - 1;
+    size_t i = home(key);
+    for (; mSlots[i].used; i = (i + 1) & mask) {
+        if (mSlots[i].key == key) {
+            mSlots[i].value = value;
+            return;
+        }
+    }
+    mSlots[i].key = key;
+    mSlots[i].value = value;
+    mSlots[i].used = true;
+    mSize++;
+}
+
+template <typename KEY, typename HASH>
+bool GeofenceFlatIndex<KEY, HASH>::erase(const KEY& key) {
+    if (0 == mSize) {
+        return false;
+    }
+    size_t mask = mSlots.size() - 1;
+    size_t i = home(key);
+    while (mSlots[i].used && !(mSlots[i].key == key)) {
+        i = (i + 1) & mask;
+    }
+    if (!mSlots[i].used) {
+        return false;
+    }
+    mSlots[i].used = false;
+    mSize--;
+    // shift back the entries of the probe run that i is now a hole in
+    for (size_t j = (i + 1) & mask; mSlots[j].used; j = (j + 1) & mask) {
+        size_t k = home(mSlots[j].key);
+        if (((j - k) & mask) >= ((j - i) & mask)) {
+            mSlots[i] = mSlots[j];
+            mSlots[j].used = false;
+            i = j;
+        }
+    }
+    return true;
+}
+
+struct GeofenceHwIdHash {
+    inline size_t operator()(uint32_t hwId) const {
+        return (size_t)((hwId * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+};
+
+struct GeofenceCellHash {
+    inline size_t operator()(uint64_t cell) const {
+        return (size_t)(((cell ^ (cell >> 29)) * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+};
+
+struct GeofenceKeyHash {
+    inline size_t operator()(const GeofenceKey& key) const {
+        uint64_t h = (uint64_t)(uintptr_t)key.client ^ ((uint64_t)key.id << 32) ^ key.id;
+        return (size_t)((h * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+};
+
+/* The geofences added to the modem, by hwId, with
+   - the fence records in a dense array,
+   - flat hash indexes from hwId and from client key to the records, and
+   - a lat/lon grid of fence coverage, answering which fences contain a
+     point without looking at all of them.
+   Iteration order is that of the dense array, which removals reorder. */
+class GeofenceStore {
+    std::vector<uint32_t> mHwIds;
+    std::vector<GeofenceObject> mObjects;
+    GeofenceFlatIndex<uint32_t, GeofenceHwIdHash> mIndexOfHwId;
+    GeofenceFlatIndex<GeofenceKey, GeofenceKeyHash> mHwIdOfKey;
+
+    // grid cells, packed level and lat/lon cell numbers to bucket of hwIds
+    GeofenceFlatIndex<uint64_t, GeofenceCellHash> mCellIndex;
+    std::vector<std::vector<uint32_t> > mCells;
+    std::vector<uint32_t> mFreeCells;
+    std::vector<uint32_t> mLargeFences;
+
+    bool getCells(const GeofenceObject& object, uint32_t level, int32_t& latMin, int32_t& latMax,
+                  int32_t& lonMin, int32_t& lonMax) const;
+    void indexFence(uint32_t hwId, const GeofenceObject& object);
+    void unindexFence(uint32_t hwId, const GeofenceObject& object);
+public:
+    inline size_t size() const { return mObjects.size(); }
+    inline bool empty() const { return mObjects.empty(); }
+    inline uint32_t hwIdAt(size_t i) const { return mHwIds[i]; }
+    inline const GeofenceObject& objectAt(size_t i) const { return mObjects[i]; }
+
+    // adds the fence of hwId, or replaces it
+    void save(uint32_t hwId, const GeofenceObject& object);
+    // false when hwId is not known
+    bool remove(uint32_t hwId);
+    void clear();
+    // moves all fences to the given arrays, leaving the store empty
+    void take(std::vector<uint32_t>& hwIds, std::vector<GeofenceObject>& objects);
+
+    inline GeofenceObject* find(uint32_t hwId) {
+        const uint32_t* index = mIndexOfHwId.find(hwId);
+        return (nullptr != index) ? &mObjects[*index] : nullptr;
+    }
+    inline bool findHwId(const GeofenceKey& key, uint32_t& hwId) const {
+        const uint32_t* found = mHwIdOfKey.find(key);
+        if (nullptr != found) {
+            hwId = *found;
+        }
+        return nullptr != found;
+    }
+    // appends the hwIds of the fences whose circle contains the point
+    void findContaining(double latitude, double longitude, std::vector<uint32_t>& hwIds) const;
+
+    // great circle distance in meters, as used for fence containment
+    static double distance(double lat1, double lon1, double lat2, double lon2);
+};
+
+#endif /* GEOFENCE_STORE_H */
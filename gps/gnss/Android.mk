@@ -23,6 +23,8 @@ LOCAL_SHARED_LIBRARIES := \
 LOCAL_SRC_FILES += \
     location_gnss.cpp \
     GnssAdapter.cpp \
+    GnssClientDispatch.cpp \
+    GnssSvUsedInFix.cpp \
     Agps.cpp \
     XtraSystemStatusObserver.cpp
 
@@ -41,16 +41,19 @@
 #include <GnssAdapter.h>
 #include <string>
 #include <sstream>
+#include <memory>
 #include <loc_log.h>
 #include <loc_nmea.h>
 #include <Agps.h>
 #include <SystemStatus.h>
+#include <LocMsgPool.h>
 
 #include <vector>
 
 #define RAD2DEG    (180.0 / M_PI)
 #define PROCESS_NAME_ENGINE_SERVICE "engine-service"
 #define MIN_TRACKING_INTERVAL (100) // 100 msec
+#define NMEA_INLINE_BUF_SIZE (256)
 
 using namespace loc_core;
 
@@ -70,8 +73,6 @@ GnssAdapter::GnssAdapter() :
                                                    false), true, nullptr),
     mEngHubProxy(new EngineHubProxyBase()),
     mLocPositionMode(),
-    mGnssSvIdUsedInPosition(),
-    mGnssSvIdUsedInPosAvail(false),
     mControlCallbacks(),
     mAfwControlId(0),
     mNmeaMask(0),
@@ -95,8 +96,6 @@ GnssAdapter::GnssAdapter() :
     mGnssEnergyConsumedCb(nullptr),
     mPowerStateCb(nullptr),
     mIsE911Session(NULL),
-    mGnssMbSvIdUsedInPosition{},
-    mGnssMbSvIdUsedInPosAvail(false),
     mSupportNfwControl(true)
 {
     LOC_LOGD("%s]: Constructor %p", __func__, this);
@@ -2054,6 +2053,9 @@ GnssAdapter::stopClientSessions(LocationAPI* client)
 void
 GnssAdapter::updateClientsEventMask()
 {
+    // clients were added or removed, report paths dispatch from these lists
+    mClientDispatch.rebuild(mClientData);
+
     LOC_API_ADAPTER_EVENT_MASK_T mask = 0;
     for (auto it=mClientData.begin(); it != mClientData.end(); ++it) {
         if (it->second.trackingCb != nullptr || it->second.gnssLocationInfoCb != nullptr) {
@@ -3086,7 +3088,7 @@ GnssAdapter::reportPositionEvent(const UlpLocation& ulpLocation,
     // Fix is from QMI, and it is not an
     // unpropagated position and engine hub is not loaded, queue the msg
     // when message is queued, the position can be dispatched to requesting client
-    struct MsgReportPosition : public LocMsg {
+    struct MsgReportPosition : public LocMsg, public LocPooledMsg<MsgReportPosition> {
         GnssAdapter& mAdapter;
         const UlpLocation mUlpLocation;
         const GpsLocationExtended mLocationExtended;
@@ -3144,7 +3146,7 @@ void
 GnssAdapter::reportEnginePositionsEvent(unsigned int count,
                                         EngineLocationInfo* locationArr)
 {
-    struct MsgReportEnginePositions : public LocMsg {
+    struct MsgReportEnginePositions : public LocMsg, public LocPooledMsg<MsgReportEnginePositions> {
         GnssAdapter& mAdapter;
         unsigned int mCount;
         EngineLocationInfo mEngLocInfo[LOC_OUTPUT_ENGINE_COUNT];
@@ -3200,11 +3202,7 @@ GnssAdapter::needReportForFlpClient(enum loc_sess_status status,
 bool
 GnssAdapter::isFlpClient(LocationCallbacks& locationCallbacks)
 {
-    return (locationCallbacks.gnssLocationInfoCb == nullptr &&
-            locationCallbacks.gnssSvCb == nullptr &&
-            locationCallbacks.gnssNmeaCb == nullptr &&
-            locationCallbacks.gnssDataCb == nullptr &&
-            locationCallbacks.gnssMeasurementsCb == nullptr);
+    return GnssClientDispatch::isFlpClient(locationCallbacks);
 }
 
 void
@@ -3221,12 +3219,13 @@ GnssAdapter::reportPosition(const UlpLocation& ulpLocation,
         convertLocationInfo(locationInfo, locationExtended);
         convertLocation(locationInfo.location, ulpLocation, locationExtended, techMask);
 
-        for (auto it=mClientData.begin(); it != mClientData.end(); ++it) {
-            if ((reportToFlpClient && isFlpClient(it->second)) ||
-                    (reportToGnssClient && !isFlpClient(it->second))) {
-                if (nullptr != it->second.gnssLocationInfoCb) {
-                    it->second.gnssLocationInfoCb(locationInfo);
-                } else if ((nullptr != it->second.engineLocationsInfoCb) &&
+        for (auto it = mClientDispatch.mPosition.begin();
+                it != mClientDispatch.mPosition.end(); ++it) {
+            if ((reportToFlpClient && it->isFlp) ||
+                    (reportToGnssClient && !it->isFlp)) {
+                if (nullptr != it->gnssLocationInfoCb) {
+                    it->gnssLocationInfoCb(locationInfo);
+                } else if ((nullptr != it->engineLocationsInfoCb) &&
                         (false == initEngHubProxy())) {
                     // if engine hub is disabled, this is SPE fix from modem
                     // we need to mark one copy marked as fused and one copy marked as PPE
@@ -3236,23 +3235,19 @@ GnssAdapter::reportPosition(const UlpLocation& ulpLocation,
                     engLocationsInfo[0].locOutputEngType = LOC_OUTPUT_ENGINE_FUSED;
                     engLocationsInfo[0].flags |= GNSS_LOCATION_INFO_OUTPUT_ENG_TYPE_BIT;
                     engLocationsInfo[1] = locationInfo;
-                    it->second.engineLocationsInfoCb(2, engLocationsInfo);
-                } else if (nullptr != it->second.trackingCb) {
-                    it->second.trackingCb(locationInfo.location);
+                    it->engineLocationsInfoCb(2, engLocationsInfo);
+                } else if (nullptr != it->trackingCb) {
+                    it->trackingCb(locationInfo.location);
                 }
             }
         }
 
-        mGnssSvIdUsedInPosAvail = false;
-        mGnssMbSvIdUsedInPosAvail = false;
+        mSvUsedInFix.clear();
         if (reportToGnssClient) {
             if (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_GNSS_SV_USED_DATA) {
-                mGnssSvIdUsedInPosAvail = true;
-                mGnssSvIdUsedInPosition = locationExtended.gnss_sv_used_ids;
-                if (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_MULTIBAND) {
-                    mGnssMbSvIdUsedInPosAvail = true;
-                    mGnssMbSvIdUsedInPosition = locationExtended.gnss_mb_sv_used_ids;
-                }
+                mSvUsedInFix.update(locationExtended.gnss_sv_used_ids,
+                        (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_MULTIBAND) ?
+                        &locationExtended.gnss_mb_sv_used_ids : nullptr);
             }
 
             // if engine hub is running and the fix is from sensor, e.g.: DRE,
@@ -3273,15 +3268,10 @@ GnssAdapter::reportPosition(const UlpLocation& ulpLocation,
                           (LOC_RELIABILITY_NOT_SET == locationExtended.horizontal_reliability));
         uint8_t generate_nmea = (reportToGnssClient && status != LOC_SESS_FAILURE && !blank_fix);
         bool custom_nmea_gga = (1 == ContextBase::mGps_conf.CUSTOM_NMEA_GGA_FIX_QUALITY_ENABLED);
-        std::vector<std::string> nmeaArraystr;
+        LocNmeaWriter writer(mNmeaBuffer, sizeof(mNmeaBuffer), reportNmeaChunk, this);
         loc_nmea_generate_pos(ulpLocation, locationExtended, mLocSystemInfo,
-                              generate_nmea, custom_nmea_gga, nmeaArraystr);
-        stringstream ss;
-        for (auto itor = nmeaArraystr.begin(); itor != nmeaArraystr.end(); ++itor) {
-            ss << *itor;
-        }
-        string s = ss.str();
-        reportNmea(s.c_str(), s.length());
+                              generate_nmea, custom_nmea_gga, writer);
+        writer.flush();
     }
 }
 
@@ -3289,13 +3279,7 @@ void
 GnssAdapter::reportEnginePositions(unsigned int count,
                                    const EngineLocationInfo* locationArr)
 {
-    bool needReportEnginePositions = false;
-    for (auto it=mClientData.begin(); it != mClientData.end(); ++it) {
-        if (nullptr != it->second.engineLocationsInfoCb) {
-            needReportEnginePositions = true;
-            break;
-        }
-    }
+    bool needReportEnginePositions = !mClientDispatch.mEngineLocations.empty();
 
     GnssLocationInfoNotification locationInfo[LOC_OUTPUT_ENGINE_COUNT] = {};
     for (unsigned int i = 0; i < count; i++) {
@@ -3318,12 +3302,9 @@ GnssAdapter::reportEnginePositions(unsigned int count,
         }
     }
 
-    if (needReportEnginePositions) {
-        for (auto it=mClientData.begin(); it != mClientData.end(); ++it) {
-            if (nullptr != it->second.engineLocationsInfoCb) {
-                it->second.engineLocationsInfoCb(count, locationInfo);
-            }
-        }
+    for (auto it = mClientDispatch.mEngineLocations.begin();
+            it != mClientDispatch.mEngineLocations.end(); ++it) {
+        (*it)(count, locationInfo);
     }
 }
 
@@ -3338,7 +3319,7 @@ GnssAdapter::reportSvEvent(const GnssSvNotification& svNotify,
         }
     }
 
-    struct MsgReportSv : public LocMsg {
+    struct MsgReportSv : public LocMsg, public LocPooledMsg<MsgReportSv> {
         GnssAdapter& mAdapter;
         const GnssSvNotification mSvNotify;
         inline MsgReportSv(GnssAdapter& adapter,
@@ -3357,158 +3338,30 @@ GnssAdapter::reportSvEvent(const GnssSvNotification& svNotify,
 void
 GnssAdapter::reportSv(GnssSvNotification& svNotify)
 {
-    int numSv = svNotify.count;
-    int16_t gnssSvId = 0;
-    uint64_t svUsedIdMask = 0;
-    for (int i=0; i < numSv; i++) {
-        svUsedIdMask = 0;
-        gnssSvId = svNotify.gnssSvs[i].svId;
-        GnssSignalTypeMask signalTypeMask = svNotify.gnssSvs[i].gnssSignalTypeMask;
-        switch (svNotify.gnssSvs[i].type) {
-            case GNSS_SV_TYPE_GPS:
-                if (mGnssSvIdUsedInPosAvail) {
-                    if (mGnssMbSvIdUsedInPosAvail) {
-                        switch (signalTypeMask) {
-                        case GNSS_SIGNAL_GPS_L1CA:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.gps_l1ca_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_GPS_L1C:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.gps_l1c_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_GPS_L2:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.gps_l2_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_GPS_L5:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.gps_l5_sv_used_ids_mask;
-                            break;
-                        }
-                    } else {
-                        svUsedIdMask = mGnssSvIdUsedInPosition.gps_sv_used_ids_mask;
-                    }
-                }
-                break;
-            case GNSS_SV_TYPE_GLONASS:
-                if (mGnssSvIdUsedInPosAvail) {
-                    if (mGnssMbSvIdUsedInPosAvail) {
-                        switch (signalTypeMask) {
-                        case GNSS_SIGNAL_GLONASS_G1:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.glo_g1_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_GLONASS_G2:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.glo_g2_sv_used_ids_mask;
-                            break;
-                        }
-                    } else {
-                        svUsedIdMask = mGnssSvIdUsedInPosition.glo_sv_used_ids_mask;
-                    }
-                }
-                break;
-            case GNSS_SV_TYPE_BEIDOU:
-                if (mGnssSvIdUsedInPosAvail) {
-                    if (mGnssMbSvIdUsedInPosAvail) {
-                        switch (signalTypeMask) {
-                        case GNSS_SIGNAL_BEIDOU_B1I:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.bds_b1i_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_BEIDOU_B1C:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.bds_b1c_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_BEIDOU_B2I:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.bds_b2i_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_BEIDOU_B2AI:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.bds_b2ai_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_BEIDOU_B2AQ:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.bds_b2aq_sv_used_ids_mask;
-                            break;
-                        }
-                    } else {
-                        svUsedIdMask = mGnssSvIdUsedInPosition.bds_sv_used_ids_mask;
-                    }
-                }
-                break;
-            case GNSS_SV_TYPE_GALILEO:
-                if (mGnssSvIdUsedInPosAvail) {
-                    if (mGnssMbSvIdUsedInPosAvail) {
-                        switch (signalTypeMask) {
-                        case GNSS_SIGNAL_GALILEO_E1:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.gal_e1_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_GALILEO_E5A:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.gal_e5a_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_GALILEO_E5B:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.gal_e5b_sv_used_ids_mask;
-                            break;
-                        }
-                    } else {
-                        svUsedIdMask = mGnssSvIdUsedInPosition.gal_sv_used_ids_mask;
-                    }
-                }
-                break;
-            case GNSS_SV_TYPE_QZSS:
-                if (mGnssSvIdUsedInPosAvail) {
-                    if (mGnssMbSvIdUsedInPosAvail) {
-                        switch (signalTypeMask) {
-                        case GNSS_SIGNAL_QZSS_L1CA:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.qzss_l1ca_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_QZSS_L1S:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.qzss_l1s_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_QZSS_L2:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.qzss_l2_sv_used_ids_mask;
-                            break;
-                        case GNSS_SIGNAL_QZSS_L5:
-                            svUsedIdMask = mGnssMbSvIdUsedInPosition.qzss_l5_sv_used_ids_mask;
-                            break;
-                        }
-                    } else {
-                        svUsedIdMask = mGnssSvIdUsedInPosition.qzss_sv_used_ids_mask;
-                    }
-                }
-                // QZSS SV id's need to reported as it is to framework, since
-                // framework expects it as it is. See GnssStatus.java.
-                // SV id passed to here by LocApi is 1-based.
-                svNotify.gnssSvs[i].svId += (QZSS_SV_PRN_MIN - 1);
-                break;
-            case GNSS_SV_TYPE_NAVIC:
-                if (mGnssSvIdUsedInPosAvail) {
-                    svUsedIdMask = mGnssSvIdUsedInPosition.navic_sv_used_ids_mask;
-                }
-                break;
-            default:
-                svUsedIdMask = 0;
-                break;
-        }
-
+    for (uint32_t i = 0; i < svNotify.count; i++) {
+        GnssSv& gnssSv = svNotify.gnssSvs[i];
         // If SV ID was used in previous position fix, then set USED_IN_FIX
         // flag, else clear the USED_IN_FIX flag.
-        if ((gnssSvId < 64) && (svUsedIdMask & (1ULL << (gnssSvId - 1)))) {
-            svNotify.gnssSvs[i].gnssSvOptionsMask |= GNSS_SV_OPTIONS_USED_IN_FIX_BIT;
-        }
+        gnssSv.gnssSvOptionsMask |= GNSS_SV_OPTIONS_USED_IN_FIX_BIT *
+                mSvUsedInFix.isUsed(gnssSv.type, gnssSv.gnssSignalTypeMask, gnssSv.svId);
+        // QZSS SV id's need to reported as it is to framework, since
+        // framework expects it as it is. See GnssStatus.java.
+        // SV id passed to here by LocApi is 1-based.
+        gnssSv.svId += (QZSS_SV_PRN_MIN - 1) * (GNSS_SV_TYPE_QZSS == gnssSv.type);
     }
 
-    for (auto it=mClientData.begin(); it != mClientData.end(); ++it) {
-        if (nullptr != it->second.gnssSvCb) {
-            it->second.gnssSvCb(svNotify);
-        }
+    for (auto it = mClientDispatch.mSv.begin(); it != mClientDispatch.mSv.end(); ++it) {
+        (*it)(svNotify);
     }
 
     if (NMEA_PROVIDER_AP == ContextBase::mGps_conf.NMEA_PROVIDER &&
         !mTimeBasedTrackingSessions.empty()) {
-        std::vector<std::string> nmeaArraystr;
-        loc_nmea_generate_sv(svNotify, nmeaArraystr);
-        stringstream ss;
-        for (auto itor = nmeaArraystr.begin(); itor != nmeaArraystr.end(); ++itor) {
-            ss << *itor;
-        }
-        string s = ss.str();
-        reportNmea(s.c_str(), s.length());
+        LocNmeaWriter writer(mNmeaBuffer, sizeof(mNmeaBuffer), reportNmeaChunk, this);
+        loc_nmea_generate_sv(svNotify, writer);
+        writer.flush();
     }
 
-    mGnssSvIdUsedInPosAvail = false;
+    mSvUsedInFix.clear();
 }
 
 void
@@ -3519,8 +3372,10 @@ GnssAdapter::reportNmeaEvent(const char* nmea, size_t length)
         return;
     }
 
-    struct MsgReportNmea : public LocMsg {
+    struct MsgReportNmea : public LocMsg, public LocPooledMsg<MsgReportNmea> {
         GnssAdapter& mAdapter;
+        // sentences that fit are carried inline, sparing a heap allocation
+        char mNmeaBuf[NMEA_INLINE_BUF_SIZE];
         const char* mNmea;
         size_t mLength;
         inline MsgReportNmea(GnssAdapter& adapter,
@@ -3528,7 +3383,7 @@ GnssAdapter::reportNmeaEvent(const char* nmea, size_t length)
                              size_t length) :
             LocMsg(),
             mAdapter(adapter),
-            mNmea(new char[length+1]),
+            mNmea((length < sizeof(mNmeaBuf)) ? mNmeaBuf : new char[length+1]),
             mLength(length) {
                 if (mNmea == nullptr) {
                     LOC_LOGE("%s] new allocation failed, fatal error.", __func__);
@@ -3538,7 +3393,9 @@ GnssAdapter::reportNmeaEvent(const char* nmea, size_t length)
             }
         inline virtual ~MsgReportNmea()
         {
-            delete[] mNmea;
+            if (mNmea != mNmeaBuf) {
+                delete[] mNmea;
+            }
         }
         inline virtual void proc() const {
             // extract bug report info - this returns true if consumed by systemstatus
@@ -3570,18 +3427,22 @@ GnssAdapter::reportNmea(const char* nmea, size_t length)
     nmeaNotification.nmea = nmea;
     nmeaNotification.length = length;
 
-    for (auto it=mClientData.begin(); it != mClientData.end(); ++it) {
-        if (nullptr != it->second.gnssNmeaCb) {
-            it->second.gnssNmeaCb(nmeaNotification);
-        }
+    for (auto it = mClientDispatch.mNmea.begin(); it != mClientDispatch.mNmea.end(); ++it) {
+        (*it)(nmeaNotification);
     }
 }
 
+void
+GnssAdapter::reportNmeaChunk(void* context, const char* nmea, size_t length)
+{
+    ((GnssAdapter*)context)->reportNmea(nmea, length);
+}
+
 void
 GnssAdapter::reportDataEvent(const GnssDataNotification& dataNotify,
                              int msInWeek)
 {
-    struct MsgReportData : public LocMsg {
+    struct MsgReportData : public LocMsg, public LocPooledMsg<MsgReportData> {
         GnssAdapter& mAdapter;
         GnssDataNotification mDataNotify;
         int mMsInWeek;
@@ -3618,10 +3479,8 @@ GnssAdapter::reportData(GnssDataNotification& dataNotify)
             LOC_LOGv("agc[%d]=%f", sig, dataNotify.agc[sig]);
         }
     }
-    for (auto it = mClientData.begin(); it != mClientData.end(); ++it) {
-        if (nullptr != it->second.gnssDataCb) {
-            it->second.gnssDataCb(dataNotify);
-        }
+    for (auto it = mClientDispatch.mData.begin(); it != mClientDispatch.mData.end(); ++it) {
+        (*it)(dataNotify);
     }
 }
 
@@ -3735,10 +3594,9 @@ GnssAdapter::reportLocationSystemInfo(const LocationSystemInfo & locationSystemI
 
     // we received new info, inform client of the newly received info
     if (locationSystemInfo.systemInfoMask) {
-        for (auto it=mClientData.begin(); it != mClientData.end(); ++it) {
-            if (it->second.locationSystemInfoCb != nullptr) {
-                it->second.locationSystemInfoCb(locationSystemInfo);
-            }
+        for (auto it = mClientDispatch.mLocationSystemInfo.begin();
+                it != mClientDispatch.mLocationSystemInfo.end(); ++it) {
+            (*it)(locationSystemInfo);
         }
     }
 }
@@ -3898,7 +3756,8 @@ GnssAdapter::reportGnssMeasurementsEvent(const GnssMeasurements& gnssMeasurement
     LOC_LOGD("%s]: msInWeek=%d", __func__, msInWeek);
 
     if (0 != gnssMeasurements.gnssMeasNotification.count) {
-        struct MsgReportGnssMeasurementData : public LocMsg {
+        struct MsgReportGnssMeasurementData : public LocMsg,
+                public LocPooledMsg<MsgReportGnssMeasurementData> {
             GnssAdapter& mAdapter;
             GnssMeasurements mGnssMeasurements;
             GnssMeasurementsNotification mMeasurementsNotify;
@@ -3925,10 +3784,9 @@ GnssAdapter::reportGnssMeasurementsEvent(const GnssMeasurements& gnssMeasurement
 void
 GnssAdapter::reportGnssMeasurementData(const GnssMeasurementsNotification& measurements)
 {
-    for (auto it=mClientData.begin(); it != mClientData.end(); ++it) {
-        if (nullptr != it->second.gnssMeasurementsCb) {
-            it->second.gnssMeasurementsCb(measurements);
-        }
+    for (auto it = mClientDispatch.mMeasurements.begin();
+            it != mClientDispatch.mMeasurements.end(); ++it) {
+        (*it)(measurements);
     }
 }
 
@@ -4594,7 +4452,9 @@ bool GnssAdapter::getDebugReport(GnssDebugReport& r)
         return false;
     }
 
-    SystemStatusReports reports = {};
+    // called from client threads, the reports are too large for their stacks
+    std::unique_ptr<SystemStatusReports> latestReports(new SystemStatusReports());
+    SystemStatusReports& reports = *latestReports;
     systemstatus->getReport(reports, true);
 
     r.size = sizeof(r);
@@ -4701,7 +4561,7 @@ GnssAdapter::getAgcInformation(GnssMeasurementsNotification& measurements, int m
     SystemStatus* systemstatus = getSystemStatus();
 
     if (nullptr != systemstatus) {
-        SystemStatusReports reports = {};
+        SystemStatusReports& reports = mStatusReports;
         systemstatus->getReport(reports, true);
 
         if ((!reports.mRfAndParams.empty()) && (!reports.mTimeAndClock.empty()) &&
@@ -4756,7 +4616,7 @@ GnssAdapter::getDataInformation(GnssDataNotification& data, int msInWeek)
 
     LOC_LOGV("%s]: msInWeek=%d", __func__, msInWeek);
     if (nullptr != systemstatus) {
-        SystemStatusReports reports = {};
+        SystemStatusReports& reports = mStatusReports;
         systemstatus->getReport(reports, true);
 
         if ((!reports.mRfAndParams.empty()) && (!reports.mTimeAndClock.empty()) &&
@@ -37,6 +37,9 @@
 #include <Agps.h>
 #include <SystemStatus.h>
 #include <XtraSystemStatusObserver.h>
+#include <GnssClientDispatch.h>
+#include <GnssSvUsedInFix.h>
+#include <loc_nmea.h>
 #include <map>
 
 #define MAX_URL_LEN 256
@@ -143,10 +146,8 @@ class GnssAdapter : public LocAdapterBase {
     TrackingOptionsMap mTimeBasedTrackingSessions;
     LocationSessionMap mDistanceBasedTrackingSessions;
     LocPosMode mLocPositionMode;
-    GnssSvUsedInPosition mGnssSvIdUsedInPosition;
-    bool mGnssSvIdUsedInPosAvail;
-    GnssSvMbUsedInPosition mGnssMbSvIdUsedInPosition;
-    bool mGnssMbSvIdUsedInPosAvail;
+    // SVs used in the last position, until the following SV report
+    GnssSvUsedInFixTable mSvUsedInFix;
 
     /* ==== CONTROL ======================================================================== */
     LocationControlCallbacks mControlCallbacks;
@@ -192,6 +193,13 @@ class GnssAdapter : public LocAdapterBase {
     BlockCPIInfo mBlockCPIInfo;
     bool mPowerOn;
     uint32_t mAllowFlpNetworkFixes;
+    // NMEA sentences of the current report, only used on the msg task thread
+    char mNmeaBuffer[NMEA_EPOCH_MAX_LENGTH];
+    // latest SystemStatus reports, only used on the msg task thread, whose
+    // stack they are too large for
+    SystemStatusReports mStatusReports;
+    // interested clients per report type, rebuilt in updateClientsEventMask()
+    GnssClientDispatch mClientDispatch;
 
     /* === Misc callback from QMI LOC API ============================================== */
     GnssEnergyConsumedCallback mGnssEnergyConsumedCb;
@@ -391,6 +399,8 @@ public:
                                const EngineLocationInfo* locationArr);
     void reportSv(GnssSvNotification& svNotify);
     void reportNmea(const char* nmea, size_t length);
+    // LocNmeaFlushCb reporting the sentences a full mNmeaBuffer hands off
+    static void reportNmeaChunk(void* context, const char* nmea, size_t length);
     void reportData(GnssDataNotification& dataNotify);
     bool requestNiNotify(const GnssNiNotification& notify, const void* data,
                          const bool bInformNiAccept);
@@ -0,0 +1,259 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_NDEBUG 0
+#define LOG_TAG "LocSvc_GnssClientDispatch"
+
+#include <GnssClientDispatch.h>
+
+void
+GnssClientDispatch::rebuild(const std::map<LocationAPI*, LocationCallbacks>& clients)
+{
+    mPosition.clear();
+    mEngineLocations.clear();
+    mSv.clear();
+    mNmea.clear();
+    mData.clear();
+    mMeasurements.clear();
+    mLocationSystemInfo.clear();
+
+    for (auto it = clients.begin(); it != clients.end(); ++it) {
+        const LocationCallbacks& callbacks = it->second;
+        if (nullptr != callbacks.gnssLocationInfoCb ||
+                nullptr != callbacks.engineLocationsInfoCb ||
+                nullptr != callbacks.trackingCb) {
+            PositionClient client = {isFlpClient(callbacks), callbacks.gnssLocationInfoCb,
+                                     callbacks.engineLocationsInfoCb, callbacks.trackingCb};
+            mPosition.push_back(client);
+        }
+        if (nullptr != callbacks.engineLocationsInfoCb) {
+            mEngineLocations.push_back(callbacks.engineLocationsInfoCb);
+        }
+        if (nullptr != callbacks.gnssSvCb) {
+            mSv.push_back(callbacks.gnssSvCb);
+        }
+        if (nullptr != callbacks.gnssNmeaCb) {
+            mNmea.push_back(callbacks.gnssNmeaCb);
+        }
+        if (nullptr != callbacks.gnssDataCb) {
+            mData.push_back(callbacks.gnssDataCb);
+        }
+        if (nullptr != callbacks.gnssMeasurementsCb) {
+            mMeasurements.push_back(callbacks.gnssMeasurementsCb);
+        }
+        if (nullptr != callbacks.locationSystemInfoCb) {
+            mLocationSystemInfo.push_back(callbacks.locationSystemInfoCb);
+        }
+    }
+}
+
+bool
+GnssClientDispatch::isFlpClient(const LocationCallbacks& locationCallbacks)
+{
+    return (locationCallbacks.gnssLocationInfoCb == nullptr &&
+            locationCallbacks.gnssSvCb == nullptr &&
+            locationCallbacks.gnssNmeaCb == nullptr &&
+            locationCallbacks.gnssDataCb == nullptr &&
+            locationCallbacks.gnssMeasurementsCb == nullptr);
+}
+
+#ifdef __LOC_DEBUG__
+
+// For Linux command line benchmarking of the report fan-out:
+//     g++ -D__LOC_DEBUG__ -DFEATURE_EXTERNAL_AP -O2 -std=c++11 -I. -I../location
+//         -I../utils -I../pla/oe -o dispatch_bench GnssClientDispatch.cpp
+//     ./dispatch_bench <epochs>
+// An epoch is what GnssAdapter fans out per fix: a position, an SV report,
+// ten NMEA sentences and a data report. "map walk" is how the report paths
+// used to find their clients, by testing every client in the client map.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static inline uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#define NMEA_PER_EPOCH 10
+
+// a mix of clients as registered by the HAL, FLP, and the geofence and
+// batching APIs, which register no report callbacks at all
+static void registerClients(std::map<LocationAPI*, LocationCallbacks>& clients,
+                            uint32_t count, uint64_t& sink) {
+    for (uint32_t i = 0; i < count; i++) {
+        LocationCallbacks callbacks = {};
+        callbacks.size = sizeof(LocationCallbacks);
+        callbacks.responseCb = [&sink](LocationError, uint32_t) { sink++; };
+        switch (i % 4) {
+        case 0:
+            callbacks.gnssLocationInfoCb = [&sink](GnssLocationInfoNotification) { sink++; };
+            callbacks.gnssSvCb = [&sink](GnssSvNotification) { sink++; };
+            callbacks.gnssNmeaCb = [&sink](GnssNmeaNotification) { sink++; };
+            callbacks.gnssDataCb = [&sink](GnssDataNotification) { sink++; };
+            break;
+        case 1:
+            callbacks.trackingCb = [&sink](Location) { sink++; };
+            break;
+        case 2:
+            callbacks.trackingCb = [&sink](Location) { sink++; };
+            callbacks.gnssSvCb = [&sink](GnssSvNotification) { sink++; };
+            break;
+        default:
+            callbacks.collectiveResponseCb = [&sink](size_t, LocationError*, uint32_t*) {
+                sink++;
+            };
+            break;
+        }
+        clients[(LocationAPI*)(uintptr_t)(0x10000 + i * 0x40)] = callbacks;
+    }
+}
+
+static void mapWalkEpoch(std::map<LocationAPI*, LocationCallbacks>& clients,
+                         bool reportToGnssClient, bool reportToFlpClient,
+                         const GnssLocationInfoNotification& locationInfo,
+                         const GnssSvNotification& svNotify,
+                         const GnssNmeaNotification& nmeaNotification,
+                         const GnssDataNotification& dataNotify) {
+    for (auto it = clients.begin(); it != clients.end(); ++it) {
+        if ((reportToFlpClient && GnssClientDispatch::isFlpClient(it->second)) ||
+                (reportToGnssClient && !GnssClientDispatch::isFlpClient(it->second))) {
+            if (nullptr != it->second.gnssLocationInfoCb) {
+                it->second.gnssLocationInfoCb(locationInfo);
+            } else if (nullptr != it->second.engineLocationsInfoCb) {
+                it->second.engineLocationsInfoCb(1, (GnssLocationInfoNotification*)&locationInfo);
+            } else if (nullptr != it->second.trackingCb) {
+                it->second.trackingCb(locationInfo.location);
+            }
+        }
+    }
+    for (auto it = clients.begin(); it != clients.end(); ++it) {
+        if (nullptr != it->second.gnssSvCb) {
+            it->second.gnssSvCb(svNotify);
+        }
+    }
+    for (int n = 0; n < NMEA_PER_EPOCH; n++) {
+        for (auto it = clients.begin(); it != clients.end(); ++it) {
+            if (nullptr != it->second.gnssNmeaCb) {
+                it->second.gnssNmeaCb(nmeaNotification);
+            }
+        }
+    }
+    for (auto it = clients.begin(); it != clients.end(); ++it) {
+        if (nullptr != it->second.gnssDataCb) {
+            it->second.gnssDataCb(dataNotify);
+        }
+    }
+}
+
+static void dispatchEpoch(GnssClientDispatch& dispatch,
+                          bool reportToGnssClient, bool reportToFlpClient,
+                          const GnssLocationInfoNotification& locationInfo,
+                          const GnssSvNotification& svNotify,
+                          const GnssNmeaNotification& nmeaNotification,
+                          const GnssDataNotification& dataNotify) {
+    for (auto it = dispatch.mPosition.begin(); it != dispatch.mPosition.end(); ++it) {
+        if ((reportToFlpClient && it->isFlp) || (reportToGnssClient && !it->isFlp)) {
+            if (nullptr != it->gnssLocationInfoCb) {
+                it->gnssLocationInfoCb(locationInfo);
+            } else if (nullptr != it->engineLocationsInfoCb) {
+                it->engineLocationsInfoCb(1, (GnssLocationInfoNotification*)&locationInfo);
+            } else if (nullptr != it->trackingCb) {
+                it->trackingCb(locationInfo.location);
+            }
+        }
+    }
+    for (auto it = dispatch.mSv.begin(); it != dispatch.mSv.end(); ++it) {
+        (*it)(svNotify);
+    }
+    for (int n = 0; n < NMEA_PER_EPOCH; n++) {
+        for (auto it = dispatch.mNmea.begin(); it != dispatch.mNmea.end(); ++it) {
+            (*it)(nmeaNotification);
+        }
+    }
+    for (auto it = dispatch.mData.begin(); it != dispatch.mData.end(); ++it) {
+        (*it)(dataNotify);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t epochs = (argc > 1) ? atoi(argv[1]) : 20000;
+    const uint32_t clientCounts[] = {1, 8, 64};
+
+    // heap allocated, as the notifications are large
+    GnssLocationInfoNotification* locationInfo = new GnssLocationInfoNotification();
+    GnssSvNotification* svNotify = new GnssSvNotification();
+    GnssDataNotification* dataNotify = new GnssDataNotification();
+    GnssNmeaNotification nmeaNotification = {};
+    nmeaNotification.nmea = "$GPGSA,A,1,,,,,,,,,,,,,,,*1E\r\n";
+    nmeaNotification.length = strlen(nmeaNotification.nmea);
+
+    // both true, as on a fix, but not known to the compiler
+    bool reportToGnssClient = (argc > 0), reportToFlpClient = (argv != nullptr);
+
+    for (uint32_t c = 0; c < sizeof(clientCounts) / sizeof(clientCounts[0]); c++) {
+        std::map<LocationAPI*, LocationCallbacks> clients;
+        GnssClientDispatch dispatch;
+        uint64_t sink = 0;
+        registerClients(clients, clientCounts[c], sink);
+        dispatch.rebuild(clients);
+
+        uint64_t t0 = nowNs();
+        for (uint32_t e = 0; e < epochs; e++) {
+            mapWalkEpoch(clients, reportToGnssClient, reportToFlpClient,
+                         *locationInfo, *svNotify, nmeaNotification, *dataNotify);
+        }
+        uint64_t t1 = nowNs();
+        uint64_t walked = sink;
+        sink = 0;
+        for (uint32_t e = 0; e < epochs; e++) {
+            dispatchEpoch(dispatch, reportToGnssClient, reportToFlpClient,
+                          *locationInfo, *svNotify, nmeaNotification, *dataNotify);
+        }
+        uint64_t t2 = nowNs();
+
+        // both must have called back the same clients
+        if (walked != sink) {
+            printf("%u clients: %llu callbacks dispatched, expected %llu\n", clientCounts[c],
+                   (unsigned long long)sink, (unsigned long long)walked);
+            return 1;
+        }
+        uint32_t reports = 1 + 1 + NMEA_PER_EPOCH + 1;
+        printf("%2u clients, %5.1f callbacks/epoch: map walk %7.1f ns/report, "
+               "dispatch %7.1f ns/report\n", clientCounts[c], (double)walked / epochs,
+               (double)(t1 - t0) / epochs / reports, (double)(t2 - t1) / epochs / reports);
+    }
+
+    delete locationInfo;
+    delete svNotify;
+    delete dataNotify;
+    return 0;
+}
+
+#endif
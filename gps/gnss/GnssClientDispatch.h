@@ -0,0 +1,64 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef GNSS_CLIENT_DISPATCH_H
+#define GNSS_CLIENT_DISPATCH_H
+
+#include <map>
+#include <vector>
+#include <time.h>
+#include <LocationAPI.h>
+
+/* Per report type lists of the callbacks registered by GnssAdapter clients.
+   The lists are rebuilt from the client map whenever a client is added or
+   removed, so the report paths walk only the clients interested in that
+   report, in a contiguous array, instead of the whole map with a callback
+   test per client. Clients keep the order of the map they came from. */
+class GnssClientDispatch {
+public:
+    struct PositionClient {
+        bool isFlp;
+        // in order of precedence, as only one of them is called per report
+        gnssLocationInfoCallback gnssLocationInfoCb;
+        engineLocationsInfoCallback engineLocationsInfoCb;
+        trackingCallback trackingCb;
+    };
+
+    std::vector<PositionClient> mPosition;
+    std::vector<engineLocationsInfoCallback> mEngineLocations;
+    std::vector<gnssSvCallback> mSv;
+    std::vector<gnssNmeaCallback> mNmea;
+    std::vector<gnssDataCallback> mData;
+    std::vector<gnssMeasurementsCallback> mMeasurements;
+    std::vector<locationSystemInfoCallback> mLocationSystemInfo;
+
+    void rebuild(const std::map<LocationAPI*, LocationCallbacks>& clients);
+    static bool isFlpClient(const LocationCallbacks& locationCallbacks);
+};
+
+#endif // GNSS_CLIENT_DISPATCH_H
@@ -0,0 +1,354 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_NDEBUG 0
+#define LOG_TAG "LocSvc_GnssSvUsedInFix"
+
+#include <string.h>
+#include <GnssSvUsedInFix.h>
+
+void
+GnssSvUsedInFixTable::update(const GnssSvUsedInPosition& svUsed,
+                             const GnssSvMbUsedInPosition* mbSvUsed)
+{
+    // SBAS and unknown SVs are never reported as used
+    memset(mMasks, 0, sizeof(mMasks));
+
+    if (nullptr == mbSvUsed) {
+        setRow(GNSS_SV_TYPE_GPS, svUsed.gps_sv_used_ids_mask);
+        setRow(GNSS_SV_TYPE_GLONASS, svUsed.glo_sv_used_ids_mask);
+        setRow(GNSS_SV_TYPE_BEIDOU, svUsed.bds_sv_used_ids_mask);
+        setRow(GNSS_SV_TYPE_GALILEO, svUsed.gal_sv_used_ids_mask);
+        setRow(GNSS_SV_TYPE_QZSS, svUsed.qzss_sv_used_ids_mask);
+    } else {
+        setSignal(GNSS_SV_TYPE_GPS, GNSS_SIGNAL_GPS_L1CA, mbSvUsed->gps_l1ca_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_GPS, GNSS_SIGNAL_GPS_L1C, mbSvUsed->gps_l1c_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_GPS, GNSS_SIGNAL_GPS_L2, mbSvUsed->gps_l2_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_GPS, GNSS_SIGNAL_GPS_L5, mbSvUsed->gps_l5_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_GLONASS, GNSS_SIGNAL_GLONASS_G1,
+                  mbSvUsed->glo_g1_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_GLONASS, GNSS_SIGNAL_GLONASS_G2,
+                  mbSvUsed->glo_g2_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_BEIDOU, GNSS_SIGNAL_BEIDOU_B1I,
+                  mbSvUsed->bds_b1i_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_BEIDOU, GNSS_SIGNAL_BEIDOU_B1C,
+                  mbSvUsed->bds_b1c_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_BEIDOU, GNSS_SIGNAL_BEIDOU_B2I,
+                  mbSvUsed->bds_b2i_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_BEIDOU, GNSS_SIGNAL_BEIDOU_B2AI,
+                  mbSvUsed->bds_b2ai_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_BEIDOU, GNSS_SIGNAL_BEIDOU_B2AQ,
+                  mbSvUsed->bds_b2aq_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_GALILEO, GNSS_SIGNAL_GALILEO_E1,
+                  mbSvUsed->gal_e1_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_GALILEO, GNSS_SIGNAL_GALILEO_E5A,
+                  mbSvUsed->gal_e5a_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_GALILEO, GNSS_SIGNAL_GALILEO_E5B,
+                  mbSvUsed->gal_e5b_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_QZSS, GNSS_SIGNAL_QZSS_L1CA, mbSvUsed->qzss_l1ca_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_QZSS, GNSS_SIGNAL_QZSS_L1S, mbSvUsed->qzss_l1s_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_QZSS, GNSS_SIGNAL_QZSS_L2, mbSvUsed->qzss_l2_sv_used_ids_mask);
+        setSignal(GNSS_SV_TYPE_QZSS, GNSS_SIGNAL_QZSS_L5, mbSvUsed->qzss_l5_sv_used_ids_mask);
+    }
+    // NavIC has no multiband mask
+    setRow(GNSS_SV_TYPE_NAVIC, svUsed.navic_sv_used_ids_mask);
+
+    mValid = true;
+}
+
+#ifdef __LOC_DEBUG__
+
+// For Linux command line checking and benchmarking of the SV used lookup:
+//     g++ -D__LOC_DEBUG__ -DFEATURE_EXTERNAL_AP -O2 -std=c++11 -I. -I../location
+//         -I../utils -I../pla/oe -o sv_used_bench GnssSvUsedInFix.cpp
+//     ./sv_used_bench <reports>
+// "switch" is how GnssAdapter::reportSv() used to resolve the used SVs, it is
+// kept here as the reference the table lookup has to match.
+#include <stdio.h>
+#include <stdlib.h>
+
+static inline uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void switchSvUsed(GnssSvNotification& svNotify,
+                         bool svIdUsedInPosAvail, const GnssSvUsedInPosition& svIdUsed,
+                         bool mbSvIdUsedInPosAvail, const GnssSvMbUsedInPosition& mbSvIdUsed) {
+    int numSv = svNotify.count;
+    int16_t gnssSvId = 0;
+    uint64_t svUsedIdMask = 0;
+    for (int i=0; i < numSv; i++) {
+        svUsedIdMask = 0;
+        gnssSvId = svNotify.gnssSvs[i].svId;
+        GnssSignalTypeMask signalTypeMask = svNotify.gnssSvs[i].gnssSignalTypeMask;
+        switch (svNotify.gnssSvs[i].type) {
+            case GNSS_SV_TYPE_GPS:
+                if (svIdUsedInPosAvail) {
+                    if (mbSvIdUsedInPosAvail) {
+                        switch (signalTypeMask) {
+                        case GNSS_SIGNAL_GPS_L1CA:
+                            svUsedIdMask = mbSvIdUsed.gps_l1ca_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_GPS_L1C:
+                            svUsedIdMask = mbSvIdUsed.gps_l1c_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_GPS_L2:
+                            svUsedIdMask = mbSvIdUsed.gps_l2_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_GPS_L5:
+                            svUsedIdMask = mbSvIdUsed.gps_l5_sv_used_ids_mask;
+                            break;
+                        }
+                    } else {
+                        svUsedIdMask = svIdUsed.gps_sv_used_ids_mask;
+                    }
+                }
+                break;
+            case GNSS_SV_TYPE_GLONASS:
+                if (svIdUsedInPosAvail) {
+                    if (mbSvIdUsedInPosAvail) {
+                        switch (signalTypeMask) {
+                        case GNSS_SIGNAL_GLONASS_G1:
+                            svUsedIdMask = mbSvIdUsed.glo_g1_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_GLONASS_G2:
+                            svUsedIdMask = mbSvIdUsed.glo_g2_sv_used_ids_mask;
+                            break;
+                        }
+                    } else {
+                        svUsedIdMask = svIdUsed.glo_sv_used_ids_mask;
+                    }
+                }
+                break;
+            case GNSS_SV_TYPE_BEIDOU:
+                if (svIdUsedInPosAvail) {
+                    if (mbSvIdUsedInPosAvail) {
+                        switch (signalTypeMask) {
+                        case GNSS_SIGNAL_BEIDOU_B1I:
+                            svUsedIdMask = mbSvIdUsed.bds_b1i_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_BEIDOU_B1C:
+                            svUsedIdMask = mbSvIdUsed.bds_b1c_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_BEIDOU_B2I:
+                            svUsedIdMask = mbSvIdUsed.bds_b2i_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_BEIDOU_B2AI:
+                            svUsedIdMask = mbSvIdUsed.bds_b2ai_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_BEIDOU_B2AQ:
+                            svUsedIdMask = mbSvIdUsed.bds_b2aq_sv_used_ids_mask;
+                            break;
+                        }
+                    } else {
+                        svUsedIdMask = svIdUsed.bds_sv_used_ids_mask;
+                    }
+                }
+                break;
+            case GNSS_SV_TYPE_GALILEO:
+                if (svIdUsedInPosAvail) {
+                    if (mbSvIdUsedInPosAvail) {
+                        switch (signalTypeMask) {
+                        case GNSS_SIGNAL_GALILEO_E1:
+                            svUsedIdMask = mbSvIdUsed.gal_e1_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_GALILEO_E5A:
+                            svUsedIdMask = mbSvIdUsed.gal_e5a_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_GALILEO_E5B:
+                            svUsedIdMask = mbSvIdUsed.gal_e5b_sv_used_ids_mask;
+                            break;
+                        }
+                    } else {
+                        svUsedIdMask = svIdUsed.gal_sv_used_ids_mask;
+                    }
+                }
+                break;
+            case GNSS_SV_TYPE_QZSS:
+                if (svIdUsedInPosAvail) {
+                    if (mbSvIdUsedInPosAvail) {
+                        switch (signalTypeMask) {
+                        case GNSS_SIGNAL_QZSS_L1CA:
+                            svUsedIdMask = mbSvIdUsed.qzss_l1ca_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_QZSS_L1S:
+                            svUsedIdMask = mbSvIdUsed.qzss_l1s_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_QZSS_L2:
+                            svUsedIdMask = mbSvIdUsed.qzss_l2_sv_used_ids_mask;
+                            break;
+                        case GNSS_SIGNAL_QZSS_L5:
+                            svUsedIdMask = mbSvIdUsed.qzss_l5_sv_used_ids_mask;
+                            break;
+                        }
+                    } else {
+                        svUsedIdMask = svIdUsed.qzss_sv_used_ids_mask;
+                    }
+                }
+                svNotify.gnssSvs[i].svId += (QZSS_SV_PRN_MIN - 1);
+                break;
+            case GNSS_SV_TYPE_NAVIC:
+                if (svIdUsedInPosAvail) {
+                    svUsedIdMask = svIdUsed.navic_sv_used_ids_mask;
+                }
+                break;
+            default:
+                svUsedIdMask = 0;
+                break;
+        }
+
+        if ((gnssSvId < 64) && (svUsedIdMask & (1ULL << (gnssSvId - 1)))) {
+            svNotify.gnssSvs[i].gnssSvOptionsMask |= GNSS_SV_OPTIONS_USED_IN_FIX_BIT;
+        }
+    }
+}
+
+// the loop GnssAdapter::reportSv() now runs
+static void tableSvUsed(GnssSvNotification& svNotify, const GnssSvUsedInFixTable& svUsedInFix) {
+    for (uint32_t i = 0; i < svNotify.count; i++) {
+        GnssSv& gnssSv = svNotify.gnssSvs[i];
+        gnssSv.gnssSvOptionsMask |= GNSS_SV_OPTIONS_USED_IN_FIX_BIT *
+                svUsedInFix.isUsed(gnssSv.type, gnssSv.gnssSignalTypeMask, gnssSv.svId);
+        gnssSv.svId += (QZSS_SV_PRN_MIN - 1) * (GNSS_SV_TYPE_QZSS == gnssSv.type);
+    }
+}
+
+static inline uint64_t randomMask() {
+    return ((uint64_t)rand() << 33) ^ ((uint64_t)rand() << 11) ^ rand();
+}
+
+// an open sky multi-band SV list: every constellation, most SVs on two bands
+static void makeSvList(GnssSvNotification& svNotify) {
+    static const struct { GnssSvType type; GnssSignalTypeMask signal; int16_t maxSvId; }
+    kBands[] = {
+        {GNSS_SV_TYPE_GPS, GNSS_SIGNAL_GPS_L1CA, 32},
+        {GNSS_SV_TYPE_GPS, GNSS_SIGNAL_GPS_L5, 32},
+        {GNSS_SV_TYPE_GLONASS, GNSS_SIGNAL_GLONASS_G1, 24},
+        {GNSS_SV_TYPE_GLONASS, GNSS_SIGNAL_GLONASS_G2, 24},
+        {GNSS_SV_TYPE_GALILEO, GNSS_SIGNAL_GALILEO_E1, 36},
+        {GNSS_SV_TYPE_GALILEO, GNSS_SIGNAL_GALILEO_E5A, 36},
+        {GNSS_SV_TYPE_BEIDOU, GNSS_SIGNAL_BEIDOU_B1I, 63},
+        {GNSS_SV_TYPE_BEIDOU, GNSS_SIGNAL_BEIDOU_B2AI, 63},
+        {GNSS_SV_TYPE_BEIDOU, GNSS_SIGNAL_BEIDOU_B1C, 63},
+        {GNSS_SV_TYPE_QZSS, GNSS_SIGNAL_QZSS_L1CA, 5},
+        {GNSS_SV_TYPE_QZSS, GNSS_SIGNAL_QZSS_L5, 5},
+        {GNSS_SV_TYPE_NAVIC, GNSS_SIGNAL_NAVIC_L5, 14},
+        {GNSS_SV_TYPE_SBAS, GNSS_SIGNAL_SBAS_L1, 39},
+    };
+    memset(&svNotify, 0, sizeof(svNotify));
+    svNotify.size = sizeof(svNotify);
+    uint32_t count = 60 + rand() % 40;
+    for (uint32_t i = 0; i < count; i++) {
+        GnssSv& gnssSv = svNotify.gnssSvs[i];
+        uint32_t band = rand() % (sizeof(kBands) / sizeof(kBands[0]));
+        gnssSv.size = sizeof(GnssSv);
+        gnssSv.type = kBands[band].type;
+        gnssSv.gnssSignalTypeMask = kBands[band].signal;
+        gnssSv.svId = 1 + rand() % kBands[band].maxSvId;
+        gnssSv.gnssSvOptionsMask = (GnssSvOptionsMask)(rand() & GNSS_SV_OPTIONS_HAS_EPHEMER_BIT);
+        // the odd SV of an unknown or combined signal, or an id out of mask range
+        switch (rand() % 64) {
+        case 0: gnssSv.gnssSignalTypeMask = 0; break;
+        case 1: gnssSv.gnssSignalTypeMask |= GNSS_SIGNAL_GPS_L2; break;
+        case 2: gnssSv.svId = 64 + rand() % 200; break;
+        case 3: gnssSv.type = GNSS_SV_TYPE_UNKNOWN; break;
+        }
+    }
+    svNotify.count = count;
+}
+
+int main(int argc, char** argv) {
+    uint32_t reports = (argc > 1) ? atoi(argv[1]) : 20000;
+    const uint32_t kLists = 64;
+
+    GnssSvNotification* lists = new GnssSvNotification[kLists];
+    GnssSvNotification* expected = new GnssSvNotification();
+    GnssSvNotification* actual = new GnssSvNotification();
+    for (uint32_t l = 0; l < kLists; l++) {
+        makeSvList(lists[l]);
+    }
+
+    uint64_t switchNs = 0, tableNs = 0, updateNs = 0, used = 0;
+    for (uint32_t r = 0; r < reports; r++) {
+        // one position in eight has no SV used info, half of the rest no multiband info
+        GnssSvUsedInPosition svIdUsed = {randomMask(), randomMask(), randomMask(),
+                                         randomMask(), randomMask(), randomMask()};
+        GnssSvMbUsedInPosition mbSvIdUsed;
+        uint64_t* mb = (uint64_t*)&mbSvIdUsed;
+        for (size_t i = 0; i < sizeof(mbSvIdUsed) / sizeof(uint64_t); i++) {
+            mb[i] = randomMask();
+        }
+        bool svIdUsedInPosAvail = (0 != r % 8);
+        bool mbSvIdUsedInPosAvail = svIdUsedInPosAvail && (0 != r % 2);
+        const GnssSvNotification& list = lists[r % kLists];
+
+        *expected = list;
+        uint64_t t0 = nowNs();
+        switchSvUsed(*expected, svIdUsedInPosAvail, svIdUsed, mbSvIdUsedInPosAvail, mbSvIdUsed);
+        uint64_t t1 = nowNs();
+
+        *actual = list;
+        GnssSvUsedInFixTable svUsedInFix;
+        uint64_t t2 = nowNs();
+        if (svIdUsedInPosAvail) {
+            svUsedInFix.update(svIdUsed, mbSvIdUsedInPosAvail ? &mbSvIdUsed : nullptr);
+        }
+        uint64_t t3 = nowNs();
+        tableSvUsed(*actual, svUsedInFix);
+        uint64_t t4 = nowNs();
+
+        for (uint32_t i = 0; i < list.count; i++) {
+            if (expected->gnssSvs[i].svId != actual->gnssSvs[i].svId ||
+                expected->gnssSvs[i].gnssSvOptionsMask != actual->gnssSvs[i].gnssSvOptionsMask) {
+                printf("report %u SV %u (type %d signal 0x%x id %d): got id %d options 0x%x,"
+                       " expected id %d options 0x%x\n", r, i, list.gnssSvs[i].type,
+                       list.gnssSvs[i].gnssSignalTypeMask, list.gnssSvs[i].svId,
+                       actual->gnssSvs[i].svId, actual->gnssSvs[i].gnssSvOptionsMask,
+                       expected->gnssSvs[i].svId, expected->gnssSvs[i].gnssSvOptionsMask);
+                return 1;
+            }
+            used += (expected->gnssSvs[i].gnssSvOptionsMask &
+                     GNSS_SV_OPTIONS_USED_IN_FIX_BIT) ? 1 : 0;
+        }
+        switchNs += t1 - t0;
+        updateNs += t3 - t2;
+        tableNs += t4 - t3;
+    }
+
+    printf("%u SV reports match, %.1f SVs used per report\n", reports, (double)used / reports);
+    printf("switch: %7.1f ns/report; table: %7.1f ns/report + %6.1f ns/position update\n",
+           (double)switchNs / reports, (double)tableNs / reports, (double)updateNs / reports);
+    delete[] lists;
+    delete expected;
+    delete actual;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,84 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef GNSS_SV_USED_IN_FIX_H
+#define GNSS_SV_USED_IN_FIX_H
+
+#include <stdint.h>
+#include <time.h>
+#include <LocationDataTypes.h>
+#include <gps_extended_c.h>
+
+/* The SV used in fix masks of the last position, laid out by constellation
+   and signal. reportSv() looks every SV up here instead of picking the mask
+   through a switch on the constellation and one on the signal per SV. */
+class GnssSvUsedInFixTable {
+public:
+    static const uint32_t SV_TYPE_ROWS = GNSS_SV_TYPE_NAVIC + 1;
+    // slot 0 is for signal type masks of none, several or unknown signals,
+    // slot n for the signal of bit n - 1
+    static const uint32_t SIGNAL_SLOTS = 2 + __builtin_ctz(GNSS_SIGNAL_BEIDOU_B2AQ);
+
+    inline GnssSvUsedInFixTable() : mValid(false) {}
+
+    // mbSvUsed is null when the position has no multiband SV used info,
+    // every signal of a constellation then takes its single band mask
+    void update(const GnssSvUsedInPosition& svUsed, const GnssSvMbUsedInPosition* mbSvUsed);
+    inline void clear() { mValid = false; }
+
+    // branch free, as the SV lists mix constellations and signals at random
+    static inline uint32_t signalSlot(GnssSignalTypeMask signalTypeMask) {
+        uint32_t bit = __builtin_ctz(signalTypeMask | 0x80000000);
+        bool single = (0 == (signalTypeMask & (signalTypeMask - 1))) &
+                      (bit < SIGNAL_SLOTS - 1);
+        return single ? bit + 1 : 0;
+    }
+
+    inline bool isUsed(GnssSvType type, GnssSignalTypeMask signalTypeMask, int16_t svId) const {
+        uint32_t row = ((uint32_t)type < SV_TYPE_ROWS) ? (uint32_t)type : GNSS_SV_TYPE_UNKNOWN;
+        // SV ids are 1 based, the masks cover ids 1 to 63
+        uint32_t bit = (uint32_t)(svId - 1);
+        return mValid & (bit < 63) &
+               (uint32_t)(mMasks[row][signalSlot(signalTypeMask)] >> (bit & 63));
+    }
+
+private:
+    bool mValid;
+    uint64_t mMasks[SV_TYPE_ROWS][SIGNAL_SLOTS];
+
+    inline void setRow(GnssSvType type, uint64_t mask) {
+        for (uint32_t slot = 0; slot < SIGNAL_SLOTS; slot++) {
+            mMasks[type][slot] = mask;
+        }
+    }
+    inline void setSignal(GnssSvType type, GnssSignalTypeMask signal, uint64_t mask) {
+        mMasks[type][signalSlot(signal)] = mask;
+    }
+};
+
+#endif // GNSS_SV_USED_IN_FIX_H
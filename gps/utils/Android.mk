@@ -27,7 +27,9 @@ LOCAL_SRC_FILES += \
     MsgTask.cpp \
     loc_misc_utils.cpp \
     loc_nmea.cpp \
-    LocIpc.cpp
+    LocIpc.cpp \
+    LocMpscQueue.cpp \
+    LocMsgPool.cpp
 
 # Flag -std=c++11 is not accepted by compiler when LOCAL_CLANG is set to true
 LOCAL_CFLAGS += \
@@ -38,6 +40,14 @@ ifeq ($(TARGET_BUILD_VARIANT),user)
    LOCAL_CFLAGS += -DTARGET_BUILD_VARIANT_USER
 endif
 
+ifeq ($(GNSS_MSGTASK_MPSC_Q),true)
+   LOCAL_CFLAGS += -DLOC_MSGTASK_MPSC_Q
+endif
+
+ifeq ($(GNSS_LOC_TIMER_ARRAY_HEAP),true)
+   LOCAL_CFLAGS += -DLOC_TIMER_ARRAY_HEAP
+endif
+
 LOCAL_LDFLAGS += -Wl,--export-dynamic
 
 ## Includes
@@ -26,6 +26,7 @@
  * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
  */
+#include <stdlib.h>
 #include <LocHeap.h>
 
 class LocHeapNode {
@@ -275,6 +276,121 @@ uint32_t LocHeap::getTreeSize() {
 }
 #endif
 
+/***************************LocArrayHeap methods***************************/
+
+#define LOC_ARRAY_HEAP_ARITY 4
+#define LOC_ARRAY_HEAP_MIN_CAPACITY 16
+
+LocArrayHeap::~LocArrayHeap() {
+    for (uint32_t i = 0; i < mSize; i++) {
+        mNodes[i]->mHeapIndex = UINT32_MAX;
+    }
+    free(mNodes);
+}
+
+inline
+void LocArrayHeap::place(LocIndexedRankable* node, uint32_t index) {
+    mNodes[index] = node;
+    node->mHeapIndex = index;
+}
+
+// moves the node at index up, until its parent outranks it
+void LocArrayHeap::siftUp(uint32_t index) {
+    LocIndexedRankable* node = mNodes[index];
+    while (index > 0) {
+        uint32_t parent = (index - 1) / LOC_ARRAY_HEAP_ARITY;
+        if (!node->outRanks(*mNodes[parent])) {
+            break;
+        }
+        place(mNodes[parent], index);
+        index = parent;
+    }
+    place(node, index);
+}
+
+// moves the node at index down, until it outranks all its children
+void LocArrayHeap::siftDown(uint32_t index) {
+    LocIndexedRankable* node = mNodes[index];
+    for (;;) {
+        uint32_t first = index * LOC_ARRAY_HEAP_ARITY + 1;
+        if (first >= mSize) {
+            break;
+        }
+        uint32_t last = first + LOC_ARRAY_HEAP_ARITY;
+        if (last > mSize) {
+            last = mSize;
+        }
+        uint32_t best = first;
+        for (uint32_t child = first + 1; child < last; child++) {
+            if (mNodes[child]->outRanks(*mNodes[best])) {
+                best = child;
+            }
+        }
+        if (!mNodes[best]->outRanks(*node)) {
+            break;
+        }
+        place(mNodes[best], index);
+        index = best;
+    }
+    place(node, index);
+}
+
+void LocArrayHeap::push(LocIndexedRankable& node) {
+    if (mSize == mCapacity) {
+        uint32_t capacity = (0 == mCapacity) ? LOC_ARRAY_HEAP_MIN_CAPACITY : mCapacity * 2;
+        LocIndexedRankable** nodes = (LocIndexedRankable**)realloc(
+                mNodes, capacity * sizeof(LocIndexedRankable*));
+        if (NULL == nodes) {
+            return;
+        }
+        mNodes = nodes;
+        mCapacity = capacity;
+    }
+    place(&node, mSize++);
+    siftUp(mSize - 1);
+}
+
+LocIndexedRankable* LocArrayHeap::removeAt(uint32_t index) {
+    LocIndexedRankable* node = mNodes[index];
+    node->mHeapIndex = UINT32_MAX;
+    mSize--;
+    if (index < mSize) {
+        // fill the hole with the last node, which may need to go either way
+        place(mNodes[mSize], index);
+        if (index > 0 &&
+            mNodes[index]->outRanks(*mNodes[(index - 1) / LOC_ARRAY_HEAP_ARITY])) {
+            siftUp(index);
+        } else {
+            siftDown(index);
+        }
+    }
+    return node;
+}
+
+LocIndexedRankable* LocArrayHeap::pop() {
+    return (mSize > 0) ? removeAt(0) : NULL;
+}
+
+LocIndexedRankable* LocArrayHeap::remove(LocIndexedRankable& rankable) {
+    uint32_t index = rankable.mHeapIndex;
+    if (index >= mSize || mNodes[index] != &rankable) {
+        return NULL;
+    }
+    return removeAt(index);
+}
+
+#ifdef __LOC_UNIT_TEST__
+bool LocArrayHeap::checkTree() {
+    for (uint32_t i = 0; i < mSize; i++) {
+        if (mNodes[i]->mHeapIndex != i ||
+            (i > 0 && mNodes[i]->outRanks(*mNodes[(i - 1) / LOC_ARRAY_HEAP_ARITY]))) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 #ifdef __LOC_DEBUG__
 
 #include <stdio.h>
@@ -30,6 +30,7 @@
 #define __LOC_HEAP__
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 // abstract class to be implemented by client to provide a rankable class
@@ -93,4 +94,55 @@ public:
 #endif
 };
 
+// a rankable that remembers its own position in a LocArrayHeap, so that it
+// can be removed without searching for it.
+class LocIndexedRankable : public LocRankable {
+    friend class LocArrayHeap;
+    uint32_t mHeapIndex;
+public:
+    inline LocIndexedRankable() : mHeapIndex(UINT32_MAX) {}
+    virtual inline ~LocIndexedRankable() {}
+    inline bool isInHeap() const { return UINT32_MAX != mHeapIndex; }
+};
+
+// an alternative to LocHeap, with the same push / peek / pop / remove
+// semantics, but kept in a contiguous array as a 4-ary heap. No allocation
+// is made per push once the array has grown to its working size, siblings
+// are compared within one or two cache lines, and remove() is O(log n) as
+// each node carries its index, instead of a search through the tree.
+class LocArrayHeap {
+    LocIndexedRankable** mNodes;
+    uint32_t mSize;
+    uint32_t mCapacity;
+    void place(LocIndexedRankable* node, uint32_t index);
+    void siftUp(uint32_t index);
+    void siftDown(uint32_t index);
+    LocIndexedRankable* removeAt(uint32_t index);
+public:
+    inline LocArrayHeap() : mNodes(NULL), mSize(0), mCapacity(0) {}
+    ~LocArrayHeap();
+
+    // node is reference to an obj that is managed by client, that client
+    //      creates and destroyes. The destroy should happen after the
+    //      node is popped out from the heap.
+    void push(LocIndexedRankable& node);
+
+    // Returns NULL if the heap is empty, otherwise pointer to the node
+    //         that currently has the highest ranking
+    inline LocIndexedRankable* peek() { return mSize > 0 ? mNodes[0] : NULL; }
+
+    // Return - pointer to the node popped out, or NULL if heap is already empty
+    LocIndexedRankable* pop();
+
+    // removes the input node, found by address, from the heap.
+    // returns the pointer to the node removed; or NULL (if not in the heap).
+    LocIndexedRankable* remove(LocIndexedRankable& rankable);
+
+    inline uint32_t getSize() const { return mSize; }
+
+#ifdef __LOC_UNIT_TEST__
+    bool checkTree();
+#endif
+};
+
 #endif //__LOC_HEAP__
@@ -0,0 +1,341 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_NDEBUG 0
+#define LOG_TAG "LocSvc_MpscQueue"
+
+#include <unistd.h>
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <new>
+#include <sys/eventfd.h>
+#include <LocMpscQueue.h>
+#include <msg_q.h>
+#include <log_util.h>
+#include <loc_pla.h>
+
+static uint32_t roundUpPow2(uint32_t v) {
+    uint32_t p = 2;
+    while (p < v && p < 0x40000000) {
+        p <<= 1;
+    }
+    return p;
+}
+
+LocMpscQueue::LocMpscQueue(uint32_t capacity, void (*dealloc)(void*)) :
+    mSlots(new Slot[roundUpPow2(capacity)]), mMask(roundUpPow2(capacity) - 1),
+    mTail(0), mHead(0), mOverflowCnt(0), mSleeping(false), mUnblocked(false),
+    mEventFd(eventfd(0, EFD_CLOEXEC)), mOverflowQ((void*)msg_q_init2()),
+    mDealloc(dealloc) {
+    for (uint32_t i = 0; i <= mMask; i++) {
+        mSlots[i].mSeq.store(i, std::memory_order_relaxed);
+        mSlots[i].mData = nullptr;
+    }
+    if (-1 == mEventFd) {
+        LOC_LOGE("%s: eventfd failure - %s", __FUNCTION__, strerror(errno));
+    }
+}
+
+LocMpscQueue::~LocMpscQueue() {
+    flush();
+    if (mOverflowQ) {
+        msg_q_destroy(&mOverflowQ);
+    }
+    if (-1 != mEventFd) {
+        close(mEventFd);
+    }
+    delete[] mSlots;
+}
+
+LocMpscQueue* LocMpscQueue::create(uint32_t capacity, void (*dealloc)(void*)) {
+    void* mem = nullptr;
+    if (0 != posix_memalign(&mem, alignof(LocMpscQueue), sizeof(LocMpscQueue))) {
+        LOC_LOGE("%s: no memory for the queue", __FUNCTION__);
+        return nullptr;
+    }
+    LocMpscQueue* q = new (mem) LocMpscQueue(capacity, dealloc);
+    if (!q->isValid()) {
+        destroy(q);
+        q = nullptr;
+    }
+    return q;
+}
+
+void LocMpscQueue::destroy(LocMpscQueue* q) {
+    if (nullptr != q) {
+        q->~LocMpscQueue();
+        free(q);
+    }
+}
+
+void LocMpscQueue::wake() {
+    // pairs with the fence in pop(), so that either the consumer sees the
+    // element we just published, or we see it going to sleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mSleeping.load(std::memory_order_relaxed) &&
+        mSleeping.exchange(false, std::memory_order_acq_rel)) {
+        uint64_t one = 1;
+        if (write(mEventFd, &one, sizeof(one)) < 0) {
+            LOC_LOGE("%s: eventfd write failure - %s", __FUNCTION__, strerror(errno));
+        }
+    }
+}
+
+bool LocMpscQueue::push(void* data) {
+    if (nullptr == data || mUnblocked.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    bool inRing = false;
+    if (0 == mOverflowCnt.load(std::memory_order_acquire)) {
+        uint32_t pos = mTail.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &mSlots[pos & mMask];
+            int32_t diff = (int32_t)(slot->mSeq.load(std::memory_order_acquire) - pos);
+            if (0 == diff) {
+                if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // ring is full
+                slot = nullptr;
+                break;
+            } else {
+                pos = mTail.load(std::memory_order_relaxed);
+            }
+        }
+        if (nullptr != slot) {
+            slot->mData = data;
+            slot->mSeq.store(pos + 1, std::memory_order_release);
+            inRing = true;
+        }
+    }
+
+    if (!inRing) {
+        // the element must be in mOverflowQ before it is counted, so that the
+        // consumer never finds mOverflowQ empty while mOverflowCnt is non 0.
+        if (eMSG_Q_SUCCESS != msg_q_snd(mOverflowQ, data, mDealloc)) {
+            return false;
+        }
+        mOverflowCnt.fetch_add(1, std::memory_order_release);
+    }
+
+    wake();
+    return true;
+}
+
+bool LocMpscQueue::tryPopRing(void*& data) {
+    Slot& slot = mSlots[mHead & mMask];
+    int32_t diff = (int32_t)(slot.mSeq.load(std::memory_order_acquire) - (mHead + 1));
+    if (diff < 0) {
+        return false;
+    }
+    data = slot.mData;
+    slot.mData = nullptr;
+    slot.mSeq.store(mHead + mMask + 1, std::memory_order_release);
+    mHead++;
+    return true;
+}
+
+bool LocMpscQueue::tryPopOverflow(void*& data) {
+    if (0 == mOverflowCnt.load(std::memory_order_acquire) ||
+        eMSG_Q_SUCCESS != msg_q_rmv(mOverflowQ, &data)) {
+        return false;
+    }
+    mOverflowCnt.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+bool LocMpscQueue::tryPop(void*& data) {
+    if (tryPopRing(data)) {
+        return true;
+    }
+    // A producer may have claimed the head slot without publishing it yet.
+    // Its message was sent before anything in mOverflowQ, so mOverflowQ is
+    // only drained once the ring is really empty.
+    while (mHead != mTail.load(std::memory_order_acquire)) {
+        if (tryPopRing(data)) {
+            return true;
+        }
+        sched_yield();
+    }
+    return tryPopOverflow(data);
+}
+
+bool LocMpscQueue::pop(void*& data) {
+    while (!mUnblocked.load(std::memory_order_acquire)) {
+        if (tryPop(data)) {
+            return true;
+        }
+
+        mSleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // a producer may have published right before we flagged sleeping
+        if (tryPop(data)) {
+            mSleeping.store(false, std::memory_order_relaxed);
+            return true;
+        }
+        if (mUnblocked.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        uint64_t cnt = 0;
+        if (read(mEventFd, &cnt, sizeof(cnt)) < 0 && EINTR != errno) {
+            LOC_LOGE("%s: eventfd read failure - %s", __FUNCTION__, strerror(errno));
+            break;
+        }
+        mSleeping.store(false, std::memory_order_relaxed);
+    }
+
+    LOC_LOGD("%s: Message queue has been unblocked.", __FUNCTION__);
+    return false;
+}
+
+void LocMpscQueue::unblock() {
+    mUnblocked.store(true, std::memory_order_release);
+    uint64_t one = 1;
+    if (-1 != mEventFd && write(mEventFd, &one, sizeof(one)) < 0) {
+        LOC_LOGE("%s: eventfd write failure - %s", __FUNCTION__, strerror(errno));
+    }
+}
+
+void LocMpscQueue::flush() {
+    void* data = nullptr;
+    while (tryPopRing(data)) {
+        if (mDealloc) {
+            mDealloc(data);
+        }
+    }
+    if (mOverflowQ) {
+        msg_q_flush(mOverflowQ);
+        mOverflowCnt.store(0, std::memory_order_release);
+    }
+}
+
+#ifdef __LOC_DEBUG__
+
+// For Linux command line benchmarking of msg_q vs LocMpscQueue:
+//     g++ -D__LOC_DEBUG__ -DUSE_GLIB -DFEATURE_EXTERNAL_AP -DOFF_TARGET -O2 -std=c++14
+//         -I. -I../pla/oe -I../location -o mpsc_bench LocMpscQueue.cpp msg_q.c
+//         linked_list.c loc_log.cpp -lpthread
+//     ./mpsc_bench <producers> <msgs per producer>
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+#include <vector>
+#include <algorithm>
+
+static inline uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void benchDealloc(void*) {}
+
+struct BenchCtx {
+    bool useRing;
+    void* q;
+    LocMpscQueue* ring;
+    uint32_t msgs;
+    std::vector<uint64_t> lat;
+};
+
+static void* benchProducer(void* arg) {
+    BenchCtx* ctx = (BenchCtx*)arg;
+    ctx->lat.resize(ctx->msgs);
+    for (uint32_t i = 0; i < ctx->msgs; i++) {
+        void* msg = (void*)(uintptr_t)(i + 1);
+        uint64_t t0 = nowNs();
+        if (ctx->useRing) {
+            ctx->ring->push(msg);
+        } else {
+            msg_q_snd(ctx->q, msg, benchDealloc);
+        }
+        ctx->lat[i] = nowNs() - t0;
+    }
+    return NULL;
+}
+
+static void runBench(bool useRing, uint32_t producers, uint32_t msgs) {
+    LocMpscQueue ring(512, benchDealloc);
+    void* q = (void*)msg_q_init2();
+    std::vector<BenchCtx> ctxs(producers);
+    std::vector<pthread_t> threads(producers);
+
+    uint64_t start = nowNs();
+    for (uint32_t p = 0; p < producers; p++) {
+        ctxs[p] = { useRing, q, &ring, msgs, {} };
+        pthread_create(&threads[p], NULL, benchProducer, &ctxs[p]);
+    }
+    uint64_t total = (uint64_t)producers * msgs;
+    for (uint64_t n = 0; n < total; n++) {
+        void* msg = NULL;
+        if (useRing) {
+            ring.pop(msg);
+        } else {
+            msg_q_rcv(q, &msg);
+        }
+    }
+    uint64_t elapsed = nowNs() - start;
+    for (uint32_t p = 0; p < producers; p++) {
+        pthread_join(threads[p], NULL);
+    }
+    msg_q_destroy(&q);
+
+    std::vector<uint64_t> lat;
+    for (auto& ctx : ctxs) {
+        lat.insert(lat.end(), ctx.lat.begin(), ctx.lat.end());
+    }
+    std::sort(lat.begin(), lat.end());
+    uint64_t sum = 0;
+    for (auto l : lat) {
+        sum += l;
+    }
+    printf("%-12s producers %u: %10.0f msgs/s, enqueue avg %6llu ns,"
+           " p50 %6llu ns, p99 %7llu ns, max %8llu ns\n",
+           useRing ? "LocMpscQueue" : "msg_q", producers, total * 1e9 / elapsed,
+           (unsigned long long)(sum / lat.size()),
+           (unsigned long long)lat[lat.size() / 2],
+           (unsigned long long)lat[lat.size() * 99 / 100],
+           (unsigned long long)lat.back());
+}
+
+int main(int argc, char** argv) {
+    uint32_t producers = (argc > 1) ? atoi(argv[1]) : 4;
+    uint32_t msgs = (argc > 2) ? atoi(argv[2]) : 200000;
+    for (uint32_t p = 1; p <= producers; p <<= 1) {
+        runBench(false, p, msgs);
+        runBench(true, p, msgs);
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,100 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef __LOC_MPSC_QUEUE__
+#define __LOC_MPSC_QUEUE__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// A bounded multi-producer / single-consumer queue of opaque pointers.
+// Producers claim a slot with a CAS on the tail and publish it through the
+// slot's sequence number, so sending neither takes a lock nor allocates.
+// The consumer only sleeps, on an eventfd, once it has found the ring
+// empty; producers write the eventfd only when they observe the consumer
+// asleep, so under load no system call is made per message.
+//
+// When the ring is full, messages spill into a msg_q. Once anything has
+// spilled, every producer keeps spilling until the consumer has drained the
+// msg_q, which keeps messages from any one producer in FIFO order. This
+// also allows the consumer thread to send to itself without deadlocking.
+class LocMpscQueue {
+    struct Slot {
+        std::atomic<uint32_t> mSeq;
+        void* mData;
+    };
+    // ring storage, capacity is a power of 2
+    Slot* const mSlots;
+    const uint32_t mMask;
+    // producers' enqueue position, on its own cache line
+    alignas(64) std::atomic<uint32_t> mTail;
+    // consumer's dequeue position, only touched by the consumer thread
+    alignas(64) uint32_t mHead;
+    // number of messages currently parked in mOverflowQ
+    alignas(64) std::atomic<uint32_t> mOverflowCnt;
+    // set by the consumer right before it blocks on mEventFd
+    std::atomic<bool> mSleeping;
+    std::atomic<bool> mUnblocked;
+    const int mEventFd;
+    void* mOverflowQ;
+    void (*const mDealloc)(void*);
+
+    bool tryPopRing(void*& data);
+    bool tryPopOverflow(void*& data);
+    void wake();
+public:
+    // capacity gets rounded up to the next power of 2.
+    // dealloc is used to free the elements left in the queue upon flush().
+    LocMpscQueue(uint32_t capacity, void (*dealloc)(void*));
+    ~LocMpscQueue();
+
+    // Heap instances come from create() and go back through destroy(): plain
+    // new does not honor the cache line alignment of the members before
+    // C++17. create() returns nullptr if the queue could not be set up.
+    static LocMpscQueue* create(uint32_t capacity, void (*dealloc)(void*));
+    static void destroy(LocMpscQueue* q);
+
+    inline bool isValid() const { return nullptr != mSlots && -1 != mEventFd; }
+
+    // Can be called from any thread. Returns false only if the queue
+    // is unblocked or invalid, in which case caller still owns data.
+    bool push(void* data);
+    // Only to be called from the single consumer thread. Blocks until an
+    // element is available. Returns false if the queue is unblocked.
+    bool pop(void*& data);
+    // Non blocking variant of pop(); returns false if the queue is empty.
+    bool tryPop(void*& data);
+    // Wakes the consumer, after which push() and pop() will fail.
+    void unblock();
+    // Drops all the elements with the dealloc function.
+    // Only to be called when no other thread uses this queue.
+    void flush();
+};
+
+#endif //__LOC_MPSC_QUEUE__
@@ -0,0 +1,102 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#define LOG_NDEBUG 0
+#define LOG_TAG "LocSvc_MsgPool"
+
+#include <stdlib.h>
+#include <inttypes.h>
+#include <LocMsgPool.h>
+#include <log_util.h>
+#include <loc_pla.h>
+
+LocMsgPool::LocMsgPool(const char* name, size_t blockSize, uint32_t maxFree) :
+    mName(name),
+    mBlockSize(blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize),
+    mMaxFree(maxFree), mFreeList(nullptr), mFreeCount(0),
+    mHits(0), mMisses(0), mOverflows(0) {
+    pthread_mutex_init(&mMutex, nullptr);
+}
+
+void* LocMsgPool::alloc(size_t size) {
+    // subclasses of the pooled type may be bigger than our blocks
+    if (size > mBlockSize) {
+        return ::operator new(size);
+    }
+
+    FreeBlock* block = nullptr;
+    pthread_mutex_lock(&mMutex);
+    if (nullptr != mFreeList) {
+        block = mFreeList;
+        mFreeList = block->mNext;
+        mFreeCount--;
+        mHits++;
+    } else {
+        mMisses++;
+    }
+    if (0 == (mHits + mMisses) % LOC_MSG_POOL_LOG_INTERVAL) {
+        logStatsLocked();
+    }
+    pthread_mutex_unlock(&mMutex);
+
+    return (nullptr != block) ? (void*)block : ::operator new(mBlockSize);
+}
+
+void LocMsgPool::release(void* block, size_t size) {
+    if (nullptr == block) {
+        return;
+    }
+    if (size <= mBlockSize) {
+        pthread_mutex_lock(&mMutex);
+        if (mFreeCount < mMaxFree) {
+            FreeBlock* freeBlock = (FreeBlock*)block;
+            freeBlock->mNext = mFreeList;
+            mFreeList = freeBlock;
+            mFreeCount++;
+            block = nullptr;
+        } else {
+            mOverflows++;
+        }
+        pthread_mutex_unlock(&mMutex);
+    }
+    if (nullptr != block) {
+        ::operator delete(block);
+    }
+}
+
+void LocMsgPool::logStatsLocked() const {
+    LOC_LOGd("%s: block size %zu, hits %" PRIu64 ", misses %" PRIu64
+             ", overflows %" PRIu64 ", free %u",
+             mName, mBlockSize, mHits, mMisses, mOverflows, mFreeCount);
+}
+
+void LocMsgPool::logStats() {
+    pthread_mutex_lock(&mMutex);
+    logStatsLocked();
+    pthread_mutex_unlock(&mMutex);
+}
@@ -0,0 +1,93 @@
+/* Copyright (c) 2020, The Linux Foundation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of The Linux Foundation, nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
+ * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef __LOC_MSG_POOL__
+#define __LOC_MSG_POOL__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <new>
+
+// Free blocks kept around per pool, beyond which released blocks
+// go back to the heap.
+#define LOC_MSG_POOL_MAX_FREE 32
+// Pool statistics get logged once every this many allocations.
+#define LOC_MSG_POOL_LOG_INTERVAL 4096
+
+// A freelist of fixed size blocks. Blocks are taken from the heap only
+// when the freelist is empty (a miss), and are put back onto the freelist
+// upon release, so that a steady flow of same-type messages, i.e. allocated
+// in the reporting thread and freed in the MsgTask thread, is served
+// without touching the heap once the pool has warmed up.
+class LocMsgPool {
+    struct FreeBlock {
+        FreeBlock* mNext;
+    };
+    const char* const mName;
+    const size_t mBlockSize;
+    const uint32_t mMaxFree;
+    pthread_mutex_t mMutex;
+    FreeBlock* mFreeList;
+    uint32_t mFreeCount;
+    uint64_t mHits;
+    uint64_t mMisses;
+    uint64_t mOverflows;
+    void logStatsLocked() const;
+public:
+    LocMsgPool(const char* name, size_t blockSize,
+               uint32_t maxFree = LOC_MSG_POOL_MAX_FREE);
+    // pools are never destroyed, as messages may still be freed
+    // from MsgTask threads while the process exits.
+    ~LocMsgPool() = delete;
+
+    void* alloc(size_t size);
+    void release(void* block, size_t size);
+    void logStats();
+};
+
+// Mixin for LocMsg subclasses on the hot reporting paths, e.g.
+//     struct MsgReportSv : public LocMsg, public LocPooledMsg<MsgReportSv> {...};
+// The class scope operator new / delete make `new MsgReportSv(...)` and the
+// `delete msg` in MsgTask::run() go through a pool dedicated to that type.
+template <typename T>
+struct LocPooledMsg {
+    static LocMsgPool& pool() {
+        // __PRETTY_FUNCTION__ carries the name of T, good enough a pool name
+        static LocMsgPool* sPool = new LocMsgPool(__PRETTY_FUNCTION__, sizeof(T));
+        return *sPool;
+    }
+    static void* operator new(size_t size) {
+        return pool().alloc(size);
+    }
+    static void operator delete(void* block, size_t size) {
+        pool().release(block, size);
+    }
+};
+
+#endif //__LOC_MSG_POOL__
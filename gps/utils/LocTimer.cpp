@@ -48,6 +48,14 @@
 #define CLOCK_BOOTTIME_ALARM CLOCK_MONOTONIC
 #endif
 
+// LocArrayHeap keeps the timers in a contiguous array, and removes a stopped
+// timer by its index; LocHeap is a linked tree with a node per timer.
+#ifdef LOC_TIMER_ARRAY_HEAP
+typedef LocArrayHeap LocTimerHeap;
+#else
+typedef LocHeap LocTimerHeap;
+#endif
+
 /*
 There are implementations of 5 classes in this file:
 LocTimer, LocTimerDelegate, LocTimerContainer, LocTimerPollTask, LocTimerWrapper
@@ -65,7 +73,8 @@ LocTimerDelegate - an internal timer entity, which also is a LocRankable obj.
                    heap, its ranks() implementation decides where it is placed
                    in the heap.
 LocTimerContainer - core of the timer service. It is a container (derived from
-                    LocHeap) for LocTimerDelegate (implements LocRankable) objs.
+                    LocHeap, or LocArrayHeap with LOC_TIMER_ARRAY_HEAP) for
+                    LocTimerDelegate (implements LocIndexedRankable) objs.
                     There are 2 of such containers, one for sw timers (or Linux
                     timers) one for hw timers (or Linux alarms). It adds one of
                     each (those that expire the soonest) to kernel via services
@@ -91,7 +100,7 @@ class LocTimerPollTask;
 //   for alarms (or mHwTimers);
 // * provides a polling thread;
 // * provides a MsgTask thread for synchronized add / remove / timer client callback.
-class LocTimerContainer : public LocHeap {
+class LocTimerContainer : public LocTimerHeap {
     // mutex to synchronize getters of static members
     static pthread_mutex_t mMutex;
     // Container of timers
@@ -173,7 +182,7 @@ public:
 // and gets deleted when client calls LocTimer::stop() or when the it expire()'s.
 // This class implements LocRankable::ranks() so that when an obj is added into
 // the container (of LocHeap), it gets placed in sorted order.
-class LocTimerDelegate : public LocRankable {
+class LocTimerDelegate : public LocIndexedRankable {
     friend class LocTimerContainer;
     friend class LocTimer;
     LocTimer* mClient;
@@ -319,7 +328,7 @@ void LocTimerContainer::add(LocTimerDelegate& timer) {
             LocMsg(), mTimerContainer(&container), mTimer(&timer) {}
         inline virtual void proc() const {
             LocTimerDelegate* priorTop = mTimerContainer->getSoonestTimer();
-            mTimerContainer->push((LocRankable&)(*mTimer));
+            mTimerContainer->push(*mTimer);
             mTimerContainer->updateSoonestTime(priorTop);
         }
     };
@@ -339,7 +348,7 @@ void LocTimerContainer::remove(LocTimerDelegate& timer) {
 
             // update soonest timer only if mTimer is actually removed from
             // mTimerContainer AND mTimer is not priorTop.
-            if (priorTop == ((LocHeap*)mTimerContainer)->remove((LocRankable&)*mTimer)) {
+            if (priorTop == mTimerContainer->LocTimerHeap::remove(*mTimer)) {
                 // if passing in NULL, we tell updateSoonestTime to update
                 // kernel with the current top timer interval.
                 mTimerContainer->updateSoonestTime(NULL);
@@ -386,7 +395,7 @@ void LocTimerContainer::expire() {
 
 LocTimerDelegate* LocTimerContainer::popIfOutRanks(LocTimerDelegate& timer) {
     LocTimerDelegate* poppedNode = NULL;
-    if (mTree && !timer.outRanks(*peek())) {
+    if (peek() && !timer.outRanks(*peek())) {
         poppedNode = (LocTimerDelegate*)(pop());
     }
 
@@ -693,12 +702,133 @@ public:
     }
 };
 
+static inline uint64_t getNowNs() {
+    struct timespec now = getNow();
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+// a stand-in for LocTimerDelegate, ranked the same way, to time the
+// container alone, without the MsgTask hops of LocTimer::start() / stop().
+class LocTimerBenchNode : public LocIndexedRankable {
+public:
+    struct timespec mFutureTime;
+    virtual int ranks(LocRankable& rankable) {
+        LocTimerBenchNode* node = (LocTimerBenchNode*)(&rankable);
+        int rank = node->mFutureTime.tv_sec - mFutureTime.tv_sec;
+        if (0 == rank) {
+            rank = (int)(node->mFutureTime.tv_nsec - mFutureTime.tv_nsec);
+        }
+        return rank;
+    }
+};
+
+static void benchHeap(int count) {
+    LocTimerBenchNode* nodes = new LocTimerBenchNode[count];
+    int* order = new int[count];
+    struct timespec now = getNow();
+    for (int i = 0; i < count; i++) {
+        nodes[i].mFutureTime = now;
+        nodes[i].mFutureTime.tv_sec += rand() % 3600;
+        nodes[i].mFutureTime.tv_nsec = rand() % 1000000000;
+        order[i] = i;
+    }
+    for (int i = count - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    LocTimerHeap heap;
+    // start: push all
+    uint64_t t0 = getNowNs();
+    for (int i = 0; i < count; i++) {
+        heap.push(nodes[i]);
+    }
+    // stop: remove all, in random order
+    uint64_t t1 = getNowNs();
+    for (int i = 0; i < count; i++) {
+        heap.remove(nodes[order[i]]);
+    }
+    uint64_t t2 = getNowNs();
+    for (int i = 0; i < count; i++) {
+        heap.push(nodes[i]);
+    }
+    // expire: pop all, soonest first
+    uint64_t t3 = getNowNs();
+    while (NULL != heap.pop()) {}
+    uint64_t t4 = getNowNs();
+
+    printf("heap  %6d timers: start %8.1f ns, stop %10.1f ns, expire %8.1f ns per timer\n",
+           count, (double)(t1 - t0) / count, (double)(t2 - t1) / count,
+           (double)(t4 - t3) / count);
+    delete[] order;
+    delete[] nodes;
+}
+
+class LocTimerBench : public LocTimer {
+public:
+    static volatile int sExpired;
+    inline virtual void timeOutCallback() {
+        __sync_fetch_and_add(&sExpired, 1);
+    }
+};
+volatile int LocTimerBench::sExpired = 0;
+
+// end to end, through LocTimer::start() / stop() and the timerfd
+static void benchTimers(int count) {
+    const unsigned int maxTimeOutMs = 200;
+    LocTimerBench* timers = new LocTimerBench[count];
+
+    // stop: timers which would not expire during the test
+    uint64_t t0 = getNowNs();
+    for (int i = 0; i < count; i++) {
+        timers[i].start(3600 * 1000 + rand() % 1000, false);
+    }
+    uint64_t t1 = getNowNs();
+    for (int i = 0; i < count; i++) {
+        timers[i].stop();
+    }
+    uint64_t t2 = getNowNs();
+
+    // expire: all timers are due within maxTimeOutMs
+    LocTimerBench::sExpired = 0;
+    for (int i = 0; i < count; i++) {
+        timers[i].start(1 + rand() % maxTimeOutMs, false);
+    }
+    uint64_t t3 = getNowNs();
+    while (LocTimerBench::sExpired < count) {
+        usleep(1000);
+    }
+    uint64_t t4 = getNowNs();
+
+    printf("timer %6d timers: start %8.1f ns, stop %10.1f ns, all expired in %6.1f ms"
+           " (max timeout %u ms)\n",
+           count, (double)(t1 - t0) / count, (double)(t2 - t1) / count,
+           (double)(t4 - t3) / 1000000, maxTimeOutMs);
+    // let the queued removals drain before the timers go away
+    sleep(1);
+    delete[] timers;
+}
+
 // For Linux command line testing:
 // compilation:
 //     g++ -D__LOC_HOST_DEBUG__ -D__LOC_DEBUG__ -g -I. -I../../../../system/core/include -o LocHeap.o LocHeap.cpp
 //     g++ -D__LOC_HOST_DEBUG__ -D__LOC_DEBUG__ -g -std=c++0x -I. -I../../../../system/core/include -lpthread -o LocThread.o LocThread.cpp
 //     g++ -D__LOC_HOST_DEBUG__ -D__LOC_DEBUG__ -g -I. -I../../../../system/core/include -o LocTimer.o LocTimer.cpp
+// add -DLOC_TIMER_ARRAY_HEAP to LocTimer.cpp to test with LocArrayHeap.
+// test: ./a.out <tries>
+// benchmark of start / stop / expire at 10, 1k and 100k timers: ./a.out -b
 int main(int argc, char** argv) {
+    if (argc > 1 && 0 == strcmp(argv[1], "-b")) {
+        srand(time(NULL));
+        for (int count = 10; count <= 100000; count *= 100) {
+            benchHeap(count);
+            benchTimers(count);
+        }
+        return 0;
+    }
+
     struct timespec timeOfStart=getNow();
     srand(time(NULL));
     int tries = atoi(argv[1]);
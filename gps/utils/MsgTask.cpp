@@ -35,14 +35,75 @@
 #include <log_util.h>
 #include <loc_log.h>
 #include <loc_pla.h>
+#ifdef LOC_MSGTASK_MPSC_Q
+#include <LocMpscQueue.h>
+
+// Messages beyond this many pending ones spill into a msg_q
+#define MSG_TASK_MPSC_Q_SIZE 512
+#endif
 
 static void LocMsgDestroy(void* msg) {
     delete (LocMsg*)msg;
 }
 
+#ifdef LOC_MSGTASK_MPSC_Q
+static const void* msgTaskQInit() {
+    return LocMpscQueue::create(MSG_TASK_MPSC_Q_SIZE, LocMsgDestroy);
+}
+
+static inline void msgTaskQDestroy(const void*& q) {
+    LocMpscQueue::destroy((LocMpscQueue*)q);
+    q = NULL;
+}
+
+static inline void msgTaskQUnblock(const void* q) {
+    if (q) {
+        ((LocMpscQueue*)q)->unblock();
+    }
+}
+
+static inline bool msgTaskQSnd(const void* q, LocMsg* msg) {
+    return q && ((LocMpscQueue*)q)->push(msg);
+}
+
+static inline bool msgTaskQRcv(const void* q, LocMsg*& msg) {
+    void* data = NULL;
+    bool success = q && ((LocMpscQueue*)q)->pop(data);
+    msg = (LocMsg*)data;
+    return success;
+}
+#else
+static inline const void* msgTaskQInit() {
+    return msg_q_init2();
+}
+
+static inline void msgTaskQDestroy(const void*& q) {
+    msg_q_flush((void*)q);
+    msg_q_destroy((void**)&q);
+}
+
+static inline void msgTaskQUnblock(const void* q) {
+    msg_q_unblock((void*)q);
+}
+
+static inline bool msgTaskQSnd(const void* q, LocMsg* msg) {
+    return eMSG_Q_SUCCESS == msg_q_snd((void*)q, (void*)msg, LocMsgDestroy);
+}
+
+static inline bool msgTaskQRcv(const void* q, LocMsg*& msg) {
+    msq_q_err_type result = msg_q_rcv((void*)q, (void **)&msg);
+    if (eMSG_Q_SUCCESS != result) {
+        LOC_LOGE("%s:%d] fail receiving msg: %s\n", __func__, __LINE__,
+                 loc_get_msg_q_status(result));
+        return false;
+    }
+    return true;
+}
+#endif /* LOC_MSGTASK_MPSC_Q */
+
 MsgTask::MsgTask(LocThread::tCreate tCreator,
                  const char* threadName, bool joinable) :
-    mQ(msg_q_init2()), mThread(new LocThread()) {
+    mQ(msgTaskQInit()), mThread(new LocThread()) {
     if (!mThread->start(tCreator, threadName, this, joinable)) {
         delete mThread;
         mThread = NULL;
@@ -50,7 +111,7 @@ MsgTask::MsgTask(LocThread::tCreate tCreator,
 }
 
 MsgTask::MsgTask(const char* threadName, bool joinable) :
-    mQ(msg_q_init2()), mThread(new LocThread()) {
+    mQ(msgTaskQInit()), mThread(new LocThread()) {
     if (!mThread->start(threadName, this, joinable)) {
         delete mThread;
         mThread = NULL;
@@ -58,13 +119,12 @@ MsgTask::MsgTask(const char* threadName, bool joinable) :
 }
 
 MsgTask::~MsgTask() {
-    msg_q_flush((void*)mQ);
-    msg_q_destroy((void**)&mQ);
+    msgTaskQDestroy(mQ);
 }
 
 void MsgTask::destroy() {
     LocThread* thread = mThread;
-    msg_q_unblock((void*)mQ);
+    msgTaskQUnblock(mQ);
     if (thread) {
         mThread = NULL;
         delete thread;
@@ -75,7 +135,9 @@ void MsgTask::destroy() {
 
 void MsgTask::sendMsg(const LocMsg* msg) const {
     if (msg && this) {
-        msg_q_snd((void*)mQ, (void*)msg, LocMsgDestroy);
+        if (!msgTaskQSnd(mQ, (LocMsg*)msg)) {
+            LOC_LOGE("%s: failed sending msg %p", __func__, msg);
+        }
     } else {
         LOC_LOGE("%s: msg is %p and this is %p",
                  __func__, msg, this);
@@ -90,11 +152,8 @@ void MsgTask::prerun() {
 }
 
 bool MsgTask::run() {
-    LocMsg* msg;
-    msq_q_err_type result = msg_q_rcv((void*)mQ, (void **)&msg);
-    if (eMSG_Q_SUCCESS != result) {
-        LOC_LOGE("%s:%d] fail receiving msg: %s\n", __func__, __LINE__,
-                 loc_get_msg_q_status(result));
+    LocMsg* msg = NULL;
+    if (!msgTaskQRcv(mQ, msg)) {
         return false;
     }
 
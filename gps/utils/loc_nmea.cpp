@@ -359,19 +359,17 @@ SIDE EFFECTS
 ===========================================================================*/
 static uint32_t get_sv_count_from_mask(uint64_t svMask, int totalSvCount)
 {
-    int index = 0;
-    uint32_t svCount = 0;
-
     if(totalSvCount > MAX_SV_COUNT_SUPPORTED_IN_ONE_CONSTELLATION) {
         LOC_LOGE("total SV count in this constellation %d exceeded limit %d",
                  totalSvCount, MAX_SV_COUNT_SUPPORTED_IN_ONE_CONSTELLATION);
     }
-    for(index = 0; index < totalSvCount; index++) {
-        if(svMask & 0x1)
-            svCount += 1;
-        svMask >>= 1;
+    if (totalSvCount <= 0) {
+        return 0;
+    }
+    if (totalSvCount < 64) {
+        svMask &= (1ULL << totalSvCount) - 1;
     }
-    return svCount;
+    return __builtin_popcountll(svMask);
 }
 
 /*===========================================================================
@@ -508,41 +506,335 @@ static loc_nmea_sv_meta* loc_nmea_sv_meta_init(loc_nmea_sv_meta& sv_meta,
 }
 
 /*===========================================================================
-FUNCTION    loc_nmea_put_checksum
+CLASS       LocNmeaWriter
 
 DESCRIPTION
-   Generate NMEA sentences generated based on position report
+   Allocation free NMEA sentence builder, see loc_nmea.h
+
+===========================================================================*/
+static const uint32_t sNmeaPow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+static const char sNmeaHexDigits[] = "0123456789ABCDEF";
+
+LocNmeaWriter::LocNmeaWriter(char* buf, size_t size, LocNmeaFlushCb flushCb,
+                             void* flushContext) :
+    mBuf(buf), mSize((NULL == buf) ? 0 : size), mLength(0), mCursor(0),
+    mCount(0), mDropped(0), mChecksum(0), mOverflown(false),
+    mFlushCb(flushCb), mFlushContext(flushContext)
+{
+    if (mSize > 0) {
+        mBuf[0] = '\0';
+    }
+}
+
+bool LocNmeaWriter::flush()
+{
+    if (NULL == mFlushCb || 0 == mLength) {
+        return false;
+    }
+
+    mFlushCb(mFlushContext, mBuf, mLength);
+    // keep the open sentence, if any, at the front of the emptied buffer
+    memmove(mBuf, mBuf + mLength, mCursor - mLength);
+    mCursor -= mLength;
+    mLength = 0;
+    return true;
+}
+
+bool LocNmeaWriter::makeRoom(size_t length)
+{
+    return (flush() && mCursor + length < mSize);
+}
+
+void LocNmeaWriter::begin()
+{
+    // an unsealed sentence, if any, is discarded
+    mCursor = mLength;
+    mOverflown = false;
+    put('$');
+    // the checksum covers everything between '$' and '*'
+    mChecksum = 0;
+}
+
+void LocNmeaWriter::write(const char* data, size_t length)
+{
+    if (mCursor + length >= mSize && !makeRoom(length)) {
+        mOverflown = true;
+        return;
+    }
+
+    // work on locals, stores through char* would otherwise force the
+    // members to be reloaded for every byte
+    char* pDst = mBuf + mCursor;
+    uint8_t checksum = mChecksum;
+    for (size_t i = 0; i < length; i++) {
+        checksum ^= (uint8_t)data[i];
+        pDst[i] = data[i];
+    }
+    mCursor += length;
+    mChecksum = checksum;
+}
+
+void LocNmeaWriter::putStr(const char* str)
+{
+    if (NULL != str) {
+        write(str, strlen(str));
+    }
+}
+
+void LocNmeaWriter::putInt(int32_t value, int minWidth)
+{
+    // digits are laid out right to left, then written in one go
+    char text[24];
+    char* pText = text + sizeof(text);
+    char* pLimit;
+    uint32_t magnitude = (value < 0) ? (0u - (uint32_t)value) : (uint32_t)value;
+
+    do {
+        *--pText = '0' + (magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    // as with printf, the sign counts towards the field width
+    if (value < 0) {
+        minWidth--;
+    }
+    pLimit = text + sizeof(text) - ((minWidth < 16) ? minWidth : 16);
+    while (pText > pLimit) {
+        *--pText = '0';
+    }
+    if (value < 0) {
+        *--pText = '-';
+    }
+    write(pText, text + sizeof(text) - pText);
+}
+
+void LocNmeaWriter::putHex(uint32_t value)
+{
+    char text[8];
+    char* pText = text + sizeof(text);
+
+    do {
+        *--pText = sNmeaHexDigits[value & 0xF];
+        value >>= 4;
+    } while (value > 0);
+
+    write(pText, text + sizeof(text) - pText);
+}
+
+void LocNmeaWriter::putFixed(double value, int decimals, int minWidth)
+{
+    char text[40];
+    char* pText = text + sizeof(text);
+    char* pLimit;
+    bool negative = (0 != signbit(value));
+    double scaled = (negative ? -value : value) *
+            sNmeaPow10[(decimals >= 0 && decimals <= 6) ? decimals : 0];
+    double whole = floor(scaled);
+    double fraction = scaled - whole;
+
+    // Below 1e15 the scaled value and its fraction are exact in a double,
+    // and k + 0.5 is representable, so comparing against 0.5 rounds the
+    // same way printf does on the exact binary value. Exact ties, nan/inf
+    // and out of range values are left to snprintf.
+    if (decimals < 0 || decimals > 6 || !(scaled < 1e15) || 0.5 == fraction) {
+        int length = snprintf(text, sizeof(text), "%0*.*f", minWidth, decimals, value);
+        if (length > 0) {
+            write(text, ((size_t)length < sizeof(text)) ? length : sizeof(text) - 1);
+        }
+        return;
+    }
+
+    uint64_t units = (uint64_t)whole + ((fraction > 0.5) ? 1 : 0);
+    for (int i = 0; i < decimals; i++) {
+        *--pText = '0' + (units % 10);
+        units /= 10;
+    }
+    if (decimals > 0) {
+        *--pText = '.';
+    }
+    do {
+        *--pText = '0' + (units % 10);
+        units /= 10;
+    } while (units > 0);
+
+    if (negative) {
+        minWidth--;
+    }
+    pLimit = text + sizeof(text) - ((minWidth < 32) ? minWidth : 32);
+    while (pText > pLimit) {
+        *--pText = '0';
+    }
+    if (negative) {
+        *--pText = '-';
+    }
+    write(pText, text + sizeof(text) - pText);
+}
+
+bool LocNmeaWriter::end()
+{
+    uint8_t checksum = mChecksum;
+
+    put('*');
+    put(sNmeaHexDigits[checksum >> 4]);
+    put(sNmeaHexDigits[checksum & 0xF]);
+    put('\r');
+    put('\n');
+
+    if (mOverflown || mCursor <= mLength) {
+        mDropped++;
+        LOC_LOGE("NMEA sentence dropped, %u so far, %zu of %zu bytes in use",
+                 mDropped, mLength, mSize);
+        mCursor = mLength;
+        mOverflown = false;
+        if (mSize > 0) {
+            mBuf[mLength] = '\0';
+        }
+        return false;
+    }
+
+    mLength = mCursor;
+    mBuf[mLength] = '\0';
+    mCount++;
+    return true;
+}
+
+bool LocNmeaWriter::append(const char* sentence, size_t length)
+{
+    if (NULL == sentence) {
+        return false;
+    }
+    if (mLength + length >= mSize && !makeRoom(length)) {
+        mDropped++;
+        LOC_LOGE("NMEA sentence dropped, %u so far, %zu of %zu bytes in use",
+                 mDropped, mLength, mSize);
+        return false;
+    }
+
+    memcpy(mBuf + mLength, sentence, length);
+    mLength += length;
+    mCursor = mLength;
+    mBuf[mLength] = '\0';
+    mCount++;
+    return true;
+}
+
+/*===========================================================================
+FUNCTION    loc_nmea_put_sentence
+
+DESCRIPTION
+   Append a complete sentence, given without '$' and checksum
 
 DEPENDENCIES
    NONE
 
 RETURN VALUE
-   Total length of the nmea sentence
+   NONE
 
 SIDE EFFECTS
    N/A
 
 ===========================================================================*/
-static int loc_nmea_put_checksum(char *pNmea, int maxSize)
+static void loc_nmea_put_sentence(LocNmeaWriter &writer, const char* body)
 {
-    uint8_t checksum = 0;
-    int length = 0;
-    if(NULL == pNmea)
-        return 0;
+    writer.begin();
+    writer.putStr(body);
+    writer.end();
+}
+
+/*===========================================================================
+FUNCTION    loc_nmea_put_lat_long
+
+DESCRIPTION
+   Append the ddmm.mmmmmm,N,dddmm.mmmmmm,E, fields of RMC, GNS and GGA
+
+DEPENDENCIES
+   NONE
+
+RETURN VALUE
+   NONE
+
+SIDE EFFECTS
+   N/A
 
-    pNmea++; //skip the $
-    while (*pNmea != '\0')
+===========================================================================*/
+static void loc_nmea_put_lat_long(LocNmeaWriter &writer,
+                                  const UlpLocation &location,
+                                  const LocLla &ref_lla)
+{
+    if (location.gpsLocation.flags & LOC_GPS_LOCATION_HAS_LAT_LONG)
     {
-        checksum ^= *pNmea++;
-        length++;
+        double latitude = ref_lla.lat;
+        double longitude = ref_lla.lon;
+        char latHemisphere;
+        char lonHemisphere;
+        double latMinutes;
+        double lonMinutes;
+
+        if (latitude > 0)
+        {
+            latHemisphere = 'N';
+        }
+        else
+        {
+            latHemisphere = 'S';
+            latitude *= -1.0;
+        }
+
+        if (longitude < 0)
+        {
+            lonHemisphere = 'W';
+            longitude *= -1.0;
+        }
+        else
+        {
+            lonHemisphere = 'E';
+        }
+
+        latMinutes = fmod(latitude * 60.0 , 60.0);
+        lonMinutes = fmod(longitude * 60.0 , 60.0);
+
+        writer.putInt((uint8_t)floor(latitude), 2);
+        writer.putFixed(latMinutes, 6, 9);
+        writer.putChar(',');
+        writer.putChar(latHemisphere);
+        writer.putChar(',');
+        writer.putInt((uint8_t)floor(longitude), 3);
+        writer.putFixed(lonMinutes, 6, 9);
+        writer.putChar(',');
+        writer.putChar(lonHemisphere);
+        writer.putChar(',');
     }
+    else
+    {
+        writer.putStr(",,,,");
+    }
+}
+
+/*===========================================================================
+FUNCTION    loc_nmea_put_utc_time
+
+DESCRIPTION
+   Append the hhmmss.ss, UTC time field
+
+DEPENDENCIES
+   NONE
 
-    // length now contains nmea sentence string length not including $ sign.
-    int checksumLength = snprintf(pNmea,(maxSize-length-1),"*%02X\r\n", checksum);
+RETURN VALUE
+   NONE
+
+SIDE EFFECTS
+   N/A
 
-    // total length of nmea sentence is length of nmea sentence inc $ sign plus
-    // length of checksum (+1 is to cover the $ character in the length).
-    return (length + checksumLength + 1);
+===========================================================================*/
+static void loc_nmea_put_utc_time(LocNmeaWriter &writer, int hours, int minutes,
+                                  int seconds, int mseconds)
+{
+    writer.putInt(hours, 2);
+    writer.putInt(minutes, 2);
+    writer.putInt(seconds, 2);
+    writer.putChar('.');
+    writer.putInt(mseconds / 10, 2);
+    writer.putChar(',');
 }
 
 /*===========================================================================
@@ -567,21 +859,15 @@ SIDE EFFECTS
 
 ===========================================================================*/
 static uint32_t loc_nmea_generate_GSA(const GpsLocationExtended &locationExtended,
-                              char* sentence,
-                              int bufSize,
                               loc_nmea_sv_meta* sv_meta_p,
-                              std::vector<std::string> &nmeaArraystr)
+                              LocNmeaWriter &writer)
 {
-    if (!sentence || bufSize <= 0 || !sv_meta_p)
+    if (!sv_meta_p)
     {
         LOC_LOGE("NMEA Error invalid arguments.");
         return 0;
     }
 
-    char* pMarker = sentence;
-    int lengthRemaining = bufSize;
-    int length = 0;
-
     uint32_t svUsedCount = 0;
     uint32_t svUsedList[64] = {0};
 
@@ -622,56 +908,41 @@ static uint32_t loc_nmea_generate_GSA(const GpsLocationExtended &locationExtende
     // v.v : Vertical DOP
     // s : GNSS System Id
     // cc : Checksum value
-    length = snprintf(pMarker, lengthRemaining, "$%sGSA,A,%c,", talker, fixType);
-
-    if (length < 0 || length >= lengthRemaining)
-    {
-        LOC_LOGE("NMEA Error in string formatting");
-        return 0;
-    }
-    pMarker += length;
-    lengthRemaining -= length;
+    writer.begin();
+    writer.putStr(talker);
+    writer.putStr("GSA,A,");
+    writer.putChar(fixType);
+    writer.putChar(',');
 
     // Add first 12 satellite IDs
     for (uint8_t i = 0; i < 12; i++)
     {
         if (i < svUsedCount)
-            length = snprintf(pMarker, lengthRemaining, "%02d,", svUsedList[i]);
-        else
-            length = snprintf(pMarker, lengthRemaining, ",");
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return 0;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+            writer.putInt(svUsedList[i], 2);
+        writer.putChar(',');
     }
 
     // Add the position/horizontal/vertical DOP values
     if (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_DOP)
     {
-        length = snprintf(pMarker, lengthRemaining, "%.1f,%.1f,%.1f,",
-                locationExtended.pdop,
-                locationExtended.hdop,
-                locationExtended.vdop);
+        writer.putFixed(locationExtended.pdop, 1);
+        writer.putChar(',');
+        writer.putFixed(locationExtended.hdop, 1);
+        writer.putChar(',');
+        writer.putFixed(locationExtended.vdop, 1);
+        writer.putChar(',');
     }
     else
     {   // no dop
-        length = snprintf(pMarker, lengthRemaining, ",,,");
+        writer.putStr(",,,");
     }
-    pMarker += length;
-    lengthRemaining -= length;
 
     // system id
-    length = snprintf(pMarker, lengthRemaining, "%d", sv_meta_p->systemId);
-    pMarker += length;
-    lengthRemaining -= length;
+    writer.putInt(sv_meta_p->systemId);
 
     /* Sentence is ready, add checksum and broadcast */
-    length = loc_nmea_put_checksum(sentence, bufSize);
-    nmeaArraystr.push_back(sentence);
+    if (!writer.end())
+        return 0;
 
     return svUsedCount;
 }
@@ -697,20 +968,15 @@ SIDE EFFECTS
 
 ===========================================================================*/
 static void loc_nmea_generate_GSV(const GnssSvNotification &svNotify,
-                              char* sentence,
-                              int bufSize,
                               loc_nmea_sv_meta* sv_meta_p,
-                              std::vector<std::string> &nmeaArraystr)
+                              LocNmeaWriter &writer)
 {
-    if (!sentence || bufSize <= 0)
+    if (!sv_meta_p)
     {
         LOC_LOGE("NMEA Error invalid argument.");
         return;
     }
 
-    char* pMarker = sentence;
-    int lengthRemaining = bufSize;
-    int length = 0;
     int sentenceCount = 0;
     int sentenceNumber = 1;
     size_t svNumber = 1;
@@ -730,19 +996,14 @@ static void loc_nmea_generate_GSV(const GnssSvNotification &svNotify,
 
     while (sentenceNumber <= sentenceCount)
     {
-        pMarker = sentence;
-        lengthRemaining = bufSize;
-
-        length = snprintf(pMarker, lengthRemaining, "$%sGSV,%d,%d,%02d",
-                talker, sentenceCount, sentenceNumber, svCount);
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.begin();
+        writer.putStr(talker);
+        writer.putStr("GSV,");
+        writer.putInt(sentenceCount);
+        writer.putChar(',');
+        writer.putInt(sentenceNumber);
+        writer.putChar(',');
+        writer.putInt(svCount, 2);
 
         for (int i=0; (svNumber <= svNotify.count) && (i < 4);  svNumber++)
         {
@@ -787,31 +1048,17 @@ static void loc_nmea_generate_GSV(const GnssSvNotification &svNotify,
                 if (GNSS_SV_TYPE_QZSS == svNotify.gnssSvs[svNumber - 1].type) {
                     svId = svId - (QZSS_SV_PRN_MIN - 1);
                 }
-                length = snprintf(pMarker, lengthRemaining,",%02d,%02d,%03d,",
-                        svId + svIdOffset,
-                        (int)(0.5 + svNotify.gnssSvs[svNumber - 1].elevation), //float to int
-                        (int)(0.5 + svNotify.gnssSvs[svNumber - 1].azimuth)); //float to int
-
-                if (length < 0 || length >= lengthRemaining)
-                {
-                    LOC_LOGE("NMEA Error in string formatting");
-                    return;
-                }
-                pMarker += length;
-                lengthRemaining -= length;
+                writer.putChar(',');
+                writer.putInt(svId + svIdOffset, 2);
+                writer.putChar(',');
+                writer.putInt((int)(0.5 + svNotify.gnssSvs[svNumber - 1].elevation), 2);
+                writer.putChar(',');
+                writer.putInt((int)(0.5 + svNotify.gnssSvs[svNumber - 1].azimuth), 3);
+                writer.putChar(',');
 
                 if (svNotify.gnssSvs[svNumber - 1].cN0Dbhz > 0)
                 {
-                    length = snprintf(pMarker, lengthRemaining,"%02d",
-                            (int)(0.5 + svNotify.gnssSvs[svNumber - 1].cN0Dbhz)); //float to int
-
-                    if (length < 0 || length >= lengthRemaining)
-                    {
-                        LOC_LOGE("NMEA Error in string formatting");
-                        return;
-                    }
-                    pMarker += length;
-                    lengthRemaining -= length;
+                    writer.putInt((int)(0.5 + svNotify.gnssSvs[svNumber - 1].cN0Dbhz), 2);
                 }
 
                 i++;
@@ -820,12 +1067,11 @@ static void loc_nmea_generate_GSV(const GnssSvNotification &svNotify,
         }
 
         // append signalId
-        length = snprintf(pMarker, lengthRemaining,",%X",sv_meta_p->signalId);
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putChar(',');
+        writer.putHex(sv_meta_p->signalId);
 
-        length = loc_nmea_put_checksum(sentence, bufSize);
-        nmeaArraystr.push_back(sentence);
+        if (!writer.end())
+            return;
         sentenceNumber++;
 
     }  //while
@@ -850,12 +1096,8 @@ SIDE EFFECTS
 static void loc_nmea_generate_DTM(const LocLla &ref_lla,
                                   const LocLla &local_lla,
                                   char *talker,
-                                  char *sentence,
-                                  int bufSize)
+                                  LocNmeaWriter &writer)
 {
-    char* pMarker = sentence;
-    int lengthRemaining = bufSize;
-    int length = 0;
     int datum_type;
     char ref_datum[4] = {0};
     char local_datum[4] = {0};
@@ -886,13 +1128,11 @@ static void loc_nmea_generate_DTM(const LocLla &ref_lla,
         default:
             break;
     }
-    length = snprintf(pMarker , lengthRemaining , "$%sDTM,%s,," , talker, local_datum);
-    if (length < 0 || length >= lengthRemaining) {
-        LOC_LOGE("NMEA Error in string formatting");
-        return;
-    }
-    pMarker += length;
-    lengthRemaining -= length;
+    writer.begin();
+    writer.putStr(talker);
+    writer.putStr("DTM,");
+    writer.putStr(local_datum);
+    writer.putStr(",,");
 
     lla_offset[0] = local_lla.lat - ref_lla.lat;
     lla_offset[1] = fmod(local_lla.lon - ref_lla.lon, 360.0);
@@ -916,24 +1156,21 @@ static void loc_nmea_generate_DTM(const LocLla &ref_lla,
         longHem = 'E';
     }
     longMins = fmod(lla_offset[1] * 60.0, 60.0);
-    length = snprintf(pMarker, lengthRemaining, "%02d%09.6lf,%c,%03d%09.6lf,%c,%.3lf,",
-                     (uint8_t)floor(lla_offset[0]), latMins, latHem,
-                     (uint8_t)floor(lla_offset[1]), longMins, longHem, lla_offset[2]);
-    if (length < 0 || length >= lengthRemaining) {
-        LOC_LOGE("NMEA Error in string formatting");
-        return;
-    }
-    pMarker += length;
-    lengthRemaining -= length;
-    length = snprintf(pMarker , lengthRemaining , "%s" , ref_datum);
-    if (length < 0 || length >= lengthRemaining) {
-        LOC_LOGE("NMEA Error in string formatting");
-        return;
-    }
-    pMarker += length;
-    lengthRemaining -= length;
-
-    length = loc_nmea_put_checksum(sentence, bufSize);
+    writer.putInt((uint8_t)floor(lla_offset[0]), 2);
+    writer.putFixed(latMins, 6, 9);
+    writer.putChar(',');
+    writer.putChar(latHem);
+    writer.putChar(',');
+    writer.putInt((uint8_t)floor(lla_offset[1]), 3);
+    writer.putFixed(longMins, 6, 9);
+    writer.putChar(',');
+    writer.putChar(longHem);
+    writer.putChar(',');
+    writer.putFixed(lla_offset[2], 3);
+    writer.putChar(',');
+    writer.putStr(ref_datum);
+
+    writer.end();
 }
 
 /*===========================================================================
@@ -1169,6 +1406,8 @@ DESCRIPTION
    - $--RMC : Recommended minimum navigation information
    - $--GGA : Time, position and fix related data
 
+   The sentences are appended to the writer, back to back.
+
 DEPENDENCIES
    NONE
 
@@ -1184,7 +1423,7 @@ void loc_nmea_generate_pos(const UlpLocation &location,
                                const LocationSystemInfo &systemInfo,
                                unsigned char generate_nmea,
                                bool custom_gga_fix_quality,
-                               std::vector<std::string> &nmeaArraystr)
+                               LocNmeaWriter &writer)
 {
     ENTRY_LOG();
 
@@ -1201,14 +1440,6 @@ void loc_nmea_generate_pos(const UlpLocation &location,
         return;
     }
 
-    char sentence[NMEA_SENTENCE_MAX_LENGTH] = {0};
-    char sentence_DTM[NMEA_SENTENCE_MAX_LENGTH] = {0};
-    char sentence_RMC[NMEA_SENTENCE_MAX_LENGTH] = {0};
-    char sentence_GNS[NMEA_SENTENCE_MAX_LENGTH] = {0};
-    char sentence_GGA[NMEA_SENTENCE_MAX_LENGTH] = {0};
-    char* pMarker = sentence;
-    int lengthRemaining = sizeof(sentence);
-    int length = 0;
     int utcYear = pTm->tm_year % 100; // 2 digit year
     int utcMonth = pTm->tm_mon + 1; // tm_mon starts at zero
     int utcDay = pTm->tm_mday;
@@ -1262,9 +1493,9 @@ void loc_nmea_generate_pos(const UlpLocation &location,
         // ---$GPGSA/$GNGSA---
         // -------------------
 
-        count = loc_nmea_generate_GSA(locationExtended, sentence, sizeof(sentence),
+        count = loc_nmea_generate_GSA(locationExtended,
                         loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_GPS,
-                        GNSS_SIGNAL_GPS_L1CA, true), nmeaArraystr);
+                        GNSS_SIGNAL_GPS_L1CA, true), writer);
         if (count > 0)
         {
             svUsedCount += count;
@@ -1276,9 +1507,9 @@ void loc_nmea_generate_pos(const UlpLocation &location,
         // ---$GLGSA/$GNGSA---
         // -------------------
 
-        count = loc_nmea_generate_GSA(locationExtended, sentence, sizeof(sentence),
+        count = loc_nmea_generate_GSA(locationExtended,
                         loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_GLONASS,
-                        GNSS_SIGNAL_GLONASS_G1, true), nmeaArraystr);
+                        GNSS_SIGNAL_GLONASS_G1, true), writer);
         if (count > 0)
         {
             svUsedCount += count;
@@ -1290,9 +1521,9 @@ void loc_nmea_generate_pos(const UlpLocation &location,
         // ---$GAGSA/$GNGSA---
         // -------------------
 
-        count = loc_nmea_generate_GSA(locationExtended, sentence, sizeof(sentence),
+        count = loc_nmea_generate_GSA(locationExtended,
                         loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_GALILEO,
-                        GNSS_SIGNAL_GALILEO_E1, true), nmeaArraystr);
+                        GNSS_SIGNAL_GALILEO_E1, true), writer);
         if (count > 0)
         {
             svUsedCount += count;
@@ -1303,9 +1534,9 @@ void loc_nmea_generate_pos(const UlpLocation &location,
         // ----------------------------
         // ---$GBGSA/$GNGSA (BEIDOU)---
         // ----------------------------
-        count = loc_nmea_generate_GSA(locationExtended, sentence, sizeof(sentence),
+        count = loc_nmea_generate_GSA(locationExtended,
                         loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_BEIDOU,
-                        GNSS_SIGNAL_BEIDOU_B1I, true), nmeaArraystr);
+                        GNSS_SIGNAL_BEIDOU_B1I, true), writer);
         if (count > 0)
         {
             svUsedCount += count;
@@ -1317,9 +1548,9 @@ void loc_nmea_generate_pos(const UlpLocation &location,
         // ---$GQGSA/$GNGSA (QZSS)---
         // --------------------------
 
-        count = loc_nmea_generate_GSA(locationExtended, sentence, sizeof(sentence),
+        count = loc_nmea_generate_GSA(locationExtended,
                         loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_QZSS,
-                        GNSS_SIGNAL_QZSS_L1CA, true), nmeaArraystr);
+                        GNSS_SIGNAL_QZSS_L1CA, true), writer);
         if (count > 0)
         {
             svUsedCount += count;
@@ -1337,8 +1568,9 @@ void loc_nmea_generate_pos(const UlpLocation &location,
         // ------$--VTG-------
         // -------------------
 
-        pMarker = sentence;
-        lengthRemaining = sizeof(sentence);
+        writer.begin();
+        writer.putStr(talker);
+        writer.putStr("VTG,");
 
         if (location.gpsLocation.flags & LOC_GPS_LOCATION_HAS_BEARING)
         {
@@ -1352,45 +1584,34 @@ void loc_nmea_generate_pos(const UlpLocation &location,
                     magTrack -= 360.0;
             }
 
-            length = snprintf(pMarker, lengthRemaining, "$%sVTG,%.1lf,T,%.1lf,M,", talker, location.gpsLocation.bearing, magTrack);
+            writer.putFixed(location.gpsLocation.bearing, 1);
+            writer.putStr(",T,");
+            writer.putFixed(magTrack, 1);
+            writer.putStr(",M,");
         }
         else
         {
-            length = snprintf(pMarker, lengthRemaining, "$%sVTG,,T,,M,", talker);
+            writer.putStr(",T,,M,");
         }
 
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
-
         if (location.gpsLocation.flags & LOC_GPS_LOCATION_HAS_SPEED)
         {
             float speedKnots = location.gpsLocation.speed * (3600.0/1852.0);
             float speedKmPerHour = location.gpsLocation.speed * 3.6;
 
-            length = snprintf(pMarker, lengthRemaining, "%.1lf,N,%.1lf,K,", speedKnots, speedKmPerHour);
+            writer.putFixed(speedKnots, 1);
+            writer.putStr(",N,");
+            writer.putFixed(speedKmPerHour, 1);
+            writer.putStr(",K,");
         }
         else
         {
-            length = snprintf(pMarker, lengthRemaining, ",N,,K,");
+            writer.putStr(",N,,K,");
         }
 
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putChar(vtgModeIndicator);
 
-        length = snprintf(pMarker, lengthRemaining, "%c", vtgModeIndicator);
-
-        length = loc_nmea_put_checksum(sentence, sizeof(sentence));
-        nmeaArraystr.push_back(sentence);
+        writer.end();
 
         memset(&ecef_w84, 0, sizeof(ecef_w84));
         memset(&ecef_p90, 0, sizeof(ecef_p90));
@@ -1430,120 +1651,44 @@ void loc_nmea_generate_pos(const UlpLocation &location,
         // -------------------
         // ------$--DTM-------
         // -------------------
-        loc_nmea_generate_DTM(ref_lla, local_lla, talker, sentence_DTM, sizeof(sentence_DTM));
+        // written once, then copied in front of GNS and GGA for PZ90
+        char dtm[NMEA_SENTENCE_MAX_LENGTH];
+        LocNmeaWriter dtmWriter(dtm, sizeof(dtm));
+        loc_nmea_generate_DTM(ref_lla, local_lla, talker, dtmWriter);
+        size_t dtmLength = dtmWriter.getLength();
+        if (dtmLength > 0) {
+            writer.append(dtm, dtmLength);
+        }
 
         // -------------------
         // ------$--RMC-------
         // -------------------
 
-        pMarker = sentence_RMC;
-        lengthRemaining = sizeof(sentence_RMC);
-
-        length = snprintf(pMarker, lengthRemaining, "$%sRMC,%02d%02d%02d.%02d,A," ,
-                          talker, utcHours, utcMinutes, utcSeconds,utcMSeconds/10);
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
-
-        if (location.gpsLocation.flags & LOC_GPS_LOCATION_HAS_LAT_LONG)
-        {
-            double latitude = ref_lla.lat;
-            double longitude = ref_lla.lon;
-            char latHemisphere;
-            char lonHemisphere;
-            double latMinutes;
-            double lonMinutes;
-
-            if (latitude > 0)
-            {
-                latHemisphere = 'N';
-            }
-            else
-            {
-                latHemisphere = 'S';
-                latitude *= -1.0;
-            }
-
-            if (longitude < 0)
-            {
-                lonHemisphere = 'W';
-                longitude *= -1.0;
-            }
-            else
-            {
-                lonHemisphere = 'E';
-            }
-
-            latMinutes = fmod(latitude * 60.0 , 60.0);
-            lonMinutes = fmod(longitude * 60.0 , 60.0);
-
-            length = snprintf(pMarker, lengthRemaining, "%02d%09.6lf,%c,%03d%09.6lf,%c,",
-                              (uint8_t)floor(latitude), latMinutes, latHemisphere,
-                              (uint8_t)floor(longitude),lonMinutes, lonHemisphere);
-        }
-        else
-        {
-            length = snprintf(pMarker, lengthRemaining,",,,,");
-        }
+        writer.begin();
+        writer.putStr(talker);
+        writer.putStr("RMC,");
+        loc_nmea_put_utc_time(writer, utcHours, utcMinutes, utcSeconds, utcMSeconds);
+        writer.putStr("A,");
 
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+        loc_nmea_put_lat_long(writer, location, ref_lla);
 
         if (location.gpsLocation.flags & LOC_GPS_LOCATION_HAS_SPEED)
         {
             float speedKnots = location.gpsLocation.speed * (3600.0/1852.0);
-            length = snprintf(pMarker, lengthRemaining, "%.1lf,", speedKnots);
-        }
-        else
-        {
-            length = snprintf(pMarker, lengthRemaining, ",");
+            writer.putFixed(speedKnots, 1);
         }
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putChar(',');
 
         if (location.gpsLocation.flags & LOC_GPS_LOCATION_HAS_BEARING)
         {
-            length = snprintf(pMarker, lengthRemaining, "%.1lf,", location.gpsLocation.bearing);
-        }
-        else
-        {
-            length = snprintf(pMarker, lengthRemaining, ",");
+            writer.putFixed(location.gpsLocation.bearing, 1);
         }
+        writer.putChar(',');
 
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
-
-        length = snprintf(pMarker, lengthRemaining, "%2.2d%2.2d%2.2d,",
-                          utcDay, utcMonth, utcYear);
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putInt(utcDay, 2);
+        writer.putInt(utcMonth, 2);
+        writer.putInt(utcYear, 2);
+        writer.putChar(',');
 
         if (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_MAG_DEV)
         {
@@ -1559,99 +1704,38 @@ void loc_nmea_generate_pos(const UlpLocation &location,
                 direction = 'E';
             }
 
-            length = snprintf(pMarker, lengthRemaining, "%.1lf,%c,",
-                              magneticVariation, direction);
+            writer.putFixed(magneticVariation, 1);
+            writer.putChar(',');
+            writer.putChar(direction);
+            writer.putChar(',');
         }
         else
         {
-            length = snprintf(pMarker, lengthRemaining, ",,");
-        }
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
+            writer.putStr(",,");
         }
-        pMarker += length;
-        lengthRemaining -= length;
 
-        length = snprintf(pMarker, lengthRemaining, "%c", rmcModeIndicator);
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putChar(rmcModeIndicator);
 
         // hardcode Navigation Status field to 'V'
-        length = snprintf(pMarker, lengthRemaining, ",%c", 'V');
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putStr(",V");
 
-        length = loc_nmea_put_checksum(sentence_RMC, sizeof(sentence_RMC));
+        writer.end();
+
+        if(LOC_GNSS_DATUM_PZ90 == datum_type && dtmLength > 0) {
+            // ------$--DTM-------
+            writer.append(dtm, dtmLength);
+        }
 
         // -------------------
         // ------$--GNS-------
         // -------------------
 
-        pMarker = sentence_GNS;
-        lengthRemaining = sizeof(sentence_GNS);
+        writer.begin();
+        writer.putStr(talker);
+        writer.putStr("GNS,");
+        loc_nmea_put_utc_time(writer, utcHours, utcMinutes, utcSeconds, utcMSeconds);
 
-        length = snprintf(pMarker, lengthRemaining, "$%sGNS,%02d%02d%02d.%02d," ,
-                          talker, utcHours, utcMinutes, utcSeconds, utcMSeconds/10);
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
-
-        if (location.gpsLocation.flags & LOC_GPS_LOCATION_HAS_LAT_LONG)
-        {
-            double latitude = ref_lla.lat;
-            double longitude = ref_lla.lon;
-            char latHemisphere;
-            char lonHemisphere;
-            double latMinutes;
-            double lonMinutes;
-
-            if (latitude > 0)
-            {
-                latHemisphere = 'N';
-            }
-            else
-            {
-                latHemisphere = 'S';
-                latitude *= -1.0;
-            }
-
-            if (longitude < 0)
-            {
-                lonHemisphere = 'W';
-                longitude *= -1.0;
-            }
-            else
-            {
-                lonHemisphere = 'E';
-            }
-
-            latMinutes = fmod(latitude * 60.0 , 60.0);
-            lonMinutes = fmod(longitude * 60.0 , 60.0);
-
-            length = snprintf(pMarker, lengthRemaining, "%02d%09.6lf,%c,%03d%09.6lf,%c,",
-                              (uint8_t)floor(latitude), latMinutes, latHemisphere,
-                              (uint8_t)floor(longitude),lonMinutes, lonHemisphere);
-        }
-        else
-        {
-            length = snprintf(pMarker, lengthRemaining,",,,,");
-        }
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+        loc_nmea_put_lat_long(writer, location, ref_lla);
 
         if(!(sv_cache_info.gps_used_mask ? 1 : 0))
             modeIndicator[0] = 'N';
@@ -1695,234 +1779,143 @@ void loc_nmea_generate_pos(const UlpLocation &location,
         for(int index = 5; index > 0 && 'N' == modeIndicator[index]; index--) {
             modeIndicator[index] = '\0';
         }
-        length = snprintf(pMarker, lengthRemaining,"%s,", modeIndicator);
-
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putStr(modeIndicator);
+        writer.putChar(',');
 
+        writer.putInt(svUsedCount, 2);
+        writer.putChar(',');
         if (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_DOP) {
-            length = snprintf(pMarker, lengthRemaining, "%02d,%.1f,",
-                              svUsedCount, locationExtended.hdop);
-        }
-        else {   // no hdop
-            length = snprintf(pMarker, lengthRemaining, "%02d,,",
-                              svUsedCount);
+            writer.putFixed(locationExtended.hdop, 1);
         }
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putChar(',');
 
         if (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_ALTITUDE_MEAN_SEA_LEVEL)
         {
-            length = snprintf(pMarker, lengthRemaining, "%.1lf,",
-                              locationExtended.altitudeMeanSeaLevel);
-        }
-        else
-        {
-            length = snprintf(pMarker, lengthRemaining,",");
+            writer.putFixed(locationExtended.altitudeMeanSeaLevel, 1);
         }
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putChar(',');
 
         if ((location.gpsLocation.flags & LOC_GPS_LOCATION_HAS_ALTITUDE) &&
             (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_ALTITUDE_MEAN_SEA_LEVEL))
         {
-            length = snprintf(pMarker, lengthRemaining, "%.1lf,,",
-                              ref_lla.alt - locationExtended.altitudeMeanSeaLevel);
-        }
-        else
-        {
-            length = snprintf(pMarker, lengthRemaining,",,");
+            writer.putFixed(ref_lla.alt - locationExtended.altitudeMeanSeaLevel, 1);
         }
-
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putStr(",,");
 
         // hardcode Navigation Status field to 'V'
-        length = snprintf(pMarker, lengthRemaining, ",%c", 'V');
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putStr(",V");
 
-        length = loc_nmea_put_checksum(sentence_GNS, sizeof(sentence_GNS));
+        writer.end();
 
+        if(LOC_GNSS_DATUM_PZ90 == datum_type && dtmLength > 0) {
+            // ------$--DTM-------
+            writer.append(dtm, dtmLength);
+        }
 
         // -------------------
         // ------$--GGA-------
         // -------------------
 
-        pMarker = sentence_GGA;
-        lengthRemaining = sizeof(sentence_GGA);
-
-        length = snprintf(pMarker, lengthRemaining, "$%sGGA,%02d%02d%02d.%02d," ,
-                          talker, utcHours, utcMinutes, utcSeconds, utcMSeconds/10);
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
-
-        if (location.gpsLocation.flags & LOC_GPS_LOCATION_HAS_LAT_LONG)
-        {
-            double latitude = ref_lla.lat;
-            double longitude = ref_lla.lon;
-            char latHemisphere;
-            char lonHemisphere;
-            double latMinutes;
-            double lonMinutes;
-
-            if (latitude > 0)
-            {
-                latHemisphere = 'N';
-            }
-            else
-            {
-                latHemisphere = 'S';
-                latitude *= -1.0;
-            }
-
-            if (longitude < 0)
-            {
-                lonHemisphere = 'W';
-                longitude *= -1.0;
-            }
-            else
-            {
-                lonHemisphere = 'E';
-            }
-
-            latMinutes = fmod(latitude * 60.0 , 60.0);
-            lonMinutes = fmod(longitude * 60.0 , 60.0);
+        writer.begin();
+        writer.putStr(talker);
+        writer.putStr("GGA,");
+        loc_nmea_put_utc_time(writer, utcHours, utcMinutes, utcSeconds, utcMSeconds);
 
-            length = snprintf(pMarker, lengthRemaining, "%02d%09.6lf,%c,%03d%09.6lf,%c,",
-                              (uint8_t)floor(latitude), latMinutes, latHemisphere,
-                              (uint8_t)floor(longitude),lonMinutes, lonHemisphere);
-        }
-        else
-        {
-            length = snprintf(pMarker, lengthRemaining,",,,,");
-        }
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+        loc_nmea_put_lat_long(writer, location, ref_lla);
 
         // Number of satellites in use, 00-12
         if (svUsedCount > MAX_SATELLITES_IN_USE)
             svUsedCount = MAX_SATELLITES_IN_USE;
+        writer.putStr(ggaGpsQuality);
+        writer.putChar(',');
+        writer.putInt(svUsedCount, 2);
+        writer.putChar(',');
         if (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_DOP)
         {
-            length = snprintf(pMarker, lengthRemaining, "%s,%02d,%.1f,",
-                              ggaGpsQuality, svUsedCount, locationExtended.hdop);
-        }
-        else
-        {   // no hdop
-            length = snprintf(pMarker, lengthRemaining, "%s,%02d,,",
-                              ggaGpsQuality, svUsedCount);
+            writer.putFixed(locationExtended.hdop, 1);
         }
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
-        }
-        pMarker += length;
-        lengthRemaining -= length;
+        writer.putChar(',');
 
         if (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_ALTITUDE_MEAN_SEA_LEVEL)
         {
-            length = snprintf(pMarker, lengthRemaining, "%.1lf,M,",
-                              locationExtended.altitudeMeanSeaLevel);
+            writer.putFixed(locationExtended.altitudeMeanSeaLevel, 1);
+            writer.putStr(",M,");
         }
         else
         {
-            length = snprintf(pMarker, lengthRemaining,",,");
-        }
-
-        if (length < 0 || length >= lengthRemaining)
-        {
-            LOC_LOGE("NMEA Error in string formatting");
-            return;
+            writer.putStr(",,");
         }
-        pMarker += length;
-        lengthRemaining -= length;
 
         if ((location.gpsLocation.flags & LOC_GPS_LOCATION_HAS_ALTITUDE) &&
             (locationExtended.flags & GPS_LOCATION_EXTENDED_HAS_ALTITUDE_MEAN_SEA_LEVEL))
         {
-            length = snprintf(pMarker, lengthRemaining, "%.1lf,M,,",
-                              ref_lla.alt - locationExtended.altitudeMeanSeaLevel);
+            writer.putFixed(ref_lla.alt - locationExtended.altitudeMeanSeaLevel, 1);
+            writer.putStr(",M,,");
         }
         else
         {
-            length = snprintf(pMarker, lengthRemaining,",,,");
-        }
-
-        length = loc_nmea_put_checksum(sentence_GGA, sizeof(sentence_GGA));
-
-        // ------$--DTM-------
-        nmeaArraystr.push_back(sentence_DTM);
-        // ------$--RMC-------
-        nmeaArraystr.push_back(sentence_RMC);
-        if(LOC_GNSS_DATUM_PZ90 == datum_type) {
-            // ------$--DTM-------
-            nmeaArraystr.push_back(sentence_DTM);
-        }
-        // ------$--GNS-------
-        nmeaArraystr.push_back(sentence_GNS);
-        if(LOC_GNSS_DATUM_PZ90 == datum_type) {
-            // ------$--DTM-------
-            nmeaArraystr.push_back(sentence_DTM);
+            writer.putStr(",,,");
         }
-        // ------$--GGA-------
-        nmeaArraystr.push_back(sentence_GGA);
 
+        writer.end();
     }
     //Send blank NMEA reports for non-final fixes
     else {
-        strlcpy(sentence, "$GPGSA,A,1,,,,,,,,,,,,,,,,", sizeof(sentence));
-        length = loc_nmea_put_checksum(sentence, sizeof(sentence));
-        nmeaArraystr.push_back(sentence);
+        loc_nmea_put_sentence(writer, "GPGSA,A,1,,,,,,,,,,,,,,,,");
+        loc_nmea_put_sentence(writer, "GPVTG,,T,,M,,N,,K,N");
+        loc_nmea_put_sentence(writer, "GPDTM,,,,,,,,");
+        loc_nmea_put_sentence(writer, "GPRMC,,V,,,,,,,,,,N,V");
+        loc_nmea_put_sentence(writer, "GPGNS,,,,,,N,,,,,,,V");
+        loc_nmea_put_sentence(writer, "GPGGA,,,,,,0,,,,,,,,");
+    }
 
-        strlcpy(sentence, "$GPVTG,,T,,M,,N,,K,N", sizeof(sentence));
-        length = loc_nmea_put_checksum(sentence, sizeof(sentence));
-        nmeaArraystr.push_back(sentence);
+    EXIT_LOG(%d, 0);
+}
 
-        strlcpy(sentence, "$GPDTM,,,,,,,,", sizeof(sentence));
-        length = loc_nmea_put_checksum(sentence, sizeof(sentence));
-        nmeaArraystr.push_back(sentence);
+/*===========================================================================
+FUNCTION    loc_nmea_split
 
-        strlcpy(sentence, "$GPRMC,,V,,,,,,,,,,N,V", sizeof(sentence));
-        length = loc_nmea_put_checksum(sentence, sizeof(sentence));
-        nmeaArraystr.push_back(sentence);
+DESCRIPTION
+   LocNmeaWriter flush callback splitting the sentences flushed into one
+   string per sentence, appended to the std::vector<std::string> context
 
-        strlcpy(sentence, "$GPGNS,,,,,,N,,,,,,,V", sizeof(sentence));
-        length = loc_nmea_put_checksum(sentence, sizeof(sentence));
-        nmeaArraystr.push_back(sentence);
+DEPENDENCIES
+   NONE
 
-        strlcpy(sentence, "$GPGGA,,,,,,0,,,,,,,,", sizeof(sentence));
-        length = loc_nmea_put_checksum(sentence, sizeof(sentence));
-        nmeaArraystr.push_back(sentence);
+RETURN VALUE
+   NONE
+
+SIDE EFFECTS
+   N/A
+
+===========================================================================*/
+static void loc_nmea_split(void* context, const char* nmea, size_t length)
+{
+    std::vector<std::string> &nmeaArraystr = *(std::vector<std::string>*)context;
+    const char* pSentence = nmea;
+    const char* pEnd = pSentence + length;
+
+    while (pSentence < pEnd) {
+        const char* pNewLine = (const char*)memchr(pSentence, '\n', pEnd - pSentence);
+        const char* pNext = (NULL == pNewLine) ? pEnd : pNewLine + 1;
+        nmeaArraystr.push_back(std::string(pSentence, pNext - pSentence));
+        pSentence = pNext;
     }
+}
 
-    EXIT_LOG(%d, 0);
+void loc_nmea_generate_pos(const UlpLocation &location,
+                               const GpsLocationExtended &locationExtended,
+                               const LocationSystemInfo &systemInfo,
+                               unsigned char generate_nmea,
+                               bool custom_gga_fix_quality,
+                               std::vector<std::string> &nmeaArraystr)
+{
+    char buffer[NMEA_EPOCH_MAX_LENGTH];
+    LocNmeaWriter writer(buffer, sizeof(buffer), loc_nmea_split, &nmeaArraystr);
+
+    loc_nmea_generate_pos(location, locationExtended, systemInfo, generate_nmea,
+                          custom_gga_fix_quality, writer);
+    writer.flush();
 }
 
 
@@ -1944,11 +1937,10 @@ SIDE EFFECTS
 
 ===========================================================================*/
 void loc_nmea_generate_sv(const GnssSvNotification &svNotify,
-                              std::vector<std::string> &nmeaArraystr)
+                              LocNmeaWriter &writer)
 {
     ENTRY_LOG();
 
-    char sentence[NMEA_SENTENCE_MAX_LENGTH] = {0};
     int svCount = svNotify.count;
     int svNumber = 1;
     loc_sv_cache_info sv_cache_info = {};
@@ -2068,86 +2060,351 @@ void loc_nmea_generate_sv(const GnssSvNotification &svNotify,
     // ------$GPGSV:L1CA----
     // ---------------------
 
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_GPS,
-            GNSS_SIGNAL_GPS_L1CA, false), nmeaArraystr);
+            GNSS_SIGNAL_GPS_L1CA, false), writer);
 
     // ---------------------
     // ------$GPGSV:L5------
     // ---------------------
 
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_GPS,
-            GNSS_SIGNAL_GPS_L5, false), nmeaArraystr);
+            GNSS_SIGNAL_GPS_L5, false), writer);
     // ---------------------
     // ------$GLGSV:G1------
     // ---------------------
 
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_GLONASS,
-            GNSS_SIGNAL_GLONASS_G1, false), nmeaArraystr);
+            GNSS_SIGNAL_GLONASS_G1, false), writer);
 
     // ---------------------
     // ------$GLGSV:G2------
     // ---------------------
 
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_GLONASS,
-            GNSS_SIGNAL_GLONASS_G2, false), nmeaArraystr);
+            GNSS_SIGNAL_GLONASS_G2, false), writer);
 
     // ---------------------
     // ------$GAGSV:E1------
     // ---------------------
 
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_GALILEO,
-            GNSS_SIGNAL_GALILEO_E1, false), nmeaArraystr);
+            GNSS_SIGNAL_GALILEO_E1, false), writer);
 
     // -------------------------
     // ------$GAGSV:E5A---------
     // -------------------------
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_GALILEO,
-            GNSS_SIGNAL_GALILEO_E5A, false), nmeaArraystr);
+            GNSS_SIGNAL_GALILEO_E5A, false), writer);
 
     // -----------------------------
     // ------$PQGSV (QZSS):L1CA-----
     // -----------------------------
 
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_QZSS,
-            GNSS_SIGNAL_QZSS_L1CA, false), nmeaArraystr);
+            GNSS_SIGNAL_QZSS_L1CA, false), writer);
 
     // -----------------------------
     // ------$PQGSV (QZSS):L5-------
     // -----------------------------
 
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_QZSS,
-            GNSS_SIGNAL_QZSS_L5, false), nmeaArraystr);
+            GNSS_SIGNAL_QZSS_L5, false), writer);
     // -----------------------------
     // ------$PQGSV (BEIDOU:B1I)----
     // -----------------------------
 
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_BEIDOU,
-            GNSS_SIGNAL_BEIDOU_B1I,false), nmeaArraystr);
+            GNSS_SIGNAL_BEIDOU_B1I,false), writer);
 
     // -----------------------------
     // ------$PQGSV (BEIDOU:B2AI)---
     // -----------------------------
 
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_BEIDOU,
-            GNSS_SIGNAL_BEIDOU_B2AI,false), nmeaArraystr);
+            GNSS_SIGNAL_BEIDOU_B2AI,false), writer);
 
     // -----------------------------
     // ------$GIGSV (NAVIC:L5)------
     // -----------------------------
 
-    loc_nmea_generate_GSV(svNotify, sentence, sizeof(sentence),
+    loc_nmea_generate_GSV(svNotify,
             loc_nmea_sv_meta_init(sv_meta, sv_cache_info, GNSS_SV_TYPE_NAVIC,
-            GNSS_SIGNAL_NAVIC_L5,false), nmeaArraystr);
+            GNSS_SIGNAL_NAVIC_L5,false), writer);
 
     EXIT_LOG(%d, 0);
 }
+
+void loc_nmea_generate_sv(const GnssSvNotification &svNotify,
+                              std::vector<std::string> &nmeaArraystr)
+{
+    char buffer[NMEA_EPOCH_MAX_LENGTH];
+    LocNmeaWriter writer(buffer, sizeof(buffer), loc_nmea_split, &nmeaArraystr);
+
+    loc_nmea_generate_sv(svNotify, writer);
+    writer.flush();
+}
+
+#ifdef __LOC_DEBUG__
+
+// For Linux command line checking and benchmarking of the per epoch NMEA cost:
+//     g++ -D__LOC_DEBUG__ -DUSE_GLIB -DFEATURE_EXTERNAL_AP -DOFF_TARGET -O2 -std=c++14
+//         -I. -I../pla/oe -I../location -o nmea_bench loc_nmea.cpp loc_log.cpp
+//         loc_misc_utils.cpp -lpthread
+// (loc_cfg.cpp is left out, provide a loc_get_datum_type() stub returning
+// LOC_GNSS_DATUM_WGS84 instead)
+//     ./nmea_bench <epochs>
+#include <stdio.h>
+#include <time.h>
+#include <string>
+
+// Output of the snprintf + std::vector<std::string> generator loc_nmea used
+// to run, recorded for benchFillEpoch() inputs. The writer must match it byte
+// for byte.
+static const struct {
+    uint32_t epoch;
+    unsigned char generateNmea;
+    bool withSv;
+    const char* nmea;
+} kNmeaGolden[] = {
+    { 0, 1, true,
+      "$GNGSA,A,3,01,07,08,11,14,16,20,,,,,,1.6,0.9,1.3,1*33\r\n"
+      "$GNGSA,A,3,66,71,72,73,,,,,,,,,1.6,0.9,1.3,2*39\r\n"
+      "$GNGSA,A,3,05,06,10,,,,,,,,,,1.6,0.9,1.3,3*3D\r\n"
+      "$GNGSA,A,3,01,02,03,04,05,,,,,,,,1.6,0.9,1.3,4*39\r\n"
+      "$GNVTG,0.0,T,0.0,M,26.0,N,48.2,K,A*37\r\n"
+      "$GNDTM,P90,,0000.000025,S,00000.000001,E,0.981,W84*58\r\n"
+      "$GNRMC,122640.00,A,3723.166000,N,12205.034000,W,26.0,0.0,130920,13.2,E,A,V*4A\r\n"
+      "$GNGNS,122640.00,3723.166000,N,12205.034000,W,AAAA,19,0.9,40.1,-27.8,,,V*20\r\n"
+      "$GNGGA,122640.00,3723.166000,N,12205.034000,W,1,12,0.9,40.1,M,-27.8,M,,*7B\r\n"
+      "$GPGSV,3,1,10,01,10,000,25,02,18,074,27,03,26,148,29,04,35,222,31,1*6E\r\n"
+      "$GPGSV,3,2,10,05,43,296,33,06,51,010,35,07,59,084,37,08,67,158,39,1*62\r\n"
+      "$GPGSV,3,3,10,09,76,232,41,10,84,306,43,1*64\r\n"
+      "$GPGSV,3,1,10,01,14,037,26,02,22,111,28,03,31,185,30,04,39,259,32,8*6C\r\n"
+      "$GPGSV,3,2,10,05,47,333,34,06,55,047,36,07,63,121,38,08,72,195,40,8*60\r\n"
+      "$GPGSV,3,3,10,09,80,269,42,10,88,343,44,8*63\r\n"
+      "$GLGSV,3,1,10,65,10,000,25,66,18,074,27,67,26,148,29,68,35,222,31,1*7A\r\n"
+      "$GLGSV,3,2,10,69,43,296,33,70,51,010,35,71,59,084,37,72,67,158,39,1*79\r\n"
+      "$GLGSV,3,3,10,73,76,232,41,74,84,306,43,1*77\r\n"
+      "$GLGSV,3,1,10,65,14,037,26,66,22,111,28,67,31,185,30,68,39,259,32,3*73\r\n"
+      "$GLGSV,3,2,10,69,47,333,34,70,55,047,36,71,63,121,38,72,72,195,40,3*70\r\n"
+      "$GLGSV,3,3,10,73,80,269,42,74,88,343,44,3*7B\r\n"
+      "$GAGSV,3,1,10,01,10,000,25,02,18,074,27,03,26,148,29,04,35,222,31,7*79\r\n"
+      "$GAGSV,3,2,10,05,43,296,33,06,51,010,35,07,59,084,37,08,67,158,39,7*75\r\n"
+      "$GAGSV,3,3,10,09,76,232,41,10,84,306,43,7*73\r\n"
+      "$GAGSV,3,1,10,01,14,037,26,02,22,111,28,03,31,185,30,04,39,259,32,1*74\r\n"
+      "$GAGSV,3,2,10,05,47,333,34,06,55,047,36,07,63,121,38,08,72,195,40,1*78\r\n"
+      "$GAGSV,3,3,10,09,80,269,42,10,88,343,44,1*7B\r\n"
+      "$GBGSV,3,1,10,01,10,000,25,02,18,074,27,03,26,148,29,04,35,222,31,1*7C\r\n"
+      "$GBGSV,3,2,10,05,43,296,33,06,51,010,35,07,59,084,37,08,67,158,39,1*70\r\n"
+      "$GBGSV,3,3,10,09,76,232,41,10,84,306,43,1*76\r\n"
+      "$GBGSV,3,1,10,01,14,037,26,02,22,111,28,03,31,185,30,04,39,259,32,5*73\r\n"
+      "$GBGSV,3,2,10,05,47,333,34,06,55,047,36,07,63,121,38,08,72,195,40,5*7F\r\n"
+      "$GBGSV,3,3,10,09,80,269,42,10,88,343,44,5*7C\r\n" },
+    { 4321, 1, true,
+      "$GNGSA,A,3,01,07,08,11,14,16,20,,,,,,1.6,0.9,1.3,1*33\r\n"
+      "$GNGSA,A,3,66,71,72,73,,,,,,,,,1.6,0.9,1.3,2*39\r\n"
+      "$GNGSA,A,3,05,06,10,,,,,,,,,,1.6,0.9,1.3,3*3D\r\n"
+      "$GNGSA,A,3,01,02,03,04,05,,,,,,,,1.6,0.9,1.3,4*39\r\n"
+      "$GNVTG,72.1,T,72.1,M,26.2,N,48.6,K,A*31\r\n"
+      "$GNDTM,P90,,0000.000025,S,00000.000001,E,0.981,W84*58\r\n"
+      "$GNRMC,123352.10,A,3723.425260,N,12205.293260,W,26.2,72.1,130920,13.2,E,A,V*77\r\n"
+      "$GNGNS,123352.10,3723.425260,N,12205.293260,W,AAAA,19,0.9,40.1,-27.6,,,V*25\r\n"
+      "$GNGGA,123352.10,3723.425260,N,12205.293260,W,1,12,0.9,40.1,M,-27.6,M,,*7E\r\n"
+      "$GPGSV,3,1,10,01,10,001,26,02,18,075,28,03,26,149,30,04,35,223,32,1*69\r\n"
+      "$GPGSV,3,2,10,05,43,297,34,06,51,011,36,07,59,085,38,08,67,159,40,1*67\r\n"
+      "$GPGSV,3,3,10,09,76,233,42,10,84,307,44,1*60\r\n"
+      "$GPGSV,3,1,10,01,14,038,27,02,22,112,29,03,31,186,31,04,39,260,33,8*69\r\n"
+      "$GPGSV,3,2,10,05,47,334,35,06,55,048,37,07,63,122,39,08,72,196,41,8*68\r\n"
+      "$GPGSV,3,3,10,09,80,270,43,10,88,344,25,8*6A\r\n"
+      "$GLGSV,3,1,10,65,10,001,26,66,18,075,28,67,26,149,30,68,35,223,32,1*7D\r\n"
+      "$GLGSV,3,2,10,69,43,297,34,70,51,011,36,71,59,085,38,72,67,159,40,1*7C\r\n"
+      "$GLGSV,3,3,10,73,76,233,42,74,84,307,44,1*73\r\n"
+      "$GLGSV,3,1,10,65,14,038,27,66,22,112,29,67,31,186,31,68,39,260,33,3*76\r\n"
+      "$GLGSV,3,2,10,69,47,334,35,70,55,048,37,71,63,122,39,72,72,196,41,3*78\r\n"
+      "$GLGSV,3,3,10,73,80,270,43,74,88,344,25,3*72\r\n"
+      "$GAGSV,3,1,10,01,10,001,26,02,18,075,28,03,26,149,30,04,35,223,32,7*7E\r\n"
+      "$GAGSV,3,2,10,05,43,297,34,06,51,011,36,07,59,085,38,08,67,159,40,7*70\r\n"
+      "$GAGSV,3,3,10,09,76,233,42,10,84,307,44,7*77\r\n"
+      "$GAGSV,3,1,10,01,14,038,27,02,22,112,29,03,31,186,31,04,39,260,33,1*71\r\n"
+      "$GAGSV,3,2,10,05,47,334,35,06,55,048,37,07,63,122,39,08,72,196,41,1*70\r\n"
+      "$GAGSV,3,3,10,09,80,270,43,10,88,344,25,1*72\r\n"
+      "$GBGSV,3,1,10,01,10,001,26,02,18,075,28,03,26,149,30,04,35,223,32,1*7B\r\n"
+      "$GBGSV,3,2,10,05,43,297,34,06,51,011,36,07,59,085,38,08,67,159,40,1*75\r\n"
+      "$GBGSV,3,3,10,09,76,233,42,10,84,307,44,1*72\r\n"
+      "$GBGSV,3,1,10,01,14,038,27,02,22,112,29,03,31,186,31,04,39,260,33,5*76\r\n"
+      "$GBGSV,3,2,10,05,47,334,35,06,55,048,37,07,63,122,39,08,72,196,41,5*77\r\n"
+      "$GBGSV,3,3,10,09,80,270,43,10,88,344,25,5*75\r\n" },
+    { 0, 0, false,
+      "$GPGSA,A,1,,,,,,,,,,,,,,,,*32\r\n"
+      "$GPVTG,,T,,M,,N,,K,N*2C\r\n"
+      "$GPDTM,,,,,,,,*4A\r\n"
+      "$GPRMC,,V,,,,,,,,,,N,V*29\r\n"
+      "$GPGNS,,,,,,N,,,,,,,V*79\r\n"
+      "$GPGGA,,,,,,0,,,,,,,,*66\r\n" },
+};
+
+static inline uint64_t nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void benchFillEpoch(uint32_t epoch, UlpLocation& location,
+                           GpsLocationExtended& locationExtended,
+                           GnssSvNotification& svNotify) {
+    memset(&location, 0, sizeof(location));
+    memset(&locationExtended, 0, sizeof(locationExtended));
+    memset(&svNotify, 0, sizeof(svNotify));
+
+    location.gpsLocation.flags = LOC_GPS_LOCATION_HAS_LAT_LONG | LOC_GPS_LOCATION_HAS_ALTITUDE |
+            LOC_GPS_LOCATION_HAS_SPEED | LOC_GPS_LOCATION_HAS_BEARING;
+    location.gpsLocation.latitude = 37.3861 + epoch * 1e-6;
+    location.gpsLocation.longitude = -122.0839 - epoch * 1e-6;
+    location.gpsLocation.altitude = 12.3 + (epoch % 100) * 0.01;
+    location.gpsLocation.speed = 13.4 + (epoch % 10) * 0.1;
+    location.gpsLocation.bearing = (epoch % 3600) * 0.1;
+    location.gpsLocation.timestamp = 1600000000000ULL + epoch * 100ULL;
+    locationExtended.flags = GPS_LOCATION_EXTENDED_HAS_DOP |
+            GPS_LOCATION_EXTENDED_HAS_ALTITUDE_MEAN_SEA_LEVEL |
+            GPS_LOCATION_EXTENDED_HAS_MAG_DEV | GPS_LOCATION_EXTENDED_HAS_POS_TECH_MASK |
+            GPS_LOCATION_EXTENDED_HAS_GNSS_SV_USED_DATA;
+    locationExtended.pdop = 1.6;
+    locationExtended.hdop = 0.9;
+    locationExtended.vdop = 1.3;
+    locationExtended.altitudeMeanSeaLevel = 40.1;
+    locationExtended.magneticDeviation = 13.2;
+    locationExtended.tech_mask = LOC_POS_TECH_MASK_SATELLITE;
+    locationExtended.gnss_sv_used_ids.gps_sv_used_ids_mask = 0x8a4c1;
+    locationExtended.gnss_sv_used_ids.glo_sv_used_ids_mask = 0x1c2;
+    locationExtended.gnss_sv_used_ids.gal_sv_used_ids_mask = 0x230;
+    locationExtended.gnss_sv_used_ids.bds_sv_used_ids_mask = 0x1f;
+
+    // 10 SVs for each of GPS, GLONASS, Galileo and BDS on two signals each
+    static const GnssSvType types[] = { GNSS_SV_TYPE_GPS, GNSS_SV_TYPE_GLONASS,
+            GNSS_SV_TYPE_GALILEO, GNSS_SV_TYPE_BEIDOU };
+    static const GnssSignalTypeMask signals[][2] = {
+            { GNSS_SIGNAL_GPS_L1CA, GNSS_SIGNAL_GPS_L5 },
+            { GNSS_SIGNAL_GLONASS_G1, GNSS_SIGNAL_GLONASS_G2 },
+            { GNSS_SIGNAL_GALILEO_E1, GNSS_SIGNAL_GALILEO_E5A },
+            { GNSS_SIGNAL_BEIDOU_B1I, GNSS_SIGNAL_BEIDOU_B2AI } };
+    for (uint32_t c = 0; c < 4; c++) {
+        for (uint32_t i = 0; i < 20; i++) {
+            GnssSv& sv = svNotify.gnssSvs[svNotify.count++];
+            sv.size = sizeof(GnssSv);
+            sv.type = types[c];
+            sv.svId = 1 + i / 2;
+            sv.gnssSignalTypeMask = signals[c][i % 2];
+            sv.elevation = 10.0f + i * 4.1f;
+            sv.azimuth = (i * 37 + epoch) % 360;
+            sv.cN0Dbhz = 25.0f + (i + epoch) % 20;
+            sv.gnssSvOptionsMask = (i % 3) ? GNSS_SV_OPTIONS_USED_IN_FIX_BIT : 0;
+        }
+    }
+}
+
+static void benchCollect(void* context, const char* nmea, size_t length) {
+    ((std::string*)context)->append(nmea, length);
+}
+
+// Checks the writer against the recorded sentences, both in one buffer and
+// through a buffer small enough to flush several times per epoch
+static uint32_t checkGolden(char* buffer, size_t size) {
+    LocationSystemInfo systemInfo = {};
+    UlpLocation location;
+    GpsLocationExtended locationExtended;
+    GnssSvNotification svNotify;
+    uint32_t failures = 0;
+
+    for (size_t i = 0; i < sizeof(kNmeaGolden) / sizeof(kNmeaGolden[0]); i++) {
+        benchFillEpoch(kNmeaGolden[i].epoch, location, locationExtended, svNotify);
+        size_t sizes[] = { size, 2 * NMEA_SENTENCE_MAX_LENGTH };
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            std::string nmea;
+            LocNmeaWriter writer(buffer, sizes[s], benchCollect, &nmea);
+            loc_nmea_generate_pos(location, locationExtended, systemInfo,
+                                  kNmeaGolden[i].generateNmea, false, writer);
+            if (kNmeaGolden[i].withSv) {
+                loc_nmea_generate_sv(svNotify, writer);
+            }
+            writer.flush();
+            if (nmea != kNmeaGolden[i].nmea || writer.getDropped() > 0) {
+                printf("golden %zu, %zu byte buffer: outputs differ\n%s---\n%s\n",
+                       i, sizes[s], kNmeaGolden[i].nmea, nmea.c_str());
+                failures++;
+            }
+        }
+    }
+
+    // without a flush callback, sentences that do not fit are counted
+    benchFillEpoch(0, location, locationExtended, svNotify);
+    LocNmeaWriter writer(buffer, 2 * NMEA_SENTENCE_MAX_LENGTH);
+    loc_nmea_generate_sv(svNotify, writer);
+    if (0 == writer.getDropped() || writer.getLength() >= 2 * NMEA_SENTENCE_MAX_LENGTH) {
+        printf("dropped sentences not counted\n");
+        failures++;
+    }
+    return failures;
+}
+
+int main(int argc, char** argv) {
+    uint32_t epochs = (argc > 1) ? atoi(argv[1]) : 100000;
+    static char buffer[NMEA_EPOCH_MAX_LENGTH];
+    LocationSystemInfo systemInfo = {};
+    UlpLocation location;
+    GpsLocationExtended locationExtended;
+    GnssSvNotification svNotify;
+    uint64_t writerNs = 0, writerBytes = 0;
+    uint32_t failures = checkGolden(buffer, sizeof(buffer));
+
+    for (uint32_t epoch = 0; epoch < epochs; epoch++) {
+        benchFillEpoch(epoch, location, locationExtended, svNotify);
+
+        uint64_t t0 = nowNs();
+        LocNmeaWriter writer(buffer, sizeof(buffer));
+        loc_nmea_generate_pos(location, locationExtended, systemInfo, 1, false, writer);
+        loc_nmea_generate_sv(svNotify, writer);
+        uint64_t t1 = nowNs();
+
+        writerNs += t1 - t0;
+        writerBytes += writer.getLength();
+    }
+    if (epochs > 0) {
+        printf("writer: %6llu ns/epoch, %llu bytes/epoch\n",
+               (unsigned long long)(writerNs / epochs),
+               (unsigned long long)(writerBytes / epochs));
+    }
+
+    // putFixed() must render exactly as printf does
+    char expected[32];
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < 1000000; i++) {
+        double value = ((int32_t)(i * 2654435761u) % 2000000) / 1000.0 + i * 1e-9;
+        int decimals = i % 7;
+        int width = i % 11;
+        LocNmeaWriter writer(buffer, sizeof(buffer));
+        writer.begin();
+        writer.putFixed(value, decimals, width);
+        writer.end();
+        int length = snprintf(expected, sizeof(expected), "%0*.*f", width, decimals, value);
+        if (0 != strncmp(expected, buffer + 1, length) || '*' != buffer[length + 1]) {
+            if (mismatches++ < 10) {
+                printf("putFixed(%.17g, %d, %d): %.*s, expected %s\n",
+                       value, decimals, width, length, buffer + 1, expected);
+            }
+        }
+    }
+    printf("putFixed mismatches: %u\n", mismatches);
+    return (mismatches > 0 || failures > 0);
+}
+
+#endif
@@ -34,6 +34,8 @@
 #include <vector>
 #include <string>
 #define NMEA_SENTENCE_MAX_LENGTH 200
+/* room for all the sentences of one position or SV report */
+#define NMEA_EPOCH_MAX_LENGTH    (NMEA_SENTENCE_MAX_LENGTH * 64)
 
 /** gnss datum type */
 #define LOC_GNSS_DATUM_WGS84          0
@@ -72,6 +74,86 @@ typedef struct {
     double     Z;
 } LocEcef;
 
+// Receives sealed sentences a LocNmeaWriter hands off to make room
+typedef void (*LocNmeaFlushCb)(void* context, const char* nmea, size_t length);
+
+// Appends NMEA sentences back to back into a caller supplied buffer, without
+// any heap allocation. Sentences are opened with begin() and sealed with end(),
+// which appends "*hh\r\n"; the checksum is accumulated as fields are written.
+// Numeric fields are formatted with integer arithmetic instead of printf.
+// When the buffer fills up, the sealed sentences are handed to the flush
+// callback, if one is given, and the buffer is reused. Otherwise a sentence
+// that does not fit is dropped as a whole and counted in getDropped(), so the
+// buffer always holds complete, NUL terminated sentences.
+class LocNmeaWriter {
+    char* mBuf;
+    size_t mSize;
+    size_t mLength;     // end of the last sealed sentence
+    size_t mCursor;     // write position in the open sentence
+    uint32_t mCount;    // number of sealed sentences
+    uint32_t mDropped;  // number of sentences that did not fit
+    uint8_t mChecksum;
+    bool mOverflown;
+    LocNmeaFlushCb mFlushCb;
+    void* mFlushContext;
+    inline void put(char c) {
+        if (mCursor + 1 < mSize || makeRoom(1)) {
+            mBuf[mCursor++] = c;
+            mChecksum ^= (uint8_t)c;
+        } else {
+            mOverflown = true;
+        }
+    }
+    void write(const char* data, size_t length);
+    bool makeRoom(size_t length);
+public:
+    LocNmeaWriter(char* buf, size_t size, LocNmeaFlushCb flushCb = NULL,
+                  void* flushContext = NULL);
+    inline void reset() {
+        mLength = mCursor = 0;
+        mCount = 0;
+        mDropped = 0;
+        mChecksum = 0;
+        mOverflown = false;
+        if (mSize > 0) {
+            mBuf[0] = '\0';
+        }
+    }
+    inline const char* getBuffer() const { return mBuf; }
+    inline size_t getLength() const { return mLength; }
+    inline uint32_t getCount() const { return mCount; }
+    inline uint32_t getDropped() const { return mDropped; }
+
+    // hands the sealed sentences to the flush callback and empties the
+    // buffer; returns false if there is no callback or nothing to flush
+    bool flush();
+    // opens a new sentence, writing the leading '$'
+    void begin();
+    inline void putChar(char c) { put(c); }
+    void putStr(const char* str);
+    // printf("%0*d", minDigits, value)
+    void putInt(int32_t value, int minDigits = 1);
+    // printf("%X", value)
+    void putHex(uint32_t value);
+    // printf("%0*.*f", minWidth, decimals, value), decimals <= 6
+    void putFixed(double value, int decimals, int minWidth = 0);
+    // seals the open sentence; returns false if it was dropped
+    bool end();
+    // copies a sealed sentence held outside this writer's buffer, which a
+    // flush may reuse
+    bool append(const char* sentence, size_t length);
+};
+
+void loc_nmea_generate_sv(const GnssSvNotification &svNotify,
+                              LocNmeaWriter &writer);
+
+void loc_nmea_generate_pos(const UlpLocation &location,
+                               const GpsLocationExtended &locationExtended,
+                               const LocationSystemInfo &systemInfo,
+                               unsigned char generate_nmea,
+                               bool custom_gga_fix_quality,
+                               LocNmeaWriter &writer);
+
 void loc_nmea_generate_sv(const GnssSvNotification &svNotify,
                               std::vector<std::string> &nmeaArraystr);
 